@@ -3,6 +3,6 @@ SET(LIB_OPTIONAL_DEP_PACKAGES)
 SET(TEST_REQUIRED_DEP_PACKAGES)
 SET(TEST_OPTIONAL_DEP_PACKAGES EpetraExt ThyraEpetraAdapters ThyraEpetraExtAdapters Sacado Stratimikos Belos NOX)
 SET(LIB_REQUIRED_DEP_TPLS)
-SET(LIB_OPTIONAL_DEP_TPLS Boost)
+SET(LIB_OPTIONAL_DEP_TPLS Boost Pthread)
 SET(TEST_REQUIRED_DEP_TPLS)
 SET(TEST_OPTIONAL_DEP_TPLS)
@@ -50,6 +50,9 @@
 #include "Rythmos_ImplicitRKStepper.hpp"
 #include "Rythmos_RKButcherTableau.hpp"
 #include "Rythmos_RKButcherTableauBuilder.hpp"
+#include "Rythmos_IntegratorBuilder.hpp"
+#include "Rythmos_PararealIntegrationDriver.hpp"
+#include "Rythmos_ForwardSensitivityStepper.hpp"
 
 // Includes for Thyra:
 #include "Thyra_EpetraThyraWrappers.hpp"
@@ -59,6 +62,9 @@
 #include "Thyra_NonlinearSolver_NOX.hpp"
 #include "Thyra_DiagonalEpetraLinearOpWithSolveFactory.hpp"
 #include "Thyra_TestingTools.hpp"
+#include "Thyra_DefaultSpmdVectorSpace.hpp"
+#include "Thyra_MultiVectorStdOps.hpp"
+#include "Thyra_VectorStdOps.hpp"
 
 // Includes for Stratimikos:
 #include "Stratimikos_DefaultLinearSolverBuilder.hpp"
@@ -77,6 +83,7 @@
 #include "Teuchos_VerboseObject.hpp"
 #include "Teuchos_StandardCatchMacros.hpp"
 #include "Teuchos_XMLParameterListHelpers.hpp"
+#include "Teuchos_Time.hpp"
 
 enum EMethod { METHOD_FE, METHOD_BE, METHOD_ERK, METHOD_BDF, METHOD_IRK };
 enum STEP_METHOD { STEP_METHOD_FIXED, STEP_METHOD_VARIABLE };
@@ -116,6 +123,10 @@ int main(int argc, char *argv[])
     int outputLevel = 2; // outputLevel is used to control Rythmos verbosity
     bool useNOX = false;
     std::string extraLSParamsFile = "";
+    int pararealSlices = 0; // 0 skips the parareal runs
+    int pararealThreads = 4;
+    int sensMaxNp = 0; // 0 skips the sensitivity solve runs
+    int sensBlockSize = 0;
 
     // Parse the command-line options:
     Teuchos::CommandLineProcessor  clp(false); // Don't throw exceptions
@@ -136,6 +147,10 @@ int main(int argc, char *argv[])
     clp.setOption( "outputLevel", &outputLevel, "Debug Level for Rythmos" );
     clp.setOption( "useNOX", "noNOX", &useNOX, "Use NOX as nonlinear solver" );
     clp.setOption( "extra-linear-solver-params-file", &extraLSParamsFile, "File containing extra linear solver parameters in XML format.");
+    clp.setOption( "parareal-slices", &pararealSlices, "If > 0, also integrate with the parareal driver using this many time slices (BE only)" );
+    clp.setOption( "parareal-threads", &pararealThreads, "Largest number of threads of the parareal strong-scaling runs" );
+    clp.setOption( "sens-max-np", &sensMaxNp, "If > 0, also integrate initial condition sensitivities for np = 1, 2, 4, ... up to this many columns (BE only)" );
+    clp.setOption( "sens-block-size", &sensBlockSize, "Sensitivity Solve Block Size compared against column by column solves (0 = all columns in one solve)" );
 
 
     Teuchos::CommandLineProcessor::EParseCommandLineReturn parse_return = clp.parse(argc,argv);
@@ -282,6 +297,7 @@ int main(int argc, char *argv[])
     double dt = (t1-t0)/N;
     double time = t0;
     int numSteps = 0;
+    const double serialStartTime = Teuchos::Time::wallTime();
 
     if (step_method == STEP_METHOD_FIXED)
     {
@@ -317,6 +333,7 @@ int main(int argc, char *argv[])
         *out << "Took stepsize of: " << dt_taken << " time = " << time << endl;
       }
     }
+    const double serialTime = Teuchos::Time::wallTime() - serialStartTime;
     *out << "Integrated to time = " << time << endl;
     // Get solution out of stepper:
     const Rythmos::StepStatus<double> stepStatus = stepper.getStepStatus();
@@ -365,6 +382,173 @@ int main(int argc, char *argv[])
       );
     if(!result) success = false;
 
+    // Strong-scaling runs of the parareal driver with the same fine steps.
+    // The coarse propagator is one backward Euler step per slice.
+    if (pararealSlices > 0)
+    {
+      TEUCHOS_TEST_FOR_EXCEPTION(
+        method_val != METHOD_BE, std::logic_error,
+        "Error, --parareal-slices is only supported with --method=BE!"
+        );
+      Teuchos::RCP<Teuchos::ParameterList> builderPL = Teuchos::parameterList();
+      builderPL->setParameters(*(Rythmos::integratorBuilder<double>()->getValidParameters()));
+      builderPL->sublist("Integrator Settings").set("Final Time",t1);
+      Teuchos::ParameterList &controlPL = builderPL->sublist("Integration Control Strategy Selection");
+      controlPL.set("Integration Control Strategy Type","Simple Integration Control Strategy");
+      controlPL.sublist("Simple Integration Control Strategy").set("Take Variable Steps",false);
+      controlPL.sublist("Simple Integration Control Strategy").set("Fixed dt",dt);
+      builderPL->sublist("Stepper Settings").sublist("Stepper Selection").set("Stepper Type","Backward Euler");
+
+      Teuchos::RCP<Rythmos::TimeStepNonlinearSolver<double> >
+        pararealSolver = Teuchos::rcp(new Rythmos::TimeStepNonlinearSolver<double>());
+      Teuchos::RCP<Teuchos::ParameterList>
+        nonlinearSolverPL = Teuchos::parameterList();
+      nonlinearSolverPL->set("Default Tol",double(1e-3*maxError));
+      pararealSolver->setParameterList(nonlinearSolverPL);
+
+      // The application keeps work vectors between evaluations, so every
+      // thread gets its own copy of the model.
+      Teuchos::Array<Teuchos::RCP<const Thyra::ModelEvaluator<double> > > threadModels;
+      for (int i=0 ; i<pararealThreads ; ++i)
+      {
+        threadModels.push_back(Teuchos::rcp(new Thyra::EpetraModelEvaluator(
+          Teuchos::rcp(new ExampleApplication1Dfem(epetra_comm_ptr_,params)),
+          lowsfCreator.createLinearSolveStrategy(""))));
+      }
+
+      *out << "\nParareal strong scaling with " << pararealSlices << " slices, "
+           << "serial integration time = " << serialTime << " s\n\n";
+      *out << std::setw(10) << "threads" << std::setw(12) << "iterations"
+           << std::setw(14) << "time (s)" << std::setw(14) << "fine (s)"
+           << std::setw(14) << "coarse (s)" << std::setw(12) << "speedup" << endl;
+      Teuchos::RCP<const Thyra::VectorBase<double> > x_parareal;
+      for (int numThreads=1 ; numThreads<=pararealThreads ; numThreads*=2)
+      {
+        Teuchos::RCP<Teuchos::ParameterList> driverPL = Teuchos::parameterList();
+        driverPL->set("Number of Time Slices",pararealSlices);
+        driverPL->set("Number of Threads",numThreads);
+        driverPL->set("Convergence Tolerance",double(1e-3*maxError));
+        Teuchos::RCP<Rythmos::PararealIntegrationDriver<double> > driver =
+          Rythmos::pararealIntegrationDriver<double>(
+            model,model_ic,pararealSolver,builderPL,driverPL);
+        driver->setThreadModels(threadModels);
+        x_parareal = driver->integrate();
+        *out << std::setw(10) << driver->getNumThreads()
+             << std::setw(12) << driver->getNumIterations()
+             << std::setw(14) << driver->getWallTime()
+             << std::setw(14) << driver->getFineWallTime()
+             << std::setw(14) << driver->getCoarseWallTime()
+             << std::setw(12) << serialTime/std::max(driver->getWallTime(),1.0e-12)
+             << endl;
+      }
+
+      Teuchos::RCP<const Epetra_Vector>
+        x_parareal_epetra = Thyra::get_Epetra_Vector(*(epetraModel->get_x_map()),x_parareal);
+      Epetra_Vector x_diff(*x_parareal_epetra);
+      x_diff.Update(-1.0,x_star,1.0);
+      double diffNorm = 0.0;
+      double starNorm = 0.0;
+      x_diff.Norm2(&diffNorm);
+      x_star.Norm2(&starNorm);
+      result = Thyra::testMaxErr(
+        "parareal error",diffNorm/starNorm
+        ,"maxError",maxError
+        ,"maxWarning",10.0*maxError
+        ,&std::cerr,""
+        );
+      if(!result) success = false;
+    }
+
+    // Forward sensitivities with respect to np directions of the initial
+    // condition with the same fixed steps.  The np sensitivity columns are
+    // solved for column by column and then in blocks of --sens-block-size
+    // columns, and the time over the state-only integration is reported.
+    if (sensMaxNp > 0)
+    {
+      TEUCHOS_TEST_FOR_EXCEPTION(
+        method_val != METHOD_BE, std::logic_error,
+        "Error, --sens-max-np is only supported with --method=BE!"
+        );
+
+      *out << "\nForward sensitivity solves with \"Sensitivity Solve Block Size\" = 1"
+           << " and " << sensBlockSize << ", "
+           << "state integration time = " << serialTime << " s\n\n";
+      *out << std::setw(8) << "np"
+           << std::setw(14) << "sens 1 (s)" << std::setw(14) << "per column"
+           << std::setw(14) << "sens B (s)" << std::setw(14) << "per column"
+           << std::setw(12) << "speedup" << endl;
+
+      Thyra::seed_randomize<double>(0);
+      for (int np=1 ; np<=sensMaxNp ; np*=2)
+      {
+        Teuchos::RCP<const Thyra::VectorSpaceBase<double> >
+          p_space = Thyra::defaultSpmdVectorSpace<double>(np);
+        Teuchos::RCP<Thyra::MultiVectorBase<double> >
+          S_init = Thyra::createMembers(model->get_x_space(),np);
+        Thyra::randomize(-1.0,1.0,S_init.ptr());
+
+        const int blockSizes[] = { 1, sensBlockSize };
+        double sensTime[2] = { 0.0, 0.0 };
+        Teuchos::RCP<const Thyra::VectorBase<double> > x_bar_final[2];
+        for (int k=0 ; k<2 ; ++k)
+        {
+          Teuchos::RCP<Rythmos::TimeStepNonlinearSolver<double> >
+            sensSolver = Teuchos::rcp(new Rythmos::TimeStepNonlinearSolver<double>());
+          Teuchos::RCP<Teuchos::ParameterList>
+            nonlinearSolverPL = Teuchos::parameterList();
+          nonlinearSolverPL->set("Default Tol",double(1e-3*maxError));
+          sensSolver->setParameterList(nonlinearSolverPL);
+          Teuchos::RCP<Rythmos::StepperBase<double> > stateStepper =
+            Teuchos::rcp(new Rythmos::BackwardEulerStepper<double>(model,sensSolver));
+
+          Teuchos::RCP<Rythmos::ForwardSensitivityStepper<double> >
+            fwdSensStepper = Rythmos::forwardSensitivityStepper<double>();
+          Teuchos::RCP<Teuchos::ParameterList>
+            fwdSensPL = Teuchos::parameterList();
+          fwdSensPL->set("Sensitivity Solve Block Size",blockSizes[k]);
+          fwdSensStepper->setParameterList(fwdSensPL);
+          fwdSensStepper->initializeSyncedSteppersInitCondOnly(
+            model, p_space, model_ic, stateStepper, sensSolver );
+          fwdSensStepper->setInitialCondition(
+            Rythmos::createStateAndSensInitialCondition<double>(
+              *fwdSensStepper, model_ic, S_init ) );
+
+          const double sensStartTime = Teuchos::Time::wallTime();
+          for (int i=1 ; i<=N ; ++i)
+          {
+            const double dt_taken = fwdSensStepper->takeStep(dt,Rythmos::STEP_TYPE_FIXED);
+            TEUCHOS_TEST_FOR_EXCEPTION(
+              dt_taken != dt, std::logic_error,
+              "Error, the forward sensitivity stepper took step of dt = "
+              << dt_taken << " when asked to take step of dt = " << dt << "!"
+              );
+          }
+          sensTime[k] = Teuchos::Time::wallTime() - sensStartTime - serialTime;
+          x_bar_final[k] = fwdSensStepper->getStepStatus().solution;
+        }
+
+        *out << std::setw(8) << np
+             << std::setw(14) << sensTime[0] << std::setw(14) << sensTime[0]/np
+             << std::setw(14) << sensTime[1] << std::setw(14) << sensTime[1]/np
+             << std::setw(12) << sensTime[0]/std::max(sensTime[1],1.0e-12)
+             << endl;
+
+        // Blocking the solves must not change the answer beyond the linear
+        // solver tolerance.
+        Teuchos::RCP<Thyra::VectorBase<double> >
+          x_bar_diff = x_bar_final[1]->clone_v();
+        Thyra::Vp_StV(x_bar_diff.ptr(),-1.0,*x_bar_final[0]);
+        result = Thyra::testMaxErr(
+          "blocked sensitivity solve difference",
+          Thyra::norm_2(*x_bar_diff)/Thyra::norm_2(*x_bar_final[0])
+          ,"maxError",maxError
+          ,"maxWarning",10.0*maxError
+          ,&std::cerr,""
+          );
+        if(!result) success = false;
+      }
+    }
+
     // Write the final parameters to file
     if(W_factory.get())
       lowsfCreator.writeParamsFile(*W_factory);
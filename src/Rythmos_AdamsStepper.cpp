@@ -0,0 +1,17 @@
+#include "Rythmos_AdamsStepper_decl.hpp"
+
+#ifdef HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
+
+#include "Rythmos_AdamsStepper_def.hpp"
+#include "Rythmos_ExplicitInstantiationHelpers.hpp"
+
+namespace Rythmos {
+
+RYTHMOS_MACRO_TEMPLATE_INSTANT_SCALAR_TYPES(RYTHMOS_ADAMS_STEPPER_INSTANT) 
+
+} // namespace Rythmos
+
+#endif // HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
+
+
+
@@ -0,0 +1,5 @@
+#include "Rythmos_AdamsStepper_decl.hpp"
+#ifndef HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
+#include "Rythmos_AdamsStepper_def.hpp"
+#endif
+
@@ -0,0 +1,354 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_ADAMS_STEPPER_DECL_H
+#define Rythmos_ADAMS_STEPPER_DECL_H
+
+#include "Rythmos_StepperBase.hpp"
+#include "Rythmos_ErrWtVecCalcBase.hpp"
+
+#include "Thyra_VectorBase.hpp"
+#include "Thyra_ModelEvaluator.hpp"
+
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+#include "Teuchos_as.hpp"
+
+
+namespace Rythmos {
+
+/** \brief Variable order, variable step size Adams-Bashforth-Moulton
+ * stepper for explicit ODEs.
+ *
+ * This stepper is the explicit sibling of <tt>ImplicitBDFStepper</tt>.  It
+ * keeps the same modified divided difference history and the same
+ * <tt>psi</tt>, <tt>alpha</tt>, <tt>beta</tt> and <tt>sigma</tt>
+ * coefficients, but the history holds differences of <tt>f</tt> instead of
+ * <tt>x</tt>.  A step of order <tt>k</tt> (1 <= k <= 12) is taken as
+ *
+ \verbatim
+
+   P:  x_pred = x_n + h * sum_{i=0}^{k-1} g_i * phi*_i
+   E:  f_pred = f(x_pred,t_n+h)
+   C:  x_{n+1} = x_pred + h * g_{k-1} * ( f_pred - sum_{i=0}^{k-1} phi*_i )
+   E:  f_{n+1} = f(x_{n+1},t_n+h)
+
+ \endverbatim
+ *
+ * i.e. an Adams-Bashforth predictor of order <tt>k</tt> followed by the
+ * Adams-Moulton corrector of order <tt>k</tt> solved with functional
+ * iteration, so no Jacobian or linear solve is ever needed.  The number of
+ * corrector evaluations sets the number of functional iterations: 1 (the
+ * default) gives PECE with two evaluations of <tt>f</tt> per step, and 0
+ * gives PEC with one evaluation per step, where <tt>f_pred</tt> is kept in
+ * the history.
+ *
+ * The local error is estimated from the difference of the order <tt>k</tt>
+ * and order <tt>k+1</tt> correctors and measured in the WRMS norm of
+ * <tt>ImplicitBDFStepperErrWtVecCalc</tt>.  Step size and order are chosen
+ * as in the DE/STEP code of Shampine and Gordon ("Computer Solution of
+ * Ordinary Differential Equations", 1975): the order and the step size are
+ * both raised in an initial phase, later the order is lowered or raised when
+ * the estimated error at order <tt>k-1</tt> or <tt>k+1</tt> is smaller, and
+ * the step size is only changed when the error estimate calls for it, so
+ * long runs of constant step size keep the coefficients fixed.
+ *
+ * Adams methods have small stability regions, so this stepper is meant for
+ * non-stiff problems with expensive right hand sides; use
+ * <tt>ImplicitBDFStepper</tt> for stiff problems.
+ */
+template<class Scalar>
+class AdamsStepper : virtual public StepperBase<Scalar>
+{
+public:
+
+  /** \brief . */
+  typedef typename Teuchos::ScalarTraits<Scalar>::magnitudeType ScalarMag;
+
+  /** \name Constructors, intializers, Misc. */
+  //@{
+
+  /** \brief . */
+  AdamsStepper();
+
+  /** \brief . */
+  const Thyra::VectorBase<Scalar>& getfHistory(int index) const;
+
+  /** \brief Set the error weight vector calculator.
+   *
+   * The default is <tt>ImplicitBDFStepperErrWtVecCalc</tt>.
+   */
+  void setErrWtVecCalc(const RCP<ErrWtVecCalcBase<Scalar> >& errWtVecCalc);
+
+  /** \brief . */
+  RCP<const ErrWtVecCalcBase<Scalar> > getErrWtVecCalc() const;
+
+  /** \brief Number of evaluations of the model since the last call to
+   * <tt>setInitialCondition()</tt>, including the one for the initial
+   * history and those of rejected steps. */
+  int getNumModelEvaluations() const;
+
+  //@}
+
+  /** \name Overridden from StepperBase */
+  //@{
+
+  /** \brief Returns false. */
+  bool isImplicit() const;
+
+  /** \brief Returns true. */
+  bool supportsCloning() const;
+
+  /** \brief . */
+  RCP<StepperBase<Scalar> > cloneStepperAlgorithm() const;
+
+  /** \brief . */
+  void setModel(const RCP<const Thyra::ModelEvaluator<Scalar> >& model);
+
+  /** \brief . */
+  void setNonconstModel(const RCP<Thyra::ModelEvaluator<Scalar> >& model);
+
+  /** \brief . */
+  RCP<const Thyra::ModelEvaluator<Scalar> > getModel() const;
+
+  /** \brief . */
+  RCP<Thyra::ModelEvaluator<Scalar> > getNonconstModel();
+
+  /** \brief . */
+  void setInitialCondition(
+    const Thyra::ModelEvaluatorBase::InArgs<Scalar> &initialCondition
+    );
+
+  /** \brief . */
+  Thyra::ModelEvaluatorBase::InArgs<Scalar> getInitialCondition() const;
+
+  /** \brief Take a step.
+   *
+   * With <tt>STEP_TYPE_FIXED</tt> the step size is <tt>dt</tt> and only the
+   * order is selected; a failed local error test is reported but the step
+   * is kept.  With <tt>STEP_TYPE_VARIABLE</tt>, <tt>dt</tt> is an upper
+   * bound on the step size.
+   */
+  Scalar takeStep(Scalar dt, StepSizeType flag);
+
+  /** \brief . */
+  const StepStatus<Scalar> getStepStatus() const;
+
+  //@}
+
+  /** \name Overridden from InterpolationBufferBase */
+  //@{
+
+  /** \brief . */
+  RCP<const Thyra::VectorSpaceBase<Scalar> >
+  get_x_space() const;
+
+  /** \brief . */
+  void addPoints(
+    const Array<Scalar>& time_vec
+    ,const Array<RCP<const Thyra::VectorBase<Scalar> > >& x_vec
+    ,const Array<RCP<const Thyra::VectorBase<Scalar> > >& xdot_vec
+    );
+
+  /** \brief . */
+  TimeRange<Scalar> getTimeRange() const;
+
+  /** \brief Interpolate with the Adams polynomial of the last step. */
+  void getPoints(
+    const Array<Scalar>& time_vec
+    ,Array<RCP<const Thyra::VectorBase<Scalar> > >* x_vec
+    ,Array<RCP<const Thyra::VectorBase<Scalar> > >* xdot_vec
+    ,Array<ScalarMag>* accuracy_vec
+    ) const;
+
+  /** \brief . */
+  void getNodes(Array<Scalar>* time_vec) const;
+
+  /** \brief . */
+  void removeNodes(Array<Scalar>& time_vec);
+
+  /** \brief . */
+  int getOrder() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::ParameterListAcceptor */
+  //@{
+
+  /** \brief . */
+  void setParameterList(RCP<Teuchos::ParameterList> const& paramList);
+
+  /** \brief . */
+  RCP<Teuchos::ParameterList> getNonconstParameterList();
+
+  /** \brief . */
+  RCP<Teuchos::ParameterList> unsetParameterList();
+
+  /** \brief . */
+  RCP<const Teuchos::ParameterList> getValidParameters() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::Describable */
+  //@{
+
+  /** \brief . */
+  std::string description() const;
+
+  /** \brief . */
+  void describe(
+    Teuchos::FancyOStream &out,
+    const Teuchos::EVerbosityLevel verbLevel
+    ) const;
+
+  //@}
+
+private:
+
+  //
+  // Private data members
+  //
+
+  RCP<const Thyra::ModelEvaluator<Scalar> > model_;
+  RCP<ErrWtVecCalcBase<Scalar> > errWtVecCalc_;
+
+  RCP<Thyra::VectorBase<Scalar> > xn_;  // solution at time_
+  RCP<Thyra::VectorBase<Scalar> > xn0_; // predictor, then corrector
+  RCP<Thyra::VectorBase<Scalar> > fn0_; // f(xn0_)
+  RCP<Thyra::VectorBase<Scalar> > fSum_; // sum of the predicted differences
+  RCP<Thyra::VectorBase<Scalar> > ee_;  // f(xn0_) - fSum_
+  RCP<Thyra::VectorBase<Scalar> > delta_;
+  RCP<Thyra::VectorBase<Scalar> > errWtVec_;
+  Array<RCP<Thyra::VectorBase<Scalar> > > fHistory_; // $\phi_j(n)$
+
+  Scalar time_;
+
+  Thyra::ModelEvaluatorBase::InArgs<Scalar> basePoint_;
+
+  Scalar hh_;        // Current step-size
+  int currentOrder_; // Current order of integration
+  int minOrder_;
+  int maxOrder_;     // maximum order <= 12
+  int usedOrder_;    // order used in current step (used after currentOrder is updated)
+  Array<Scalar> alpha_;    // $\alpha_j(n)=h_n/\psi_j(n)$
+  Array<Scalar> beta_;     // coefficients used to evaluate predictor from history array
+  Array<Scalar> psi_;      // $\psi_j(n) = t_n-t_{n-j}$
+  Array<Scalar> sigma_;    // $\sigma_j(n) = \frac{h_n^j(j-1)!}{\psi_1(n)*\cdots *\psi_j(n)}$
+  Array<Scalar> g_;        // $g_j(n)$ integration coefficients of the Adams formulas
+  Array<Scalar> gstar_;    // constant step error constants of the Adams-Moulton formulas
+  Scalar LETvalue_;   // error norm of the current step
+  EStepLETStatus stepLETStatus_; // Local Error Test Status
+  Scalar Ek_;   // error estimates at orders k, k-1, k-2 and k+1
+  Scalar Ekm1_;
+  Scalar Ekm2_;
+  Scalar Ekp1_;
+  int newOrder_;
+  bool initialPhase_;
+  int numberOfSteps_;// number of total time integration steps taken
+  int nef_; // number of error failures
+  Scalar usedStep_;
+  int nscsco_; // number of steps taken with constant step size
+  Scalar maxTimeStep_;
+  StepSizeType stepSizeType_;
+  bool haveInitialCondition_;
+  bool isInitialized_;
+
+  ScalarMag relErrTol_;
+  ScalarMag absErrTol_;
+  int correctorEvaluations_;
+  int maxLETFail_;
+  int numModelEvaluations_;
+
+  RCP<Teuchos::ParameterList> parameterList_;
+
+  static const std::string minOrder_name_;
+  static const int minOrder_default_;
+  static const std::string maxOrder_name_;
+  static const int maxOrder_default_;
+  static const std::string relErrTol_name_;
+  static const double relErrTol_default_;
+  static const std::string absErrTol_name_;
+  static const double absErrTol_default_;
+  static const std::string correctorEvaluations_name_;
+  static const int correctorEvaluations_default_;
+  static const std::string maxLETFail_name_;
+  static const int maxLETFail_default_;
+
+  //
+  // Private member functions
+  //
+
+  void defaultInitializeAll_();
+  void initialize_();
+  void getFirstTimeStep_();
+  void updateCoeffs_();
+  void obtainPredictor_();
+  void evaluateCorrector_();
+  void estimateErrors_();
+  void restoreHistory_();
+  void updateHistory_();
+  void selectOrderAndStepSize_();
+  void rejectStep_();
+  void completeStep_();
+  void interpolateSolution_(
+    const Scalar& timepoint,
+    Thyra::VectorBase<Scalar>* x_ptr_,
+    Thyra::VectorBase<Scalar>* xdot_ptr_,
+    ScalarMag* accuracy_ptr_
+    ) const;
+  void evalModel_(
+    const Thyra::VectorBase<Scalar>& x,
+    Scalar t,
+    Thyra::VectorBase<Scalar>* f
+    );
+  Scalar wRMSNorm_(const Thyra::VectorBase<Scalar>& vector) const;
+
+};
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates AdamsStepper
+ */
+template<class Scalar>
+RCP<AdamsStepper<Scalar> > adamsStepper();
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates AdamsStepper
+ */
+template<class Scalar>
+RCP<AdamsStepper<Scalar> > adamsStepper(
+  const RCP<const Thyra::ModelEvaluator<Scalar> >& model
+  );
+
+
+} // namespace Rythmos
+
+#endif // Rythmos_ADAMS_STEPPER_DECL_H
@@ -0,0 +1,1184 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_ADAMS_STEPPER_DEF_H
+#define Rythmos_ADAMS_STEPPER_DEF_H
+
+#include "Rythmos_AdamsStepper_decl.hpp"
+#include "Rythmos_StepperHelpers.hpp"
+#include "Rythmos_ImplicitBDFStepperErrWtVecCalc.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+
+namespace Rythmos {
+
+// ////////////////////////////
+// Defintions
+
+// Nonmember constructors
+template<class Scalar>
+RCP<AdamsStepper<Scalar> > adamsStepper()
+{
+  RCP<AdamsStepper<Scalar> >
+    stepper = Teuchos::rcp(new AdamsStepper<Scalar>());
+  return stepper;
+}
+
+template<class Scalar>
+RCP<AdamsStepper<Scalar> > adamsStepper(
+  const RCP<const Thyra::ModelEvaluator<Scalar> >& model
+  )
+{
+  RCP<AdamsStepper<Scalar> >
+    stepper = Teuchos::rcp(new AdamsStepper<Scalar>());
+  stepper->setModel(model);
+  return stepper;
+}
+
+
+// Static members
+
+
+template<class Scalar>
+const std::string
+AdamsStepper<Scalar>::minOrder_name_ = "Minimum Order";
+
+template<class Scalar>
+const int
+AdamsStepper<Scalar>::minOrder_default_ = 1;
+
+template<class Scalar>
+const std::string
+AdamsStepper<Scalar>::maxOrder_name_ = "Maximum Order";
+
+template<class Scalar>
+const int
+AdamsStepper<Scalar>::maxOrder_default_ = 12;
+
+template<class Scalar>
+const std::string
+AdamsStepper<Scalar>::relErrTol_name_ = "Relative Error Tolerance";
+
+template<class Scalar>
+const double
+AdamsStepper<Scalar>::relErrTol_default_ = 1.0e-4;
+
+template<class Scalar>
+const std::string
+AdamsStepper<Scalar>::absErrTol_name_ = "Absolute Error Tolerance";
+
+template<class Scalar>
+const double
+AdamsStepper<Scalar>::absErrTol_default_ = 1.0e-6;
+
+template<class Scalar>
+const std::string
+AdamsStepper<Scalar>::correctorEvaluations_name_ = "Corrector Evaluations";
+
+template<class Scalar>
+const int
+AdamsStepper<Scalar>::correctorEvaluations_default_ = 1;
+
+template<class Scalar>
+const std::string
+AdamsStepper<Scalar>::maxLETFail_name_ = "Maximum Local Error Test Failures";
+
+template<class Scalar>
+const int
+AdamsStepper<Scalar>::maxLETFail_default_ = 15;
+
+
+// Constructors, intializers, Misc.
+
+
+template<class Scalar>
+AdamsStepper<Scalar>::AdamsStepper()
+{
+  this->defaultInitializeAll_();
+}
+
+
+template<class Scalar>
+const Thyra::VectorBase<Scalar>&
+  AdamsStepper<Scalar>::getfHistory(int index) const
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(!isInitialized_,std::logic_error,
+      "Error, attempting to call getfHistory before initialization!\n");
+  TEUCHOS_TEST_FOR_EXCEPT( !(( 0 <= index ) && ( index <= usedOrder_+1 )) );
+  return(*(fHistory_[index]));
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::setErrWtVecCalc(
+  const RCP<ErrWtVecCalcBase<Scalar> >& errWtVecCalc
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(errWtVecCalc));
+  errWtVecCalc_ = errWtVecCalc;
+}
+
+
+template<class Scalar>
+RCP<const ErrWtVecCalcBase<Scalar> >
+AdamsStepper<Scalar>::getErrWtVecCalc() const
+{
+  return(errWtVecCalc_);
+}
+
+
+template<class Scalar>
+int AdamsStepper<Scalar>::getNumModelEvaluations() const
+{
+  return numModelEvaluations_;
+}
+
+
+// Overridden from StepperBase
+
+
+template<class Scalar>
+bool AdamsStepper<Scalar>::isImplicit() const
+{
+  return false;
+}
+
+
+template<class Scalar>
+bool AdamsStepper<Scalar>::supportsCloning() const
+{
+  return true;
+}
+
+
+template<class Scalar>
+RCP<StepperBase<Scalar> >
+AdamsStepper<Scalar>::cloneStepperAlgorithm() const
+{
+
+  // Just use the interface to clone the algorithm in an basically
+  // uninitialized state
+
+  RCP<AdamsStepper<Scalar> >
+    stepper = Teuchos::rcp(new AdamsStepper<Scalar>());
+
+  if (!is_null(model_))
+    stepper->setModel(model_); // Shallow copy is okay!
+
+  if (!is_null(parameterList_))
+    stepper->setParameterList(Teuchos::parameterList(*parameterList_));
+
+  if (!is_null(errWtVecCalc_))
+    stepper->setErrWtVecCalc(errWtVecCalc_); // The calculator is stateless
+
+  return stepper;
+
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::setModel(
+  const RCP<const Thyra::ModelEvaluator<Scalar> >& model
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT( is_null(model) );
+  assertValidModel( *this, *model );
+  model_ = model;
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::setNonconstModel(
+  const RCP<Thyra::ModelEvaluator<Scalar> >& model
+  )
+{
+  this->setModel(model);
+}
+
+
+template<class Scalar>
+RCP<const Thyra::ModelEvaluator<Scalar> >
+AdamsStepper<Scalar>::getModel() const
+{
+  return model_;
+}
+
+
+template<class Scalar>
+RCP<Thyra::ModelEvaluator<Scalar> >
+AdamsStepper<Scalar>::getNonconstModel()
+{
+  return Teuchos::null;
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::setInitialCondition(
+  const Thyra::ModelEvaluatorBase::InArgs<Scalar> &initialCondition
+  )
+{
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  typedef Thyra::ModelEvaluatorBase MEB;
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(initialCondition.get_x()), std::logic_error,
+    "Error, if the client passes in an intial condition to "
+    "setInitialCondition(...), then x can not be null!" );
+  basePoint_ = initialCondition;
+  xn_ = initialCondition.get_x()->clone_v();
+  time_ =
+    (
+      initialCondition.supports(MEB::IN_ARG_t)
+      ? initialCondition.get_t()
+      : ST::zero()
+      );
+  fHistory_.clear();
+  numModelEvaluations_ = 0;
+  haveInitialCondition_ = true;
+  isInitialized_ = false;
+}
+
+
+template<class Scalar>
+Thyra::ModelEvaluatorBase::InArgs<Scalar>
+AdamsStepper<Scalar>::getInitialCondition() const
+{
+  return basePoint_;
+}
+
+
+template<class Scalar>
+Scalar AdamsStepper<Scalar>::takeStep(Scalar dt, StepSizeType stepType)
+{
+
+  RYTHMOS_FUNC_TIME_MONITOR("Rythmos::AdamsStepper::takeStep");
+
+  using Teuchos::as;
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+
+  RCP<Teuchos::FancyOStream> out = this->getOStream();
+  Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+  Teuchos::OSTab ostab(out,1,"takeStep");
+
+  if ( !is_null(out) && as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW) ) {
+    *out
+      << "\nEntering " << this->Teuchos::Describable::description()
+      << "::takeStep("<<dt<<","<<toString(stepType)<<") ...\n";
+  }
+
+  if (dt <= ST::zero()) {
+    if ( !is_null(out) && as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW) )
+      *out << "\nThe arguments to takeStep are not valid for "
+           << "AdamsStepper at this time.\n"
+           << "  dt = " << dt << "\n"
+           << "AdamsStepper requires positive dt.\n" << std::endl;
+    return(Scalar(-ST::one()));
+  }
+
+  if (!isInitialized_) {
+    initialize_();
+  }
+
+  stepSizeType_ = stepType;
+  maxTimeStep_ = dt;
+  errWtVecCalc_->errWtVecSet(&*errWtVec_,*xn_,relErrTol_,absErrTol_);
+  if ( (numberOfSteps_ == 0) && (nef_ == 0) ) {
+    getFirstTimeStep_();
+  }
+
+  while (1) {
+    if (stepSizeType_ == STEP_TYPE_FIXED) {
+      hh_ = dt;
+    } else {
+      hh_ = std::min(hh_,maxTimeStep_);
+    }
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      hh_ <= 4*ST::eps()*std::abs(time_), std::runtime_error,
+      "Error, the step size hh_ = " << hh_ << " is too small at time_ = "
+      << time_ << "!\n");
+    updateCoeffs_();
+    // P: compute the Adams-Bashforth predictor
+    obtainPredictor_();
+    // E: evaluate f at the predictor
+    evalModel_(*xn0_,time_+hh_,&*fn0_);
+    V_StVpStV( ee_.ptr(), ST::one(), *fn0_, Scalar(-ST::one()), *fSum_ );
+    // Check the local error of the order currentOrder_ corrector
+    estimateErrors_();
+
+    if ( as<int>(verbLevel) >= as<int>(Teuchos::VERB_HIGH) ) {
+      *out << "hh_ = " << hh_ << std::endl;
+      *out << "currentOrder_ = " << currentOrder_ << std::endl;
+      *out << "LETvalue_ = " << LETvalue_ << std::endl;
+    }
+
+    if (LETvalue_ <= ST::one()) {
+      stepLETStatus_ = STEP_LET_STATUS_PASSED;
+      break;
+    }
+    stepLETStatus_ = STEP_LET_STATUS_FAILED;
+    if (stepSizeType_ == STEP_TYPE_FIXED) {
+      if ( !is_null(out) && as<int>(verbLevel) != as<int>(Teuchos::VERB_NONE) ) {
+        *out
+          << "Warning:  Local error test failed with constant step-size."
+          << std::endl;
+      }
+      break;
+    }
+    rejectStep_();
+  }
+
+  // C(E): correct with Adams-Moulton and evaluate
+  evaluateCorrector_();
+  completeStep_();
+  selectOrderAndStepSize_();
+
+  if ( !is_null(out) && as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW) ) {
+    *out
+      << "\nLeaving " << this->Teuchos::Describable::description()
+      << "::takeStep("<<dt<<","<<toString(stepType)<<") ...\n";
+  }
+
+  return(usedStep_);
+}
+
+
+template<class Scalar>
+const StepStatus<Scalar> AdamsStepper<Scalar>::getStepStatus() const
+{
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  StepStatus<Scalar> stepStatus;
+  if (!haveInitialCondition_) {
+    stepStatus.message = "This stepper is uninitialized.";
+    stepStatus.stepStatus = STEP_STATUS_UNINITIALIZED;
+    stepStatus.stepSize = Scalar(-ST::one());
+    stepStatus.order = -1;
+    stepStatus.time = Scalar(-ST::one());
+    return(stepStatus);
+  }
+  else if (numberOfSteps_ > 0) {
+    stepStatus.stepStatus = STEP_STATUS_CONVERGED;
+  } else {
+    stepStatus.stepStatus = STEP_STATUS_UNKNOWN;
+  }
+  stepStatus.stepLETStatus = stepLETStatus_;
+  stepStatus.stepSize = usedStep_;
+  stepStatus.order = usedOrder_;
+  stepStatus.time = time_;
+  stepStatus.stepLETValue = LETvalue_;
+  stepStatus.solution = xn_;
+  stepStatus.solutionDot = Teuchos::null;
+  stepStatus.residual = Teuchos::null;
+  return(stepStatus);
+}
+
+
+// Overridden from InterpolationBufferBase
+
+
+template<class Scalar>
+RCP<const Thyra::VectorSpaceBase<Scalar> >
+AdamsStepper<Scalar>::get_x_space() const
+{
+  return ( !is_null(model_) ? model_->get_x_space() : Teuchos::null );
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::addPoints(
+  const Array<Scalar>& /* time_vec */,
+  const Array<RCP<const Thyra::VectorBase<Scalar> > >& /* x_vec */,
+  const Array<RCP<const Thyra::VectorBase<Scalar> > >& /* xdot_vec */
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(true,std::logic_error,
+    "Error, addPoints is not implemented for AdamsStepper.\n");
+}
+
+
+template<class Scalar>
+TimeRange<Scalar> AdamsStepper<Scalar>::getTimeRange() const
+{
+  if (!haveInitialCondition_)
+    return invalidTimeRange<Scalar>();
+  if (numberOfSteps_ <= 0)
+    return timeRange<Scalar>(time_,time_);
+  return timeRange<Scalar>(time_-usedStep_,time_);
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::getPoints(
+  const Array<Scalar>& time_vec
+  ,Array<RCP<const Thyra::VectorBase<Scalar> > >* x_vec
+  ,Array<RCP<const Thyra::VectorBase<Scalar> > >* xdot_vec
+  ,Array<ScalarMag>* accuracy_vec) const
+{
+  using Teuchos::constOptInArg;
+  using Teuchos::null;
+  using Teuchos::ptr;
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+
+  TEUCHOS_ASSERT(haveInitialCondition_);
+  if (numberOfSteps_ <= 0) {
+    // Only the initial condition is available.
+    defaultGetPoints<Scalar>(
+        time_, constOptInArg(*xn_), Ptr<const VectorBase<Scalar> >(null),
+        time_, constOptInArg(*xn_), Ptr<const VectorBase<Scalar> >(null),
+        time_vec, ptr(x_vec), ptr(xdot_vec), ptr(accuracy_vec),
+        Ptr<InterpolatorBase<Scalar> >(null)
+        );
+    return;
+  }
+  RYTHMOS_FUNC_TIME_MONITOR("Rythmos::AdamsStepper::getPoints");
+  if (x_vec)
+    x_vec->clear();
+  if (xdot_vec)
+    xdot_vec->clear();
+  if (accuracy_vec)
+    accuracy_vec->clear();
+  for (Teuchos::Ordinal i=0 ; i<time_vec.size() ; ++i) {
+    RCP<Thyra::VectorBase<Scalar> >
+      x_temp = createMember(xn_->space());
+    RCP<Thyra::VectorBase<Scalar> >
+      xdot_temp = createMember(xn_->space());
+    ScalarMag accuracy = -ST::zero();
+    interpolateSolution_(
+      time_vec[i], &*x_temp, &*xdot_temp,
+      accuracy_vec ? &accuracy : 0
+      );
+    if (x_vec)
+      x_vec->push_back(x_temp);
+    if (xdot_vec)
+      xdot_vec->push_back(xdot_temp);
+    if (accuracy_vec)
+      accuracy_vec->push_back(accuracy);
+  }
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::getNodes(Array<Scalar>* time_vec) const
+{
+  TEUCHOS_ASSERT( time_vec != NULL );
+  time_vec->clear();
+  if (!haveInitialCondition_) {
+    return;
+  }
+  if (numberOfSteps_ > 0) {
+    time_vec->push_back(time_-usedStep_);
+  }
+  time_vec->push_back(time_);
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::removeNodes(Array<Scalar>& /* time_vec */)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(true,std::logic_error,
+    "Error, removeNodes is not implemented for AdamsStepper.\n");
+}
+
+
+template<class Scalar>
+int AdamsStepper<Scalar>::getOrder() const
+{
+  if (!isInitialized_) {
+    return(-1);
+  }
+  return(usedOrder_);
+}
+
+
+// Overridden from Teuchos::ParameterListAcceptor
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::setParameterList(
+  RCP<Teuchos::ParameterList> const& paramList
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(paramList == Teuchos::null);
+  paramList->validateParametersAndSetDefaults(*this->getValidParameters(),0);
+  parameterList_ = paramList;
+  Teuchos::readVerboseObjectSublist(&*parameterList_,this);
+
+  minOrder_ = parameterList_->get<int>(minOrder_name_);
+  maxOrder_ = parameterList_->get<int>(maxOrder_name_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+      !((1 <= minOrder_) && (minOrder_ <= maxOrder_) && (maxOrder_ <= 12)),
+      std::logic_error,
+      "Error, \"" << minOrder_name_ << "\" = " << minOrder_ << " and \""
+      << maxOrder_name_ << "\" = " << maxOrder_
+      << " must satisfy 1 <= min <= max <= 12!\n"
+      );
+  relErrTol_ = parameterList_->get<double>(relErrTol_name_);
+  absErrTol_ = parameterList_->get<double>(absErrTol_name_);
+  correctorEvaluations_ = parameterList_->get<int>(correctorEvaluations_name_);
+  TEUCHOS_TEST_FOR_EXCEPTION( correctorEvaluations_ < 0, std::logic_error,
+    "Error, \"" << correctorEvaluations_name_ << "\" = "
+    << correctorEvaluations_ << " can not be negative!\n"
+    );
+  maxLETFail_ = parameterList_->get<int>(maxLETFail_name_);
+  isInitialized_ = false;
+}
+
+
+template<class Scalar>
+RCP<Teuchos::ParameterList> AdamsStepper<Scalar>::getNonconstParameterList()
+{
+  return(parameterList_);
+}
+
+
+template<class Scalar>
+RCP<Teuchos::ParameterList>
+AdamsStepper<Scalar>::unsetParameterList()
+{
+  RCP<Teuchos::ParameterList> temp_param_list = parameterList_;
+  parameterList_ = Teuchos::null;
+  return(temp_param_list);
+}
+
+
+template<class Scalar>
+RCP<const Teuchos::ParameterList>
+AdamsStepper<Scalar>::getValidParameters() const
+{
+  static RCP<Teuchos::ParameterList> validPL;
+  if (is_null(validPL)) {
+    RCP<Teuchos::ParameterList> pl = Teuchos::parameterList();
+    pl->set<int>( minOrder_name_, minOrder_default_,
+      "Lower limit of order selection.  The first steps are taken at lower "
+      "order until this order is reached.");
+    pl->set<int>( maxOrder_name_, maxOrder_default_,
+      "Upper limit of order selection, at most 12.");
+    pl->set<double>( relErrTol_name_, relErrTol_default_,
+      "Relative tolerance value used in WRMS calculation.");
+    pl->set<double>( absErrTol_name_, absErrTol_default_,
+      "Absolute tolerance value used in WRMS calculation.");
+    pl->set<int>( correctorEvaluations_name_, correctorEvaluations_default_,
+      "Number of evaluations of f after each correction.  1 gives PECE with "
+      "two evaluations per step, 0 gives PEC with one evaluation per step, "
+      "and larger values add functional iterations of the corrector.");
+    pl->set<int>( maxLETFail_name_, maxLETFail_default_,
+      "Number of successive local error test failures before the step is "
+      "abandoned with an exception.");
+    Teuchos::setupVerboseObjectSublist(&*pl);
+    validPL = pl;
+  }
+  return (validPL);
+}
+
+
+// Overridden from Teuchos::Describable
+
+
+template<class Scalar>
+std::string AdamsStepper<Scalar>::description() const
+{
+  std::ostringstream out;
+  out << this->Teuchos::Describable::description();
+  const TimeRange<Scalar> timeRange = this->getTimeRange();
+  if (timeRange.isValid())
+    out << " (timeRange="<<timeRange<<")";
+  else
+    out << " (This stepper is not initialized yet)";
+  out << std::endl;
+  return out.str();
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::describe(
+  Teuchos::FancyOStream &out,
+  const Teuchos::EVerbosityLevel verbLevel
+  ) const
+{
+
+  using Teuchos::as;
+
+  if (!isInitialized_) {
+    out << this->description();
+    return;
+  }
+
+  if ( (as<int>(verbLevel) == as<int>(Teuchos::VERB_DEFAULT) ) ||
+    (as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW)     )
+    )
+  {
+    out << this->description() << std::endl;
+    out << "model_ = " << Teuchos::describe(*model_,verbLevel);
+  }
+  if (as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW)) {
+    out << "time_ = " << time_ << std::endl;
+    out << "hh_ = " << hh_ << std::endl;
+    out << "currentOrder_ = " << currentOrder_ << std::endl;
+    out << "numModelEvaluations_ = " << numModelEvaluations_ << std::endl;
+  }
+  if (as<int>(verbLevel) >= as<int>(Teuchos::VERB_HIGH)) {
+    out << "xn_ = " << Teuchos::describe(*xn_,verbLevel);
+    for (int i=0 ; i <= usedOrder_+1 ; ++i) {
+      out << "fHistory_[" << i << "] = "
+          << Teuchos::describe(*fHistory_[i],verbLevel);
+    }
+  }
+}
+
+
+// private
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::defaultInitializeAll_()
+{
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  const Scalar nan = ST::nan(), one = ST::one(), zero = ST::zero();
+  haveInitialCondition_ = false;
+  isInitialized_ = false;
+  currentOrder_ = 1;
+  usedOrder_ = 1;
+  usedStep_ = zero;
+  minOrder_ = minOrder_default_;
+  maxOrder_ = maxOrder_default_;
+  relErrTol_ = relErrTol_default_;
+  absErrTol_ = absErrTol_default_;
+  correctorEvaluations_ = correctorEvaluations_default_;
+  maxLETFail_ = maxLETFail_default_;
+  numModelEvaluations_ = 0;
+  // Initialize the rest of the private data members to invalid values to
+  // avoid uninitialed memory
+  time_ = nan;
+  hh_ = nan;
+  maxTimeStep_ = nan;
+  LETvalue_ = -one;
+  stepLETStatus_ = STEP_LET_STATUS_UNKNOWN;
+  Ek_ = -one;
+  Ekm1_ = -one;
+  Ekm2_ = -one;
+  Ekp1_ = -one;
+  newOrder_ = -1;
+  initialPhase_ = false;
+  numberOfSteps_ = -1;
+  nef_ = -1;
+  nscsco_ = -1;
+  stepSizeType_ = STEP_TYPE_VARIABLE;
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::initialize_()
+{
+
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  using Thyra::createMember;
+
+  TEUCHOS_TEST_FOR_EXCEPT(model_ == Teuchos::null);
+  TEUCHOS_ASSERT(haveInitialCondition_);
+
+  // Initialize Parameter List if none provided.
+  if (parameterList_ == Teuchos::null) {
+    RCP<Teuchos::ParameterList> emptyParameterList =
+      Teuchos::rcp(new Teuchos::ParameterList);
+    this->setParameterList(emptyParameterList);
+  }
+
+  if (is_null(errWtVecCalc_)) {
+    errWtVecCalc_ = Teuchos::rcp(new ImplicitBDFStepperErrWtVecCalc<Scalar>());
+  }
+
+  const Scalar zero = ST::zero();
+  RCP<const Thyra::VectorSpaceBase<Scalar> > x_space = model_->get_x_space();
+
+  xn0_ = createMember(x_space);
+  fn0_ = createMember(x_space);
+  fSum_ = createMember(x_space);
+  ee_ = createMember(x_space);
+  delta_ = createMember(x_space);
+  errWtVec_ = createMember(x_space);
+
+  // The history holds maxOrder_+2 differences of f; the first one is f at
+  // the initial condition.
+  fHistory_.clear();
+  for (int i=0 ; i<=maxOrder_+1 ; ++i) {
+    fHistory_.push_back(createMember(x_space));
+    V_S(fHistory_[i].ptr(),zero);
+  }
+  numModelEvaluations_ = 0;
+  evalModel_(*xn_,time_,&*fHistory_[0]);
+
+  alpha_.clear();
+  beta_.clear();
+  psi_.clear();
+  sigma_.clear();
+  g_.clear();
+  for (int i=0 ; i<=maxOrder_ ; ++i) {
+    alpha_.push_back(zero);
+    beta_.push_back(zero);
+    psi_.push_back(zero);
+    sigma_.push_back(zero);
+    g_.push_back(zero);
+  }
+
+  // Constant step error constants |gamma*_k| of the order k Adams-Moulton
+  // formulas from gamma*_0 = 1, gamma*_k = -sum_{j<k} gamma*_j/(k+1-j).
+  Array<Scalar> gammaStar(maxOrder_+2,zero);
+  gammaStar[0] = ST::one();
+  gstar_.clear();
+  for (int k=1 ; k<=maxOrder_+1 ; ++k) {
+    for (int j=0 ; j<k ; ++j) {
+      gammaStar[k] -= gammaStar[j]/Scalar(k+1-j);
+    }
+    gstar_.push_back(ST::magnitude(gammaStar[k]));
+  }
+
+  currentOrder_ = 1;
+  usedOrder_ = 1;
+  usedStep_ = zero;
+  hh_ = zero;
+  nscsco_ = 0;
+  LETvalue_ = zero;
+  newOrder_ = 1;
+  initialPhase_ = true;
+  numberOfSteps_ = 0;
+  nef_ = 0;
+
+  isInitialized_ = true;
+
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::getFirstTimeStep_()
+{
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  // Choose the step so that the first forward Euler step changes x by about
+  // a quarter of the tolerance, as in DE/STEP.
+  hh_ = maxTimeStep_;
+  if (stepSizeType_ == STEP_TYPE_VARIABLE) {
+    const Scalar ypnorm = wRMSNorm_(*fHistory_[0]);
+    if (ypnorm > ST::zero()) {
+      hh_ = std::min(hh_, Scalar(0.25/ypnorm));
+    }
+  }
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::updateCoeffs_()
+{
+
+  using Teuchos::as;
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+
+  // Count the steps taken with constant step size.  The estimate of the
+  // error at order k+1 is only reliable after k+1 of them.
+  if (hh_ != usedStep_) {
+    nscsco_ = 0;
+  }
+  nscsco_ = std::min(nscsco_+1,usedOrder_+1);
+  if (numberOfSteps_ == 0) {
+    psi_[0] = hh_;
+  }
+  const int k = currentOrder_;
+  beta_[0] = ST::one();
+  alpha_[0] = ST::one();
+  sigma_[0] = ST::one();
+  Scalar temp1 = hh_;
+  for (int i=1;i<=k;++i) {
+    Scalar temp2 = psi_[i-1];
+    psi_[i-1] = temp1;
+    beta_[i] = beta_[i-1]*psi_[i-1]/temp2;
+    temp1 = temp2 + hh_;
+    alpha_[i] = hh_/temp1;
+    sigma_[i] = Scalar(i)*alpha_[i-1]*sigma_[i-1];
+  }
+  psi_[k] = temp1;
+
+  // g_[i] = int_0^1 prod_{j<i} (1-alpha_[j]+alpha_[j]*s) ds, which
+  // reduces to the Adams-Bashforth coefficients for constant step sizes.
+  // coeff holds the coefficients of the product polynomial in s.
+  Array<Scalar> coeff(k+1,ST::zero());
+  coeff[0] = ST::one();
+  for (int i=0;i<=k;++i) {
+    g_[i] = ST::zero();
+    for (int j=0;j<=i;++j) {
+      g_[i] += coeff[j]/Scalar(j+1);
+    }
+    if (i < k) {
+      const Scalar a = alpha_[i];
+      for (int j=i+1;j>0;--j) {
+        coeff[j] = (ST::one()-a)*coeff[j] + a*coeff[j-1];
+      }
+      coeff[0] = (ST::one()-a)*coeff[0];
+    }
+  }
+
+  RCP<Teuchos::FancyOStream> out = this->getOStream();
+  Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+  Teuchos::OSTab ostab(out,1,"updateCoeffs_");
+  if ( as<int>(verbLevel) >= as<int>(Teuchos::VERB_HIGH) ) {
+    for (int i=0;i<=k;++i) {
+      *out << "alpha_[" << i << "] = " << alpha_[i] << std::endl;
+      *out << "beta_[" << i << "] = " << beta_[i] << std::endl;
+      *out << "sigma_[" << i << "] = " << sigma_[i] << std::endl;
+      *out << "g_[" << i << "] = " << g_[i] << std::endl;
+      *out << "psi_[" << i << "] = " << psi_[i] << std::endl;
+    }
+  }
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::obtainPredictor_()
+{
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  const int k = currentOrder_;
+  // prepare history array for prediction
+  for (int i=1;i<=k;++i) {
+    if (beta_[i] != ST::one()) {
+      Vt_S(fHistory_[i].ptr(),beta_[i]);
+    }
+  }
+  // evaluate predictor
+  V_V(xn0_.ptr(),*xn_);
+  V_S(fSum_.ptr(),ST::zero());
+  for (int i=0;i<k;++i) {
+    Vp_StV(xn0_.ptr(),hh_*g_[i],*fHistory_[i]);
+    Vp_V(fSum_.ptr(),*fHistory_[i]);
+  }
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::evaluateCorrector_()
+{
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  // x_{n+1} = x_pred + h*g_{k-1}*ee, where ee = f - fSum_ is updated after
+  // each evaluation of f, so each correction only adds the change in ee.
+  const Scalar coeff = hh_*g_[currentOrder_-1];
+  Vp_StV(xn0_.ptr(),coeff,*ee_);
+  for (int it=0 ; it<correctorEvaluations_ ; ++it) {
+    evalModel_(*xn0_,time_+hh_,&*fn0_);
+    V_StVpStV( delta_.ptr(), ST::one(), *fn0_, Scalar(-ST::one()), *fSum_ );
+    if (it+1 < correctorEvaluations_) {
+      Vp_StV(xn0_.ptr(),coeff,*delta_);
+      Vp_StV(xn0_.ptr(),Scalar(-coeff),*ee_);
+    }
+    V_V(ee_.ptr(),*delta_);
+  }
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::estimateErrors_()
+{
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  const int k = currentOrder_;
+  const Scalar enorm = wRMSNorm_(*ee_);
+  // The order k and order k+1 correctors differ by h*(g_k-g_{k-1})*ee.
+  LETvalue_ = hh_*ST::magnitude(g_[k]-g_[k-1])*enorm;
+  Ek_ = hh_*sigma_[k]*gstar_[k-1]*enorm;
+  Ekm1_ = ST::zero();
+  Ekm2_ = ST::zero();
+  if (k >= 2) {
+    V_StVpStV( delta_.ptr(), ST::one(), *fHistory_[k-1], ST::one(), *ee_ );
+    Ekm1_ = hh_*sigma_[k-1]*gstar_[k-2]*wRMSNorm_(*delta_);
+  }
+  if (k >= 3) {
+    V_StVpStV( delta_.ptr(), ST::one(), *fHistory_[k-2], ST::one(), *ee_ );
+    Ekm2_ = hh_*sigma_[k-2]*gstar_[k-3]*wRMSNorm_(*delta_);
+  }
+  newOrder_ = k;
+  if ( (k == 2) && (Ekm1_ <= 0.5*Ek_) ) {
+    newOrder_ = 1;
+  } else if ( (k > 2) && (std::max(Ekm1_,Ekm2_) <= Ek_) ) {
+    newOrder_ = k-1;
+  }
+  if (newOrder_ < minOrder_) {
+    newOrder_ = k;
+  }
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::restoreHistory_()
+{
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  // undo preparation of history array for prediction
+  for (int i=1;i<=currentOrder_;++i) {
+    if (beta_[i] != ST::one()) {
+      Vt_S( fHistory_[i].ptr(), ST::one()/beta_[i] );
+    }
+  }
+  for (int i=1;i<=currentOrder_;++i) {
+    psi_[i-1] = psi_[i] - hh_;
+  }
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::rejectStep_()
+{
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  nef_++;
+  TEUCHOS_TEST_FOR_EXCEPTION(nef_ >= maxLETFail_, std::runtime_error,
+    "Error, maximum number of local error test failures.\n");
+  initialPhase_ = false;
+  restoreHistory_();
+  // Halve the step; after three failures drop to the lowest order and use
+  // the estimated optimal step size once it is smaller.
+  Scalar rr = 0.5;
+  if (nef_ >= 3) {
+    newOrder_ = minOrder_;
+  }
+  if ( (nef_ > 3) && (0.25*Ek_ > 0.5) ) {
+    rr = ST::squareroot(0.5/Ek_);
+  }
+  currentOrder_ = newOrder_;
+  hh_ = rr*hh_;
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::updateHistory_()
+{
+  // With the starred differences phi*_i(n) in fHistory_ the new differences
+  // are phi_k(n+1) = ee, phi_{k+1}(n+1) = ee - phi*_k(n) and
+  // phi_i(n+1) = phi*_i(n) + phi_{i+1}(n+1).
+  const int k = usedOrder_;
+  V_StVpStV( fHistory_[k+1].ptr(), Scalar(1.0), *ee_,
+    Scalar(-1.0), *fHistory_[k] );
+  V_V( fHistory_[k].ptr(), *ee_ );
+  for (int j=k-1;j>=0;j--) {
+    Vp_V( fHistory_[j].ptr(), *fHistory_[j+1] );
+  }
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::completeStep_()
+{
+
+  using Teuchos::as;
+
+  numberOfSteps_ ++;
+  nef_ = 0;
+  usedStep_ = hh_;
+  usedOrder_ = currentOrder_;
+  time_ += hh_;
+  V_V( xn_.ptr(), *xn0_ );
+
+  RCP<Teuchos::FancyOStream> out = this->getOStream();
+  Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+  Teuchos::OSTab ostab(out,1,"completeStep_");
+  if ( as<int>(verbLevel) >= as<int>(Teuchos::VERB_HIGH) ) {
+    *out << "numberOfSteps_ = " << numberOfSteps_ << std::endl;
+    *out << "time_ = " << time_ << std::endl;
+  }
+
+  updateHistory_();
+
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::selectOrderAndStepSize_()
+{
+
+  using Teuchos::as;
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+
+  const int k = usedOrder_;
+  Scalar Est = Ek_;
+
+  if ( (newOrder_ == k-1) || (k == maxOrder_) ) {
+    // Once the order is to be lowered or has reached its maximum, move to
+    // the phase of integration where we don't automatically double the
+    // step-size and increase the order.
+    initialPhase_ = false;
+  }
+  if (initialPhase_) {
+    currentOrder_ = k+1;
+  } else if (newOrder_ == k-1) {
+    currentOrder_ = k-1;
+    Est = Ekm1_;
+  } else if ( (k+1 <= nscsco_) && (k < maxOrder_) ) {
+    // The step size has been constant long enough to estimate the error at
+    // order k+1 from the new difference phi_{k+1}.
+    Ekp1_ = hh_*gstar_[k]*wRMSNorm_(*fHistory_[k+1]);
+    if (k == 1) {
+      if (Ekp1_ < 0.5*Ek_) {
+        currentOrder_ = k+1;
+        Est = Ekp1_;
+      }
+    } else if ( (Ekm1_ <= std::min(Ek_,Ekp1_)) && (k > minOrder_) ) {
+      currentOrder_ = k-1;
+      Est = Ekm1_;
+    } else if (Ekp1_ < Ek_) {
+      currentOrder_ = k+1;
+      Est = Ekp1_;
+    }
+  }
+  currentOrder_ = std::max(minOrder_,std::min(maxOrder_,currentOrder_));
+
+  if (stepSizeType_ == STEP_TYPE_VARIABLE) {
+    // Double the step if the error would still be small enough, keep it if
+    // the error is acceptable and cut it by at most half otherwise.
+    Scalar newTimeStep = 2*hh_;
+    const Scalar p = Scalar(currentOrder_+1);
+    if ( !initialPhase_ && (0.5 < Est*ST::pow(Scalar(2.0),p)) ) {
+      newTimeStep = hh_;
+      if (0.5 < Est) {
+        const Scalar rr = ST::pow(Scalar(0.5)/Est,ST::one()/p);
+        newTimeStep = hh_*std::max(Scalar(0.5),std::min(Scalar(0.9),rr));
+      }
+    }
+    hh_ = newTimeStep;
+  }
+
+  RCP<Teuchos::FancyOStream> out = this->getOStream();
+  Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+  Teuchos::OSTab ostab(out,1,"selectOrderAndStepSize_");
+  if ( as<int>(verbLevel) >= as<int>(Teuchos::VERB_HIGH) ) {
+    *out << "Ek_ = " << Ek_ << std::endl;
+    *out << "Ekm1_ = " << Ekm1_ << std::endl;
+    *out << "Ekm2_ = " << Ekm2_ << std::endl;
+    *out << "Ekp1_ = " << Ekp1_ << std::endl;
+    *out << "initialPhase_ = " << initialPhase_ << std::endl;
+    *out << "currentOrder_ = " << currentOrder_ << std::endl;
+    *out << "hh_ = " << hh_ << std::endl;
+  }
+
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::interpolateSolution_(
+  const Scalar& timepoint,
+  Thyra::VectorBase<Scalar>* x_ptr,
+  Thyra::VectorBase<Scalar>* xdot_ptr,
+  ScalarMag* accuracy_ptr
+  ) const
+{
+
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+
+#ifdef HAVE_RYTHMOS_DEBUG
+  const TimeRange<Scalar> currTimeRange = this->getTimeRange();
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !currTimeRange.isInRange(timepoint), std::logic_error,
+    "Error, timepoint = " << timepoint << " is not in the time range "
+    << currTimeRange << "!" );
+#endif
+
+  const int kord = usedOrder_;
+
+  // The differences phi_i(n) in fHistory_ interpolate f at t_n, ...,
+  // t_{n-kord} in Newton form,
+  //
+  //   f(t_n+delt) = sum_i phi_i(n) * prod_{j<i} (delt+psi_{j-1})/psi_j
+  //
+  // with psi_{-1} = 0, and x is interpolated with the integral of this
+  // polynomial from t_n.  coeff holds the coefficients of the product
+  // polynomial in delt.
+  Thyra::V_V(ptr(x_ptr),*xn_);
+  Thyra::V_S(ptr(xdot_ptr),ST::zero());
+  const Scalar delt = timepoint - time_;
+  Array<Scalar> coeff(kord+2,ST::zero());
+  coeff[0] = ST::one();
+  for (int i=0 ; i <= kord ; ++i) {
+    Scalar c = ST::zero(); // coefficient for interpolation of x
+    Scalar d = ST::zero(); // coefficient for interpolation of xdot
+    Scalar deltPow = ST::one();
+    for (int j=0 ; j <= i ; ++j) {
+      d += coeff[j]*deltPow;
+      deltPow *= delt;
+      c += coeff[j]*deltPow/Scalar(j+1);
+    }
+    Thyra::Vp_StV(ptr(x_ptr),c,*fHistory_[i]);
+    Thyra::Vp_StV(ptr(xdot_ptr),d,*fHistory_[i]);
+    if (i < kord) {
+      const Scalar shift = ( i == 0 ? ST::zero() : psi_[i-1] );
+      for (int j=i+1 ; j>0 ; --j) {
+        coeff[j] = (coeff[j-1] + shift*coeff[j])/psi_[i];
+      }
+      coeff[0] = shift*coeff[0]/psi_[i];
+    }
+  }
+
+  // Set approximate accuracy
+  if (accuracy_ptr) {
+    *accuracy_ptr = ST::pow(usedStep_,kord);
+  }
+
+}
+
+
+template<class Scalar>
+void AdamsStepper<Scalar>::evalModel_(
+  const Thyra::VectorBase<Scalar>& x,
+  Scalar t,
+  Thyra::VectorBase<Scalar>* f
+  )
+{
+  eval_model_explicit<Scalar>(*model_,basePoint_,x,t,Teuchos::ptr(f));
+  ++numModelEvaluations_;
+}
+
+
+template<class Scalar>
+Scalar AdamsStepper<Scalar>::wRMSNorm_(
+  const Thyra::VectorBase<Scalar>& vector
+  ) const
+{
+  return(norm_2(*errWtVec_,vector));
+}
+
+
+//
+// Explicit Instantiation macro
+//
+// Must be expanded from within the Rythmos namespace!
+//
+
+#define RYTHMOS_ADAMS_STEPPER_INSTANT(SCALAR) \
+  \
+  template class AdamsStepper< SCALAR >; \
+  \
+  template RCP< AdamsStepper< SCALAR > > \
+  adamsStepper();  \
+  \
+  template RCP< AdamsStepper< SCALAR > > \
+  adamsStepper( \
+    const RCP<const Thyra::ModelEvaluator< SCALAR > >& model \
+    ); \
+
+
+} // namespace Rythmos
+
+
+#endif //Rythmos_ADAMS_STEPPER_DEF_H
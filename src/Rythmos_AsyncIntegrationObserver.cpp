@@ -0,0 +1,17 @@
+#include "Rythmos_AsyncIntegrationObserver_decl.hpp"
+
+#ifdef HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
+
+#include "Rythmos_AsyncIntegrationObserver_def.hpp"
+#include "Rythmos_ExplicitInstantiationHelpers.hpp"
+
+namespace Rythmos {
+
+RYTHMOS_MACRO_TEMPLATE_INSTANT_SCALAR_TYPES(RYTHMOS_ASYNC_INTEGRATION_OBSERVER_INSTANT) 
+
+} // namespace Rythmos
+
+#endif // HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
+
+
+
@@ -0,0 +1,5 @@
+#include "Rythmos_AsyncIntegrationObserver_decl.hpp"
+#ifndef HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
+#include "Rythmos_AsyncIntegrationObserver_def.hpp"
+#endif
+
@@ -0,0 +1,335 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_ASYNC_INTEGRATION_OBSERVER_DECL_H
+#define Rythmos_ASYNC_INTEGRATION_OBSERVER_DECL_H
+
+#include "Rythmos_IntegrationObserverBase.hpp"
+#include "Rythmos_StepperSnapshot.hpp"
+#include "Rythmos_StepControlInfo.hpp"
+#include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
+
+#include <deque>
+#include <vector>
+
+#ifdef HAVE_RYTHMOS_THREADS
+#  include <condition_variable>
+#  include <exception>
+#  include <mutex>
+#  include <thread>
+#endif
+
+
+namespace Rythmos {
+
+
+/** \brief What <tt>AsyncIntegrationObserver</tt> does with a completed time
+ * step when its queue is full. */
+enum EAsyncObserverBackpressure {
+  /** \brief Wait for the wrapped observer to catch up. */
+  ASYNC_OBSERVER_BLOCK,
+  /** \brief Do not deliver the new step. */
+  ASYNC_OBSERVER_DROP,
+  /** \brief Remove the newest queued completed step to make room for the new
+   * one. */
+  ASYNC_OBSERVER_COALESCE
+};
+
+
+/** \brief . */
+inline
+const char* toString(const EAsyncObserverBackpressure backpressure)
+{
+  switch(backpressure) {
+    case ASYNC_OBSERVER_BLOCK: return "Block";
+    case ASYNC_OBSERVER_DROP: return "Drop";
+    case ASYNC_OBSERVER_COALESCE: return "Coalesce";
+#ifdef HAVE_RYTHMOS_DEBUG
+    default: TEUCHOS_TEST_FOR_EXCEPT(true);
+#endif
+  }
+  return ""; // Never be called!
+}
+
+
+/** \brief Integration observer adapter that delivers the observations to a
+ * wrapped observer in batches, on a background thread when possible.
+ *
+ * Each call made by the integrator is turned into an event that holds a
+ * <tt>StepperSnapshot</tt> of the stepper, taken from a pool of
+ * preallocated snapshots, so the integrator only pays for copying the
+ * solution and its time derivative.  The events are queued and handed to the
+ * wrapped observer in order.  The wrapped observer sees the snapshot in
+ * place of the real stepper, so it must only ask for the state at the end of
+ * the step, which is what all observers in Rythmos do.
+ *
+ * When Rythmos is built with thread support (<tt>HAVE_RYTHMOS_THREADS</tt>,
+ * which needs a thread safe Teuchos and the Pthread TPL) and "Asynchronous"
+ * is true, the wrapped observer runs on a worker thread that is started on
+ * the first event.  The queue then holds at most "Queue Capacity" events and
+ * "Backpressure Policy" says what happens to a completed time step when it
+ * is full:
+ *
+ * <ul>
+ * <li> "Block": the integrator waits until there is room.
+ * <li> "Drop": the new step is not delivered.
+ * <li> "Coalesce": the newest queued completed step is removed to make room
+ *      for the new one, so the wrapped observer skips a step but always sees
+ *      the latest state.
+ * </ul>
+ *
+ * A step is always dropped or coalesced together with its start of step
+ * event, so every start of step the wrapped observer sees is followed by the
+ * completion or failure of that step.  When the start has already been
+ * delivered the integrator waits as for "Block".  Start and end of
+ * integration and failed step events are never dropped or coalesced.  The worker waits until "Batch Size" events
+ * are queued and then delivers all of them before it goes back to sleep,
+ * which keeps the number of thread hand-offs low for cheap observers.
+ *
+ * Without thread support, or with "Asynchronous" set to false, the events
+ * are delivered on the calling thread each time "Batch Size" of them have
+ * been queued and nothing is ever dropped.
+ *
+ * In both modes <tt>observeEndTimeIntegration()</tt>,
+ * <tt>resetIntegrationObserver()</tt> and the destructor call
+ * <tt>flush()</tt>, so all observations of an integration have been
+ * delivered when the integrator returns.  An exception thrown by the wrapped
+ * observer on the worker thread is rethrown by the next <tt>flush()</tt>.
+ *
+ * The wrapped observer must copy any state it wants to keep since the
+ * snapshots are reused, and when it runs on the worker thread anything it
+ * touches besides the snapshot (output streams, files, MPI) must be safe to
+ * use concurrently with the integrator.
+ */
+template<class Scalar>
+class AsyncIntegrationObserver
+  : virtual public IntegrationObserverBase<Scalar>,
+    virtual public Teuchos::ParameterListAcceptorDefaultBase
+{
+public:
+
+  /** \name Constructors/Initializers/Accessors */
+  //@{
+
+  /** \brief . */
+  AsyncIntegrationObserver();
+
+  /** \brief Flushes the queue and stops the worker thread. */
+  ~AsyncIntegrationObserver();
+
+  /** \brief Set the observer that the observations are delivered to. */
+  void setObserver(const RCP<IntegrationObserverBase<Scalar> > &observer);
+
+  /** \brief . */
+  RCP<const IntegrationObserverBase<Scalar> > getObserver() const;
+
+  /** \brief . */
+  RCP<IntegrationObserverBase<Scalar> > getNonconstObserver();
+
+  /** \brief Block until all queued observations have been delivered. */
+  void flush();
+
+  /** \brief Returns true if the observations are delivered on a worker
+   * thread. */
+  bool isAsynchronous() const;
+
+  /** \brief Number of events delivered to the wrapped observer. */
+  int getNumDelivered() const;
+
+  /** \brief Number of completed time steps dropped because the queue was
+   * full. */
+  int getNumDropped() const;
+
+  /** \brief Number of queued completed time steps removed to make room for
+   * a newer one because the queue was full. */
+  int getNumCoalesced() const;
+
+  //@}
+
+  /** \name Overridden from ParameterListAcceptor */
+  //@{
+
+  /** \brief . */
+  void setParameterList(RCP<ParameterList> const& paramList);
+
+  /** \brief . */
+  RCP<const ParameterList> getValidParameters() const;
+
+  //@}
+
+  /** \name Overridden from IntegrationObserverBase */
+  //@{
+
+  /** \brief . */
+  RCP<IntegrationObserverBase<Scalar> > cloneIntegrationObserver() const;
+
+  /** \brief . */
+  void resetIntegrationObserver(
+    const TimeRange<Scalar> &integrationTimeDomain
+    );
+
+  /** \brief . */
+  void observeStartTimeIntegration(const StepperBase<Scalar> &stepper);
+
+  /** \brief . */
+  void observeEndTimeIntegration(const StepperBase<Scalar> &stepper);
+
+  /** \brief . */
+  void observeStartTimeStep(
+    const StepperBase<Scalar> &stepper,
+    const StepControlInfo<Scalar> &stepCtrlInfo,
+    const int timeStepIter
+    );
+
+  /** \brief . */
+  void observeCompletedTimeStep(
+    const StepperBase<Scalar> &stepper,
+    const StepControlInfo<Scalar> &stepCtrlInfo,
+    const int timeStepIter
+    );
+
+  /** \brief . */
+  void observeFailedTimeStep(
+    const StepperBase<Scalar> &stepper,
+    const StepControlInfo<Scalar> &stepCtrlInfo,
+    const int timeStepIter
+    );
+
+  /** \brief Flushes the queue and forwards the event synchronously.
+   *
+   * A stepper snapshot cannot interpolate inside the step, so events are
+   * delivered with the live stepper on the calling thread.
+   */
+  void observeEvent(
+    const StepperBase<Scalar> &stepper,
+    const Scalar &eventTime,
+    const Array<int> &eventIndices
+    );
+
+  //@}
+
+private:
+
+  enum EEventType {
+    START_TIME_INTEGRATION,
+    END_TIME_INTEGRATION,
+    START_TIME_STEP,
+    COMPLETED_TIME_STEP,
+    FAILED_TIME_STEP
+  };
+
+  struct ObserverEvent {
+    EEventType type;
+    StepControlInfo<Scalar> stepCtrlInfo;
+    int timeStepIter;
+    RCP<StepperSnapshot<Scalar> > snapshot;
+  };
+
+  RCP<IntegrationObserverBase<Scalar> > observer_;
+
+  bool asynchronous_;
+  int queueCapacity_;
+  EAsyncObserverBackpressure backpressure_;
+  int batchSize_;
+
+  // Pool of events, the queue of pool indices waiting to be delivered and
+  // the free pool indices.
+  std::vector<ObserverEvent> events_;
+  std::deque<int> queue_;
+  std::vector<int> freeEvents_;
+
+  int numDelivered_;
+  int numDropped_;
+  int numCoalesced_;
+
+#ifdef HAVE_RYTHMOS_THREADS
+  std::thread worker_;
+  mutable std::mutex mutex_;
+  std::condition_variable readyCond_;
+  std::condition_variable spaceCond_;
+  std::condition_variable idleCond_;
+  bool workerRunning_;
+  bool shutdown_;
+  bool flushRequested_;
+  int numInFlight_;
+  std::exception_ptr workerException_;
+#endif
+
+  static const std::string asynchronous_name_;
+  static const bool asynchronous_default_;
+
+  static const std::string queueCapacity_name_;
+  static const int queueCapacity_default_;
+
+  static const std::string backpressure_name_;
+  static const std::string backpressure_default_;
+
+  static const std::string batchSize_name_;
+  static const int batchSize_default_;
+
+  void enqueue(
+    const EEventType type,
+    const StepperBase<Scalar> &stepper,
+    const StepControlInfo<Scalar> &stepCtrlInfo,
+    const int timeStepIter
+    );
+
+  bool isQueuedStartOf(const int queueIndex, const int timeStepIter) const;
+
+  bool removeNewestCompletedStep();
+
+  void deliver(const ObserverEvent &event);
+
+  void deliverQueued();
+
+  void resizePool();
+
+  void stopWorker();
+
+#ifdef HAVE_RYTHMOS_THREADS
+  void workerLoop();
+#endif
+
+};
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates AsyncIntegrationObserver
+ */
+template<class Scalar>
+RCP<AsyncIntegrationObserver<Scalar> >
+asyncIntegrationObserver(
+  const RCP<IntegrationObserverBase<Scalar> > &observer,
+  const RCP<ParameterList> &paramList = Teuchos::null
+  );
+
+
+} // namespace Rythmos
+
+#endif //Rythmos_ASYNC_INTEGRATION_OBSERVER_DECL_H
@@ -0,0 +1,715 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_ASYNC_INTEGRATION_OBSERVER_DEF_H
+#define Rythmos_ASYNC_INTEGRATION_OBSERVER_DEF_H
+
+#include "Rythmos_AsyncIntegrationObserver_decl.hpp"
+
+#include "Teuchos_StandardParameterEntryValidators.hpp"
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+
+
+namespace Rythmos {
+
+
+// Nonmember constructors
+
+
+template<class Scalar>
+RCP<AsyncIntegrationObserver<Scalar> >
+asyncIntegrationObserver(
+  const RCP<IntegrationObserverBase<Scalar> > &observer,
+  const RCP<ParameterList> &paramList
+  )
+{
+  RCP<AsyncIntegrationObserver<Scalar> >
+    asyncObserver = Teuchos::rcp(new AsyncIntegrationObserver<Scalar>());
+  asyncObserver->setObserver(observer);
+  if (!is_null(paramList))
+    asyncObserver->setParameterList(paramList);
+  return asyncObserver;
+}
+
+
+//
+// Implementation
+//
+
+
+// Static members
+
+
+template<class Scalar>
+const std::string
+AsyncIntegrationObserver<Scalar>::asynchronous_name_
+= "Asynchronous";
+
+template<class Scalar>
+const bool
+AsyncIntegrationObserver<Scalar>::asynchronous_default_
+= true;
+
+
+template<class Scalar>
+const std::string
+AsyncIntegrationObserver<Scalar>::queueCapacity_name_
+= "Queue Capacity";
+
+template<class Scalar>
+const int
+AsyncIntegrationObserver<Scalar>::queueCapacity_default_
+= 16;
+
+
+template<class Scalar>
+const std::string
+AsyncIntegrationObserver<Scalar>::backpressure_name_
+= "Backpressure Policy";
+
+template<class Scalar>
+const std::string
+AsyncIntegrationObserver<Scalar>::backpressure_default_
+= "Block";
+
+
+template<class Scalar>
+const std::string
+AsyncIntegrationObserver<Scalar>::batchSize_name_
+= "Batch Size";
+
+template<class Scalar>
+const int
+AsyncIntegrationObserver<Scalar>::batchSize_default_
+= 1;
+
+
+// Constructors/Initializers/Accessors
+
+
+template<class Scalar>
+AsyncIntegrationObserver<Scalar>::AsyncIntegrationObserver()
+  :asynchronous_(asynchronous_default_),
+   queueCapacity_(queueCapacity_default_),
+   backpressure_(ASYNC_OBSERVER_BLOCK),
+   batchSize_(batchSize_default_),
+   numDelivered_(0),
+   numDropped_(0),
+   numCoalesced_(0)
+#ifdef HAVE_RYTHMOS_THREADS
+   ,workerRunning_(false),
+   shutdown_(false),
+   flushRequested_(false),
+   numInFlight_(0)
+#endif
+{
+  resizePool();
+}
+
+
+template<class Scalar>
+AsyncIntegrationObserver<Scalar>::~AsyncIntegrationObserver()
+{
+  // Never let an exception from the wrapped observer escape the destructor.
+  try {
+    flush();
+  }
+  catch (...) {}
+  stopWorker();
+}
+
+
+template<class Scalar>
+void AsyncIntegrationObserver<Scalar>::setObserver(
+  const RCP<IntegrationObserverBase<Scalar> > &observer
+  )
+{
+  flush();
+  observer_ = observer;
+}
+
+
+template<class Scalar>
+RCP<const IntegrationObserverBase<Scalar> >
+AsyncIntegrationObserver<Scalar>::getObserver() const
+{
+  return observer_;
+}
+
+
+template<class Scalar>
+RCP<IntegrationObserverBase<Scalar> >
+AsyncIntegrationObserver<Scalar>::getNonconstObserver()
+{
+  return observer_;
+}
+
+
+template<class Scalar>
+void AsyncIntegrationObserver<Scalar>::flush()
+{
+#ifdef HAVE_RYTHMOS_THREADS
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (workerRunning_) {
+    flushRequested_ = true;
+    readyCond_.notify_one();
+    idleCond_.wait(lock,
+      [this]{ return queue_.empty() && numInFlight_ == 0; });
+    flushRequested_ = false;
+    if (workerException_) {
+      std::exception_ptr workerException = workerException_;
+      workerException_ = std::exception_ptr();
+      std::rethrow_exception(workerException);
+    }
+    return;
+  }
+  lock.unlock();
+#endif
+  while (!queue_.empty()) {
+    deliverQueued();
+  }
+}
+
+
+template<class Scalar>
+bool AsyncIntegrationObserver<Scalar>::isAsynchronous() const
+{
+#ifdef HAVE_RYTHMOS_THREADS
+  return asynchronous_;
+#else
+  return false;
+#endif
+}
+
+
+template<class Scalar>
+int AsyncIntegrationObserver<Scalar>::getNumDelivered() const
+{
+#ifdef HAVE_RYTHMOS_THREADS
+  std::lock_guard<std::mutex> lock(mutex_);
+#endif
+  return numDelivered_;
+}
+
+
+template<class Scalar>
+int AsyncIntegrationObserver<Scalar>::getNumDropped() const
+{
+#ifdef HAVE_RYTHMOS_THREADS
+  std::lock_guard<std::mutex> lock(mutex_);
+#endif
+  return numDropped_;
+}
+
+
+template<class Scalar>
+int AsyncIntegrationObserver<Scalar>::getNumCoalesced() const
+{
+#ifdef HAVE_RYTHMOS_THREADS
+  std::lock_guard<std::mutex> lock(mutex_);
+#endif
+  return numCoalesced_;
+}
+
+
+// Overridden from ParameterListAcceptor
+
+
+template<class Scalar>
+void AsyncIntegrationObserver<Scalar>::setParameterList(
+  RCP<ParameterList> const& paramList
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(paramList));
+  paramList->validateParametersAndSetDefaults(*getValidParameters());
+
+  // The pool is resized below so nothing may be queued or in flight.
+  flush();
+  stopWorker();
+
+  const int queueCapacity = paramList->get<int>(queueCapacity_name_);
+  const int batchSize = paramList->get<int>(batchSize_name_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    queueCapacity < 1, std::logic_error,
+    "Error, AsyncIntegrationObserver::setParameterList(...):  \""
+    << queueCapacity_name_ << "\" = " << queueCapacity << " must be >= 1!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    batchSize < 1 || batchSize > queueCapacity, std::logic_error,
+    "Error, AsyncIntegrationObserver::setParameterList(...):  \""
+    << batchSize_name_ << "\" = " << batchSize << " must be >= 1 and <= \""
+    << queueCapacity_name_ << "\" = " << queueCapacity << "!"
+    );
+
+  asynchronous_ = paramList->get<bool>(asynchronous_name_);
+  queueCapacity_ = queueCapacity;
+  batchSize_ = batchSize;
+  backpressure_ = Teuchos::getIntegralValue<EAsyncObserverBackpressure>(
+    *paramList, backpressure_name_ );
+  resizePool();
+
+  this->setMyParamList(paramList);
+  Teuchos::readVerboseObjectSublist(&*paramList,this);
+}
+
+
+template<class Scalar>
+RCP<const ParameterList>
+AsyncIntegrationObserver<Scalar>::getValidParameters() const
+{
+  static RCP<const ParameterList> validPL;
+  if (is_null(validPL)) {
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set(
+      asynchronous_name_, asynchronous_default_,
+      "Deliver the observations to the wrapped observer on a worker thread.\n"
+      "This is ignored unless Rythmos was built with thread support."
+      );
+    pl->set(
+      queueCapacity_name_, queueCapacity_default_,
+      "Maximum number of observations that are waiting to be delivered."
+      );
+    Teuchos::setStringToIntegralParameter<EAsyncObserverBackpressure>(
+      backpressure_name_,
+      backpressure_default_,
+      "What to do with a completed time step when the queue is full.\n"
+      "\"Block\" waits for the wrapped observer, \"Drop\" skips the new step\n"
+      "and \"Coalesce\" removes the newest queued completed step to make room\n"
+      "for it.",
+      Teuchos::tuple<std::string>(
+        toString(ASYNC_OBSERVER_BLOCK),
+        toString(ASYNC_OBSERVER_DROP),
+        toString(ASYNC_OBSERVER_COALESCE)),
+      Teuchos::tuple<EAsyncObserverBackpressure>(
+        ASYNC_OBSERVER_BLOCK,
+        ASYNC_OBSERVER_DROP,
+        ASYNC_OBSERVER_COALESCE),
+      pl.get()
+      );
+    pl->set(
+      batchSize_name_, batchSize_default_,
+      "Number of queued observations that are delivered together.\n"
+      "Must not be larger than \"" + queueCapacity_name_ + "\"."
+      );
+    Teuchos::setupVerboseObjectSublist(&*pl);
+    validPL = pl;
+  }
+  return validPL;
+}
+
+
+// Overridden from IntegrationObserverBase
+
+
+template<class Scalar>
+RCP<IntegrationObserverBase<Scalar> >
+AsyncIntegrationObserver<Scalar>::cloneIntegrationObserver() const
+{
+  RCP<AsyncIntegrationObserver<Scalar> >
+    asyncObserver = Teuchos::rcp(new AsyncIntegrationObserver<Scalar>());
+  if (!is_null(observer_))
+    asyncObserver->setObserver(observer_->cloneIntegrationObserver());
+  RCP<const ParameterList> paramList = this->getParameterList();
+  if (!is_null(paramList))
+    asyncObserver->setParameterList(Teuchos::parameterList(*paramList));
+  return asyncObserver;
+}
+
+
+template<class Scalar>
+void AsyncIntegrationObserver<Scalar>::resetIntegrationObserver(
+  const TimeRange<Scalar> &integrationTimeDomain
+  )
+{
+  flush();
+  if (!is_null(observer_))
+    observer_->resetIntegrationObserver(integrationTimeDomain);
+}
+
+
+template<class Scalar>
+void AsyncIntegrationObserver<Scalar>::observeStartTimeIntegration(
+  const StepperBase<Scalar> &stepper
+  )
+{
+  // The integrator sets the output stream and verbosity right before this
+  // call so pass them on while the worker is idle.
+  flush();
+  if (!is_null(observer_)) {
+    observer_->setOStream(this->getOStream());
+    observer_->setVerbLevel(this->getVerbLevel());
+  }
+  enqueue(START_TIME_INTEGRATION, stepper, StepControlInfo<Scalar>(), 0);
+}
+
+
+template<class Scalar>
+void AsyncIntegrationObserver<Scalar>::observeEndTimeIntegration(
+  const StepperBase<Scalar> &stepper
+  )
+{
+  enqueue(END_TIME_INTEGRATION, stepper, StepControlInfo<Scalar>(), 0);
+  flush();
+}
+
+
+template<class Scalar>
+void AsyncIntegrationObserver<Scalar>::observeStartTimeStep(
+  const StepperBase<Scalar> &stepper,
+  const StepControlInfo<Scalar> &stepCtrlInfo,
+  const int timeStepIter
+  )
+{
+  enqueue(START_TIME_STEP, stepper, stepCtrlInfo, timeStepIter);
+}
+
+
+template<class Scalar>
+void AsyncIntegrationObserver<Scalar>::observeCompletedTimeStep(
+  const StepperBase<Scalar> &stepper,
+  const StepControlInfo<Scalar> &stepCtrlInfo,
+  const int timeStepIter
+  )
+{
+  enqueue(COMPLETED_TIME_STEP, stepper, stepCtrlInfo, timeStepIter);
+}
+
+
+template<class Scalar>
+void AsyncIntegrationObserver<Scalar>::observeFailedTimeStep(
+  const StepperBase<Scalar> &stepper,
+  const StepControlInfo<Scalar> &stepCtrlInfo,
+  const int timeStepIter
+  )
+{
+  enqueue(FAILED_TIME_STEP, stepper, stepCtrlInfo, timeStepIter);
+}
+
+
+template<class Scalar>
+void AsyncIntegrationObserver<Scalar>::observeEvent(
+  const StepperBase<Scalar> &stepper,
+  const Scalar &eventTime,
+  const Array<int> &eventIndices
+  )
+{
+  flush();
+  if (!is_null(observer_))
+    observer_->observeEvent(stepper, eventTime, eventIndices);
+}
+
+
+// private
+
+
+template<class Scalar>
+void AsyncIntegrationObserver<Scalar>::enqueue(
+  const EEventType type,
+  const StepperBase<Scalar> &stepper,
+  const StepControlInfo<Scalar> &stepCtrlInfo,
+  const int timeStepIter
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(observer_), std::logic_error,
+    "Error, AsyncIntegrationObserver:  No observer has been set!"
+    );
+
+#ifdef HAVE_RYTHMOS_THREADS
+  if (asynchronous_) {
+    int slot = -1;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (!workerRunning_) {
+        shutdown_ = false;
+        worker_ = std::thread(&AsyncIntegrationObserver<Scalar>::workerLoop, this);
+        workerRunning_ = true;
+      }
+      while (slot < 0) {
+        if (Teuchos::as<int>(queue_.size()) < queueCapacity_) {
+          slot = freeEvents_.back();
+          freeEvents_.pop_back();
+        }
+        else if (type == COMPLETED_TIME_STEP
+          && backpressure_ == ASYNC_OBSERVER_DROP
+          && isQueuedStartOf(Teuchos::as<int>(queue_.size())-1, timeStepIter))
+        {
+          // Drop the start of this step with it so the wrapped observer
+          // never sees a start without its completion.
+          freeEvents_.push_back(queue_.back());
+          queue_.pop_back();
+          ++numDropped_;
+          return;
+        }
+        else if (type == COMPLETED_TIME_STEP
+          && backpressure_ == ASYNC_OBSERVER_COALESCE
+          && removeNewestCompletedStep())
+        {
+          ++numCoalesced_;
+        }
+        else {
+          spaceCond_.wait(lock);
+        }
+      }
+    }
+    // Copy the state without holding the lock so the worker can keep
+    // delivering the events that are already queued.
+    ObserverEvent &event = events_[slot];
+    try {
+      event.type = type;
+      event.stepCtrlInfo = stepCtrlInfo;
+      event.timeStepIter = timeStepIter;
+      event.snapshot->capture(stepper);
+    }
+    catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      freeEvents_.push_back(slot);
+      spaceCond_.notify_all();
+      throw;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(slot);
+    if (Teuchos::as<int>(queue_.size()) >= batchSize_)
+      readyCond_.notify_one();
+    return;
+  }
+#endif
+
+  const int slot = freeEvents_.back();
+  freeEvents_.pop_back();
+  ObserverEvent &event = events_[slot];
+  try {
+    event.type = type;
+    event.stepCtrlInfo = stepCtrlInfo;
+    event.timeStepIter = timeStepIter;
+    event.snapshot->capture(stepper);
+  }
+  catch (...) {
+    freeEvents_.push_back(slot);
+    throw;
+  }
+  queue_.push_back(slot);
+  if (Teuchos::as<int>(queue_.size()) >= batchSize_)
+    flush();
+}
+
+
+template<class Scalar>
+bool AsyncIntegrationObserver<Scalar>::isQueuedStartOf(
+  const int queueIndex,
+  const int timeStepIter
+  ) const
+{
+  if (queueIndex < 0)
+    return false;
+  const ObserverEvent &event = events_[queue_[queueIndex]];
+  return event.type == START_TIME_STEP && event.timeStepIter == timeStepIter;
+}
+
+
+template<class Scalar>
+bool AsyncIntegrationObserver<Scalar>::removeNewestCompletedStep()
+{
+  // The integrator queues the start of a step right before its completion,
+  // so the newest completed step is usually behind the start of the step
+  // that is being completed now.
+  for (int i = Teuchos::as<int>(queue_.size())-1; i >= 0; --i) {
+    const ObserverEvent &event = events_[queue_[i]];
+    if (event.type != COMPLETED_TIME_STEP)
+      continue;
+    if (!isQueuedStartOf(i-1, event.timeStepIter)) {
+      // The start has already been delivered so this step can not be
+      // removed as a whole, and neither can any older one.
+      return false;
+    }
+    freeEvents_.push_back(queue_[i]);
+    freeEvents_.push_back(queue_[i-1]);
+    queue_.erase(queue_.begin()+(i-1), queue_.begin()+(i+1));
+    return true;
+  }
+  return false;
+}
+
+
+template<class Scalar>
+void AsyncIntegrationObserver<Scalar>::deliver(const ObserverEvent &event)
+{
+  const StepperBase<Scalar> &stepper = *event.snapshot;
+  switch (event.type) {
+    case START_TIME_INTEGRATION:
+      observer_->observeStartTimeIntegration(stepper);
+      break;
+    case END_TIME_INTEGRATION:
+      observer_->observeEndTimeIntegration(stepper);
+      break;
+    case START_TIME_STEP:
+      observer_->observeStartTimeStep(
+        stepper, event.stepCtrlInfo, event.timeStepIter);
+      break;
+    case COMPLETED_TIME_STEP:
+      observer_->observeCompletedTimeStep(
+        stepper, event.stepCtrlInfo, event.timeStepIter);
+      break;
+    case FAILED_TIME_STEP:
+      observer_->observeFailedTimeStep(
+        stepper, event.stepCtrlInfo, event.timeStepIter);
+      break;
+    default:
+      TEUCHOS_TEST_FOR_EXCEPT(true);
+  }
+}
+
+
+template<class Scalar>
+void AsyncIntegrationObserver<Scalar>::deliverQueued()
+{
+  // Give the slot back before delivering so an exception from the wrapped
+  // observer leaves the queue consistent.  Nothing refills the slot until
+  // this returns.
+  const int slot = queue_.front();
+  queue_.pop_front();
+  freeEvents_.push_back(slot);
+  deliver(events_[slot]);
+#ifdef HAVE_RYTHMOS_THREADS
+  std::lock_guard<std::mutex> lock(mutex_);
+#endif
+  ++numDelivered_;
+}
+
+
+template<class Scalar>
+void AsyncIntegrationObserver<Scalar>::resizePool()
+{
+  TEUCHOS_ASSERT(queue_.empty());
+  // Up to queueCapacity_ events can be queued while batchSize_ more are
+  // being delivered by the worker.
+  const int poolSize = queueCapacity_ + batchSize_;
+  const int oldPoolSize = Teuchos::as<int>(events_.size());
+  events_.resize(poolSize);
+  for (int i = oldPoolSize; i < poolSize; ++i) {
+    events_[i].snapshot = stepperSnapshot<Scalar>();
+  }
+  freeEvents_.clear();
+  for (int i = poolSize-1; i >= 0; --i) {
+    freeEvents_.push_back(i);
+  }
+}
+
+
+template<class Scalar>
+void AsyncIntegrationObserver<Scalar>::stopWorker()
+{
+#ifdef HAVE_RYTHMOS_THREADS
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!workerRunning_)
+      return;
+    shutdown_ = true;
+    readyCond_.notify_one();
+  }
+  worker_.join();
+  std::lock_guard<std::mutex> lock(mutex_);
+  workerRunning_ = false;
+  shutdown_ = false;
+#endif
+}
+
+
+#ifdef HAVE_RYTHMOS_THREADS
+template<class Scalar>
+void AsyncIntegrationObserver<Scalar>::workerLoop()
+{
+  std::vector<int> batch;
+  batch.reserve(batchSize_);
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    readyCond_.wait(lock,
+      [this]{
+        return shutdown_
+          || Teuchos::as<int>(queue_.size()) >= batchSize_
+          || (flushRequested_ && !queue_.empty());
+      });
+    if (queue_.empty()) {
+      // Only a shutdown wakes the worker up with nothing to do, and the
+      // queue is always flushed before that.
+      break;
+    }
+    batch.clear();
+    while (!queue_.empty() && Teuchos::as<int>(batch.size()) < batchSize_) {
+      batch.push_back(queue_.front());
+      queue_.pop_front();
+    }
+    numInFlight_ = Teuchos::as<int>(batch.size());
+    spaceCond_.notify_all();
+    lock.unlock();
+    for (int i = 0; i < Teuchos::as<int>(batch.size()); ++i) {
+      try {
+        deliver(events_[batch[i]]);
+      }
+      catch (...) {
+        lock.lock();
+        if (!workerException_)
+          workerException_ = std::current_exception();
+        lock.unlock();
+      }
+    }
+    lock.lock();
+    for (int i = 0; i < Teuchos::as<int>(batch.size()); ++i) {
+      freeEvents_.push_back(batch[i]);
+    }
+    numDelivered_ += numInFlight_;
+    numInFlight_ = 0;
+    spaceCond_.notify_all();
+    if (queue_.empty())
+      idleCond_.notify_all();
+  }
+}
+#endif
+
+
+//
+// Explicit Instantiation macro
+//
+// Must be expanded from within the Rythmos namespace!
+//
+
+#define RYTHMOS_ASYNC_INTEGRATION_OBSERVER_INSTANT(SCALAR) \
+  \
+  template class AsyncIntegrationObserver< SCALAR >; \
+  \
+  template RCP<AsyncIntegrationObserver< SCALAR > > \
+  asyncIntegrationObserver( \
+    const RCP<IntegrationObserverBase< SCALAR > > &observer, \
+    const RCP<ParameterList> &paramList \
+    );
+
+
+} // namespace Rythmos
+
+
+#endif //Rythmos_ASYNC_INTEGRATION_OBSERVER_DEF_H
@@ -72,6 +72,7 @@ template<class Scalar>
       m->set_t_old(t_old_);
       m->set_dt(dt_);
       m->set_numSteps(numSteps_);
+      m->set_newtonConvergenceStatus(newtonConvergenceStatus_);
       m->set_isInitialized(isInitialized_);
       m->set_haveInitialCondition(haveInitialCondition_);
       m->set_parameterList(parameterList_);
@@ -87,17 +88,59 @@ template<class Scalar>
       return m;
     }
 
+    /** \brief Write the vectors, times, and counters.
+     *
+     * The parameter list, base point, interpolator, and step control are not
+     * written, so <tt>deSerialize()</tt> must be called on a clone of a
+     * momento of the same stepper.
+     */
     void serialize(
-        const StateSerializerStrategy<Scalar>& /* stateSerializer */,
-        std::ostream& /* oStream */
+        const StateSerializerStrategy<Scalar>& stateSerializer,
+        std::ostream& oStream
         ) const
-    { }
+    {
+      serializeVector_(stateSerializer,scaled_x_old_,oStream);
+      serializeVector_(stateSerializer,x_old_,oStream);
+      serializeVector_(stateSerializer,x_dot_old_,oStream);
+      serializeVector_(stateSerializer,x_,oStream);
+      serializeVector_(stateSerializer,x_dot_,oStream);
+      serializeVector_(stateSerializer,dx_,oStream);
+      stateSerializer.serializeScalar(t_,oStream);
+      stateSerializer.serializeScalar(t_old_,oStream);
+      stateSerializer.serializeScalar(dt_,oStream);
+      stateSerializer.serializeInt(numSteps_,oStream);
+      stateSerializer.serializeInt(newtonConvergenceStatus_,oStream);
+      stateSerializer.serializeBool(isInitialized_,oStream);
+      stateSerializer.serializeBool(haveInitialCondition_,oStream);
+    }
 
+    /** \brief Read what <tt>serialize()</tt> wrote.
+     *
+     * Vectors missing in <tt>*this</tt> are created in the space of
+     * <tt>x</tt>, which must be set.
+     */
     void deSerialize(
-        const StateSerializerStrategy<Scalar>& /* stateSerializer */,
-        std::istream& /* iStream */
+        const StateSerializerStrategy<Scalar>& stateSerializer,
+        std::istream& iStream
         )
-    { }
+    {
+      using Teuchos::outArg;
+      TEUCHOS_ASSERT( !Teuchos::is_null(x_) );
+      const RCP<const Thyra::VectorSpaceBase<Scalar> > space = x_->space();
+      deSerializeVector_(stateSerializer,*space,outArg(scaled_x_old_),iStream);
+      deSerializeVector_(stateSerializer,*space,outArg(x_old_),iStream);
+      deSerializeVector_(stateSerializer,*space,outArg(x_dot_old_),iStream);
+      deSerializeVector_(stateSerializer,*space,outArg(x_),iStream);
+      deSerializeVector_(stateSerializer,*space,outArg(x_dot_),iStream);
+      deSerializeVector_(stateSerializer,*space,outArg(dx_),iStream);
+      stateSerializer.deSerializeScalar(outArg(t_),iStream);
+      stateSerializer.deSerializeScalar(outArg(t_old_),iStream);
+      stateSerializer.deSerializeScalar(outArg(dt_),iStream);
+      stateSerializer.deSerializeInt(outArg(numSteps_),iStream);
+      stateSerializer.deSerializeInt(outArg(newtonConvergenceStatus_),iStream);
+      stateSerializer.deSerializeBool(outArg(isInitialized_),iStream);
+      stateSerializer.deSerializeBool(outArg(haveInitialCondition_),iStream);
+    }
 
     void set_scaled_x_old(const RCP<const VectorBase<Scalar> >& scaled_x_old )
     {
@@ -247,6 +290,39 @@ template<class Scalar>
     { return Teuchos::null; }
 
   private:
+
+    // The vectors that are not set yet are written as a false flag.
+    static void serializeVector_(
+        const StateSerializerStrategy<Scalar>& stateSerializer,
+        const RCP<const VectorBase<Scalar> >& vec,
+        std::ostream& oStream
+        )
+    {
+      stateSerializer.serializeBool(!Teuchos::is_null(vec),oStream);
+      if (!Teuchos::is_null(vec)) {
+        stateSerializer.serializeVectorBase(*vec,oStream);
+      }
+    }
+
+    static void deSerializeVector_(
+        const StateSerializerStrategy<Scalar>& stateSerializer,
+        const Thyra::VectorSpaceBase<Scalar>& space,
+        const Ptr<RCP<VectorBase<Scalar> > >& vec,
+        std::istream& iStream
+        )
+    {
+      bool haveVec = false;
+      stateSerializer.deSerializeBool(Teuchos::outArg(haveVec),iStream);
+      if (!haveVec) {
+        *vec = Teuchos::null;
+        return;
+      }
+      if (Teuchos::is_null(*vec)) {
+        *vec = Thyra::createMember(space);
+      }
+      stateSerializer.deSerializeVectorBase((*vec).ptr(),iStream);
+    }
+
     RCP<Thyra::VectorBase<Scalar> > scaled_x_old_;
     RCP<Thyra::VectorBase<Scalar> > x_old_;
     RCP<Thyra::VectorBase<Scalar> > x_dot_old_;
@@ -401,6 +477,9 @@ public:
   /** \brief . */
   const StepStatus<Scalar> getStepStatus() const;
 
+  /** \brief . */
+  StepperPerformanceCounters getPerformanceCounters() const;
+
   //@}
 
   /** \name Overridden from InterpolationBufferBase */
@@ -508,6 +587,7 @@ private:
 
   Scalar dt_;
   int numSteps_;
+  StepperPerformanceCounters perfCounters_;
 
   RCP<Rythmos::SingleResidualModelEvaluator<Scalar> >  neModel_;
 
@@ -465,6 +465,8 @@ Scalar BackwardEulerStepper<Scalar>::takeStep(Scalar dt,
 
     Thyra::SolveStatus<Scalar> neSolveStatus =
       solver_->solve(&*x_, NULL, &*dx_);
+    accumulateNonlinearSolveCounters(*solver_, neSolveStatus,
+      Teuchos::outArg(perfCounters_));
 
     // In the above solve, on input *x_ is the initial guess that comes from
     // the predictor.  On output, *x_ is the converged timestep solution and
@@ -492,6 +494,7 @@ Scalar BackwardEulerStepper<Scalar>::takeStep(Scalar dt,
     stepPass = stepControl_->acceptStep(*this,NULL);
 
     if (!stepPass) { // stepPass = false
+      ++perfCounters_.numRejectedSteps;
       status = stepControl_->rejectStep(*this);
 
       if (status != PREDICT_AGAIN)
@@ -511,6 +514,7 @@ Scalar BackwardEulerStepper<Scalar>::takeStep(Scalar dt,
     V_V( x_old_.ptr(), *x_ );
     t_ += dt_;
     numSteps_++;
+    ++perfCounters_.numSteps;
     stepControl_->completeStep(*this);
   } else {
     // Complete failure.  Return to Integrator with bad step size.
@@ -610,6 +614,13 @@ const StepStatus<Scalar> BackwardEulerStepper<Scalar>::getStepStatus() const
 
 }
 
+template<class Scalar>
+StepperPerformanceCounters
+BackwardEulerStepper<Scalar>::getPerformanceCounters() const
+{
+  return perfCounters_;
+}
+
 
 // Overridden from InterpolationBufferBase
 
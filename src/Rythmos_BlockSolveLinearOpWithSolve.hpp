@@ -0,0 +1,383 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef RYTHMOS_BLOCK_SOLVE_LINEAR_OP_WITH_SOLVE_HPP
+#define RYTHMOS_BLOCK_SOLVE_LINEAR_OP_WITH_SOLVE_HPP
+
+
+#include "Rythmos_Types.hpp"
+#include "Thyra_LinearOpWithSolveBase.hpp"
+#include "Thyra_MultiVectorBase.hpp"
+#include "Thyra_SolveSupportTypes.hpp"
+#include "Teuchos_Range1D.hpp"
+
+
+namespace Rythmos {
+
+
+/** \brief <tt>LinearOpWithSolveBase</tt> decorator that solves for the
+ * columns of a multi-vector in blocks of a fixed number of columns.
+ *
+ * A solve with a right-hand side multi-vector <tt>B</tt> of <tt>m</tt>
+ * columns is done as <tt>ceil(m/blockSize)</tt> solves with the decorated
+ * object, each given the next <tt>blockSize</tt> columns of <tt>B</tt> and
+ * <tt>X</tt> as one multi-vector.  What happens inside each of these solves
+ * is up to the decorated object: a direct solver such as Amesos reuses its
+ * one factorization for a back-substitution with all of the columns, and a
+ * block Krylov solver such as Belos works on all of the columns in one block
+ * when its own "Block Size" matches.  A block size of zero (the default)
+ * passes all of the columns to one solve, which makes this decorator a
+ * no-op, and a block size of one solves column by column.
+ *
+ * This is used for the sensitivity solves of the forward sensitivity
+ * models, where the <tt>np</tt> columns of <tt>S</tt> are all solved with
+ * the same state iteration matrix <tt>W</tt>.  The forward operator is just
+ * the decorated object.
+ */
+template<class Scalar>
+class BlockSolveLinearOpWithSolve
+  : virtual public Thyra::LinearOpWithSolveBase<Scalar>
+{
+public:
+
+  /** \name Constructors/initializers/accessors */
+  //@{
+
+  /** \brief . */
+  BlockSolveLinearOpWithSolve();
+
+  /** \brief . */
+  void initialize(
+    const RCP<const Thyra::LinearOpWithSolveBase<Scalar> > &lows,
+    const int blockSize
+    );
+
+  /** \brief . */
+  RCP<const Thyra::LinearOpWithSolveBase<Scalar> > getLinearOpWithSolve() const;
+
+  /** \brief . */
+  int getBlockSize() const;
+
+  //@}
+
+  /** \name Overridden from LinearOpBase */
+  //@{
+
+  /** \brief . */
+  RCP<const Thyra::VectorSpaceBase<Scalar> > range() const;
+
+  /** \brief . */
+  RCP<const Thyra::VectorSpaceBase<Scalar> > domain() const;
+
+  /** \brief Returns a decorator of the same block size around a clone of
+   * the decorated object.
+   *
+   * Throws <tt>std::logic_error</tt> if the decorated object does not
+   * support <tt>clone()</tt> as a <tt>LinearOpWithSolveBase</tt> object.
+   */
+  RCP<const Thyra::LinearOpBase<Scalar> > clone() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::Describable */
+  //@{
+
+  /** \brief . */
+  std::string description() const;
+
+  //@}
+
+protected:
+
+  /** \name Overridden from LinearOpBase */
+  //@{
+
+  /** \brief . */
+  bool opSupportedImpl(Thyra::EOpTransp M_trans) const;
+
+  /** \brief . */
+  void applyImpl(
+    const Thyra::EOpTransp M_trans,
+    const Thyra::MultiVectorBase<Scalar> &X,
+    const Ptr<Thyra::MultiVectorBase<Scalar> > &Y,
+    const Scalar alpha,
+    const Scalar beta
+    ) const;
+
+  //@}
+
+  /** \name Overridden from LinearOpWithSolveBase */
+  //@{
+
+  /** \brief . */
+  bool solveSupportsImpl(Thyra::EOpTransp M_trans) const;
+
+  /** \brief . */
+  bool solveSupportsSolveMeasureTypeImpl(
+    Thyra::EOpTransp M_trans,
+    const Thyra::SolveMeasureType& solveMeasureType
+    ) const;
+
+  /** \brief . */
+  Thyra::SolveStatus<Scalar> solveImpl(
+    const Thyra::EOpTransp transp,
+    const Thyra::MultiVectorBase<Scalar> &B,
+    const Ptr<Thyra::MultiVectorBase<Scalar> > &X,
+    const Ptr<const Thyra::SolveCriteria<Scalar> > solveCriteria
+    ) const;
+
+  //@}
+
+private:
+
+  RCP<const Thyra::LinearOpWithSolveBase<Scalar> > lows_;
+  int blockSize_;
+
+};
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates BlockSolveLinearOpWithSolve
+ */
+template<class Scalar>
+RCP<BlockSolveLinearOpWithSolve<Scalar> >
+blockSolveLinearOpWithSolve()
+{
+  return Teuchos::rcp(new BlockSolveLinearOpWithSolve<Scalar>());
+}
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates BlockSolveLinearOpWithSolve
+ */
+template<class Scalar>
+RCP<BlockSolveLinearOpWithSolve<Scalar> >
+blockSolveLinearOpWithSolve(
+  const RCP<const Thyra::LinearOpWithSolveBase<Scalar> > &lows,
+  const int blockSize
+  )
+{
+  RCP<BlockSolveLinearOpWithSolve<Scalar> >
+    blockLows = Teuchos::rcp(new BlockSolveLinearOpWithSolve<Scalar>());
+  blockLows->initialize(lows,blockSize);
+  return blockLows;
+}
+
+
+// ///////////////////////
+// Definition
+
+
+// Constructors/initializers/accessors
+
+
+template<class Scalar>
+BlockSolveLinearOpWithSolve<Scalar>::BlockSolveLinearOpWithSolve()
+  :blockSize_(0)
+{}
+
+
+template<class Scalar>
+void BlockSolveLinearOpWithSolve<Scalar>::initialize(
+  const RCP<const Thyra::LinearOpWithSolveBase<Scalar> > &lows,
+  const int blockSize
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(lows));
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    blockSize < 0, std::logic_error,
+    "Error, blockSize = " << blockSize << " can not be negative!"
+    );
+  lows_ = lows;
+  blockSize_ = blockSize;
+}
+
+
+template<class Scalar>
+RCP<const Thyra::LinearOpWithSolveBase<Scalar> >
+BlockSolveLinearOpWithSolve<Scalar>::getLinearOpWithSolve() const
+{
+  return lows_;
+}
+
+
+template<class Scalar>
+int BlockSolveLinearOpWithSolve<Scalar>::getBlockSize() const
+{
+  return blockSize_;
+}
+
+
+// Overridden from LinearOpBase
+
+
+template<class Scalar>
+RCP<const Thyra::VectorSpaceBase<Scalar> >
+BlockSolveLinearOpWithSolve<Scalar>::range() const
+{
+  return ( nonnull(lows_) ? lows_->range() : Teuchos::null );
+}
+
+
+template<class Scalar>
+RCP<const Thyra::VectorSpaceBase<Scalar> >
+BlockSolveLinearOpWithSolve<Scalar>::domain() const
+{
+  return ( nonnull(lows_) ? lows_->domain() : Teuchos::null );
+}
+
+
+template<class Scalar>
+RCP<const Thyra::LinearOpBase<Scalar> >
+BlockSolveLinearOpWithSolve<Scalar>::clone() const
+{
+  RCP<BlockSolveLinearOpWithSolve<Scalar> >
+    blockLows = blockSolveLinearOpWithSolve<Scalar>();
+  blockLows->blockSize_ = blockSize_;
+  if (nonnull(lows_)) {
+    const RCP<const Thyra::LinearOpWithSolveBase<Scalar> > lows =
+      Teuchos::rcp_dynamic_cast<const Thyra::LinearOpWithSolveBase<Scalar> >(
+        lows_->clone() );
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      is_null(lows), std::logic_error,
+      "Error, the decorated object " << lows_->description()
+      << " does not support clone() as a LinearOpWithSolveBase object!"
+      );
+    blockLows->initialize(lows,blockSize_);
+  }
+  return blockLows;
+}
+
+
+// Overridden from Teuchos::Describable
+
+
+template<class Scalar>
+std::string BlockSolveLinearOpWithSolve<Scalar>::description() const
+{
+  std::ostringstream oss;
+  oss << this->Teuchos::Describable::description()
+      << "{blockSize=" << blockSize_;
+  if (nonnull(lows_))
+    oss << ",lows=" << lows_->description();
+  oss << "}";
+  return oss.str();
+}
+
+
+// protected
+
+
+// Overridden from LinearOpBase
+
+
+template<class Scalar>
+bool BlockSolveLinearOpWithSolve<Scalar>::opSupportedImpl(
+  Thyra::EOpTransp M_trans
+  ) const
+{
+  return Thyra::opSupported(*lows_,M_trans);
+}
+
+
+template<class Scalar>
+void BlockSolveLinearOpWithSolve<Scalar>::applyImpl(
+  const Thyra::EOpTransp M_trans,
+  const Thyra::MultiVectorBase<Scalar> &X,
+  const Ptr<Thyra::MultiVectorBase<Scalar> > &Y,
+  const Scalar alpha,
+  const Scalar beta
+  ) const
+{
+  Thyra::apply( *lows_, M_trans, X, Y, alpha, beta );
+}
+
+
+// Overridden from LinearOpWithSolveBase
+
+
+template<class Scalar>
+bool BlockSolveLinearOpWithSolve<Scalar>::solveSupportsImpl(
+  Thyra::EOpTransp M_trans
+  ) const
+{
+  return lows_->solveSupports(M_trans);
+}
+
+
+template<class Scalar>
+bool BlockSolveLinearOpWithSolve<Scalar>::solveSupportsSolveMeasureTypeImpl(
+  Thyra::EOpTransp M_trans,
+  const Thyra::SolveMeasureType& solveMeasureType
+  ) const
+{
+  return lows_->solveSupportsSolveMeasureType(M_trans,solveMeasureType);
+}
+
+
+template<class Scalar>
+Thyra::SolveStatus<Scalar>
+BlockSolveLinearOpWithSolve<Scalar>::solveImpl(
+  const Thyra::EOpTransp transp,
+  const Thyra::MultiVectorBase<Scalar> &B,
+  const Ptr<Thyra::MultiVectorBase<Scalar> > &X,
+  const Ptr<const Thyra::SolveCriteria<Scalar> > solveCriteria
+  ) const
+{
+
+  RYTHMOS_FUNC_TIME_MONITOR("Rythmos::BlockSolveLinearOpWithSolve::solve");
+
+  const int numCols = B.domain()->dim();
+
+  if ( blockSize_ == 0 || numCols <= blockSize_ ) {
+    return lows_->solve(transp, B, X, solveCriteria);
+  }
+
+  Thyra::SolveStatus<Scalar> overallSolveStatus;
+  Thyra::accumulateSolveStatusInit(Teuchos::outArg(overallSolveStatus));
+
+  for ( int j = 0; j < numCols; j += blockSize_ ) {
+    const Teuchos::Range1D cols(j, std::min(j+blockSize_,numCols)-1);
+    const Thyra::SolveStatus<Scalar> solveStatus =
+      lows_->solve(transp, *B.subView(cols), X->subView(cols).ptr(), solveCriteria);
+    Thyra::accumulateSolveStatus(
+      Thyra::SolveCriteria<Scalar>(), solveStatus,
+      Teuchos::outArg(overallSolveStatus) );
+  }
+
+  return overallSolveStatus;
+
+}
+
+
+} // namespace Rythmos
+
+
+#endif // RYTHMOS_BLOCK_SOLVE_LINEAR_OP_WITH_SOLVE_HPP
@@ -29,6 +29,12 @@
 #ifndef Rythmos_BREAK_POINT_INFORMER_H
 #define Rythmos_BREAK_POINT_INFORMER_H
 
+#include "Rythmos_Types.hpp"
+#include "Rythmos_StepperSupportTypes.hpp"
+#include "Teuchos_Describable.hpp"
+#include "Teuchos_VerboseObject.hpp"
+#include "Teuchos_ParameterListAcceptor.hpp"
+
 namespace Rythmos {
 
 /** \brief Interface for using breakpoints.   */
@@ -59,6 +65,16 @@ class BreakPointInformerBase
      */
     virtual void removeNextBreakPoint(Scalar& time0) =0;
 
+    /** \brief Get the type of the next break point.
+     *
+     *  Returns the type of the breakpoint returned by
+     *  <tt>getNextBreakPoint(time0)</tt>.  At a hard breakpoint the
+     *  integrator restarts the stepper, at a soft one it only lands on it.
+     *  The default treats all breakpoints as hard.
+     */
+    virtual EBreakPointType getNextBreakPointType(Scalar& /* time0 */) const
+      { return BREAK_POINT_TYPE_HARD; }
+
 };
 
 } // namespace Rythmos
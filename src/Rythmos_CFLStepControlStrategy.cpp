@@ -0,0 +1,14 @@
+#include "Rythmos_CFLStepControlStrategy_decl.hpp"
+
+#ifdef HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
+
+#include "Rythmos_CFLStepControlStrategy_def.hpp"
+#include "Rythmos_ExplicitInstantiationHelpers.hpp"
+
+namespace Rythmos {
+
+RYTHMOS_MACRO_TEMPLATE_INSTANT_SCALAR_TYPES(RYTHMOS_CFL_STEP_CONTROL_STRATEGY_INSTANT)
+
+} // namespace Rythmos
+
+#endif // HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
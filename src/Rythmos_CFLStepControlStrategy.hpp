@@ -0,0 +1,4 @@
+#include "Rythmos_CFLStepControlStrategy_decl.hpp"
+#ifndef HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
+#include "Rythmos_CFLStepControlStrategy_def.hpp"
+#endif
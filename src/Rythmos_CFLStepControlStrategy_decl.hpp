@@ -0,0 +1,214 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_CFL_STEP_CONTROL_STRATEGY_DECL_H
+#define Rythmos_CFL_STEP_CONTROL_STRATEGY_DECL_H
+
+#include "Rythmos_StepControlStrategyBase.hpp"
+#include "Thyra_VectorBase.hpp"
+#include "Teuchos_VerboseObject.hpp"
+
+namespace Rythmos {
+
+// Step Control Strategy object for CFLStepControlStrategy
+//
+// Order of calls:
+// setRequestedStepSize()
+// nextStepSize()
+// optional:  nextStepOrder()
+// setCorrection
+// acceptStep
+// completeStep or rejectStep
+// repeat
+//
+/** \brief Step Control Strategy that selects the largest stable step size
+ * from a model-supplied CFL (wave speed) response.
+ *
+ * This strategy is intended for explicit (in particular strong-stability
+ * preserving) Runge-Kutta methods applied to semi-discretized hyperbolic
+ * problems, where the step size is limited by stability rather than by
+ * accuracy.  Before each step the model response
+ * \f$ g_j(x_n,t_n) \f$, with \f$ j \f$ given by the
+ * <tt>"Max Wave Speed Response Index"</tt> parameter, is evaluated at the
+ * current state.  Its components are the local ratios of the wave speed
+ * to the mesh size, \f$ |\lambda_i| / \Delta x_i \f$, i.e., the inverse of
+ * the Forward Euler stable step size in each cell.  The step size is then
+ *
+ * \f[ \Delta t_{n+1} = \frac{\nu \, C}{\max_i |g_{j,i}|} \f]
+ *
+ * where \f$ \nu \f$ is the <tt>"CFL Number"</tt> and \f$ C \f$ is the
+ * strong-stability-preserving coefficient of the stepper's Butcher tableau
+ * (see <tt>RKButcherTableauBase::sspCoefficient()</tt>), or one if the
+ * stepper does not have an SSP tableau or <tt>"Use SSP Coefficient"</tt> is
+ * false.  The result is bounded by the requested step size (e.g., to land
+ * on the final time) and by the minimum and maximum step sizes.
+ *
+ * For <tt>STEP_TYPE_FIXED</tt> the requested step size is used unchanged.
+ */
+template<class Scalar>
+class CFLStepControlStrategy
+  : virtual public StepControlStrategyBase<Scalar>
+{
+  public:
+
+    typedef typename Teuchos::ScalarTraits<Scalar>::magnitudeType ScalarMag;
+
+    /** \name Overridden from StepControlStrategyBase */
+    //@{
+    /** \brief . */
+    void setRequestedStepSize(const StepperBase<Scalar>& stepper,
+      const Scalar& stepSize, const StepSizeType& stepSizeType);
+
+    /** \brief . */
+    void nextStepSize(const StepperBase<Scalar>& stepper, Scalar* stepSize,
+      StepSizeType* stepSizeType, int* order);
+
+    /** \brief . */
+    void setCorrection(
+         const StepperBase<Scalar>& stepper
+        ,const RCP<const Thyra::VectorBase<Scalar> >& soln
+        ,const RCP<const Thyra::VectorBase<Scalar> >& ee
+        ,int solveStatus
+        );
+
+    /** \brief . */
+    bool acceptStep(const StepperBase<Scalar>& stepper, Scalar* LETValue);
+
+    /** \brief . */
+    void completeStep(const StepperBase<Scalar>& stepper);
+
+    /** \brief . */
+    AttemptedStepStatusFlag rejectStep(const StepperBase<Scalar>& stepper);
+
+    /** \brief . */
+    StepControlStrategyState getCurrentState();
+
+    /** \brief . */
+    int getMaxOrder() const;
+
+    /** \brief . */
+    void setStepControlData(const StepperBase<Scalar>& stepper);
+
+    /** \brief . */
+    bool supportsCloning() const;
+
+    /** \brief . */
+    RCP<StepControlStrategyBase<Scalar> > cloneStepControlStrategyAlgorithm() const;
+
+    //@}
+
+    CFLStepControlStrategy();
+
+    /** \brief Return the stable step size computed for the last step. */
+    Scalar getStableStepSize() const;
+
+    /** \name Overridden from Teuchos::Describable */
+    //@{
+    /** \brief . */
+    void describe(
+      Teuchos::FancyOStream &out,
+      const Teuchos::EVerbosityLevel verbLevel
+      ) const;
+    //@}
+
+    /** \name Overridden from ParameterListAcceptor */
+    //@{
+    /** \brief . */
+    void setParameterList(RCP<Teuchos::ParameterList> const& paramList);
+
+    /** \brief . */
+    RCP<Teuchos::ParameterList> getNonconstParameterList();
+
+    /** \brief . */
+    RCP<Teuchos::ParameterList> unsetParameterList();
+
+    /** \brief . */
+    RCP<const Teuchos::ParameterList> getValidParameters() const;
+
+    //@}
+
+    void initialize(const StepperBase<Scalar>& stepper);
+
+
+  private:
+
+    // Private data members
+
+    StepControlStrategyState stepControlState_;
+
+    RCP<Teuchos::ParameterList> parameterList_;
+
+    Scalar requestedStepSize_;
+    Scalar currentStepSize_;
+    Scalar stableStepSize_;
+    StepSizeType stepSizeType_;
+
+    int responseIndex_;
+    Scalar cflNumber_;
+    bool useSSPCoefficient_;
+    Scalar minStepSize_;
+    Scalar maxStepSize_;
+    Scalar stepSizeDecreaseFactor_;
+    int numStepFailures_;
+    int maxStepFailures_;
+    int solveStatus_;
+
+    RCP<Thyra::VectorBase<Scalar> > waveSpeed_;
+
+    static const std::string responseIndexName_;
+    static const int responseIndexDefault_;
+
+    static const std::string cflNumberName_;
+    static const double cflNumberDefault_;
+
+    static const std::string useSSPCoefficientName_;
+    static const bool useSSPCoefficientDefault_;
+
+    static const std::string minStepSizeName_;
+    static const double minStepSizeDefault_;
+
+    static const std::string maxStepSizeName_;
+    static const double maxStepSizeDefault_;
+
+    static const std::string stepSizeDecreaseFactorName_;
+    static const double stepSizeDecreaseFactorDefault_;
+
+    static const std::string maxStepFailuresName_;
+    static const int maxStepFailuresDefault_;
+
+    // Private member functions
+
+    void setStepControlState_(StepControlStrategyState state);
+
+    Scalar computeStableStepSize_(const StepperBase<Scalar>& stepper);
+
+};
+
+} // namespace Rythmos
+
+#endif // Rythmos_CFL_STEP_CONTROL_STRATEGY_DECL_H
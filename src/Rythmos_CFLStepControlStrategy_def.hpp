@@ -0,0 +1,577 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_CFL_STEP_CONTROL_STRATEGY_DEF_H
+#define Rythmos_CFL_STEP_CONTROL_STRATEGY_DEF_H
+
+#include "Rythmos_CFLStepControlStrategy_decl.hpp"
+#include "Rythmos_RKButcherTableauAcceptingStepperBase.hpp"
+#include "Thyra_VectorStdOps.hpp"
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+
+namespace Rythmos {
+
+// Static members
+
+
+template<class Scalar>
+const std::string
+CFLStepControlStrategy<Scalar>::responseIndexName_
+= "Max Wave Speed Response Index";
+
+template<class Scalar>
+const int
+CFLStepControlStrategy<Scalar>::responseIndexDefault_
+= 0;
+
+
+template<class Scalar>
+const std::string
+CFLStepControlStrategy<Scalar>::cflNumberName_
+= "CFL Number";
+
+template<class Scalar>
+const double
+CFLStepControlStrategy<Scalar>::cflNumberDefault_
+= 0.9;
+
+
+template<class Scalar>
+const std::string
+CFLStepControlStrategy<Scalar>::useSSPCoefficientName_
+= "Use SSP Coefficient";
+
+template<class Scalar>
+const bool
+CFLStepControlStrategy<Scalar>::useSSPCoefficientDefault_
+= true;
+
+
+template<class Scalar>
+const std::string
+CFLStepControlStrategy<Scalar>::minStepSizeName_
+= "Min Step Size";
+
+template<class Scalar>
+const double
+CFLStepControlStrategy<Scalar>::minStepSizeDefault_
+= std::numeric_limits<Scalar>::min();
+
+
+template<class Scalar>
+const std::string
+CFLStepControlStrategy<Scalar>::maxStepSizeName_
+= "Max Step Size";
+
+template<class Scalar>
+const double
+CFLStepControlStrategy<Scalar>::maxStepSizeDefault_
+= std::numeric_limits<Scalar>::max();
+
+
+template<class Scalar>
+const std::string
+CFLStepControlStrategy<Scalar>::stepSizeDecreaseFactorName_
+= "Step Size Decrease Factor";
+
+template<class Scalar>
+const double
+CFLStepControlStrategy<Scalar>::stepSizeDecreaseFactorDefault_
+= 0.5;
+
+
+template<class Scalar>
+const std::string
+CFLStepControlStrategy<Scalar>::maxStepFailuresName_
+= "Maximum Number of Step Failures";
+
+template<class Scalar>
+const int
+CFLStepControlStrategy<Scalar>::maxStepFailuresDefault_
+= 10;
+
+
+// Constructors
+
+template<class Scalar>
+void CFLStepControlStrategy<Scalar>::setStepControlState_(
+  StepControlStrategyState newState)
+{
+  if (stepControlState_ == UNINITIALIZED) {
+    TEUCHOS_TEST_FOR_EXCEPT(newState != BEFORE_FIRST_STEP);
+  } else if (stepControlState_ == BEFORE_FIRST_STEP) {
+    TEUCHOS_TEST_FOR_EXCEPT(newState != MID_STEP);
+  } else if (stepControlState_ == MID_STEP) {
+    TEUCHOS_TEST_FOR_EXCEPT(newState != AFTER_CORRECTION);
+  } else if (stepControlState_ == AFTER_CORRECTION) {
+    TEUCHOS_TEST_FOR_EXCEPT(newState != READY_FOR_NEXT_STEP);
+  } else if (stepControlState_ == READY_FOR_NEXT_STEP) {
+    TEUCHOS_TEST_FOR_EXCEPT(newState != MID_STEP);
+  }
+  stepControlState_ = newState;
+}
+
+template<class Scalar>
+StepControlStrategyState CFLStepControlStrategy<Scalar>::getCurrentState()
+{
+  return(stepControlState_);
+}
+
+template<class Scalar>
+CFLStepControlStrategy<Scalar>::CFLStepControlStrategy()
+  : stepControlState_(UNINITIALIZED),
+    requestedStepSize_(Scalar(-1.0)),
+    currentStepSize_(Scalar(-1.0)),
+    stableStepSize_(Scalar(-1.0)),
+    stepSizeType_(STEP_TYPE_VARIABLE),
+    responseIndex_(responseIndexDefault_),
+    cflNumber_(cflNumberDefault_),
+    useSSPCoefficient_(useSSPCoefficientDefault_),
+    minStepSize_(minStepSizeDefault_),
+    maxStepSize_(maxStepSizeDefault_),
+    stepSizeDecreaseFactor_(stepSizeDecreaseFactorDefault_),
+    numStepFailures_(0),
+    maxStepFailures_(maxStepFailuresDefault_),
+    solveStatus_(0)
+{}
+
+template<class Scalar>
+void CFLStepControlStrategy<Scalar>::initialize(
+  const StepperBase<Scalar>& stepper)
+{
+  using Teuchos::as;
+
+  RCP<Teuchos::FancyOStream> out = this->getOStream();
+  Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+  const bool doTrace = (as<int>(verbLevel) >= as<int>(Teuchos::VERB_HIGH));
+  Teuchos::OSTab ostab(out,1,"initialize");
+
+  if (doTrace) {
+    *out << "\nEntering " << this->Teuchos::Describable::description()
+         << "::initialize()...\n";
+  }
+
+  RCP<const Thyra::ModelEvaluator<Scalar> > model = stepper.getModel();
+  TEUCHOS_TEST_FOR_EXCEPTION( is_null(model), std::logic_error,
+    "Error, CFLStepControlStrategy requires the stepper to have a model!\n");
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !((0 <= responseIndex_) && (responseIndex_ < model->Ng())),
+    std::logic_error,
+    "Error, (" << responseIndexName_ << "=" << responseIndex_ << ") is not "
+    "a valid response index for the model with Ng=" << model->Ng() << "!\n");
+  if (is_null(waveSpeed_))
+    waveSpeed_ = Thyra::createMember(model->get_g_space(responseIndex_));
+  numStepFailures_ = 0;
+  setStepControlState_(BEFORE_FIRST_STEP);
+
+  if (doTrace) {
+    *out << "\nLeaving " << this->Teuchos::Describable::description()
+         << "::initialize()...\n";
+  }
+}
+
+template<class Scalar>
+void CFLStepControlStrategy<Scalar>::setRequestedStepSize(
+  const StepperBase<Scalar>& stepper,
+  const Scalar& stepSize,
+  const StepSizeType& stepSizeType)
+{
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !((stepControlState_ == UNINITIALIZED) ||
+      (stepControlState_ == BEFORE_FIRST_STEP) ||
+      (stepControlState_ == READY_FOR_NEXT_STEP) ||
+      (stepControlState_ == MID_STEP)), std::logic_error,
+     "Error: Invalid state (stepControlState_=" << toString(stepControlState_)
+     << ") for CFLStepControlStrategy<Scalar>::setRequestedStepSize()\n");
+
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    ((stepSizeType == STEP_TYPE_FIXED) && (stepSize == ST::zero())),
+    std::logic_error, "Error, step size type == STEP_TYPE_FIXED, "
+    "but requested step size == 0!\n");
+
+  if (stepControlState_ == UNINITIALIZED) initialize(stepper);
+  requestedStepSize_ = stepSize;
+  stepSizeType_ = stepSizeType;
+}
+
+template<class Scalar>
+Scalar CFLStepControlStrategy<Scalar>::computeStableStepSize_(
+  const StepperBase<Scalar>& stepper)
+{
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  typedef Thyra::ModelEvaluatorBase MEB;
+
+  RCP<const Thyra::ModelEvaluator<Scalar> > model = stepper.getModel();
+  const StepStatus<Scalar> stepStatus = stepper.getStepStatus();
+  TEUCHOS_TEST_FOR_EXCEPTION( is_null(stepStatus.solution), std::logic_error,
+    "Error, CFLStepControlStrategy requires the stepper to have a state!\n");
+
+  // Evaluate the wave speed response at the current state.
+  MEB::InArgs<Scalar> inArgs = model->createInArgs();
+  inArgs.setArgs(stepper.getInitialCondition(), true);
+  inArgs.set_x(stepStatus.solution);
+  if (inArgs.supports(MEB::IN_ARG_t))
+    inArgs.set_t(stepStatus.time);
+  if (inArgs.supports(MEB::IN_ARG_x_dot) && !is_null(stepStatus.solutionDot))
+    inArgs.set_x_dot(stepStatus.solutionDot);
+  MEB::OutArgs<Scalar> outArgs = model->createOutArgs();
+  outArgs.set_g(responseIndex_, waveSpeed_);
+  model->evalModel(inArgs, outArgs);
+  const ScalarMag maxWaveSpeed = Thyra::norm_inf(*waveSpeed_);
+
+  // Scale the Forward Euler limit by the SSP coefficient of the method.
+  Scalar sspCoef = ST::one();
+  if (useSSPCoefficient_) {
+    const RKButcherTableauAcceptingStepperBase<Scalar>* rkbtStepper =
+      dynamic_cast<const RKButcherTableauAcceptingStepperBase<Scalar>*>(&stepper);
+    if (rkbtStepper != NULL) {
+      RCP<const RKButcherTableauBase<Scalar> > rkbt =
+        rkbtStepper->getRKButcherTableau();
+      if (!is_null(rkbt) && rkbt->sspCoefficient() > ST::zero())
+        sspCoef = rkbt->sspCoefficient();
+    }
+  }
+
+  if (maxWaveSpeed == ST::zero()) return maxStepSize_;
+  return cflNumber_*sspCoef/maxWaveSpeed;
+}
+
+template<class Scalar>
+void CFLStepControlStrategy<Scalar>::nextStepSize(
+  const StepperBase<Scalar>& stepper, Scalar* stepSize,
+  StepSizeType* stepSizeType, int* /* order */)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(!((stepControlState_ == BEFORE_FIRST_STEP) ||
+                               (stepControlState_ == MID_STEP) ||
+                               (stepControlState_ == READY_FOR_NEXT_STEP) ),
+                               std::logic_error,
+     "Error: Invalid state (stepControlState_=" << toString(stepControlState_)
+     << ") for CFLStepControlStrategy<Scalar>::nextStepSize()\n");
+
+  stepSizeType_ = *stepSizeType;
+  if (stepSizeType_ == STEP_TYPE_FIXED) {
+    currentStepSize_ = requestedStepSize_;
+  } else { // STEP_TYPE_VARIABLE
+    stableStepSize_ = computeStableStepSize_(stepper);
+    currentStepSize_ = stableStepSize_;
+    for (int i=0 ; i<numStepFailures_ ; ++i)
+      currentStepSize_ *= stepSizeDecreaseFactor_;
+    currentStepSize_ = std::max(currentStepSize_, minStepSize_);
+    currentStepSize_ = std::min(currentStepSize_, maxStepSize_);
+    // Limit the step size to the requested step size
+    currentStepSize_ = std::min(requestedStepSize_, currentStepSize_);
+  }
+
+  Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+  if ( Teuchos::as<int>(verbLevel) >= Teuchos::as<int>(Teuchos::VERB_HIGH) ) {
+    RCP<Teuchos::FancyOStream> out = this->getOStream();
+    Teuchos::OSTab ostab(out,1,"nextStepSize");
+    *out << "stableStepSize_  = " << stableStepSize_ << "\n";
+    *out << "currentStepSize_ = " << currentStepSize_ << "\n";
+  }
+
+  *stepSize = currentStepSize_;
+  setStepControlState_(MID_STEP);
+}
+
+template<class Scalar>
+void CFLStepControlStrategy<Scalar>::setCorrection(
+     const StepperBase<Scalar>& /* stepper */
+    ,const RCP<const Thyra::VectorBase<Scalar> >& /* soln */
+    ,const RCP<const Thyra::VectorBase<Scalar> >& /* ee */
+    ,int solveStatus)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(stepControlState_ != MID_STEP, std::logic_error,
+     "Error: Invalid state (stepControlState_=" << toString(stepControlState_)
+     << ") for CFLStepControlStrategy<Scalar>::setCorrection()\n");
+  solveStatus_ = solveStatus;
+  setStepControlState_(AFTER_CORRECTION);
+}
+
+template<class Scalar>
+bool CFLStepControlStrategy<Scalar>::acceptStep(
+  const StepperBase<Scalar>& /* stepper */, Scalar* /* LETValue */)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(stepControlState_ != AFTER_CORRECTION,
+     std::logic_error,
+     "Error: Invalid state (stepControlState_=" << toString(stepControlState_)
+     << ") for CFLStepControlStrategy<Scalar>::acceptStep()\n");
+
+  // The step size was chosen to be stable, so the step is only rejected if
+  // the stepper reports a failed (nonlinear) solve.
+  return (solveStatus_ >= 0);
+}
+
+template<class Scalar>
+AttemptedStepStatusFlag CFLStepControlStrategy<Scalar>::rejectStep(
+  const StepperBase<Scalar>& /* stepper */)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(stepControlState_ != AFTER_CORRECTION,
+     std::logic_error,
+     "Error: Invalid state (stepControlState_=" << toString(stepControlState_)
+     << ") for CFLStepControlStrategy<Scalar>::rejectStep()\n");
+
+  setStepControlState_(READY_FOR_NEXT_STEP);
+
+  using Teuchos::as;
+
+  RCP<Teuchos::FancyOStream> out = this->getOStream();
+  Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+  Teuchos::OSTab ostab(out,1,"rejectStep");
+
+  numStepFailures_ ++;
+  if ( as<int>(verbLevel) != as<int>(Teuchos::VERB_NONE) )
+    *out << "numStepFailures_ = " << numStepFailures_ << "\n";
+  if (numStepFailures_ > maxStepFailures_) {
+    *out << "Rythmos_CFLStepControlStrategy::rejectStep(...):  "
+         << "Error: Too many step failures "
+         << "(numStepFailures="<<numStepFailures_
+         <<") > (maxStepFailures="<<maxStepFailures_<<")\n";
+    return (REP_ERR_FAIL);
+  }
+
+  // Fail if we are running with fixed stepsize.
+  if (stepSizeType_ == STEP_TYPE_FIXED) {
+    if ( as<int>(verbLevel) != as<int>(Teuchos::VERB_NONE) ) {
+      *out << "Rythmos_CFLStepControlStrategy::rejectStep(...):  "
+           << "Error:  Step failure with fixed step size.\n";
+    }
+    return (REP_ERR_FAIL);
+  }
+
+  return (PREDICT_AGAIN);
+}
+
+template<class Scalar>
+void CFLStepControlStrategy<Scalar>::completeStep(
+  const StepperBase<Scalar>& /* stepper */)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(stepControlState_ != AFTER_CORRECTION,
+     std::logic_error,
+     "Error: Invalid state (stepControlState_=" << toString(stepControlState_)
+     << ") for CFLStepControlStrategy<Scalar>::completeStep()\n");
+
+  numStepFailures_ = 0;
+  setStepControlState_(READY_FOR_NEXT_STEP);
+}
+
+template<class Scalar>
+Scalar CFLStepControlStrategy<Scalar>::getStableStepSize() const
+{
+  return stableStepSize_;
+}
+
+template<class Scalar>
+void CFLStepControlStrategy<Scalar>::describe(
+  Teuchos::FancyOStream &out,
+  const Teuchos::EVerbosityLevel verbLevel
+  ) const
+{
+
+  using Teuchos::as;
+
+  if ( (as<int>(verbLevel) == as<int>(Teuchos::VERB_DEFAULT) ) ||
+       (as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW)     )    ) {
+    out << this->description() << "::describe" << "\n";
+  }
+  if (as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW)) {
+    out << "responseIndex_     = " << responseIndex_ << "\n";
+    out << "cflNumber_         = " << cflNumber_ << "\n";
+    out << "useSSPCoefficient_ = " << useSSPCoefficient_ << "\n";
+    out << "requestedStepSize_ = " << requestedStepSize_ << "\n";
+    out << "stableStepSize_    = " << stableStepSize_ << "\n";
+    out << "currentStepSize_   = " << currentStepSize_ << "\n";
+    out << "stepSizeType_      = " << stepSizeType_ << "\n";
+    out << "numStepFailures_   = " << numStepFailures_ << "\n";
+  }
+}
+
+template<class Scalar>
+void CFLStepControlStrategy<Scalar>::setParameterList(
+  RCP<Teuchos::ParameterList> const& paramList)
+{
+  using Teuchos::as;
+
+  TEUCHOS_TEST_FOR_EXCEPT(paramList == Teuchos::null);
+  paramList->validateParameters(*this->getValidParameters(),0);
+  parameterList_ = paramList;
+  Teuchos::readVerboseObjectSublist(&*parameterList_,this);
+
+  responseIndex_ = parameterList_->get(responseIndexName_,
+                                       responseIndexDefault_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !(responseIndex_ >= 0), std::logic_error,
+    "Error:  (" << responseIndexName_ << "=" << responseIndex_ << ") < 0\n");
+
+  cflNumber_ = parameterList_->get(cflNumberName_, cflNumberDefault_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !(cflNumber_ > 0.0), std::logic_error,
+    "Error:  (cflNumber="<<cflNumber_<<") <= 0.0\n");
+
+  useSSPCoefficient_ = parameterList_->get(useSSPCoefficientName_,
+                                           useSSPCoefficientDefault_);
+
+  minStepSize_ = parameterList_->get(minStepSizeName_, minStepSizeDefault_);
+  maxStepSize_ = parameterList_->get(maxStepSizeName_, maxStepSizeDefault_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !(minStepSize_ <= maxStepSize_), std::logic_error,
+    "Error:  (minStepSize="<<minStepSize_
+    <<") > (maxStepSize="<<maxStepSize_<<")\n");
+
+  stepSizeDecreaseFactor_ = parameterList_->get(stepSizeDecreaseFactorName_,
+                                                stepSizeDecreaseFactorDefault_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !((0.0 < stepSizeDecreaseFactor_) && (stepSizeDecreaseFactor_ < 1.0)),
+    std::logic_error,
+    "Error:  (stepSizeDecreaseFactor="<<stepSizeDecreaseFactor_
+    <<") is not in (0,1)\n");
+
+  maxStepFailures_ = parameterList_->get(maxStepFailuresName_,
+                                         maxStepFailuresDefault_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !(maxStepFailures_ >= 0), std::logic_error,
+    "Error:  (maxStepFailures="<<maxStepFailures_<<") < 0\n");
+
+  RCP<Teuchos::FancyOStream> out = this->getOStream();
+  Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+  Teuchos::OSTab ostab(out,1,"setParameterList");
+  out->precision(15);
+
+  if ( as<int>(verbLevel) >= as<int>(Teuchos::VERB_HIGH) ) {
+    *out << "responseIndex_          = " << responseIndex_          <<"\n";
+    *out << "cflNumber_              = " << cflNumber_              <<"\n";
+    *out << "useSSPCoefficient_      = " << useSSPCoefficient_      <<"\n";
+    *out << "minStepSize_            = " << minStepSize_            <<"\n";
+    *out << "maxStepSize_            = " << maxStepSize_            <<"\n";
+    *out << "stepSizeDecreaseFactor_ = " << stepSizeDecreaseFactor_ <<"\n";
+    *out << "maxStepFailures_        = " << maxStepFailures_        <<"\n";
+  }
+}
+
+template<class Scalar>
+RCP<const Teuchos::ParameterList>
+CFLStepControlStrategy<Scalar>::getValidParameters() const
+{
+  static RCP<Teuchos::ParameterList> validPL;
+  if (is_null(validPL)) {
+    RCP<Teuchos::ParameterList> pl = Teuchos::parameterList();
+
+    pl->set(responseIndexName_, responseIndexDefault_,
+      "Index of the model response g(j) whose components are the local "
+      "ratios of the maximum wave speed to the mesh size, |lambda|/dx.  "
+      "The largest magnitude component is the inverse of the Forward "
+      "Euler stable step size.");
+    pl->set(cflNumberName_, cflNumberDefault_,
+      "The fraction of the Forward Euler stable step size to take, "
+      "i.e., dt = CFL*C/max(|lambda|/dx), where C is the SSP coefficient.");
+    pl->set(useSSPCoefficientName_, useSSPCoefficientDefault_,
+      "If true and the stepper has a strong-stability-preserving Runge-Kutta "
+      "Butcher tableau, the stable step size is scaled by the SSP "
+      "coefficient of the tableau.");
+    pl->set(minStepSizeName_, minStepSizeDefault_, "Minimum step size.");
+    pl->set(maxStepSizeName_, maxStepSizeDefault_, "Maximum step size.");
+    pl->set(stepSizeDecreaseFactorName_, stepSizeDecreaseFactorDefault_,
+      "The factor applied to the stable step size for each consecutive "
+      "step failure reported by the stepper.");
+    pl->set(maxStepFailuresName_, maxStepFailuresDefault_,
+      "The maximum number of consecutive step failures before exiting "
+      "with an error.");
+
+    Teuchos::setupVerboseObjectSublist(&*pl);
+    validPL = pl;
+  }
+  return (validPL);
+}
+
+template<class Scalar>
+RCP<Teuchos::ParameterList>
+CFLStepControlStrategy<Scalar>::unsetParameterList()
+{
+  RCP<Teuchos::ParameterList> temp_param_list = parameterList_;
+  parameterList_ = Teuchos::null;
+  return(temp_param_list);
+}
+
+template<class Scalar>
+RCP<Teuchos::ParameterList>
+CFLStepControlStrategy<Scalar>::getNonconstParameterList()
+{
+  return(parameterList_);
+}
+
+template<class Scalar>
+void CFLStepControlStrategy<Scalar>::setStepControlData(
+  const StepperBase<Scalar>& stepper)
+{
+  if (stepControlState_ == UNINITIALIZED) initialize(stepper);
+}
+
+template<class Scalar>
+bool CFLStepControlStrategy<Scalar>::supportsCloning() const
+{
+  return true;
+}
+
+
+template<class Scalar>
+RCP<StepControlStrategyBase<Scalar> >
+CFLStepControlStrategy<Scalar>::cloneStepControlStrategyAlgorithm() const
+{
+  RCP<CFLStepControlStrategy<Scalar> >
+    stepControl = rcp(new CFLStepControlStrategy<Scalar>());
+
+  if (!is_null(parameterList_)) {
+    stepControl->setParameterList(parameterList_);
+  }
+
+  return stepControl;
+}
+
+template<class Scalar>
+int CFLStepControlStrategy<Scalar>::getMaxOrder() const
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+      stepControlState_ == UNINITIALIZED, std::logic_error,
+      "Error, attempting to call getMaxOrder before initialization!\n"
+      );
+  return(0);
+}
+
+//
+// Explicit Instantiation macro
+//
+// Must be expanded from within the Rythmos namespace!
+//
+
+#define RYTHMOS_CFL_STEP_CONTROL_STRATEGY_INSTANT(SCALAR) \
+  template class CFLStepControlStrategy< SCALAR >;
+
+
+} // namespace Rythmos
+#endif // Rythmos_CFL_STEP_CONTROL_STRATEGY_DEF_H
@@ -0,0 +1,1199 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef RYTHMOS_CHECKPOINTED_ADJOINT_DRIVER_HPP
+#define RYTHMOS_CHECKPOINTED_ADJOINT_DRIVER_HPP
+
+
+#include "Rythmos_InterpolationBufferBase.hpp"
+#include "Rythmos_BackwardEulerStepper.hpp"
+#include "Rythmos_MomentoBase.hpp"
+#include "Rythmos_StateSerializerStrategy.hpp"
+#include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+#include "Teuchos_GlobalMPISession.hpp"
+#include "Teuchos_Time.hpp"
+#include "Teuchos_as.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+#ifdef HAVE_RYTHMOS_THREADS
+#  include <exception>
+#  include <thread>
+#endif
+
+
+namespace Rythmos {
+
+
+/** \brief The largest number of steps <tt>beta(n,r) = (n+r)!/(n!*r!)</tt>
+ * that <tt>n</tt> checkpoints can reverse when no step is recomputed more
+ * than <tt>r</tt> times.
+ *
+ * \relates CheckpointedAdjointDriver
+ */
+inline long binomialCheckpointRange(const int n, const int r)
+{
+  if (r < 0)
+    return 0;
+  long beta = 1;
+  for (int k = 1; k <= r; ++k)
+    beta = (beta*(n+k))/k;
+  return beta;
+}
+
+
+/** \brief The fewest forward steps that must be recomputed to reverse
+ * <tt>numSteps</tt> steps with <tt>numCheckpoints</tt> checkpoints, one of
+ * which holds the state before the first step.
+ *
+ * This is <tt>r*numSteps - beta(numCheckpoints+1,r-1)</tt> (Griewank and
+ * Walther), where <tt>r</tt> is the smallest number with
+ * <tt>beta(numCheckpoints,r) >= numSteps</tt>.  The <tt>numSteps</tt> steps
+ * of the first forward sweep are not counted.
+ *
+ * \relates CheckpointedAdjointDriver
+ */
+inline long binomialCheckpointRecomputations(
+  const int numSteps, const int numCheckpoints
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(numCheckpoints < 1);
+  if (numSteps <= 1)
+    return 0;
+  int r = 0;
+  while (binomialCheckpointRange(numCheckpoints,r) < numSteps)
+    ++r;
+  return r*Teuchos::as<long>(numSteps)
+    - binomialCheckpointRange(numCheckpoints+1,r-1);
+}
+
+
+/** \brief The number of steps to advance from a checkpoint before storing
+ * the next one, when the <tt>numSteps</tt> steps after the checkpoint are to
+ * be reversed and <tt>numFreeCheckpoints</tt> checkpoints are still unused.
+ *
+ * Storing the next checkpoint <tt>m</tt> steps ahead costs <tt>m</tt> steps
+ * and splits the reversal into the last <tt>numSteps-m</tt> steps, reversed
+ * with one free checkpoint less, and the first <tt>m</tt> steps, reversed
+ * afterwards when that checkpoint is free again.  The recomputations of both
+ * parts are convex in <tt>m</tt>, so the smallest optimal <tt>m</tt> is found
+ * by bisection.
+ *
+ * \relates CheckpointedAdjointDriver
+ */
+inline int binomialCheckpointAdvance(
+  const int numSteps, const int numFreeCheckpoints
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(numSteps < 2);
+  TEUCHOS_TEST_FOR_EXCEPT(numFreeCheckpoints < 1);
+  const int s = numFreeCheckpoints;
+  int lower = 1;
+  int upper = numSteps-1;
+  while (lower < upper) {
+    const int m = (lower+upper)/2;
+    const long cost = m
+      + binomialCheckpointRecomputations(numSteps-m,s)
+      + binomialCheckpointRecomputations(m,s+1);
+    const long nextCost = (m+1)
+      + binomialCheckpointRecomputations(numSteps-m-1,s)
+      + binomialCheckpointRecomputations(m+1,s+1);
+    if (nextCost >= cost)
+      upper = m;
+    else
+      lower = m+1;
+  }
+  return lower;
+}
+
+
+/** \brief The number of steps between disk checkpoints that minimizes the
+ * cost of reversing <tt>numSteps</tt> steps with <tt>numCheckpoints</tt>
+ * checkpoints in memory and at most <tt>numDiskCheckpoints</tt> on disk.
+ *
+ * Splitting the steps into <tt>n</tt> intervals of <tt>K</tt> steps stores a
+ * disk checkpoint at the start of all but the last interval.  Each of these
+ * intervals is reversed by reading its checkpoint back and recomputing its
+ * steps with the binomial schedule in memory, so the cost in forward steps is
+ *
+ \verbatim
+
+   2*(n-1)*diskAccessCost + (n-1)*(K + R(K)) + R(N-(n-1)*K)
+
+ \endverbatim
+ *
+ * where <tt>diskAccessCost</tt> is the time to write or read one checkpoint
+ * in forward steps and <tt>R</tt> is
+ * <tt>binomialCheckpointRecomputations(.,numCheckpoints)</tt>.  Returns
+ * <tt>numSteps</tt> when the disk does not pay off.
+ *
+ * \relates CheckpointedAdjointDriver
+ */
+inline int binomialDiskCheckpointInterval(
+  const int numSteps, const int numCheckpoints,
+  const int numDiskCheckpoints, const double diskAccessCost
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(numSteps < 1);
+  TEUCHOS_TEST_FOR_EXCEPT(numDiskCheckpoints < 0);
+  double bestCost = binomialCheckpointRecomputations(numSteps,numCheckpoints);
+  int bestInterval = numSteps;
+  if (numDiskCheckpoints == 0)
+    return bestInterval;
+  const int minInterval = (numSteps + numDiskCheckpoints)/(numDiskCheckpoints+1);
+  for (int K = std::max(minInterval,1); K < numSteps; ++K) {
+    const int numDiskUsed = (numSteps-1)/K;
+    const double cost = 2.0*numDiskUsed*diskAccessCost
+      + numDiskUsed*double(K + binomialCheckpointRecomputations(K,numCheckpoints))
+      + binomialCheckpointRecomputations(numSteps-numDiskUsed*K,numCheckpoints);
+    if (cost < bestCost) {
+      bestCost = cost;
+      bestInterval = K;
+    }
+  }
+  return bestInterval;
+}
+
+
+/** \brief Integrates a model forward and provides its states to a backward
+ * adjoint integration while storing only a fixed number of checkpoints.
+ *
+ * <tt>AdjointModelEvaluator</tt> gets the forward state at the times the
+ * adjoint stepper asks for from an <tt>InterpolationBufferBase</tt>.  Holding
+ * the whole forward trajectory in an <tt>InterpolationBuffer</tt> for this
+ * takes memory in proportion to the number of steps.  This class is an
+ * <tt>InterpolationBufferBase</tt> that instead keeps at most "Number of
+ * Checkpoints" momentos of a <tt>BackwardEulerStepper</tt>, each with the
+ * state and the step history needed to restart the stepper (see
+ * <tt>MomentoBase</tt>).  The forward step containing a requested time is
+ * recomputed from the last checkpoint before it.
+ *
+ * The checkpoints are placed by the binomial schedule of Griewank and Walther
+ * ("revolve").  When the forward steps are asked for from last to first, it
+ * recomputes the fewest steps possible with <tt>c</tt> checkpoints,
+ *
+ \verbatim
+
+   r*N - (c+r)!/((c+1)!*(r-1)!)
+
+ \endverbatim
+ *
+ * for <tt>N</tt> forward steps, where <tt>r</tt> is the smallest number with
+ * <tt>(c+r)!/(c!*r!) >= N</tt> (see
+ * <tt>binomialCheckpointRecomputations()</tt>).  No step is recomputed more
+ * than <tt>r</tt> times, and keeping that bound fixed takes only about
+ * <tt>N^(1/r)</tt> checkpoints.  Other orders give the same states but may
+ * recompute more steps.
+ *
+ * A typical use is:
+ *
+ \code
+
+   RCP<CheckpointedAdjointDriver<double> > driver =
+     checkpointedAdjointDriver<double>(fwdStepper, paramList);
+   driver->integrateForward(finalTime, numSteps);
+
+   RCP<AdjointModelEvaluator<double> > adjModel =
+     adjointModelEvaluator<double>(fwdModel, driver->getTimeRange());
+   adjModel->setFwdStateSolutionBuffer(driver);
+
+   // Create adjStepper for adjModel with the adjoint initial condition at
+   // t_bar = 0, then:
+   driver->integrateAdjoint(adjStepper.ptr());
+
+ \endcode
+ *
+ * <tt>getNumRecomputedSteps()</tt> and <tt>getRecomputationWallTime()</tt>
+ * report the price paid for the memory saved.
+ *
+ * With "Number of Disk Checkpoints" greater than zero, checkpoints can also
+ * be written to binary files in "Disk Checkpoint Directory" with
+ * <tt>BinaryStateSerializerStrategy</tt>.  The file names hold the MPI rank,
+ * the process id and the driver, so that several processes and drivers can
+ * share the directory, and an existing file is never overwritten.  The forward steps are then split
+ * into intervals with a disk checkpoint at the start of each but the last,
+ * and each interval is reversed with the checkpoints in memory as above.
+ * The interval length is chosen by <tt>binomialDiskCheckpointInterval()</tt>
+ * from "Disk Access Cost", the time to write or read one checkpoint in
+ * forward steps, so that slow disks are used less.  While an interval is
+ * reversed, the disk checkpoint of the interval before it is read on a
+ * helper thread (with <tt>HAVE_RYTHMOS_THREADS</tt>), so the read overlaps
+ * with the adjoint steps.  This holds one more momento in memory.  The
+ * helper thread creates vectors in the model's state space, so the
+ * reference counts of Teuchos must be thread safe.
+ *
+ * The forward steps have a fixed size, so that the number of steps, and with
+ * it the schedule, is known before the first checkpoint is stored.  Only
+ * <tt>BackwardEulerStepper</tt> is supported, as it is the only implicit
+ * stepper that implements momentos.  <tt>AdjointModelEvaluator</tt> maps
+ * <tt>t_bar</tt> to <tt>t = getTimeRange().length() - t_bar</tt>, so the
+ * forward integration must start at <tt>t = 0</tt> when used with it.
+ */
+template<class Scalar>
+class CheckpointedAdjointDriver
+  : virtual public InterpolationBufferBase<Scalar>,
+    virtual public Teuchos::ParameterListAcceptorDefaultBase
+{
+public:
+
+  /** \brief . */
+  typedef typename ScalarTraits<Scalar>::magnitudeType ScalarMag;
+
+  /** \name Constructors/Initializers/Accessors */
+  //@{
+
+  /** \brief . */
+  CheckpointedAdjointDriver();
+
+  /** \brief Waits for a disk read in progress and removes the checkpoint
+   * files. */
+  ~CheckpointedAdjointDriver();
+
+  /** \brief Set the forward stepper.
+   *
+   * \param fwdStepper [in,persisting] Stepper with the forward model, a
+   * nonlinear solver, and the initial condition set.  It is restarted from
+   * the checkpoints by <tt>setMomento()</tt>, so it must not be used by
+   * anything else.
+   */
+  void initialize(const RCP<BackwardEulerStepper<Scalar> > &fwdStepper);
+
+  /** \brief . */
+  RCP<const BackwardEulerStepper<Scalar> > getFwdStepper() const;
+
+  /** \brief Integrate forward from the current time of the stepper to
+   * <tt>finalTime</tt> in <tt>numSteps</tt> equal steps, storing the
+   * checkpoints, and return the solution at the final time.
+   *
+   * Any checkpoints of an earlier forward integration are released first.
+   */
+  RCP<const Thyra::VectorBase<Scalar> >
+  integrateForward(const Scalar &finalTime, const int numSteps);
+
+  /** \brief Take one fixed step with <tt>adjointStepper</tt> for each forward
+   * step, from the last to the first.
+   *
+   * The adjoint stepper must be set up for an adjoint model that gets the
+   * forward state from <tt>*this</tt>, with the adjoint initial condition at
+   * <tt>t_bar = 0</tt>.
+   */
+  void integrateAdjoint(const Ptr<StepperBase<Scalar> > &adjointStepper);
+
+  /** \brief Number of steps of the last forward integration. */
+  int getNumForwardSteps() const;
+
+  /** \brief Number of forward steps recomputed since the last forward
+   * integration. */
+  int getNumRecomputedSteps() const;
+
+  /** \brief <tt>getNumRecomputedSteps()/getNumForwardSteps()</tt>. */
+  double getRecomputationRatio() const;
+
+  /** \brief Number of checkpoints currently stored. */
+  int getNumCheckpoints() const;
+
+  /** \brief Wall time in seconds of the last forward integration. */
+  double getForwardWallTime() const;
+
+  /** \brief Wall time in seconds spent recomputing forward steps since the
+   * last forward integration. */
+  double getRecomputationWallTime() const;
+
+  /** \brief Number of steps between the disk checkpoints of the last forward
+   * integration, or the number of steps if none were written. */
+  int getDiskCheckpointInterval() const;
+
+  /** \brief Number of disk checkpoints written by the last forward
+   * integration. */
+  int getNumDiskCheckpoints() const;
+
+  /** \brief Number of disk checkpoints read since the last forward
+   * integration. */
+  int getNumDiskReads() const;
+
+  /** \brief Wall time in seconds the calling thread spent writing disk
+   * checkpoints or waiting for them to be read since the start of the last
+   * forward integration. */
+  double getDiskWallTime() const;
+
+  //@}
+
+  /** \name Overridden from InterpolationBufferBase */
+  //@{
+
+  /** \brief . */
+  RCP<const Thyra::VectorSpaceBase<Scalar> > get_x_space() const;
+
+  /** \brief Throws, the states are only computed by
+   * <tt>integrateForward()</tt>. */
+  void addPoints(
+    const Array<Scalar>& time_vec,
+    const Array<RCP<const Thyra::VectorBase<Scalar> > >& x_vec,
+    const Array<RCP<const Thyra::VectorBase<Scalar> > >& xdot_vec
+    );
+
+  /** \brief The range of the last forward integration. */
+  TimeRange<Scalar> getTimeRange() const;
+
+  /** \brief Get the states by recomputing the forward steps they lie in.
+   *
+   * The times are handled in the given order.
+   */
+  void getPoints(
+    const Array<Scalar>& time_vec,
+    Array<RCP<const Thyra::VectorBase<Scalar> > >* x_vec,
+    Array<RCP<const Thyra::VectorBase<Scalar> > >* xdot_vec,
+    Array<ScalarMag>* accuracy_vec
+    ) const;
+
+  /** \brief The times of the forward steps. */
+  void getNodes(Array<Scalar>* time_vec) const;
+
+  /** \brief Throws, the forward steps can not be removed. */
+  void removeNodes(Array<Scalar>& time_vec);
+
+  /** \brief . */
+  int getOrder() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::ParameterListAcceptor */
+  //@{
+
+  /** \brief . */
+  void setParameterList(RCP<ParameterList> const& paramList);
+
+  /** \brief . */
+  RCP<const ParameterList> getValidParameters() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::Describable */
+  //@{
+
+  /** \brief . */
+  std::string description() const;
+
+  //@}
+
+private:
+
+  struct Checkpoint {
+    Checkpoint() : step(-1) {}
+    Checkpoint(const int step_in, const RCP<const MomentoBase<Scalar> > &momento_in)
+      : step(step_in), momento(momento_in) {}
+    int step;
+    RCP<const MomentoBase<Scalar> > momento;
+  };
+
+  RCP<BackwardEulerStepper<Scalar> > fwdStepper_;
+  RCP<Thyra::ModelEvaluator<Scalar> > fwdModel_;
+  RCP<Thyra::NonlinearSolverBase<Scalar> > fwdSolver_;
+  int numCheckpoints_;
+  int numDiskCheckpoints_;
+  std::string diskDirectory_;
+  double diskAccessCost_;
+
+  // Times t(0),...,t(N) of the forward steps, the step size, and the
+  // checkpoints ordered by step.  Step i covers [t(i),t(i+1)] and the
+  // checkpoint of step i holds the state at t(i).
+  mutable Array<Scalar> stepTimes_;
+  Scalar dt_;
+  mutable Array<Checkpoint> checkpoints_;
+
+  // The step the stepper can interpolate in, or -1.
+  mutable int currentStep_;
+
+  // Disk checkpoint k holds the state at t(k*diskInterval_).  They are read
+  // into clones of diskPrototype_, which has the parts of the momento that
+  // are not written.
+  int diskInterval_;
+  Array<std::string> diskFiles_;
+  RCP<const MomentoBase<Scalar> > diskPrototype_;
+  BinaryStateSerializerStrategy<Scalar> serializer_;
+
+  // The disk checkpoint being read ahead of time, or -1.
+  mutable int prefetchIndex_;
+  mutable RCP<MomentoBase<Scalar> > prefetchMomento_;
+#ifdef HAVE_RYTHMOS_THREADS
+  mutable std::thread prefetchThread_;
+  mutable std::exception_ptr prefetchException_;
+#endif
+
+  mutable int numStepsTaken_;
+  double forwardWallTime_;
+  mutable double recomputationWallTime_;
+  mutable int numDiskReads_;
+  mutable double diskWallTime_;
+
+  static const std::string numCheckpoints_name_;
+  static const int numCheckpoints_default_;
+
+  static const std::string numDiskCheckpoints_name_;
+  static const int numDiskCheckpoints_default_;
+
+  static const std::string diskDirectory_name_;
+  static const std::string diskDirectory_default_;
+
+  static const std::string diskAccessCost_name_;
+  static const double diskAccessCost_default_;
+
+  void assertForwardIntegrated() const;
+
+  int findStep(const Scalar &t) const;
+
+  void moveToStep(const int step) const;
+
+  void runSchedule(int step, const int endStep) const;
+
+  void advance(const int step, const int endStep) const;
+
+  void storeCheckpoint(const int step) const;
+
+  void writeDiskCheckpoint(const int index);
+
+  void readDiskCheckpoint(const int index, MomentoBase<Scalar> &momento) const;
+
+  RCP<const MomentoBase<Scalar> > loadDiskCheckpoint(const int index) const;
+
+  void startPrefetch(const int index) const;
+
+  void finishPrefetch() const;
+
+  void removeDiskCheckpoints();
+
+};
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates CheckpointedAdjointDriver
+ */
+template<class Scalar>
+RCP<CheckpointedAdjointDriver<Scalar> >
+checkpointedAdjointDriver(
+  const RCP<BackwardEulerStepper<Scalar> > &fwdStepper,
+  const RCP<ParameterList> &paramList = Teuchos::null
+  )
+{
+  RCP<CheckpointedAdjointDriver<Scalar> >
+    driver = Teuchos::rcp(new CheckpointedAdjointDriver<Scalar>);
+  if (!is_null(paramList))
+    driver->setParameterList(paramList);
+  driver->initialize(fwdStepper);
+  return driver;
+}
+
+
+//
+// Implementation
+//
+
+
+// Static members
+
+
+template<class Scalar>
+const std::string CheckpointedAdjointDriver<Scalar>::numCheckpoints_name_
+= "Number of Checkpoints";
+
+template<class Scalar>
+const int CheckpointedAdjointDriver<Scalar>::numCheckpoints_default_
+= 10;
+
+template<class Scalar>
+const std::string CheckpointedAdjointDriver<Scalar>::numDiskCheckpoints_name_
+= "Number of Disk Checkpoints";
+
+template<class Scalar>
+const int CheckpointedAdjointDriver<Scalar>::numDiskCheckpoints_default_
+= 0;
+
+template<class Scalar>
+const std::string CheckpointedAdjointDriver<Scalar>::diskDirectory_name_
+= "Disk Checkpoint Directory";
+
+template<class Scalar>
+const std::string CheckpointedAdjointDriver<Scalar>::diskDirectory_default_
+= ".";
+
+template<class Scalar>
+const std::string CheckpointedAdjointDriver<Scalar>::diskAccessCost_name_
+= "Disk Access Cost";
+
+template<class Scalar>
+const double CheckpointedAdjointDriver<Scalar>::diskAccessCost_default_
+= 1.0;
+
+
+// Constructors/Initializers/Accessors
+
+
+template<class Scalar>
+CheckpointedAdjointDriver<Scalar>::CheckpointedAdjointDriver()
+  :numCheckpoints_(numCheckpoints_default_),
+   numDiskCheckpoints_(numDiskCheckpoints_default_),
+   diskDirectory_(diskDirectory_default_),
+   diskAccessCost_(diskAccessCost_default_),
+   dt_(ScalarTraits<Scalar>::zero()),
+   currentStep_(-1),
+   diskInterval_(0),
+   prefetchIndex_(-1),
+   numStepsTaken_(0),
+   forwardWallTime_(0.0),
+   recomputationWallTime_(0.0),
+   numDiskReads_(0),
+   diskWallTime_(0.0)
+{}
+
+
+template<class Scalar>
+CheckpointedAdjointDriver<Scalar>::~CheckpointedAdjointDriver()
+{
+  // Never let an exception from a failed read escape the destructor.
+  try {
+    finishPrefetch();
+  }
+  catch (...) {}
+  removeDiskCheckpoints();
+}
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::initialize(
+  const RCP<BackwardEulerStepper<Scalar> > &fwdStepper
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(fwdStepper));
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(fwdStepper->getModel()) || is_null(fwdStepper->getNonconstSolver()),
+    std::logic_error,
+    "Error, the forward stepper needs a model and a nonlinear solver!"
+    );
+  fwdStepper_ = fwdStepper;
+  // BackwardEulerStepper only keeps a const model, setMomento() just needs
+  // the same one back.
+  fwdModel_ = Teuchos::rcp_const_cast<Thyra::ModelEvaluator<Scalar> >(
+    fwdStepper->getModel());
+  fwdSolver_ = fwdStepper->getNonconstSolver();
+  finishPrefetch();
+  removeDiskCheckpoints();
+  diskPrototype_ = Teuchos::null;
+  stepTimes_.clear();
+  checkpoints_.clear();
+  currentStep_ = -1;
+  numStepsTaken_ = 0;
+  forwardWallTime_ = 0.0;
+  recomputationWallTime_ = 0.0;
+  numDiskReads_ = 0;
+  diskWallTime_ = 0.0;
+}
+
+
+template<class Scalar>
+RCP<const BackwardEulerStepper<Scalar> >
+CheckpointedAdjointDriver<Scalar>::getFwdStepper() const
+{
+  return fwdStepper_;
+}
+
+
+template<class Scalar>
+RCP<const Thyra::VectorBase<Scalar> >
+CheckpointedAdjointDriver<Scalar>::integrateForward(
+  const Scalar &finalTime, const int numSteps
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(fwdStepper_), std::logic_error,
+    "Error, initialize() must be called first!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    numSteps < 1, std::logic_error,
+    "Error, numSteps = " << numSteps << " must be positive!"
+    );
+  const Scalar t0 = fwdStepper_->getTimeRange().upper();
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !(finalTime > t0), std::logic_error,
+    "Error, finalTime = " << finalTime << " must be after the current time "
+    << t0 << " of the forward stepper!"
+    );
+
+  const double startTime = Teuchos::Time::wallTime();
+
+  finishPrefetch();
+  removeDiskCheckpoints();
+  stepTimes_.clear();
+  stepTimes_.push_back(t0);
+  dt_ = (finalTime-t0)/numSteps;
+  checkpoints_.clear();
+  numStepsTaken_ = 0;
+  recomputationWallTime_ = 0.0;
+  numDiskReads_ = 0;
+  diskWallTime_ = 0.0;
+
+  // Write a disk checkpoint at the start of each interval but the last, and
+  // store the checkpoints in memory only in the last interval, which is
+  // reversed first.
+  diskInterval_ = binomialDiskCheckpointInterval(
+    numSteps, numCheckpoints_, numDiskCheckpoints_, diskAccessCost_);
+  diskPrototype_ = Teuchos::null;
+  if (diskInterval_ < numSteps)
+    diskPrototype_ = fwdStepper_->getMomento();
+  int step = 0;
+  for ( ; numSteps - step > diskInterval_; step += diskInterval_) {
+    writeDiskCheckpoint(step/diskInterval_);
+    advance(step,step+diskInterval_);
+  }
+  storeCheckpoint(step);
+  runSchedule(step,numSteps);
+  startPrefetch(getNumDiskCheckpoints()-1);
+
+  forwardWallTime_ = Teuchos::Time::wallTime() - startTime;
+  return fwdStepper_->getStepStatus().solution->clone_v();
+}
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::integrateAdjoint(
+  const Ptr<StepperBase<Scalar> > &adjointStepper
+  )
+{
+  assertForwardIntegrated();
+  for (int i = getNumForwardSteps()-1; i >= 0; --i) {
+    const Scalar dt = stepTimes_[i+1] - stepTimes_[i];
+    const Scalar dt_taken = adjointStepper->takeStep(dt,STEP_TYPE_FIXED);
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      dt_taken != dt, std::runtime_error,
+      "Error, the adjoint stepper failed to take the step of size " << dt
+      << " over the forward step [" << stepTimes_[i] << ","
+      << stepTimes_[i+1] << "]!"
+      );
+  }
+}
+
+
+template<class Scalar>
+int CheckpointedAdjointDriver<Scalar>::getNumForwardSteps() const
+{
+  return stepTimes_.size() > 0 ? Teuchos::as<int>(stepTimes_.size())-1 : 0;
+}
+
+
+template<class Scalar>
+int CheckpointedAdjointDriver<Scalar>::getNumRecomputedSteps() const
+{
+  return numStepsTaken_ - getNumForwardSteps();
+}
+
+
+template<class Scalar>
+double CheckpointedAdjointDriver<Scalar>::getRecomputationRatio() const
+{
+  const int numSteps = getNumForwardSteps();
+  return numSteps > 0 ? double(getNumRecomputedSteps())/numSteps : 0.0;
+}
+
+
+template<class Scalar>
+int CheckpointedAdjointDriver<Scalar>::getNumCheckpoints() const
+{
+  return checkpoints_.size();
+}
+
+
+template<class Scalar>
+double CheckpointedAdjointDriver<Scalar>::getForwardWallTime() const
+{
+  return forwardWallTime_;
+}
+
+
+template<class Scalar>
+double CheckpointedAdjointDriver<Scalar>::getRecomputationWallTime() const
+{
+  return recomputationWallTime_;
+}
+
+
+template<class Scalar>
+int CheckpointedAdjointDriver<Scalar>::getDiskCheckpointInterval() const
+{
+  return diskInterval_;
+}
+
+
+template<class Scalar>
+int CheckpointedAdjointDriver<Scalar>::getNumDiskCheckpoints() const
+{
+  return diskFiles_.size();
+}
+
+
+template<class Scalar>
+int CheckpointedAdjointDriver<Scalar>::getNumDiskReads() const
+{
+  return numDiskReads_;
+}
+
+
+template<class Scalar>
+double CheckpointedAdjointDriver<Scalar>::getDiskWallTime() const
+{
+  return diskWallTime_;
+}
+
+
+// Overridden from InterpolationBufferBase
+
+
+template<class Scalar>
+RCP<const Thyra::VectorSpaceBase<Scalar> >
+CheckpointedAdjointDriver<Scalar>::get_x_space() const
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(fwdStepper_));
+  return fwdStepper_->get_x_space();
+}
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::addPoints(
+  const Array<Scalar>& time_vec,
+  const Array<RCP<const Thyra::VectorBase<Scalar> > >& x_vec,
+  const Array<RCP<const Thyra::VectorBase<Scalar> > >& xdot_vec
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(true, std::logic_error,
+    "Error, addPoints() is not supported by CheckpointedAdjointDriver!"
+    );
+}
+
+
+template<class Scalar>
+TimeRange<Scalar> CheckpointedAdjointDriver<Scalar>::getTimeRange() const
+{
+  if (stepTimes_.size() < 2)
+    return invalidTimeRange<Scalar>();
+  return timeRange(stepTimes_.front(),stepTimes_.back());
+}
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::getPoints(
+  const Array<Scalar>& time_vec,
+  Array<RCP<const Thyra::VectorBase<Scalar> > >* x_vec,
+  Array<RCP<const Thyra::VectorBase<Scalar> > >* xdot_vec,
+  Array<ScalarMag>* accuracy_vec
+  ) const
+{
+  assertForwardIntegrated();
+  if (x_vec)
+    x_vec->clear();
+  if (xdot_vec)
+    xdot_vec->clear();
+  if (accuracy_vec)
+    accuracy_vec->clear();
+  const TimeRange<Scalar> range = getTimeRange();
+  Array<Scalar> time(1);
+  Array<RCP<const Thyra::VectorBase<Scalar> > > x, xdot;
+  Array<ScalarMag> accuracy;
+  for (int i = 0; i < Teuchos::as<int>(time_vec.size()); ++i) {
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      !range.isInRange(time_vec[i]), std::out_of_range,
+      "Error, time_vec[" << i << "] = " << time_vec[i] << " is not in the"
+      " range " << range << " of the forward integration!"
+      );
+    moveToStep(findStep(time_vec[i]));
+    time[0] = time_vec[i];
+    fwdStepper_->getPoints(time, x_vec ? &x : 0, xdot_vec ? &xdot : 0,
+      accuracy_vec ? &accuracy : 0);
+    if (x_vec)
+      x_vec->push_back(x[0]);
+    if (xdot_vec)
+      xdot_vec->push_back(xdot[0]);
+    if (accuracy_vec)
+      accuracy_vec->push_back(accuracy[0]);
+  }
+}
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::getNodes(Array<Scalar>* time_vec) const
+{
+  TEUCHOS_TEST_FOR_EXCEPT(0 == time_vec);
+  *time_vec = stepTimes_;
+}
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::removeNodes(Array<Scalar>& time_vec)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(true, std::logic_error,
+    "Error, removeNodes() is not supported by CheckpointedAdjointDriver!"
+    );
+}
+
+
+template<class Scalar>
+int CheckpointedAdjointDriver<Scalar>::getOrder() const
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(fwdStepper_));
+  return fwdStepper_->getOrder();
+}
+
+
+// Overridden from Teuchos::ParameterListAcceptor
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::setParameterList(
+  RCP<ParameterList> const& paramList
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(paramList));
+  paramList->validateParameters(*getValidParameters());
+  this->setMyParamList(paramList);
+  const int numCheckpoints = paramList->get(
+    numCheckpoints_name_, numCheckpoints_default_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    numCheckpoints < 1, std::logic_error,
+    "Error, \"" << numCheckpoints_name_ << "\" = " << numCheckpoints
+    << " must be at least one!"
+    );
+  numCheckpoints_ = numCheckpoints;
+  const int numDiskCheckpoints = paramList->get(
+    numDiskCheckpoints_name_, numDiskCheckpoints_default_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    numDiskCheckpoints < 0, std::logic_error,
+    "Error, \"" << numDiskCheckpoints_name_ << "\" = " << numDiskCheckpoints
+    << " can not be negative!"
+    );
+  numDiskCheckpoints_ = numDiskCheckpoints;
+  diskDirectory_ = paramList->get(diskDirectory_name_, diskDirectory_default_);
+  const double diskAccessCost = paramList->get(
+    diskAccessCost_name_, diskAccessCost_default_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    diskAccessCost < 0.0, std::logic_error,
+    "Error, \"" << diskAccessCost_name_ << "\" = " << diskAccessCost
+    << " can not be negative!"
+    );
+  diskAccessCost_ = diskAccessCost;
+  Teuchos::readVerboseObjectSublist(&*paramList,this);
+}
+
+
+template<class Scalar>
+RCP<const ParameterList>
+CheckpointedAdjointDriver<Scalar>::getValidParameters() const
+{
+  static RCP<const ParameterList> validPL;
+  if (is_null(validPL)) {
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set( numCheckpoints_name_, numCheckpoints_default_,
+      "Largest number of forward stepper states kept in memory, including\n"
+      "the initial state.  Fewer checkpoints use less memory but recompute\n"
+      "more forward steps during the adjoint integration."
+      );
+    pl->set( numDiskCheckpoints_name_, numDiskCheckpoints_default_,
+      "Largest number of forward stepper states written to disk.  Zero\n"
+      "keeps all checkpoints in memory."
+      );
+    pl->set( diskDirectory_name_, diskDirectory_default_,
+      "Directory of the disk checkpoint files, preferably on a local disk.\n"
+      "The files are removed when they are no longer needed."
+      );
+    pl->set( diskAccessCost_name_, diskAccessCost_default_,
+      "Time to write or read one disk checkpoint, measured in forward\n"
+      "steps.  The higher it is, the fewer disk checkpoints are used."
+      );
+    Teuchos::setupVerboseObjectSublist(&*pl);
+    validPL = pl;
+  }
+  return validPL;
+}
+
+
+// Overridden from Teuchos::Describable
+
+
+template<class Scalar>
+std::string CheckpointedAdjointDriver<Scalar>::description() const
+{
+  std::ostringstream oss;
+  oss << "Rythmos::CheckpointedAdjointDriver{"
+      << "numCheckpoints=" << numCheckpoints_
+      << ",numForwardSteps=" << getNumForwardSteps()
+      << ",numRecomputedSteps=" << getNumRecomputedSteps()
+      << ",numDiskCheckpoints=" << getNumDiskCheckpoints()
+      << "}";
+  return oss.str();
+}
+
+
+// private
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::assertForwardIntegrated() const
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    stepTimes_.size() < 2, std::logic_error,
+    "Error, integrateForward() must be called first!"
+    );
+}
+
+
+template<class Scalar>
+int CheckpointedAdjointDriver<Scalar>::findStep(const Scalar &t) const
+{
+  // Stay in the current step if it has t, otherwise take the step ending at
+  // t, which comes next when going backward.
+  if (currentStep_ >= 0
+    && timeRange(stepTimes_[currentStep_],stepTimes_[currentStep_+1]).isInRange(t))
+  {
+    return currentStep_;
+  }
+  const int j = std::lower_bound(stepTimes_.begin(), stepTimes_.end(), t)
+    - stepTimes_.begin();
+  return std::min(std::max(j-1,0), getNumForwardSteps()-1);
+}
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::moveToStep(const int step) const
+{
+  if (step == currentStep_)
+    return;
+  const double startTime = Teuchos::Time::wallTime();
+  // Checkpoints after the step are not needed again going backward.  When
+  // the step is before all of them, start over from the disk checkpoint of
+  // its interval.
+  while (checkpoints_.size() > 0 && checkpoints_.back().step > step)
+    checkpoints_.pop_back();
+  if (checkpoints_.size() == 0) {
+    const int index = step/diskInterval_;
+    checkpoints_.push_back(
+      Checkpoint(index*diskInterval_, loadDiskCheckpoint(index)));
+  }
+  const int checkpointStep = checkpoints_.back().step;
+  // setMomento() takes over the vectors of the momento, so restore from a
+  // copy to keep the checkpoint intact.
+  RCP<MomentoBase<Scalar> > momento = checkpoints_.back().momento->clone();
+  fwdStepper_->setMomento(momento.getConst().ptr(), fwdModel_, fwdSolver_);
+  currentStep_ = -1;
+  runSchedule(checkpointStep,step+1);
+  recomputationWallTime_ += Teuchos::Time::wallTime() - startTime;
+}
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::runSchedule(
+  int step, const int endStep
+  ) const
+{
+  // The stepper is at the last checkpoint, t(step).  Store checkpoints on
+  // the way to t(endStep) while there are free ones.
+  while (
+    endStep - step > 1
+    && Teuchos::as<int>(checkpoints_.size()) < numCheckpoints_
+    )
+  {
+    const int numFree = numCheckpoints_ - Teuchos::as<int>(checkpoints_.size());
+    const int m = binomialCheckpointAdvance(endStep-step,numFree);
+    advance(step,step+m);
+    step += m;
+    storeCheckpoint(step);
+  }
+  advance(step,endStep);
+  currentStep_ = endStep-1;
+}
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::advance(
+  const int step, const int endStep
+  ) const
+{
+  for (int i = step; i < endStep; ++i) {
+    const Scalar dt_taken = fwdStepper_->takeStep(dt_,STEP_TYPE_FIXED);
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      dt_taken != dt_, std::runtime_error,
+      "Error, the forward stepper failed to take step " << i << " of size "
+      << dt_ << " from t = " << stepTimes_[i] << "!"
+      );
+    ++numStepsTaken_;
+    // Record the times in the first forward integration.  The recomputed
+    // steps end at the same times as they take the same step sizes.
+    if (i+1 == Teuchos::as<int>(stepTimes_.size()))
+      stepTimes_.push_back(fwdStepper_->getTimeRange().upper());
+  }
+}
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::storeCheckpoint(const int step) const
+{
+  checkpoints_.push_back(Checkpoint(step,fwdStepper_->getMomento()));
+}
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::writeDiskCheckpoint(const int index)
+{
+  const double startTime = Teuchos::Time::wallTime();
+  std::ostringstream fileName;
+  fileName << diskDirectory_ << "/rythmos_checkpoint_"
+           << Teuchos::GlobalMPISession::getRank() << "_" << getpid() << "_"
+           << this << "_" << index << ".bin";
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    std::ifstream(fileName.str().c_str()).is_open(), std::runtime_error,
+    "Error, the checkpoint file \"" << fileName.str() << "\" already exists!"
+    );
+  diskFiles_.push_back(fileName.str());
+  std::ofstream file(fileName.str().c_str(), std::ios::binary);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !file, std::runtime_error,
+    "Error, can not open the checkpoint file \"" << fileName.str() << "\"!"
+    );
+  fwdStepper_->getMomento()->serialize(serializer_,file);
+  file.close();
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !file, std::runtime_error,
+    "Error, can not write the checkpoint file \"" << fileName.str() << "\"!"
+    );
+  diskWallTime_ += Teuchos::Time::wallTime() - startTime;
+}
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::readDiskCheckpoint(
+  const int index, MomentoBase<Scalar> &momento
+  ) const
+{
+  // This may run on the helper thread, so it only touches the momento and
+  // the file.
+  std::ifstream file(diskFiles_[index].c_str(), std::ios::binary);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !file, std::runtime_error,
+    "Error, can not open the checkpoint file \"" << diskFiles_[index] << "\"!"
+    );
+  momento.deSerialize(serializer_,file);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !file, std::runtime_error,
+    "Error, can not read the checkpoint file \"" << diskFiles_[index] << "\"!"
+    );
+}
+
+
+template<class Scalar>
+RCP<const MomentoBase<Scalar> >
+CheckpointedAdjointDriver<Scalar>::loadDiskCheckpoint(const int index) const
+{
+  TEUCHOS_TEST_FOR_EXCEPT(index >= getNumDiskCheckpoints());
+  const double startTime = Teuchos::Time::wallTime();
+  RCP<MomentoBase<Scalar> > momento;
+  if (index == prefetchIndex_) {
+    momento = prefetchMomento_;
+#ifndef HAVE_RYTHMOS_THREADS
+    readDiskCheckpoint(index,*momento);
+#endif
+  }
+  finishPrefetch();
+  if (is_null(momento)) {
+    momento = diskPrototype_->clone();
+    readDiskCheckpoint(index,*momento);
+  }
+  ++numDiskReads_;
+  diskWallTime_ += Teuchos::Time::wallTime() - startTime;
+  // Going backward, the interval before this one is needed next.
+  startPrefetch(index-1);
+  return momento;
+}
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::startPrefetch(const int index) const
+{
+  finishPrefetch();
+  if (index < 0)
+    return;
+  // Clone on the calling thread, as cloning reads the shared prototype.
+  prefetchMomento_ = diskPrototype_->clone();
+  prefetchIndex_ = index;
+#ifdef HAVE_RYTHMOS_THREADS
+  MomentoBase<Scalar> *momento = prefetchMomento_.get();
+  prefetchThread_ = std::thread(
+    [this, index, momento]{
+      try {
+        readDiskCheckpoint(index,*momento);
+      }
+      catch (...) {
+        prefetchException_ = std::current_exception();
+      }
+    });
+#endif
+}
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::finishPrefetch() const
+{
+#ifdef HAVE_RYTHMOS_THREADS
+  // Join before the momento is released, the helper thread writes into it.
+  if (prefetchThread_.joinable())
+    prefetchThread_.join();
+#endif
+  prefetchIndex_ = -1;
+  prefetchMomento_ = Teuchos::null;
+#ifdef HAVE_RYTHMOS_THREADS
+  if (prefetchException_) {
+    std::exception_ptr prefetchException = prefetchException_;
+    prefetchException_ = std::exception_ptr();
+    std::rethrow_exception(prefetchException);
+  }
+#endif
+}
+
+
+template<class Scalar>
+void CheckpointedAdjointDriver<Scalar>::removeDiskCheckpoints()
+{
+  for (int k = 0; k < Teuchos::as<int>(diskFiles_.size()); ++k)
+    std::remove(diskFiles_[k].c_str());
+  diskFiles_.clear();
+}
+
+
+} // namespace Rythmos
+
+
+#endif // RYTHMOS_CHECKPOINTED_ADJOINT_DRIVER_HPP
@@ -98,6 +98,13 @@ public:
     const int timeStepIter
     );
 
+  /** \brief . */
+  virtual void observeEvent(
+    const StepperBase<Scalar> &stepper,
+    const Scalar &eventTime,
+    const Array<int> &eventIndices
+    );
+
   //@}
 
 private:
@@ -268,6 +275,27 @@ void CompositeIntegrationObserver<Scalar>::observeFailedTimeStep(
 }
 
 
+template<class Scalar>
+void CompositeIntegrationObserver<Scalar>::observeEvent(
+  const StepperBase<Scalar> &stepper,
+  const Scalar &eventTime,
+  const Array<int> &eventIndices
+  )
+{
+  using Teuchos::as;
+
+  const RCP<FancyOStream> out = this->getOStream();
+  const Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+
+  for (int i = 0; i < as<int>(observers_.size()); ++i ) {
+    RCP<IntegrationObserverBase<Scalar> > observer = observers_[i];
+    observer->setOStream(out);
+    observer->setVerbLevel(verbLevel);
+    observer->observeEvent(stepper,eventTime,eventIndices);
+  }
+}
+
+
 } // namespace Rythmos
 
 
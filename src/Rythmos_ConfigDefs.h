@@ -76,4 +76,46 @@
 
 #include "Teuchos_ConfigDefs.hpp"
 
+/*
+ * Worker threads are only used when the Teuchos reference counts are thread
+ * safe and the Pthread TPL is there to link against.
+ */
+#if defined(HAVE_TEUCHOS_THREAD_SAFE) && defined(Rythmos_ENABLE_Pthread)
+#define HAVE_RYTHMOS_THREADS
+#endif
+
+#ifdef HAVE_RYTHMOS_THREADS
+
+namespace Rythmos {
+
+/*
+ * Set on the worker threads of Rythmos::ThreadPool.  The timers of
+ * RYTHMOS_FUNC_TIME_MONITOR are function statics and Teuchos timers are not
+ * thread safe, so only the calling thread of a threaded algorithm is timed.
+ */
+inline bool& timeMonitorSuppressedOnThisThread()
+{
+  static thread_local bool suppressed = false;
+  return suppressed;
+}
+
+} // namespace Rythmos
+
+#ifdef RYTHMOS_TEUCHOS_TIME_MONITOR
+#undef RYTHMOS_FUNC_TIME_MONITOR
+#undef RYTHMOS_FUNC_TIME_MONITOR_DIFF
+#define RYTHMOS_FUNC_TIME_MONITOR(FUNCNAME) \
+  RYTHMOS_FUNC_TIME_MONITOR_DIFF(FUNCNAME, RYTHMOS)
+#define RYTHMOS_FUNC_TIME_MONITOR_DIFF(FUNCNAME, DIFF) \
+  Teuchos::RCP<Teuchos::TimeMonitor> DIFF ## _localTimeMonitor; \
+  if (!Rythmos::timeMonitorSuppressedOnThisThread()) { \
+    static const Teuchos::RCP<Teuchos::Time> DIFF ## _localTimer = \
+      Teuchos::TimeMonitor::getNewCounter(FUNCNAME); \
+    DIFF ## _localTimeMonitor = \
+      Teuchos::rcp(new Teuchos::TimeMonitor(*DIFF ## _localTimer)); \
+  }
+#endif
+
+#endif
+
 #endif /* RYTHMOS_CONFIGDEFS_H */
@@ -0,0 +1,5 @@
+#include "Rythmos_DefaultBreakPointInformer_decl.hpp"
+#ifndef HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
+#include "Rythmos_DefaultBreakPointInformer_def.hpp"
+#endif
+
@@ -0,0 +1,156 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_DEFAULT_BREAK_POINT_INFORMER_DECL_H
+#define Rythmos_DEFAULT_BREAK_POINT_INFORMER_DECL_H
+
+#include "Rythmos_BreakPointInformerBase.hpp"
+#include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
+
+#include <map>
+
+
+namespace Rythmos {
+
+
+/** \brief Breakpoint informer holding a sorted list of hard and soft
+ * breakpoints.
+ *
+ * Hand this to <tt>DefaultIntegrator::setBreakPointInformer()</tt> to make
+ * the integrator cut every trial step that would step over a breakpoint so
+ * that it lands on it.  At a hard breakpoint the stepper is restarted from
+ * the solution at the breakpoint before the next step, which drops the
+ * history of multistep methods (e.g. the BDF order goes back to one).  Use
+ * hard breakpoints for discontinuities of the forcing (switching inputs,
+ * piecewise data) and soft ones for times that should only be hit exactly.
+ *
+ * Breakpoints are compared with <tt>compareTimeValues()</tt>, so a step that
+ * ends within round-off of a breakpoint counts as having reached it.  The
+ * breakpoints are not consumed by the integrator, so the same informer can
+ * be used again for another integration.
+ *
+ * <tt>setParameterList()</tt> replaces all breakpoints, including the ones
+ * added with <tt>addBreakPoint()</tt>, with the ones in the list.
+ */
+template<class Scalar>
+class DefaultBreakPointInformer
+  : virtual public BreakPointInformerBase<Scalar>,
+    virtual public Teuchos::ParameterListAcceptorDefaultBase
+{
+public:
+
+  /** \name Constructors/Initializers/Accessors */
+  //@{
+
+  /** \brief . */
+  DefaultBreakPointInformer();
+
+  /** \brief Add a breakpoint.
+   *
+   * Adding a hard breakpoint at the time of a soft one makes it hard.
+   */
+  void addBreakPoint(
+    const Scalar& time,
+    const EBreakPointType breakPointType = BREAK_POINT_TYPE_HARD
+    );
+
+  /** \brief Remove all breakpoints. */
+  void clearBreakPoints();
+
+  /** \brief . */
+  int getNumBreakPoints() const;
+
+  //@}
+
+  /** \name Overridden from BreakPointInformerBase */
+  //@{
+
+  /** \brief Returns true if there is a breakpoint in <tt>(time0,
+   * time0+dt]</tt>. */
+  bool testForBreakPoint(Scalar& time0, Scalar& dt) const;
+
+  /** \brief Returns the first breakpoint after <tt>time0</tt>, or
+   * <tt>ScalarTraits<Scalar>::rmax()</tt> if there is none. */
+  Scalar getNextBreakPoint(Scalar& time0) const;
+
+  /** \brief . */
+  void removeNextBreakPoint(Scalar& time0);
+
+  /** \brief . */
+  EBreakPointType getNextBreakPointType(Scalar& time0) const;
+
+  //@}
+
+  /** \name Overridden from ParameterListAcceptor */
+  //@{
+
+  /** \brief Adds the breakpoints in "Hard Break Points" and "Soft Break
+   * Points". */
+  void setParameterList(RCP<ParameterList> const& paramList);
+
+  /** \brief . */
+  RCP<const ParameterList> getValidParameters() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::Describable */
+  //@{
+
+  /** \brief . */
+  std::string description() const;
+
+  //@}
+
+private:
+
+  typedef std::map<Scalar,EBreakPointType> BreakPointMap;
+
+  BreakPointMap breakPoints_;
+
+  static const std::string hardBreakPoints_name_;
+  static const std::string softBreakPoints_name_;
+
+  typename BreakPointMap::const_iterator nextBreakPoint_(
+    const Scalar& time0
+    ) const;
+
+};
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates DefaultBreakPointInformer
+ */
+template<class Scalar>
+RCP<DefaultBreakPointInformer<Scalar> >
+defaultBreakPointInformer();
+
+
+} // namespace Rythmos
+
+#endif //Rythmos_DEFAULT_BREAK_POINT_INFORMER_DECL_H
@@ -0,0 +1,260 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_DEFAULT_BREAK_POINT_INFORMER_DEF_H
+#define Rythmos_DEFAULT_BREAK_POINT_INFORMER_DEF_H
+
+#include "Rythmos_DefaultBreakPointInformer_decl.hpp"
+#include "Rythmos_TimeRange.hpp"
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+#include "Teuchos_as.hpp"
+
+
+namespace Rythmos {
+
+
+// Nonmember constructors
+
+
+template<class Scalar>
+RCP<DefaultBreakPointInformer<Scalar> >
+defaultBreakPointInformer()
+{
+  RCP<DefaultBreakPointInformer<Scalar> >
+    informer = Teuchos::rcp(new DefaultBreakPointInformer<Scalar>());
+  return informer;
+}
+
+
+//
+// Implementation
+//
+
+
+// Static members
+
+
+template<class Scalar>
+const std::string
+DefaultBreakPointInformer<Scalar>::hardBreakPoints_name_
+= "Hard Break Points";
+
+template<class Scalar>
+const std::string
+DefaultBreakPointInformer<Scalar>::softBreakPoints_name_
+= "Soft Break Points";
+
+
+// Constructors/Initializers/Accessors
+
+
+template<class Scalar>
+DefaultBreakPointInformer<Scalar>::DefaultBreakPointInformer()
+{}
+
+
+template<class Scalar>
+void DefaultBreakPointInformer<Scalar>::addBreakPoint(
+  const Scalar& time,
+  const EBreakPointType breakPointType
+  )
+{
+  typename BreakPointMap::iterator itr = breakPoints_.find(time);
+  if (itr == breakPoints_.end()) {
+    breakPoints_[time] = breakPointType;
+  }
+  else if (breakPointType == BREAK_POINT_TYPE_HARD) {
+    itr->second = BREAK_POINT_TYPE_HARD;
+  }
+}
+
+
+template<class Scalar>
+void DefaultBreakPointInformer<Scalar>::clearBreakPoints()
+{
+  breakPoints_.clear();
+}
+
+
+template<class Scalar>
+int DefaultBreakPointInformer<Scalar>::getNumBreakPoints() const
+{
+  return Teuchos::as<int>(breakPoints_.size());
+}
+
+
+// Overridden from BreakPointInformerBase
+
+
+template<class Scalar>
+bool DefaultBreakPointInformer<Scalar>::testForBreakPoint(
+  Scalar& time0, Scalar& dt
+  ) const
+{
+  typename BreakPointMap::const_iterator itr = nextBreakPoint_(time0);
+  if (itr == breakPoints_.end())
+    return false;
+  return ( compareTimeValues<Scalar>(itr->first,time0+dt) <= 0 );
+}
+
+
+template<class Scalar>
+Scalar DefaultBreakPointInformer<Scalar>::getNextBreakPoint(
+  Scalar& time0
+  ) const
+{
+  typename BreakPointMap::const_iterator itr = nextBreakPoint_(time0);
+  if (itr == breakPoints_.end())
+    return Teuchos::ScalarTraits<Scalar>::rmax();
+  return itr->first;
+}
+
+
+template<class Scalar>
+void DefaultBreakPointInformer<Scalar>::removeNextBreakPoint(Scalar& time0)
+{
+  typename BreakPointMap::const_iterator itr = nextBreakPoint_(time0);
+  if (itr != breakPoints_.end())
+    breakPoints_.erase(itr->first);
+}
+
+
+template<class Scalar>
+EBreakPointType DefaultBreakPointInformer<Scalar>::getNextBreakPointType(
+  Scalar& time0
+  ) const
+{
+  typename BreakPointMap::const_iterator itr = nextBreakPoint_(time0);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    itr == breakPoints_.end(), std::logic_error,
+    "Error, DefaultBreakPointInformer::getNextBreakPointType(...):  There is"
+    " no breakpoint after time0 = " << time0 << "!"
+    );
+  return itr->second;
+}
+
+
+// Overridden from ParameterListAcceptor
+
+
+template<class Scalar>
+void DefaultBreakPointInformer<Scalar>::setParameterList(
+  RCP<ParameterList> const& paramList
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(paramList));
+  paramList->validateParametersAndSetDefaults(*getValidParameters());
+  this->setMyParamList(paramList);
+  // The list replaces the breakpoints so setting it again does not pile
+  // them up.
+  clearBreakPoints();
+  const Array<double> hardBreakPoints =
+    paramList->get<Array<double> >(hardBreakPoints_name_);
+  for (int i = 0; i < Teuchos::as<int>(hardBreakPoints.size()); ++i) {
+    addBreakPoint(Teuchos::as<Scalar>(hardBreakPoints[i]),
+      BREAK_POINT_TYPE_HARD);
+  }
+  const Array<double> softBreakPoints =
+    paramList->get<Array<double> >(softBreakPoints_name_);
+  for (int i = 0; i < Teuchos::as<int>(softBreakPoints.size()); ++i) {
+    addBreakPoint(Teuchos::as<Scalar>(softBreakPoints[i]),
+      BREAK_POINT_TYPE_SOFT);
+  }
+  Teuchos::readVerboseObjectSublist(&*paramList,this);
+}
+
+
+template<class Scalar>
+RCP<const ParameterList>
+DefaultBreakPointInformer<Scalar>::getValidParameters() const
+{
+  static RCP<const ParameterList> validPL;
+  if (is_null(validPL)) {
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set(
+      hardBreakPoints_name_, Array<double>(),
+      "Times of discontinuities.  The integrator lands on them and restarts\n"
+      "the stepper."
+      );
+    pl->set(
+      softBreakPoints_name_, Array<double>(),
+      "Times the integrator lands on without restarting the stepper."
+      );
+    Teuchos::setupVerboseObjectSublist(&*pl);
+    validPL = pl;
+  }
+  return validPL;
+}
+
+
+// Overridden from Teuchos::Describable
+
+
+template<class Scalar>
+std::string DefaultBreakPointInformer<Scalar>::description() const
+{
+  return "Rythmos::DefaultBreakPointInformer";
+}
+
+
+// private
+
+
+template<class Scalar>
+typename DefaultBreakPointInformer<Scalar>::BreakPointMap::const_iterator
+DefaultBreakPointInformer<Scalar>::nextBreakPoint_(const Scalar& time0) const
+{
+  // Skip the breakpoints that are at time0 up to round-off.
+  typename BreakPointMap::const_iterator itr = breakPoints_.upper_bound(time0);
+  while (itr != breakPoints_.end()
+    && compareTimeValues<Scalar>(itr->first,time0) == 0)
+  {
+    ++itr;
+  }
+  return itr;
+}
+
+
+//
+// Explicit Instantiation macro
+//
+// Must be expanded from within the Rythmos namespace!
+//
+
+#define RYTHMOS_DEFAULT_BREAK_POINT_INFORMER_INSTANT(SCALAR) \
+  \
+  template class DefaultBreakPointInformer< SCALAR >; \
+  \
+  template RCP< DefaultBreakPointInformer< SCALAR > > \
+  defaultBreakPointInformer(); \
+
+
+} // namespace Rythmos
+
+
+#endif //Rythmos_DEFAULT_BREAK_POINT_INFORMER_DEF_H
@@ -34,7 +34,9 @@
 #include "Rythmos_InterpolationBufferAppenderAcceptingIntegratorBase.hpp"
 #include "Rythmos_TrailingInterpolationBufferAcceptingIntegratorBase.hpp"
 #include "Rythmos_IntegrationObserverBase.hpp"
+#include "Rythmos_BreakPointInformerBase.hpp"
 #include "Rythmos_StepControlInfo.hpp"
+#include "Rythmos_StepTrace.hpp"
 #include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
 
 
@@ -43,6 +45,34 @@
 namespace Rythmos {
 
 
+/** \brief Which sign changes of an event function <tt>DefaultIntegrator</tt>
+ * reports as events. */
+enum EEventDirection {
+  /** \brief Report zero crossings in either direction. */
+  EVENT_DIRECTION_BOTH,
+  /** \brief Report only crossings from negative to positive. */
+  EVENT_DIRECTION_INCREASING,
+  /** \brief Report only crossings from positive to negative. */
+  EVENT_DIRECTION_DECREASING
+};
+
+
+/** \brief . */
+inline
+const char* toString(const EEventDirection eventDirection)
+{
+  switch(eventDirection) {
+    case EVENT_DIRECTION_BOTH: return "Both";
+    case EVENT_DIRECTION_INCREASING: return "Increasing";
+    case EVENT_DIRECTION_DECREASING: return "Decreasing";
+#ifdef HAVE_RYTHMOS_DEBUG
+    default: TEUCHOS_TEST_FOR_EXCEPT(true);
+#endif
+  }
+  return ""; // Never be called!
+}
+
+
 /** \brief A concrete subclass for <tt>IntegratorBase</tt> that allows a good
  * deal of customization.
  */
@@ -69,6 +99,190 @@ public:
     const RCP<IntegrationObserverBase<Scalar> > &integrationObserver
     );
 
+  /** \name Stiffness switching */
+  //@{
+
+  /** \brief Set a stepper to switch to when the stiffness of the problem
+   * changes.
+   *
+   * One of <tt>alternateStepper</tt> and the stepper passed to
+   * <tt>setStepper()</tt> must be explicit and the other implicit, and the
+   * model of the explicit stepper must give <tt>f(x,t)</tt>.  After every
+   * "Check Interval" steps the integrator estimates the spectral radius
+   * <tt>rho</tt> of <tt>df/dx</tt> at the current solution with a power
+   * iteration on finite differences of <tt>f</tt>, started from the last
+   * change of the solution.  If <tt>h*rho</tt> of the explicit stepper exceeds
+   * "Stiff Threshold", or <tt>h*rho</tt> of the implicit stepper falls below
+   * "Nonstiff Threshold", for "Consecutive Detections" checks in a row, the
+   * current solution is handed to the other stepper through
+   * <tt>setInitialCondition()</tt> before the next step and integration
+   * continues with that stepper.  A null <tt>alternateStepper</tt> turns
+   * switching off.
+   */
+  void setStiffnessSwitchingStepper(
+    const RCP<StepperBase<Scalar> > &alternateStepper
+    );
+
+  /** \brief The stepper that is not currently used for integration. */
+  RCP<const StepperBase<Scalar> > getStiffnessSwitchingStepper() const;
+
+  /** \brief Number of switches since the last call to <tt>setStepper()</tt>.
+   */
+  int getNumStiffnessSwitches() const;
+
+  /** \brief The last estimate of <tt>h*rho</tt>, or -1 if none was made yet.
+   */
+  ScalarMag getStiffnessEstimate() const;
+
+  //@}
+
+  /** \name Step tracing */
+  //@{
+
+  /** \brief Set the ring buffer that trial, accepted and failed steps are
+   * recorded in.
+   *
+   * Nothing is recorded unless Rythmos is configured with
+   * <tt>Rythmos_ENABLE_STEP_TRACE=ON</tt>.  A null <tt>stepTrace</tt> turns
+   * recording off.
+   */
+  void setStepTrace(const RCP<StepTraceRing> &stepTrace);
+
+  /** \brief . */
+  RCP<StepTraceRing> getStepTrace() const;
+
+  //@}
+
+  /** \name Breakpoints */
+  //@{
+
+  /** \brief Set the object that gives the breakpoints of the integration.
+   *
+   * Before each trial step the integrator asks <tt>breakPointInformer</tt>
+   * for the next breakpoint after the current time.  If the trial step
+   * would reach or step over it, the step is cut to end on the breakpoint
+   * and, for a hard breakpoint, the stepper is restarted there before the
+   * next step (see <tt>restart()</tt>).  This keeps the stepper from
+   * stepping across a discontinuity and having the step rejected.  A null
+   * <tt>breakPointInformer</tt> turns this off.
+   */
+  void setBreakPointInformer(
+    const RCP<BreakPointInformerBase<Scalar> > &breakPointInformer
+    );
+
+  /** \brief . */
+  RCP<const BreakPointInformerBase<Scalar> > getBreakPointInformer() const;
+
+  /** \brief Number of trial steps cut to land on a breakpoint since the last
+   * call to <tt>setStepper()</tt>.
+   *
+   * Each of these steps would otherwise have stepped over a breakpoint, which
+   * for a discontinuity usually ends in a rejected step.
+   */
+  int getNumBreakPointCutSteps() const;
+
+  //@}
+
+  /** \name Event detection */
+  //@{
+
+  /** \brief Number of events located since the last call to
+   * <tt>setStepper()</tt>.
+   *
+   * Event detection is turned on by setting "Response Index" in the "Event
+   * Detection" sublist to a response <tt>g(j)</tt> of the stepper's model.
+   * Every component of <tt>g(j)(x,x_dot,t)</tt> is an event function.  After
+   * each accepted step the response is evaluated at the end of the step and
+   * compared with its value at the start.  For the components that changed
+   * sign the earliest zero crossing is located with an Illinois (modified
+   * regula falsi) iteration that evaluates the whole response vector at
+   * states interpolated with the stepper's <tt>getPoints()</tt>, so no extra
+   * time steps are taken and the cost per iteration does not depend on the
+   * number of event functions.  Each located event is passed to
+   * <tt>IntegrationObserverBase::observeEvent()</tt>.  If "Stop On Event" is
+   * true, <tt>getFwdPoints()</tt> returns after the first event with the
+   * requested points up to the event time filled in and the later ones left
+   * null; calling it again continues the integration past the event, first
+   * stopping at any further event inside the same step.
+   */
+  int getNumEvents() const;
+
+  /** \brief Time of the last located event. */
+  Scalar getLastEventTime() const;
+
+  /** \brief Components of the event response that changed sign at
+   * <tt>getLastEventTime()</tt>. */
+  const Array<int>& getLastEventIndices() const;
+
+  /** \brief Number of evaluations of the event response since the last call
+   * to <tt>setStepper()</tt>. */
+  int getNumEventResponseEvaluations() const;
+
+  //@}
+
+  /** \name Streaming integration */
+  //@{
+
+  /** \brief Start advancing the integration in many short chunks.
+   *
+   * This is for callers that exchange data with an external code at a fixed
+   * interval, e.g. every millisecond of simulated time in a coupled
+   * simulation, and so would otherwise call <tt>getFwdPoints()</tt> once per
+   * exchange.  <tt>IntegrationObserverBase::observeStartTimeIntegration()</tt>
+   * is called here once and
+   * <tt>IntegrationObserverBase::observeEndTimeIntegration()</tt> once in
+   * <tt>endStreaming()</tt>, so the observer sees the chunks as one
+   * integration.  Nothing is reset between the chunks: the stepper keeps its
+   * history (e.g. the order and step size of <tt>ImplicitBDFStepper</tt>),
+   * and the integration control strategy and the stepper's step control
+   * keep their state.  The only restarts are those at hard breakpoints.
+   *
+   * <tt>getFwdPoints()</tt> may still be called while streaming and then
+   * does not notify the observer of a start or end of integration.
+   * <tt>setStepper()</tt> ends the streaming integration without calling
+   * <tt>observeEndTimeIntegration()</tt>.
+   */
+  void beginStreaming();
+
+  /** \brief Advance a streaming integration to exactly time <tt>t</tt>.
+   *
+   * The last step of the chunk is cut to end on <tt>t</tt>, as with "Land On
+   * Output Times", so the caller may change the inputs of the model (e.g. its
+   * parameters) before the next chunk.  The solution and, if requested, its
+   * time derivative at <tt>t</tt> are copied into the caller's vectors, from
+   * the step status of the stepper when it is at <tt>t</tt> and from
+   * <tt>getPoints()</tt> otherwise.
+   *
+   * \param t [in] End of the chunk.  Must not be before the start of the
+   * stepper's current step or after the final time.
+   *
+   * \param x [out] If not null, the solution at <tt>t</tt>.
+   *
+   * \param x_dot [out] If not null, the time derivative at <tt>t</tt>.
+   *
+   * \returns <tt>false</tt> if the integration stopped before <tt>t</tt>
+   * because it reached "Max Number Time Steps" or, with "Stop On Event", an
+   * event.  <tt>x</tt> and <tt>x_dot</tt> are then left unchanged.
+   */
+  bool advanceChunk(
+    const Scalar &t,
+    const Ptr<Thyra::VectorBase<Scalar> > &x = Teuchos::null,
+    const Ptr<Thyra::VectorBase<Scalar> > &x_dot = Teuchos::null
+    );
+
+  /** \brief End the streaming integration started by
+   * <tt>beginStreaming()</tt>. */
+  void endStreaming();
+
+  /** \brief . */
+  bool isStreaming() const;
+
+  /** \brief Number of calls to <tt>advanceChunk()</tt> since the last call to
+   * <tt>beginStreaming()</tt>. */
+  int getNumStreamingChunks() const;
+
+  //@}
+
   /** \name Overridden from InterpolationBufferAppenderAcceptingIntegratorBase */
   //@{
 
@@ -226,15 +440,85 @@ private:
   RCP<StepperBase<Scalar> > stepper_;
   TimeRange<Scalar> integrationTimeDomain_;
   bool landOnFinalTime_;
+  bool landOnOutputTimes_;
 
   int maxNumTimeSteps_;
 
   int currTimeStepIndex_;
   StepControlInfo<Scalar> stepCtrlInfoLast_;
 
+  RCP<StepTraceRing> stepTrace_;
+
+  RCP<BreakPointInformerBase<Scalar> > breakPointInformer_;
+  int numBreakPointCutSteps_;
+  int stepTraceNonlinearIterations_;
+
+  int eventResponseIndex_;
+  EEventDirection eventDirection_;
+  bool stopOnEvent_;
+  ScalarMag eventRelTimeTol_;
+  int eventMaxIterations_;
+  RCP<Thyra::VectorBase<Scalar> > eventResponse_;
+  Scalar eventTime0_;
+  Array<Scalar> eventResponse0_;
+  Array<Scalar> eventResponse1_;
+  bool stoppedAtEvent_;
+  int numEvents_;
+  int numEventResponseEvals_;
+  Scalar lastEventTime_;
+  Array<int> lastEventIndices_;
+
+  bool streaming_;
+  int numStreamingChunks_;
+
+  RCP<StepperBase<Scalar> > alternateStepper_;
+  RCP<Thyra::VectorBase<Scalar> > lastSolution_;
+  RCP<Thyra::VectorBase<Scalar> > dominantEigenVector_;
+  // Work vectors of checkStiffness(), created on the first check.
+  RCP<Thyra::VectorBase<Scalar> > stiffnessF_;
+  RCP<Thyra::VectorBase<Scalar> > stiffnessFPert_;
+  RCP<Thyra::VectorBase<Scalar> > stiffnessXPert_;
+  bool stiffnessSwitchPending_;
+  int numStiffnessDetections_;
+  int numStiffnessSwitches_;
+  ScalarMag stiffnessEstimate_;
+
+  ScalarMag stiffThreshold_;
+  ScalarMag nonstiffThreshold_;
+  int powerIterations_;
+  int stiffnessCheckInterval_;
+  int consecutiveDetections_;
+
   static const std::string maxNumTimeSteps_name_;
   static const int maxNumTimeSteps_default_;
 
+  static const std::string landOnOutputTimes_name_;
+  static const bool landOnOutputTimes_default_;
+
+  static const std::string stiffnessSwitching_name_;
+  static const std::string stiffThreshold_name_;
+  static const double stiffThreshold_default_;
+  static const std::string nonstiffThreshold_name_;
+  static const double nonstiffThreshold_default_;
+  static const std::string powerIterations_name_;
+  static const int powerIterations_default_;
+  static const std::string stiffnessCheckInterval_name_;
+  static const int stiffnessCheckInterval_default_;
+  static const std::string consecutiveDetections_name_;
+  static const int consecutiveDetections_default_;
+
+  static const std::string eventDetection_name_;
+  static const std::string eventResponseIndex_name_;
+  static const int eventResponseIndex_default_;
+  static const std::string eventDirection_name_;
+  static const std::string eventDirection_default_;
+  static const std::string stopOnEvent_name_;
+  static const bool stopOnEvent_default_;
+  static const std::string eventRelTimeTol_name_;
+  static const double eventRelTimeTol_default_;
+  static const std::string eventMaxIterations_name_;
+  static const int eventMaxIterations_default_;
+
   // /////////////////////////
   // Private member functions
 
@@ -242,6 +526,28 @@ private:
 
   bool advanceStepperToTime( const Scalar& t );
 
+  void checkStiffness( const StepControlInfo<Scalar> &stepCtrlInfo );
+
+  void switchStepper();
+
+  int nonlinearIterationsSinceLastTrace();
+
+  bool detectEvents();
+
+  bool resumeEventSearch();
+
+  void getPointsUpToEvent(
+    const Array<Scalar>& time_vec,
+    Array<RCP<const Thyra::VectorBase<Scalar> > >* x_vec,
+    Array<RCP<const Thyra::VectorBase<Scalar> > >* xdot_vec,
+    int* nextTimePointIndex
+    );
+
+  void evalEventResponse( const Scalar& t, Array<Scalar>* g );
+
+  bool eventCrossing( const Array<Scalar>& g0, const Array<Scalar>& g1,
+    const int i ) const;
+
 };
 
 
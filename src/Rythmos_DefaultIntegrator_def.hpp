@@ -36,9 +36,13 @@
 #include "Rythmos_InterpolationBufferAppenderBase.hpp"
 #include "Rythmos_PointwiseInterpolationBufferAppender.hpp"
 #include "Rythmos_StepperHelpers.hpp"
+#include "Thyra_VectorStdOps.hpp"
+#include "Thyra_DetachedVectorView.hpp"
 #include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+#include "Teuchos_StandardParameterEntryValidators.hpp"
 #include "Teuchos_Assert.hpp"
 #include "Teuchos_as.hpp"
+#include <algorithm>
 #include <limits>
 
 namespace Rythmos {
@@ -127,6 +131,103 @@ const int
 DefaultIntegrator<Scalar>::maxNumTimeSteps_default_ =
   std::numeric_limits<int>::max();
 
+template<class Scalar>
+const std::string
+DefaultIntegrator<Scalar>::landOnOutputTimes_name_ = "Land On Output Times";
+
+template<class Scalar>
+const bool
+DefaultIntegrator<Scalar>::landOnOutputTimes_default_ = false;
+
+template<class Scalar>
+const std::string
+DefaultIntegrator<Scalar>::stiffnessSwitching_name_ = "Stiffness Switching";
+
+template<class Scalar>
+const std::string
+DefaultIntegrator<Scalar>::stiffThreshold_name_ = "Stiff Threshold";
+
+template<class Scalar>
+const double
+DefaultIntegrator<Scalar>::stiffThreshold_default_ = 1.5;
+
+template<class Scalar>
+const std::string
+DefaultIntegrator<Scalar>::nonstiffThreshold_name_ = "Nonstiff Threshold";
+
+template<class Scalar>
+const double
+DefaultIntegrator<Scalar>::nonstiffThreshold_default_ = 0.5;
+
+template<class Scalar>
+const std::string
+DefaultIntegrator<Scalar>::powerIterations_name_ = "Power Iterations";
+
+template<class Scalar>
+const int
+DefaultIntegrator<Scalar>::powerIterations_default_ = 1;
+
+template<class Scalar>
+const std::string
+DefaultIntegrator<Scalar>::stiffnessCheckInterval_name_ = "Check Interval";
+
+template<class Scalar>
+const int
+DefaultIntegrator<Scalar>::stiffnessCheckInterval_default_ = 1;
+
+template<class Scalar>
+const std::string
+DefaultIntegrator<Scalar>::consecutiveDetections_name_ =
+  "Consecutive Detections";
+
+template<class Scalar>
+const int
+DefaultIntegrator<Scalar>::consecutiveDetections_default_ = 3;
+
+template<class Scalar>
+const std::string
+DefaultIntegrator<Scalar>::eventDetection_name_ = "Event Detection";
+
+template<class Scalar>
+const std::string
+DefaultIntegrator<Scalar>::eventResponseIndex_name_ = "Response Index";
+
+template<class Scalar>
+const int
+DefaultIntegrator<Scalar>::eventResponseIndex_default_ = -1;
+
+template<class Scalar>
+const std::string
+DefaultIntegrator<Scalar>::eventDirection_name_ = "Crossing Direction";
+
+template<class Scalar>
+const std::string
+DefaultIntegrator<Scalar>::eventDirection_default_ = "Both";
+
+template<class Scalar>
+const std::string
+DefaultIntegrator<Scalar>::stopOnEvent_name_ = "Stop On Event";
+
+template<class Scalar>
+const bool
+DefaultIntegrator<Scalar>::stopOnEvent_default_ = true;
+
+template<class Scalar>
+const std::string
+DefaultIntegrator<Scalar>::eventRelTimeTol_name_ = "Relative Time Tolerance";
+
+template<class Scalar>
+const double
+DefaultIntegrator<Scalar>::eventRelTimeTol_default_ = 1.0e-10;
+
+template<class Scalar>
+const std::string
+DefaultIntegrator<Scalar>::eventMaxIterations_name_ = "Max Iterations";
+
+template<class Scalar>
+const int
+DefaultIntegrator<Scalar>::eventMaxIterations_default_ = 50;
+
 
 
 // Constructors, Initializers, Misc
@@ -135,8 +236,32 @@ DefaultIntegrator<Scalar>::maxNumTimeSteps_default_ =
 template<class Scalar>
 DefaultIntegrator<Scalar>::DefaultIntegrator()
   :landOnFinalTime_(true),
+   landOnOutputTimes_(landOnOutputTimes_default_),
    maxNumTimeSteps_(maxNumTimeSteps_default_),
-   currTimeStepIndex_(-1)
+   currTimeStepIndex_(-1),
+   numBreakPointCutSteps_(0),
+   stepTraceNonlinearIterations_(0),
+   eventResponseIndex_(eventResponseIndex_default_),
+   eventDirection_(EVENT_DIRECTION_BOTH),
+   stopOnEvent_(stopOnEvent_default_),
+   eventRelTimeTol_(eventRelTimeTol_default_),
+   eventMaxIterations_(eventMaxIterations_default_),
+   eventTime0_(ScalarTraits<Scalar>::zero()),
+   stoppedAtEvent_(false),
+   numEvents_(0),
+   numEventResponseEvals_(0),
+   lastEventTime_(ScalarTraits<Scalar>::zero()),
+   streaming_(false),
+   numStreamingChunks_(0),
+   stiffnessSwitchPending_(false),
+   numStiffnessDetections_(0),
+   numStiffnessSwitches_(0),
+   stiffnessEstimate_(-ScalarTraits<ScalarMag>::one()),
+   stiffThreshold_(stiffThreshold_default_),
+   nonstiffThreshold_(nonstiffThreshold_default_),
+   powerIterations_(powerIterations_default_),
+   stiffnessCheckInterval_(stiffnessCheckInterval_default_),
+   consecutiveDetections_(consecutiveDetections_default_)
 {}
 
 
@@ -178,6 +303,238 @@ void DefaultIntegrator<Scalar>::setIntegrationObserver(
 }
 
 
+template<class Scalar>
+void DefaultIntegrator<Scalar>::setStiffnessSwitchingStepper(
+  const RCP<StepperBase<Scalar> > &alternateStepper
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    nonnull(alternateStepper) && nonnull(stepper_) &&
+    (alternateStepper->isImplicit() == stepper_->isImplicit()),
+    std::logic_error,
+    "Error, the stiffness switching stepper must be implicit if the current "
+    "stepper is explicit and explicit if it is implicit!"
+    );
+  alternateStepper_ = alternateStepper;
+  lastSolution_ = Teuchos::null;
+  dominantEigenVector_ = Teuchos::null;
+  stiffnessF_ = Teuchos::null;
+  stiffnessFPert_ = Teuchos::null;
+  stiffnessXPert_ = Teuchos::null;
+  stiffnessSwitchPending_ = false;
+  numStiffnessDetections_ = 0;
+}
+
+
+template<class Scalar>
+RCP<const StepperBase<Scalar> >
+DefaultIntegrator<Scalar>::getStiffnessSwitchingStepper() const
+{
+  return alternateStepper_;
+}
+
+
+template<class Scalar>
+int DefaultIntegrator<Scalar>::getNumStiffnessSwitches() const
+{
+  return numStiffnessSwitches_;
+}
+
+
+template<class Scalar>
+typename DefaultIntegrator<Scalar>::ScalarMag
+DefaultIntegrator<Scalar>::getStiffnessEstimate() const
+{
+  return stiffnessEstimate_;
+}
+
+
+template<class Scalar>
+void DefaultIntegrator<Scalar>::setStepTrace(
+  const RCP<StepTraceRing> &stepTrace
+  )
+{
+  stepTrace_ = stepTrace;
+}
+
+
+template<class Scalar>
+RCP<StepTraceRing> DefaultIntegrator<Scalar>::getStepTrace() const
+{
+  return stepTrace_;
+}
+
+
+template<class Scalar>
+void DefaultIntegrator<Scalar>::setBreakPointInformer(
+  const RCP<BreakPointInformerBase<Scalar> > &breakPointInformer
+  )
+{
+  breakPointInformer_ = breakPointInformer;
+}
+
+
+template<class Scalar>
+RCP<const BreakPointInformerBase<Scalar> >
+DefaultIntegrator<Scalar>::getBreakPointInformer() const
+{
+  return breakPointInformer_;
+}
+
+
+template<class Scalar>
+int DefaultIntegrator<Scalar>::getNumBreakPointCutSteps() const
+{
+  return numBreakPointCutSteps_;
+}
+
+
+template<class Scalar>
+int DefaultIntegrator<Scalar>::getNumEvents() const
+{
+  return numEvents_;
+}
+
+
+template<class Scalar>
+Scalar DefaultIntegrator<Scalar>::getLastEventTime() const
+{
+  return lastEventTime_;
+}
+
+
+template<class Scalar>
+const Array<int>& DefaultIntegrator<Scalar>::getLastEventIndices() const
+{
+  return lastEventIndices_;
+}
+
+
+template<class Scalar>
+int DefaultIntegrator<Scalar>::getNumEventResponseEvaluations() const
+{
+  return numEventResponseEvals_;
+}
+
+
+template<class Scalar>
+void DefaultIntegrator<Scalar>::beginStreaming()
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(stepper_), std::logic_error,
+    "Error, DefaultIntegrator::beginStreaming():  setStepper() must be"
+    " called first!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    streaming_, std::logic_error,
+    "Error, DefaultIntegrator::beginStreaming():  A streaming integration"
+    " has already been started!"
+    );
+  finalizeSetup();
+  if (!is_null(integrationObserver_)) {
+    integrationObserver_->setOStream(this->getOStream());
+    integrationObserver_->setVerbLevel(
+      Teuchos::incrVerbLevel(this->getVerbLevel(),-1));
+    integrationObserver_->observeStartTimeIntegration(*stepper_);
+  }
+  streaming_ = true;
+  numStreamingChunks_ = 0;
+}
+
+
+template<class Scalar>
+bool DefaultIntegrator<Scalar>::advanceChunk(
+  const Scalar &t,
+  const Ptr<Thyra::VectorBase<Scalar> > &x,
+  const Ptr<Thyra::VectorBase<Scalar> > &x_dot
+  )
+{
+
+  RYTHMOS_FUNC_TIME_MONITOR_DIFF("Rythmos:DefaultIntegrator::advanceChunk",
+    TopLevel);
+
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !streaming_, std::logic_error,
+    "Error, DefaultIntegrator::advanceChunk(...):  beginStreaming() must be"
+    " called first!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    t < stepper_->getTimeRange().lower() || t > integrationTimeDomain_.upper(),
+    std::out_of_range,
+    "Error, DefaultIntegrator::advanceChunk(" << t << "):  The end of the"
+    " chunk must be in [" << stepper_->getTimeRange().lower() << ","
+    << integrationTimeDomain_.upper() << "]!"
+    );
+
+  stoppedAtEvent_ = false;
+  ++numStreamingChunks_;
+
+  if (resumeEventSearch())
+    return false;
+
+  if (!stepper_->getTimeRange().isInRange(t)) {
+    if (!advanceStepperToTime(t))
+      return false;
+  }
+
+  if (is_null(x) && is_null(x_dot))
+    return true;
+
+  // The chunk normally ends on the end of a step, where the solution can be
+  // copied without interpolation.
+  const StepStatus<Scalar> stepStatus = stepper_->getStepStatus();
+  if ( stepStatus.time == t && nonnull(stepStatus.solution)
+    && (is_null(x_dot) || nonnull(stepStatus.solutionDot)) )
+  {
+    if (nonnull(x))
+      Thyra::V_V(x,*stepStatus.solution);
+    if (nonnull(x_dot))
+      Thyra::V_V(x_dot,*stepStatus.solutionDot);
+  }
+  else {
+    Array<Scalar> time_vec(1,t);
+    Array<RCP<const Thyra::VectorBase<Scalar> > > x_vec, x_dot_vec;
+    stepper_->getPoints(time_vec, nonnull(x) ? &x_vec : 0,
+      nonnull(x_dot) ? &x_dot_vec : 0, 0);
+    if (nonnull(x))
+      Thyra::V_V(x,*x_vec[0]);
+    if (nonnull(x_dot))
+      Thyra::V_V(x_dot,*x_dot_vec[0]);
+  }
+
+  return true;
+
+}
+
+
+template<class Scalar>
+void DefaultIntegrator<Scalar>::endStreaming()
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !streaming_, std::logic_error,
+    "Error, DefaultIntegrator::endStreaming():  No streaming integration"
+    " has been started!"
+    );
+  if (!is_null(integrationObserver_))
+    integrationObserver_->observeEndTimeIntegration(*stepper_);
+  streaming_ = false;
+}
+
+
+template<class Scalar>
+bool DefaultIntegrator<Scalar>::isStreaming() const
+{
+  return streaming_;
+}
+
+
+template<class Scalar>
+int DefaultIntegrator<Scalar>::getNumStreamingChunks() const
+{
+  return numStreamingChunks_;
+}
+
+
 template<class Scalar>
 void DefaultIntegrator<Scalar>::setInterpolationBufferAppender(
   const RCP<InterpolationBufferAppenderBase<Scalar> > &interpBufferAppender
@@ -224,6 +581,49 @@ void DefaultIntegrator<Scalar>::setParameterList(
   this->setMyParamList(paramList);
   maxNumTimeSteps_ = paramList->get(
     maxNumTimeSteps_name_, maxNumTimeSteps_default_);
+  landOnOutputTimes_ = paramList->get(
+    landOnOutputTimes_name_, landOnOutputTimes_default_);
+  ParameterList &stiffnessPL = paramList->sublist(stiffnessSwitching_name_);
+  stiffThreshold_ = stiffnessPL.get(
+    stiffThreshold_name_, stiffThreshold_default_);
+  nonstiffThreshold_ = stiffnessPL.get(
+    nonstiffThreshold_name_, nonstiffThreshold_default_);
+  powerIterations_ = stiffnessPL.get(
+    powerIterations_name_, powerIterations_default_);
+  stiffnessCheckInterval_ = stiffnessPL.get(
+    stiffnessCheckInterval_name_, stiffnessCheckInterval_default_);
+  consecutiveDetections_ = stiffnessPL.get(
+    consecutiveDetections_name_, consecutiveDetections_default_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    (powerIterations_ < 1) || (stiffnessCheckInterval_ < 1),
+    std::logic_error,
+    "Error, \"" << powerIterations_name_ << "\" and \""
+    << stiffnessCheckInterval_name_ << "\" must be at least one!"
+    );
+  ParameterList &eventPL = paramList->sublist(eventDetection_name_);
+  eventResponseIndex_ = eventPL.get(
+    eventResponseIndex_name_, eventResponseIndex_default_);
+  const std::string eventDirection = eventPL.get(
+    eventDirection_name_, eventDirection_default_);
+  eventDirection_ = EVENT_DIRECTION_BOTH;
+  if (eventDirection == toString(EVENT_DIRECTION_INCREASING))
+    eventDirection_ = EVENT_DIRECTION_INCREASING;
+  else if (eventDirection == toString(EVENT_DIRECTION_DECREASING))
+    eventDirection_ = EVENT_DIRECTION_DECREASING;
+  stopOnEvent_ = eventPL.get(stopOnEvent_name_, stopOnEvent_default_);
+  eventRelTimeTol_ = eventPL.get(
+    eventRelTimeTol_name_, eventRelTimeTol_default_);
+  eventMaxIterations_ = eventPL.get(
+    eventMaxIterations_name_, eventMaxIterations_default_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    (eventRelTimeTol_ <= ScalarTraits<ScalarMag>::zero())
+    || (eventMaxIterations_ < 1),
+    std::logic_error,
+    "Error, \"" << eventRelTimeTol_name_ << "\" must be positive and \""
+    << eventMaxIterations_name_ << "\" must be at least one!"
+    );
+  eventResponse_ = Teuchos::null;
+  eventResponse0_.clear();
   Teuchos::readVerboseObjectSublist(&*paramList,this);
 }
 
@@ -237,6 +637,67 @@ DefaultIntegrator<Scalar>::getValidParameters() const
     RCP<ParameterList> pl = Teuchos::parameterList();
     pl->set(maxNumTimeSteps_name_, maxNumTimeSteps_default_,
       "Set the maximum number of integration time-steps allowed.");
+    pl->set(landOnOutputTimes_name_, landOnOutputTimes_default_,
+      "If true, the time steps are cut so that every time point requested "
+      "from getFwdPoints(...) is the end of a time step.  If false, the "
+      "stepper takes its natural step sizes, only the final time and the "
+      "breakpoints of the integration control strategy cut a step, and all "
+      "requested time points inside an accepted step are interpolated by "
+      "the stepper in one call to getPoints(...).");
+    ParameterList &stiffnessPL = pl->sublist(stiffnessSwitching_name_, false,
+      "Switching between an explicit and an implicit stepper, used when a "
+      "stiffness switching stepper is set on the integrator.");
+    stiffnessPL.set(stiffThreshold_name_, stiffThreshold_default_,
+      "Switch to the implicit stepper when h*rho of the explicit stepper "
+      "exceeds this value, where rho is the estimated spectral radius of "
+      "df/dx.  Choose it below the extent of the stability region of the "
+      "explicit method along the negative real axis (2 for Forward Euler, "
+      "2.78 for classic RK4).");
+    stiffnessPL.set(nonstiffThreshold_name_, nonstiffThreshold_default_,
+      "Switch to the explicit stepper when h*rho of the implicit stepper "
+      "falls below this value.");
+    stiffnessPL.set(powerIterations_name_, powerIterations_default_,
+      "Number of power iterations for the estimate of rho.  Each costs one "
+      "evaluation of f; the iterate is carried over between estimates.");
+    stiffnessPL.set(stiffnessCheckInterval_name_,
+      stiffnessCheckInterval_default_,
+      "Number of time steps between estimates of rho.");
+    stiffnessPL.set(consecutiveDetections_name_,
+      consecutiveDetections_default_,
+      "Number of estimates in a row that must call for a switch before the "
+      "stepper is switched.");
+    ParameterList &eventPL = pl->sublist(eventDetection_name_, false,
+      "Location of the zero crossings of the components of a model response, "
+      "evaluated after every accepted time step.");
+    eventPL.set(eventResponseIndex_name_, eventResponseIndex_default_,
+      "Index j of the model response g(j) whose components are the event "
+      "functions.  A negative value turns event detection off.");
+    Teuchos::setStringToIntegralParameter<EEventDirection>(
+      eventDirection_name_,
+      eventDirection_default_,
+      "Which zero crossings are events.  \"Increasing\" and \"Decreasing\" "
+      "only report components going from negative to positive and from "
+      "positive to negative respectively.",
+      Teuchos::tuple<std::string>(
+        toString(EVENT_DIRECTION_BOTH),
+        toString(EVENT_DIRECTION_INCREASING),
+        toString(EVENT_DIRECTION_DECREASING)
+        ),
+      Teuchos::tuple<EEventDirection>(
+        EVENT_DIRECTION_BOTH,
+        EVENT_DIRECTION_INCREASING,
+        EVENT_DIRECTION_DECREASING
+        ),
+      &eventPL
+      );
+    eventPL.set(stopOnEvent_name_, stopOnEvent_default_,
+      "If true, getFwdPoints(...) returns after the first event.  If false, "
+      "the events are only passed to the integration observer.");
+    eventPL.set(eventRelTimeTol_name_, eventRelTimeTol_default_,
+      "The event time is located to within this tolerance times |t|+|dt| "
+      "of the time step it falls in.");
+    eventPL.set(eventMaxIterations_name_, eventMaxIterations_default_,
+      "Maximum number of response evaluations used to locate one event.");
     Teuchos::setupVerboseObjectSublist(&*pl);
     validPL = pl;
   }
@@ -269,6 +730,8 @@ DefaultIntegrator<Scalar>::cloneIntegrator() const
     newIntegrator->integrationObserver_ =
       integrationObserver_->cloneIntegrationObserver().assert_not_null();
   }
+  // The breakpoints are only read by the integrator so they can be shared.
+  newIntegrator->breakPointInformer_ = breakPointInformer_;
   if (!is_null(trailingInterpBuffer_)) {
     // ToDo: implement the clone!
     newIntegrator->trailingInterpBuffer_ = null;
@@ -296,6 +759,13 @@ void DefaultIntegrator<Scalar>::setStepper(
   TEUCHOS_TEST_FOR_EXCEPT(is_null(stepper));
   TEUCHOS_TEST_FOR_EXCEPT( finalTime < stepper->getTimeRange().lower() );
   TEUCHOS_ASSERT( stepper->getTimeRange().length() == ST::zero() );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    nonnull(alternateStepper_) &&
+    (alternateStepper_->isImplicit() == stepper->isImplicit()),
+    std::logic_error,
+    "Error, the stiffness switching stepper must be implicit if the new "
+    "stepper is explicit and explicit if it is implicit!"
+    );
   // 2007/07/25: rabartl: ToDo: Validate state of the stepper!
   stepper_ = stepper;
   integrationTimeDomain_ = timeRange(stepper_->getTimeRange().lower(),
@@ -303,6 +773,26 @@ void DefaultIntegrator<Scalar>::setStepper(
   landOnFinalTime_ = landOnFinalTime;
   currTimeStepIndex_ = 0;
   stepCtrlInfoLast_ = StepControlInfo<Scalar>();
+  stepTraceNonlinearIterations_ =
+    stepper_->getPerformanceCounters().numNonlinearIterations;
+  lastSolution_ = Teuchos::null;
+  dominantEigenVector_ = Teuchos::null;
+  stiffnessF_ = Teuchos::null;
+  stiffnessFPert_ = Teuchos::null;
+  stiffnessXPert_ = Teuchos::null;
+  stiffnessSwitchPending_ = false;
+  numStiffnessDetections_ = 0;
+  numStiffnessSwitches_ = 0;
+  stiffnessEstimate_ = -ScalarTraits<ScalarMag>::one();
+  numBreakPointCutSteps_ = 0;
+  eventResponse_ = Teuchos::null;
+  eventResponse0_.clear();
+  stoppedAtEvent_ = false;
+  numEvents_ = 0;
+  numEventResponseEvals_ = 0;
+  lastEventIndices_.clear();
+  streaming_ = false;
+  numStreamingChunks_ = 0;
   if (!is_null(integrationControlStrategy_))
     integrationControlStrategy_->resetIntegrationControlStrategy(
       integrationTimeDomain_
@@ -391,6 +881,7 @@ void DefaultIntegrator<Scalar>::getFwdPoints(
   typedef Teuchos::VerboseObjectTempState<IBB> VOTSIBB;
 
   finalizeSetup();
+  stoppedAtEvent_ = false;
 
   RCP<Teuchos::FancyOStream> out = this->getOStream();
   Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
@@ -405,8 +896,9 @@ void DefaultIntegrator<Scalar>::getFwdPoints(
   if ( includesVerbLevel(verbLevel,Teuchos::VERB_MEDIUM) )
     *out << "\nRequested time points: " << Teuchos::toString(time_vec) << "\n";
 
-  // Observe start of a time integration
-  if (!is_null(integrationObserver_)) {
+  // Observe start of a time integration, unless it is part of a streaming
+  // integration that has already been started.
+  if (!is_null(integrationObserver_) && !streaming_) {
     integrationObserver_->setOStream(out);
     integrationObserver_->setVerbLevel(incrVerbLevel(verbLevel,-1));
     integrationObserver_->observeStartTimeIntegration(*stepper_);
@@ -436,10 +928,15 @@ void DefaultIntegrator<Scalar>::getFwdPoints(
   assertNoTimePointsBeforeCurrentTimeRange(*this,time_vec,nextTimePointIndex);
 
   //
-  // 1) First, get all time points that fall within the current time range
+  // 1) First, get all time points that fall within the current time range,
+  // unless the last call stopped at an event and the rest of the current
+  // step holds another one.
   //
 
-  {
+  if (resumeEventSearch()) {
+    getPointsUpToEvent(time_vec,x_vec,xdot_vec,&nextTimePointIndex);
+  }
+  else {
     RYTHMOS_FUNC_TIME_MONITOR(
       "Rythmos:DefaultIntegrator::getFwdPoints: getPoints");
     // 2007/10/05: rabartl: ToDo: Get points from trailingInterpBuffer_ first!
@@ -451,10 +948,13 @@ void DefaultIntegrator<Scalar>::getFwdPoints(
   // before the current time.
   //
 
-  while ( nextTimePointIndex < numTimePoints ) {
+  while ( !stoppedAtEvent_ && nextTimePointIndex < numTimePoints ) {
 
     // Use the time stepping algorithm to step up to or past the next
     // requested time but not so far as to step past the point entirely.
+    // Unless "Land On Output Times" is set the steps are not cut at t, and
+    // all of the requested times that fall inside the step are extracted in
+    // one batch below.
     const Scalar t = time_vec[nextTimePointIndex];
     bool advanceStepperToTimeSucceeded = false;
 
@@ -476,6 +976,11 @@ void DefaultIntegrator<Scalar>::getFwdPoints(
         // Break out of the while loop and attempt to exit gracefully.
         break;
       }
+      if (stoppedAtEvent_) {
+        // Return the requested points up to the event and leave the rest.
+        getPointsUpToEvent(time_vec,x_vec,xdot_vec,&nextTimePointIndex);
+        break;
+      }
       TEUCHOS_TEST_FOR_EXCEPTION(
           !advanceStepperToTimeSucceeded, Exceptions::GetFwdPointsFailed,
           this->description() << "\n\n"
@@ -495,7 +1000,7 @@ void DefaultIntegrator<Scalar>::getFwdPoints(
   }
 
   // Observe end of a time integration
-  if (!is_null(integrationObserver_)) {
+  if (!is_null(integrationObserver_) && !streaming_) {
     integrationObserver_->observeEndTimeIntegration(*stepper_);
   }
 
@@ -690,6 +1195,15 @@ bool DefaultIntegrator<Scalar>::advanceStepperToTime(const Scalar& advance_to_t)
       }
     }
 
+    if (stiffnessSwitchPending_) {
+      if ( includesVerbLevel(verbLevel,Teuchos::VERB_LOW) )
+        *out << "\nSwitching to the "
+             << (stepper_->isImplicit() ? "explicit" : "implicit")
+             << " stepper, h*rho = " << stiffnessEstimate_ << " ...\n";
+      switchStepper();
+      currStepperTimeRange = stepper_->getTimeRange();
+    }
+
     //
     // B) Find an acceptable time step in a loop
     //
@@ -766,6 +1280,40 @@ bool DefaultIntegrator<Scalar>::advanceStepperToTime(const Scalar& advance_to_t)
         }
       }
 
+      // Make sure we don't step past the requested time if asked not to.  A
+      // streaming chunk always ends on a step.
+      if ((landOnOutputTimes_ || streaming_) && trialStepCtrlInfo.stepSize
+                                + currStepperTimeRange.upper() > advance_to_t) {
+
+        trialStepCtrlInfo.stepSize = advance_to_t - currStepperTimeRange.upper();
+        updatedTrialStepCtrlInfo = true;
+
+        if ( includesVerbLevel(verbLevel,Teuchos::VERB_LOW) )
+          *out << "\nCutting trial step to "<< trialStepCtrlInfo.stepSize
+               << " to land on the requested time " << advance_to_t << " ...\n";
+      }
+
+      // Make sure we don't step over the next breakpoint
+      if (nonnull(breakPointInformer_)) {
+        Scalar currTime = currStepperTimeRange.upper();
+        Scalar trialStepSize = trialStepCtrlInfo.stepSize;
+        if (breakPointInformer_->testForBreakPoint(currTime,trialStepSize)) {
+          const Scalar breakPoint =
+            breakPointInformer_->getNextBreakPoint(currTime);
+          trialStepCtrlInfo.limitedByBreakPoint = true;
+          trialStepCtrlInfo.breakPointType =
+            breakPointInformer_->getNextBreakPointType(currTime);
+          updatedTrialStepCtrlInfo = true;
+          if (breakPoint - currTime < trialStepCtrlInfo.stepSize) {
+            trialStepCtrlInfo.stepSize = breakPoint - currTime;
+            ++numBreakPointCutSteps_;
+            if ( includesVerbLevel(verbLevel,Teuchos::VERB_LOW) )
+              *out << "\nCutting trial step to "<< trialStepCtrlInfo.stepSize
+                   << " to land on the breakpoint " << breakPoint << " ...\n";
+          }
+        }
+      }
+
       // Print the modified trial step
       if ( updatedTrialStepCtrlInfo
         && includesVerbLevel(verbLevel,Teuchos::VERB_MEDIUM) )
@@ -795,6 +1343,10 @@ bool DefaultIntegrator<Scalar>::advanceStepperToTime(const Scalar& advance_to_t)
                << trialStepCtrlInfo.stepSize << " ....\n";
       }
 
+      RYTHMOS_STEP_TRACE( stepTrace_.get(), STEP_TRACE_TRIAL_STEP,
+        currTimeStepIndex_, currStepperTimeRange.upper(),
+        trialStepCtrlInfo.stepSize, -1, -1.0, -1 );
+
       // Take step
       Scalar stepSizeTaken;
       {
@@ -823,6 +1375,13 @@ bool DefaultIntegrator<Scalar>::advanceStepperToTime(const Scalar& advance_to_t)
              <<" failed!\n";
       }
 
+      RYTHMOS_STEP_TRACE( stepTrace_.get(),
+        timeStepFailed ? STEP_TRACE_FAILED_STEP : STEP_TRACE_ACCEPTED_STEP,
+        currTimeStepIndex_, currStepperTimeRange.upper(),
+        stepCtrlInfo.stepSize, stepper_->getOrder(),
+        stepper_->getStepStatus().stepLETValue,
+        nonlinearIterationsSinceLastTrace() );
+
       // Notify observer of a failed time step
       if (timeStepFailed) {
         if (nonnull(integrationObserver_))
@@ -935,6 +1494,17 @@ bool DefaultIntegrator<Scalar>::advanceStepperToTime(const Scalar& advance_to_t)
     stepCtrlInfoLast_ = stepCtrlInfo;
     ++currTimeStepIndex_;
 
+    if (nonnull(alternateStepper_))
+      checkStiffness(stepCtrlInfo);
+
+    if (eventResponseIndex_ >= 0 && detectEvents() && stopOnEvent_) {
+      if ( includesVerbLevel(verbLevel,Teuchos::VERB_LOW) )
+        *out << "\nStopping at the event at t = " << lastEventTime_ << "\n";
+      stoppedAtEvent_ = true;
+      return_val = false;
+      break;
+    }
+
   }
 
   if ( includesVerbLevel(verbLevel,Teuchos::VERB_LOW) )
@@ -948,6 +1518,374 @@ bool DefaultIntegrator<Scalar>::advanceStepperToTime(const Scalar& advance_to_t)
 
 }
 
+template<class Scalar>
+void DefaultIntegrator<Scalar>::checkStiffness(
+  const StepControlInfo<Scalar> &stepCtrlInfo
+  )
+{
+
+  RYTHMOS_FUNC_TIME_MONITOR(
+    "Rythmos:DefaultIntegrator::checkStiffness");
+
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  typedef Thyra::ModelEvaluatorBase MEB;
+
+  const StepStatus<Scalar> stepStatus = stepper_->getStepStatus();
+  const RCP<const Thyra::VectorBase<Scalar> > x = stepStatus.solution;
+
+  // The first power iterate is the change of the solution over the last
+  // step, which is dominated by the stiff components once they are excited.
+  if (is_null(lastSolution_)) {
+    lastSolution_ = x->clone_v();
+    return;
+  }
+  if (is_null(dominantEigenVector_)) {
+    dominantEigenVector_ = x->clone_v();
+    Thyra::Vp_StV(dominantEigenVector_.ptr(), -ST::one(), *lastSolution_);
+  }
+  Thyra::V_V(lastSolution_.ptr(), *x);
+  if (currTimeStepIndex_ % stiffnessCheckInterval_ != 0)
+    return;
+
+  ScalarMag vnorm = Thyra::norm_2(*dominantEigenVector_);
+  if (vnorm == ScalarTraits<ScalarMag>::zero()) {
+    dominantEigenVector_ = Teuchos::null;
+    return;
+  }
+
+  const RCP<const Thyra::ModelEvaluator<Scalar> > model =
+    ( stepper_->isImplicit() ? alternateStepper_ : stepper_ )->getModel();
+  MEB::InArgs<Scalar> basePoint = model->createInArgs();
+  basePoint.setArgs(model->getNominalValues());
+  if (is_null(stiffnessF_)) {
+    stiffnessF_ = Thyra::createMember(x->space());
+    stiffnessFPert_ = Thyra::createMember(x->space());
+    stiffnessXPert_ = Thyra::createMember(x->space());
+  }
+  const RCP<Thyra::VectorBase<Scalar> >
+    f = stiffnessF_,
+    f_pert = stiffnessFPert_,
+    x_pert = stiffnessXPert_;
+  eval_model_explicit<Scalar>(*model, basePoint, *x, stepStatus.time, f.ptr());
+
+  // Power iteration with (df/dx)*v approximated by a directional difference.
+  const ScalarMag xnorm = Thyra::norm_2(*x);
+  ScalarMag rho = ScalarTraits<ScalarMag>::zero();
+  for (int i=0 ; i<powerIterations_ ; ++i) {
+    const Scalar delta = ST::squareroot(ST::eps())*(ST::one()+xnorm)/vnorm;
+    Thyra::V_V(x_pert.ptr(), *x);
+    Thyra::Vp_StV(x_pert.ptr(), delta, *dominantEigenVector_);
+    eval_model_explicit<Scalar>(
+      *model, basePoint, *x_pert, stepStatus.time, f_pert.ptr());
+    Thyra::V_StVpStV(dominantEigenVector_.ptr(), ST::one()/delta, *f_pert,
+      -ST::one()/delta, *f);
+    const ScalarMag wnorm = Thyra::norm_2(*dominantEigenVector_);
+    rho = wnorm/vnorm;
+    if (wnorm == ScalarTraits<ScalarMag>::zero()) {
+      dominantEigenVector_ = Teuchos::null;
+      break;
+    }
+    Thyra::Vt_S(dominantEigenVector_.ptr(), ST::one()/wnorm);
+    vnorm = ScalarTraits<ScalarMag>::one();
+  }
+
+  stiffnessEstimate_ = stepCtrlInfo.stepSize*rho;
+  const bool switchIndicated =
+    ( stepper_->isImplicit()
+      ? stiffnessEstimate_ < nonstiffThreshold_
+      : stiffnessEstimate_ > stiffThreshold_ );
+  numStiffnessDetections_ = ( switchIndicated ? numStiffnessDetections_+1 : 0 );
+  if (numStiffnessDetections_ >= consecutiveDetections_)
+    stiffnessSwitchPending_ = true;
+
+  RCP<Teuchos::FancyOStream> out = this->getOStream();
+  if ( includesVerbLevel(this->getVerbLevel(),Teuchos::VERB_MEDIUM) )
+    *out << "\nStiffness estimate: h*rho = " << stiffnessEstimate_
+         << " (rho = " << rho << "), detections = "
+         << numStiffnessDetections_ << "\n";
+
+}
+
+
+template<class Scalar>
+void DefaultIntegrator<Scalar>::switchStepper()
+{
+
+  RYTHMOS_FUNC_TIME_MONITOR(
+    "Rythmos:DefaultIntegrator::switchStepper");
+
+  typedef Thyra::ModelEvaluatorBase MEB;
+
+  // Hand the current state to the other stepper as in restart(...)
+  const StepStatus<Scalar> stepStatus = stepper_->getStepStatus();
+  const RCP<const Thyra::ModelEvaluator<Scalar> >
+    model = alternateStepper_->getModel();
+  MEB::InArgs<Scalar> initialCondition = model->createInArgs();
+  initialCondition.setArgs(model->getNominalValues());
+  initialCondition.set_x(stepStatus.solution->clone_v());
+  if (initialCondition.supports(MEB::IN_ARG_x_dot)) {
+    // The current stepper is explicit, so its model gives x_dot = f(x,t).
+    const RCP<const Thyra::ModelEvaluator<Scalar> >
+      explicitModel = stepper_->getModel();
+    MEB::InArgs<Scalar> basePoint = explicitModel->createInArgs();
+    basePoint.setArgs(explicitModel->getNominalValues());
+    const RCP<Thyra::VectorBase<Scalar> >
+      x_dot = Thyra::createMember(stepStatus.solution->space());
+    eval_model_explicit<Scalar>(*explicitModel, basePoint,
+      *stepStatus.solution, stepStatus.time, x_dot.ptr());
+    initialCondition.set_x_dot(x_dot);
+  }
+  if (initialCondition.supports(MEB::IN_ARG_t))
+    initialCondition.set_t(stepStatus.time);
+  alternateStepper_->setInitialCondition(initialCondition);
+
+  std::swap(stepper_, alternateStepper_);
+  eventResponse_ = Teuchos::null;
+  stepTraceNonlinearIterations_ =
+    stepper_->getPerformanceCounters().numNonlinearIterations;
+  stiffnessSwitchPending_ = false;
+  numStiffnessDetections_ = 0;
+  ++numStiffnessSwitches_;
+
+}
+
+
+template<class Scalar>
+int DefaultIntegrator<Scalar>::nonlinearIterationsSinceLastTrace()
+{
+  const int numIters =
+    stepper_->getPerformanceCounters().numNonlinearIterations;
+  const int newIters = numIters - stepTraceNonlinearIterations_;
+  stepTraceNonlinearIterations_ = numIters;
+  return newIters;
+}
+
+
+template<class Scalar>
+bool DefaultIntegrator<Scalar>::detectEvents()
+{
+
+  RYTHMOS_FUNC_TIME_MONITOR(
+    "Rythmos:DefaultIntegrator::detectEvents");
+
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+
+  const TimeRange<Scalar> stepRange = stepper_->getTimeRange();
+  if (eventResponse0_.size() == 0 || !stepRange.isInRange(eventTime0_)) {
+    eventTime0_ = stepRange.lower();
+    evalEventResponse(eventTime0_, &eventResponse0_);
+  }
+  const Scalar t1 = stepRange.upper();
+  evalEventResponse(t1, &eventResponse1_);
+  const int numEventFuncs = eventResponse1_.size();
+  const Scalar timeTol =
+    eventRelTimeTol_*(ST::magnitude(t1) + ST::magnitude(t1 - eventTime0_));
+
+  // Locate the events in the step one after the other.  Each search keeps
+  // the earliest crossing of all components bracketed in [tLo,tHi] and only
+  // evaluates the full response vector at interpolated states.
+  bool foundEvent = false;
+  Scalar tLo = eventTime0_;
+  Array<Scalar> gLo = eventResponse0_;
+  Array<Scalar> gHi, gMid;
+  while (true) {
+
+    bool anyCrossing = false;
+    for (int i = 0; i < numEventFuncs && !anyCrossing; ++i)
+      anyCrossing = eventCrossing(gLo, eventResponse1_, i);
+    if (!anyCrossing)
+      break;
+
+    Scalar tHi = t1;
+    gHi = eventResponse1_;
+    Scalar wLo = ST::one(), wHi = ST::one();
+    int lastSide = 0;
+    for (int iter = 0;
+      iter < eventMaxIterations_ && tHi - tLo > timeTol; ++iter)
+    {
+      // Regula falsi on the component with the earliest predicted root.  The
+      // Illinois weights halve the end point that was kept twice in a row.
+      Scalar frac = ST::one();
+      for (int i = 0; i < numEventFuncs; ++i) {
+        if (!eventCrossing(gLo, gHi, i))
+          continue;
+        const Scalar fLo = wLo*gLo[i], fHi = wHi*gHi[i];
+        const Scalar frac_i =
+          ( fLo == fHi ? ST::zero() : fLo/(fLo - fHi) );
+        frac = std::min(frac, frac_i);
+      }
+      Scalar tMid = tLo + frac*(tHi - tLo);
+      tMid = std::max(tMid, tLo + timeTol/2);
+      tMid = std::min(tMid, tHi - timeTol/2);
+      evalEventResponse(tMid, &gMid);
+      bool crossingBelowMid = false;
+      for (int i = 0; i < numEventFuncs && !crossingBelowMid; ++i)
+        crossingBelowMid = eventCrossing(gLo, gMid, i);
+      if (crossingBelowMid) {
+        tHi = tMid;
+        std::swap(gHi, gMid);
+        wHi = ST::one();
+        if (lastSide < 0)
+          wLo /= 2;
+        lastSide = -1;
+      }
+      else {
+        tLo = tMid;
+        std::swap(gLo, gMid);
+        wLo = ST::one();
+        if (lastSide > 0)
+          wHi /= 2;
+        lastSide = 1;
+      }
+    }
+
+    lastEventTime_ = tHi;
+    lastEventIndices_.clear();
+    for (int i = 0; i < numEventFuncs; ++i) {
+      if (eventCrossing(gLo, gHi, i))
+        lastEventIndices_.push_back(i);
+    }
+    ++numEvents_;
+    foundEvent = true;
+
+    RCP<Teuchos::FancyOStream> out = this->getOStream();
+    if ( includesVerbLevel(this->getVerbLevel(),Teuchos::VERB_MEDIUM) )
+      *out << "\nLocated event at t = " << lastEventTime_
+           << " for event functions " << Teuchos::toString(lastEventIndices_)
+           << "\n";
+
+    if (nonnull(integrationObserver_))
+      integrationObserver_->observeEvent(
+        *stepper_, lastEventTime_, lastEventIndices_);
+
+    // Look for more events in the rest of the step.
+    tLo = tHi;
+    std::swap(gLo, gHi);
+
+    if (stopOnEvent_) {
+      // Resume from the event so that the events left in (tHi,t1] are found
+      // by resumeEventSearch() when the integration is continued.
+      eventTime0_ = tLo;
+      std::swap(eventResponse0_, gLo);
+      return true;
+    }
+
+  }
+
+  eventTime0_ = t1;
+  std::swap(eventResponse0_, eventResponse1_);
+  return foundEvent;
+
+}
+
+
+template<class Scalar>
+bool DefaultIntegrator<Scalar>::resumeEventSearch()
+{
+  if (eventResponseIndex_ < 0 || !stopOnEvent_ || eventResponse0_.size() == 0)
+    return false;
+  // Only a stop at an event leaves the search behind the end of the step.
+  const TimeRange<Scalar> stepRange = stepper_->getTimeRange();
+  if (!stepRange.isInRange(eventTime0_) || eventTime0_ >= stepRange.upper())
+    return false;
+  if (!detectEvents())
+    return false;
+  stoppedAtEvent_ = true;
+  return true;
+}
+
+
+template<class Scalar>
+void DefaultIntegrator<Scalar>::getPointsUpToEvent(
+  const Array<Scalar>& time_vec,
+  Array<RCP<const Thyra::VectorBase<Scalar> > >* x_vec,
+  Array<RCP<const Thyra::VectorBase<Scalar> > >* xdot_vec,
+  int* nextTimePointIndex
+  )
+{
+  const int numTimePoints = time_vec.size();
+  Array<Scalar> event_time_vec;
+  for (int i = *nextTimePointIndex; i < numTimePoints; ++i) {
+    if (time_vec[i] > lastEventTime_)
+      break;
+    event_time_vec.push_back(time_vec[i]);
+  }
+  if (event_time_vec.size() == 0)
+    return;
+  Array<RCP<const Thyra::VectorBase<Scalar> > > event_x_vec;
+  Array<RCP<const Thyra::VectorBase<Scalar> > > event_xdot_vec;
+  stepper_->getPoints(event_time_vec, x_vec ? &event_x_vec : 0,
+    xdot_vec ? &event_xdot_vec : 0, 0);
+  for (int i = 0; i < Teuchos::as<int>(event_time_vec.size()); ++i) {
+    if (x_vec)
+      (*x_vec)[*nextTimePointIndex+i] = event_x_vec[i];
+    if (xdot_vec)
+      (*xdot_vec)[*nextTimePointIndex+i] = event_xdot_vec[i];
+  }
+  *nextTimePointIndex += event_time_vec.size();
+}
+
+
+template<class Scalar>
+void DefaultIntegrator<Scalar>::evalEventResponse(
+  const Scalar& t, Array<Scalar>* g
+  )
+{
+
+  typedef Thyra::ModelEvaluatorBase MEB;
+
+  const RCP<const Thyra::ModelEvaluator<Scalar> > model = stepper_->getModel();
+  if (is_null(eventResponse_)) {
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      eventResponseIndex_ >= model->Ng(), std::logic_error,
+      "Error, (" << eventResponseIndex_name_ << "=" << eventResponseIndex_
+      << ") is not a valid response index for the model with Ng="
+      << model->Ng() << "!\n");
+    eventResponse_ = Thyra::createMember(
+      model->get_g_space(eventResponseIndex_));
+  }
+
+  MEB::InArgs<Scalar> inArgs = model->createInArgs();
+  inArgs.setArgs(stepper_->getInitialCondition(), true);
+  const bool needsXDot = inArgs.supports(MEB::IN_ARG_x_dot);
+  Array<Scalar> time_vec(1, t);
+  Array<RCP<const Thyra::VectorBase<Scalar> > > x_vec, xdot_vec;
+  stepper_->getPoints(time_vec, &x_vec, needsXDot ? &xdot_vec : 0, 0);
+  inArgs.set_x(x_vec[0]);
+  if (needsXDot && nonnull(xdot_vec[0]))
+    inArgs.set_x_dot(xdot_vec[0]);
+  if (inArgs.supports(MEB::IN_ARG_t))
+    inArgs.set_t(t);
+  MEB::OutArgs<Scalar> outArgs = model->createOutArgs();
+  outArgs.set_g(eventResponseIndex_, eventResponse_);
+  model->evalModel(inArgs, outArgs);
+  ++numEventResponseEvals_;
+
+  const Thyra::ConstDetachedVectorView<Scalar> g_view(*eventResponse_);
+  g->resize(g_view.subDim());
+  for (int i = 0; i < Teuchos::as<int>(g_view.subDim()); ++i)
+    (*g)[i] = g_view[i];
+
+}
+
+
+template<class Scalar>
+bool DefaultIntegrator<Scalar>::eventCrossing(
+  const Array<Scalar>& g0, const Array<Scalar>& g1, const int i
+  ) const
+{
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  // A component that starts exactly on zero had its event reported already.
+  const bool increasing = (g0[i] < ST::zero() && g1[i] >= ST::zero());
+  const bool decreasing = (g0[i] > ST::zero() && g1[i] <= ST::zero());
+  switch (eventDirection_) {
+    case EVENT_DIRECTION_INCREASING: return increasing;
+    case EVENT_DIRECTION_DECREASING: return decreasing;
+    default: return increasing || decreasing;
+  }
+}
+
+
 //
 // Explicit Instantiation macro
 //
@@ -0,0 +1,119 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef RYTHMOS_DIRECTIONAL_DERIVATIVE_MODEL_EVALUATOR_BASE_HPP
+#define RYTHMOS_DIRECTIONAL_DERIVATIVE_MODEL_EVALUATOR_BASE_HPP
+
+
+#include "Rythmos_Types.hpp"
+#include "Thyra_ModelEvaluatorBase.hpp"
+#include "Thyra_MultiVectorBase.hpp"
+
+
+namespace Rythmos {
+
+
+/** \brief Optional mix-in interface for a state model that can compute
+ * directional derivatives of its residual in many directions with one call.
+ *
+ * For a state model <tt>f(x_dot,x,{p_l},t)</tt> evaluated at a base point
+ * <tt>(x_dot,x,{p_l},t)</tt>, this computes the <tt>m</tt> directional
+ * derivatives
+
+ \verbatim
+
+   F(:,j) = d(f)/d(x_dot)*V_x_dot(:,j) + d(f)/d(x)*V_x(:,j) + d(f)/d(p_l)*e_{pCols[j]}
+
+ \endverbatim
+
+ * for <tt>j=0...m-1</tt>, where <tt>e_i</tt> is the <tt>i</tt>th unit vector
+ * of the space of <tt>p_l</tt>.  This is the product that the forward
+ * sensitivity residual needs, and a model can compute it without ever forming
+ * <tt>d(f)/d(x_dot)</tt>, <tt>d(f)/d(x)</tt> or <tt>d(f)/d(p_l)</tt>, e.g.
+ * with forward mode automatic differentiation carrying all <tt>m</tt>
+ * directions at once, or with batched finite differences.
+ *
+ * <tt>ForwardSensitivityImplicitModelEvaluator</tt> uses this interface,
+ * when the state model implements it, to compute all of the sensitivity
+ * columns of its residual with a single call in its directional derivative
+ * mode.  A <tt>Thyra::ModelEvaluator</tt> subclass implements it by also
+ * deriving from this class.
+ */
+template<class Scalar>
+class DirectionalDerivativeModelEvaluatorBase
+{
+public:
+
+  /** \brief . */
+  virtual ~DirectionalDerivativeModelEvaluatorBase() {}
+
+  /** \brief Compute the directional derivatives of <tt>f</tt> at
+   * <tt>basePoint</tt>.
+   *
+   * \param basePoint [in] The point <tt>(x_dot,x,{p_l},t)</tt> at which the
+   * derivatives are computed.
+   *
+   * \param V_x_dot [in] The directions for <tt>x_dot</tt>.  If null, the
+   * term with <tt>d(f)/d(x_dot)</tt> is dropped.
+   *
+   * \param V_x [in] The directions for <tt>x</tt>.  If null, the term with
+   * <tt>d(f)/d(x)</tt> is dropped.
+   *
+   * \param l [in] The index of the parameter subvector whose unit vectors
+   * are the directions for the parameters.  If <tt>l < 0</tt>, the term with
+   * <tt>d(f)/d(p_l)</tt> is dropped.
+   *
+   * \param pCols [in] The parameter of each direction.  Ignored if
+   * <tt>l < 0</tt>.
+   *
+   * \param F [out] The directional derivatives, with one column per
+   * direction.
+   *
+   * <b>Preconditions:</b><ul>
+   * <li><tt>V_x_dot</tt>, <tt>V_x</tt> and <tt>F</tt> have the same number
+   *     of columns <tt>m</tt>
+   * <li>If <tt>l >= 0</tt> then <tt>pCols.size() == m</tt> and
+   *     <tt>0 <= pCols[j] < get_p_space(l)->dim()</tt>
+   * </ul>
+   */
+  virtual void evalDirectionalDerivatives(
+    const Thyra::ModelEvaluatorBase::InArgs<Scalar> &basePoint,
+    const Ptr<const Thyra::MultiVectorBase<Scalar> > &V_x_dot,
+    const Ptr<const Thyra::MultiVectorBase<Scalar> > &V_x,
+    const int l,
+    const ArrayView<const int> &pCols,
+    const Ptr<Thyra::MultiVectorBase<Scalar> > &F
+    ) const = 0;
+
+};
+
+
+} // namespace Rythmos
+
+
+#endif // RYTHMOS_DIRECTIONAL_DERIVATIVE_MODEL_EVALUATOR_BASE_HPP
@@ -0,0 +1,660 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef RYTHMOS_DISCRETE_ADJOINT_BACKWARD_EULER_INTEGRATOR_HPP
+#define RYTHMOS_DISCRETE_ADJOINT_BACKWARD_EULER_INTEGRATOR_HPP
+
+
+#include "Rythmos_BackwardEulerStepper.hpp"
+#include "Rythmos_TimeStepNonlinearSolver.hpp"
+#include "Thyra_ModelEvaluatorHelpers.hpp"
+#include "Thyra_LinearOpWithSolveBase.hpp"
+#include "Thyra_VectorStdOps.hpp"
+#include "Teuchos_VerboseObject.hpp"
+#include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+#include "Teuchos_Time.hpp"
+#include "Teuchos_as.hpp"
+#include <sstream>
+
+
+namespace Rythmos {
+
+
+/** \brief Computes the exact gradient of a response of the final state of a
+ * fixed step Backward Euler integration with the discrete adjoint of the
+ * Backward Euler steps.
+ *
+ * This drives a <tt>BackwardEulerStepper</tt> forward and then integrates the
+ * adjoint backward; it is not a <tt>StepperBase</tt> itself.
+ *
+ * For the implicit model <tt>f(x_dot,x,t,p) = 0</tt>, forward step
+ * <tt>n = 1...N</tt> of size <tt>dt(n)</tt> solves
+
+ \verbatim
+
+   R(n) = f( (x(n)-x(n-1))/dt(n), x(n), t(n), p ) = 0
+
+ \endverbatim
+
+ * with the Newton matrix <tt>W(n) = 1/dt(n)*d(f)/d(x_dot) + d(f)/d(x)</tt>.
+ * For a response <tt>g(x(N))</tt>, the discrete adjoint goes backward over
+ * the same steps:
+
+ \verbatim
+
+   W(n)^T * lambda(n) = mu(n),  n = N...1
+
+   mu(N)   = d(g)/d(x(N))^T
+   mu(n-1) = 1/dt(n) * d(f)/d(x_dot)(n)^T * lambda(n)
+
+   d(g)/d(x(0))^T = mu(0)
+   d(g)/d(p)^T    = - sum_n d(f)/d(p)(n)^T * lambda(n)
+
+ \endverbatim
+
+ * These are the derivatives of the Backward Euler solution itself, not of
+ * the ODE, so they agree with finite differences of the forward integration
+ * up to the nonlinear solver tolerance, independent of the step size.
+ *
+ * <tt>integrateForward()</tt> takes the fixed forward steps and keeps the
+ * state of each step together with <tt>W(n)</tt>, which the nonlinear solver
+ * evaluates and factors once more at the converged state after each step and
+ * then releases with <tt>TimeStepNonlinearSolver::release_W()</tt>.  This
+ * extra evaluation and factorization per step is part of the forward wall
+ * time, so compare <tt>getAdjointWallTime()</tt> against a plain forward
+ * integration for the cost of the gradient relative to the simulation.
+ * <tt>integrateAdjoint()</tt> then solves with the transpose of the kept
+ * factorizations, so the adjoint step costs one transposed solve, one
+ * evaluation of <tt>d(f)/d(x_dot)</tt> and, for parameter gradients, one of
+ * <tt>d(f)/d(p)</tt>, but no factorization.  With "Store Forward W" set to
+ * false, <tt>W(n)</tt> is instead evaluated and factored again at the
+ * converged state in each adjoint step, which keeps only the states in
+ * memory.  Either way the adjoint uses the exact <tt>W(n)</tt> of the
+ * converged state, also for nonlinear models.
+ *
+ * All forward states are kept in memory.  For long integrations
+ * <tt>CheckpointedAdjointDriver</tt> with <tt>AdjointModelEvaluator</tt>
+ * trades this memory for recomputation, but integrates the continuous
+ * adjoint.
+ *
+ * With "Store Forward W" the nonlinear solver must be a
+ * <tt>TimeStepNonlinearSolver</tt>, and the linear solver must support
+ * transposed solves.  The model must support
+ * <tt>W_op</tt>, and <tt>DfDp</tt> as a multi-vector by column for parameter
+ * gradients.
+ */
+template<class Scalar>
+class DiscreteAdjointBackwardEulerIntegrator
+  : virtual public Teuchos::Describable,
+    virtual public Teuchos::VerboseObject<DiscreteAdjointBackwardEulerIntegrator<Scalar> >,
+    virtual public Teuchos::ParameterListAcceptorDefaultBase
+{
+public:
+
+  /** \name Constructors/Initializers/Accessors */
+  //@{
+
+  /** \brief . */
+  DiscreteAdjointBackwardEulerIntegrator();
+
+  /** \brief Set the forward stepper.
+   *
+   * \param fwdStepper [in,persisting] Stepper with the forward model, a
+   * nonlinear solver, and the initial condition set.
+   *
+   * \param p_index [in] Index of the model parameters the gradient is
+   * computed for, or <tt>-1</tt> for none.
+   */
+  void initialize(
+    const RCP<BackwardEulerStepper<Scalar> > &fwdStepper,
+    const int p_index = -1
+    );
+
+  /** \brief . */
+  RCP<const BackwardEulerStepper<Scalar> > getFwdStepper() const;
+
+  /** \brief . */
+  int get_p_index() const;
+
+  /** \brief Integrate forward from the current time of the stepper to
+   * <tt>finalTime</tt> in <tt>numSteps</tt> equal steps, keeping the states
+   * and the W of each step, and return the solution at the final time.
+   */
+  RCP<const Thyra::VectorBase<Scalar> >
+  integrateForward(const Scalar &finalTime, const int numSteps);
+
+  /** \brief Integrate the discrete adjoint backward over the forward steps.
+   *
+   * \param d_g_d_x [in] The derivative of the response with respect to the
+   * final state, in the state space.
+   *
+   * \param d_g_d_x_init [out] If not null, the derivative of the response
+   * with respect to the initial state of the forward integration.
+   *
+   * \param d_g_d_p [out] If not null, the derivative of the response with
+   * respect to the parameters <tt>p_index</tt> through the forward
+   * integration.  The derivative of <tt>g</tt> itself with respect to
+   * <tt>p</tt>, and any dependence of the initial state on <tt>p</tt>, must
+   * be added by the caller.
+   *
+   * This can be called any number of times after one
+   * <tt>integrateForward()</tt>.
+   */
+  void integrateAdjoint(
+    const Thyra::VectorBase<Scalar> &d_g_d_x,
+    const Ptr<Thyra::VectorBase<Scalar> > &d_g_d_x_init,
+    const Ptr<Thyra::VectorBase<Scalar> > &d_g_d_p
+    );
+
+  /** \brief Number of steps of the last forward integration. */
+  int getNumForwardSteps() const;
+
+  /** \brief Number of transposed linear solves of the adjoint integrations
+   * since the last forward integration. */
+  int getNumTransposedSolves() const;
+
+  /** \brief Number of times W was evaluated and factored by the adjoint
+   * integrations since the last forward integration.  Zero when the forward
+   * W are stored. */
+  int getNumWEvaluations() const;
+
+  /** \brief Wall time in seconds of the last forward integration. */
+  double getForwardWallTime() const;
+
+  /** \brief Wall time in seconds of the last adjoint integration. */
+  double getAdjointWallTime() const;
+
+  /** \brief <tt>getAdjointWallTime()/getForwardWallTime()</tt>.
+   *
+   * The forward time includes the factorizations kept with "Store Forward
+   * W", so this is the cost of the adjoint relative to that forward
+   * integration, not to a plain one.
+   */
+  double getGradientCostRatio() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::ParameterListAcceptor */
+  //@{
+
+  /** \brief . */
+  void setParameterList(RCP<ParameterList> const& paramList);
+
+  /** \brief . */
+  RCP<const ParameterList> getValidParameters() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::Describable */
+  //@{
+
+  /** \brief . */
+  std::string description() const;
+
+  //@}
+
+private:
+
+  RCP<BackwardEulerStepper<Scalar> > fwdStepper_;
+  RCP<const Thyra::ModelEvaluator<Scalar> > fwdModel_;
+  RCP<Thyra::NonlinearSolverBase<Scalar> > fwdSolver_;
+  int p_index_;
+  bool storeW_;
+
+  // The forward integration, stepTimes_[n] is t(n), the others are of step
+  // n+1.
+  Thyra::ModelEvaluatorBase::InArgs<Scalar> basePoint_;
+  Array<Scalar> stepTimes_;
+  Array<RCP<const Thyra::VectorBase<Scalar> > > x_;
+  Array<RCP<const Thyra::VectorBase<Scalar> > > x_dot_;
+  Array<RCP<const Thyra::LinearOpWithSolveBase<Scalar> > > W_;
+
+  // Work storage of the adjoint integration.
+  RCP<Thyra::LinearOpBase<Scalar> > DfDx_dot_;
+  RCP<Thyra::MultiVectorBase<Scalar> > DfDp_;
+  RCP<Thyra::LinearOpWithSolveBase<Scalar> > W_compute_;
+
+  int numTransposedSolves_;
+  int numWEvaluations_;
+  double forwardWallTime_;
+  double adjointWallTime_;
+
+  static const std::string storeW_name_;
+  static const bool storeW_default_;
+
+  void assertForwardIntegrated() const;
+
+  RCP<const Thyra::LinearOpWithSolveBase<Scalar> > getW(const int n);
+
+};
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates DiscreteAdjointBackwardEulerIntegrator
+ */
+template<class Scalar>
+RCP<DiscreteAdjointBackwardEulerIntegrator<Scalar> >
+discreteAdjointBackwardEulerIntegrator(
+  const RCP<BackwardEulerStepper<Scalar> > &fwdStepper,
+  const int p_index = -1,
+  const RCP<ParameterList> &paramList = Teuchos::null
+  )
+{
+  RCP<DiscreteAdjointBackwardEulerIntegrator<Scalar> >
+    integrator = Teuchos::rcp(new DiscreteAdjointBackwardEulerIntegrator<Scalar>);
+  if (!is_null(paramList))
+    integrator->setParameterList(paramList);
+  integrator->initialize(fwdStepper,p_index);
+  return integrator;
+}
+
+
+//
+// Implementation
+//
+
+
+// Static members
+
+
+template<class Scalar>
+const std::string DiscreteAdjointBackwardEulerIntegrator<Scalar>::storeW_name_
+= "Store Forward W";
+
+template<class Scalar>
+const bool DiscreteAdjointBackwardEulerIntegrator<Scalar>::storeW_default_
+= true;
+
+
+// Constructors/Initializers/Accessors
+
+
+template<class Scalar>
+DiscreteAdjointBackwardEulerIntegrator<Scalar>::DiscreteAdjointBackwardEulerIntegrator()
+  :p_index_(-1),
+   storeW_(storeW_default_),
+   numTransposedSolves_(0),
+   numWEvaluations_(0),
+   forwardWallTime_(0.0),
+   adjointWallTime_(0.0)
+{}
+
+
+template<class Scalar>
+void DiscreteAdjointBackwardEulerIntegrator<Scalar>::initialize(
+  const RCP<BackwardEulerStepper<Scalar> > &fwdStepper,
+  const int p_index
+  )
+{
+  typedef Thyra::ModelEvaluatorBase MEB;
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(fwdStepper));
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(fwdStepper->getModel()) || is_null(fwdStepper->getNonconstSolver()),
+    std::logic_error,
+    "Error, the forward stepper needs a model and a nonlinear solver!"
+    );
+  const RCP<const Thyra::ModelEvaluator<Scalar> >
+    fwdModel = fwdStepper->getModel();
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !fwdModel->createOutArgs().supports(MEB::OUT_ARG_W_op), std::logic_error,
+    "Error, the model must support W_op for d(f)/d(x_dot)!"
+    );
+  if (p_index >= 0) {
+    TEUCHOS_ASSERT_IN_RANGE_UPPER_EXCLUSIVE( p_index, 0, fwdModel->Np() );
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      !fwdModel->createOutArgs().supports(MEB::OUT_ARG_DfDp,p_index).supports(
+        MEB::DERIV_MV_BY_COL),
+      std::logic_error,
+      "Error, the model must support DfDp(" << p_index << ") as a"
+      " multi-vector by column!"
+      );
+  }
+  fwdStepper_ = fwdStepper;
+  fwdModel_ = fwdModel;
+  fwdSolver_ = fwdStepper->getNonconstSolver();
+  p_index_ = p_index;
+  stepTimes_.clear();
+  x_.clear();
+  x_dot_.clear();
+  W_.clear();
+  DfDx_dot_ = Teuchos::null;
+  DfDp_ = Teuchos::null;
+  W_compute_ = Teuchos::null;
+  numTransposedSolves_ = 0;
+  numWEvaluations_ = 0;
+  forwardWallTime_ = 0.0;
+  adjointWallTime_ = 0.0;
+}
+
+
+template<class Scalar>
+RCP<const BackwardEulerStepper<Scalar> >
+DiscreteAdjointBackwardEulerIntegrator<Scalar>::getFwdStepper() const
+{
+  return fwdStepper_;
+}
+
+
+template<class Scalar>
+int DiscreteAdjointBackwardEulerIntegrator<Scalar>::get_p_index() const
+{
+  return p_index_;
+}
+
+
+template<class Scalar>
+RCP<const Thyra::VectorBase<Scalar> >
+DiscreteAdjointBackwardEulerIntegrator<Scalar>::integrateForward(
+  const Scalar &finalTime, const int numSteps
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(fwdStepper_), std::logic_error,
+    "Error, initialize() must be called first!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    numSteps < 1, std::logic_error,
+    "Error, numSteps = " << numSteps << " must be positive!"
+    );
+  const Scalar t0 = fwdStepper_->getTimeRange().upper();
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !(finalTime > t0), std::logic_error,
+    "Error, finalTime = " << finalTime << " must be after the current time "
+    << t0 << " of the forward stepper!"
+    );
+
+  const double startTime = Teuchos::Time::wallTime();
+
+  basePoint_ = fwdStepper_->getInitialCondition();
+  stepTimes_.clear();
+  stepTimes_.push_back(t0);
+  x_.clear();
+  x_dot_.clear();
+  W_.clear();
+  numTransposedSolves_ = 0;
+  numWEvaluations_ = 0;
+  adjointWallTime_ = 0.0;
+
+  const Scalar dt = (finalTime-t0)/numSteps;
+  for (int n = 0; n < numSteps; ++n) {
+    const Scalar dt_taken = fwdStepper_->takeStep(dt,STEP_TYPE_FIXED);
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      dt_taken != dt, std::runtime_error,
+      "Error, the forward stepper failed to take step " << n << " of size "
+      << dt << " from t = " << stepTimes_[n] << "!"
+      );
+    const StepStatus<Scalar> stepStatus = fwdStepper_->getStepStatus();
+    stepTimes_.push_back(stepStatus.time);
+    x_.push_back(stepStatus.solution->clone_v());
+    x_dot_.push_back(stepStatus.solutionDot->clone_v());
+    if (storeW_) {
+      const RCP<TimeStepNonlinearSolver<Scalar> > timeStepSolver =
+        Teuchos::rcp_dynamic_cast<TimeStepNonlinearSolver<Scalar> >(fwdSolver_);
+      TEUCHOS_TEST_FOR_EXCEPTION(
+        is_null(timeStepSolver), std::logic_error,
+        "Error, \"" << storeW_name_ << "\" needs the forward stepper to use a"
+        " TimeStepNonlinearSolver!"
+        );
+      // The solver's W is of the last Newton iterate, so have it evaluated
+      // again at the converged state, and take it from the solver so that
+      // the next step creates a new W instead of factoring over this one.
+      timeStepSolver->get_nonconst_W(true);
+      const RCP<const Thyra::LinearOpWithSolveBase<Scalar> >
+        W = timeStepSolver->release_W();
+      TEUCHOS_TEST_FOR_EXCEPTION(
+        is_null(W), std::logic_error,
+        "Error, the nonlinear solver has no W to keep!"
+        );
+      TEUCHOS_TEST_FOR_EXCEPTION(
+        n == 0 && !W->solveSupports(Thyra::CONJTRANS), std::logic_error,
+        "Error, the linear solver of W does not support transposed solves!"
+        );
+      W_.push_back(W);
+    }
+  }
+
+  forwardWallTime_ = Teuchos::Time::wallTime() - startTime;
+  return x_.back();
+}
+
+
+template<class Scalar>
+void DiscreteAdjointBackwardEulerIntegrator<Scalar>::integrateAdjoint(
+  const Thyra::VectorBase<Scalar> &d_g_d_x,
+  const Ptr<Thyra::VectorBase<Scalar> > &d_g_d_x_init,
+  const Ptr<Thyra::VectorBase<Scalar> > &d_g_d_p
+  )
+{
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  typedef Thyra::ModelEvaluatorBase MEB;
+  assertForwardIntegrated();
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    nonnull(d_g_d_p) && p_index_ < 0, std::logic_error,
+    "Error, d_g_d_p needs a parameter index in initialize()!"
+    );
+
+  const double startTime = Teuchos::Time::wallTime();
+
+  if (is_null(DfDx_dot_))
+    DfDx_dot_ = fwdModel_->create_W_op();
+  if (nonnull(d_g_d_p) && is_null(DfDp_)) {
+    DfDp_ = Thyra::create_DfDp_mv(
+      *fwdModel_, p_index_, MEB::DERIV_MV_BY_COL
+      ).getMultiVector();
+  }
+
+  const RCP<Thyra::VectorBase<Scalar> > mu = d_g_d_x.clone_v();
+  const RCP<Thyra::VectorBase<Scalar> >
+    lambda = createMember(fwdModel_->get_f_space());
+  if (nonnull(d_g_d_p))
+    Thyra::V_S(d_g_d_p, ST::zero());
+
+  for (int n = getNumForwardSteps()-1; n >= 0; --n) {
+    const Scalar dt = stepTimes_[n+1] - stepTimes_[n];
+
+    // W(n)^T * lambda(n) = mu(n)
+    Thyra::V_S(lambda.ptr(), ST::zero());
+    const Thyra::SolveStatus<Scalar> solveStatus =
+      getW(n)->solve(Thyra::CONJTRANS, *mu, lambda.ptr());
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      solveStatus.solveStatus == Thyra::SOLVE_STATUS_UNCONVERGED,
+      std::runtime_error,
+      "Error, the transposed solve of the step ending at t = "
+      << stepTimes_[n+1] << " did not converge!"
+      );
+    ++numTransposedSolves_;
+
+    // d(f)/d(x_dot) and d(f)/d(p) at the end of the step
+    MEB::InArgs<Scalar> inArgs = fwdModel_->createInArgs();
+    MEB::OutArgs<Scalar> outArgs = fwdModel_->createOutArgs();
+    inArgs.setArgs(basePoint_);
+    inArgs.set_x_dot(x_dot_[n]);
+    inArgs.set_x(x_[n]);
+    inArgs.set_t(stepTimes_[n+1]);
+    inArgs.set_alpha(ST::one());
+    inArgs.set_beta(ST::zero());
+    outArgs.set_W_op(DfDx_dot_);
+    if (nonnull(d_g_d_p))
+      outArgs.set_DfDp(p_index_, MEB::Derivative<Scalar>(DfDp_,MEB::DERIV_MV_BY_COL));
+    fwdModel_->evalModel(inArgs,outArgs);
+
+    // d(g)/d(p)^T -= d(f)/d(p)^T * lambda(n)
+    if (nonnull(d_g_d_p)) {
+      Thyra::apply<Scalar>( *DfDp_, Thyra::CONJTRANS, *lambda, d_g_d_p,
+        -ST::one(), ST::one() );
+    }
+    // mu(n-1) = 1/dt * d(f)/d(x_dot)^T * lambda(n)
+    Thyra::apply<Scalar>( *DfDx_dot_, Thyra::CONJTRANS, *lambda, mu.ptr(),
+      ST::one()/dt, ST::zero() );
+  }
+
+  if (nonnull(d_g_d_x_init))
+    Thyra::V_V(d_g_d_x_init, *mu);
+
+  adjointWallTime_ = Teuchos::Time::wallTime() - startTime;
+}
+
+
+template<class Scalar>
+int DiscreteAdjointBackwardEulerIntegrator<Scalar>::getNumForwardSteps() const
+{
+  return x_.size();
+}
+
+
+template<class Scalar>
+int DiscreteAdjointBackwardEulerIntegrator<Scalar>::getNumTransposedSolves() const
+{
+  return numTransposedSolves_;
+}
+
+
+template<class Scalar>
+int DiscreteAdjointBackwardEulerIntegrator<Scalar>::getNumWEvaluations() const
+{
+  return numWEvaluations_;
+}
+
+
+template<class Scalar>
+double DiscreteAdjointBackwardEulerIntegrator<Scalar>::getForwardWallTime() const
+{
+  return forwardWallTime_;
+}
+
+
+template<class Scalar>
+double DiscreteAdjointBackwardEulerIntegrator<Scalar>::getAdjointWallTime() const
+{
+  return adjointWallTime_;
+}
+
+
+template<class Scalar>
+double DiscreteAdjointBackwardEulerIntegrator<Scalar>::getGradientCostRatio() const
+{
+  return forwardWallTime_ > 0.0 ? adjointWallTime_/forwardWallTime_ : 0.0;
+}
+
+
+// Overridden from Teuchos::ParameterListAcceptor
+
+
+template<class Scalar>
+void DiscreteAdjointBackwardEulerIntegrator<Scalar>::setParameterList(
+  RCP<ParameterList> const& paramList
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(paramList));
+  paramList->validateParameters(*getValidParameters());
+  this->setMyParamList(paramList);
+  storeW_ = paramList->get(storeW_name_, storeW_default_);
+  Teuchos::readVerboseObjectSublist(&*paramList,this);
+}
+
+
+template<class Scalar>
+RCP<const ParameterList>
+DiscreteAdjointBackwardEulerIntegrator<Scalar>::getValidParameters() const
+{
+  static RCP<const ParameterList> validPL;
+  if (is_null(validPL)) {
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set( storeW_name_, storeW_default_,
+      "Keep the factored W of each forward step and solve the adjoint with\n"
+      "its transpose.  If false, W is evaluated and factored again in each\n"
+      "adjoint step, which needs less memory."
+      );
+    Teuchos::setupVerboseObjectSublist(&*pl);
+    validPL = pl;
+  }
+  return validPL;
+}
+
+
+// Overridden from Teuchos::Describable
+
+
+template<class Scalar>
+std::string DiscreteAdjointBackwardEulerIntegrator<Scalar>::description() const
+{
+  std::ostringstream oss;
+  oss << "Rythmos::DiscreteAdjointBackwardEulerIntegrator{"
+      << "p_index=" << p_index_
+      << ",storeForwardW=" << storeW_
+      << ",numForwardSteps=" << getNumForwardSteps()
+      << "}";
+  return oss.str();
+}
+
+
+// private
+
+
+template<class Scalar>
+void DiscreteAdjointBackwardEulerIntegrator<Scalar>::assertForwardIntegrated() const
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    getNumForwardSteps() < 1, std::logic_error,
+    "Error, integrateForward() must be called first!"
+    );
+}
+
+
+template<class Scalar>
+RCP<const Thyra::LinearOpWithSolveBase<Scalar> >
+DiscreteAdjointBackwardEulerIntegrator<Scalar>::getW(const int n)
+{
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  typedef Thyra::ModelEvaluatorBase MEB;
+  if (n < Teuchos::as<int>(W_.size()))
+    return W_[n];
+  // W(n) = 1/dt*d(f)/d(x_dot) + d(f)/d(x) at the end of step n
+  if (is_null(W_compute_))
+    W_compute_ = fwdModel_->create_W();
+  MEB::InArgs<Scalar> inArgs = fwdModel_->createInArgs();
+  MEB::OutArgs<Scalar> outArgs = fwdModel_->createOutArgs();
+  inArgs.setArgs(basePoint_);
+  inArgs.set_x_dot(x_dot_[n]);
+  inArgs.set_x(x_[n]);
+  inArgs.set_t(stepTimes_[n+1]);
+  inArgs.set_alpha(ST::one()/(stepTimes_[n+1]-stepTimes_[n]));
+  inArgs.set_beta(ST::one());
+  outArgs.set_W(W_compute_);
+  fwdModel_->evalModel(inArgs,outArgs);
+  ++numWEvaluations_;
+  return W_compute_;
+}
+
+
+} // namespace Rythmos
+
+
+#endif // RYTHMOS_DISCRETE_ADJOINT_BACKWARD_EULER_INTEGRATOR_HPP
@@ -0,0 +1,17 @@
+#include "Rythmos_EnsembleIntegrationDriver_decl.hpp"
+
+#ifdef HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
+
+#include "Rythmos_EnsembleIntegrationDriver_def.hpp"
+#include "Rythmos_ExplicitInstantiationHelpers.hpp"
+
+namespace Rythmos {
+
+RYTHMOS_MACRO_TEMPLATE_INSTANT_SCALAR_TYPES(RYTHMOS_ENSEMBLE_INTEGRATION_DRIVER_INSTANT) 
+
+} // namespace Rythmos
+
+#endif // HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
+
+
+
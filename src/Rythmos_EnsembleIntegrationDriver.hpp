@@ -0,0 +1,5 @@
+#include "Rythmos_EnsembleIntegrationDriver_decl.hpp"
+#ifndef HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
+#include "Rythmos_EnsembleIntegrationDriver_def.hpp"
+#endif
+
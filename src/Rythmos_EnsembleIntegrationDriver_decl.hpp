@@ -0,0 +1,274 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_ENSEMBLE_INTEGRATION_DRIVER_DECL_H
+#define Rythmos_ENSEMBLE_INTEGRATION_DRIVER_DECL_H
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_IntegratorBase.hpp"
+#include "Rythmos_ThreadPool.hpp"
+#include "Thyra_ModelEvaluator.hpp"
+#include "Thyra_NonlinearSolverBase.hpp"
+#include "Thyra_MultiVectorBase.hpp"
+#include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
+#include "Teuchos_Describable.hpp"
+
+#include <deque>
+
+#ifdef HAVE_RYTHMOS_THREADS
+#  include <mutex>
+#endif
+
+
+namespace Rythmos {
+
+
+/** \brief Work done by one thread of an
+ * <tt>EnsembleIntegrationDriver</tt> in the last call to
+ * <tt>integrate()</tt>. */
+struct EnsembleThreadStatistics {
+  /** \brief Number of members integrated. */
+  int numMembers;
+  /** \brief Number of those members taken from another thread's queue. */
+  int numStolenMembers;
+  /** \brief Number of accepted time steps. */
+  int numSteps;
+  /** \brief Seconds spent integrating members. */
+  double busyTime;
+  /** \brief <tt>busyTime</tt> divided by the wall time of the whole
+   * <tt>integrate()</tt> call. */
+  double utilization;
+  /** \brief . */
+  EnsembleThreadStatistics()
+    :numMembers(0), numStolenMembers(0), numSteps(0),
+     busyTime(0.0), utilization(0.0)
+    {}
+};
+
+
+/** \brief Integrates an ensemble of independent runs of one model that
+ * differ only in the value of one parameter vector, spread over a pool of
+ * threads.
+ *
+ * The driver builds a prototype integrator from an
+ * <tt>IntegratorBuilder</tt> parameter list.  Each thread gets its own copy
+ * of the integrator and stepper from <tt>cloneIntegrator()</tt> and
+ * <tt>cloneStepperAlgorithm()</tt>, made once on the calling thread and
+ * kept between calls to <tt>integrate()</tt>.  A member is run by resetting
+ * the initial condition of the thread's stepper, so the stepper's work
+ * vectors are reused from member to member and a thread never touches
+ * another thread's vectors.  The solution at the output times is copied
+ * into multi-vectors that the caller allocates up front.
+ *
+ * The members are handed out in contiguous blocks, one block per thread.  A
+ * thread takes members from the front of its own queue and, once the queue
+ * is empty, steals from the back of the other threads' queues, so runs whose
+ * adaptive step counts differ by orders of magnitude still keep all the
+ * threads busy.  <tt>getThreadStatistics()</tt> reports the members, steps
+ * and utilization of each thread.
+ *
+ * Without thread support (<tt>HAVE_RYTHMOS_THREADS</tt>) the members are
+ * integrated one after the other on the calling thread.
+ *
+ * Thread safety requirements: the model is shared by all threads, so its
+ * <tt>evalModel()</tt> must be safe to call concurrently on different
+ * arguments, which is true of models that keep no mutable state.  The
+ * threads come from a <tt>ThreadPool</tt>, so with the Teuchos time monitor
+ * only the members integrated on the calling thread are timed.  Integration
+ * observers are cloned with the integrator;
+ * <tt>LoggingIntegrationObserver</tt> clones keep their own log, but
+ * observers that share output streams or other state between clones must
+ * synchronize it themselves.  Breakpoint informers are shared
+ * and only queried.
+ */
+template<class Scalar>
+class EnsembleIntegrationDriver
+  : virtual public Teuchos::Describable,
+    virtual public Teuchos::ParameterListAcceptorDefaultBase
+{
+public:
+
+  /** \name Constructors/Initializers/Accessors */
+  //@{
+
+  /** \brief . */
+  EnsembleIntegrationDriver();
+
+  /** \brief Build the prototype integrator.
+   *
+   * \param model [in] The model, shared by all members.
+   *
+   * \param initialCondition [in] Initial condition of every member, except
+   * for parameter vector "Parameter Index" which is set per member.
+   *
+   * \param nlSolver [in] Nonlinear solver for implicit steppers, cloned for
+   * each thread.  May be null for explicit steppers.
+   *
+   * \param integratorBuilderPL [in] Parameter list for
+   * <tt>IntegratorBuilder</tt>.
+   */
+  void initialize(
+    const RCP<const Thyra::ModelEvaluator<Scalar> > &model,
+    const Thyra::ModelEvaluatorBase::InArgs<Scalar> &initialCondition,
+    const RCP<Thyra::NonlinearSolverBase<Scalar> > &nlSolver,
+    const RCP<ParameterList> &integratorBuilderPL
+    );
+
+  /** \brief . */
+  RCP<const IntegratorBase<Scalar> > getPrototypeIntegrator() const;
+
+  /** \brief Integrate one member per parameter vector.
+   *
+   * \param memberParams [in] Value of parameter vector "Parameter Index" for
+   * each member.
+   *
+   * \param time_vec [in] Sorted output times in the integration time range.
+   *
+   * \param x_out [out] Preallocated multi-vectors, one per member with one
+   * column per output time.  On output <tt>x_out[k]->col(i)</tt> is the
+   * solution of member <tt>k</tt> at <tt>time_vec[i]</tt>.
+   *
+   * An exception thrown by any member is rethrown here once all threads
+   * have stopped.
+   */
+  void integrate(
+    const Array<RCP<const Thyra::VectorBase<Scalar> > > &memberParams,
+    const Array<Scalar> &time_vec,
+    const Array<RCP<Thyra::MultiVectorBase<Scalar> > > &x_out
+    );
+
+  /** \brief Number of threads used by the last <tt>integrate()</tt>. */
+  int getNumThreads() const;
+
+  /** \brief Statistics of each thread in the last <tt>integrate()</tt>. */
+  const Array<EnsembleThreadStatistics>& getThreadStatistics() const;
+
+  /** \brief Number of accepted time steps of each member in the last
+   * <tt>integrate()</tt>. */
+  const Array<int>& getMemberNumSteps() const;
+
+  /** \brief Wall time in seconds of the last <tt>integrate()</tt>. */
+  double getWallTime() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::ParameterListAcceptor */
+  //@{
+
+  /** \brief . */
+  void setParameterList(RCP<ParameterList> const& paramList);
+
+  /** \brief . */
+  RCP<const ParameterList> getValidParameters() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::Describable */
+  //@{
+
+  /** \brief . */
+  std::string description() const;
+
+  //@}
+
+private:
+
+  // Integrator, stepper and member queue owned by one thread.
+  struct ThreadWorkspace {
+    RCP<IntegratorBase<Scalar> > integrator;
+    RCP<StepperBase<Scalar> > stepper;
+    Thyra::ModelEvaluatorBase::InArgs<Scalar> initialCondition;
+    std::deque<int> queue;
+#ifdef HAVE_RYTHMOS_THREADS
+    std::mutex queueMutex;
+#endif
+  };
+
+  RCP<const Thyra::ModelEvaluator<Scalar> > model_;
+  Thyra::ModelEvaluatorBase::InArgs<Scalar> initialCondition_;
+  RCP<IntegratorBase<Scalar> > prototype_;
+  Scalar finalTime_;
+  bool landOnFinalTime_;
+
+  int numThreadsRequested_;
+  int paramIndex_;
+
+  Array<RCP<ThreadWorkspace> > workspaces_;
+#ifdef HAVE_RYTHMOS_THREADS
+  RCP<ThreadPool> threadPool_;
+#endif
+
+  int numThreads_;
+  Array<EnsembleThreadStatistics> threadStats_;
+  Array<int> memberNumSteps_;
+  double wallTime_;
+
+  static const std::string numThreads_name_;
+  static const int numThreads_default_;
+
+  static const std::string paramIndex_name_;
+  static const int paramIndex_default_;
+
+  void runThread(
+    const int threadIndex,
+    const Array<RCP<const Thyra::VectorBase<Scalar> > > &memberParams,
+    const Array<Scalar> &time_vec,
+    const Array<RCP<Thyra::MultiVectorBase<Scalar> > > &x_out
+    );
+
+  bool takeMember(const int threadIndex, int *member, bool *stolen);
+
+  void integrateMember(
+    ThreadWorkspace &workspace,
+    const RCP<const Thyra::VectorBase<Scalar> > &p,
+    const Array<Scalar> &time_vec,
+    const RCP<Thyra::MultiVectorBase<Scalar> > &x_out,
+    int *numSteps
+    );
+
+};
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates EnsembleIntegrationDriver
+ */
+template<class Scalar>
+RCP<EnsembleIntegrationDriver<Scalar> >
+ensembleIntegrationDriver(
+  const RCP<const Thyra::ModelEvaluator<Scalar> > &model,
+  const Thyra::ModelEvaluatorBase::InArgs<Scalar> &initialCondition,
+  const RCP<Thyra::NonlinearSolverBase<Scalar> > &nlSolver,
+  const RCP<ParameterList> &integratorBuilderPL,
+  const RCP<ParameterList> &paramList = Teuchos::null
+  );
+
+
+} // namespace Rythmos
+
+#endif //Rythmos_ENSEMBLE_INTEGRATION_DRIVER_DECL_H
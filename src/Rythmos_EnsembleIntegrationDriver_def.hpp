@@ -0,0 +1,464 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_ENSEMBLE_INTEGRATION_DRIVER_DEF_H
+#define Rythmos_ENSEMBLE_INTEGRATION_DRIVER_DEF_H
+
+#include "Rythmos_EnsembleIntegrationDriver_decl.hpp"
+#include "Rythmos_IntegratorBuilder.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+
+#include "Teuchos_Time.hpp"
+
+#include <algorithm>
+
+#ifdef HAVE_RYTHMOS_THREADS
+#  include <thread>
+#endif
+
+
+namespace Rythmos {
+
+
+// Nonmember constructors
+
+
+template<class Scalar>
+RCP<EnsembleIntegrationDriver<Scalar> >
+ensembleIntegrationDriver(
+  const RCP<const Thyra::ModelEvaluator<Scalar> > &model,
+  const Thyra::ModelEvaluatorBase::InArgs<Scalar> &initialCondition,
+  const RCP<Thyra::NonlinearSolverBase<Scalar> > &nlSolver,
+  const RCP<ParameterList> &integratorBuilderPL,
+  const RCP<ParameterList> &paramList
+  )
+{
+  RCP<EnsembleIntegrationDriver<Scalar> >
+    driver = Teuchos::rcp(new EnsembleIntegrationDriver<Scalar>());
+  if (!is_null(paramList))
+    driver->setParameterList(paramList);
+  driver->initialize(model,initialCondition,nlSolver,integratorBuilderPL);
+  return driver;
+}
+
+
+//
+// Definitions
+//
+
+
+// Static members
+
+
+template<class Scalar>
+const std::string
+EnsembleIntegrationDriver<Scalar>::numThreads_name_
+= "Number of Threads";
+
+template<class Scalar>
+const int
+EnsembleIntegrationDriver<Scalar>::numThreads_default_
+= 0;
+
+template<class Scalar>
+const std::string
+EnsembleIntegrationDriver<Scalar>::paramIndex_name_
+= "Parameter Index";
+
+template<class Scalar>
+const int
+EnsembleIntegrationDriver<Scalar>::paramIndex_default_
+= 0;
+
+
+// Constructors/Initializers/Accessors
+
+
+template<class Scalar>
+EnsembleIntegrationDriver<Scalar>::EnsembleIntegrationDriver()
+  :finalTime_(Teuchos::ScalarTraits<Scalar>::zero()),
+   landOnFinalTime_(true),
+   numThreadsRequested_(numThreads_default_),
+   paramIndex_(paramIndex_default_),
+   numThreads_(0),
+   wallTime_(0.0)
+{}
+
+
+template<class Scalar>
+void EnsembleIntegrationDriver<Scalar>::initialize(
+  const RCP<const Thyra::ModelEvaluator<Scalar> > &model,
+  const Thyra::ModelEvaluatorBase::InArgs<Scalar> &initialCondition,
+  const RCP<Thyra::NonlinearSolverBase<Scalar> > &nlSolver,
+  const RCP<ParameterList> &integratorBuilderPL
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(model));
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(integratorBuilderPL));
+
+  RCP<IntegratorBuilder<Scalar> > builder = integratorBuilder<Scalar>();
+  builder->setParameterList(integratorBuilderPL);
+  const RCP<IntegratorBase<Scalar> >
+    prototype = builder->create(model,initialCondition,nlSolver);
+
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(prototype->getStepper()), std::logic_error,
+    "Error, EnsembleIntegrationDriver::initialize(...):  The integrator"
+    " built from the parameter list has no stepper!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !prototype->getStepper()->supportsCloning(), std::logic_error,
+    "Error, EnsembleIntegrationDriver::initialize(...):  The stepper "
+    << prototype->getStepper()->description()
+    << " does not support cloning!"
+    );
+
+  model_ = model;
+  initialCondition_ = initialCondition;
+  prototype_ = prototype;
+  finalTime_ = prototype_->getFwdTimeRange().upper();
+  // The builder has already filled in the default if it was not given.
+  landOnFinalTime_ = integratorBuilderPL->sublist("Integrator Settings")
+    .get<bool>("Land On Final Time",true);
+  workspaces_.clear();
+}
+
+
+template<class Scalar>
+RCP<const IntegratorBase<Scalar> >
+EnsembleIntegrationDriver<Scalar>::getPrototypeIntegrator() const
+{
+  return prototype_;
+}
+
+
+template<class Scalar>
+void EnsembleIntegrationDriver<Scalar>::integrate(
+  const Array<RCP<const Thyra::VectorBase<Scalar> > > &memberParams,
+  const Array<Scalar> &time_vec,
+  const Array<RCP<Thyra::MultiVectorBase<Scalar> > > &x_out
+  )
+{
+
+  using Teuchos::as;
+
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(prototype_), std::logic_error,
+    "Error, EnsembleIntegrationDriver::integrate(...):  initialize() must"
+    " be called first!"
+    );
+  const int numMembers = as<int>(memberParams.size());
+  const int numTimes = as<int>(time_vec.size());
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    as<int>(x_out.size()) != numMembers, std::logic_error,
+    "Error, EnsembleIntegrationDriver::integrate(...):  There are "
+    << numMembers << " members but x_out.size() = " << x_out.size() << "!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    paramIndex_ >= initialCondition_.Np(), std::logic_error,
+    "Error, EnsembleIntegrationDriver::integrate(...):  \""
+    << paramIndex_name_ << "\" = " << paramIndex_
+    << " but the model only has " << initialCondition_.Np()
+    << " parameter vectors!"
+    );
+  for (int k = 0; k < numMembers; ++k) {
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      is_null(memberParams[k]), std::logic_error,
+      "Error, EnsembleIntegrationDriver::integrate(...):  The parameters of"
+      " member " << k << " are null!"
+      );
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      is_null(x_out[k]) || x_out[k]->domain()->dim() != numTimes,
+      std::logic_error,
+      "Error, EnsembleIntegrationDriver::integrate(...):  x_out[" << k
+      << "] must have one column for each of the " << numTimes
+      << " output times!"
+      );
+  }
+
+  // Never start more threads than there are members.
+  int numThreads = 1;
+#ifdef HAVE_RYTHMOS_THREADS
+  numThreads = numThreadsRequested_;
+  if (numThreads == 0)
+    numThreads = std::max(as<int>(std::thread::hardware_concurrency()), 1);
+#endif
+  numThreads = std::max(std::min(numThreads, numMembers), 1);
+
+  // The clones are made here on the calling thread since cloning reads the
+  // prototype, which is shared by all threads.
+  for (int i = as<int>(workspaces_.size()); i < numThreads; ++i) {
+    RCP<ThreadWorkspace> workspace = Teuchos::rcp(new ThreadWorkspace);
+    workspace->integrator = prototype_->cloneIntegrator();
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      is_null(workspace->integrator), std::logic_error,
+      "Error, EnsembleIntegrationDriver::integrate(...):  The integrator "
+      << prototype_->description() << " does not support cloning!"
+      );
+    workspace->stepper =
+      prototype_->getStepper()->cloneStepperAlgorithm().assert_not_null();
+    workspace->initialCondition = model_->createInArgs();
+    workspace->initialCondition.setArgs(initialCondition_);
+    workspaces_.push_back(workspace);
+  }
+
+  // Hand out the members in contiguous blocks.
+  for (int i = 0; i < numThreads; ++i) {
+    workspaces_[i]->queue.clear();
+  }
+  for (int k = 0; k < numMembers; ++k) {
+    workspaces_[(as<long>(k)*numThreads)/numMembers]->queue.push_back(k);
+  }
+
+  numThreads_ = numThreads;
+  threadStats_.assign(numThreads, EnsembleThreadStatistics());
+  memberNumSteps_.assign(numMembers, 0);
+
+  const double startTime = Teuchos::Time::wallTime();
+
+#ifdef HAVE_RYTHMOS_THREADS
+  if (is_null(threadPool_) || threadPool_->getNumThreads() != numThreads)
+    threadPool_ = Teuchos::rcp(new ThreadPool(numThreads));
+  threadPool_->run(
+    [this, &memberParams, &time_vec, &x_out](int i) {
+      runThread(i,memberParams,time_vec,x_out);
+    });
+#else
+  runThread(0,memberParams,time_vec,x_out);
+#endif
+
+  wallTime_ = Teuchos::Time::wallTime() - startTime;
+  for (int i = 0; i < numThreads; ++i) {
+    threadStats_[i].utilization =
+      ( wallTime_ > 0.0 ? threadStats_[i].busyTime/wallTime_ : 1.0 );
+  }
+
+}
+
+
+template<class Scalar>
+int EnsembleIntegrationDriver<Scalar>::getNumThreads() const
+{
+  return numThreads_;
+}
+
+
+template<class Scalar>
+const Array<EnsembleThreadStatistics>&
+EnsembleIntegrationDriver<Scalar>::getThreadStatistics() const
+{
+  return threadStats_;
+}
+
+
+template<class Scalar>
+const Array<int>&
+EnsembleIntegrationDriver<Scalar>::getMemberNumSteps() const
+{
+  return memberNumSteps_;
+}
+
+
+template<class Scalar>
+double EnsembleIntegrationDriver<Scalar>::getWallTime() const
+{
+  return wallTime_;
+}
+
+
+// Overridden from ParameterListAcceptor
+
+
+template<class Scalar>
+void EnsembleIntegrationDriver<Scalar>::setParameterList(
+  RCP<ParameterList> const& paramList
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(paramList));
+  paramList->validateParametersAndSetDefaults(*getValidParameters());
+  const int numThreads = paramList->get<int>(numThreads_name_);
+  const int paramIndex = paramList->get<int>(paramIndex_name_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    numThreads < 0, std::logic_error,
+    "Error, EnsembleIntegrationDriver::setParameterList(...):  \""
+    << numThreads_name_ << "\" = " << numThreads << " must be >= 0!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    paramIndex < 0, std::logic_error,
+    "Error, EnsembleIntegrationDriver::setParameterList(...):  \""
+    << paramIndex_name_ << "\" = " << paramIndex << " must be >= 0!"
+    );
+  numThreadsRequested_ = numThreads;
+  paramIndex_ = paramIndex;
+  this->setMyParamList(paramList);
+}
+
+
+template<class Scalar>
+RCP<const ParameterList>
+EnsembleIntegrationDriver<Scalar>::getValidParameters() const
+{
+  static RCP<const ParameterList> validPL;
+  if (is_null(validPL)) {
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set(
+      numThreads_name_, numThreads_default_,
+      "Number of threads that integrate the members.  Zero uses one thread\n"
+      "per hardware thread.  This is ignored unless Rythmos was built with\n"
+      "thread support."
+      );
+    pl->set(
+      paramIndex_name_, paramIndex_default_,
+      "Index of the model parameter vector that is set for each member."
+      );
+    validPL = pl;
+  }
+  return validPL;
+}
+
+
+// Overridden from Teuchos::Describable
+
+
+template<class Scalar>
+std::string EnsembleIntegrationDriver<Scalar>::description() const
+{
+  return "Rythmos::EnsembleIntegrationDriver";
+}
+
+
+// private
+
+
+template<class Scalar>
+void EnsembleIntegrationDriver<Scalar>::runThread(
+  const int threadIndex,
+  const Array<RCP<const Thyra::VectorBase<Scalar> > > &memberParams,
+  const Array<Scalar> &time_vec,
+  const Array<RCP<Thyra::MultiVectorBase<Scalar> > > &x_out
+  )
+{
+  ThreadWorkspace &workspace = *workspaces_[threadIndex];
+  EnsembleThreadStatistics &stats = threadStats_[threadIndex];
+  int member = -1;
+  bool stolen = false;
+  while (takeMember(threadIndex,&member,&stolen)) {
+    const double startTime = Teuchos::Time::wallTime();
+    integrateMember(workspace,memberParams[member],time_vec,x_out[member],
+      &memberNumSteps_[member]);
+    stats.busyTime += Teuchos::Time::wallTime() - startTime;
+    stats.numSteps += memberNumSteps_[member];
+    ++stats.numMembers;
+    if (stolen)
+      ++stats.numStolenMembers;
+  }
+}
+
+
+template<class Scalar>
+bool EnsembleIntegrationDriver<Scalar>::takeMember(
+  const int threadIndex, int *member, bool *stolen
+  )
+{
+  // Members are never added during a run, so once every queue has been
+  // seen empty there is nothing left to do.
+  for (int j = 0; j < numThreads_; ++j) {
+    const int victim = (threadIndex + j) % numThreads_;
+    ThreadWorkspace &workspace = *workspaces_[victim];
+#ifdef HAVE_RYTHMOS_THREADS
+    std::lock_guard<std::mutex> lock(workspace.queueMutex);
+#endif
+    if (workspace.queue.empty())
+      continue;
+    if (j == 0) {
+      *member = workspace.queue.front();
+      workspace.queue.pop_front();
+    }
+    else {
+      *member = workspace.queue.back();
+      workspace.queue.pop_back();
+    }
+    *stolen = (j != 0);
+    return true;
+  }
+  return false;
+}
+
+
+template<class Scalar>
+void EnsembleIntegrationDriver<Scalar>::integrateMember(
+  ThreadWorkspace &workspace,
+  const RCP<const Thyra::VectorBase<Scalar> > &p,
+  const Array<Scalar> &time_vec,
+  const RCP<Thyra::MultiVectorBase<Scalar> > &x_out,
+  int *numSteps
+  )
+{
+  workspace.initialCondition.set_p(paramIndex_,p);
+  workspace.stepper->setInitialCondition(workspace.initialCondition);
+  const int numStepsBefore =
+    workspace.stepper->getPerformanceCounters().numSteps;
+  workspace.integrator->setStepper(workspace.stepper,finalTime_,
+    landOnFinalTime_);
+
+  Array<RCP<const Thyra::VectorBase<Scalar> > > x_vec;
+  workspace.integrator->getFwdPoints(time_vec,&x_vec,NULL,NULL);
+  for (int i = 0; i < Teuchos::as<int>(time_vec.size()); ++i) {
+    Thyra::V_V(x_out->col(i).ptr(),*x_vec[i]);
+  }
+
+  *numSteps = workspace.stepper->getPerformanceCounters().numSteps
+    - numStepsBefore;
+}
+
+
+//
+// Explicit Instantiation macro
+//
+// Must be expanded from within the Rythmos namespace!
+//
+
+#define RYTHMOS_ENSEMBLE_INTEGRATION_DRIVER_INSTANT(SCALAR) \
+  \
+  template class EnsembleIntegrationDriver< SCALAR >; \
+  \
+  template RCP<EnsembleIntegrationDriver< SCALAR > > \
+  ensembleIntegrationDriver( \
+    const RCP<const Thyra::ModelEvaluator< SCALAR > > &model, \
+    const Thyra::ModelEvaluatorBase::InArgs< SCALAR > &initialCondition, \
+    const RCP<Thyra::NonlinearSolverBase< SCALAR > > &nlSolver, \
+    const RCP<ParameterList> &integratorBuilderPL, \
+    const RCP<ParameterList> &paramList \
+    );
+
+
+} // namespace Rythmos
+
+
+#endif //Rythmos_ENSEMBLE_INTEGRATION_DRIVER_DEF_H
@@ -0,0 +1,522 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef RYTHMOS_ENSEMBLE_MODEL_EVALUATOR_HPP
+#define RYTHMOS_ENSEMBLE_MODEL_EVALUATOR_HPP
+
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_EnsembleVectorSpace.hpp"
+#include "Thyra_StateFuncModelEvaluatorBase.hpp"
+#include "Thyra_DefaultBlockedLinearOp.hpp"
+#include "Thyra_DefaultBlockedTriangularLinearOpWithSolveFactory.hpp" // Default implementation
+#include "Thyra_VectorStdOps.hpp"
+
+
+namespace Rythmos {
+
+
+/** \brief Transient <tt>ModelEvaluator</tt> subclass that advances an
+ * ensemble of independent copies of one model in lockstep.
+ *
+ * Each member <tt>k</tt> of the ensemble is the member model evaluated at its
+ * own point <tt>memberPoints[k]</tt>, which gives the initial condition and
+ * the parameters of that member.  The state of the ensemble is a
+ * <tt>Thyra::MultiVectorBase</tt> with one column per member, flattened into
+ * a vector as
+
+ \verbatim
+
+   x_bar = [ X(:,0); X(:,1); ...; X(:,numMembers-1) ]
+
+            [ f(X_dot(:,0),X(:,0),{p_l}_0,t)                       ]
+   f_bar =  [ ...                                                  ]
+            [ f(X_dot(:,numMembers-1),X(:,numMembers-1),{p_l}_N-1,t) ]
+
+ \endverbatim
+
+ * so that any stepper can integrate the ensemble as one model, with one
+ * stepper, integrator and set of parameter lists for the whole ensemble.
+ * The stepper then does its bookkeeping and its vector operations once per
+ * step for all members instead of once per member.  The ensemble vectors
+ * come from an <tt>EnsembleVectorSpace</tt>, which for a serial member space
+ * stores <tt>X</tt> in one contiguous array, so a norm or an axpy of the
+ * stepper is a single RTOp over all members.  <tt>f_bar</tt> is computed with
+ * one call to the member model's <tt>evalModel()</tt> per column, with
+ * member <tt>InArgs</tt> and <tt>OutArgs</tt> that are set up once in
+ * <tt>initialize()</tt> and of which only the state, time, <tt>alpha</tt>,
+ * <tt>beta</tt> and outputs are reset on each evaluation.  For an implicit
+ * member model <tt>W_bar</tt> is block diagonal with the member <tt>W</tt>
+ * on the diagonal and is solved block by block with the member <tt>W</tt>
+ * factory.
+ *
+ * All members share the step sizes chosen by the stepper, so the error
+ * control of an adaptive stepper is driven by the whole ensemble.  Members
+ * that need very different step sizes are better integrated separately.
+ */
+template<class Scalar>
+class EnsembleModelEvaluator
+  : virtual public Thyra::StateFuncModelEvaluatorBase<Scalar>
+{
+public:
+
+  /** \name Constructors/initializers/accessors */
+  //@{
+
+  /** \brief . */
+  EnsembleModelEvaluator();
+
+  /** \brief Initialize with the member model and one point per member.
+   *
+   * Each point must give <tt>x</tt> (and <tt>x_dot</tt> for an implicit
+   * member model) and all points must have the same <tt>t</tt>.
+   */
+  void initialize(
+    const RCP<const Thyra::ModelEvaluator<Scalar> > &memberModel,
+    const Array<Thyra::ModelEvaluatorBase::InArgs<Scalar> > &memberPoints
+    );
+
+  /** \brief . */
+  RCP<const Thyra::ModelEvaluator<Scalar> > getMemberModel() const;
+
+  /** \brief . */
+  int getNumMembers() const;
+
+  /** \brief . */
+  const Thyra::ModelEvaluatorBase::InArgs<Scalar>&
+  getMemberPoint(const int k) const;
+
+  /** \brief The multi-vector with one column per member of an ensemble
+   * vector, e.g. a state returned by the stepper. */
+  RCP<const Thyra::MultiVectorBase<Scalar> >
+  getMemberStates(const RCP<const Thyra::VectorBase<Scalar> > &x_bar) const;
+
+  //@}
+
+  /** \name Public functions overridden from ModelEvaluator */
+  //@{
+
+  /** \brief . */
+  RCP<const Thyra::VectorSpaceBase<Scalar> > get_x_space() const;
+  /** \brief . */
+  RCP<const Thyra::VectorSpaceBase<Scalar> > get_f_space() const;
+  /** \brief . */
+  RCP<Thyra::LinearOpBase<Scalar> > create_W_op() const;
+  /** \brief . */
+  RCP<const Thyra::LinearOpWithSolveFactoryBase<Scalar> > get_W_factory() const;
+  /** \brief . */
+  Thyra::ModelEvaluatorBase::InArgs<Scalar> getNominalValues() const;
+  /** \brief . */
+  Thyra::ModelEvaluatorBase::InArgs<Scalar> createInArgs() const;
+
+  //@}
+
+private:
+
+  /** \name Private functions overridden from ModelEvaluatorDefaultBase */
+  //@{
+
+  /** \brief . */
+  Thyra::ModelEvaluatorBase::OutArgs<Scalar> createOutArgsImpl() const;
+  /** \brief . */
+  void evalModelImpl(
+    const Thyra::ModelEvaluatorBase::InArgs<Scalar>& inArgs_bar,
+    const Thyra::ModelEvaluatorBase::OutArgs<Scalar>& outArgs_bar
+    ) const;
+
+  //@}
+
+private:
+
+  RCP<const Thyra::ModelEvaluator<Scalar> > memberModel_;
+  Array<Thyra::ModelEvaluatorBase::InArgs<Scalar> > memberPoints_;
+
+  RCP<const EnsembleVectorSpace<Scalar> > x_bar_space_;
+  RCP<const EnsembleVectorSpace<Scalar> > f_bar_space_;
+  RCP<Thyra::LinearOpWithSolveFactoryBase<Scalar> > W_bar_factory_;
+  Thyra::ModelEvaluatorBase::InArgs<Scalar> nominalValues_;
+
+  // The args of each member, set up with its point in initialize()
+  mutable Array<Thyra::ModelEvaluatorBase::InArgs<Scalar> > memberInArgs_;
+  mutable Array<Thyra::ModelEvaluatorBase::OutArgs<Scalar> > memberOutArgs_;
+
+  static RCP<const Thyra::VectorBase<Scalar> > getMemberVector(
+    const RCP<const Thyra::VectorBase<Scalar> > &v_bar, const int k );
+  static RCP<Thyra::VectorBase<Scalar> > getNonconstMemberVector(
+    const RCP<Thyra::VectorBase<Scalar> > &v_bar, const int k );
+
+};
+
+
+/** \brief Non-member constructor.
+ *
+ * \relates EnsembleModelEvaluator
+ */
+template<class Scalar>
+RCP<EnsembleModelEvaluator<Scalar> >
+ensembleModelEvaluator(
+  const RCP<const Thyra::ModelEvaluator<Scalar> > &memberModel,
+  const Array<Thyra::ModelEvaluatorBase::InArgs<Scalar> > &memberPoints
+  )
+{
+  RCP<EnsembleModelEvaluator<Scalar> >
+    model = Teuchos::rcp(new EnsembleModelEvaluator<Scalar>());
+  model->initialize(memberModel,memberPoints);
+  return model;
+}
+
+
+// ///////////////////////
+// Definition
+
+
+// Constructors/initializers/accessors
+
+
+template<class Scalar>
+EnsembleModelEvaluator<Scalar>::EnsembleModelEvaluator()
+{}
+
+
+template<class Scalar>
+void EnsembleModelEvaluator<Scalar>::initialize(
+  const RCP<const Thyra::ModelEvaluator<Scalar> > &memberModel,
+  const Array<Thyra::ModelEvaluatorBase::InArgs<Scalar> > &memberPoints
+  )
+{
+
+  typedef Thyra::ModelEvaluatorBase MEB;
+  using Teuchos::as;
+
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(memberModel));
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    memberPoints.size() == 0, std::logic_error,
+    "Error, the ensemble must have at least one member!"
+    );
+
+  const int numMembers = memberPoints.size();
+  const MEB::InArgs<Scalar> memberInArgs = memberModel->createInArgs();
+  const bool isImplicit = memberInArgs.supports(MEB::IN_ARG_x_dot);
+  for (int k = 0; k < numMembers; ++k) {
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      is_null(memberPoints[k].get_x()), std::logic_error,
+      "Error, the point of member " << k << " does not give x!"
+      );
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      isImplicit && is_null(memberPoints[k].get_x_dot()), std::logic_error,
+      "Error, the point of member " << k << " does not give x_dot!"
+      );
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      memberInArgs.supports(MEB::IN_ARG_t)
+      && memberPoints[k].get_t() != memberPoints[0].get_t(),
+      std::logic_error,
+      "Error, member " << k << " starts at t = " << memberPoints[k].get_t()
+      << " but member 0 starts at t = " << memberPoints[0].get_t() << "!"
+      );
+  }
+
+  memberModel_ = memberModel;
+  memberPoints_ = memberPoints;
+
+  x_bar_space_ = ensembleVectorSpace<Scalar>(
+    memberModel_->get_x_space(), numMembers
+    );
+  f_bar_space_ = ensembleVectorSpace<Scalar>(
+    memberModel_->get_f_space(), numMembers
+    );
+
+  memberInArgs_.resize(numMembers);
+  memberOutArgs_.resize(numMembers);
+  for (int k = 0; k < numMembers; ++k) {
+    memberInArgs_[k] = memberModel_->createInArgs();
+    memberInArgs_[k].setArgs(memberPoints_[k]);
+    memberOutArgs_[k] = memberModel_->createOutArgs();
+  }
+
+  W_bar_factory_ = Teuchos::null;
+  if (nonnull(memberModel_->get_W_factory())) {
+    W_bar_factory_ =
+      Thyra::defaultBlockedTriangularLinearOpWithSolveFactory<Scalar>(
+        memberModel_->get_W_factory()
+        );
+  }
+
+  // The nominal values stack up the initial conditions of the members.
+  nominalValues_ = this->createInArgs();
+  const RCP<Thyra::VectorBase<Scalar> >
+    x_bar = Thyra::createMember<Scalar>(x_bar_space_);
+  RCP<Thyra::VectorBase<Scalar> > x_dot_bar;
+  if (isImplicit)
+    x_dot_bar = Thyra::createMember<Scalar>(x_bar_space_);
+  for (int k = 0; k < numMembers; ++k) {
+    Thyra::V_V(getNonconstMemberVector(x_bar,k).ptr(),
+      *memberPoints_[k].get_x());
+    if (isImplicit) {
+      Thyra::V_V(getNonconstMemberVector(x_dot_bar,k).ptr(),
+        *memberPoints_[k].get_x_dot());
+    }
+  }
+  nominalValues_.set_x(x_bar);
+  if (isImplicit)
+    nominalValues_.set_x_dot(x_dot_bar);
+  if (nominalValues_.supports(MEB::IN_ARG_t))
+    nominalValues_.set_t(memberPoints_[0].get_t());
+
+}
+
+
+template<class Scalar>
+RCP<const Thyra::ModelEvaluator<Scalar> >
+EnsembleModelEvaluator<Scalar>::getMemberModel() const
+{
+  return memberModel_;
+}
+
+
+template<class Scalar>
+int EnsembleModelEvaluator<Scalar>::getNumMembers() const
+{
+  return memberPoints_.size();
+}
+
+
+template<class Scalar>
+const Thyra::ModelEvaluatorBase::InArgs<Scalar>&
+EnsembleModelEvaluator<Scalar>::getMemberPoint(const int k) const
+{
+  return memberPoints_[k];
+}
+
+
+template<class Scalar>
+RCP<const Thyra::MultiVectorBase<Scalar> >
+EnsembleModelEvaluator<Scalar>::getMemberStates(
+  const RCP<const Thyra::VectorBase<Scalar> > &x_bar
+  ) const
+{
+  return Teuchos::rcp_dynamic_cast<
+    const Thyra::DefaultMultiVectorProductVector<Scalar> >(
+      x_bar.assert_not_null(), true
+      )->getMultiVector();
+}
+
+
+// Public functions overridden from ModelEvaluator
+
+
+template<class Scalar>
+RCP<const Thyra::VectorSpaceBase<Scalar> >
+EnsembleModelEvaluator<Scalar>::get_x_space() const
+{
+  return x_bar_space_;
+}
+
+
+template<class Scalar>
+RCP<const Thyra::VectorSpaceBase<Scalar> >
+EnsembleModelEvaluator<Scalar>::get_f_space() const
+{
+  return f_bar_space_;
+}
+
+
+template<class Scalar>
+RCP<Thyra::LinearOpBase<Scalar> >
+EnsembleModelEvaluator<Scalar>::create_W_op() const
+{
+  RCP<Thyra::PhysicallyBlockedLinearOpBase<Scalar> >
+    W_op_bar = Thyra::defaultBlockedLinearOp<Scalar>();
+  W_op_bar->beginBlockFill( f_bar_space_, x_bar_space_ );
+  for ( int k = 0; k < getNumMembers(); ++k )
+    W_op_bar->setNonconstBlock( k, k, memberModel_->create_W_op() );
+  W_op_bar->endBlockFill();
+  return W_op_bar;
+}
+
+
+template<class Scalar>
+RCP<const Thyra::LinearOpWithSolveFactoryBase<Scalar> >
+EnsembleModelEvaluator<Scalar>::get_W_factory() const
+{
+  return W_bar_factory_;
+}
+
+
+template<class Scalar>
+Thyra::ModelEvaluatorBase::InArgs<Scalar>
+EnsembleModelEvaluator<Scalar>::getNominalValues() const
+{
+  return nominalValues_;
+}
+
+
+template<class Scalar>
+Thyra::ModelEvaluatorBase::InArgs<Scalar>
+EnsembleModelEvaluator<Scalar>::createInArgs() const
+{
+  TEUCHOS_ASSERT( !is_null(memberModel_) );
+  typedef Thyra::ModelEvaluatorBase MEB;
+  const MEB::InArgs<Scalar> memberInArgs = memberModel_->createInArgs();
+  MEB::InArgsSetup<Scalar> inArgs;
+  inArgs.setModelEvalDescription(this->description());
+  inArgs.setSupports( MEB::IN_ARG_x );
+  inArgs.setSupports( MEB::IN_ARG_t, memberInArgs.supports(MEB::IN_ARG_t) );
+  inArgs.setSupports( MEB::IN_ARG_x_dot,
+    memberInArgs.supports(MEB::IN_ARG_x_dot) );
+  inArgs.setSupports( MEB::IN_ARG_alpha,
+    memberInArgs.supports(MEB::IN_ARG_alpha) );
+  inArgs.setSupports( MEB::IN_ARG_beta,
+    memberInArgs.supports(MEB::IN_ARG_beta) );
+  return inArgs;
+}
+
+
+// Private functions overridden from ModelEvaluatorDefaultBase
+
+
+template<class Scalar>
+Thyra::ModelEvaluatorBase::OutArgs<Scalar>
+EnsembleModelEvaluator<Scalar>::createOutArgsImpl() const
+{
+  TEUCHOS_ASSERT( !is_null(memberModel_) );
+  typedef Thyra::ModelEvaluatorBase MEB;
+  const MEB::OutArgs<Scalar> memberOutArgs = memberModel_->createOutArgs();
+  MEB::OutArgsSetup<Scalar> outArgs;
+  outArgs.setModelEvalDescription(this->description());
+  outArgs.setSupports(MEB::OUT_ARG_f);
+  if (memberOutArgs.supports(MEB::OUT_ARG_W_op)) {
+    outArgs.setSupports(MEB::OUT_ARG_W_op);
+    outArgs.set_W_properties(memberOutArgs.get_W_properties());
+  }
+  return outArgs;
+}
+
+
+template<class Scalar>
+void EnsembleModelEvaluator<Scalar>::evalModelImpl(
+  const Thyra::ModelEvaluatorBase::InArgs<Scalar>& inArgs_bar,
+  const Thyra::ModelEvaluatorBase::OutArgs<Scalar>& outArgs_bar
+  ) const
+{
+
+  RYTHMOS_FUNC_TIME_MONITOR("Rythmos:EnsembleModelEvaluator::evalModel");
+
+  using Teuchos::rcp_dynamic_cast;
+  typedef Thyra::ModelEvaluatorBase MEB;
+  typedef Thyra::BlockedLinearOpBase<Scalar> BLWB;
+
+  //
+  // A) Unwrap the outArgs to get at the block op
+  //
+
+  const RCP<const Thyra::VectorBase<Scalar> > x_bar = inArgs_bar.get_x();
+  RCP<const Thyra::VectorBase<Scalar> > x_dot_bar;
+  if (inArgs_bar.supports(MEB::IN_ARG_x_dot))
+    x_dot_bar = inArgs_bar.get_x_dot();
+  const RCP<Thyra::VectorBase<Scalar> > f_bar = outArgs_bar.get_f();
+  RCP<BLWB> W_op_bar;
+  if (outArgs_bar.supports(MEB::OUT_ARG_W_op) && nonnull(outArgs_bar.get_W_op()))
+    W_op_bar = rcp_dynamic_cast<BLWB>(outArgs_bar.get_W_op(), true);
+
+  //
+  // B) Evaluate the members one column at a time
+  //
+
+  for ( int k = 0; k < getNumMembers(); ++k ) {
+
+    // Only reset what changes from one evaluation to the next, the rest
+    // (e.g. the parameters of the member) was set up in initialize().
+    MEB::InArgs<Scalar> &memberInArgs = memberInArgs_[k];
+    MEB::OutArgs<Scalar> &memberOutArgs = memberOutArgs_[k];
+    memberInArgs.set_x(getMemberVector(x_bar,k));
+    if (memberInArgs.supports(MEB::IN_ARG_x_dot)) {
+      memberInArgs.set_x_dot( nonnull(x_dot_bar)
+        ? getMemberVector(x_dot_bar,k) : Teuchos::null );
+    }
+    if (memberInArgs.supports(MEB::IN_ARG_t))
+      memberInArgs.set_t(inArgs_bar.get_t());
+    if (memberInArgs.supports(MEB::IN_ARG_alpha))
+      memberInArgs.set_alpha(inArgs_bar.get_alpha());
+    if (memberInArgs.supports(MEB::IN_ARG_beta))
+      memberInArgs.set_beta(inArgs_bar.get_beta());
+
+    memberOutArgs.set_f( nonnull(f_bar)
+      ? getNonconstMemberVector(f_bar,k) : Teuchos::null );
+    if (memberOutArgs.supports(MEB::OUT_ARG_W_op)) {
+      memberOutArgs.set_W_op( nonnull(W_op_bar)
+        ? W_op_bar->getNonconstBlock(k,k).assert_not_null() : Teuchos::null );
+    }
+
+    memberModel_->evalModel(memberInArgs,memberOutArgs);
+
+  }
+
+}
+
+
+// private
+
+
+template<class Scalar>
+RCP<const Thyra::VectorBase<Scalar> >
+EnsembleModelEvaluator<Scalar>::getMemberVector(
+  const RCP<const Thyra::VectorBase<Scalar> > &v_bar, const int k
+  )
+{
+  const EnsembleVector<Scalar>* ensembleVector =
+    dynamic_cast<const EnsembleVector<Scalar>*>(v_bar.get());
+  if (ensembleVector)
+    return ensembleVector->getMemberVector(k);
+  return Teuchos::rcp_dynamic_cast<
+    const Thyra::DefaultMultiVectorProductVector<Scalar> >(
+      v_bar.assert_not_null(), true
+      )->getMultiVector()->col(k);
+}
+
+
+template<class Scalar>
+RCP<Thyra::VectorBase<Scalar> >
+EnsembleModelEvaluator<Scalar>::getNonconstMemberVector(
+  const RCP<Thyra::VectorBase<Scalar> > &v_bar, const int k
+  )
+{
+  EnsembleVector<Scalar>* ensembleVector =
+    dynamic_cast<EnsembleVector<Scalar>*>(v_bar.get());
+  if (ensembleVector)
+    return ensembleVector->getNonconstMemberVector(k);
+  return Teuchos::rcp_dynamic_cast<
+    Thyra::DefaultMultiVectorProductVector<Scalar> >(
+      v_bar.assert_not_null(), true
+      )->getNonconstMultiVector()->col(k);
+}
+
+
+} // namespace Rythmos
+
+
+#endif // RYTHMOS_ENSEMBLE_MODEL_EVALUATOR_HPP
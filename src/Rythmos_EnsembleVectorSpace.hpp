@@ -0,0 +1,350 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef RYTHMOS_ENSEMBLE_VECTOR_SPACE_HPP
+#define RYTHMOS_ENSEMBLE_VECTOR_SPACE_HPP
+
+
+#include "Rythmos_Types.hpp"
+#include "Thyra_DefaultMultiVectorProductVectorSpace.hpp"
+#include "Thyra_DefaultMultiVectorProductVector.hpp"
+#include "Thyra_SpmdVectorSpaceBase.hpp"
+#include "Thyra_DefaultSpmdVectorSpace.hpp"
+#include "Thyra_DefaultSpmdVector.hpp"
+#include "Thyra_DefaultSpmdMultiVector.hpp"
+
+
+namespace Rythmos {
+
+
+template<class Scalar> class EnsembleVector;
+
+
+/** \brief Multi-vector product vector space whose vectors store the columns
+ * of all ensemble members in one contiguous array.
+ *
+ * A vector of this space is a <tt>Thyra::DefaultMultiVectorProductVector</tt>
+ * whose multi-vector <tt>X</tt> has one column per member, so blocked
+ * operators such as the block diagonal <tt>W_bar</tt> of
+ * <tt>EnsembleModelEvaluator</tt> see the usual product structure.  When the
+ * member space is a locally replicated (e.g. serial) SPMD space, the columns
+ * of <tt>X</tt> are laid out one after the other in one array that is also
+ * viewed as a single SPMD vector of dimension <tt>numMembers*dim</tt>.  A
+ * reduction or transformation operator applied to vectors of this space is
+ * then applied once to these flat vectors, instead of once per column as by
+ * <tt>DefaultMultiVectorProductVector</tt>, so a norm or an axpy of the
+ * whole ensemble is one RTOp.  For any other member space this falls back
+ * to the column by column operators of the base class.
+ */
+template<class Scalar>
+class EnsembleVectorSpace
+  : public Thyra::DefaultMultiVectorProductVectorSpace<Scalar>
+{
+public:
+
+  /** \name Constructors/initializers/accessors */
+  //@{
+
+  /** \brief . */
+  EnsembleVectorSpace();
+
+  /** \brief . */
+  void initialize(
+    const RCP<const Thyra::VectorSpaceBase<Scalar> > &memberSpace,
+    const int numMembers
+    );
+
+  /** \brief The SPMD space of the flat vectors, or null if the columns can
+   * not be stored contiguously. */
+  RCP<const Thyra::SpmdVectorSpaceBase<Scalar> > getFlatSpace() const;
+
+  //@}
+
+  /** \name Overridden from VectorSpaceBase */
+  //@{
+
+  /** \brief . */
+  RCP<const Thyra::VectorSpaceBase<Scalar> > clone() const;
+
+  //@}
+
+protected:
+
+  /** \name Overridden from VectorSpaceBase */
+  //@{
+
+  /** \brief . */
+  RCP<Thyra::VectorBase<Scalar> > createMember() const;
+
+  //@}
+
+private:
+
+  RCP<const EnsembleVectorSpace<Scalar> > weakSelfPtr_;
+  RCP<const Thyra::SpmdVectorSpaceBase<Scalar> > memberSpmdSpace_;
+  RCP<const Thyra::DefaultSpmdVectorSpace<Scalar> > columnsSpace_;
+  RCP<const Thyra::SpmdVectorSpaceBase<Scalar> > flatSpace_;
+
+  template<class Scalar2>
+  friend RCP<EnsembleVectorSpace<Scalar2> > ensembleVectorSpace(
+    const RCP<const Thyra::VectorSpaceBase<Scalar2> > &memberSpace,
+    const int numMembers
+    );
+
+};
+
+
+/** \brief Non-member constructor.
+ *
+ * \relates EnsembleVectorSpace
+ */
+template<class Scalar>
+RCP<EnsembleVectorSpace<Scalar> >
+ensembleVectorSpace(
+  const RCP<const Thyra::VectorSpaceBase<Scalar> > &memberSpace,
+  const int numMembers
+  )
+{
+  RCP<EnsembleVectorSpace<Scalar> >
+    space = Teuchos::rcp(new EnsembleVectorSpace<Scalar>());
+  space->initialize(memberSpace,numMembers);
+  space->weakSelfPtr_ = space.create_weak();
+  return space;
+}
+
+
+/** \brief Vector of an <tt>EnsembleVectorSpace</tt> with contiguous storage
+ * of the member columns.
+ *
+ * Besides the multi-vector of the base class this holds a flat SPMD vector
+ * and one SPMD vector per member, all views of the same array, so that the
+ * member vectors can be handed to the member model without creating a new
+ * view on every evaluation.
+ */
+template<class Scalar>
+class EnsembleVector
+  : public Thyra::DefaultMultiVectorProductVector<Scalar>
+{
+public:
+
+  /** \brief Allocate the storage of all the members of <tt>space</tt>. */
+  EnsembleVector(
+    const RCP<const EnsembleVectorSpace<Scalar> > &space,
+    const RCP<const Thyra::SpmdVectorSpaceBase<Scalar> > &memberSpmdSpace,
+    const RCP<const Thyra::DefaultSpmdVectorSpace<Scalar> > &columnsSpace
+    );
+
+  /** \brief The column of member <tt>k</tt>. */
+  RCP<const Thyra::VectorBase<Scalar> > getMemberVector(const int k) const;
+
+  /** \brief The column of member <tt>k</tt>. */
+  RCP<Thyra::VectorBase<Scalar> > getNonconstMemberVector(const int k);
+
+protected:
+
+  /** \name Overridden from VectorBase */
+  //@{
+
+  /** \brief Applies <tt>op</tt> once to the flat vectors if all vectors
+   * are <tt>EnsembleVector</tt> objects, else column by column. */
+  void applyOpImpl(
+    const RTOpPack::RTOpT<Scalar> &op,
+    const ArrayView<const Ptr<const Thyra::VectorBase<Scalar> > > &vecs,
+    const ArrayView<const Ptr<Thyra::VectorBase<Scalar> > > &targ_vecs,
+    const Ptr<RTOpPack::ReductTarget> &reduct_obj,
+    const Thyra::Ordinal global_offset
+    ) const;
+
+  //@}
+
+private:
+
+  RCP<Thyra::VectorBase<Scalar> > flatVector_;
+  Array<RCP<Thyra::VectorBase<Scalar> > > memberVectors_;
+
+};
+
+
+// ///////////////////////
+// Definition
+
+
+// EnsembleVectorSpace
+
+
+template<class Scalar>
+EnsembleVectorSpace<Scalar>::EnsembleVectorSpace()
+{}
+
+
+template<class Scalar>
+void EnsembleVectorSpace<Scalar>::initialize(
+  const RCP<const Thyra::VectorSpaceBase<Scalar> > &memberSpace,
+  const int numMembers
+  )
+{
+  this->Thyra::DefaultMultiVectorProductVectorSpace<Scalar>::initialize(
+    memberSpace, numMembers );
+  memberSpmdSpace_ = Teuchos::rcp_dynamic_cast<
+    const Thyra::SpmdVectorSpaceBase<Scalar> >(memberSpace);
+  columnsSpace_ = Teuchos::null;
+  flatSpace_ = Teuchos::null;
+  // With more than one process the flat vector would order the elements
+  // process by process instead of member by member, which changes the
+  // answer of operators that depend on the global index of an element.
+  if ( nonnull(memberSpmdSpace_)
+    && memberSpmdSpace_->localSubDim() == memberSpmdSpace_->dim() )
+  {
+    columnsSpace_ = Thyra::locallyReplicatedDefaultSpmdVectorSpace<Scalar>(
+      memberSpmdSpace_->getComm(), numMembers );
+    flatSpace_ = Thyra::defaultSpmdVectorSpace<Scalar>(
+      memberSpmdSpace_->getComm(),
+      numMembers*memberSpmdSpace_->dim(), numMembers*memberSpmdSpace_->dim() );
+  }
+}
+
+
+template<class Scalar>
+RCP<const Thyra::SpmdVectorSpaceBase<Scalar> >
+EnsembleVectorSpace<Scalar>::getFlatSpace() const
+{
+  return flatSpace_;
+}
+
+
+template<class Scalar>
+RCP<const Thyra::VectorSpaceBase<Scalar> >
+EnsembleVectorSpace<Scalar>::clone() const
+{
+  return ensembleVectorSpace<Scalar>( this->getBlock(0), this->numBlocks() );
+}
+
+
+template<class Scalar>
+RCP<Thyra::VectorBase<Scalar> >
+EnsembleVectorSpace<Scalar>::createMember() const
+{
+  if (is_null(flatSpace_))
+    return this->Thyra::DefaultMultiVectorProductVectorSpace<Scalar>::createMember();
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(weakSelfPtr_), std::logic_error,
+    "Error, create the space with ensembleVectorSpace()!"
+    );
+  return Teuchos::rcp(
+    new EnsembleVector<Scalar>(weakSelfPtr_.create_strong(),
+      memberSpmdSpace_, columnsSpace_) );
+}
+
+
+// EnsembleVector
+
+
+template<class Scalar>
+EnsembleVector<Scalar>::EnsembleVector(
+  const RCP<const EnsembleVectorSpace<Scalar> > &space,
+  const RCP<const Thyra::SpmdVectorSpaceBase<Scalar> > &memberSpmdSpace,
+  const RCP<const Thyra::DefaultSpmdVectorSpace<Scalar> > &columnsSpace
+  )
+{
+  const int numMembers = space->numBlocks();
+  const Thyra::Ordinal n = memberSpmdSpace->localSubDim();
+  const ArrayRCP<Scalar> values = Teuchos::arcp<Scalar>(numMembers*n);
+  this->initialize( space,
+    Teuchos::rcp( new Thyra::DefaultSpmdMultiVector<Scalar>(
+      memberSpmdSpace, columnsSpace, values, n ) ) );
+  flatVector_ = Teuchos::rcp(
+    new Thyra::DefaultSpmdVector<Scalar>(space->getFlatSpace(), values, 1) );
+  memberVectors_.resize(numMembers);
+  for (int k = 0; k < numMembers; ++k) {
+    memberVectors_[k] = Teuchos::rcp(
+      new Thyra::DefaultSpmdVector<Scalar>(memberSpmdSpace,
+        values.persistingView(k*n,n), 1) );
+  }
+}
+
+
+template<class Scalar>
+RCP<const Thyra::VectorBase<Scalar> >
+EnsembleVector<Scalar>::getMemberVector(const int k) const
+{
+  return memberVectors_[k];
+}
+
+
+template<class Scalar>
+RCP<Thyra::VectorBase<Scalar> >
+EnsembleVector<Scalar>::getNonconstMemberVector(const int k)
+{
+  return memberVectors_[k];
+}
+
+
+template<class Scalar>
+void EnsembleVector<Scalar>::applyOpImpl(
+  const RTOpPack::RTOpT<Scalar> &op,
+  const ArrayView<const Ptr<const Thyra::VectorBase<Scalar> > > &vecs,
+  const ArrayView<const Ptr<Thyra::VectorBase<Scalar> > > &targ_vecs,
+  const Ptr<RTOpPack::ReductTarget> &reduct_obj,
+  const Thyra::Ordinal global_offset
+  ) const
+{
+
+  Array<Ptr<const Thyra::VectorBase<Scalar> > > flatVecs(vecs.size());
+  Array<Ptr<Thyra::VectorBase<Scalar> > > flatTargVecs(targ_vecs.size());
+  bool allEnsemble = true;
+  for (int i = 0; allEnsemble && i < vecs.size(); ++i) {
+    const EnsembleVector<Scalar>* v =
+      dynamic_cast<const EnsembleVector<Scalar>*>(vecs[i].get());
+    allEnsemble = ( v != 0 );
+    if (allEnsemble)
+      flatVecs[i] = v->flatVector_.ptr();
+  }
+  for (int i = 0; allEnsemble && i < targ_vecs.size(); ++i) {
+    const EnsembleVector<Scalar>* v =
+      dynamic_cast<const EnsembleVector<Scalar>*>(targ_vecs[i].get());
+    allEnsemble = ( v != 0 );
+    if (allEnsemble)
+      flatTargVecs[i] = v->flatVector_.ptr();
+  }
+
+  if (allEnsemble) {
+    Thyra::applyOp<Scalar>( op, flatVecs(), flatTargVecs(), reduct_obj,
+      global_offset );
+  }
+  else {
+    this->Thyra::DefaultMultiVectorProductVector<Scalar>::applyOpImpl(
+      op, vecs, targ_vecs, reduct_obj, global_offset );
+  }
+
+}
+
+
+} // namespace Rythmos
+
+
+#endif // RYTHMOS_ENSEMBLE_VECTOR_SPACE_HPP
@@ -105,6 +105,9 @@ class ExplicitRKStepper : virtual public RKButcherTableauAcceptingStepperBase<Sc
     /** \brief . */
     const StepStatus<Scalar> getStepStatus() const;
 
+    /** \brief . */
+    StepperPerformanceCounters getPerformanceCounters() const;
+
     /** \brief . */
     void describe(
         Teuchos::FancyOStream &out,
@@ -187,6 +190,7 @@ class ExplicitRKStepper : virtual public RKButcherTableauAcceptingStepperBase<Sc
     Scalar t_old_;
     Scalar dt_;
     int numSteps_;
+    StepperPerformanceCounters perfCounters_;
     Scalar LETvalue_;   // ck * e
 
     Teuchos::RCP<Teuchos::ParameterList> parameterList_;
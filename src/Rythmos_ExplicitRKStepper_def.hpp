@@ -260,6 +260,7 @@ Scalar ExplicitRKStepper<Scalar>::takeVariableStep_(Scalar dt, StepSizeType /* s
     // need to check here the status of the solver (the linear solve)
     //eval_model_explicit<Scalar>(*model_,basePoint_,*ktemp_vector_,ts,Teuchos::outArg(*k_vector_[s]));
     eval_model_explicit<Scalar>(*model_,basePoint_,*ktemp_vector_,ts,Teuchos::outArg(*k_vector_[s]), scaled_dt, c(s));
+    ++perfCounters_.numResidualEvaluations;
     Thyra::Vt_S(k_vector_[s].ptr(),dt); // k_s = k_s*dt
   }
   // Sum for solution:
@@ -271,14 +272,13 @@ Scalar ExplicitRKStepper<Scalar>::takeVariableStep_(Scalar dt, StepSizeType /* s
 
    // cheat and say that the solver converged ( although no solver is needed for explicit method )
    rkNewtonConvergenceStatus_ = 0; 
-   stepControl_->setCorrection(*this, solution_vector_, Teuchos::null , rkNewtonConvergenceStatus_);
-   bool stepPass = stepControl_->acceptStep(*this, &LETvalue_);
 
    if (erkButcherTableau_->isEmbeddedMethod() ){ 
        
        Teuchos::SerialDenseVector<int,Scalar> bhat = erkButcherTableau_->bhat();
 
         // Sum for Embedded solution:
+        Thyra::assign(solution_hat_vector_.ptr(), *solution_vector_old_);
         for (int s=0 ; s < stages ; ++s) {
           if (bhat(s) != ST::zero()) {
              
@@ -296,7 +296,7 @@ Scalar ExplicitRKStepper<Scalar>::takeVariableStep_(Scalar dt, StepSizeType /* s
         stepControl_->setCorrection(*this, solution_vector_, Teuchos::null, rkNewtonConvergenceStatus_);
    }
 
-    stepPass = stepControl_->acceptStep(*this, &LETvalue_);
+    bool stepPass = stepControl_->acceptStep(*this, &LETvalue_);
 
     if (!stepPass) { // stepPass = false
        stepLETStatus_ = STEP_LET_STATUS_FAILED;
@@ -310,7 +310,10 @@ Scalar ExplicitRKStepper<Scalar>::takeVariableStep_(Scalar dt, StepSizeType /* s
 
      // Update time range
      timeRange_ = timeRange(t,t+current_dt);
+     // update current time:
+     t_ = t_ + dt;
      numSteps_++;
+     ++perfCounters_.numSteps;
 
      // completeStep only if the none of the stage solution's failed to converged
      stepControl_->completeStep(*this);
@@ -320,14 +323,17 @@ Scalar ExplicitRKStepper<Scalar>::takeVariableStep_(Scalar dt, StepSizeType /* s
      } else {
         
         rkNewtonConvergenceStatus_ = -1;
+        ++perfCounters_.numRejectedSteps;
         status = stepControl_-> rejectStep(*this); // reject the stage value
-        (void) status; // avoid "set but not used" build warning
+        TEUCHOS_TEST_FOR_EXCEPTION( status == REP_ERR_FAIL, std::logic_error,
+          "Error in ExplicitRKStepper::takeStep():  The step control strategy "
+          "failed to find an acceptable step size!\n");
+        // Restore the solution from the beginning of the step
+        V_V(solution_vector_.ptr(), *solution_vector_old_);
+        t_ = t_old_;
         dt_to_return = dt_old;
      }
 
-  // update current time:
-  t_ = t_ + dt;
-  numSteps_++;
   return( dt_to_return );
 }
 
@@ -367,6 +373,7 @@ Scalar ExplicitRKStepper<Scalar>::takeFixedStep_(Scalar dt, StepSizeType flag)
     TScalarMag scaled_dt = (s == 0)? Scalar(dt/stages) : c(s)*dt;
 
     eval_model_explicit<Scalar>(*model_,basePoint_,*ktemp_vector_,ts,Teuchos::outArg(*k_vector_[s]), scaled_dt, c(s));
+    ++perfCounters_.numResidualEvaluations;
     Thyra::Vt_S(k_vector_[s].ptr(),dt); // k_s = k_s*dt
   }
   // Sum for solution:
@@ -380,6 +387,7 @@ Scalar ExplicitRKStepper<Scalar>::takeFixedStep_(Scalar dt, StepSizeType flag)
   t_ = t_ + dt;
 
   numSteps_++;
+  ++perfCounters_.numSteps;
 
   return(dt);
 }
@@ -407,6 +415,13 @@ const StepStatus<Scalar> ExplicitRKStepper<Scalar>::getStepStatus() const
   return(stepStatus);
 }
 
+template<class Scalar>
+StepperPerformanceCounters
+ExplicitRKStepper<Scalar>::getPerformanceCounters() const
+{
+  return perfCounters_;
+}
+
 template<class Scalar>
 void ExplicitRKStepper<Scalar>::describe(
     Teuchos::FancyOStream &out,
@@ -650,6 +665,12 @@ RCP<StepperBase<Scalar> > ExplicitRKStepper<Scalar>::cloneStepperAlgorithm() con
     stepper->setParameterList(Teuchos::parameterList(*parameterList_));
   }
 
+  if (!is_null(stepControl_)) {
+    if (stepControl_->supportsCloning())
+      stepper->setStepControlStrategy(
+        stepControl_->cloneStepControlStrategyAlgorithm().assert_not_null());
+  }
+
   return stepper;
 
 }
@@ -372,6 +372,9 @@ class ForwardEulerStepper : virtual public StepperBase<Scalar>
     /** \brief . */
     const StepStatus<Scalar> getStepStatus() const;
 
+    /** \brief . */
+    StepperPerformanceCounters getPerformanceCounters() const;
+
     /** \brief . */
     std::string description() const;
 
@@ -449,6 +452,7 @@ class ForwardEulerStepper : virtual public StepperBase<Scalar>
     RCP<Thyra::VectorBase<Scalar> > solution_vector_old_;
     Thyra::ModelEvaluatorBase::InArgs<Scalar> basePoint_;
     int numSteps_;
+    StepperPerformanceCounters perfCounters_;
     bool haveInitialCondition_;
 
     RCP<Teuchos::ParameterList> parameterList_;
@@ -402,6 +402,7 @@ Scalar ForwardEulerStepper<Scalar>::takeStep(Scalar dt, StepSizeType flag)
   }
   //Thyra::eval_f<Scalar>(*model_,*solution_vector_,t_+dt,&*residual_vector_);
   eval_model_explicit<Scalar>(*model_,basePoint_,*solution_vector_,t_+dt,Teuchos::outArg(*residual_vector_));
+  ++perfCounters_.numResidualEvaluations;
 
   // solution_vector_old_ = solution_vector_
   Thyra::V_V(Teuchos::outArg(*solution_vector_old_),*solution_vector_);
@@ -411,6 +412,7 @@ Scalar ForwardEulerStepper<Scalar>::takeStep(Scalar dt, StepSizeType flag)
   t_ += dt;
   dt_ = dt;
   numSteps_++;
+  ++perfCounters_.numSteps;
 
   return(dt);
 }
@@ -442,6 +444,13 @@ const StepStatus<Scalar> ForwardEulerStepper<Scalar>::getStepStatus() const
   return(stepStatus);
 }
 
+template<class Scalar>
+StepperPerformanceCounters
+ForwardEulerStepper<Scalar>::getPerformanceCounters() const
+{
+  return perfCounters_;
+}
+
 template<class Scalar>
 std::string ForwardEulerStepper<Scalar>::description() const
 {
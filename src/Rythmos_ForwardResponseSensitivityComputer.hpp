@@ -31,9 +31,13 @@
 
 
 #include "Rythmos_Types.hpp"
+#include "Rythmos_InterpolationBufferBase.hpp"
+#include "Rythmos_extractStateAndSens.hpp"
+#include "Rythmos_ForwardSensitivityModelEvaluatorBase.hpp"
 #include "Thyra_ModelEvaluator.hpp"
 #include "Teuchos_VerboseObject.hpp"
 #include "Teuchos_StandardMemberCompositionMacros.hpp"
+#include "Teuchos_as.hpp"
 
 
 namespace Rythmos {
@@ -42,6 +46,32 @@ namespace Rythmos {
 /** \brief Concrete utility class for computing (assembling) forward transient
  * response sensitivities.
  *
+ * The reduced sensitivity of the response <tt>g(x_dot,x,p)</tt> at a time
+ * point is
+
+ \verbatim
+
+   D_g_hat_D_p = DgDp + DgDx_dot * S_dot + DgDx * S
+
+ \endverbatim
+
+ * The response function writes <tt>DgDp</tt> directly into
+ * <tt>D_g_hat_D_p</tt> (when all of the parameters are active) and the other
+ * two terms are added in place, so the assembly takes no extra passes over
+ * <tt>D_g_hat_D_p</tt>.  The
+ * <tt>DgDx</tt> and <tt>DgDx_dot</tt> operators are created once and reused
+ * for every time point.
+ *
+ * <tt>computeResponsesAndSensitivities()</tt> computes the response and
+ * sensitivity at all of the response times inside the current step of a
+ * forward sensitivity stepper, with one call to <tt>getPoints()</tt> to
+ * interpolate <tt>x_bar = [ x; s_bar ]</tt> at all of them.
+ *
+ * When the forward sensitivities are only computed for a subset of the
+ * parameters (see <tt>ForwardSensitivityStepper::setActiveParameters()</tt>),
+ * the same subset must be given to <tt>setActiveParameters()</tt>.  Then
+ * <tt>S</tt> and <tt>D_g_hat_D_p</tt> only have the columns of the active
+ * parameters and only these columns of <tt>DgDp</tt> are added.
  *
  * ToDo: Finish documentation!
  */
@@ -89,10 +119,25 @@ public:
     const Thyra::ModelEvaluatorBase::InArgs<Scalar> &basePoint
     );
 
+  /** \brief Select the parameters whose reduced sensitivities are
+   * computed.
+   *
+   * \param activeParams [in] Strictly increasing indexes into the parameter
+   * subvector <tt>p_index</tt>.  Column <tt>k</tt> of <tt>S</tt> and of
+   * <tt>D_g_hat_D_p</tt> is then for <tt>p(activeParams[k])</tt>.
+   *
+   * <tt>setResponseFunction()</tt> makes all of the parameters active.
+   */
+  void setActiveParameters(const ArrayView<const int> &activeParams);
+
   /** \brief . */
-  const RCP<Thyra::VectorBase<Scalar> > create_g_hat() const;
+  const Array<int>& getActiveParameters() const;
 
   /** \brief . */
+  const RCP<Thyra::VectorBase<Scalar> > create_g_hat() const;
+
+  /** \brief Create a multi-vector with a column for each active
+   * parameter. */
   const RCP<Thyra::MultiVectorBase<Scalar> > create_D_g_hat_D_p() const;
 
   /** \brief Compute the reduced response at a point
@@ -143,6 +188,37 @@ public:
     Thyra::MultiVectorBase<Scalar> *D_g_hat_D_p
     ) const;
 
+  /** \brief Compute the reduced sensitivities and perhaps the responses at
+   * several times in the current step of a forward sensitivity stepper.
+   *
+   * \param stateAndSensBuffer [in] Interpolation buffer for <tt>x_bar = [ x;
+   * s_bar ]</tt> and <tt>x_bar_dot</tt>, e.g. a
+   * <tt>ForwardSensitivityStepper</tt>.  All of <tt>time_vec</tt> must be in
+   * its time range.
+   *
+   * \param time_vec [in] The response times.
+   *
+   * \param g_hat_vec [out,optional] If not empty, <tt>*g_hat_vec[i]</tt> is
+   * set to the response at <tt>time_vec[i]</tt>.  These can be created by
+   * calling this->create_g_hat().
+   *
+   * \param D_g_hat_D_p_vec [out] <tt>*D_g_hat_D_p_vec[i]</tt> is set to the
+   * reduced sensitivity at <tt>time_vec[i]</tt>.  These can be created by
+   * calling this->create_D_g_hat_D_p().
+   *
+   * The states and sensitivities at all of the times are interpolated with
+   * a single call to <tt>stateAndSensBuffer.getPoints()</tt> and each time
+   * point then costs one evaluation of the response function.  As with
+   * <tt>computeResponseAndSensitivity()</tt>, the time is not passed to the
+   * response function.
+   */
+  void computeResponsesAndSensitivities(
+    const InterpolationBufferBase<Scalar> &stateAndSensBuffer,
+    const Array<Scalar> &time_vec,
+    const Array<RCP<Thyra::VectorBase<Scalar> > > &g_hat_vec,
+    const Array<RCP<Thyra::MultiVectorBase<Scalar> > > &D_g_hat_D_p_vec
+    ) const;
+
 private: // Data members
 
   RCP<const Thyra::ModelEvaluator<Scalar> > responseFunc_;
@@ -153,6 +229,8 @@ private: // Data members
   RCP<const Thyra::VectorSpaceBase<Scalar> > p_space_;
   RCP<const Thyra::VectorSpaceBase<Scalar> > g_space_;
 
+  Array<int> activeParams_;
+
   bool response_func_supports_x_dot_;
   bool response_func_supports_D_x_dot_;
   bool response_func_supports_D_p_;
@@ -166,6 +244,8 @@ private: // Data members
 
 private: // Functions
 
+  bool allParametersActive() const;
+
   void clearCache();
 
   void createCache(const bool computeSens) const;
@@ -220,6 +300,11 @@ void ForwardResponseSensitivityComputer<Scalar>::setResponseFunction(
   p_space_ = responseFunc_->get_p_space(p_index_);
   g_space_ = responseFunc_->get_g_space(g_index_);
 
+  const int np = p_space_->dim();
+  activeParams_.resize(np);
+  for (int k = 0; k < np; ++k)
+    activeParams_[k] = k;
+
 
   MEB::InArgs<Scalar>
     responseInArgs = responseFunc_->createInArgs();
@@ -250,6 +335,29 @@ void ForwardResponseSensitivityComputer<Scalar>::resetResponseFunction(
 }
 
 
+template<class Scalar>
+void ForwardResponseSensitivityComputer<Scalar>::setActiveParameters(
+  const ArrayView<const int> &activeParams
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(p_space_), std::logic_error,
+    "Error, you must call setResponseFunction(...) before you call"
+    " setActiveParameters(...)!"
+    );
+  assertValidActiveParameters(activeParams, p_space_->dim());
+  activeParams_.assign(activeParams.begin(), activeParams.end());
+}
+
+
+template<class Scalar>
+const Array<int>&
+ForwardResponseSensitivityComputer<Scalar>::getActiveParameters() const
+{
+  return activeParams_;
+}
+
+
 template<class Scalar>
 const RCP<Thyra::VectorBase<Scalar> >
 ForwardResponseSensitivityComputer<Scalar>::create_g_hat() const
@@ -262,7 +370,7 @@ template<class Scalar>
 const RCP<Thyra::MultiVectorBase<Scalar> >
 ForwardResponseSensitivityComputer<Scalar>::create_D_g_hat_D_p() const
 {
-  return Thyra::createMembers(g_space_,p_space_->dim());
+  return Thyra::createMembers(g_space_,activeParams_.size());
 }
 
 
@@ -293,9 +401,64 @@ void ForwardResponseSensitivityComputer<Scalar>::computeResponseAndSensitivity(
 }
 
 
+template<class Scalar>
+void ForwardResponseSensitivityComputer<Scalar>::computeResponsesAndSensitivities(
+  const InterpolationBufferBase<Scalar> &stateAndSensBuffer,
+  const Array<Scalar> &time_vec,
+  const Array<RCP<Thyra::VectorBase<Scalar> > > &g_hat_vec,
+  const Array<RCP<Thyra::MultiVectorBase<Scalar> > > &D_g_hat_D_p_vec
+  ) const
+{
+
+  const int numTimes = time_vec.size();
+
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    Teuchos::as<int>(D_g_hat_D_p_vec.size()) != numTimes, std::logic_error,
+    "Error, D_g_hat_D_p_vec.size() = " << D_g_hat_D_p_vec.size()
+    << " != time_vec.size() = " << numTimes << "!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !g_hat_vec.empty() && Teuchos::as<int>(g_hat_vec.size()) != numTimes,
+    std::logic_error,
+    "Error, g_hat_vec.size() = " << g_hat_vec.size()
+    << " != time_vec.size() = " << numTimes << "!"
+    );
+
+  if (numTimes == 0)
+    return;
+
+  Array<RCP<const Thyra::VectorBase<Scalar> > > x_bar_vec, x_bar_dot_vec;
+  {
+    RYTHMOS_FUNC_TIME_MONITOR("Rythmos:ForwardResponseSensitivityComputer::evalModel: getPoints");
+    stateAndSensBuffer.getPoints(time_vec, &x_bar_vec, &x_bar_dot_vec, 0);
+  }
+
+  RCP<const Thyra::VectorBase<Scalar> > x, x_dot;
+  RCP<const Thyra::MultiVectorBase<Scalar> > S, S_dot;
+  for (int i = 0; i < numTimes; ++i) {
+    extractStateAndSens( x_bar_vec[i], x_bar_dot_vec[i], &x, &S, &x_dot, &S_dot );
+    computeResponseAndSensitivityImpl(
+      x_dot.get(), S_dot.get(), *x, S.get(), time_vec[i],
+      g_hat_vec.empty() ? 0 : g_hat_vec[i].get(),
+      D_g_hat_D_p_vec[i].assert_not_null().get()
+      );
+  }
+
+}
+
+
 // private
 
 
+template<class Scalar>
+bool ForwardResponseSensitivityComputer<Scalar>::allParametersActive() const
+{
+  // The active parameters are strictly increasing so all of them are active
+  // if there are as many as parameters.
+  return ( Teuchos::as<int>(activeParams_.size()) == p_space_->dim() );
+}
+
+
 template<class Scalar>
 void ForwardResponseSensitivityComputer<Scalar>::clearCache()
 {
@@ -313,9 +476,10 @@ void ForwardResponseSensitivityComputer<Scalar>::createCache(
   if (computeSens) {
     if (response_func_supports_D_x_dot_ && is_null(D_g_D_x_dot_))
       D_g_D_x_dot_ = responseFunc_->create_DgDx_dot_op(g_index_);
-    D_g_D_x_ = responseFunc_->create_DgDx_op(g_index_);
-    if (response_func_supports_D_p_ && is_null(D_g_D_p_))
-      D_g_D_p_ = createMembers(g_space_,p_space_->dim());
+    if (is_null(D_g_D_x_))
+      D_g_D_x_ = responseFunc_->create_DgDx_op(g_index_);
+    if (response_func_supports_D_p_ && !allParametersActive() && is_null(D_g_D_p_))
+      D_g_D_p_ = Thyra::createMembers(g_space_,p_space_->dim());
   }
 }
 
@@ -337,7 +501,6 @@ void ForwardResponseSensitivityComputer<Scalar>::computeResponseAndSensitivityIm
   using Teuchos::includesVerbLevel;
   typedef ScalarTraits<Scalar> ST;
   using Thyra::apply;
-  using Thyra::Vp_V;
   typedef Thyra::ModelEvaluatorBase MEB;
 
   //
@@ -361,6 +524,25 @@ void ForwardResponseSensitivityComputer<Scalar>::computeResponseAndSensitivityIm
   const bool computeSens = ( D_g_hat_D_p != 0 );
   createCache(computeSens);
 
+  // The response function gives DgDp for all of the parameters so it is
+  // written straight into D_g_hat_D_p only if they are all active.
+  const bool extractActiveDgDp =
+    ( computeSens && response_func_supports_D_p_ && !allParametersActive() );
+
+  if (computeSens) {
+    const int numActiveParams = activeParams_.size();
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      S->domain()->dim() != numActiveParams, std::logic_error,
+      "Error, S has " << S->domain()->dim() << " columns but there are "
+      << numActiveParams << " active parameters!"
+      );
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      D_g_hat_D_p->domain()->dim() != numActiveParams, std::logic_error,
+      "Error, D_g_hat_D_p has " << D_g_hat_D_p->domain()->dim()
+      << " columns but there are " << numActiveParams << " active parameters!"
+      );
+  }
+
   //
   // C) Evaluate the response function
   //
@@ -403,11 +585,15 @@ void ForwardResponseSensitivityComputer<Scalar>::computeResponseAndSensitivityIm
       MEB::Derivative<Scalar>(D_g_D_x_)
       );
     
-    // D_g_D_p
+    // D_g_D_p, written straight into D_g_hat_D_p if all of the parameters
+    // are active
     if (response_func_supports_D_p_) {
       responseOutArgs.set_DgDp(
         g_index_, p_index_,
-        MEB::Derivative<Scalar>(D_g_D_p_,MEB::DERIV_MV_BY_COL)
+        MEB::Derivative<Scalar>(
+          extractActiveDgDp ? D_g_D_p_ : rcp(D_g_hat_D_p,false),
+          MEB::DERIV_MV_BY_COL
+          )
         );
     }
     
@@ -419,14 +605,18 @@ void ForwardResponseSensitivityComputer<Scalar>::computeResponseAndSensitivityIm
     RYTHMOS_FUNC_TIME_MONITOR("Rythmos:ForwardResponseSensitivityComputer::evalModel: evalResponse");
     responseFunc_->evalModel( responseInArgs, responseOutArgs );
   }
+
+  // D_g_hat_D_p = DgDp(:,activeParams)
+  if (extractActiveDgDp)
+    Thyra::assign( ptr(D_g_hat_D_p), *D_g_D_p_->subView(activeParams_()) );
   
   // C.1.d) Print the outputs just coputed
   
   if (print_norms) {
     if (g_hat)
       *out << "\n||g_hat||inf = " << norm_inf(*g_hat) << std::endl;
-    if (computeSens && !is_null(D_g_D_p_))
-      *out << "\n||D_g_D_p_||inf = " << norms_inf(*D_g_D_p_) << std::endl;
+    if (computeSens && response_func_supports_D_p_)
+      *out << "\n||D_g_D_p||inf = " << norms_inf(*D_g_hat_D_p) << std::endl;
   }
   
   if ( g_hat && (dumpSensitivities_ || print_x) )
@@ -437,39 +627,37 @@ void ForwardResponseSensitivityComputer<Scalar>::computeResponseAndSensitivityIm
       *out << "\nD_g_D_x_dot = " << *D_g_D_x_ << std::endl;
     if (!is_null(D_g_D_x_))
       *out << "\nD_g_D_x = " << *D_g_D_x_ << std::endl;
-    if (!is_null(D_g_D_p_))
-      *out << "\nD_g_D_p = " << *D_g_D_p_ << std::endl;
+    if (response_func_supports_D_p_)
+      *out << "\nD_g_D_p = " << *D_g_hat_D_p << std::endl;
   }
   
   //
   // C.2) Assemble the output response function sensitivity D_d_hat_D_p
   //
 
-  // D_g_hat_D_p = DgDx_dot * S_dot + DgDx * S + DgDp 
+  // D_g_hat_D_p = DgDp + DgDx_dot * S_dot + DgDx * S
   
   if (computeSens) {
 
     RYTHMOS_FUNC_TIME_MONITOR("Rythmos:ForwardResponseSensitivityComputer::evalModel: computeSens");
     
     if (trace)
-      *out << "\nD_g_hat_D_p = DgDx_dot * S_dot + DgDx * S + DgDp ...\n";
-    
-    assign( ptr(D_g_hat_D_p), ST::zero() );
+      *out << "\nD_g_hat_D_p = DgDp + DgDx_dot * S_dot + DgDx * S ...\n";
+
+    // D_g_hat_D_p already holds DgDp if the response function has it, so
+    // the first product overwrites D_g_hat_D_p only when it does not.
+    Scalar beta = ( response_func_supports_D_p_ ? ST::one() : ST::zero() );
       
-    // D_g_hat_D_p += DgDx_dot * S_dot
+    // D_g_hat_D_p = DgDx_dot * S_dot + beta * D_g_hat_D_p
     if (response_func_supports_D_x_dot_) {
       apply( *D_g_D_x_dot_, Thyra::NOTRANS, *S_dot,
-        ptr(D_g_hat_D_p), ST::one(), ST::one() );
+        ptr(D_g_hat_D_p), ST::one(), beta );
+      beta = ST::one();
     }
     
-    // D_g_hat_D_p += DgDx * S
+    // D_g_hat_D_p = DgDx * S + beta * D_g_hat_D_p
     apply( *D_g_D_x_, Thyra::NOTRANS, *S,
-      ptr(D_g_hat_D_p), ST::one(), ST::one() );
-    
-    // D_g_hat_D_p += DgDp
-    if (response_func_supports_D_p_) {
-      Vp_V( ptr(D_g_hat_D_p), *D_g_D_p_ );
-    }
+      ptr(D_g_hat_D_p), ST::one(), beta );
       
     if (dumpSensitivities_ || print_x)
       *out << "\nD_g_hat_D_p = "
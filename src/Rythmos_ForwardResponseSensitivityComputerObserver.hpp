@@ -42,6 +42,11 @@ namespace Rythmos {
 /** \brief Observer class that computes sensitivities at the end of each time
  * step.
  *
+ * If response times are given with <tt>setResponseTimes()</tt>, the response
+ * and sensitivities are computed at these times instead.  All of the
+ * response times inside a step are done together after the step with
+ * <tt>ForwardResponseSensitivityComputer::computeResponsesAndSensitivities()</tt>.
+ *
  * ToDo: Finish Documentation
  */
 template<class Scalar>
@@ -64,6 +69,24 @@ public:
     const int g_index
     );
 
+  /** \brief Compute the response and sensitivities at the sorted times
+   * <tt>responseTimes</tt> instead of at the end of each time step.
+   *
+   * Response times outside of the integration time domain are skipped.
+   * Passing an empty array goes back to the end of each time step.
+   */
+  void setResponseTimes(const Array<Scalar> &responseTimes);
+
+  /** \brief Compute the reduced sensitivities for the active parameters
+   * <tt>activeParams</tt> of the forward sensitivity stepper.
+   *
+   * This must match <tt>ForwardSensitivityStepper::setActiveParameters()</tt>
+   * and must be called again whenever that is changed.  The stored
+   * <tt>D_g_hat_D_p</tt> then have a column for each active parameter (see
+   * <tt>ForwardResponseSensitivityComputer::setActiveParameters()</tt>).
+   */
+  void setActiveParameters(const ArrayView<const int> &activeParams);
+
   /** \brief . */
   const Array<ResponseAndFwdSensPoint<Scalar> >& responseAndFwdSensPoints() const;
 
@@ -98,6 +121,11 @@ private:
   RCP<Thyra::VectorBase<Scalar> > g_hat_;
   RCP<Thyra::MultiVectorBase<Scalar> > D_g_hat_D_p_;
 
+  Array<Scalar> responseTimes_;
+  int nextResponseTime_;
+
+  void computeAtResponseTimes(const StepperBase<Scalar> &stepper);
+
 };
 
 
@@ -145,6 +173,7 @@ forwardResponseSensitivityComputerObserver(
 
 template<class Scalar>
 ForwardResponseSensitivityComputerObserver<Scalar>::ForwardResponseSensitivityComputerObserver()
+  : nextResponseTime_(0)
 {}
 
 
@@ -163,6 +192,34 @@ void ForwardResponseSensitivityComputerObserver<Scalar>::initialize(
 }
 
 
+template<class Scalar>
+void ForwardResponseSensitivityComputerObserver<Scalar>::setResponseTimes(
+  const Array<Scalar> &responseTimes
+  )
+{
+  for (int i = 1; i < Teuchos::as<int>(responseTimes.size()); ++i) {
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      responseTimes[i] < responseTimes[i-1], std::logic_error,
+      "Error, the response times must be sorted but responseTimes["<<i<<"] = "
+      << responseTimes[i] << " < responseTimes["<<i-1<<"] = "
+      << responseTimes[i-1] << "!"
+      );
+  }
+  responseTimes_ = responseTimes;
+  nextResponseTime_ = 0;
+}
+
+
+template<class Scalar>
+void ForwardResponseSensitivityComputerObserver<Scalar>::setActiveParameters(
+  const ArrayView<const int> &activeParams
+  )
+{
+  forwardResponseSensitivityComputer_.setActiveParameters(activeParams);
+  D_g_hat_D_p_ = forwardResponseSensitivityComputer_.create_D_g_hat_D_p();
+}
+
+
 template<class Scalar>
 const Array<ResponseAndFwdSensPoint<Scalar> >&
 ForwardResponseSensitivityComputerObserver<Scalar>::responseAndFwdSensPoints() const
@@ -189,6 +246,15 @@ void ForwardResponseSensitivityComputerObserver<Scalar>::resetIntegrationObserve
   )
 {
   responseAndFwdSensPoints_.clear();
+  nextResponseTime_ = 0;
+  const int numResponseTimes = responseTimes_.size();
+  while (
+    nextResponseTime_ < numResponseTimes
+    && responseTimes_[nextResponseTime_] < integrationTimeDomain.lower()
+    )
+  {
+    ++nextResponseTime_;
+  }
 }
 
 
@@ -219,6 +285,11 @@ void ForwardResponseSensitivityComputerObserver<Scalar>::observeCompletedTimeSte
   if (trace)
     *out << "\nEntering ForwardResponseSensitivityComputerObserver<Scalar>::observeCompletedTimeStep(...) ...\n";
 
+  if (!responseTimes_.empty()) {
+    computeAtResponseTimes(stepper);
+    return;
+  }
+
   // A) Get x_bar and x_dot_bar for this time step
 
   const Scalar t = stepper.getStepStatus().time;
@@ -254,6 +325,57 @@ void ForwardResponseSensitivityComputerObserver<Scalar>::observeCompletedTimeSte
 }
 
 
+// private
+
+
+template<class Scalar>
+void ForwardResponseSensitivityComputerObserver<Scalar>::computeAtResponseTimes(
+  const StepperBase<Scalar> &stepper
+  )
+{
+
+  // A) Get the response times inside this time step
+
+  const TimeRange<Scalar> stepRange = stepper.getTimeRange();
+  const int numResponseTimes = responseTimes_.size();
+  Array<Scalar> time_vec;
+  while (
+    nextResponseTime_ < numResponseTimes
+    && responseTimes_[nextResponseTime_] <= stepRange.upper()
+    )
+  {
+    time_vec.push_back(responseTimes_[nextResponseTime_]);
+    ++nextResponseTime_;
+  }
+  if (time_vec.empty())
+    return;
+
+  // B) Compute the responses and reduced sensitivities into the storage for
+  // the new points
+
+  const int numTimes = time_vec.size();
+  Array<RCP<Thyra::VectorBase<Scalar> > > g_hat_vec(numTimes);
+  Array<RCP<Thyra::MultiVectorBase<Scalar> > > D_g_hat_D_p_vec(numTimes);
+  for (int i = 0; i < numTimes; ++i) {
+    g_hat_vec[i] = forwardResponseSensitivityComputer_.create_g_hat();
+    D_g_hat_D_p_vec[i] = forwardResponseSensitivityComputer_.create_D_g_hat_D_p();
+  }
+
+  forwardResponseSensitivityComputer_.computeResponsesAndSensitivities(
+    stepper, time_vec, g_hat_vec, D_g_hat_D_p_vec );
+
+  // C) Store these points
+
+  for (int i = 0; i < numTimes; ++i) {
+    responseAndFwdSensPoints_.push_back(
+      ResponseAndFwdSensPoint<Scalar>(
+        time_vec[i], g_hat_vec[i], D_g_hat_D_p_vec[i] )
+      );
+  }
+
+}
+
+
 } // namespace Rythmos
 
 
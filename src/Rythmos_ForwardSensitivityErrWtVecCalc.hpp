@@ -0,0 +1,224 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_FORWARD_SENSITIVITY_ERR_WT_VEC_CALC_H
+#define Rythmos_FORWARD_SENSITIVITY_ERR_WT_VEC_CALC_H
+
+#include "Rythmos_ErrWtVecCalcBase.hpp"
+#include "Rythmos_ImplicitBDFStepperErrWtVecCalc.hpp"
+#include "Thyra_ProductVectorBase.hpp"
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+
+namespace Rythmos {
+
+
+/** \brief Error weight vector calculator for the combined state and forward
+ * sensitivity vector <tt>x_bar = [ x; s_bar ]</tt> that leaves the
+ * sensitivities out of the local error test.
+ *
+ * The weights for all of <tt>x_bar</tt> are first computed with the wrapped
+ * state calculator.  The weights of the <tt>s_bar</tt> block are then set to
+ * zero and the weights of the <tt>x</tt> block are scaled by
+ * <tt>dim(x_bar)/dim(x)</tt>, so that the WRMS norm computed with these
+ * weights is the RMS norm over the state alone, as if the state had been
+ * integrated by itself with the wrapped calculator.  This scaling assumes
+ * that the wrapped calculator divides by the vector dimension, as
+ * <tt>ImplicitBDFStepperErrWtVecCalc</tt> does.
+ *
+ * This is used by <tt>ForwardSensitivityStepper</tt> for the simultaneous
+ * corrector method with "Sensitivity Error Control" turned off.
+ */
+template<class Scalar>
+class ForwardSensitivityErrWtVecCalc
+  : virtual public ErrWtVecCalcBase<Scalar>
+{
+  public:
+
+    /** \brief . */
+    ForwardSensitivityErrWtVecCalc();
+
+    /** \brief Set the calculator used for the state block.
+     *
+     * If <tt>stateErrWtVecCalc</tt> is null, an
+     * <tt>ImplicitBDFStepperErrWtVecCalc</tt> is used.
+     */
+    void initialize(const RCP<const ErrWtVecCalcBase<Scalar> >& stateErrWtVecCalc);
+
+    /** \brief . */
+    RCP<const ErrWtVecCalcBase<Scalar> > getStateErrWtVecCalc() const;
+
+    /** \brief . */
+    void errWtVecSet(
+         Thyra::VectorBase<Scalar>* weight
+         ,const Thyra::VectorBase<Scalar>& vector
+         ,Scalar relTol
+         ,Scalar absTol
+         ) const;
+
+    /** \name Overridden from ParameterListAcceptor */
+    //@{
+    /** \brief . */
+    void setParameterList(RCP<Teuchos::ParameterList> const& paramList);
+
+    /** \brief . */
+    RCP<Teuchos::ParameterList> getNonconstParameterList();
+
+    /** \brief . */
+    RCP<Teuchos::ParameterList> unsetParameterList();
+
+    /** \brief . */
+    RCP<const Teuchos::ParameterList> getValidParameters() const;
+
+    //@}
+
+  private:
+    RCP<const ErrWtVecCalcBase<Scalar> > stateErrWtVecCalc_;
+    RCP<Teuchos::ParameterList> paramList_;
+};
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates ForwardSensitivityErrWtVecCalc
+ */
+template<class Scalar>
+RCP<ForwardSensitivityErrWtVecCalc<Scalar> >
+forwardSensitivityErrWtVecCalc(
+  const RCP<const ErrWtVecCalcBase<Scalar> >& stateErrWtVecCalc
+  )
+{
+  RCP<ForwardSensitivityErrWtVecCalc<Scalar> >
+    errWtVecCalc = Teuchos::rcp(new ForwardSensitivityErrWtVecCalc<Scalar>());
+  errWtVecCalc->initialize(stateErrWtVecCalc);
+  return errWtVecCalc;
+}
+
+
+template<class Scalar>
+ForwardSensitivityErrWtVecCalc<Scalar>::ForwardSensitivityErrWtVecCalc()
+{}
+
+template<class Scalar>
+void ForwardSensitivityErrWtVecCalc<Scalar>::initialize(
+  const RCP<const ErrWtVecCalcBase<Scalar> >& stateErrWtVecCalc
+  )
+{
+  if (nonnull(stateErrWtVecCalc)) {
+    stateErrWtVecCalc_ = stateErrWtVecCalc;
+  }
+  else {
+    stateErrWtVecCalc_ = Teuchos::rcp(new ImplicitBDFStepperErrWtVecCalc<Scalar>());
+  }
+}
+
+template<class Scalar>
+RCP<const ErrWtVecCalcBase<Scalar> >
+ForwardSensitivityErrWtVecCalc<Scalar>::getStateErrWtVecCalc() const
+{
+  return stateErrWtVecCalc_;
+}
+
+template<class Scalar>
+void ForwardSensitivityErrWtVecCalc<Scalar>::errWtVecSet(
+     Thyra::VectorBase<Scalar>* weight
+     ,const Thyra::VectorBase<Scalar>& vector
+     ,Scalar relTol
+     ,Scalar absTol
+     ) const
+{
+  using Teuchos::as;
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  TEUCHOS_TEST_FOR_EXCEPT(weight==NULL);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+      is_null(stateErrWtVecCalc_), std::logic_error,
+      "Error, initialize(...) must be called first!\n");
+
+  stateErrWtVecCalc_->errWtVecSet(weight,vector,relTol,absTol);
+
+  Thyra::ProductVectorBase<Scalar> &w_bar =
+    Teuchos::dyn_cast<Thyra::ProductVectorBase<Scalar> >(*weight);
+  const RCP<Thyra::VectorBase<Scalar> > w = w_bar.getNonconstVectorBlock(0);
+  const int N_bar = vector.space()->dim();
+  const int N = w->space()->dim();
+  Thyra::Vt_S(w.ptr(), as<Scalar>(N_bar)/as<Scalar>(N));
+  Thyra::assign(w_bar.getNonconstVectorBlock(1).ptr(), ST::zero());
+
+  RCP<Teuchos::FancyOStream> out = this->getOStream();
+  Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+  Teuchos::OSTab ostab(out,1,"errWtVecSet");
+
+  if ( as<int>(verbLevel) >= as<int>(Teuchos::VERB_EXTREME) ) {
+    *out << "weight = " << std::endl;
+    weight->describe(*out,verbLevel);
+  }
+}
+
+template<class Scalar>
+void ForwardSensitivityErrWtVecCalc<Scalar>::setParameterList(
+  RCP<Teuchos::ParameterList> const& paramList
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(paramList == Teuchos::null);
+  paramList->validateParameters(*this->getValidParameters(),0);
+  paramList_ = paramList;
+  Teuchos::readVerboseObjectSublist(&*paramList_,this);
+}
+
+template<class Scalar>
+RCP<Teuchos::ParameterList>
+ForwardSensitivityErrWtVecCalc<Scalar>::unsetParameterList()
+{
+  RCP<Teuchos::ParameterList> temp_param_list = paramList_;
+  paramList_ = Teuchos::null;
+  return(temp_param_list);
+}
+
+template<class Scalar>
+RCP<Teuchos::ParameterList>
+ForwardSensitivityErrWtVecCalc<Scalar>::getNonconstParameterList()
+{
+  return(paramList_);
+}
+
+template<class Scalar>
+RCP<const Teuchos::ParameterList>
+ForwardSensitivityErrWtVecCalc<Scalar>::getValidParameters() const
+{
+  static RCP<Teuchos::ParameterList> validPL;
+  if (is_null(validPL)) {
+    RCP<Teuchos::ParameterList>
+      pl = Teuchos::parameterList();
+    Teuchos::setupVerboseObjectSublist(&*pl);
+    validPL = pl;
+  }
+  return (validPL);
+}
+
+} // namespace Rythmos
+
+#endif // Rythmos_FORWARD_SENSITIVITY_ERR_WT_VEC_CALC_H
@@ -32,6 +32,7 @@
 
 #include "Rythmos_IntegratorBase.hpp"
 #include "Rythmos_ForwardSensitivityModelEvaluatorBase.hpp"
+#include "Rythmos_ThreadPool.hpp"
 #include "Thyra_ModelEvaluator.hpp" // Interface
 #include "Thyra_StateFuncModelEvaluatorBase.hpp" // Implementation
 #include "Thyra_ModelEvaluatorDelegatorBase.hpp"
@@ -40,6 +41,11 @@
 #include "Thyra_DefaultMultiVectorLinearOpWithSolve.hpp"
 #include "Thyra_VectorStdOps.hpp"
 #include "Thyra_MultiVectorStdOps.hpp"
+#include "Teuchos_Range1D.hpp"
+
+#ifdef HAVE_RYTHMOS_THREADS
+#  include <thread>
+#endif
 
 
 namespace Rythmos {
@@ -120,6 +126,37 @@ namespace Rythmos {
  * in terms of a single <tt>Thyra::MultiVectorBase</tt> object (which has
  * <tt>np</tt> columns).
  *
+ * \section Rythmos_ForwardSensitivityExplicitModelEvaluator_threads_sec Parallel column evaluation
+ *
+ * By default <tt>d(f)/d(x)</tt> is applied to all of <tt>S</tt> in one
+ * multi-vector apply on the calling thread.  When <tt>d(f)/d(x)</tt> is a
+ * matrix-free operator that applies itself one column at a time (e.g. with
+ * directional derivatives of the state model), this is <tt>np</tt> serial
+ * evaluations.  With <tt>setNumThreads()</tt> the columns of <tt>S</tt> are
+ * instead split into contiguous blocks, one per thread, and each thread
+ * computes its block of columns of <tt>F_sens</tt>.  The threads write to
+ * disjoint columns, so the result does not depend on the number of threads.
+ *
+ * The calling thread computes <tt>d(f)/d(x)</tt> and <tt>d(f)/d(p)</tt> with
+ * the state model as before.  By default the other threads apply the same
+ * <tt>d(f)/d(x)</tt> object, whose <tt>apply()</tt> must then be safe to
+ * call concurrently on different multi-vectors.  Operators that keep
+ * mutable state, such as matrix-free operators that evaluate the state
+ * model, can instead be given per-thread copies of the state model with
+ * <tt>setThreadModels()</tt>.  Each of the other threads then computes its
+ * own <tt>d(f)/d(x)</tt> with its model at the same point.  Without thread
+ * support (<tt>HAVE_RYTHMOS_THREADS</tt>) the columns are always computed on
+ * the calling thread.  The column views of one multi-vector share its
+ * reference count, so Teuchos must be built with thread safe reference
+ * counting.  The threads come from a <tt>ThreadPool</tt> that is owned by
+ * this object and kept between evaluations, so no thread is started per
+ * residual evaluation, and as for <tt>EnsembleIntegrationDriver</tt> only
+ * the block of columns computed on the calling thread is timed.
+ *
+ * <tt>setActiveParameters()</tt> restricts <tt>S</tt> to the columns of a
+ * subset of the parameters, in which case only the active columns of
+ * <tt>d(f)/d(p)</tt> are used and the threads split the active columns.
+ *
  * ToDo: Finish documention!
  */
 template<class Scalar>
@@ -134,6 +171,31 @@ public:
   /** \brief . */
   ForwardSensitivityExplicitModelEvaluator();
 
+  /** \brief Set the number of threads that compute the sensitivity
+   * columns.
+   *
+   * The default of one computes all of the columns on the calling thread.
+   * Zero uses one thread per hardware thread.  No more threads than there
+   * are active sensitivity columns are ever used.  This is ignored unless Rythmos was built with
+   * thread support.
+   */
+  void setNumThreads(const int numThreads);
+
+  /** \brief . */
+  int getNumThreads() const;
+
+  /** \brief Give thread <tt>i>0</tt> its own state model
+   * <tt>threadModels[(i-1) % threadModels.size()]</tt> to compute
+   * <tt>d(f)/d(x)</tt> with.
+   *
+   * The models must describe the same problem as the state model passed to
+   * <tt>initializeStructure()</tt>, which is still used on the calling
+   * thread.  Passing an empty array shares <tt>d(f)/d(x)</tt> again.
+   */
+  void setThreadModels(
+    const Array<RCP<const Thyra::ModelEvaluator<Scalar> > > &threadModels
+    );
+
   //@}
 
   /** \name Public functions overridden from ForwardSensitivityModelEvaluatorBase. */
@@ -176,6 +238,12 @@ public:
       bool forceUpToDateW
       );
 
+  /** \brief . */
+  void setActiveParameters(const ArrayView<const int> &activeParams);
+
+  /** \brief . */
+  const Array<int>& getActiveParameters() const;
+
   //@}
 
   /** \name Public functions overridden from ModelEvaulator. */
@@ -217,6 +285,7 @@ private:
   RCP<const Thyra::ModelEvaluator<Scalar> > stateModel_;
   int p_index_;
   int np_;
+  Array<int> activeParams_;
 
   RCP<const Thyra::DefaultMultiVectorProductVectorSpace<Scalar> > s_bar_space_;
   RCP<const Thyra::DefaultMultiVectorProductVectorSpace<Scalar> > f_sens_space_;
@@ -231,11 +300,43 @@ private:
   mutable RCP<Thyra::LinearOpBase<Scalar> > DfDx_compute_;
   mutable RCP<Thyra::MultiVectorBase<Scalar> > DfDp_compute_;
 
+  int numThreadsRequested_;
+  Array<RCP<const Thyra::ModelEvaluator<Scalar> > > threadModels_;
+
+  // Column block of one thread, set up on the calling thread before the
+  // threads are started.
+  struct ThreadColumns {
+    RCP<const Thyra::MultiVectorBase<Scalar> > S;
+    RCP<Thyra::MultiVectorBase<Scalar> > F_sens;
+    RCP<const Thyra::MultiVectorBase<Scalar> > DfDp;
+    RCP<const Thyra::ModelEvaluator<Scalar> > model;
+    Thyra::ModelEvaluatorBase::InArgs<Scalar> inArgs;
+    RCP<Thyra::LinearOpBase<Scalar> > DfDx;
+  };
+  mutable Array<RCP<Thyra::LinearOpBase<Scalar> > > threadDfDx_;
+#ifdef HAVE_RYTHMOS_THREADS
+  mutable RCP<ThreadPool> threadPool_;
+#endif
+
   // /////////////////////////
   // Private member functions
 
   void wrapNominalValuesAndBounds();
 
+  void createSensSpaces();
+
+  RCP<const Thyra::MultiVectorBase<Scalar> > getActiveDfDp() const;
+
+  int numThreadsToUse() const;
+
+  void computeSensColumnsParallel(
+    const RCP<const Thyra::MultiVectorBase<Scalar> > &S,
+    const RCP<Thyra::MultiVectorBase<Scalar> > &F_sens,
+    const int numThreads
+    ) const;
+
+  void computeSensColumns(const ThreadColumns &columns) const;
+
   void computeDerivativeMatrices(
     const Thyra::ModelEvaluatorBase::InArgs<Scalar> &point
     ) const;
@@ -262,10 +363,43 @@ forwardSensitivityExplicitModelEvaluator()
 
 template<class Scalar>
 ForwardSensitivityExplicitModelEvaluator<Scalar>::ForwardSensitivityExplicitModelEvaluator()
-  : p_index_(0), np_(-1)
+  : p_index_(0), np_(-1), numThreadsRequested_(1)
 {}
 
 
+template<class Scalar>
+void ForwardSensitivityExplicitModelEvaluator<Scalar>::setNumThreads(
+  const int numThreads
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    numThreads < 0, std::logic_error,
+    "Error, numThreads = " << numThreads << " can not be negative!"
+    );
+  numThreadsRequested_ = numThreads;
+}
+
+
+template<class Scalar>
+int ForwardSensitivityExplicitModelEvaluator<Scalar>::getNumThreads() const
+{
+  return numThreadsRequested_;
+}
+
+
+template<class Scalar>
+void ForwardSensitivityExplicitModelEvaluator<Scalar>::setThreadModels(
+  const Array<RCP<const Thyra::ModelEvaluator<Scalar> > > &threadModels
+  )
+{
+  for (int i = 0; i < Teuchos::as<int>(threadModels.size()); ++i) {
+    TEUCHOS_TEST_FOR_EXCEPT(is_null(threadModels[i]));
+  }
+  threadModels_ = threadModels;
+  threadDfDx_.clear();
+}
+
+
 
 // Public functions overridden from ForwardSensitivityModelEvaluatorBase
 
@@ -301,17 +435,11 @@ void ForwardSensitivityExplicitModelEvaluator<Scalar>::initializeStructure(
   // Create the structure of the model
   //
 
-  s_bar_space_ = Thyra::multiVectorProductVectorSpace(
-    stateModel_->get_x_space(), np_
-    );
-
-  f_sens_space_ = Thyra::multiVectorProductVectorSpace(
-    stateModel_->get_f_space(), np_
-    );
-
-  nominalValues_ = this->createInArgs();
+  activeParams_.resize(np_);
+  for (int j = 0; j < np_; ++j)
+    activeParams_[j] = j;
 
-  this->wrapNominalValuesAndBounds();
+  createSensSpaces();
 
   //
   // Wipe out matrix storage
@@ -322,6 +450,7 @@ void ForwardSensitivityExplicitModelEvaluator<Scalar>::initializeStructure(
   DfDp_ = Teuchos::null;
   DfDx_compute_ = Teuchos::null;
   DfDp_compute_ = Teuchos::null;
+  threadDfDx_.clear();
 
 }
 
@@ -409,6 +538,29 @@ void ForwardSensitivityExplicitModelEvaluator<Scalar>::initializePointState(
 }
 
 
+template<class Scalar>
+void ForwardSensitivityExplicitModelEvaluator<Scalar>::setActiveParameters(
+  const ArrayView<const int> &activeParams
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(stateModel_), std::logic_error,
+    "Error, you must call intializeStructure(...) before you call setActiveParameters(...)"
+    );
+  assertValidActiveParameters(activeParams, np_);
+  activeParams_.assign(activeParams.begin(), activeParams.end());
+  createSensSpaces();
+}
+
+
+template<class Scalar>
+const Array<int>&
+ForwardSensitivityExplicitModelEvaluator<Scalar>::getActiveParameters() const
+{
+  return activeParams_;
+}
+
+
 // Public functions overridden from ModelEvaulator
 
 
@@ -545,15 +697,21 @@ void ForwardSensitivityExplicitModelEvaluator<Scalar>::evalModelImpl(
         Rythmos_FSEME
         );
 
-    // Form the residual:  df/dx * S + df/dp
-    // F_sens = df/dx * S
-    Thyra::apply(
-      *DfDx_, Thyra::NOTRANS,
-      *S, F_sens.ptr(),
-      ST::one(), ST::zero()
-      );
-    // F_sens += d(f)/d(p)
-    Vp_V( F_sens.ptr(), *DfDp_ );
+    const int numThreads = numThreadsToUse();
+    if (numThreads > 1) {
+      computeSensColumnsParallel(S, F_sens, numThreads);
+    }
+    else {
+      // Form the residual:  df/dx * S + df/dp
+      // F_sens = df/dx * S
+      Thyra::apply(
+        *DfDx_, Thyra::NOTRANS,
+        *S, F_sens.ptr(),
+        ST::one(), ST::zero()
+        );
+      // F_sens += d(f)/d(p)
+      Vp_V( F_sens.ptr(), *getActiveDfDp() );
+    }
   }
 
   THYRA_MODEL_EVALUATOR_DECORATOR_EVAL_MODEL_END();
@@ -591,6 +749,37 @@ void ForwardSensitivityExplicitModelEvaluator<Scalar>::wrapNominalValuesAndBound
 }
 
 
+template<class Scalar>
+void ForwardSensitivityExplicitModelEvaluator<Scalar>::createSensSpaces()
+{
+
+  const int numActive = Teuchos::as<int>(activeParams_.size());
+
+  s_bar_space_ = Thyra::multiVectorProductVectorSpace(
+    stateModel_->get_x_space(), numActive
+    );
+
+  f_sens_space_ = Thyra::multiVectorProductVectorSpace(
+    stateModel_->get_f_space(), numActive
+    );
+
+  nominalValues_ = this->createInArgs();
+
+  this->wrapNominalValuesAndBounds();
+
+}
+
+
+template<class Scalar>
+RCP<const Thyra::MultiVectorBase<Scalar> >
+ForwardSensitivityExplicitModelEvaluator<Scalar>::getActiveDfDp() const
+{
+  if (Teuchos::as<int>(activeParams_.size()) == np_)
+    return DfDp_;
+  return DfDp_->subView(activeParams_());
+}
+
+
 template<class Scalar>
 void ForwardSensitivityExplicitModelEvaluator<Scalar>::computeDerivativeMatrices(
   const Thyra::ModelEvaluatorBase::InArgs<Scalar> &/* point */
@@ -633,6 +822,100 @@ void ForwardSensitivityExplicitModelEvaluator<Scalar>::computeDerivativeMatrices
 }
 
 
+template<class Scalar>
+int ForwardSensitivityExplicitModelEvaluator<Scalar>::numThreadsToUse() const
+{
+  int numThreads = 1;
+#ifdef HAVE_RYTHMOS_THREADS
+  numThreads = numThreadsRequested_;
+  if (numThreads == 0)
+    numThreads = std::max(Teuchos::as<int>(std::thread::hardware_concurrency()), 1);
+#endif
+  // Never start more threads than there are columns.
+  const int numActive = Teuchos::as<int>(activeParams_.size());
+  return std::max(std::min(numThreads, numActive), 1);
+}
+
+
+template<class Scalar>
+void ForwardSensitivityExplicitModelEvaluator<Scalar>::computeSensColumnsParallel(
+  const RCP<const Thyra::MultiVectorBase<Scalar> > &S,
+  const RCP<Thyra::MultiVectorBase<Scalar> > &F_sens,
+  const int numThreads
+  ) const
+{
+
+  typedef Thyra::ModelEvaluatorBase MEB;
+
+  // The column views, in args and d(f)/d(x) objects of all of the threads
+  // are created here on the calling thread, so that the threads only
+  // evaluate and apply.
+  const int numModels = Teuchos::as<int>(threadModels_.size());
+  if (numModels > 0 && Teuchos::as<int>(threadDfDx_.size()) < numThreads)
+    threadDfDx_.resize(numThreads);
+  const RCP<const Thyra::MultiVectorBase<Scalar> > DfDp = getActiveDfDp();
+  const int numActive = Teuchos::as<int>(activeParams_.size());
+  Array<ThreadColumns> threadColumns(numThreads);
+  for (int i = 0; i < numThreads; ++i) {
+    ThreadColumns &columns = threadColumns[i];
+    const Teuchos::Range1D
+      cols( (i*numActive)/numThreads, ((i+1)*numActive)/numThreads - 1 );
+    columns.S = S->subView(cols);
+    columns.F_sens = F_sens->subView(cols);
+    columns.DfDp = DfDp->subView(cols);
+    columns.DfDx = DfDx_;
+    if (i > 0 && numModels > 0) {
+      columns.model = threadModels_[(i-1) % numModels];
+      if (is_null(threadDfDx_[i]))
+        threadDfDx_[i] = columns.model->create_W_op();
+      columns.DfDx = threadDfDx_[i];
+      columns.inArgs = columns.model->createInArgs();
+      columns.inArgs.setArgs(stateBasePoint_,true);
+      if (columns.inArgs.supports(MEB::IN_ARG_beta))
+        columns.inArgs.set_beta(1.0);
+    }
+  }
+
+#ifdef HAVE_RYTHMOS_THREADS
+  if (is_null(threadPool_) || threadPool_->getNumThreads() != numThreads)
+    threadPool_ = Teuchos::rcp(new ThreadPool(numThreads));
+  threadPool_->run(
+    [this, &threadColumns](int i) { computeSensColumns(threadColumns[i]); } );
+#else
+  for (int i = 0; i < numThreads; ++i) {
+    computeSensColumns(threadColumns[i]);
+  }
+#endif
+
+}
+
+
+template<class Scalar>
+void ForwardSensitivityExplicitModelEvaluator<Scalar>::computeSensColumns(
+  const ThreadColumns &columns
+  ) const
+{
+
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  typedef Thyra::ModelEvaluatorBase MEB;
+
+  if (nonnull(columns.model)) {
+    MEB::OutArgs<Scalar> outArgs = columns.model->createOutArgs();
+    outArgs.set_W_op(columns.DfDx);
+    columns.model->evalModel(columns.inArgs,outArgs);
+  }
+
+  // F_sens(:,cols) = df/dx * S(:,cols) + df/dp(:,cols)
+  Thyra::apply(
+    *columns.DfDx, Thyra::NOTRANS,
+    *columns.S, columns.F_sens.ptr(),
+    ST::one(), ST::zero()
+    );
+  Vp_V( columns.F_sens.ptr(), *columns.DfDp );
+
+}
+
+
 } // namespace Rythmos
 
 
@@ -34,6 +34,8 @@
 #include "Rythmos_ForwardSensitivityModelEvaluatorBase.hpp"
 #include "Rythmos_SolverAcceptingStepperBase.hpp"
 #include "Rythmos_SingleResidualModelEvaluator.hpp"
+#include "Rythmos_BlockSolveLinearOpWithSolve.hpp"
+#include "Rythmos_DirectionalDerivativeModelEvaluatorBase.hpp"
 #include "Thyra_ModelEvaluator.hpp" // Interface
 #include "Thyra_StateFuncModelEvaluatorBase.hpp" // Implementation
 #include "Thyra_DefaultProductVectorSpace.hpp"
@@ -45,6 +47,7 @@
 #include "Thyra_DefaultMultiVectorProductVector.hpp"
 #include "Thyra_DefaultMultiVectorLinearOpWithSolve.hpp"
 #include "Thyra_MultiVectorStdOps.hpp"
+#include "Thyra_VectorStdOps.hpp"
 #include "Teuchos_implicit_cast.hpp"
 #include "Teuchos_Assert.hpp"
 
@@ -296,6 +299,53 @@ namespace Rythmos {
  * <tt>d(f)/d(x_dot) * B_x_dot</tt> need only be computed once and can then be
  * reused each time.
  *
+ * When evaluating <tt>F_sens</tt>, the difference <tt>S_dot -
+ * (coeff_x_dot/coeff_x)*S</tt> is never formed.  Instead
+ * <tt>d(f)/d(x_dot)</tt> is applied to <tt>S_dot</tt> and to <tt>S</tt>
+ * with the scalar <tt>-coeff_x_dot/coeff_x</tt>, so that a residual
+ * evaluation does not allocate any multi-vector with <tt>np</tt> columns.
+ * The matrices <tt>d(f)/d(x_dot)</tt> and <tt>d(f)/d(p)</tt>, when they are
+ * computed here and not passed in, are created once per call to
+ * <tt>initializeStructure()</tt> and refilled at each new base point.
+ *
+ * \section Rythmos_ForwardSensitivityImplicitModelEvaluator_dd_sec Directional Derivatives
+ *
+ * For models with many parameters, forming <tt>d(f)/d(p)</tt> with
+ * <tt>np</tt> columns may not be possible.  With
+ * <tt>setDirectionalDerivatives(true)</tt>, <tt>F_sens</tt> is instead
+ * computed column by column as the directional derivative of <tt>f</tt> in
+ * the direction <tt>(S_dot(:,j),S(:,j),e_j)</tt>, which is exactly
+ * <tt>F_sens(:,j)</tt> above, and neither <tt>d(f)/d(x_dot)</tt> nor
+ * <tt>d(f)/d(p)</tt> is computed.  <tt>W_tilde</tt> is still used for
+ * <tt>W_hat</tt>.  If the state model implements
+ * <tt>DirectionalDerivativeModelEvaluatorBase</tt> (which is the
+ * <tt>F_sens_var</tt> operation above), all <tt>np</tt> columns are computed
+ * with one call to it.  Otherwise each column is approximated by the one-sided
+ * finite difference
+
+ \verbatim
+
+    F_sens(:,j) = ( f(x_dot+delta*S_dot(:,j),x+delta*S(:,j),p+delta*e_j) - f(x_dot,x,p) ) / delta
+
+    delta = h * ( 1 + ||(x_dot,x,p)||_inf ) / ||(S_dot(:,j),S(:,j),e_j)||_inf
+
+ \endverbatim
+
+ * with the relative step <tt>h</tt> set by
+ * <tt>setFiniteDifferenceStep()</tt>, which costs one evaluation of
+ * <tt>f</tt> per column plus one for <tt>f(x_dot,x,p)</tt> at each new base
+ * point.
+ *
+ * \section Rythmos_ForwardSensitivityImplicitModelEvaluator_active_sec Active Parameters
+ *
+ * <tt>setActiveParameters()</tt> restricts <tt>S</tt> to the columns of a
+ * subset of the parameters, so that the storage, the residual and the solves
+ * with <tt>W_tilde</tt> only involve the active columns.  The matrix
+ * <tt>d(f)/d(p)</tt> is still computed by the state model for all of the
+ * parameters, since <tt>Thyra::ModelEvaluator</tt> can not ask for some of
+ * its columns.  With directional derivatives, only the active columns are
+ * computed.
+ *
  * ToDo: Finish documention!
  */
 template<class Scalar>
@@ -304,6 +354,9 @@ class ForwardSensitivityImplicitModelEvaluator
 {
 public:
 
+  /** \brief . */
+  typedef typename Teuchos::ScalarTraits<Scalar>::magnitudeType ScalarMag;
+
   /** \name Constructors/Intializers/Accessors */
   //@{
 
@@ -341,6 +394,47 @@ public:
   /** \brief . */
   int get_p_index() const;
 
+  /** \brief Set the number of sensitivity columns passed to each solve with
+   * <tt>W_tilde</tt>.
+   *
+   * The <tt>np</tt> sensitivity columns all share the same state iteration
+   * matrix, so the <tt>W</tt> object computed by this model solves for them
+   * with one multi-vector solve with <tt>W_tilde</tt> by default
+   * (<tt>blockSize=0</tt>).  For a direct solver this is one
+   * back-substitution with <tt>np</tt> right-hand sides, and a block Krylov
+   * solver can iterate on all of the columns together.  A positive
+   * <tt>blockSize</tt> splits the solve into solves with at most
+   * <tt>blockSize</tt> columns each (see
+   * <tt>BlockSolveLinearOpWithSolve</tt>), e.g. to match the block size of an
+   * iterative solver or to bound its memory use.
+   */
+  void setSolveBlockSize(const int blockSize);
+
+  /** \brief . */
+  int getSolveBlockSize() const;
+
+  /** \brief Compute the sensitivity residual from directional derivatives of
+   * the state model instead of from <tt>d(f)/d(x_dot)</tt> and
+   * <tt>d(f)/d(p)</tt>.
+   *
+   * See the section on directional derivatives above.  Any
+   * <tt>DfDx_dot</tt> and <tt>DfDp</tt> passed to
+   * <tt>initializeState()</tt> are ignored in this mode.
+   */
+  void setDirectionalDerivatives(const bool directionalDerivatives);
+
+  /** \brief . */
+  bool getDirectionalDerivatives() const;
+
+  /** \brief Set the relative step <tt>h</tt> of the finite differences used
+   * in directional derivative mode when the state model does not implement
+   * <tt>DirectionalDerivativeModelEvaluatorBase</tt>.
+   */
+  void setFiniteDifferenceStep(const ScalarMag &h);
+
+  /** \brief . */
+  ScalarMag getFiniteDifferenceStep() const;
+
   /** \brief Set the state integrator that will be used to get x and x_dot at
    * various time points.
    *
@@ -478,6 +572,12 @@ public:
   /** \brief . */
   RCP<const Thyra::VectorSpaceBase<Scalar> > get_p_sens_space() const;
 
+  /** \brief . */
+  void setActiveParameters(const ArrayView<const int> &activeParams);
+
+  /** \brief . */
+  const Array<int>& getActiveParameters() const;
+
   //@}
 
   /** \name Public functions overridden from ModelEvaulator. */
@@ -535,6 +635,7 @@ private:
   int p_index_;
   RCP<const Thyra::VectorSpaceBase<Scalar> > p_space_;
   int np_;
+  Array<int> activeParams_;
 
   RCP<IntegratorBase<Scalar> > stateIntegrator_;
 
@@ -552,14 +653,34 @@ private:
   mutable RCP<const Thyra::MultiVectorBase<Scalar> > DfDp_;
 
   mutable RCP<Thyra::LinearOpWithSolveBase<Scalar> > W_tilde_compute_;
+  // Storage that computeDerivativeMatrices() fills when DfDx_dot_ or DfDp_
+  // was not passed in.  It is kept across base points: every evaluation
+  // overwrites all of it, and DfDx_dot_ and DfDp_ are never handed out, so
+  // nothing can observe the values of an earlier base point.
   mutable RCP<Thyra::LinearOpBase<Scalar> > DfDx_dot_compute_;
   mutable RCP<Thyra::MultiVectorBase<Scalar> > DfDp_compute_;
 
+  int solveBlockSize_;
+  mutable RCP<BlockSolveLinearOpWithSolve<Scalar> > W_tilde_block_;
+
+  bool directionalDerivatives_;
+  ScalarMag finiteDifferenceStep_;
+  mutable bool haveBaseResidual_;
+  mutable RCP<Thyra::VectorBase<Scalar> > f_base_;
+  mutable RCP<Thyra::VectorBase<Scalar> > x_dot_pert_;
+  mutable RCP<Thyra::VectorBase<Scalar> > x_pert_;
+  mutable RCP<Thyra::VectorBase<Scalar> > p_pert_;
+
   // /////////////////////////
   // Private member functions
 
   bool hasStateFuncParams() const { return p_index_ >= 0; }
 
+  bool allParamsActive() const
+    { return Teuchos::as<int>(activeParams_.size()) == np_; }
+
+  void createSensSpaces();
+
   void initializeStructureCommon(
     const RCP<const Thyra::ModelEvaluator<Scalar> > &stateModel,
     const int p_index,
@@ -572,6 +693,12 @@ private:
     const Thyra::ModelEvaluatorBase::InArgs<Scalar> &point
     ) const;
 
+  void computeDirectionalDerivatives(
+    const Thyra::MultiVectorBase<Scalar> &S_dot,
+    const Thyra::MultiVectorBase<Scalar> &S,
+    const Ptr<Thyra::MultiVectorBase<Scalar> > &F_sens
+    ) const;
+
 };
 
 
@@ -589,7 +716,10 @@ RCP<ForwardSensitivityImplicitModelEvaluator<Scalar> > forwardSensitivityImplici
 
 template<class Scalar>
 ForwardSensitivityImplicitModelEvaluator<Scalar>::ForwardSensitivityImplicitModelEvaluator()
-  : p_index_(0), np_(-1)
+  : p_index_(0), np_(-1), solveBlockSize_(0),
+    directionalDerivatives_(false),
+    finiteDifferenceStep_(1.0e-8),
+    haveBaseResidual_(false)
 {}
 
 
@@ -616,6 +746,63 @@ int ForwardSensitivityImplicitModelEvaluator<Scalar>::get_p_index() const
 }
 
 
+template<class Scalar>
+void ForwardSensitivityImplicitModelEvaluator<Scalar>::setSolveBlockSize(
+  const int blockSize
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    blockSize < 0, std::logic_error,
+    "Error, blockSize = " << blockSize << " can not be negative!"
+    );
+  solveBlockSize_ = blockSize;
+}
+
+
+template<class Scalar>
+int ForwardSensitivityImplicitModelEvaluator<Scalar>::getSolveBlockSize() const
+{
+  return solveBlockSize_;
+}
+
+
+template<class Scalar>
+void ForwardSensitivityImplicitModelEvaluator<Scalar>::setDirectionalDerivatives(
+  const bool directionalDerivatives
+  )
+{
+  directionalDerivatives_ = directionalDerivatives;
+}
+
+
+template<class Scalar>
+bool ForwardSensitivityImplicitModelEvaluator<Scalar>::getDirectionalDerivatives() const
+{
+  return directionalDerivatives_;
+}
+
+
+template<class Scalar>
+void ForwardSensitivityImplicitModelEvaluator<Scalar>::setFiniteDifferenceStep(
+  const ScalarMag &h
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !(h > Teuchos::ScalarTraits<ScalarMag>::zero()), std::logic_error,
+    "Error, the finite difference step h = " << h << " must be positive!"
+    );
+  finiteDifferenceStep_ = h;
+}
+
+
+template<class Scalar>
+typename ForwardSensitivityImplicitModelEvaluator<Scalar>::ScalarMag
+ForwardSensitivityImplicitModelEvaluator<Scalar>::getFiniteDifferenceStep() const
+{
+  return finiteDifferenceStep_;
+}
+
+
 template<class Scalar>
 void ForwardSensitivityImplicitModelEvaluator<Scalar>::setStateIntegrator(
   const RCP<IntegratorBase<Scalar> > &stateIntegrator,
@@ -706,6 +893,7 @@ void ForwardSensitivityImplicitModelEvaluator<Scalar>::initializePointState(
   coeff_x_ = coeff_x;
   DfDx_dot_ = Teuchos::null;
   DfDp_ = Teuchos::null;
+  haveBaseResidual_ = false;
 
   wrapNominalValuesAndBounds();
 
@@ -763,6 +951,7 @@ void ForwardSensitivityImplicitModelEvaluator<Scalar>::initializeState(
   coeff_x_ = coeff_x;
   DfDx_dot_ = DfDx_dot;
   DfDp_ = DfDp;
+  haveBaseResidual_ = false;
 
   wrapNominalValuesAndBounds();
 
@@ -808,6 +997,29 @@ ForwardSensitivityImplicitModelEvaluator<Scalar>::get_p_sens_space() const
 }
 
 
+template<class Scalar>
+void ForwardSensitivityImplicitModelEvaluator<Scalar>::setActiveParameters(
+  const ArrayView<const int> &activeParams
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(stateModel_), std::logic_error,
+    "Error, you must call intializeStructure(...) before you call setActiveParameters(...)"
+    );
+  assertValidActiveParameters(activeParams, np_);
+  activeParams_.assign(activeParams.begin(), activeParams.end());
+  createSensSpaces();
+}
+
+
+template<class Scalar>
+const Array<int>&
+ForwardSensitivityImplicitModelEvaluator<Scalar>::getActiveParameters() const
+{
+  return activeParams_;
+}
+
+
 // Public functions overridden from ModelEvaulator
 
 
@@ -911,7 +1123,10 @@ void ForwardSensitivityImplicitModelEvaluator<Scalar>::evalModelImpl(
   // given time!.
   //
 
-  {
+  if (directionalDerivatives_) {
+    TEUCHOS_ASSERT_EQUALITY( inArgs.get_t(), stateBasePoint_.get_t() );
+  }
+  else {
     RYTHMOS_FUNC_TIME_MONITOR_DIFF(
       "Rythmos:ForwardSensitivityImplicitModelEvaluator::evalModel: computeMatrices",
       RythmosFSIMEmain
@@ -967,25 +1182,41 @@ void ForwardSensitivityImplicitModelEvaluator<Scalar>::evalModelImpl(
       "Rythmos:ForwardSensitivityImplicitModelEvaluator::evalModel: computeSens",
       Rythmos_FSIME);
 
-    // S_diff =  -(coeff_x_dot/coeff_x)*S + S_dot
-    RCP<Thyra::MultiVectorBase<Scalar> >
-      S_diff = createMembers( stateModel_->get_x_space(), np_ );
-    V_StVpV( S_diff.ptr(), as<Scalar>(-coeff_x_dot_/coeff_x_), *S, *S_dot );
-    // F_sens = (1/coeff_x) * W_tilde * S
-    Thyra::apply(
-      *W_tilde_, Thyra::NOTRANS,
-      *S, F_sens.ptr(),
-      as<Scalar>(1.0/coeff_x_), ST::zero()
-      );
-    // F_sens += d(f)/d(x_dot) * S_diff
-    Thyra::apply(
-      *DfDx_dot_, Thyra::NOTRANS,
-      *S_diff, F_sens.ptr(),
-      ST::one(), ST::one()
-      );
-    // F_sens += d(f)/d(p)
-    if (hasStateFuncParams())
-      Vp_V( F_sens.ptr(), *DfDp_ );
+    if (directionalDerivatives_) {
+      computeDirectionalDerivatives(*S_dot, *S, F_sens.ptr());
+    }
+    else {
+      // Note: The term d(f)/d(x_dot) * ( S_dot - (coeff_x_dot/coeff_x)*S ) is
+      // applied as two products with the scalars folded into the apply so that
+      // no temporary multi-vector with np columns is created.
+      // F_sens = (1/coeff_x) * W_tilde * S
+      Thyra::apply(
+        *W_tilde_, Thyra::NOTRANS,
+        *S, F_sens.ptr(),
+        as<Scalar>(1.0/coeff_x_), ST::zero()
+        );
+      // F_sens += d(f)/d(x_dot) * S_dot
+      Thyra::apply(
+        *DfDx_dot_, Thyra::NOTRANS,
+        *S_dot, F_sens.ptr(),
+        ST::one(), ST::one()
+        );
+      // F_sens += -(coeff_x_dot/coeff_x) * d(f)/d(x_dot) * S
+      if (coeff_x_dot_ != ST::zero()) {
+        Thyra::apply(
+          *DfDx_dot_, Thyra::NOTRANS,
+          *S, F_sens.ptr(),
+          as<Scalar>(-coeff_x_dot_/coeff_x_), ST::one()
+          );
+      }
+      // F_sens += d(f)/d(p)
+      if (hasStateFuncParams()) {
+        if (allParamsActive())
+          Vp_V( F_sens.ptr(), *DfDp_ );
+        else
+          Vp_V( F_sens.ptr(), *DfDp_->subView(activeParams_()) );
+      }
+    }
   }
 
   if(nonnull(W_sens)) {
@@ -997,7 +1228,15 @@ void ForwardSensitivityImplicitModelEvaluator<Scalar>::evalModelImpl(
       beta != coeff_x_, std::logic_error,
       "Error, beta="<<beta<<" != coeff_x="<<coeff_x_
       <<" with difference = "<<(beta-coeff_x_)<<"!" );
-    W_sens->initialize( W_tilde_, s_bar_space_, f_sens_space_ );
+    if (solveBlockSize_ > 0) {
+      if (is_null(W_tilde_block_))
+        W_tilde_block_ = blockSolveLinearOpWithSolve<Scalar>();
+      W_tilde_block_->initialize( W_tilde_, solveBlockSize_ );
+      W_sens->initialize( W_tilde_block_, s_bar_space_, f_sens_space_ );
+    }
+    else {
+      W_sens->initialize( W_tilde_, s_bar_space_, f_sens_space_ );
+    }
 
   }
 
@@ -1056,15 +1295,11 @@ void ForwardSensitivityImplicitModelEvaluator<Scalar>::initializeStructureCommon
   // Create the structure of the model
   //
 
-  s_bar_space_ = Thyra::multiVectorProductVectorSpace(
-    stateModel_->get_x_space(), np_
-    );
-
-  f_sens_space_ = Thyra::multiVectorProductVectorSpace(
-    stateModel_->get_f_space(), np_
-    );
+  activeParams_.resize(np_);
+  for (int j = 0; j < np_; ++j)
+    activeParams_[j] = j;
 
-  nominalValues_ = this->createInArgs();
+  createSensSpaces();
 
   //
   // Wipe out matrix storage
@@ -1079,6 +1314,30 @@ void ForwardSensitivityImplicitModelEvaluator<Scalar>::initializeStructureCommon
   W_tilde_compute_ = Teuchos::null;
   DfDx_dot_compute_ = Teuchos::null;
   DfDp_compute_ = Teuchos::null;
+  haveBaseResidual_ = false;
+  f_base_ = Teuchos::null;
+  x_dot_pert_ = Teuchos::null;
+  x_pert_ = Teuchos::null;
+  p_pert_ = Teuchos::null;
+
+}
+
+
+template<class Scalar>
+void ForwardSensitivityImplicitModelEvaluator<Scalar>::createSensSpaces()
+{
+
+  const int numActive = Teuchos::as<int>(activeParams_.size());
+
+  s_bar_space_ = Thyra::multiVectorProductVectorSpace(
+    stateModel_->get_x_space(), numActive
+    );
+
+  f_sens_space_ = Thyra::multiVectorProductVectorSpace(
+    stateModel_->get_f_space(), numActive
+    );
+
+  nominalValues_ = this->createInArgs();
 
 }
 
@@ -1130,9 +1389,15 @@ void ForwardSensitivityImplicitModelEvaluator<Scalar>::computeDerivativeMatrices
     MEB::InArgs<Scalar> inArgs = stateBasePoint_;
     MEB::OutArgs<Scalar> outArgs = stateModel_->createOutArgs();
 
+    // The storage for d(f)/d(x_dot) and d(f)/d(p) is created once for the
+    // structure set in initializeStructure(...) and is refilled at every new
+    // base point.
+
     Teuchos::RCP<Thyra::LinearOpBase<Scalar> > DfDx_dot_compute;
     if (is_null(DfDx_dot_)) {
-      DfDx_dot_compute = stateModel_->create_W_op();
+      if (is_null(DfDx_dot_compute_))
+        DfDx_dot_compute_ = stateModel_->create_W_op();
+      DfDx_dot_compute = DfDx_dot_compute_;
       inArgs.set_alpha(1.0);
       inArgs.set_beta(0.0);
       outArgs.set_W_op(DfDx_dot_compute);
@@ -1140,10 +1405,13 @@ void ForwardSensitivityImplicitModelEvaluator<Scalar>::computeDerivativeMatrices
 
     Teuchos::RCP<Thyra::MultiVectorBase<Scalar> > DfDp_compute;
     if (is_null(DfDp_) && hasStateFuncParams()) {
-      DfDp_compute = Thyra::create_DfDp_mv(
-        *stateModel_, p_index_,
-        MEB::DERIV_MV_BY_COL
-        ).getMultiVector();
+      if (is_null(DfDp_compute_)) {
+        DfDp_compute_ = Thyra::create_DfDp_mv(
+          *stateModel_, p_index_,
+          MEB::DERIV_MV_BY_COL
+          ).getMultiVector();
+      }
+      DfDp_compute = DfDp_compute_;
       outArgs.set_DfDp(
         p_index_,
         MEB::Derivative<Scalar>(DfDp_compute,MEB::DERIV_MV_BY_COL)
@@ -1313,6 +1581,113 @@ void ForwardSensitivityImplicitModelEvaluator<Scalar>::computeDerivativeMatrices
 }
 
 
+template<class Scalar>
+void ForwardSensitivityImplicitModelEvaluator<Scalar>::computeDirectionalDerivatives(
+  const Thyra::MultiVectorBase<Scalar> &S_dot,
+  const Thyra::MultiVectorBase<Scalar> &S,
+  const Ptr<Thyra::MultiVectorBase<Scalar> > &F_sens
+  ) const
+{
+
+  using Teuchos::rcp_dynamic_cast;
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  typedef Teuchos::ScalarTraits<ScalarMag> SMT;
+  typedef Thyra::ModelEvaluatorBase MEB;
+  typedef Teuchos::VerboseObjectTempState<MEB> VOTSME;
+
+  Teuchos::RCP<Teuchos::FancyOStream> out = this->getOStream();
+  Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+  VOTSME stateModel_outputTempState(stateModel_,out,verbLevel);
+
+  // All of the columns with one call if the model can do it
+
+  const RCP<const DirectionalDerivativeModelEvaluatorBase<Scalar> >
+    ddStateModel =
+    rcp_dynamic_cast<const DirectionalDerivativeModelEvaluatorBase<Scalar> >(
+      stateModel_ );
+  if (nonnull(ddStateModel)) {
+    ddStateModel->evalDirectionalDerivatives(
+      stateBasePoint_, Teuchos::ptrFromRef(S_dot), Teuchos::ptrFromRef(S),
+      p_index_, activeParams_(), F_sens );
+    return;
+  }
+
+  // Otherwise one finite difference per column
+
+  if (is_null(f_base_)) {
+    f_base_ = Thyra::createMember(stateModel_->get_f_space());
+    x_dot_pert_ = Thyra::createMember(stateModel_->get_x_space());
+    x_pert_ = Thyra::createMember(stateModel_->get_x_space());
+    if (hasStateFuncParams())
+      p_pert_ = Thyra::createMember(p_space_);
+  }
+
+  const RCP<const Thyra::VectorBase<Scalar> >
+    x_dot = stateBasePoint_.get_x_dot(),
+    x = stateBasePoint_.get_x();
+  RCP<const Thyra::VectorBase<Scalar> > p;
+  if (hasStateFuncParams())
+    p = stateBasePoint_.get_p(p_index_);
+
+  if (!haveBaseResidual_) {
+    MEB::OutArgs<Scalar> outArgs = stateModel_->createOutArgs();
+    outArgs.set_f(f_base_);
+    stateModel_->evalModel(stateBasePoint_,outArgs);
+    haveBaseResidual_ = true;
+  }
+
+  ScalarMag baseNorm = std::max(Thyra::norm_inf(*x_dot), Thyra::norm_inf(*x));
+  if (hasStateFuncParams()) {
+    baseNorm = std::max(baseNorm, Thyra::norm_inf(*p));
+    Thyra::assign(p_pert_.ptr(), *p);
+  }
+
+  MEB::InArgs<Scalar> inArgs = stateBasePoint_;
+  inArgs.set_x_dot(x_dot_pert_);
+  inArgs.set_x(x_pert_);
+  if (hasStateFuncParams())
+    inArgs.set_p(p_index_, p_pert_);
+
+  const int numActive = Teuchos::as<int>(activeParams_.size());
+  for (int j = 0; j < numActive; ++j) {
+
+    const int pj = activeParams_[j];
+    const RCP<const Thyra::VectorBase<Scalar> >
+      S_dot_j = S_dot.col(j),
+      S_j = S.col(j);
+    const RCP<Thyra::VectorBase<Scalar> > F_j = F_sens->col(j);
+
+    ScalarMag dirNorm = std::max(Thyra::norm_inf(*S_dot_j), Thyra::norm_inf(*S_j));
+    if (hasStateFuncParams())
+      dirNorm = std::max(dirNorm, SMT::one());
+    if (dirNorm == SMT::zero()) {
+      Thyra::assign(F_j.ptr(), ST::zero());
+      continue;
+    }
+
+    const Scalar delta = finiteDifferenceStep_ * (SMT::one() + baseNorm) / dirNorm;
+
+    Thyra::V_StVpV(x_dot_pert_.ptr(), delta, *S_dot_j, *x_dot);
+    Thyra::V_StVpV(x_pert_.ptr(), delta, *S_j, *x);
+    if (hasStateFuncParams())
+      Thyra::set_ele(pj, Thyra::get_ele(*p,pj) + delta, p_pert_.ptr());
+
+    MEB::OutArgs<Scalar> outArgs = stateModel_->createOutArgs();
+    outArgs.set_f(F_j);
+    stateModel_->evalModel(inArgs,outArgs);
+
+    if (hasStateFuncParams())
+      Thyra::set_ele(pj, Thyra::get_ele(*p,pj), p_pert_.ptr());
+
+    // F_sens(:,j) = ( f(pert) - f(base) ) / delta
+    Thyra::Vp_StV(F_j.ptr(), -ST::one(), *f_base_);
+    Thyra::Vt_S(F_j.ptr(), ST::one()/delta);
+
+  }
+
+}
+
+
 } // namespace Rythmos
 
 
@@ -126,9 +126,58 @@ public:
       bool forceUpToDateW
       ) =0;
 
+  /** \brief Select the parameters whose sensitivities are computed.
+   *
+   * \param activeParams [in] Strictly increasing indexes into
+   * <tt>get_p_sens_space()</tt>.  Column <tt>k</tt> of <tt>S</tt> is then
+   * <tt>d(x)/d(p(activeParams[k]))</tt>.
+   *
+   * This changes <tt>get_s_bar_space()</tt>, <tt>get_x_space()</tt> and
+   * <tt>get_f_space()</tt> to have <tt>activeParams.size()</tt> columns.
+   * <tt>initializeStructure()</tt> makes all of the parameters active.
+   */
+  virtual void setActiveParameters(
+    const ArrayView<const int> &activeParams
+    ) = 0;
+
+  /** \brief The indexes of the parameters of the columns of <tt>S</tt>. */
+  virtual const Array<int>& getActiveParameters() const = 0;
+
 };
 
 
+/** \brief Throw if <tt>activeParams</tt> is not a non-empty strictly
+ * increasing array of indexes into a parameter space of dimension
+ * <tt>np</tt>.
+ *
+ * \relates ForwardSensitivityModelEvaluatorBase
+ */
+inline
+void assertValidActiveParameters(
+  const ArrayView<const int> &activeParams,
+  const int np
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    activeParams.size() == 0, std::logic_error,
+    "Error, at least one parameter must be active!"
+    );
+  for (int k = 0; k < activeParams.size(); ++k) {
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      !( 0 <= activeParams[k] && activeParams[k] < np ), std::logic_error,
+      "Error, activeParams["<<k<<"] = "<<activeParams[k]
+      <<" does not fall in the range [0,"<<(np-1)<<"]!"
+      );
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      k > 0 && !( activeParams[k-1] < activeParams[k] ), std::logic_error,
+      "Error, activeParams must be strictly increasing but activeParams["
+      <<(k-1)<<"] = "<<activeParams[k-1]<<" and activeParams["<<k<<"] = "
+      <<activeParams[k]<<"!"
+      );
+  }
+}
+
+
 /** \brief Create a wrapped non-const s_bar vector object given a non-const S
  * multi-vector object.
  */
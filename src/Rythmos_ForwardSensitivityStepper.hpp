@@ -37,6 +37,11 @@
 #include "Rythmos_ForwardSensitivityExplicitModelEvaluator.hpp"
 #include "Rythmos_StateAndForwardSensitivityModelEvaluator.hpp"
 #include "Rythmos_SolverAcceptingStepperBase.hpp"
+#include "Rythmos_StepControlStrategyAcceptingStepperBase.hpp"
+#include "Rythmos_ErrWtVecCalcAcceptingStepControlStrategyBase.hpp"
+#include "Rythmos_ForwardSensitivityErrWtVecCalc.hpp"
+#include "Rythmos_ImplicitBDFStepper.hpp"
+#include "Rythmos_ImplicitBDFStepperStepControl.hpp"
 #include "Rythmos_IntegratorBase.hpp"
 #include "Rythmos_SingleResidualModelEvaluatorBase.hpp"
 #include "Thyra_ModelEvaluatorHelpers.hpp"
@@ -45,6 +50,7 @@
 #include "Thyra_AssertOp.hpp"
 #include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
 #include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+#include "Teuchos_StandardParameterEntryValidators.hpp"
 #include "Teuchos_ConstNonconstObjectContainer.hpp"
 #include "Teuchos_Assert.hpp"
 #include "Teuchos_as.hpp"
@@ -53,6 +59,32 @@
 namespace Rythmos {
 
 
+/** \brief How <tt>ForwardSensitivityStepper</tt> solves the state and
+ * sensitivity equations over a timestep. */
+enum EForwardSensitivityMethod {
+  /** \brief Solve the state step first and then the sensitivity step with
+   * a separate stepper. */
+  FORWARD_SENSITIVITY_STAGGERED_CORRECTOR,
+  /** \brief Solve the state and sensitivities together as one system. */
+  FORWARD_SENSITIVITY_SIMULTANEOUS_CORRECTOR
+};
+
+
+/** \brief . */
+inline
+const char* toString(const EForwardSensitivityMethod sensitivityMethod)
+{
+  switch(sensitivityMethod) {
+    case FORWARD_SENSITIVITY_STAGGERED_CORRECTOR: return "Staggered Corrector";
+    case FORWARD_SENSITIVITY_SIMULTANEOUS_CORRECTOR: return "Simultaneous Corrector";
+#ifdef HAVE_RYTHMOS_DEBUG
+    default: TEUCHOS_TEST_FOR_EXCEPT(true);
+#endif
+  }
+  return ""; // Never be called!
+}
+
+
 /** \brief Foward sensitivity stepper concrete subclass.
  *
  * This class provides a very general implemenation of a forward sensitivity
@@ -144,21 +176,16 @@ namespace Rythmos {
  * and Linda Petzold.  The three ways are the <em>simultaneous corrector</em>,
  * the <em>staggered direct</em> and the <em>staggered corrector</em> methods.
  *
- * The <em>simultaneous corrector</em> method would be equivalent to forming
- * one big ModelEvaluator for the state and sensitivities where the "state"
- * variables would be the <tt>x_bar</tt> variables described above and then
- * this big system would be solved with a single stepper object and as single
+ * The <em>simultaneous corrector</em> method is equivalent to forming one
+ * big ModelEvaluator for the state and sensitivities where the "state"
+ * variables are the <tt>x_bar</tt> variables described above and then
+ * solving this big system with a single stepper object and a single
  * nonlinear solver.  The advantage of this approach is that it makes great
- * reuse of all of the timestepping software.  Also, by being able to
- * specialize the nonlinear solver (which you can't do in most software) you
- * could set up the nonlinear solver to first solve the nonlinear state
- * timestep equation, and then solve the linear sensitivity equations.  The
- * problem with this approach would be that it would be very wasteful if the
- * timestep had to be cut back in order to reduce the local truncation error
- * of the state solution.  This would result in the sensitivity solution being
- * thrown away for each cut-back iteration.  Because of this fundamental
- * problem, we have not implemented the simultaneous corrector method.
- * Actually, we are not really sure why anyone implements ths method.
+ * reuse of all of the timestepping software and that the local error test of
+ * the stepper can include the sensitivities, so a step whose sensitivities
+ * are not accurate enough is rejected and cut back like any other.  The
+ * disadvantage is that the sensitivity solution is thrown away along with
+ * the state solution for each cut-back iteration.
  *
  * The <em>staggered direct</em> and <em>staggered corrector</em> methods are
  * similar in several ways.  In each method, the state timestep is first fully
@@ -176,26 +203,68 @@ namespace Rythmos {
  * (assuming the linear solver tolerance is made tight enough) with no harm
  * done.
  *
- * Because of the advantages of the staggered corrector method over the other
- * methods, the staggered corrector method is what is implemented in this
- * stepper class.  However, the term "corrector" is not really appropriate to
- * be used in the context of this class since this class does not have to
- * assume anything about how timesteps are computed and does not care if a
+ * This stepper class implements the staggered corrector method and the
+ * simultaneous corrector method, selected with the "Sensitivity Method"
+ * parameter.  However, the term "corrector" is not really appropriate to be
+ * used in the context of this class since this class does not have to assume
+ * anything about how timesteps are computed and does not care if a
  * predictor/corrector method is used or not.
  *
- * While this class does provide a full ModelEvaluator for the full state plus
- * forward sensitivity DAE <tt>f_bar(x_bar_hat,x_bar)</tt> it is not solved
- * all at one time as described above.  Instead, the step is solved first for
- * the state equation and then a ModelEvaluator for just the linear forward
- * sensitivity equations is formed and is solved over the same time step as
- * the forward solve.
+ * With the default "Staggered Corrector" method, the full state plus forward
+ * sensitivity DAE <tt>f_bar(x_bar_hat,x_bar)</tt> is not solved all at one
+ * time.  Instead, the step is solved first for the state equation and then a
+ * ModelEvaluator for just the linear forward sensitivity equations is formed
+ * and is solved over the same time step as the forward solve.  Timestep
+ * control is then not performed for the forward sensitivity variables, since
+ * reducing the timestep for the sensitivity variables would require an
+ * "undoStep()" operation for the state stepper object and this is not
+ * currently supported by the <tt>StepperBase</tt> interface.
+ *
+ * With the "Simultaneous Corrector" method, the state stepper integrates the
+ * <tt>StateAndForwardSensitivityModelEvaluator</tt> directly with the state
+ * timestep solver.  Its iteration matrix is block diagonal with the state
+ * <tt>W</tt> in every block, so each Newton iteration uses one factorization
+ * of <tt>W</tt> for the state and all of the sensitivities.  If
+ * "Sensitivity Error Control" is true, the local error test of the stepper
+ * is done on all of <tt>x_bar</tt>, as with the "errconS" option of CVODES
+ * and IDAS.  If it is false, the sensitivities are solved for together with
+ * the state but left out of the local error test by giving the stepper's
+ * step control a <tt>ForwardSensitivityErrWtVecCalc</tt> object, so that
+ * the same timesteps are taken as with the staggered corrector method.  This
+ * requires a step control that accepts an <tt>ErrWtVecCalcBase</tt> object
+ * (e.g. <tt>ImplicitBDFStepperStepControl</tt>, which is created here for
+ * an <tt>ImplicitBDFStepper</tt> that has no step control yet).  Other step
+ * controls are left alone and control the error in all of <tt>x_bar</tt>.
+ *
+ * With either method the <tt>np</tt> sensitivity columns are solved for
+ * with the same state <tt>W</tt>.  By default all of them are passed to
+ * the linear solver in one multi-vector solve, so that a direct solver
+ * does one back-substitution with <tt>np</tt> right-hand sides and a block
+ * Krylov solver can iterate on all of them together.  The parameter
+ * "Sensitivity Solve Block Size" limits the number of columns in each of
+ * these solves (see <tt>BlockSolveLinearOpWithSolve</tt>).
  *
- * Currently, timestep control is not performed for the forward sensitivity
- * variables.  In the future, however, it would not be too difficult to allow
- * for the timestep to be reduced for the sensitivity variables but this would
- * require a "undoStep()" operation be implimented for the state stepper
- * object and this is not currently supported by the <tt>StepperBase</tt>
- * interface.
+ * For an explicit state model the sensitivity residual
+ * <tt>d(f)/d(x)*S + d(f)/d(p)</tt> can be computed by several threads, each
+ * for its own block of columns, with the parameter "Number of Sensitivity
+ * Threads" and <tt>setSensitivityThreadModels()</tt> (see
+ * <tt>ForwardSensitivityExplicitModelEvaluator</tt>).
+ *
+ * For an implicit state model with the staggered corrector method,
+ * "Directional Derivative Sensitivities" computes the sensitivity residual
+ * from directional derivatives of the state residual in the directions of
+ * the sensitivity columns, so that <tt>d(f)/d(p)</tt> and
+ * <tt>d(f)/d(x_dot)</tt> are never formed.  The derivatives come from the
+ * state model in one call if it implements
+ * <tt>DirectionalDerivativeModelEvaluatorBase</tt> and from finite
+ * differences with the relative step "Sensitivity Finite Difference Step"
+ * otherwise (see <tt>ForwardSensitivityImplicitModelEvaluator</tt>).
+ *
+ * <tt>setActiveParameters()</tt> restricts the sensitivities to a subset of
+ * the parameters, before the integration starts or between any two steps,
+ * so that the storage for <tt>S</tt>, the sensitivity residuals and the
+ * multi-vector solves only involve the columns of the active parameters.
+ * The stepper does not have to be built again to add or remove parameters.
  *
  *
  * 2007/15/21: rabart: ToDo: This class only works for implicit models and
@@ -270,9 +339,12 @@ public:
    * therefore this hook is exposed to clients.
    *
    * Here <tt>*this</tt> is set up to synchronize the state and sensitivity
-   * solvers.  Currently, error control is only done by the state stepper and
-   * not the sensitivity stepper but the overall implementation has a high
-   * degree of resuse and will therefore compute sensitivities quite fast.
+   * solvers.  With the default "Staggered Corrector" method, error control is
+   * only done by the state stepper and not the sensitivity stepper but the
+   * overall implementation has a high degree of resuse and will therefore
+   * compute sensitivities quite fast.  See the "Sensitivity Method" and
+   * "Sensitivity Error Control" parameters for controlling the error in the
+   * sensitivities.
    */
   void initializeSyncedSteppers(
     const RCP<const Thyra::ModelEvaluator<Scalar> > &stateModel,
@@ -303,10 +375,8 @@ public:
    * \param sensTimeStepSolver [in,persisting] See initializeSyncedSteppers().
    *
    * Here <tt>*this</tt> is set up to synchronize the state and sensitivity
-   * solvers for an initial-condition only forward sensitivity problem.
-   * Currently, error control is only done by the state stepper and not the
-   * sensitivity stepper but the overall implementation has a high degree of
-   * resuse and will therefore compute sensitivities quite fast.
+   * solvers for an initial-condition only forward sensitivity problem.  See
+   * <tt>initializeSyncedSteppers()</tt> for how the error is controlled.
    */
   void initializeSyncedSteppersInitCondOnly(
     const RCP<const Thyra::ModelEvaluator<Scalar> >& stateModel,
@@ -351,7 +421,8 @@ public:
    * completely independently; each with the their own error control
    * strategies.  The state stepper in driven through the state integrator
    * which in turn is driven by the ForwardSensitivityModelEvaluatorBase that is
-   * driven by the sens stepper.
+   * driven by the sens stepper.  The "Simultaneous Corrector" method can not
+   * be used with decoupled steppers.
    */
   void initializeDecoupledSteppers(
     const RCP<const Thyra::ModelEvaluator<Scalar> > &stateModel,
@@ -395,6 +466,54 @@ public:
   RCP<const StateAndForwardSensitivityModelEvaluator<Scalar> >
   getStateAndFwdSensModel() const;
 
+  /** \brief Give the threads that compute the sensitivity columns of an
+   * explicit state model their own copies of the state model.
+   *
+   * See <tt>ForwardSensitivityExplicitModelEvaluator::setThreadModels()</tt>
+   * and the parameter "Number of Sensitivity Threads".  This can be called
+   * before or after the initialize function and is ignored for implicit
+   * state models.
+   */
+  void setSensitivityThreadModels(
+    const Array<RCP<const Thyra::ModelEvaluator<Scalar> > > &threadModels
+    );
+
+  /** \brief Only compute the sensitivities for the parameters
+   * <tt>activeParams</tt>.
+   *
+   * \param activeParams [in] Strictly increasing indexes of the active
+   * parameters in <tt>p(p_index)</tt>.  Column <tt>k</tt> of <tt>S</tt> is
+   * then the sensitivity with respect to <tt>p(activeParams[k])</tt>.
+   *
+   * <b>Preconditions:</b><ul>
+   * <li> One of the <tt>initializeSyncedSteppers*()</tt> functions has been
+   *      called.  Decoupled steppers are not supported.
+   * </ul>
+   *
+   * This can be called before the initial condition is set or between any
+   * two steps.  All parameters are active after initialization.  The
+   * spaces of <tt>getModel()</tt> change to the number of active
+   * parameters, so the initial condition must be given in the new spaces if
+   * it is set afterwards.
+   *
+   * Once the initial condition has been set, the current sensitivities of
+   * the parameters that stay active are kept and the sensitivities of newly
+   * activated parameters start at zero, i.e. they are the sensitivities to a
+   * change of the parameter from the current time on.  The integration is
+   * restarted from the current time with a clone of the stepper for the
+   * sensitivities (the state stepper with the "Simultaneous Corrector"
+   * method, so <tt>getNonconstStateStepper()</tt> returns a new object), so
+   * the stepper must support <tt>cloneStepperAlgorithm()</tt> and a
+   * multistep stepper loses its history.  Points before the current time
+   * can no longer be interpolated and <tt>getInitialCondition()</tt> still
+   * returns the original initial condition.
+   */
+  void setActiveParameters(const ArrayView<const int> &activeParams);
+
+  /** \brief The active parameters set with
+   * <tt>setActiveParameters()</tt>. */
+  const Array<int>& getActiveParameters() const;
+
   //@}
 
   /** \name Overridden from Teuchos::ParameterListAcceptor */
@@ -425,9 +544,10 @@ public:
 
   /** \brief Returns <tt>getStateAndFwdSensModel()</tt>.
    *
-   * Warning, currently the returned model does not implement evalModel(...)
-   * or define a W object.  It is just used for getting the spaces and for
-   * creating an InArgs object for setting the initial condition.
+   * With the "Staggered Corrector" method, this model is just used for
+   * getting the spaces and for creating an InArgs object for setting the
+   * initial condition.  With the "Simultaneous Corrector" method, it is also
+   * the model that the state stepper integrates.
    */
   RCP<const Thyra::ModelEvaluator<Scalar> > getModel() const;
 
@@ -543,6 +663,13 @@ private:
   // Private data members
 
   bool forceUpToDateW_;
+  EForwardSensitivityMethod sensitivityMethod_;
+  bool sensitivityErrorControl_;
+  int sensitivitySolveBlockSize_;
+  int numSensitivityThreads_;
+  bool directionalDerivatives_;
+  double finiteDifferenceStep_;
+  Array<RCP<const Thyra::ModelEvaluator<Scalar> > > sensitivityThreadModels_;
   CNCME stateModel_;
   Thyra::ModelEvaluatorBase::InArgs<Scalar> stateBasePoint_;
   RCP<StepperBase<Scalar> > stateStepper_;
@@ -561,6 +688,24 @@ private:
   static const std::string forceUpToDateW_name_;
   static const bool forceUpToDateW_default_;
 
+  static const std::string sensitivityMethod_name_;
+  static const std::string sensitivityMethod_default_;
+
+  static const std::string sensitivityErrorControl_name_;
+  static const bool sensitivityErrorControl_default_;
+
+  static const std::string sensitivitySolveBlockSize_name_;
+  static const int sensitivitySolveBlockSize_default_;
+
+  static const std::string numSensitivityThreads_name_;
+  static const int numSensitivityThreads_default_;
+
+  static const std::string directionalDerivatives_name_;
+  static const bool directionalDerivatives_default_;
+
+  static const std::string finiteDifferenceStep_name_;
+  static const double finiteDifferenceStep_default_;
+
   // /////////////////////////
   // Private member functions
 
@@ -581,8 +726,36 @@ private:
     const RCP<Thyra::NonlinearSolverBase<Scalar> > &sensTimeStepSolver
     );
 
+  bool useSimultaneousCorrector() const
+    { return sensitivityMethod_ == FORWARD_SENSITIVITY_SIMULTANEOUS_CORRECTOR; }
+
+  // Give the steppers their models and solvers for the current
+  // "Sensitivity Method".
+  void setupSteppers();
+
+  // Add or remove the ForwardSensitivityErrWtVecCalc object on the state
+  // stepper's step control for the current parameters.
+  void setupErrWtVecCalc();
+
+  // Clone a stepper whose model spaces have changed and give it its model
+  // and solver.
+  RCP<StepperBase<Scalar> > cloneSubStepper(
+    const StepperBase<Scalar> &stepper,
+    const RCP<const Thyra::ModelEvaluator<Scalar> > &model,
+    const RCP<Thyra::NonlinearSolverBase<Scalar> > &solver
+    ) const;
+
+  // Copy the columns of s_bar_old for the parameters that are still active
+  // into a new s_bar and zero the columns of the new active parameters.
+  RCP<Thyra::VectorBase<Scalar> > remapSensColumns(
+    const Thyra::VectorBase<Scalar> &s_bar_old,
+    const ArrayView<const int> &oldActiveParams
+    ) const;
+
   Scalar takeSyncedStep( Scalar dt, StepSizeType stepType );
 
+  Scalar takeSimultaneousStep( Scalar dt, StepSizeType stepType );
+
   Scalar takeDecoupledStep( Scalar dt, StepSizeType stepType );
 
 };
@@ -772,6 +945,54 @@ template<class Scalar>
 const bool ForwardSensitivityStepper<Scalar>::forceUpToDateW_default_
 = true;
 
+template<class Scalar>
+const std::string ForwardSensitivityStepper<Scalar>::sensitivityMethod_name_
+= "Sensitivity Method";
+
+template<class Scalar>
+const std::string ForwardSensitivityStepper<Scalar>::sensitivityMethod_default_
+= "Staggered Corrector";
+
+template<class Scalar>
+const std::string ForwardSensitivityStepper<Scalar>::sensitivityErrorControl_name_
+= "Sensitivity Error Control";
+
+template<class Scalar>
+const bool ForwardSensitivityStepper<Scalar>::sensitivityErrorControl_default_
+= false;
+
+template<class Scalar>
+const std::string ForwardSensitivityStepper<Scalar>::sensitivitySolveBlockSize_name_
+= "Sensitivity Solve Block Size";
+
+template<class Scalar>
+const int ForwardSensitivityStepper<Scalar>::sensitivitySolveBlockSize_default_
+= 0;
+
+template<class Scalar>
+const std::string ForwardSensitivityStepper<Scalar>::numSensitivityThreads_name_
+= "Number of Sensitivity Threads";
+
+template<class Scalar>
+const int ForwardSensitivityStepper<Scalar>::numSensitivityThreads_default_
+= 1;
+
+template<class Scalar>
+const std::string ForwardSensitivityStepper<Scalar>::directionalDerivatives_name_
+= "Directional Derivative Sensitivities";
+
+template<class Scalar>
+const bool ForwardSensitivityStepper<Scalar>::directionalDerivatives_default_
+= false;
+
+template<class Scalar>
+const std::string ForwardSensitivityStepper<Scalar>::finiteDifferenceStep_name_
+= "Sensitivity Finite Difference Step";
+
+template<class Scalar>
+const double ForwardSensitivityStepper<Scalar>::finiteDifferenceStep_default_
+= 1.0e-8;
+
 
 // Constructors, Intializers, Misc.
 
@@ -779,6 +1000,12 @@ const bool ForwardSensitivityStepper<Scalar>::forceUpToDateW_default_
 template<class Scalar>
 ForwardSensitivityStepper<Scalar>::ForwardSensitivityStepper()
   :forceUpToDateW_(false),
+   sensitivityMethod_(FORWARD_SENSITIVITY_STAGGERED_CORRECTOR),
+   sensitivityErrorControl_(sensitivityErrorControl_default_),
+   sensitivitySolveBlockSize_(sensitivitySolveBlockSize_default_),
+   numSensitivityThreads_(numSensitivityThreads_default_),
+   directionalDerivatives_(directionalDerivatives_default_),
+   finiteDifferenceStep_(finiteDifferenceStep_default_),
    isSingleResidualStepper_(false)
 {}
 
@@ -830,6 +1057,11 @@ void ForwardSensitivityStepper<Scalar>::initializeDecoupledSteppers(
   )
 {
   TEUCHOS_ASSERT(nonnull(stateIntegrator));
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    useSimultaneousCorrector(), std::logic_error,
+    "Error, the \""<<toString(sensitivityMethod_)<<"\" method can not be"
+    " used with decoupled steppers!"
+    );
   initializeCommon( stateModel, p_index, Teuchos::null, stateBasePoint, stateStepper,
     stateTimeStepSolver, sensStepper, sensTimeStepSolver );
   stateIntegrator_ = stateIntegrator;
@@ -876,6 +1108,130 @@ ForwardSensitivityStepper<Scalar>::getStateAndFwdSensModel() const
 }
 
 
+template<class Scalar>
+void ForwardSensitivityStepper<Scalar>::setSensitivityThreadModels(
+  const Array<RCP<const Thyra::ModelEvaluator<Scalar> > > &threadModels
+  )
+{
+  sensitivityThreadModels_ = threadModels;
+  if (nonnull(stateStepper_))
+    setupSteppers();
+}
+
+
+template<class Scalar>
+void ForwardSensitivityStepper<Scalar>::setActiveParameters(
+  const ArrayView<const int> &activeParams
+  )
+{
+
+  typedef Thyra::ModelEvaluatorBase MEB;
+
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(sensModel_), std::logic_error,
+    "Error, one of the initialize functions must be called before\n"
+    "setActiveParameters(...)!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    nonnull(stateIntegrator_), std::logic_error,
+    "Error, the active parameters can not be changed for decoupled steppers!"
+    );
+
+  // Get the current state and sensitivities before the spaces change
+
+  const bool haveInitialCondition =
+    ( stateAndSensBasePoint_.supports(MEB::IN_ARG_x)
+      && nonnull(stateAndSensBasePoint_.get_x()) );
+
+  StepStatus<Scalar> stepStatus;
+  RCP<const Thyra::ProductVectorBase<Scalar> > x_bar, x_bar_dot;
+  if (haveInitialCondition) {
+    stepStatus = this->getStepStatus();
+    TEUCHOS_TEST_FOR_EXCEPT(is_null(stepStatus.solution));
+    x_bar = Thyra::productVectorBase<Scalar>(stepStatus.solution);
+    if (nonnull(stepStatus.solutionDot))
+      x_bar_dot = Thyra::productVectorBase<Scalar>(stepStatus.solutionDot);
+  }
+
+  const Array<int> oldActiveParams = sensModel_->getActiveParameters();
+
+  // Change the spaces of the models
+
+  sensModel_->setActiveParameters(activeParams);
+  stateAndSensModel_->initializeStructure(sensModel_);
+
+  // Restart the integration from the current time with fresh steppers for
+  // the new spaces
+
+  if (useSimultaneousCorrector()) {
+    stateStepper_ = cloneSubStepper(
+      *stateStepper_, stateAndSensModel_, stateTimeStepSolver_ );
+  }
+  else {
+    sensStepper_ = cloneSubStepper(
+      *sensStepper_, sensModel_, sensTimeStepSolver_ );
+  }
+
+  if (haveInitialCondition) {
+
+    MEB::InArgs<Scalar> basePoint_no_x = stateAndSensBasePoint_;
+    basePoint_no_x.set_x(Teuchos::null);
+    if (basePoint_no_x.supports(MEB::IN_ARG_x_dot))
+      basePoint_no_x.set_x_dot(Teuchos::null);
+
+    const RCP<Thyra::VectorBase<Scalar> >
+      s_bar = remapSensColumns(*x_bar->getVectorBlock(1), oldActiveParams());
+    RCP<Thyra::VectorBase<Scalar> > s_bar_dot;
+    if (nonnull(x_bar_dot)) {
+      s_bar_dot =
+        remapSensColumns(*x_bar_dot->getVectorBlock(1), oldActiveParams());
+    }
+
+    if (useSimultaneousCorrector()) {
+      MEB::InArgs<Scalar> state_and_sens_ic = stateAndSensModel_->createInArgs();
+      state_and_sens_ic.setArgs(basePoint_no_x,true,true);
+      state_and_sens_ic.set_t(stepStatus.time);
+      state_and_sens_ic.set_x(
+        stateAndSensModel_->create_x_bar_vec(
+          x_bar->getVectorBlock(0)->clone_v(), s_bar ) );
+      if (state_and_sens_ic.supports(MEB::IN_ARG_x_dot) && nonnull(x_bar_dot)) {
+        state_and_sens_ic.set_x_dot(
+          stateAndSensModel_->create_x_bar_vec(
+            x_bar_dot->getVectorBlock(0)->clone_v(), s_bar_dot ) );
+      }
+      stateStepper_->setInitialCondition(state_and_sens_ic);
+    }
+    else {
+      MEB::InArgs<Scalar> sens_ic = sensModel_->createInArgs();
+      sens_ic.setArgs(basePoint_no_x,true,true);
+      sens_ic.set_t(stepStatus.time);
+      sens_ic.set_x(s_bar);
+      if (sens_ic.supports(MEB::IN_ARG_x_dot))
+        sens_ic.set_x_dot(s_bar_dot);
+      sensStepper_->setInitialCondition(sens_ic);
+    }
+
+  }
+
+  if (useSimultaneousCorrector())
+    setupErrWtVecCalc();
+
+}
+
+
+template<class Scalar>
+const Array<int>&
+ForwardSensitivityStepper<Scalar>::getActiveParameters() const
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(sensModel_), std::logic_error,
+    "Error, one of the initialize functions must be called before\n"
+    "getActiveParameters()!"
+    );
+  return sensModel_->getActiveParameters();
+}
+
+
 // Overridden from Teuchos::ParameterListAcceptor
 
 
@@ -885,10 +1241,58 @@ void ForwardSensitivityStepper<Scalar>::setParameterList(
   )
 {
   TEUCHOS_TEST_FOR_EXCEPT(is_null(paramList));
-  paramList->validateParameters(*getValidParameters());
+  paramList->validateParametersAndSetDefaults(*getValidParameters());
   this->setMyParamList(paramList);
   forceUpToDateW_ = paramList->get(forceUpToDateW_name_,forceUpToDateW_default_);
+  sensitivityMethod_ = Teuchos::getIntegralValue<EForwardSensitivityMethod>(
+    *paramList, sensitivityMethod_name_);
+  sensitivityErrorControl_ = paramList->get(
+    sensitivityErrorControl_name_, sensitivityErrorControl_default_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    sensitivityErrorControl_ && !useSimultaneousCorrector(), std::logic_error,
+    "Error, \""<<sensitivityErrorControl_name_<<"\" = true requires \""
+    <<sensitivityMethod_name_<<"\" = \""
+    <<toString(FORWARD_SENSITIVITY_SIMULTANEOUS_CORRECTOR)<<"\"!  The"
+    " staggered corrector can not reject a sensitivity step because the"
+    " state step it follows can not be undone."
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    useSimultaneousCorrector() && nonnull(stateIntegrator_), std::logic_error,
+    "Error, the \""<<toString(sensitivityMethod_)<<"\" method can not be"
+    " used with decoupled steppers!"
+    );
+  sensitivitySolveBlockSize_ = paramList->get(
+    sensitivitySolveBlockSize_name_, sensitivitySolveBlockSize_default_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    sensitivitySolveBlockSize_ < 0, std::logic_error,
+    "Error, \""<<sensitivitySolveBlockSize_name_<<"\" = "
+    <<sensitivitySolveBlockSize_<<" can not be negative!"
+    );
+  numSensitivityThreads_ = paramList->get(
+    numSensitivityThreads_name_, numSensitivityThreads_default_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    numSensitivityThreads_ < 0, std::logic_error,
+    "Error, \""<<numSensitivityThreads_name_<<"\" = "
+    <<numSensitivityThreads_<<" can not be negative!"
+    );
+  directionalDerivatives_ = paramList->get(
+    directionalDerivatives_name_, directionalDerivatives_default_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    directionalDerivatives_ && useSimultaneousCorrector(), std::logic_error,
+    "Error, \""<<directionalDerivatives_name_<<"\" = true requires \""
+    <<sensitivityMethod_name_<<"\" = \""
+    <<toString(FORWARD_SENSITIVITY_STAGGERED_CORRECTOR)<<"\"!"
+    );
+  finiteDifferenceStep_ = paramList->get(
+    finiteDifferenceStep_name_, finiteDifferenceStep_default_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !(finiteDifferenceStep_ > 0.0), std::logic_error,
+    "Error, \""<<finiteDifferenceStep_name_<<"\" = "
+    <<finiteDifferenceStep_<<" must be positive!"
+    );
   Teuchos::readVerboseObjectSublist(&*paramList,this);
+  if (nonnull(stateStepper_))
+    setupSteppers();
 }
 
 
@@ -906,6 +1310,59 @@ ForwardSensitivityStepper<Scalar>::getValidParameters() const
       "you are willing to live with slightly less accurate sensitivities\n"
       "then set this to false."
       );
+    Teuchos::setStringToIntegralParameter<EForwardSensitivityMethod>(
+      sensitivityMethod_name_,
+      sensitivityMethod_default_,
+      "How the state and sensitivity equations are solved over a timestep.\n"
+      "\"Staggered Corrector\" solves the state step first and then the\n"
+      "sensitivities with a separate stepper using the state Jacobian.\n"
+      "\"Simultaneous Corrector\" solves the state and sensitivities as one\n"
+      "system with the state stepper, sharing one factorization of W.",
+      Teuchos::tuple<std::string>(
+        toString(FORWARD_SENSITIVITY_STAGGERED_CORRECTOR),
+        toString(FORWARD_SENSITIVITY_SIMULTANEOUS_CORRECTOR)
+        ),
+      Teuchos::tuple<EForwardSensitivityMethod>(
+        FORWARD_SENSITIVITY_STAGGERED_CORRECTOR,
+        FORWARD_SENSITIVITY_SIMULTANEOUS_CORRECTOR
+        ),
+      &*pl
+      );
+    pl->set( sensitivityErrorControl_name_, sensitivityErrorControl_default_,
+      "If set to true, then the sensitivities are included in the local\n"
+      "error test of the stepper, so that the timestep is also cut back\n"
+      "when the sensitivities are not accurate enough.  This requires\n"
+      "the \"Simultaneous Corrector\" method."
+      );
+    pl->set( sensitivitySolveBlockSize_name_, sensitivitySolveBlockSize_default_,
+      "The number of sensitivity columns passed to each linear solve with\n"
+      "the state Jacobian W.  The default of 0 solves for all np columns\n"
+      "together, which for a direct solver is one factorization of W and\n"
+      "one back-substitution with np right-hand sides, and for a block\n"
+      "Krylov solver (e.g. Belos with a matching \"Block Size\") is one\n"
+      "block solve.  A value of 1 solves column by column."
+      );
+    pl->set( numSensitivityThreads_name_, numSensitivityThreads_default_,
+      "Number of threads that compute the sensitivity columns of the\n"
+      "residual of an explicit state model with the \"Staggered Corrector\"\n"
+      "method.  Each thread computes a contiguous block of the np columns.\n"
+      "Zero uses one thread per hardware thread.  This is ignored unless\n"
+      "Rythmos was built with thread support."
+      );
+    pl->set( directionalDerivatives_name_, directionalDerivatives_default_,
+      "If set to true, then the sensitivity residual of an implicit state\n"
+      "model is computed from directional derivatives of the state residual\n"
+      "in the directions of the sensitivity columns, without forming\n"
+      "d(f)/d(x_dot) or d(f)/d(p).  The state model computes all of them in\n"
+      "one call if it implements DirectionalDerivativeModelEvaluatorBase,\n"
+      "otherwise they are approximated by one-sided finite differences.\n"
+      "This requires the \"Staggered Corrector\" method."
+      );
+    pl->set( finiteDifferenceStep_name_, finiteDifferenceStep_default_,
+      "The relative step of the finite differences used for\n"
+      "\"Directional Derivative Sensitivities\" when the state model does\n"
+      "not compute the directional derivatives itself."
+      );
     Teuchos::setupVerboseObjectSublist(&*pl);
     validPL = pl;
   }
@@ -996,6 +1453,23 @@ void ForwardSensitivityStepper<Scalar>::setInitialCondition(
     state_and_sens_ic_no_x.set_x_dot(Teuchos::null);
   }
 
+  // With the simultaneous corrector, the state stepper takes all of x_bar
+
+  if (useSimultaneousCorrector()) {
+    MEB::InArgs<Scalar> state_and_sens_ic_copy = stateAndSensModel_->createInArgs();
+    state_and_sens_ic_copy.setArgs(state_and_sens_ic_no_x,true,true);
+    state_and_sens_ic_copy.set_x(x_bar_init->clone_v());
+    if (state_and_sens_ic_copy.supports(MEB::IN_ARG_x_dot)) {
+      state_and_sens_ic_copy.set_x_dot(
+          !is_null(x_bar_dot_init)
+          ? x_bar_dot_init->clone_v()
+          : Teuchos::null
+          );
+    }
+    stateStepper_->setInitialCondition(state_and_sens_ic_copy);
+    return;
+  }
+
   // Set initial condition for the state
 
   MEB::InArgs<Scalar> state_ic = stateModel_->createInArgs();
@@ -1054,6 +1528,10 @@ ForwardSensitivityStepper<Scalar>::takeStep(
     return takeDecoupledStep(dt,stepType);
   }
 
+  if (useSimultaneousCorrector()) {
+    return takeSimultaneousStep(dt,stepType);
+  }
+
   return takeSyncedStep(dt,stepType);
 
 }
@@ -1064,6 +1542,10 @@ const StepStatus<Scalar>
 ForwardSensitivityStepper<Scalar>::getStepStatus() const
 {
 
+  if (useSimultaneousCorrector()) {
+    return stateStepper_->getStepStatus();
+  }
+
   const StepStatus<Scalar> sensStepStatus = sensStepper_->getStepStatus();
   StepStatus<Scalar> stepStatus;
 
@@ -1120,6 +1602,9 @@ template<class Scalar>
 TimeRange<Scalar>
 ForwardSensitivityStepper<Scalar>::getTimeRange() const
 {
+  if (useSimultaneousCorrector()) {
+    return stateStepper_->getTimeRange();
+  }
   return sensStepper_->getTimeRange();
 }
 
@@ -1147,6 +1632,11 @@ void ForwardSensitivityStepper<Scalar>::getPoints(
   if (x_bar_dot_vec)
     x_bar_dot_vec->clear();
 
+  if (useSimultaneousCorrector()) {
+    stateStepper_->getPoints(time_vec, x_bar_vec, x_bar_dot_vec, accuracy_vec);
+    return;
+  }
+
   Array<RCP<const Thyra::VectorBase<Scalar> > >
     x_vec, x_dot_vec;
 
@@ -1227,6 +1717,9 @@ void ForwardSensitivityStepper<Scalar>::removeNodes(
 template<class Scalar>
 int ForwardSensitivityStepper<Scalar>::getOrder() const
 {
+  if (useSimultaneousCorrector()) {
+    return stateStepper_->getOrder();
+  }
   return sensStepper_->getOrder();
   // Note: This assumes that stateStepper will have the same order!
 }
@@ -1339,16 +1832,7 @@ void ForwardSensitivityStepper<Scalar>::initializeCommon(
   isSingleResidualStepper_ = true; // ToDo: Add dynamic cast on
                                    // stateTimeStepSolver to check this!
 
-  setStepperModel(Teuchos::inOutArg(*stateStepper_),stateModel_);
-  if (stateStepper_->isImplicit()) {
-    rcp_dynamic_cast<SolverAcceptingStepperBase<Scalar> >(
-        stateStepper_,true)->setSolver(stateTimeStepSolver_);
-  }
-  sensStepper_->setModel(sensModel_);
-  if (sensStepper_->isImplicit()) {
-    rcp_dynamic_cast<SolverAcceptingStepperBase<Scalar> >(
-        sensStepper_,true)->setSolver(sensTimeStepSolver_);
-  }
+  setupSteppers();
 
   stateBasePoint_t_ = stateModel_->createInArgs();
 
@@ -1358,6 +1842,184 @@ void ForwardSensitivityStepper<Scalar>::initializeCommon(
 }
 
 
+template<class Scalar>
+void ForwardSensitivityStepper<Scalar>::setupSteppers()
+{
+
+  using Teuchos::rcp_dynamic_cast;
+
+  const RCP<ForwardSensitivityImplicitModelEvaluator<Scalar> >
+    implicitSensModel =
+    rcp_dynamic_cast<ForwardSensitivityImplicitModelEvaluator<Scalar> >(
+      sensModel_ );
+  if (nonnull(implicitSensModel)) {
+    implicitSensModel->setSolveBlockSize(sensitivitySolveBlockSize_);
+    implicitSensModel->setDirectionalDerivatives(directionalDerivatives_);
+    implicitSensModel->setFiniteDifferenceStep(finiteDifferenceStep_);
+  }
+  const RCP<ForwardSensitivityExplicitModelEvaluator<Scalar> >
+    explicitSensModel =
+    rcp_dynamic_cast<ForwardSensitivityExplicitModelEvaluator<Scalar> >(
+      sensModel_ );
+  if (nonnull(explicitSensModel)) {
+    explicitSensModel->setNumThreads(numSensitivityThreads_);
+    explicitSensModel->setThreadModels(sensitivityThreadModels_);
+  }
+  stateAndSensModel_->setSolveBlockSize(sensitivitySolveBlockSize_);
+
+  if (useSimultaneousCorrector()) {
+    stateStepper_->setModel(stateAndSensModel_);
+    if (stateStepper_->isImplicit()) {
+      rcp_dynamic_cast<SolverAcceptingStepperBase<Scalar> >(
+          stateStepper_,true)->setSolver(stateTimeStepSolver_);
+    }
+  }
+  else {
+    setStepperModel(Teuchos::inOutArg(*stateStepper_),stateModel_);
+    if (stateStepper_->isImplicit()) {
+      rcp_dynamic_cast<SolverAcceptingStepperBase<Scalar> >(
+          stateStepper_,true)->setSolver(stateTimeStepSolver_);
+    }
+    sensStepper_->setModel(sensModel_);
+    if (sensStepper_->isImplicit()) {
+      rcp_dynamic_cast<SolverAcceptingStepperBase<Scalar> >(
+          sensStepper_,true)->setSolver(sensTimeStepSolver_);
+    }
+  }
+
+  setupErrWtVecCalc();
+
+}
+
+
+template<class Scalar>
+void ForwardSensitivityStepper<Scalar>::setupErrWtVecCalc()
+{
+
+  using Teuchos::rcp_dynamic_cast;
+  typedef ErrWtVecCalcAcceptingStepControlStrategyBase<Scalar> EWVCASCSB;
+
+  const RCP<StepControlStrategyAcceptingStepperBase<Scalar> >
+    scaStateStepper =
+    rcp_dynamic_cast<StepControlStrategyAcceptingStepperBase<Scalar> >(
+      stateStepper_);
+  if (is_null(scaStateStepper))
+    return;
+
+  const bool excludeSens =
+    ( useSimultaneousCorrector() && !sensitivityErrorControl_ );
+
+  RCP<StepControlStrategyBase<Scalar> >
+    stepControl = scaStateStepper->getNonconstStepControlStrategy();
+
+  if (excludeSens && is_null(stepControl)) {
+    // ImplicitBDFStepper only creates its default step control when it takes
+    // its first step, which is too late to change the error weights, so
+    // create the same default step control here.
+    const RCP<ImplicitBDFStepper<Scalar> > bdfStateStepper =
+      rcp_dynamic_cast<ImplicitBDFStepper<Scalar> >(stateStepper_);
+    if (nonnull(bdfStateStepper)) {
+      const RCP<ImplicitBDFStepperStepControl<Scalar> >
+        bdfStepControl = Teuchos::rcp(new ImplicitBDFStepperStepControl<Scalar>());
+      const RCP<ParameterList>
+        stepperPL = bdfStateStepper->getNonconstParameterList();
+      bdfStepControl->setParameterList(
+        nonnull(stepperPL)
+        ? Teuchos::sublist(stepperPL, RythmosStepControlSettings_name)
+        : Teuchos::parameterList()
+        );
+      bdfStateStepper->setStepControlStrategy(bdfStepControl);
+      stepControl = bdfStepControl;
+    }
+  }
+
+  const RCP<EWVCASCSB>
+    ewvcStepControl = rcp_dynamic_cast<EWVCASCSB>(stepControl);
+  if (is_null(ewvcStepControl))
+    return;
+
+  const RCP<const ForwardSensitivityErrWtVecCalc<Scalar> >
+    fsErrWtVecCalc = rcp_dynamic_cast<const ForwardSensitivityErrWtVecCalc<Scalar> >(
+      ewvcStepControl->getErrWtVecCalc());
+
+  if (excludeSens && is_null(fsErrWtVecCalc)) {
+    ewvcStepControl->setErrWtVecCalc(
+      forwardSensitivityErrWtVecCalc<Scalar>(ewvcStepControl->getErrWtVecCalc()));
+  }
+  else if (!excludeSens && nonnull(fsErrWtVecCalc)) {
+    ewvcStepControl->setErrWtVecCalc(
+      Teuchos::rcp_const_cast<ErrWtVecCalcBase<Scalar> >(
+        fsErrWtVecCalc->getStateErrWtVecCalc()));
+  }
+
+}
+
+
+template<class Scalar>
+RCP<StepperBase<Scalar> >
+ForwardSensitivityStepper<Scalar>::cloneSubStepper(
+  const StepperBase<Scalar> &stepper,
+  const RCP<const Thyra::ModelEvaluator<Scalar> > &model,
+  const RCP<Thyra::NonlinearSolverBase<Scalar> > &solver
+  ) const
+{
+  const RCP<StepperBase<Scalar> > newStepper = stepper.cloneStepperAlgorithm();
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(newStepper), std::logic_error,
+    "Error, the stepper " << stepper.description() << " must support\n"
+    "cloning to change the active parameters!"
+    );
+  // Some steppers copy the model when they are cloned and do not allow it
+  // to be set again.  The model object is the same one, only its spaces
+  // have changed.
+  if (is_null(newStepper->getModel()))
+    newStepper->setModel(model);
+  if (newStepper->isImplicit()) {
+    Teuchos::rcp_dynamic_cast<SolverAcceptingStepperBase<Scalar> >(
+        newStepper,true)->setSolver(solver);
+  }
+  return newStepper;
+}
+
+
+template<class Scalar>
+RCP<Thyra::VectorBase<Scalar> >
+ForwardSensitivityStepper<Scalar>::remapSensColumns(
+  const Thyra::VectorBase<Scalar> &s_bar_old,
+  const ArrayView<const int> &oldActiveParams
+  ) const
+{
+
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  typedef Thyra::DefaultMultiVectorProductVector<Scalar> DMVPV;
+
+  const RCP<const Thyra::MultiVectorBase<Scalar> >
+    S_old = Teuchos::rcp_dynamic_cast<const DMVPV>(
+      Teuchos::rcpFromRef(s_bar_old),true)->getMultiVector();
+
+  const RCP<Thyra::VectorBase<Scalar> >
+    s_bar = createMember(sensModel_->get_x_space());
+  const RCP<Thyra::MultiVectorBase<Scalar> >
+    S = Teuchos::rcp_dynamic_cast<DMVPV>(s_bar,true)->getNonconstMultiVector();
+
+  // Both lists of parameters are sorted
+  const Array<int> &activeParams = sensModel_->getActiveParameters();
+  const int numOld = Teuchos::as<int>(oldActiveParams.size());
+  int j = 0;
+  for (int k = 0; k < Teuchos::as<int>(activeParams.size()); ++k) {
+    while (j < numOld && oldActiveParams[j] < activeParams[k])
+      ++j;
+    if (j < numOld && oldActiveParams[j] == activeParams[k])
+      V_V( S->col(k).ptr(), *S_old->col(j) );
+    else
+      V_S( S->col(k).ptr(), ST::zero() );
+  }
+
+  return s_bar;
+
+}
+
+
 template<class Scalar>
 Scalar ForwardSensitivityStepper<Scalar>::takeSyncedStep(
   Scalar dt, StepSizeType stepType
@@ -1468,6 +2130,64 @@ Scalar ForwardSensitivityStepper<Scalar>::takeSyncedStep(
 }
 
 
+template<class Scalar>
+Scalar ForwardSensitivityStepper<Scalar>::takeSimultaneousStep(
+  Scalar dt, StepSizeType stepType
+  )
+{
+
+  RYTHMOS_FUNC_TIME_MONITOR_DIFF("Rythmos:ForwardSensitivityStepper::takeStep: simultaneous",
+    TopLevel);
+
+  using Teuchos::as;
+  typedef Teuchos::VerboseObjectTempState<InterpolationBufferBase<Scalar> > VOTSIBB;
+
+  RCP<Teuchos::FancyOStream> out = this->getOStream();
+  Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+  const bool lowTrace =
+    ( !is_null(out) && as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW) );
+  const bool mediumTrace =
+    ( !is_null(out) && as<int>(verbLevel) >= as<int>(Teuchos::VERB_MEDIUM) );
+  Teuchos::OSTab tab(out);
+
+  if (lowTrace) {
+    *out
+      << "\nEntering " << TypeNameTraits<ForwardSensitivityStepper<Scalar> >::name()
+      << "::takeSimultaneousStep("<<dt<<","<<toString(stepType)<<") ...\n";
+  }
+
+  //
+  // Take the state and sensitivity timestep together
+  //
+
+  if (lowTrace) {
+    *out
+      << "\nTaking state and sensitivity step using stepper : "
+      << stateStepper_->description() << "\n";
+  }
+
+  Scalar state_and_sens_dt = -1.0;
+  {
+    VOTSIBB stateStepper_outputTempState(stateStepper_,out,verbLevel);
+    state_and_sens_dt = stateStepper_->takeStep(dt,stepType);
+  }
+
+  if (mediumTrace) {
+    const StepStatus<Scalar> stepStatus = stateStepper_->getStepStatus();
+    *out << "\nState and sensitivity step status:\n" << stepStatus;
+  }
+
+  if (lowTrace) {
+    *out
+      << "\nLeaving " << TypeNameTraits<ForwardSensitivityStepper<Scalar> >::name()
+      << "::takeSimultaneousStep("<<dt<<","<<toString(stepType)<<") ...\n";
+  }
+
+  return state_and_sens_dt;
+
+}
+
+
 template<class Scalar>
 Scalar ForwardSensitivityStepper<Scalar>::takeDecoupledStep(
   Scalar dt, StepSizeType stepType
@@ -0,0 +1,5 @@
+#include "Rythmos_IMEXRKStepper_decl.hpp"
+#ifndef HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
+#include "Rythmos_IMEXRKStepper_def.hpp"
+#endif
+
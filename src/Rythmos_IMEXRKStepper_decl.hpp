@@ -0,0 +1,351 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_IMEX_RK_STEPPER_DECL_H
+#define Rythmos_IMEX_RK_STEPPER_DECL_H
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_StepperBase.hpp"
+#include "Rythmos_SolverAcceptingStepperBase.hpp"
+#include "Rythmos_StepControlStrategyAcceptingStepperBase.hpp"
+#include "Rythmos_StepControlStrategyBase.hpp"
+#include "Rythmos_RKButcherTableauBase.hpp"
+#include "Rythmos_SingleResidualModelEvaluator.hpp"
+
+#include "Thyra_ModelEvaluator.hpp"
+#include "Thyra_NonlinearSolverBase.hpp"
+
+namespace Rythmos {
+
+
+/** \brief Implicit-explicit additive Runge-Kutta (IMEX-ARK) stepper.
+ *
+ * This stepper integrates split problems of the form
+ *
+ \verbatim
+
+   x_dot = f_E(x,t) + f_I(x,t)
+
+ \endverbatim
+ *
+ * where <tt>f_I</tt> is stiff and is treated with a diagonally implicit RK
+ * tableau and <tt>f_E</tt> is nonstiff and is treated with an explicit RK
+ * tableau that shares the same <tt>b</tt> and <tt>c</tt> vectors.  Each stage
+ * is
+ *
+ \verbatim
+
+   X_i = x_n + dt*sum_{j<i} ( AE(i,j)*KE_j + AI(i,j)*KI_j ) + dt*AI(i,i)*KI_i
+   KI_i = f_I(X_i,t_n+c_i*dt)
+   KE_i = f_E(X_i,t_n+c_i*dt)
+
+ \endverbatim
+ *
+ * and <tt>x_{n+1} = x_n + dt*sum_i b_i*(KE_i + KI_i)</tt>.
+ *
+ * The stiff part is the model passed through <tt>setModel()</tt>, which must
+ * be in the implicit form <tt>f(x_dot,x,t) = 0</tt> and is the only model for
+ * which a W matrix is ever formed.  The nonstiff part is given either as a
+ * second model in the explicit form through <tt>setExplicitModel()</tt>, or
+ * as a response function <tt>g(x,t)</tt> of the stiff model selected with the
+ * "Explicit Response Index" parameter.  If neither is given, the stepper
+ * reduces to the DIRK method of the implicit tableau.
+ *
+ * The tableau pair is selected with the "IMEX RK Method" parameter or set
+ * directly with <tt>setRKButcherTableaus()</tt>.  When both tableaus are
+ * embedded, the difference between the two solutions is passed to the step
+ * control strategy through <tt>setCorrection()</tt> so that variable step
+ * sizes can be selected with any <tt>StepControlStrategyBase</tt>.
+ */
+template<class Scalar>
+class IMEXRKStepper :
+  virtual public SolverAcceptingStepperBase<Scalar>,
+  virtual public StepControlStrategyAcceptingStepperBase<Scalar>
+{
+public:
+
+  /** \brief . */
+  typedef typename ScalarTraits<Scalar>::magnitudeType ScalarMag;
+
+  /** \name Constructors, intializers, Misc. */
+  //@{
+
+  /** \brief . */
+  IMEXRKStepper();
+
+  /** \brief Set the nonstiff part of the model.
+   *
+   * The model is evaluated in the explicit form <tt>x_dot = f_E(x,t)</tt>
+   * and must share the state space of the stiff model.
+   */
+  void setExplicitModel(
+    const RCP<const Thyra::ModelEvaluator<Scalar> >& explicitModel
+    );
+
+  /** \brief . */
+  RCP<const Thyra::ModelEvaluator<Scalar> > getExplicitModel() const;
+
+  /** \brief Set the explicit and implicit tableaus of the IMEX pair.
+   *
+   * The explicit tableau must be ERK, the implicit tableau must be DIRK, and
+   * both must have the same number of stages and the same <tt>c</tt> vector.
+   */
+  void setRKButcherTableaus(
+    const RCP<const RKButcherTableauBase<Scalar> > &explicitRKBT,
+    const RCP<const RKButcherTableauBase<Scalar> > &implicitRKBT
+    );
+
+  /** \brief . */
+  RCP<const RKButcherTableauBase<Scalar> > getExplicitRKButcherTableau() const;
+
+  /** \brief . */
+  RCP<const RKButcherTableauBase<Scalar> > getImplicitRKButcherTableau() const;
+
+  //@}
+
+  /** \name Overridden from SolverAcceptingStepperBase */
+  //@{
+
+  /** \brief . */
+  void setSolver(
+    const RCP<Thyra::NonlinearSolverBase<Scalar> > &solver
+    );
+
+  /** \brief . */
+  RCP<Thyra::NonlinearSolverBase<Scalar> >
+  getNonconstSolver();
+
+  /** \brief . */
+  RCP<const Thyra::NonlinearSolverBase<Scalar> >
+  getSolver() const;
+
+  //@}
+
+  /** \name Overridden from StepControlStrategyAcceptingStepperBase */
+  //@{
+
+  /** \brief . */
+  void setStepControlStrategy(
+      const RCP<StepControlStrategyBase<Scalar> >& stepControlStrategy
+      );
+
+  /** \brief . */
+  RCP<StepControlStrategyBase<Scalar> >
+    getNonconstStepControlStrategy();
+
+  /** \brief . */
+  RCP<const StepControlStrategyBase<Scalar> >
+    getStepControlStrategy() const;
+
+  //@}
+
+  /** \name Overridden from StepperBase */
+  //@{
+
+  /** \brief Returns true. */
+  bool isImplicit() const;
+
+  /** \brief Returns true. */
+  bool supportsCloning() const;
+
+  /** \brief . */
+  RCP<StepperBase<Scalar> > cloneStepperAlgorithm() const;
+
+  /** \brief Set the stiff part of the model. */
+  void setModel(const RCP<const Thyra::ModelEvaluator<Scalar> >& model);
+
+  /** \brief . */
+  void setNonconstModel(const RCP<Thyra::ModelEvaluator<Scalar> >& model);
+
+  /** \brief . */
+  RCP<const Thyra::ModelEvaluator<Scalar> > getModel() const;
+
+  /** \brief . */
+  RCP<Thyra::ModelEvaluator<Scalar> > getNonconstModel();
+
+  /** \brief . */
+  void setInitialCondition(
+    const Thyra::ModelEvaluatorBase::InArgs<Scalar> &initialCondition
+    );
+
+  /** \brief . */
+  Thyra::ModelEvaluatorBase::InArgs<Scalar> getInitialCondition() const;
+
+  /** \brief . */
+  Scalar takeStep(Scalar dt, StepSizeType flag);
+
+  /** \brief . */
+  const StepStatus<Scalar> getStepStatus() const;
+
+  //@}
+
+  /** \name Overridden from InterpolationBufferBase */
+  //@{
+
+  /** \brief . */
+  RCP<const Thyra::VectorSpaceBase<Scalar> >
+  get_x_space() const;
+
+  /** \brief . */
+  void addPoints(
+    const Array<Scalar>& time_vec,
+    const Array<RCP<const Thyra::VectorBase<Scalar> > >& x_vec,
+    const Array<RCP<const Thyra::VectorBase<Scalar> > >& xdot_vec
+    );
+
+  /** \brief . */
+  TimeRange<Scalar> getTimeRange() const;
+
+  /** \brief . */
+  void getPoints(
+    const Array<Scalar>& time_vec,
+    Array<RCP<const Thyra::VectorBase<Scalar> > >* x_vec,
+    Array<RCP<const Thyra::VectorBase<Scalar> > >* xdot_vec,
+    Array<ScalarMag>* accuracy_vec
+    ) const;
+
+  /** \brief . */
+  void getNodes(Array<Scalar>* time_vec) const;
+
+  /** \brief . */
+  void removeNodes(Array<Scalar>& time_vec);
+
+  /** \brief Returns the smaller of the two tableau orders. */
+  int getOrder() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::ParameterListAcceptor */
+  //@{
+
+  /** \brief . */
+  void setParameterList(RCP<ParameterList> const& paramList);
+
+  /** \brief . */
+  RCP<ParameterList> getNonconstParameterList();
+
+  /** \brief . */
+  RCP<ParameterList> unsetParameterList();
+
+  /** \brief . */
+  RCP<const ParameterList> getValidParameters() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::Describable */
+  //@{
+
+  /** \brief . */
+  void describe(
+    FancyOStream  &out,
+    const Teuchos::EVerbosityLevel verbLevel
+    ) const;
+
+  //@}
+
+private:
+
+  // ///////////////////////
+  // Private date members
+
+  bool isInitialized_;
+  bool haveInitialCondition_;
+  RCP<const Thyra::ModelEvaluator<Scalar> > model_;
+  RCP<const Thyra::ModelEvaluator<Scalar> > explicitModel_;
+  RCP<Thyra::NonlinearSolverBase<Scalar> > solver_;
+  RCP<const RKButcherTableauBase<Scalar> > erkButcherTableau_;
+  RCP<const RKButcherTableauBase<Scalar> > irkButcherTableau_;
+  RCP<StepControlStrategyBase<Scalar> > stepControl_;
+  RCP<ParameterList> paramList_;
+
+  Thyra::ModelEvaluatorBase::InArgs<Scalar> basePoint_;
+  Thyra::ModelEvaluatorBase::InArgs<Scalar> explicitBasePoint_;
+  RCP<Thyra::VectorBase<Scalar> > x_;
+  RCP<Thyra::VectorBase<Scalar> > x_old_;
+  RCP<Thyra::VectorBase<Scalar> > xhat_;
+  RCP<Thyra::VectorBase<Scalar> > ee_;
+  RCP<Thyra::VectorBase<Scalar> > x_stage_;
+  Array<RCP<Thyra::VectorBase<Scalar> > > kE_;
+  Array<RCP<Thyra::VectorBase<Scalar> > > kI_;
+  RCP<SingleResidualModelEvaluator<Scalar> > neModel_;
+  TimeRange<Scalar> timeRange_;
+  Scalar dt_;
+  int numSteps_;
+  int explicitResponseIndex_;
+  int newtonConvergenceStatus_;
+
+  static const std::string imexMethod_name_;
+  static const std::string imexMethod_default_;
+  static const std::string explicitResponseIndex_name_;
+  static const int explicitResponseIndex_default_;
+
+  // ///////////////////////
+  // Private member functions
+
+  void defaultInitializeAll_();
+  void initialize_();
+  void setTableausFromParameterList_();
+
+  // Compute all stages and the new solution over [t,t+dt].  Returns false if
+  // any of the stage solves failed.
+  bool computeStages_(Scalar t, Scalar dt);
+
+  // kE = f_E(x,t) from either the explicit model or the split response.
+  void evalExplicitPart_(
+    const Thyra::VectorBase<Scalar>& x, Scalar t,
+    const Ptr<Thyra::VectorBase<Scalar> >& kE
+    );
+
+};
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates IMEXRKStepper
+ */
+template<class Scalar>
+RCP<IMEXRKStepper<Scalar> >
+imexRKStepper();
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates IMEXRKStepper
+ */
+template<class Scalar>
+RCP<IMEXRKStepper<Scalar> >
+imexRKStepper(
+  const RCP<const Thyra::ModelEvaluator<Scalar> >& implicitModel,
+  const RCP<const Thyra::ModelEvaluator<Scalar> >& explicitModel,
+  const RCP<Thyra::NonlinearSolverBase<Scalar> >& solver
+  );
+
+
+} // namespace Rythmos
+
+#endif // Rythmos_IMEX_RK_STEPPER_DECL_H
@@ -0,0 +1,1017 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_IMEX_RK_STEPPER_DEF_H
+#define Rythmos_IMEX_RK_STEPPER_DEF_H
+
+#include "Rythmos_IMEXRKStepper_decl.hpp"
+
+#include "Rythmos_StepperHelpers.hpp"
+#include "Rythmos_RKButcherTableau.hpp"
+#include "Rythmos_RKButcherTableauHelpers.hpp"
+#include "Rythmos_FixedStepControlStrategy.hpp"
+
+#include "Thyra_ModelEvaluatorHelpers.hpp"
+#include "Thyra_AssertOp.hpp"
+#include "Thyra_VectorStdOps.hpp"
+#include "Teuchos_StandardParameterEntryValidators.hpp"
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+#include "Teuchos_as.hpp"
+
+namespace Rythmos {
+
+
+template<class Scalar>
+RCP<IMEXRKStepper<Scalar> >
+imexRKStepper()
+{
+  RCP<IMEXRKStepper<Scalar> > stepper(new IMEXRKStepper<Scalar>());
+  return stepper;
+}
+
+template<class Scalar>
+RCP<IMEXRKStepper<Scalar> >
+imexRKStepper(
+  const RCP<const Thyra::ModelEvaluator<Scalar> >& implicitModel,
+  const RCP<const Thyra::ModelEvaluator<Scalar> >& explicitModel,
+  const RCP<Thyra::NonlinearSolverBase<Scalar> >& solver
+  )
+{
+  RCP<IMEXRKStepper<Scalar> > stepper(new IMEXRKStepper<Scalar>());
+  stepper->setModel(implicitModel);
+  if (!is_null(explicitModel)) {
+    stepper->setExplicitModel(explicitModel);
+  }
+  stepper->setSolver(solver);
+  return stepper;
+}
+
+
+// Static members
+
+
+template<class Scalar>
+const std::string
+IMEXRKStepper<Scalar>::imexMethod_name_
+= "IMEX RK Method";
+
+template<class Scalar>
+const std::string
+IMEXRKStepper<Scalar>::imexMethod_default_
+= "ARK3(2)4L[2]SA";
+
+template<class Scalar>
+const std::string
+IMEXRKStepper<Scalar>::explicitResponseIndex_name_
+= "Explicit Response Index";
+
+template<class Scalar>
+const int
+IMEXRKStepper<Scalar>::explicitResponseIndex_default_
+= -1;
+
+
+// ////////////////////////////
+// Defintions
+
+
+// Constructors, intializers, Misc.
+
+
+template<class Scalar>
+IMEXRKStepper<Scalar>::IMEXRKStepper()
+{
+  this->defaultInitializeAll_();
+  numSteps_ = 0;
+}
+
+template<class Scalar>
+void IMEXRKStepper<Scalar>::defaultInitializeAll_()
+{
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  isInitialized_ = false;
+  haveInitialCondition_ = false;
+  model_ = Teuchos::null;
+  explicitModel_ = Teuchos::null;
+  solver_ = Teuchos::null;
+  erkButcherTableau_ = Teuchos::null;
+  irkButcherTableau_ = Teuchos::null;
+  stepControl_ = Teuchos::null;
+  paramList_ = Teuchos::null;
+  //basePoint_;
+  //explicitBasePoint_;
+  x_ = Teuchos::null;
+  x_old_ = Teuchos::null;
+  xhat_ = Teuchos::null;
+  ee_ = Teuchos::null;
+  x_stage_ = Teuchos::null;
+  kE_.clear();
+  kI_.clear();
+  neModel_ = Teuchos::null;
+  //timeRange_;
+  dt_ = ST::nan();
+  numSteps_ = -1;
+  explicitResponseIndex_ = explicitResponseIndex_default_;
+  newtonConvergenceStatus_ = -1;
+}
+
+
+template<class Scalar>
+void IMEXRKStepper<Scalar>::setExplicitModel(
+  const RCP<const Thyra::ModelEvaluator<Scalar> >& explicitModel
+  )
+{
+  typedef Thyra::ModelEvaluatorBase MEB;
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(explicitModel));
+  const MEB::InArgs<Scalar> inArgs = explicitModel->createInArgs();
+  const MEB::OutArgs<Scalar> outArgs = explicitModel->createOutArgs();
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !inArgs.supports(MEB::IN_ARG_x) || !outArgs.supports(MEB::OUT_ARG_f),
+    std::logic_error,
+    "Error!  The explicit model passed to IMEXRKStepper::setExplicitModel "
+    "must support x and f!"
+    );
+  explicitModel_ = explicitModel;
+  isInitialized_ = false;
+}
+
+
+template<class Scalar>
+RCP<const Thyra::ModelEvaluator<Scalar> >
+IMEXRKStepper<Scalar>::getExplicitModel() const
+{
+  return explicitModel_;
+}
+
+
+template<class Scalar>
+void IMEXRKStepper<Scalar>::setRKButcherTableaus(
+  const RCP<const RKButcherTableauBase<Scalar> > &explicitRKBT,
+  const RCP<const RKButcherTableauBase<Scalar> > &implicitRKBT
+  )
+{
+  typedef ScalarTraits<Scalar> ST;
+  TEUCHOS_ASSERT( !is_null(explicitRKBT) );
+  TEUCHOS_ASSERT( !is_null(implicitRKBT) );
+  TEUCHOS_TEST_FOR_EXCEPTION( isInitialized_, std::logic_error,
+      "Error!  The RK Butcher Tableaus cannot be changed after internal "
+      "initialization!"
+      );
+  validateERKButcherTableau(*explicitRKBT);
+  validateDIRKButcherTableau(*implicitRKBT);
+  const int numStages = explicitRKBT->numStages();
+  TEUCHOS_TEST_FOR_EXCEPTION( implicitRKBT->numStages() != numStages,
+      std::logic_error,
+      "Error!  The explicit RK Butcher Tableau has " << numStages
+      << " stages but the implicit RK Butcher Tableau has "
+      << implicitRKBT->numStages() << " stages!"
+      );
+  const Teuchos::SerialDenseVector<int,Scalar> cE = explicitRKBT->c();
+  const Teuchos::SerialDenseVector<int,Scalar> cI = implicitRKBT->c();
+  for (int i=0 ; i<numStages ; ++i) {
+    const ScalarMag tol =
+      ScalarMag(100.0*ST::eps())*std::max(ST::magnitude(cI(i)), ScalarMag(1.0));
+    TEUCHOS_TEST_FOR_EXCEPTION( ST::magnitude(cE(i)-cI(i)) > tol,
+        std::logic_error,
+        "Error!  The explicit and implicit RK Butcher Tableaus have different "
+        "stage times, c_E(" << i << ") = " << cE(i) << " and c_I(" << i
+        << ") = " << cI(i) << "!"
+        );
+  }
+  TEUCHOS_TEST_FOR_EXCEPTION(
+      explicitRKBT->isEmbeddedMethod() != implicitRKBT->isEmbeddedMethod(),
+      std::logic_error,
+      "Error!  Either both or neither of the IMEX RK Butcher Tableaus must "
+      "be embedded methods!"
+      );
+  erkButcherTableau_ = explicitRKBT;
+  irkButcherTableau_ = implicitRKBT;
+}
+
+
+template<class Scalar>
+RCP<const RKButcherTableauBase<Scalar> >
+IMEXRKStepper<Scalar>::getExplicitRKButcherTableau() const
+{
+  return erkButcherTableau_;
+}
+
+
+template<class Scalar>
+RCP<const RKButcherTableauBase<Scalar> >
+IMEXRKStepper<Scalar>::getImplicitRKButcherTableau() const
+{
+  return irkButcherTableau_;
+}
+
+
+// Overridden from SolverAcceptingStepperBase
+
+
+template<class Scalar>
+void IMEXRKStepper<Scalar>::setSolver(
+  const RCP<Thyra::NonlinearSolverBase<Scalar> > &solver
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(solver == Teuchos::null, std::logic_error,
+      "Error!  Thyra::NonlinearSolverBase RCP passed in through "
+      "IMEXRKStepper::setSolver is null!");
+  solver_ = solver;
+  isInitialized_ = false;
+}
+
+
+template<class Scalar>
+RCP<Thyra::NonlinearSolverBase<Scalar> >
+IMEXRKStepper<Scalar>::getNonconstSolver()
+{
+  return solver_;
+}
+
+
+template<class Scalar>
+RCP<const Thyra::NonlinearSolverBase<Scalar> >
+IMEXRKStepper<Scalar>::getSolver() const
+{
+  return solver_;
+}
+
+
+// Overridden from StepControlStrategyAcceptingStepperBase
+
+
+template<class Scalar>
+void IMEXRKStepper<Scalar>::setStepControlStrategy(
+  const RCP<StepControlStrategyBase<Scalar> >& stepControl
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(stepControl == Teuchos::null,std::logic_error,
+    "Error, stepControl == Teuchos::null!\n");
+  stepControl_ = stepControl;
+}
+
+
+template<class Scalar>
+RCP<StepControlStrategyBase<Scalar> >
+IMEXRKStepper<Scalar>::getNonconstStepControlStrategy()
+{
+  return(stepControl_);
+}
+
+
+template<class Scalar>
+RCP<const StepControlStrategyBase<Scalar> >
+IMEXRKStepper<Scalar>::getStepControlStrategy() const
+{
+  return(stepControl_);
+}
+
+
+// Overridden from StepperBase
+
+
+template<class Scalar>
+bool IMEXRKStepper<Scalar>::isImplicit() const
+{
+  return true;
+}
+
+
+template<class Scalar>
+bool IMEXRKStepper<Scalar>::supportsCloning() const
+{
+  return true;
+}
+
+
+template<class Scalar>
+RCP<StepperBase<Scalar> >
+IMEXRKStepper<Scalar>::cloneStepperAlgorithm() const
+{
+  // Just use the interface to clone the algorithm in a basically
+  // uninitialized state
+  RCP<IMEXRKStepper<Scalar> >
+    stepper = Teuchos::rcp(new IMEXRKStepper<Scalar>());
+
+  if (!is_null(model_)) {
+    stepper->setModel(model_); // Shallow copy is okay!
+  }
+
+  if (!is_null(explicitModel_)) {
+    stepper->setExplicitModel(explicitModel_); // Shallow copy is okay!
+  }
+
+  if (!is_null(paramList_)) {
+    stepper->setParameterList(Teuchos::parameterList(*paramList_));
+  }
+
+  if (!is_null(erkButcherTableau_)) {
+    stepper->setRKButcherTableaus(erkButcherTableau_,irkButcherTableau_);
+  }
+
+  if (!is_null(solver_)) {
+    stepper->setSolver(solver_->cloneNonlinearSolver().assert_not_null());
+  }
+
+  if (!is_null(stepControl_)) {
+    if (stepControl_->supportsCloning())
+      stepper->setStepControlStrategy(
+        stepControl_->cloneStepControlStrategyAlgorithm().assert_not_null());
+  }
+
+  return stepper;
+}
+
+
+template<class Scalar>
+void IMEXRKStepper<Scalar>::setModel(
+  const RCP<const Thyra::ModelEvaluator<Scalar> >& model
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(model));
+  assertValidModel( *this, *model );
+  model_ = model;
+  isInitialized_ = false;
+}
+
+
+template<class Scalar>
+void IMEXRKStepper<Scalar>::setNonconstModel(
+  const RCP<Thyra::ModelEvaluator<Scalar> >& model
+  )
+{
+  this->setModel(model);
+}
+
+
+template<class Scalar>
+RCP<const Thyra::ModelEvaluator<Scalar> >
+IMEXRKStepper<Scalar>::getModel() const
+{
+  return model_;
+}
+
+
+template<class Scalar>
+RCP<Thyra::ModelEvaluator<Scalar> >
+IMEXRKStepper<Scalar>::getNonconstModel()
+{
+  return Teuchos::null;
+}
+
+
+template<class Scalar>
+void IMEXRKStepper<Scalar>::setInitialCondition(
+  const Thyra::ModelEvaluatorBase::InArgs<Scalar> &initialCondition
+  )
+{
+  typedef ScalarTraits<Scalar> ST;
+  typedef Thyra::ModelEvaluatorBase MEB;
+
+  basePoint_ = initialCondition;
+
+  // x
+
+  RCP<const Thyra::VectorBase<Scalar> >
+    x_init = initialCondition.get_x();
+
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(x_init), std::logic_error,
+    "Error, if the client passes in an intial condition to "
+    "setInitialCondition(...), then x can not be null!" );
+
+  x_ = x_init->clone_v();
+  x_old_ = x_->clone_v();
+
+  // t
+
+  const Scalar t =
+    (
+      initialCondition.supports(MEB::IN_ARG_t)
+      ? initialCondition.get_t()
+      : ST::zero()
+      );
+
+  timeRange_ = timeRange(t,t);
+  numSteps_ = 0;
+
+  haveInitialCondition_ = true;
+  isInitialized_ = false;
+}
+
+
+template<class Scalar>
+Thyra::ModelEvaluatorBase::InArgs<Scalar>
+IMEXRKStepper<Scalar>::getInitialCondition() const
+{
+  return basePoint_;
+}
+
+
+template<class Scalar>
+Scalar IMEXRKStepper<Scalar>::takeStep(Scalar dt, StepSizeType stepSizeType)
+{
+  using Teuchos::as;
+  using Teuchos::incrVerbLevel;
+  typedef ScalarTraits<Scalar> ST;
+  typedef Thyra::NonlinearSolverBase<Scalar> NSB;
+  typedef Teuchos::VerboseObjectTempState<NSB> VOTSNSB;
+
+  RCP<FancyOStream> out = this->getOStream();
+  Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+  Teuchos::OSTab ostab(out,1,"IMEXRK::takeStep");
+  VOTSNSB solver_outputTempState(solver_,out,incrVerbLevel(verbLevel,-1));
+
+  if ( !is_null(out) && as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW) ) {
+    *out
+      << "\nEntering "
+      << Teuchos::TypeNameTraits<IMEXRKStepper<Scalar> >::name()
+      << "::takeStep("<<dt<<","<<toString(stepSizeType)<<") ...\n";
+  }
+
+  initialize_();
+
+  if (dt <= ST::zero()) {
+    if ( as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW) )
+      *out << "\nThe arguments to takeStep are not valid for "
+           << "IMEXRKStepper at this time.\n"
+           << "  dt = " << dt << "\n"
+           << "IMEXRKStepper requires positive dt.\n" << std::endl;
+    return(Scalar(-ST::one()));
+  }
+
+  const Scalar t = timeRange_.upper();
+  V_V( x_old_.ptr(), *x_ );
+  dt_ = dt;
+
+  stepControl_->setRequestedStepSize(*this,dt_,stepSizeType);
+  AttemptedStepStatusFlag status;
+  bool stepPass = false;
+  while (1) {
+
+    stepControl_->nextStepSize(*this,&dt_,&stepSizeType,NULL);
+    if ( as<int>(verbLevel) >= as<int>(Teuchos::VERB_HIGH) ) {
+      *out << "\nrequested dt = " << dt
+           << "\ncurrent dt   = " << dt_ << "\n";
+    }
+
+    newtonConvergenceStatus_ = ( computeStages_(t,dt_) ? 0 : -1 );
+
+    // The embedded error estimate is only meaningful if all of the stage
+    // solves converged.
+    RCP<Thyra::VectorBase<Scalar> > ee = Teuchos::null;
+    if ( (newtonConvergenceStatus_ == 0)
+         && irkButcherTableau_->isEmbeddedMethod() ) {
+      Thyra::V_VmV(ee_.ptr(), *x_, *xhat_);
+      ee = ee_;
+    }
+
+    stepControl_->setCorrection(*this,x_,ee,newtonConvergenceStatus_);
+
+    stepPass = stepControl_->acceptStep(*this,NULL);
+
+    if (!stepPass) { // stepPass = false
+      V_V( x_.ptr(), *x_old_ );
+      status = stepControl_->rejectStep(*this);
+
+      if (status != PREDICT_AGAIN)
+        break;
+    } else { // stepPass = true
+      break;
+    }
+  }
+
+  // Update the step
+
+  if (stepPass) {
+    timeRange_ = timeRange(t,t+dt_);
+    numSteps_++;
+    stepControl_->completeStep(*this);
+  } else {
+    // Complete failure.  Return to Integrator with bad step size.
+    dt_ = Scalar(-ST::one());
+  }
+
+  if ( !is_null(out) && as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW) ) {
+    *out
+      << "\nLeaving "
+      << Teuchos::TypeNameTraits<IMEXRKStepper<Scalar> >::name()
+      << "::takeStep("<<dt_<<","<<toString(stepSizeType)<<") ...\n";
+  }
+
+  return(dt_);
+}
+
+
+template<class Scalar>
+const StepStatus<Scalar> IMEXRKStepper<Scalar>::getStepStatus() const
+{
+  StepStatus<Scalar> stepStatus;
+
+  if (!isInitialized_) {
+    stepStatus.stepStatus = STEP_STATUS_UNINITIALIZED;
+    stepStatus.message = "This stepper is uninitialized.";
+  }
+  else if (numSteps_ > 0) {
+    stepStatus.stepStatus = STEP_STATUS_CONVERGED;
+  }
+  else {
+    stepStatus.stepStatus = STEP_STATUS_UNKNOWN;
+  }
+  stepStatus.stepSize = timeRange_.length();
+  stepStatus.order = ( is_null(irkButcherTableau_) ? 0 : this->getOrder() );
+  stepStatus.time = timeRange_.upper();
+  if(Teuchos::nonnull(x_))
+    stepStatus.solution = x_;
+  else
+    stepStatus.solution = Teuchos::null;
+  stepStatus.solutionDot = Teuchos::null;
+  return(stepStatus);
+}
+
+
+// Overridden from InterpolationBufferBase
+
+
+template<class Scalar>
+RCP<const Thyra::VectorSpaceBase<Scalar> >
+IMEXRKStepper<Scalar>::get_x_space() const
+{
+  return ( !is_null(model_) ? model_->get_x_space() : Teuchos::null );
+}
+
+
+template<class Scalar>
+void IMEXRKStepper<Scalar>::addPoints(
+    const Array<Scalar>& /* time_vec */
+    ,const Array<RCP<const Thyra::VectorBase<Scalar> > >& /* x_vec */
+    ,const Array<RCP<const Thyra::VectorBase<Scalar> > >& /* xdot_vec */
+    )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(true);
+}
+
+
+template<class Scalar>
+TimeRange<Scalar> IMEXRKStepper<Scalar>::getTimeRange() const
+{
+  if (!haveInitialCondition_)
+    return invalidTimeRange<Scalar>();
+  return timeRange_;
+}
+
+
+template<class Scalar>
+void IMEXRKStepper<Scalar>::getPoints(
+  const Array<Scalar>& time_vec
+  ,Array<RCP<const Thyra::VectorBase<Scalar> > >* x_vec
+  ,Array<RCP<const Thyra::VectorBase<Scalar> > >* xdot_vec
+  ,Array<ScalarMag>* accuracy_vec) const
+{
+  using Teuchos::constOptInArg;
+  using Teuchos::null;
+  TEUCHOS_ASSERT(haveInitialCondition_);
+  defaultGetPoints<Scalar>(
+    timeRange_.lower(), constOptInArg(*x_old_),
+    Ptr<const VectorBase<Scalar> >(null),
+    timeRange_.upper(), constOptInArg(*x_),
+    Ptr<const VectorBase<Scalar> >(null),
+    time_vec,
+    ptr(x_vec), ptr(xdot_vec), ptr(accuracy_vec),
+    Ptr<InterpolatorBase<Scalar> >(null)
+    );
+}
+
+
+template<class Scalar>
+void IMEXRKStepper<Scalar>::getNodes(Array<Scalar>* time_vec) const
+{
+  TEUCHOS_ASSERT( time_vec != NULL );
+  time_vec->clear();
+  if (!haveInitialCondition_) {
+    return;
+  }
+  time_vec->push_back(timeRange_.lower());
+  if (numSteps_ > 0) {
+    time_vec->push_back(timeRange_.upper());
+  }
+}
+
+
+template<class Scalar>
+void IMEXRKStepper<Scalar>::removeNodes(Array<Scalar>& /* time_vec */)
+{
+  TEUCHOS_TEST_FOR_EXCEPT(true);
+}
+
+
+template<class Scalar>
+int IMEXRKStepper<Scalar>::getOrder() const
+{
+  TEUCHOS_ASSERT( !is_null(erkButcherTableau_) );
+  return std::min(erkButcherTableau_->order(), irkButcherTableau_->order());
+}
+
+
+// Overridden from Teuchos::ParameterListAcceptor
+
+
+template <class Scalar>
+void IMEXRKStepper<Scalar>::setParameterList(
+  RCP<ParameterList> const& paramList
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(paramList));
+  // Only replace tableaus set through setRKButcherTableaus() if the client
+  // asked for a method by name.
+  const bool methodGiven = paramList->isParameter(imexMethod_name_);
+  paramList->validateParametersAndSetDefaults(*this->getValidParameters());
+  paramList_ = paramList;
+  Teuchos::readVerboseObjectSublist(&*paramList_,this);
+  explicitResponseIndex_ =
+    paramList_->get<int>(explicitResponseIndex_name_);
+  isInitialized_ = false;
+  if (methodGiven || is_null(erkButcherTableau_)) {
+    setTableausFromParameterList_();
+  }
+}
+
+
+template <class Scalar>
+RCP<ParameterList>
+IMEXRKStepper<Scalar>::getNonconstParameterList()
+{
+  return(paramList_);
+}
+
+
+template <class Scalar>
+RCP<ParameterList>
+IMEXRKStepper<Scalar>::unsetParameterList()
+{
+  RCP<ParameterList>
+    temp_param_list = paramList_;
+  paramList_ = Teuchos::null;
+  return(temp_param_list);
+}
+
+
+template<class Scalar>
+RCP<const ParameterList>
+IMEXRKStepper<Scalar>::getValidParameters() const
+{
+  static RCP<const ParameterList> validPL;
+  if (is_null(validPL)) {
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    Teuchos::setStringToIntegralParameter<int>(
+      imexMethod_name_,
+      imexMethod_default_,
+      "Additive Runge-Kutta IMEX method.  ARK2 is the method of Giraldo, "
+      "Kelly and Constantinescu; ARK3(2)4L[2]SA and ARK4(3)6L[2]SA are the "
+      "methods of Kennedy and Carpenter.  All carry an embedded error "
+      "estimate.",
+      Teuchos::tuple<std::string>(
+        "ARK2",
+        "ARK3(2)4L[2]SA",
+        "ARK4(3)6L[2]SA"),
+      Teuchos::tuple<int>(2,3,4),
+      pl.get());
+    pl->set<int>(explicitResponseIndex_name_, explicitResponseIndex_default_,
+      "If no explicit model is set, the index of the response function "
+      "g_j(x,t) of the implicit model that gives the nonstiff part f_E(x,t) "
+      "of the right hand side.  A negative value means there is no nonstiff "
+      "part.");
+    pl->sublist(RythmosStepControlSettings_name);
+    Teuchos::setupVerboseObjectSublist(&*pl);
+    validPL = pl;
+  }
+  return validPL;
+}
+
+
+// Overridden from Teuchos::Describable
+
+
+template<class Scalar>
+void IMEXRKStepper<Scalar>::describe(
+  FancyOStream &out,
+  const Teuchos::EVerbosityLevel verbLevel
+  ) const
+{
+  using std::endl;
+  using Teuchos::as;
+  if (!isInitialized_) {
+    out << this->description() << " : This stepper is not initialized yet"
+        << std::endl;
+    return;
+  }
+  if (
+    as<int>(verbLevel) == as<int>(Teuchos::VERB_DEFAULT)
+    ||
+    as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW)
+    )
+  {
+    out << this->description() << ":" << endl;
+    Teuchos::OSTab tab(out);
+    out << "implicit model = " << Teuchos::describe(*model_,verbLevel);
+    if (!is_null(explicitModel_)) {
+      out << "explicit model = "
+          << Teuchos::describe(*explicitModel_,verbLevel);
+    }
+    else {
+      out << "explicit response index = " << explicitResponseIndex_ << endl;
+    }
+    out << "solver = " << Teuchos::describe(*solver_,verbLevel);
+    out << "explicit RKBT = "
+        << Teuchos::describe(*erkButcherTableau_,verbLevel);
+    out << "implicit RKBT = "
+        << Teuchos::describe(*irkButcherTableau_,verbLevel);
+  }
+}
+
+
+// private
+
+
+template <class Scalar>
+void IMEXRKStepper<Scalar>::initialize_()
+{
+  typedef ScalarTraits<Scalar> ST;
+  typedef Thyra::ModelEvaluatorBase MEB;
+
+  if (isInitialized_) return;
+
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(model_));
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(solver_));
+  TEUCHOS_TEST_FOR_EXCEPT(!haveInitialCondition_);
+
+  // Initialize Parameter List if none provided.
+  if (paramList_ == Teuchos::null) {
+    RCP<Teuchos::ParameterList> emptyParameterList =
+      Teuchos::rcp(new Teuchos::ParameterList);
+    this->setParameterList(emptyParameterList);
+  }
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(erkButcherTableau_));
+
+  if (is_null(explicitModel_) && explicitResponseIndex_ >= 0) {
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      explicitResponseIndex_ >= model_->Ng(), std::logic_error,
+      "Error!  \"" << explicitResponseIndex_name_ << "\" = "
+      << explicitResponseIndex_ << " but the implicit model only has "
+      << model_->Ng() << " response functions!"
+      );
+    THYRA_ASSERT_VEC_SPACES(
+      "Rythmos::IMEXRKStepper::initialize_(...)",
+      *model_->get_g_space(explicitResponseIndex_), *model_->get_x_space() );
+  }
+  if (!is_null(explicitModel_)) {
+    THYRA_ASSERT_VEC_SPACES(
+      "Rythmos::IMEXRKStepper::initialize_(...)",
+      *explicitModel_->get_x_space(), *model_->get_x_space() );
+    explicitBasePoint_ = explicitModel_->getNominalValues();
+    const MEB::InArgs<Scalar> explicitInArgs = explicitModel_->createInArgs();
+    if (explicitInArgs.supports(MEB::IN_ARG_p)) {
+      // Pass the parameter values of the initial condition on to the
+      // explicit model where the spaces agree.
+      const int Np = std::min(explicitInArgs.Np(), basePoint_.Np());
+      for (int l=0 ; l<Np ; ++l) {
+        if (!is_null(basePoint_.get_p(l)))
+          explicitBasePoint_.set_p(l,basePoint_.get_p(l));
+      }
+    }
+  }
+
+#ifdef HAVE_RYTHMOS_DEBUG
+  THYRA_ASSERT_VEC_SPACES(
+    "Rythmos::IMEXRKStepper::initialize_(...)",
+    *x_->space(), *model_->get_x_space() );
+#endif // HAVE_RYTHMOS_DEBUG
+
+  // Initialize StepControl
+  if (stepControl_ == Teuchos::null) {
+    RCP<StepControlStrategyBase<Scalar> > stepControlStrategy =
+      Teuchos::rcp(new FixedStepControlStrategy<Scalar>());
+    RCP<Teuchos::ParameterList> stepControlPL =
+      Teuchos::sublist(paramList_, RythmosStepControlSettings_name);
+    stepControlStrategy->setParameterList(stepControlPL);
+    this->setStepControlStrategy(stepControlStrategy);
+  }
+  stepControl_->initialize(*this);
+  stepControl_->setOStream(this->getOStream());
+  stepControl_->setVerbLevel(this->getVerbLevel());
+
+  // Set up the stage storage ...
+  const int numStages = irkButcherTableau_->numStages();
+  RCP<const Thyra::VectorSpaceBase<Scalar> > x_space = model_->get_x_space();
+  kE_.clear();
+  kI_.clear();
+  for (int i=0 ; i<numStages ; ++i) {
+    kE_.push_back(createMember(x_space));
+    kI_.push_back(createMember(x_space));
+    V_S(kI_[i].ptr(),ST::zero());
+  }
+  x_stage_ = createMember(x_space);
+  xhat_ = createMember(x_space);
+  ee_ = createMember(x_space);
+
+  if (is_null(neModel_)) {
+    neModel_ = Teuchos::rcp(new SingleResidualModelEvaluator<Scalar>());
+  }
+
+  isInitialized_ = true;
+}
+
+
+template <class Scalar>
+void IMEXRKStepper<Scalar>::setTableausFromParameterList_()
+{
+  const int method =
+    Teuchos::getIntegralValue<int>(*paramList_,imexMethod_name_);
+  RCP<const RKButcherTableauBase<Scalar> > erkbt, irkbt;
+  if (method == 2) {
+    erkbt = Teuchos::rcp(new Explicit3Stage2ndOrderARK_RKBT<Scalar>());
+    irkbt = Teuchos::rcp(new DIRK3Stage2ndOrderARK_RKBT<Scalar>());
+  }
+  else if (method == 3) {
+    erkbt = Teuchos::rcp(new Explicit4Stage3rdOrderARK_RKBT<Scalar>());
+    irkbt = Teuchos::rcp(new DIRK4Stage3rdOrderARK_RKBT<Scalar>());
+  }
+  else {
+    erkbt = Teuchos::rcp(new Explicit6Stage4thOrderARK_RKBT<Scalar>());
+    irkbt = Teuchos::rcp(new DIRK6Stage4thOrderARK_RKBT<Scalar>());
+  }
+  this->setRKButcherTableaus(erkbt,irkbt);
+}
+
+
+template <class Scalar>
+bool IMEXRKStepper<Scalar>::computeStages_(Scalar t, Scalar dt)
+{
+  using Teuchos::as;
+  typedef ScalarTraits<Scalar> ST;
+
+  RCP<FancyOStream> out = this->getOStream();
+  Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+  Teuchos::OSTab ostab(out,1,"IMEXRK::computeStages_");
+
+  const Teuchos::SerialDenseMatrix<int,Scalar> AE = erkButcherTableau_->A();
+  const Teuchos::SerialDenseMatrix<int,Scalar> AI = irkButcherTableau_->A();
+  const Teuchos::SerialDenseVector<int,Scalar> bE = erkButcherTableau_->b();
+  const Teuchos::SerialDenseVector<int,Scalar> bI = irkButcherTableau_->b();
+  const Teuchos::SerialDenseVector<int,Scalar> c = irkButcherTableau_->c();
+  const int numStages = irkButcherTableau_->numStages();
+
+  for (int i=0 ; i<numStages ; ++i) {
+
+    // x_stage = x_old + dt*sum_{j<i}( AE(i,j)*kE_j + AI(i,j)*kI_j )
+    V_V( x_stage_.ptr(), *x_old_ );
+    for (int j=0 ; j<i ; ++j) {
+      if (AE(i,j) != ST::zero())
+        Thyra::Vp_StV( x_stage_.ptr(), Scalar(dt*AE(i,j)), *kE_[j] );
+      if (AI(i,j) != ST::zero())
+        Thyra::Vp_StV( x_stage_.ptr(), Scalar(dt*AI(i,j)), *kI_[j] );
+    }
+    const Scalar ts = t + c(i)*dt;
+
+    // Solve the stage equation for kI_i:
+    //
+    //   f_I( kI_i, x_stage + dt*AI(i,i)*kI_i, ts ) = 0
+    //
+    // Only the stiff model is differentiated here, so W = I - dt*AI(i,i)*J_I.
+    neModel_->initializeSingleResidualModel(
+      model_, basePoint_,
+      ST::one(), Teuchos::null,
+      Scalar(dt*AI(i,i)), x_stage_,
+      ts,
+      Teuchos::null
+      );
+    if( solver_->getModel().get() != neModel_.get() ) {
+      solver_->setModel(neModel_);
+    }
+
+    // Use the previous stage derivative as the initial guess.
+    if (i > 0)
+      V_V( kI_[i].ptr(), *kI_[i-1] );
+
+    Thyra::SolveStatus<Scalar> neSolveStatus = solver_->solve( &*kI_[i] );
+
+    if ( as<int>(verbLevel) > as<int>(Teuchos::VERB_LOW) ) {
+      *out << "\nOutput status of nonlinear solve for stage " << i << ":\n"
+           << neSolveStatus;
+    }
+
+    if (neSolveStatus.solveStatus != Thyra::SOLVE_STATUS_CONVERGED) {
+      return false;
+    }
+
+    // X_i = x_stage + dt*AI(i,i)*kI_i and kE_i = f_E(X_i,ts)
+    if (AI(i,i) != ST::zero())
+      Thyra::Vp_StV( x_stage_.ptr(), Scalar(dt*AI(i,i)), *kI_[i] );
+    evalExplicitPart_( *x_stage_, ts, kE_[i].ptr() );
+  }
+
+  // x = x_old + dt*sum_i( bE(i)*kE_i + bI(i)*kI_i )
+  V_V( x_.ptr(), *x_old_ );
+  for (int i=0 ; i<numStages ; ++i) {
+    if (bE(i) != ST::zero())
+      Thyra::Vp_StV( x_.ptr(), Scalar(dt*bE(i)), *kE_[i] );
+    if (bI(i) != ST::zero())
+      Thyra::Vp_StV( x_.ptr(), Scalar(dt*bI(i)), *kI_[i] );
+  }
+
+  if (irkButcherTableau_->isEmbeddedMethod()) {
+    const Teuchos::SerialDenseVector<int,Scalar>
+      bhatE = erkButcherTableau_->bhat();
+    const Teuchos::SerialDenseVector<int,Scalar>
+      bhatI = irkButcherTableau_->bhat();
+    V_V( xhat_.ptr(), *x_old_ );
+    for (int i=0 ; i<numStages ; ++i) {
+      if (bhatE(i) != ST::zero())
+        Thyra::Vp_StV( xhat_.ptr(), Scalar(dt*bhatE(i)), *kE_[i] );
+      if (bhatI(i) != ST::zero())
+        Thyra::Vp_StV( xhat_.ptr(), Scalar(dt*bhatI(i)), *kI_[i] );
+    }
+  }
+
+  return true;
+}
+
+
+template <class Scalar>
+void IMEXRKStepper<Scalar>::evalExplicitPart_(
+  const Thyra::VectorBase<Scalar>& x, Scalar t,
+  const Ptr<Thyra::VectorBase<Scalar> >& kE
+  )
+{
+  typedef ScalarTraits<Scalar> ST;
+  typedef Thyra::ModelEvaluatorBase MEB;
+
+  if (!is_null(explicitModel_)) {
+    eval_model_explicit<Scalar>(*explicitModel_,explicitBasePoint_,x,t,kE);
+  }
+  else if (explicitResponseIndex_ >= 0) {
+    MEB::InArgs<Scalar> inArgs = model_->createInArgs();
+    inArgs.setArgs(basePoint_);
+    inArgs.set_x(Teuchos::rcp(&x,false));
+    if (inArgs.supports(MEB::IN_ARG_t)) {
+      inArgs.set_t(t);
+    }
+    MEB::OutArgs<Scalar> outArgs = model_->createOutArgs();
+    outArgs.set_g(explicitResponseIndex_,Teuchos::rcp(&*kE,false));
+    model_->evalModel(inArgs,outArgs);
+  }
+  else {
+    V_S( kE, ST::zero() );
+  }
+}
+
+
+//
+// Explicit Instantiation macro
+//
+// Must be expanded from within the Rythmos namespace!
+//
+
+#define RYTHMOS_IMEX_RK_STEPPER_INSTANT(SCALAR) \
+  \
+  template class IMEXRKStepper< SCALAR >; \
+  \
+  template RCP< IMEXRKStepper< SCALAR > > \
+  imexRKStepper(); \
+  \
+  template RCP< IMEXRKStepper< SCALAR > > \
+  imexRKStepper( \
+    const RCP<const Thyra::ModelEvaluator< SCALAR > >& implicitModel, \
+    const RCP<const Thyra::ModelEvaluator< SCALAR > >& explicitModel, \
+    const RCP<Thyra::NonlinearSolverBase< SCALAR > >& solver \
+    );
+
+
+} // namespace Rythmos
+
+#endif // Rythmos_IMEX_RK_STEPPER_DEF_H
@@ -171,6 +171,9 @@ public:
   /** \brief . */
   const StepStatus<Scalar> getStepStatus() const;
 
+  /** \brief . */
+  StepperPerformanceCounters getPerformanceCounters() const;
+
   //@}
 
   /** \name Overridden from InterpolationBufferBase */
@@ -282,6 +285,7 @@ private:
   Scalar alpha_s_;    // $\alpha_s$ fixed-leading coefficient of this BDF method
   int numberOfSteps_;// number of total time integration steps taken
   int nef_; // number of error failures 
+  StepperPerformanceCounters perfCounters_; // cumulative work counters
   Scalar usedStep_;
   int nscsco_;
   bool haveInitialCondition_;
@@ -339,6 +339,9 @@ Scalar ImplicitBDFStepper<Scalar>::takeStep(Scalar dt, StepSizeType stepType)
     TEUCHOS_TEST_FOR_EXCEPT(!((1 <= desiredOrder) &&
                               (desiredOrder <= maxOrder_)));
     TEUCHOS_TEST_FOR_EXCEPT(!(desiredOrder <= usedOrder_+1));
+    if (desiredOrder != currentOrder_) {
+      ++perfCounters_.numOrderChanges;
+    }
     currentOrder_ = desiredOrder;
     if (numberOfSteps_ == 0) {
       psi_[0] = hh_;
@@ -411,6 +414,8 @@ Scalar ImplicitBDFStepper<Scalar>::takeStep(Scalar dt, StepSizeType stepType)
       ee_->describe(*out,verbLevel);
     }
     nonlinearSolveStatus_ = solver_->solve( &*xn0_, NULL, &*ee_ );
+    accumulateNonlinearSolveCounters(*solver_, nonlinearSolveStatus_,
+      Teuchos::outArg(perfCounters_));
     if ( as<int>(verbLevel) >= as<int>(Teuchos::VERB_EXTREME) ) {
       *out << "xn0 = " << std::endl;
       xn0_->describe(*out,verbLevel);
@@ -450,6 +455,7 @@ Scalar ImplicitBDFStepper<Scalar>::takeStep(Scalar dt, StepSizeType stepType)
       stepLETStatus_ = STEP_LET_STATUS_FAILED;
       status = stepControl_->rejectStep(*this);
       nef_++;
+      ++perfCounters_.numRejectedSteps;
       if (status == CONTINUE_ANYWAY) {
         break;
       } else {
@@ -465,6 +471,7 @@ Scalar ImplicitBDFStepper<Scalar>::takeStep(Scalar dt, StepSizeType stepType)
   // stepControl_->completeStep.
   completeStep_();
   stepControl_->completeStep(*this);
+  ++perfCounters_.numSteps;
 
   if ( !is_null(out) && as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW) ) {
     *out
@@ -515,6 +522,13 @@ const StepStatus<Scalar> ImplicitBDFStepper<Scalar>::getStepStatus() const
 
 }
 
+template<class Scalar>
+StepperPerformanceCounters
+ImplicitBDFStepper<Scalar>::getPerformanceCounters() const
+{
+  return perfCounters_;
+}
+
 
 // Overridden from InterpolationBufferBase
 
@@ -143,6 +143,9 @@ public:
   
   /** \brief . */
   const StepStatus<Scalar> getStepStatus() const;
+
+  /** \brief . */
+  StepperPerformanceCounters getPerformanceCounters() const;
  
   /** \name Overridden from StepControlStrategyAcceptingStepperBase */
   //@{
@@ -261,6 +264,7 @@ private:
   bool isVariableStep_ = false;
 
   int numSteps_;
+  StepperPerformanceCounters perfCounters_;
   Scalar LETvalue_;   // ck * e
 
   bool haveInitialCondition_;
@@ -431,7 +431,9 @@ Scalar ImplicitRKStepper<Scalar>::takeFixedStep_(Scalar dt, StepSizeType stepSiz
     firkModel_->setTimeStepPoint( x_old_, t, current_dt );
 
     // Solve timestep equation
-    solver_->solve( &*x_stage_bar_ );
+    nonlinearSolveStatus_ = solver_->solve( &*x_stage_bar_ );
+    accumulateNonlinearSolveCounters(*solver_, nonlinearSolveStatus_,
+      Teuchos::outArg(perfCounters_));
 
   } else { // Diagonal Implicit RK Case:
 
@@ -441,7 +443,9 @@ Scalar ImplicitRKStepper<Scalar>::takeFixedStep_(Scalar dt, StepSizeType stepSiz
     int numStages = irkButcherTableau_->numStages();
     for (int stage=0 ; stage < numStages ; ++stage) {
       dirkModel_->setCurrentStage(stage);
-      solver_->solve( &*(x_stage_bar_->getNonconstVectorBlock(stage)) );
+      nonlinearSolveStatus_ = solver_->solve( &*(x_stage_bar_->getNonconstVectorBlock(stage)) );
+      accumulateNonlinearSolveCounters(*solver_, nonlinearSolveStatus_,
+        Teuchos::outArg(perfCounters_));
       dirkModel_->setStageSolution( stage, *(x_stage_bar_->getVectorBlock(stage)) );
     }
 
@@ -459,6 +463,7 @@ Scalar ImplicitRKStepper<Scalar>::takeFixedStep_(Scalar dt, StepSizeType stepSiz
   // Update time range
   timeRange_ = timeRange(t,t+current_dt);
   numSteps_++;
+  ++perfCounters_.numSteps;
 
   return current_dt;
 
@@ -513,7 +518,9 @@ Scalar ImplicitRKStepper<Scalar>::takeVariableStep_(Scalar dt, StepSizeType step
     firkModel_->setTimeStepPoint( x_old_, t, current_dt );
 
     // Solve timestep equation
-    solver_->solve( &*x_stage_bar_ );
+    nonlinearSolveStatus_ = solver_->solve( &*x_stage_bar_ );
+    accumulateNonlinearSolveCounters(*solver_, nonlinearSolveStatus_,
+      Teuchos::outArg(perfCounters_));
 
   } else { // Diagonal Implicit RK Case:
 
@@ -524,6 +531,8 @@ Scalar ImplicitRKStepper<Scalar>::takeVariableStep_(Scalar dt, StepSizeType step
     for (int stage=0 ; stage < numStages ; ++stage) {
         dirkModel_->setCurrentStage(stage);
         nonlinearSolveStatus_ = solver_->solve( &*(x_stage_bar_->getNonconstVectorBlock(stage)) );
+        accumulateNonlinearSolveCounters(*solver_, nonlinearSolveStatus_,
+          Teuchos::outArg(perfCounters_));
 
         if (nonlinearSolveStatus_.solveStatus == Thyra::SOLVE_STATUS_CONVERGED) {
            rkNewtonConvergenceStatus_ = 0;
@@ -595,6 +604,7 @@ Scalar ImplicitRKStepper<Scalar>::takeVariableStep_(Scalar dt, StepSizeType step
      // Update time range
      timeRange_ = timeRange(t,t+current_dt);
      numSteps_++;
+     ++perfCounters_.numSteps;
 
      // completeStep only if the none of the stage solution's failed to converged
      stepControl_->completeStep(*this);
@@ -603,6 +613,7 @@ Scalar ImplicitRKStepper<Scalar>::takeVariableStep_(Scalar dt, StepSizeType step
 
      } else {
      rkNewtonConvergenceStatus_ = -1;
+     ++perfCounters_.numRejectedSteps;
      status = stepControl_-> rejectStep(*this); // reject the stage value
      (void) status; // avoid "set but not used" build warning
      dt_to_return = dt_old;
@@ -640,6 +651,13 @@ const StepStatus<Scalar> ImplicitRKStepper<Scalar>::getStepStatus() const
   return(stepStatus);
 }
 
+template<class Scalar>
+StepperPerformanceCounters
+ImplicitRKStepper<Scalar>::getPerformanceCounters() const
+{
+  return perfCounters_;
+}
+
 
 // Overridden from InterpolationBufferBase
 
@@ -194,6 +194,31 @@ public:
     const int timeStepIter
     );
 
+  /** \brief Observe that one or more event functions changed sign inside
+   * the last completed integration step.
+   *
+   * \param stepper [in] The stepper object.  The located event time lies
+   * inside <tt>stepper.getTimeRange()</tt> so the state at the event can be
+   * recovered with <tt>stepper.getPoints()</tt>.
+   *
+   * \param eventTime [in] The located time of the earliest zero crossing in
+   * the step.
+   *
+   * \param eventIndices [in] The (zero-based) components of the event
+   * response vector that changed sign at <tt>eventTime</tt>.
+   *
+   * This is called after <tt>observeCompletedTimeStep()</tt> for the step in
+   * which the event was located.
+   *
+   * NOTE: This method has been given a default implementation that does
+   * nothing so that existing observers do not need to be changed.
+   */
+  virtual void observeEvent(
+    const StepperBase<Scalar> &stepper,
+    const Scalar &eventTime,
+    const Array<int> &eventIndices
+    );
+
 };
 
 
@@ -275,6 +300,17 @@ observeFailedTimeStep(
 
 }    
 
+template<class Scalar>
+void IntegrationObserverBase<Scalar>::
+observeEvent(
+    const StepperBase<Scalar> &/* stepper */,
+    const Scalar &/* eventTime */,
+    const Array<int> &/* eventIndices */
+    )
+{
+
+}    
+
 
 } // namespace Rythmos
 
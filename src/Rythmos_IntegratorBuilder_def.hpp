@@ -45,6 +45,7 @@
 #include "Rythmos_FixedStepControlStrategy.hpp"
 #include "Rythmos_SimpleStepControlStrategy.hpp"
 #include "Rythmos_FirstOrderErrorStepControlStrategy.hpp"
+#include "Rythmos_CFLStepControlStrategy.hpp"
 #include "Rythmos_ImplicitBDFStepperStepControl.hpp"
 #include "Rythmos_ImplicitBDFStepperRampingStepControl.hpp"
 #include "Rythmos_InterpolationBuffer.hpp"
@@ -270,6 +271,15 @@ namespace {
     "by using a weight norm of the difference between the predicted and "
     "solution.  See Gresho and Sani, `Incompressible Flow and the Finite "
     "Element Method', Vol. 1, 1998, p. 268.";
+  static std::string cflStepControl_name =
+    "CFL Step Control Strategy";
+  static std::string cflStepControl_docs =
+    "This Step Control Strategy produces the largest stable step size for "
+    "an explicit method from a model response giving the local wave speed "
+    "over mesh size, scaled by the CFL number and the SSP coefficient of "
+    "the Runge-Kutta Butcher tableau.  See Gottlieb, Ketcheson and Shu, "
+    "`Strong Stability Preserving Runge-Kutta and Multistep Time "
+    "Discretizations', 2011.";
   static std::string implicitBDFRampingStepControl_name =
     "Implicit BDF Stepper Ramping Step Control Strategy";
   static std::string implicitBDFRampingStepControl_docs =
@@ -560,6 +570,10 @@ IntegratorBuilder<Scalar>::getValidParameters() const
           stepControlSelectionPL.sublist(firstOrderErrorStepControl_name,false,
                                          firstOrderErrorStepControl_docs)
                                 .disableRecursiveValidation();
+          // CFL Step Control Strategy
+          stepControlSelectionPL.sublist(cflStepControl_name,false,
+                                         cflStepControl_docs)
+                                .disableRecursiveValidation();
           // Implicit BDF Stepper Step Control Strategy
           stepControlSelectionPL.sublist(implicitBDFStepControl_name,false,
                                          implicitBDFStepControl_docs)
@@ -952,6 +966,10 @@ void IntegratorBuilder<Scalar>::initializeDefaults_()
       abstractFactoryStd< StepControlStrategyBase<Scalar>,
                           FirstOrderErrorStepControlStrategy<Scalar> >(),
       firstOrderErrorStepControl_name);
+  stepControlBuilder_->setObjectFactory(
+      abstractFactoryStd< StepControlStrategyBase<Scalar>,
+                          CFLStepControlStrategy<Scalar> >(),
+      cflStepControl_name);
   stepControlBuilder_->setObjectFactory(
       abstractFactoryStd< StepControlStrategyBase<Scalar>,
                           ImplicitBDFStepperStepControl<Scalar> >(),
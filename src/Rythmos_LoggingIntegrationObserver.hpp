@@ -83,6 +83,12 @@ public:
     const int timeStepIter
     );
 
+  void observeEvent(
+    const StepperBase<Scalar> &stepper,
+    const Scalar &eventTime,
+    const Array<int> &eventIndices
+    );
+
   //@}
 
   /** \name string names logged in map 
@@ -98,6 +104,7 @@ public:
   const std::string nameObserveStartTimeStep_;
   const std::string nameObserveCompletedTimeStep_;
   const std::string nameObserveFailedTimeStep_;
+  const std::string nameObserveEvent_;
 
   //@}
 
@@ -145,7 +152,8 @@ LoggingIntegrationObserver<Scalar>::LoggingIntegrationObserver() :
   nameObserveEndTimeIntegration_("observeEndTimeIntegration"),
   nameObserveStartTimeStep_("observeStartTimeStep"),
   nameObserveCompletedTimeStep_("observeCompletedTimeStep"),
-  nameObserveFailedTimeStep_("observeFailedTimeStep")
+  nameObserveFailedTimeStep_("observeFailedTimeStep"),
+  nameObserveEvent_("observeEvent")
 { 
   counters_ = Teuchos::rcp(new std::map<std::string,int>);
   order_ = Teuchos::rcp(new std::list<std::string>);
@@ -163,6 +171,7 @@ resetLogCounters()
   (*counters_)[nameObserveStartTimeStep_] = 0;
   (*counters_)[nameObserveCompletedTimeStep_] = 0;
   (*counters_)[nameObserveFailedTimeStep_] = 0;
+  (*counters_)[nameObserveEvent_] = 0;
   order_->clear();
 }
 
@@ -171,8 +180,12 @@ RCP<IntegrationObserverBase<Scalar> >
 LoggingIntegrationObserver<Scalar>::cloneIntegrationObserver() const
 {
   logCall(nameCloneIntegrationObserver_);
-  Teuchos::RCP<IntegrationObserverBase<Scalar> > observer = 
+  Teuchos::RCP<LoggingIntegrationObserver<Scalar> > observer = 
     Teuchos::rcp(new LoggingIntegrationObserver<Scalar>(*this));
+  // Give the clone its own copy of the log so that clones can be used by
+  // integrators running on different threads.
+  observer->counters_ = Teuchos::rcp(new std::map<std::string,int>(*counters_));
+  observer->order_ = Teuchos::rcp(new std::list<std::string>(*order_));
   return observer;
 }
   
@@ -228,6 +241,16 @@ void LoggingIntegrationObserver<Scalar>::observeFailedTimeStep(
   logCall(nameObserveFailedTimeStep_);
 }				
 
+template<typename Scalar>
+void LoggingIntegrationObserver<Scalar>::observeEvent(
+    const StepperBase<Scalar> &stepper,
+    const Scalar &eventTime,
+    const Array<int> &eventIndices
+    )
+{
+  logCall(nameObserveEvent_);
+}				
+
 template<typename Scalar>
 RCP<const std::map<std::string,int> > LoggingIntegrationObserver<Scalar>::getCounters()
 {
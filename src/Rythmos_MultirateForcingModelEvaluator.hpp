@@ -0,0 +1,205 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef RYTHMOS_MULTIRATE_FORCING_MODEL_EVALUATOR_HPP
+#define RYTHMOS_MULTIRATE_FORCING_MODEL_EVALUATOR_HPP
+
+
+#include "Rythmos_Types.hpp"
+#include "Thyra_ModelEvaluatorDelegatorBase.hpp"
+#include "Thyra_VectorStdOps.hpp"
+
+
+namespace Rythmos {
+
+
+/** \brief Decorator subclass that adds a constant forcing vector to the
+ * right hand side of a model.
+ *
+ * For the explicit form of the underlying model this gives
+ *
+ \verbatim
+
+ x_dot = f(x,t) + r
+ \endverbatim
+ *
+ * and for the implicit form (<tt>x_dot</tt> is set)
+ *
+ \verbatim
+
+ F(x_dot,x,t) - r = 0
+ \endverbatim
+ *
+ * Since <tt>r</tt> does not depend on <tt>x</tt> or <tt>x_dot</tt>, all
+ * other output arguments (W, W_op, DfDp, ...) are passed through unchanged.
+ * This is the inner (fast) model of the <tt>MultirateStepper</tt>, where
+ * <tt>r</tt> carries the slow tendencies into the fast subcycling.
+ *
+ * The forcing vector is held by reference, so the client can update it in
+ * place between steps of the stepper that integrates this model.
+ */
+template<class Scalar>
+class MultirateForcingModelEvaluator
+  : virtual public Thyra::ModelEvaluatorDelegatorBase<Scalar>
+{
+public:
+
+  /** \name Constructors/initializers/accessors */
+  //@{
+
+  /** \brief . */
+  MultirateForcingModelEvaluator();
+
+  /** \brief . */
+  void initializeMultirateForcingModel(
+    const RCP<const Thyra::ModelEvaluator<Scalar> > &model,
+    const RCP<const Thyra::VectorBase<Scalar> > &forcing
+    );
+
+  /** \brief . */
+  RCP<const Thyra::VectorBase<Scalar> > getForcing() const;
+
+  //@}
+
+private:
+
+  /** \name Private functions overridden from ModelEvaluatorDefaultBase */
+  //@{
+
+  /** \brief . */
+  void evalModelImpl(
+    const Thyra::ModelEvaluatorBase::InArgs<Scalar>& inArgs,
+    const Thyra::ModelEvaluatorBase::OutArgs<Scalar>& outArgs
+    ) const;
+
+  //@}
+
+private:
+
+  RCP<const Thyra::VectorBase<Scalar> > forcing_;
+
+};
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates MultirateForcingModelEvaluator
+ */
+template<class Scalar>
+RCP<MultirateForcingModelEvaluator<Scalar> >
+multirateForcingModelEvaluator(
+  const RCP<const Thyra::ModelEvaluator<Scalar> > &model,
+  const RCP<const Thyra::VectorBase<Scalar> > &forcing
+  )
+{
+  RCP<MultirateForcingModelEvaluator<Scalar> >
+    forcingModel = Teuchos::rcp(new MultirateForcingModelEvaluator<Scalar>());
+  forcingModel->initializeMultirateForcingModel(model,forcing);
+  return forcingModel;
+}
+
+
+// ///////////////////////
+// Definition
+
+
+// Constructors/initializers/accessors
+
+
+template<class Scalar>
+MultirateForcingModelEvaluator<Scalar>::MultirateForcingModelEvaluator()
+{}
+
+
+template<class Scalar>
+void MultirateForcingModelEvaluator<Scalar>::initializeMultirateForcingModel(
+  const RCP<const Thyra::ModelEvaluator<Scalar> > &model,
+  const RCP<const Thyra::VectorBase<Scalar> > &forcing
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(model));
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(forcing));
+  this->Thyra::ModelEvaluatorDelegatorBase<Scalar>::initialize(model);
+  forcing_ = forcing;
+}
+
+
+template<class Scalar>
+RCP<const Thyra::VectorBase<Scalar> >
+MultirateForcingModelEvaluator<Scalar>::getForcing() const
+{
+  return forcing_;
+}
+
+
+// Private functions overridden from ModelEvaluatorDefaultBase
+
+
+template<class Scalar>
+void MultirateForcingModelEvaluator<Scalar>::evalModelImpl(
+  const Thyra::ModelEvaluatorBase::InArgs<Scalar>& inArgs,
+  const Thyra::ModelEvaluatorBase::OutArgs<Scalar>& outArgs
+  ) const
+{
+
+  using Teuchos::as;
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  typedef Thyra::ModelEvaluatorBase MEB;
+
+  const RCP<const Thyra::ModelEvaluator<Scalar> >
+    model = this->getUnderlyingModel();
+
+  THYRA_MODEL_EVALUATOR_DECORATOR_EVAL_MODEL_BEGIN(
+    "Rythmos::MultirateForcingModelEvaluator",inArgs,outArgs
+    );
+
+  MEB::InArgs<Scalar> modelInArgs = model->createInArgs();
+  modelInArgs.setArgs(inArgs);
+  MEB::OutArgs<Scalar> modelOutArgs = model->createOutArgs();
+  modelOutArgs.setArgs(outArgs);
+  model->evalModel(modelInArgs,modelOutArgs);
+
+  const RCP<Thyra::VectorBase<Scalar> > f = outArgs.get_f();
+  if (!is_null(f)) {
+    const bool implicitForm =
+      ( inArgs.supports(MEB::IN_ARG_x_dot) && !is_null(inArgs.get_x_dot()) );
+    Thyra::Vp_StV( f.ptr(), ( implicitForm ? -ST::one() : ST::one() ),
+      *forcing_ );
+    if (as<int>(verbLevel) >= as<int>(Teuchos::VERB_EXTREME))
+      *out << "\nf (with forcing) = " << *f;
+  }
+
+  THYRA_MODEL_EVALUATOR_DECORATOR_EVAL_MODEL_END();
+
+}
+
+
+} // namespace Rythmos
+
+
+#endif // RYTHMOS_MULTIRATE_FORCING_MODEL_EVALUATOR_HPP
@@ -0,0 +1,5 @@
+#include "Rythmos_MultirateStepper_decl.hpp"
+#ifndef HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
+#include "Rythmos_MultirateStepper_def.hpp"
+#endif
+
@@ -0,0 +1,335 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_MULTIRATE_STEPPER_DECL_H
+#define Rythmos_MULTIRATE_STEPPER_DECL_H
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_StepperBase.hpp"
+#include "Rythmos_RKButcherTableauAcceptingStepperBase.hpp"
+#include "Rythmos_RKButcherTableauBase.hpp"
+#include "Rythmos_MultirateForcingModelEvaluator.hpp"
+
+#include "Thyra_ModelEvaluator.hpp"
+
+namespace Rythmos {
+
+
+/** \brief Multirate infinitesimal step (MIS) stepper.
+ *
+ * This stepper integrates split problems of the form
+ *
+ \verbatim
+
+   x_dot = f_S(x,t) + f_F(x,t)
+
+ \endverbatim
+ *
+ * where <tt>f_F</tt> is fast and <tt>f_S</tt> is slow.  The slow part is
+ * advanced with large steps <tt>dt</tt> using an explicit RK tableau with
+ * nondecreasing <tt>c</tt>, and between two slow stages the fast part is
+ * subcycled by an inner stepper on the ODE
+ *
+ \verbatim
+
+   v_dot = f_F(v,tau) + r_i,   tau in [t_n + c_i*dt, t_n + c_{i+1}*dt]
+
+   r_i = 1/(c_{i+1}-c_i) * sum_{j<=i} ( A(i+1,j) - A(i,j) ) * f_S(X_j)
+
+ \endverbatim
+ *
+ * with <tt>v = X_i</tt> at the start of the interval and <tt>X_{i+1}</tt> the
+ * value at its end (row <tt>s+1</tt> of <tt>A</tt> is <tt>b</tt> and
+ * <tt>c_{s+1} = 1</tt>).  This is the MIS method of Wensch, Knoth and Galant
+ * (BIT 49, 2009), which reduces to the slow RK method when <tt>f_F = 0</tt>
+ * and to the inner method when <tt>f_S = 0</tt>.  It is second order for any
+ * second order slow tableau, and third order for the default tableau of
+ * Knoth and Wolke when the inner integration is at least third order.
+ *
+ * The slow model, given through <tt>setModel()</tt>, is only evaluated once
+ * per slow stage, so the slow dynamics are never resolved at the fast time
+ * scale.  The fast model is given through <tt>setFastModel()</tt> and is
+ * wrapped in a <tt>MultirateForcingModelEvaluator</tt> that is handed to the
+ * inner stepper.  Any stepper that accepts a model may be used as the inner
+ * stepper (e.g., <tt>ImplicitBDFStepper</tt> for a stiff fast part); the
+ * default is <tt>ExplicitRKStepper</tt> with the classic fourth order
+ * tableau.  With "Fast Step Type" = "Variable" the inner stepper picks its
+ * own step sizes through its step control strategy, limited only by the end
+ * of each slow stage interval.
+ *
+ * Unlike <tt>StackedStepper</tt>, whose steppers each own a separate part of
+ * the state and share one step size, both parts here act on the same state,
+ * and the fast stepper takes many steps per slow step.
+ */
+template<class Scalar>
+class MultirateStepper :
+  virtual public RKButcherTableauAcceptingStepperBase<Scalar>
+{
+public:
+
+  /** \brief . */
+  typedef typename ScalarTraits<Scalar>::magnitudeType ScalarMag;
+
+  /** \name Constructors, intializers, Misc. */
+  //@{
+
+  /** \brief . */
+  MultirateStepper();
+
+  /** \brief Set the fast part of the model.
+   *
+   * The fast model must share the state space of the slow model and is
+   * evaluated by the inner stepper in whatever form that stepper needs.
+   */
+  void setFastModel(
+    const RCP<const Thyra::ModelEvaluator<Scalar> >& fastModel
+    );
+
+  /** \brief . */
+  RCP<const Thyra::ModelEvaluator<Scalar> > getFastModel() const;
+
+  /** \brief Set the inner stepper that subcycles the fast part.
+   *
+   * The stepper must accept a model and must not have a model set yet; it
+   * is given the forced fast model on initialization.
+   */
+  void setFastStepper(const RCP<StepperBase<Scalar> >& fastStepper);
+
+  /** \brief . */
+  RCP<StepperBase<Scalar> > getNonconstFastStepper();
+
+  /** \brief . */
+  RCP<const StepperBase<Scalar> > getFastStepper() const;
+
+  /** \brief Number of evaluations of the slow model since the last call to
+   * <tt>setInitialCondition()</tt>. */
+  int getNumSlowEvaluations() const;
+
+  /** \brief Number of steps taken by the fast stepper since the last call
+   * to <tt>setInitialCondition()</tt>. */
+  int getNumFastSteps() const;
+
+  //@}
+
+  /** \name Overridden from RKButcherTableauAcceptingStepperBase */
+  //@{
+
+  /** \brief Set the slow tableau.
+   *
+   * The tableau must be ERK with <tt>0 <= c_1 <= ... <= c_s <= 1</tt>.
+   */
+  void setRKButcherTableau(
+    const RCP<const RKButcherTableauBase<Scalar> > &rkbt
+    );
+
+  /** \brief . */
+  RCP<const RKButcherTableauBase<Scalar> > getRKButcherTableau() const;
+
+  //@}
+
+  /** \name Overridden from StepperBase */
+  //@{
+
+  /** \brief Returns false. */
+  bool isImplicit() const;
+
+  /** \brief Returns true. */
+  bool supportsCloning() const;
+
+  /** \brief . */
+  RCP<StepperBase<Scalar> > cloneStepperAlgorithm() const;
+
+  /** \brief Set the slow part of the model. */
+  void setModel(const RCP<const Thyra::ModelEvaluator<Scalar> >& model);
+
+  /** \brief . */
+  void setNonconstModel(const RCP<Thyra::ModelEvaluator<Scalar> >& model);
+
+  /** \brief . */
+  RCP<const Thyra::ModelEvaluator<Scalar> > getModel() const;
+
+  /** \brief . */
+  RCP<Thyra::ModelEvaluator<Scalar> > getNonconstModel();
+
+  /** \brief . */
+  void setInitialCondition(
+    const Thyra::ModelEvaluatorBase::InArgs<Scalar> &initialCondition
+    );
+
+  /** \brief . */
+  Thyra::ModelEvaluatorBase::InArgs<Scalar> getInitialCondition() const;
+
+  /** \brief Take a slow step of size <tt>dt</tt>.
+   *
+   * The slow step size is always <tt>dt</tt>; only the fast stepper adapts
+   * its step size.
+   */
+  Scalar takeStep(Scalar dt, StepSizeType flag);
+
+  /** \brief . */
+  const StepStatus<Scalar> getStepStatus() const;
+
+  //@}
+
+  /** \name Overridden from InterpolationBufferBase */
+  //@{
+
+  /** \brief . */
+  RCP<const Thyra::VectorSpaceBase<Scalar> >
+  get_x_space() const;
+
+  /** \brief . */
+  void addPoints(
+    const Array<Scalar>& time_vec,
+    const Array<RCP<const Thyra::VectorBase<Scalar> > >& x_vec,
+    const Array<RCP<const Thyra::VectorBase<Scalar> > >& xdot_vec
+    );
+
+  /** \brief . */
+  TimeRange<Scalar> getTimeRange() const;
+
+  /** \brief . */
+  void getPoints(
+    const Array<Scalar>& time_vec,
+    Array<RCP<const Thyra::VectorBase<Scalar> > >* x_vec,
+    Array<RCP<const Thyra::VectorBase<Scalar> > >* xdot_vec,
+    Array<ScalarMag>* accuracy_vec
+    ) const;
+
+  /** \brief . */
+  void getNodes(Array<Scalar>* time_vec) const;
+
+  /** \brief . */
+  void removeNodes(Array<Scalar>& time_vec);
+
+  /** \brief Returns the order of the slow tableau. */
+  int getOrder() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::ParameterListAcceptor */
+  //@{
+
+  /** \brief . */
+  void setParameterList(RCP<ParameterList> const& paramList);
+
+  /** \brief . */
+  RCP<ParameterList> getNonconstParameterList();
+
+  /** \brief . */
+  RCP<ParameterList> unsetParameterList();
+
+  /** \brief . */
+  RCP<const ParameterList> getValidParameters() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::Describable */
+  //@{
+
+  /** \brief . */
+  void describe(
+    FancyOStream  &out,
+    const Teuchos::EVerbosityLevel verbLevel
+    ) const;
+
+  //@}
+
+private:
+
+  // ///////////////////////
+  // Private date members
+
+  bool isInitialized_;
+  bool haveInitialCondition_;
+  RCP<const Thyra::ModelEvaluator<Scalar> > model_;
+  RCP<const Thyra::ModelEvaluator<Scalar> > fastModel_;
+  RCP<MultirateForcingModelEvaluator<Scalar> > forcingModel_;
+  RCP<StepperBase<Scalar> > fastStepper_;
+  RCP<const RKButcherTableauBase<Scalar> > rkButcherTableau_;
+  RCP<ParameterList> paramList_;
+
+  Thyra::ModelEvaluatorBase::InArgs<Scalar> basePoint_;
+  RCP<Thyra::VectorBase<Scalar> > x_;
+  RCP<Thyra::VectorBase<Scalar> > x_old_;
+  RCP<Thyra::VectorBase<Scalar> > forcing_;
+  Array<RCP<Thyra::VectorBase<Scalar> > > kS_;
+  TimeRange<Scalar> timeRange_;
+  Scalar dt_;
+  int numSteps_;
+  int numSlowEvaluations_;
+  int numFastSteps_;
+  int fastStepsPerSlowStep_;
+  StepSizeType fastStepType_;
+
+  static const std::string fastStepsPerSlowStep_name_;
+  static const int fastStepsPerSlowStep_default_;
+  static const std::string fastStepType_name_;
+  static const std::string fastStepType_default_;
+
+  // ///////////////////////
+  // Private member functions
+
+  void defaultInitializeAll_();
+  void initialize_();
+
+  // Compute the new solution over [t,t+dt].  Returns false if the fast
+  // stepper failed.
+  bool computeStep_(Scalar t, Scalar dt);
+
+  // Advance x_ from t0 to t1 = t0 + dc*slowDt with the fast stepper and the
+  // current forcing.
+  bool integrateFast_(Scalar t0, Scalar t1, Scalar dc, Scalar slowDt);
+
+};
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates MultirateStepper
+ */
+template<class Scalar>
+RCP<MultirateStepper<Scalar> >
+multirateStepper();
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates MultirateStepper
+ */
+template<class Scalar>
+RCP<MultirateStepper<Scalar> >
+multirateStepper(
+  const RCP<const Thyra::ModelEvaluator<Scalar> >& slowModel,
+  const RCP<const Thyra::ModelEvaluator<Scalar> >& fastModel
+  );
+
+
+} // namespace Rythmos
+
+#endif // Rythmos_MULTIRATE_STEPPER_DECL_H
@@ -0,0 +1,877 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_MULTIRATE_STEPPER_DEF_H
+#define Rythmos_MULTIRATE_STEPPER_DEF_H
+
+#include "Rythmos_MultirateStepper_decl.hpp"
+
+#include "Rythmos_StepperHelpers.hpp"
+#include "Rythmos_RKButcherTableau.hpp"
+#include "Rythmos_RKButcherTableauHelpers.hpp"
+#include "Rythmos_ExplicitRKStepper.hpp"
+
+#include "Thyra_AssertOp.hpp"
+#include "Thyra_VectorStdOps.hpp"
+#include "Teuchos_StandardParameterEntryValidators.hpp"
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+#include "Teuchos_as.hpp"
+
+namespace Rythmos {
+
+
+template<class Scalar>
+RCP<MultirateStepper<Scalar> >
+multirateStepper()
+{
+  RCP<MultirateStepper<Scalar> > stepper(new MultirateStepper<Scalar>());
+  return stepper;
+}
+
+template<class Scalar>
+RCP<MultirateStepper<Scalar> >
+multirateStepper(
+  const RCP<const Thyra::ModelEvaluator<Scalar> >& slowModel,
+  const RCP<const Thyra::ModelEvaluator<Scalar> >& fastModel
+  )
+{
+  RCP<MultirateStepper<Scalar> > stepper(new MultirateStepper<Scalar>());
+  stepper->setModel(slowModel);
+  stepper->setFastModel(fastModel);
+  return stepper;
+}
+
+
+// Static members
+
+
+template<class Scalar>
+const std::string
+MultirateStepper<Scalar>::fastStepsPerSlowStep_name_
+= "Fast Steps per Slow Step";
+
+template<class Scalar>
+const int
+MultirateStepper<Scalar>::fastStepsPerSlowStep_default_
+= 10;
+
+template<class Scalar>
+const std::string
+MultirateStepper<Scalar>::fastStepType_name_
+= "Fast Step Type";
+
+template<class Scalar>
+const std::string
+MultirateStepper<Scalar>::fastStepType_default_
+= "Fixed";
+
+
+// ////////////////////////////
+// Defintions
+
+
+// Constructors, intializers, Misc.
+
+
+template<class Scalar>
+MultirateStepper<Scalar>::MultirateStepper()
+{
+  this->defaultInitializeAll_();
+  numSteps_ = 0;
+  numSlowEvaluations_ = 0;
+  numFastSteps_ = 0;
+}
+
+template<class Scalar>
+void MultirateStepper<Scalar>::defaultInitializeAll_()
+{
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  isInitialized_ = false;
+  haveInitialCondition_ = false;
+  model_ = Teuchos::null;
+  fastModel_ = Teuchos::null;
+  forcingModel_ = Teuchos::null;
+  fastStepper_ = Teuchos::null;
+  rkButcherTableau_ = Teuchos::null;
+  paramList_ = Teuchos::null;
+  //basePoint_;
+  x_ = Teuchos::null;
+  x_old_ = Teuchos::null;
+  forcing_ = Teuchos::null;
+  kS_.clear();
+  //timeRange_;
+  dt_ = ST::nan();
+  numSteps_ = -1;
+  numSlowEvaluations_ = -1;
+  numFastSteps_ = -1;
+  fastStepsPerSlowStep_ = fastStepsPerSlowStep_default_;
+  fastStepType_ = STEP_TYPE_FIXED;
+}
+
+
+template<class Scalar>
+void MultirateStepper<Scalar>::setFastModel(
+  const RCP<const Thyra::ModelEvaluator<Scalar> >& fastModel
+  )
+{
+  typedef Thyra::ModelEvaluatorBase MEB;
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(fastModel));
+  const MEB::InArgs<Scalar> inArgs = fastModel->createInArgs();
+  const MEB::OutArgs<Scalar> outArgs = fastModel->createOutArgs();
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !inArgs.supports(MEB::IN_ARG_x) || !outArgs.supports(MEB::OUT_ARG_f),
+    std::logic_error,
+    "Error!  The fast model passed to MultirateStepper::setFastModel "
+    "must support x and f!"
+    );
+  fastModel_ = fastModel;
+  isInitialized_ = false;
+}
+
+
+template<class Scalar>
+RCP<const Thyra::ModelEvaluator<Scalar> >
+MultirateStepper<Scalar>::getFastModel() const
+{
+  return fastModel_;
+}
+
+
+template<class Scalar>
+void MultirateStepper<Scalar>::setFastStepper(
+  const RCP<StepperBase<Scalar> >& fastStepper
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(fastStepper));
+  TEUCHOS_TEST_FOR_EXCEPTION( !fastStepper->acceptsModel(), std::logic_error,
+    "Error!  The fast stepper passed to MultirateStepper::setFastStepper "
+    "must accept a model!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION( !is_null(fastStepper->getModel()),
+    std::logic_error,
+    "Error!  The fast stepper passed to MultirateStepper::setFastStepper "
+    "already has a model set!"
+    );
+  fastStepper_ = fastStepper;
+  isInitialized_ = false;
+}
+
+
+template<class Scalar>
+RCP<StepperBase<Scalar> >
+MultirateStepper<Scalar>::getNonconstFastStepper()
+{
+  return fastStepper_;
+}
+
+
+template<class Scalar>
+RCP<const StepperBase<Scalar> >
+MultirateStepper<Scalar>::getFastStepper() const
+{
+  return fastStepper_;
+}
+
+
+template<class Scalar>
+int MultirateStepper<Scalar>::getNumSlowEvaluations() const
+{
+  return numSlowEvaluations_;
+}
+
+
+template<class Scalar>
+int MultirateStepper<Scalar>::getNumFastSteps() const
+{
+  return numFastSteps_;
+}
+
+
+// Overridden from RKButcherTableauAcceptingStepperBase
+
+
+template<class Scalar>
+void MultirateStepper<Scalar>::setRKButcherTableau(
+  const RCP<const RKButcherTableauBase<Scalar> > &rkbt
+  )
+{
+  typedef ScalarTraits<Scalar> ST;
+  TEUCHOS_ASSERT( !is_null(rkbt) );
+  validateERKButcherTableau(*rkbt);
+  const Teuchos::SerialDenseVector<int,Scalar> c = rkbt->c();
+  const int numStages = rkbt->numStages();
+  for (int i=0 ; i<numStages ; ++i) {
+    const Scalar c_next = ( i+1 < numStages ? c(i+1) : ST::one() );
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      c(i) < ST::zero() || c_next < c(i), std::logic_error,
+      "Error!  The slow RK Butcher Tableau of the MultirateStepper must have "
+      "0 <= c_1 <= ... <= c_s <= 1, but c(" << i << ") = " << c(i)
+      << " and the next stage time is " << c_next << "!"
+      );
+  }
+  rkButcherTableau_ = rkbt;
+  isInitialized_ = false;
+}
+
+
+template<class Scalar>
+RCP<const RKButcherTableauBase<Scalar> >
+MultirateStepper<Scalar>::getRKButcherTableau() const
+{
+  return rkButcherTableau_;
+}
+
+
+// Overridden from StepperBase
+
+
+template<class Scalar>
+bool MultirateStepper<Scalar>::isImplicit() const
+{
+  return false;
+}
+
+
+template<class Scalar>
+bool MultirateStepper<Scalar>::supportsCloning() const
+{
+  return true;
+}
+
+
+template<class Scalar>
+RCP<StepperBase<Scalar> >
+MultirateStepper<Scalar>::cloneStepperAlgorithm() const
+{
+  // Just use the interface to clone the algorithm in a basically
+  // uninitialized state
+  RCP<MultirateStepper<Scalar> >
+    stepper = Teuchos::rcp(new MultirateStepper<Scalar>());
+
+  if (!is_null(model_)) {
+    stepper->setModel(model_); // Shallow copy is okay!
+  }
+
+  if (!is_null(fastModel_)) {
+    stepper->setFastModel(fastModel_); // Shallow copy is okay!
+  }
+
+  if (!is_null(rkButcherTableau_)) {
+    stepper->setRKButcherTableau(rkButcherTableau_);
+  }
+
+  if (!is_null(paramList_)) {
+    stepper->setParameterList(Teuchos::parameterList(*paramList_));
+  }
+
+  if (!is_null(fastStepper_)) {
+    // The fast stepper has been given the forced fast model of this stepper,
+    // so the clone gets a fresh copy of the algorithm without it.
+    TEUCHOS_TEST_FOR_EXCEPTION( !fastStepper_->supportsCloning(),
+      std::logic_error,
+      "Error!  The fast stepper of this MultirateStepper does not support "
+      "cloning!"
+      );
+    RCP<StepperBase<Scalar> >
+      fastStepper = fastStepper_->cloneStepperAlgorithm();
+    if (is_null(fastStepper->getModel()))
+      stepper->setFastStepper(fastStepper);
+  }
+
+  return stepper;
+}
+
+
+template<class Scalar>
+void MultirateStepper<Scalar>::setModel(
+  const RCP<const Thyra::ModelEvaluator<Scalar> >& model
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(model));
+  assertValidModel( *this, *model );
+  model_ = model;
+  isInitialized_ = false;
+}
+
+
+template<class Scalar>
+void MultirateStepper<Scalar>::setNonconstModel(
+  const RCP<Thyra::ModelEvaluator<Scalar> >& model
+  )
+{
+  this->setModel(model);
+}
+
+
+template<class Scalar>
+RCP<const Thyra::ModelEvaluator<Scalar> >
+MultirateStepper<Scalar>::getModel() const
+{
+  return model_;
+}
+
+
+template<class Scalar>
+RCP<Thyra::ModelEvaluator<Scalar> >
+MultirateStepper<Scalar>::getNonconstModel()
+{
+  return Teuchos::null;
+}
+
+
+template<class Scalar>
+void MultirateStepper<Scalar>::setInitialCondition(
+  const Thyra::ModelEvaluatorBase::InArgs<Scalar> &initialCondition
+  )
+{
+  typedef ScalarTraits<Scalar> ST;
+  typedef Thyra::ModelEvaluatorBase MEB;
+
+  basePoint_ = initialCondition;
+
+  // x
+
+  RCP<const Thyra::VectorBase<Scalar> >
+    x_init = initialCondition.get_x();
+
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(x_init), std::logic_error,
+    "Error, if the client passes in an intial condition to "
+    "setInitialCondition(...), then x can not be null!" );
+
+  x_ = x_init->clone_v();
+  x_old_ = x_->clone_v();
+
+  // t
+
+  const Scalar t =
+    (
+      initialCondition.supports(MEB::IN_ARG_t)
+      ? initialCondition.get_t()
+      : ST::zero()
+      );
+
+  timeRange_ = timeRange(t,t);
+  numSteps_ = 0;
+  numSlowEvaluations_ = 0;
+  numFastSteps_ = 0;
+
+  haveInitialCondition_ = true;
+}
+
+
+template<class Scalar>
+Thyra::ModelEvaluatorBase::InArgs<Scalar>
+MultirateStepper<Scalar>::getInitialCondition() const
+{
+  return basePoint_;
+}
+
+
+template<class Scalar>
+Scalar MultirateStepper<Scalar>::takeStep(Scalar dt, StepSizeType stepSizeType)
+{
+  using Teuchos::as;
+  using Teuchos::incrVerbLevel;
+  typedef ScalarTraits<Scalar> ST;
+  typedef Teuchos::VerboseObjectTempState<InterpolationBufferBase<Scalar> > VOTSIBB;
+
+  initialize_();
+
+  RCP<FancyOStream> out = this->getOStream();
+  Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+  Teuchos::OSTab ostab(out,1,"Multirate::takeStep");
+  VOTSIBB fastStepper_outputTempState(fastStepper_,out,
+    incrVerbLevel(verbLevel,-1));
+
+  if ( !is_null(out) && as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW) ) {
+    *out
+      << "\nEntering "
+      << Teuchos::TypeNameTraits<MultirateStepper<Scalar> >::name()
+      << "::takeStep("<<dt<<","<<toString(stepSizeType)<<") ...\n";
+  }
+
+  if (dt <= ST::zero()) {
+    if ( as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW) )
+      *out << "\nThe arguments to takeStep are not valid for "
+           << "MultirateStepper at this time.\n"
+           << "  dt = " << dt << "\n"
+           << "MultirateStepper requires positive dt.\n" << std::endl;
+    return(Scalar(-ST::one()));
+  }
+
+  const Scalar t = timeRange_.upper();
+  V_V( x_old_.ptr(), *x_ );
+  dt_ = dt;
+
+  if (computeStep_(t,dt_)) {
+    timeRange_ = timeRange(t,t+dt_);
+    numSteps_++;
+  }
+  else {
+    // Complete failure.  Return to Integrator with bad step size.
+    V_V( x_.ptr(), *x_old_ );
+    dt_ = Scalar(-ST::one());
+  }
+
+  if ( !is_null(out) && as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW) ) {
+    *out
+      << "\nLeaving "
+      << Teuchos::TypeNameTraits<MultirateStepper<Scalar> >::name()
+      << "::takeStep("<<dt_<<","<<toString(stepSizeType)<<") ...\n";
+  }
+
+  return(dt_);
+}
+
+
+template<class Scalar>
+const StepStatus<Scalar> MultirateStepper<Scalar>::getStepStatus() const
+{
+  StepStatus<Scalar> stepStatus;
+
+  if (!isInitialized_) {
+    stepStatus.stepStatus = STEP_STATUS_UNINITIALIZED;
+    stepStatus.message = "This stepper is uninitialized.";
+  }
+  else if (numSteps_ > 0) {
+    stepStatus.stepStatus = STEP_STATUS_CONVERGED;
+  }
+  else {
+    stepStatus.stepStatus = STEP_STATUS_UNKNOWN;
+  }
+  stepStatus.stepSize = timeRange_.length();
+  stepStatus.order = ( is_null(rkButcherTableau_) ? 0 : this->getOrder() );
+  stepStatus.time = timeRange_.upper();
+  if(Teuchos::nonnull(x_))
+    stepStatus.solution = x_;
+  else
+    stepStatus.solution = Teuchos::null;
+  stepStatus.solutionDot = Teuchos::null;
+  return(stepStatus);
+}
+
+
+// Overridden from InterpolationBufferBase
+
+
+template<class Scalar>
+RCP<const Thyra::VectorSpaceBase<Scalar> >
+MultirateStepper<Scalar>::get_x_space() const
+{
+  return ( !is_null(model_) ? model_->get_x_space() : Teuchos::null );
+}
+
+
+template<class Scalar>
+void MultirateStepper<Scalar>::addPoints(
+    const Array<Scalar>& /* time_vec */
+    ,const Array<RCP<const Thyra::VectorBase<Scalar> > >& /* x_vec */
+    ,const Array<RCP<const Thyra::VectorBase<Scalar> > >& /* xdot_vec */
+    )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(true);
+}
+
+
+template<class Scalar>
+TimeRange<Scalar> MultirateStepper<Scalar>::getTimeRange() const
+{
+  if (!haveInitialCondition_)
+    return invalidTimeRange<Scalar>();
+  return timeRange_;
+}
+
+
+template<class Scalar>
+void MultirateStepper<Scalar>::getPoints(
+  const Array<Scalar>& time_vec
+  ,Array<RCP<const Thyra::VectorBase<Scalar> > >* x_vec
+  ,Array<RCP<const Thyra::VectorBase<Scalar> > >* xdot_vec
+  ,Array<ScalarMag>* accuracy_vec) const
+{
+  using Teuchos::constOptInArg;
+  using Teuchos::null;
+  TEUCHOS_ASSERT(haveInitialCondition_);
+  defaultGetPoints<Scalar>(
+    timeRange_.lower(), constOptInArg(*x_old_),
+    Ptr<const VectorBase<Scalar> >(null),
+    timeRange_.upper(), constOptInArg(*x_),
+    Ptr<const VectorBase<Scalar> >(null),
+    time_vec,
+    ptr(x_vec), ptr(xdot_vec), ptr(accuracy_vec),
+    Ptr<InterpolatorBase<Scalar> >(null)
+    );
+}
+
+
+template<class Scalar>
+void MultirateStepper<Scalar>::getNodes(Array<Scalar>* time_vec) const
+{
+  TEUCHOS_ASSERT( time_vec != NULL );
+  time_vec->clear();
+  if (!haveInitialCondition_) {
+    return;
+  }
+  time_vec->push_back(timeRange_.lower());
+  if (numSteps_ > 0) {
+    time_vec->push_back(timeRange_.upper());
+  }
+}
+
+
+template<class Scalar>
+void MultirateStepper<Scalar>::removeNodes(Array<Scalar>& /* time_vec */)
+{
+  TEUCHOS_TEST_FOR_EXCEPT(true);
+}
+
+
+template<class Scalar>
+int MultirateStepper<Scalar>::getOrder() const
+{
+  TEUCHOS_ASSERT( !is_null(rkButcherTableau_) );
+  return rkButcherTableau_->order();
+}
+
+
+// Overridden from Teuchos::ParameterListAcceptor
+
+
+template <class Scalar>
+void MultirateStepper<Scalar>::setParameterList(
+  RCP<ParameterList> const& paramList
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(paramList));
+  paramList->validateParametersAndSetDefaults(*this->getValidParameters());
+  paramList_ = paramList;
+  Teuchos::readVerboseObjectSublist(&*paramList_,this);
+  fastStepsPerSlowStep_ =
+    paramList_->get<int>(fastStepsPerSlowStep_name_);
+  TEUCHOS_TEST_FOR_EXCEPTION( fastStepsPerSlowStep_ < 1, std::logic_error,
+    "Error!  \"" << fastStepsPerSlowStep_name_ << "\" = "
+    << fastStepsPerSlowStep_ << " must be positive!"
+    );
+  fastStepType_ = ( Teuchos::getIntegralValue<int>(*paramList_,
+      fastStepType_name_) == 0 ? STEP_TYPE_FIXED : STEP_TYPE_VARIABLE );
+}
+
+
+template <class Scalar>
+RCP<ParameterList>
+MultirateStepper<Scalar>::getNonconstParameterList()
+{
+  return(paramList_);
+}
+
+
+template <class Scalar>
+RCP<ParameterList>
+MultirateStepper<Scalar>::unsetParameterList()
+{
+  RCP<ParameterList>
+    temp_param_list = paramList_;
+  paramList_ = Teuchos::null;
+  return(temp_param_list);
+}
+
+
+template<class Scalar>
+RCP<const ParameterList>
+MultirateStepper<Scalar>::getValidParameters() const
+{
+  static RCP<const ParameterList> validPL;
+  if (is_null(validPL)) {
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set<int>(fastStepsPerSlowStep_name_, fastStepsPerSlowStep_default_,
+      "Number of fast steps per slow step dt.  With fixed fast steps, the "
+      "fast interval [c_i*dt,c_{i+1}*dt] of each slow stage is divided into "
+      "ceil((c_{i+1}-c_i)*N) equal steps.  With variable fast steps, this "
+      "only sets the largest fast step size dt/N.");
+    Teuchos::setStringToIntegralParameter<int>(
+      fastStepType_name_,
+      fastStepType_default_,
+      "Take fixed or variable steps with the fast stepper.  Variable steps "
+      "are selected by the step control strategy of the fast stepper.",
+      Teuchos::tuple<std::string>("Fixed","Variable"),
+      Teuchos::tuple<int>(0,1),
+      pl.get());
+    Teuchos::setupVerboseObjectSublist(&*pl);
+    validPL = pl;
+  }
+  return validPL;
+}
+
+
+// Overridden from Teuchos::Describable
+
+
+template<class Scalar>
+void MultirateStepper<Scalar>::describe(
+  FancyOStream &out,
+  const Teuchos::EVerbosityLevel verbLevel
+  ) const
+{
+  using std::endl;
+  using Teuchos::as;
+  if (!isInitialized_) {
+    out << this->description() << " : This stepper is not initialized yet"
+        << std::endl;
+    return;
+  }
+  if (
+    as<int>(verbLevel) == as<int>(Teuchos::VERB_DEFAULT)
+    ||
+    as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW)
+    )
+  {
+    out << this->description() << ":" << endl;
+    Teuchos::OSTab tab(out);
+    out << "slow model = " << Teuchos::describe(*model_,verbLevel);
+    out << "fast model = " << Teuchos::describe(*fastModel_,verbLevel);
+    out << "slow RKBT = "
+        << Teuchos::describe(*rkButcherTableau_,verbLevel);
+    out << "fast stepper = " << Teuchos::describe(*fastStepper_,verbLevel);
+    out << "fast steps per slow step = " << fastStepsPerSlowStep_ << endl;
+    out << "fast step type = " << toString(fastStepType_) << endl;
+  }
+}
+
+
+// private
+
+
+template <class Scalar>
+void MultirateStepper<Scalar>::initialize_()
+{
+  typedef ScalarTraits<Scalar> ST;
+
+  if (isInitialized_) return;
+
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(model_));
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(fastModel_));
+  TEUCHOS_TEST_FOR_EXCEPT(!haveInitialCondition_);
+
+  THYRA_ASSERT_VEC_SPACES(
+    "Rythmos::MultirateStepper::initialize_(...)",
+    *fastModel_->get_x_space(), *model_->get_x_space() );
+
+  // Initialize Parameter List if none provided.
+  if (paramList_ == Teuchos::null) {
+    RCP<Teuchos::ParameterList> emptyParameterList =
+      Teuchos::rcp(new Teuchos::ParameterList);
+    this->setParameterList(emptyParameterList);
+  }
+
+  if (is_null(rkButcherTableau_)) {
+    this->setRKButcherTableau(
+      Teuchos::rcp(new Explicit3Stage3rdOrderKnothWolke_RKBT<Scalar>()) );
+  }
+
+  RCP<const Thyra::VectorSpaceBase<Scalar> > x_space = model_->get_x_space();
+
+#ifdef HAVE_RYTHMOS_DEBUG
+  THYRA_ASSERT_VEC_SPACES(
+    "Rythmos::MultirateStepper::initialize_(...)",
+    *x_->space(), *x_space );
+#endif // HAVE_RYTHMOS_DEBUG
+
+  // Set up the forced fast model and give it to the fast stepper.
+  if (is_null(forcing_)) {
+    forcing_ = createMember(x_space);
+    V_S(forcing_.ptr(),ST::zero());
+  }
+  if (is_null(forcingModel_)) {
+    forcingModel_ = multirateForcingModelEvaluator<Scalar>(fastModel_,forcing_);
+  }
+  else {
+    forcingModel_->initializeMultirateForcingModel(fastModel_,forcing_);
+  }
+  if (is_null(fastStepper_)) {
+    RCP<ExplicitRKStepper<Scalar> > erkStepper = explicitRKStepper<Scalar>();
+    erkStepper->setRKButcherTableau(
+      Teuchos::rcp(new Explicit4Stage4thOrder_RKBT<Scalar>()) );
+    fastStepper_ = erkStepper;
+  }
+  if (fastStepper_->getModel().get() != forcingModel_.get()) {
+    fastStepper_->setModel(forcingModel_);
+  }
+
+  // Set up the slow stage storage ...
+  const int numStages = rkButcherTableau_->numStages();
+  kS_.clear();
+  for (int i=0 ; i<numStages ; ++i) {
+    kS_.push_back(createMember(x_space));
+  }
+
+  isInitialized_ = true;
+}
+
+
+template <class Scalar>
+bool MultirateStepper<Scalar>::computeStep_(Scalar t, Scalar dt)
+{
+  typedef ScalarTraits<Scalar> ST;
+
+  const Teuchos::SerialDenseMatrix<int,Scalar> A = rkButcherTableau_->A();
+  const Teuchos::SerialDenseVector<int,Scalar> b = rkButcherTableau_->b();
+  const Teuchos::SerialDenseVector<int,Scalar> c = rkButcherTableau_->c();
+  const int numStages = rkButcherTableau_->numStages();
+
+  // x_ holds the current stage value X_i, starting from X_0 = x_old_.
+  V_V( x_.ptr(), *x_old_ );
+
+  for (int i=0 ; i<numStages ; ++i) {
+
+    // kS_i = f_S(X_i, t+c_i*dt)
+    eval_model_explicit<Scalar>(
+      *model_, basePoint_, *x_, t+c(i)*dt, kS_[i].ptr() );
+    ++numSlowEvaluations_;
+
+    // forcing = sum_{j<=i} ( A(i+1,j) - A(i,j) ) * kS_j
+    const bool lastStage = ( i+1 == numStages );
+    const Scalar c_next = ( lastStage ? ST::one() : c(i+1) );
+    V_S( forcing_.ptr(), ST::zero() );
+    for (int j=0 ; j<=i ; ++j) {
+      const Scalar a_next = ( lastStage ? b(j) : A(i+1,j) );
+      const Scalar coeff = a_next - A(i,j);
+      if (coeff != ST::zero())
+        Thyra::Vp_StV( forcing_.ptr(), coeff, *kS_[j] );
+    }
+
+    const Scalar dc = c_next - c(i);
+    if (dc == ST::zero()) {
+      // Degenerate fast interval: this is just the slow RK update.
+      Thyra::Vp_StV( x_.ptr(), dt, *forcing_ );
+      continue;
+    }
+
+    // X_{i+1} = v(t+c_{i+1}*dt) where
+    //   v_dot = f_F(v,tau) + forcing/dc,  v(t+c_i*dt) = X_i
+    Thyra::Vt_S( forcing_.ptr(), Scalar(ST::one()/dc) );
+    if (!integrateFast_(t+c(i)*dt, t+c_next*dt, dc, dt)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+template <class Scalar>
+bool MultirateStepper<Scalar>::integrateFast_(
+  Scalar t0, Scalar t1, Scalar dc, Scalar slowDt
+  )
+{
+  using Teuchos::as;
+  typedef ScalarTraits<Scalar> ST;
+  typedef Thyra::ModelEvaluatorBase MEB;
+
+  RCP<FancyOStream> out = this->getOStream();
+  Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+  Teuchos::OSTab ostab(out,1,"Multirate::integrateFast_");
+
+  MEB::InArgs<Scalar> fastIC = forcingModel_->getNominalValues();
+  fastIC.set_x(x_);
+  if (fastIC.supports(MEB::IN_ARG_t)) {
+    fastIC.set_t(t0);
+  }
+  fastStepper_->setInitialCondition(fastIC);
+
+  const Scalar maxFastDt = slowDt/as<Scalar>(fastStepsPerSlowStep_);
+
+  if (fastStepType_ == STEP_TYPE_FIXED) {
+    // Equal fast steps that end exactly at t1.  The count only depends on
+    // the tableau, so that it is not changed by roundoff in t0 and t1.
+    const Scalar numFastStepsExact = dc*as<Scalar>(fastStepsPerSlowStep_);
+    const int numFastSteps = std::max(1, as<int>( std::ceil(
+          ST::magnitude(numFastStepsExact)*(ST::one() - 100*ST::eps()) ) ));
+    const Scalar fastDt = (t1-t0)/as<Scalar>(numFastSteps);
+    for (int k=0 ; k<numFastSteps ; ++k) {
+      const Scalar dt_taken = fastStepper_->takeStep(fastDt,STEP_TYPE_FIXED);
+      ++numFastSteps_;
+      if (dt_taken <= ST::zero()) {
+        if ( as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW) )
+          *out << "\nThe fast stepper failed at step " << k
+               << " of [" << t0 << "," << t1 << "]!\n";
+        return false;
+      }
+    }
+  }
+  else {
+    const Scalar tol = 100*ST::eps()*std::max(ST::magnitude(t1),ST::one());
+    Scalar t = t0;
+    while (t1 - t > tol) {
+      const Scalar dt_taken = fastStepper_->takeStep(
+        std::min(maxFastDt, Scalar(t1-t)), STEP_TYPE_VARIABLE );
+      ++numFastSteps_;
+      if (dt_taken <= ST::zero()) {
+        if ( as<int>(verbLevel) >= as<int>(Teuchos::VERB_LOW) )
+          *out << "\nThe fast stepper failed at t = " << t
+               << " in [" << t0 << "," << t1 << "]!\n";
+        return false;
+      }
+      t += dt_taken;
+    }
+  }
+
+  V_V( x_.ptr(), *fastStepper_->getStepStatus().solution );
+
+  if ( as<int>(verbLevel) >= as<int>(Teuchos::VERB_HIGH) ) {
+    *out << "\nfast interval [" << t0 << "," << t1 << "] done, "
+         << "total fast steps = " << numFastSteps_ << "\n";
+  }
+
+  return true;
+}
+
+
+//
+// Explicit Instantiation macro
+//
+// Must be expanded from within the Rythmos namespace!
+//
+
+#define RYTHMOS_MULTIRATE_STEPPER_INSTANT(SCALAR) \
+  \
+  template class MultirateStepper< SCALAR >; \
+  \
+  template RCP< MultirateStepper< SCALAR > > \
+  multirateStepper(); \
+  \
+  template RCP< MultirateStepper< SCALAR > > \
+  multirateStepper( \
+    const RCP<const Thyra::ModelEvaluator< SCALAR > >& slowModel, \
+    const RCP<const Thyra::ModelEvaluator< SCALAR > >& fastModel \
+    );
+
+
+} // namespace Rythmos
+
+#endif // Rythmos_MULTIRATE_STEPPER_DEF_H
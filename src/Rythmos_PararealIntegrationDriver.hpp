@@ -0,0 +1,5 @@
+#include "Rythmos_PararealIntegrationDriver_decl.hpp"
+#ifndef HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
+#include "Rythmos_PararealIntegrationDriver_def.hpp"
+#endif
+
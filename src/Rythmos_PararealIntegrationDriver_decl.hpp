@@ -0,0 +1,319 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_PARAREAL_INTEGRATION_DRIVER_DECL_H
+#define Rythmos_PARAREAL_INTEGRATION_DRIVER_DECL_H
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_IntegratorBase.hpp"
+#include "Rythmos_StepperBase.hpp"
+#include "Rythmos_ThreadPool.hpp"
+#include "Thyra_ModelEvaluator.hpp"
+#include "Thyra_NonlinearSolverBase.hpp"
+#include "Thyra_VectorBase.hpp"
+#include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
+#include "Teuchos_Describable.hpp"
+
+#ifdef HAVE_RYTHMOS_THREADS
+#  include <mutex>
+#endif
+
+
+namespace Rythmos {
+
+
+/** \brief Integrates one run of a model with the parareal algorithm, solving
+ * the time slices of the integration range in parallel threads.
+ *
+ * The integration range <tt>[t0,tf]</tt> is split into <tt>N</tt> equal
+ * time slices <tt>[T(n),T(n+1)]</tt>.  A cheap coarse propagator <tt>G</tt>
+ * gives a first guess at the slice boundary values <tt>U(n)</tt> in one
+ * serial sweep.  Each iteration <tt>k</tt> then runs the accurate fine
+ * propagator <tt>F</tt> on every slice that has not converged yet, all in
+ * parallel, and corrects the boundary values in another serial coarse sweep
+ *
+ \verbatim
+
+   U(n+1) = G(U(n)) + F(U_old(n)) - G(U_old(n))
+
+ \endverbatim
+ *
+ * where <tt>U_old</tt> are the boundary values from the previous iteration.
+ * After iteration <tt>k</tt> the first <tt>k+1</tt> slices are exactly the
+ * fine solution, so <tt>N</tt> iterations always reproduce a serial fine run
+ * slice by slice.  The iterations stop early once the largest change
+ * <tt>||U(n) - U_old(n)||_inf</tt> over the boundary values is no more than
+ * "Convergence Tolerance" times <tt>1 + ||U(n)||_inf</tt>.
+ *
+ * The fine propagator is an integrator built from an
+ * <tt>IntegratorBuilder</tt> parameter list, whose final time is
+ * <tt>tf</tt>.  Each thread gets its own copy of the integrator and stepper
+ * from <tt>cloneIntegrator()</tt> and <tt>cloneStepperAlgorithm()</tt>,
+ * made once on the calling thread and kept between calls to
+ * <tt>integrate()</tt>.  A slice is run by resetting the initial condition
+ * of the thread's stepper.  The slices are handed out to the threads one at
+ * a time.
+ *
+ * The coarse propagator takes "Coarse Steps Per Slice" equal fixed steps
+ * per slice on the calling thread.  By default it is a
+ * <tt>BackwardEulerStepper</tt>, whose default step control is a
+ * <tt>FixedStepControlStrategy</tt>, which requires an implicit model
+ * (<tt>x_dot</tt> in the in args).  Any other stepper that supports fixed
+ * steps may be passed in instead, e.g. a forward Euler
+ * <tt>ExplicitRKStepper</tt> for explicit models.  When the model takes
+ * <tt>x_dot</tt> the correction above is also applied to <tt>x_dot</tt>, so
+ * that steppers such as <tt>ImplicitBDFStepper</tt> that need a consistent
+ * <tt>x_dot</tt> can be restarted at the slice boundaries.
+ *
+ * The fine slices are integrated by the threads of a <tt>ThreadPool</tt>
+ * that is kept between iterations, so with the Teuchos time monitor only
+ * the slices integrated on the calling thread are timed.  Without thread
+ * support (<tt>HAVE_RYTHMOS_THREADS</tt>) the fine slices are integrated
+ * one after the other on the calling thread.
+ *
+ * Thread safety requirements are those of
+ * <tt>EnsembleIntegrationDriver</tt>: the model is shared by all threads, so
+ * its <tt>evalModel()</tt> must be safe to call concurrently on different
+ * arguments.  Models that keep mutable evaluation state, such as most
+ * Epetra application models, can instead give each thread its own instance
+ * with <tt>setThreadModels()</tt>.
+ */
+template<class Scalar>
+class PararealIntegrationDriver
+  : virtual public Teuchos::Describable,
+    virtual public Teuchos::ParameterListAcceptorDefaultBase
+{
+public:
+
+  /** \brief . */
+  typedef typename Teuchos::ScalarTraits<Scalar>::magnitudeType ScalarMag;
+
+  /** \name Constructors/Initializers/Accessors */
+  //@{
+
+  /** \brief . */
+  PararealIntegrationDriver();
+
+  /** \brief Build the fine and coarse propagators.
+   *
+   * \param model [in] The model.
+   *
+   * \param initialCondition [in] Initial condition at <tt>t0</tt>.
+   *
+   * \param nlSolver [in] Nonlinear solver for implicit fine steppers,
+   * cloned for each thread.  May be null for explicit steppers.
+   *
+   * \param integratorBuilderPL [in] Parameter list for
+   * <tt>IntegratorBuilder</tt> that describes the fine propagator.
+   *
+   * \param coarseStepper [in] The coarse propagator.  If null, a
+   * <tt>BackwardEulerStepper</tt> is created with a clone of
+   * <tt>nlSolver</tt>, or a <tt>TimeStepNonlinearSolver</tt> if
+   * <tt>nlSolver</tt> is null or can not be cloned.
+   */
+  void initialize(
+    const RCP<const Thyra::ModelEvaluator<Scalar> > &model,
+    const Thyra::ModelEvaluatorBase::InArgs<Scalar> &initialCondition,
+    const RCP<Thyra::NonlinearSolverBase<Scalar> > &nlSolver,
+    const RCP<ParameterList> &integratorBuilderPL,
+    const RCP<StepperBase<Scalar> > &coarseStepper = Teuchos::null
+    );
+
+  /** \brief Give the fine stepper of thread <tt>i</tt> its own model
+   * <tt>threadModels[i % threadModels.size()]</tt>.
+   *
+   * The models must describe the same problem as the model passed to
+   * <tt>initialize()</tt>, which is still used by the coarse propagator.
+   * The fine stepper must allow <tt>setModel()</tt> after cloning, which is
+   * true of <tt>BackwardEulerStepper</tt> and <tt>ImplicitBDFStepper</tt>.
+   * Passing an empty array shares the model again.
+   */
+  void setThreadModels(
+    const Array<RCP<const Thyra::ModelEvaluator<Scalar> > > &threadModels
+    );
+
+  /** \brief . */
+  RCP<const IntegratorBase<Scalar> > getPrototypeIntegrator() const;
+
+  /** \brief . */
+  RCP<const StepperBase<Scalar> > getCoarseStepper() const;
+
+  /** \brief Integrate from <tt>t0</tt> to <tt>tf</tt> and return the
+   * solution at <tt>tf</tt>.
+   *
+   * An exception thrown by any fine slice is rethrown here once all threads
+   * have stopped.
+   */
+  RCP<const Thyra::VectorBase<Scalar> > integrate();
+
+  /** \brief The slice boundary times <tt>T(0),...,T(N)</tt>. */
+  const Array<Scalar>& getSliceTimes() const;
+
+  /** \brief The solution <tt>U(n)</tt> at <tt>T(n)</tt> after the last
+   * iteration of the last <tt>integrate()</tt>. */
+  RCP<const Thyra::VectorBase<Scalar> > getSliceSolution(const int n) const;
+
+  /** \brief Number of parareal iterations of the last
+   * <tt>integrate()</tt>. */
+  int getNumIterations() const;
+
+  /** \brief Largest relative change of the slice boundary values in each
+   * iteration of the last <tt>integrate()</tt>. */
+  const Array<ScalarMag>& getCorrectionHistory() const;
+
+  /** \brief Number of threads used by the last <tt>integrate()</tt>. */
+  int getNumThreads() const;
+
+  /** \brief Wall time in seconds of the last <tt>integrate()</tt>. */
+  double getWallTime() const;
+
+  /** \brief Wall time in seconds spent in the parallel fine solves of the
+   * last <tt>integrate()</tt>. */
+  double getFineWallTime() const;
+
+  /** \brief Wall time in seconds spent in the serial coarse sweeps of the
+   * last <tt>integrate()</tt>. */
+  double getCoarseWallTime() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::ParameterListAcceptor */
+  //@{
+
+  /** \brief . */
+  void setParameterList(RCP<ParameterList> const& paramList);
+
+  /** \brief . */
+  RCP<const ParameterList> getValidParameters() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::Describable */
+  //@{
+
+  /** \brief . */
+  std::string description() const;
+
+  //@}
+
+private:
+
+  // Integrator and stepper owned by one thread.
+  struct ThreadWorkspace {
+    RCP<IntegratorBase<Scalar> > integrator;
+    RCP<StepperBase<Scalar> > stepper;
+    Thyra::ModelEvaluatorBase::InArgs<Scalar> initialCondition;
+  };
+
+  RCP<const Thyra::ModelEvaluator<Scalar> > model_;
+  Thyra::ModelEvaluatorBase::InArgs<Scalar> initialCondition_;
+  RCP<IntegratorBase<Scalar> > prototype_;
+  RCP<StepperBase<Scalar> > coarseStepper_;
+  Array<RCP<const Thyra::ModelEvaluator<Scalar> > > threadModels_;
+  bool haveXDot_;
+
+  int numSlices_;
+  int numCoarseSteps_;
+  int maxIterations_;
+  ScalarMag tolerance_;
+  int numThreadsRequested_;
+
+  Array<RCP<ThreadWorkspace> > workspaces_;
+  Thyra::ModelEvaluatorBase::InArgs<Scalar> coarseInitialCondition_;
+
+  // Slice boundary values U(n) and the fine and coarse results F(U(n)) and
+  // G(U(n)) of slice n, with the matching x_dot when the model has it.
+  Array<Scalar> sliceTimes_;
+  Array<RCP<Thyra::VectorBase<Scalar> > > U_, U_dot_;
+  Array<RCP<Thyra::VectorBase<Scalar> > > F_, F_dot_;
+  Array<RCP<Thyra::VectorBase<Scalar> > > G_, G_dot_;
+  RCP<Thyra::VectorBase<Scalar> > G_new_, G_dot_new_;
+  RCP<Thyra::VectorBase<Scalar> > U_new_, U_dot_new_;
+
+  int numIterations_;
+  Array<ScalarMag> correctionHistory_;
+  int numThreads_;
+  double wallTime_;
+  double fineWallTime_;
+  double coarseWallTime_;
+
+  int nextSlice_;
+#ifdef HAVE_RYTHMOS_THREADS
+  std::mutex sliceMutex_;
+  RCP<ThreadPool> threadPool_;
+#endif
+
+  static const std::string numSlices_name_;
+  static const int numSlices_default_;
+
+  static const std::string numCoarseSteps_name_;
+  static const int numCoarseSteps_default_;
+
+  static const std::string maxIterations_name_;
+  static const int maxIterations_default_;
+
+  static const std::string tolerance_name_;
+  static const double tolerance_default_;
+
+  static const std::string numThreads_name_;
+  static const int numThreads_default_;
+
+  void allocateWorkspace_(const int numThreads);
+
+  void propagateCoarse_(const int n);
+
+  void propagateFine_(const int firstSlice, const int numThreads);
+
+  void runThread_(const int threadIndex);
+
+  bool takeSlice_(int *n);
+
+  void integrateSlice_(ThreadWorkspace &workspace, const int n);
+
+};
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates PararealIntegrationDriver
+ */
+template<class Scalar>
+RCP<PararealIntegrationDriver<Scalar> >
+pararealIntegrationDriver(
+  const RCP<const Thyra::ModelEvaluator<Scalar> > &model,
+  const Thyra::ModelEvaluatorBase::InArgs<Scalar> &initialCondition,
+  const RCP<Thyra::NonlinearSolverBase<Scalar> > &nlSolver,
+  const RCP<ParameterList> &integratorBuilderPL,
+  const RCP<ParameterList> &paramList = Teuchos::null,
+  const RCP<StepperBase<Scalar> > &coarseStepper = Teuchos::null
+  );
+
+
+} // namespace Rythmos
+
+#endif //Rythmos_PARAREAL_INTEGRATION_DRIVER_DECL_H
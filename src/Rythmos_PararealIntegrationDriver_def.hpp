@@ -0,0 +1,741 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_PARAREAL_INTEGRATION_DRIVER_DEF_H
+#define Rythmos_PARAREAL_INTEGRATION_DRIVER_DEF_H
+
+#include "Rythmos_PararealIntegrationDriver_decl.hpp"
+#include "Rythmos_IntegratorBuilder.hpp"
+#include "Rythmos_BackwardEulerStepper.hpp"
+#include "Rythmos_TimeStepNonlinearSolver.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+
+#include "Teuchos_Time.hpp"
+
+#include <algorithm>
+
+#ifdef HAVE_RYTHMOS_THREADS
+#  include <thread>
+#endif
+
+
+namespace Rythmos {
+
+
+// Nonmember constructors
+
+
+template<class Scalar>
+RCP<PararealIntegrationDriver<Scalar> >
+pararealIntegrationDriver(
+  const RCP<const Thyra::ModelEvaluator<Scalar> > &model,
+  const Thyra::ModelEvaluatorBase::InArgs<Scalar> &initialCondition,
+  const RCP<Thyra::NonlinearSolverBase<Scalar> > &nlSolver,
+  const RCP<ParameterList> &integratorBuilderPL,
+  const RCP<ParameterList> &paramList,
+  const RCP<StepperBase<Scalar> > &coarseStepper
+  )
+{
+  RCP<PararealIntegrationDriver<Scalar> >
+    driver = Teuchos::rcp(new PararealIntegrationDriver<Scalar>());
+  if (!is_null(paramList))
+    driver->setParameterList(paramList);
+  driver->initialize(model,initialCondition,nlSolver,integratorBuilderPL,
+    coarseStepper);
+  return driver;
+}
+
+
+//
+// Definitions
+//
+
+
+// Static members
+
+
+template<class Scalar>
+const std::string
+PararealIntegrationDriver<Scalar>::numSlices_name_
+= "Number of Time Slices";
+
+template<class Scalar>
+const int
+PararealIntegrationDriver<Scalar>::numSlices_default_
+= 8;
+
+template<class Scalar>
+const std::string
+PararealIntegrationDriver<Scalar>::numCoarseSteps_name_
+= "Coarse Steps Per Slice";
+
+template<class Scalar>
+const int
+PararealIntegrationDriver<Scalar>::numCoarseSteps_default_
+= 1;
+
+template<class Scalar>
+const std::string
+PararealIntegrationDriver<Scalar>::maxIterations_name_
+= "Max Iterations";
+
+template<class Scalar>
+const int
+PararealIntegrationDriver<Scalar>::maxIterations_default_
+= 0;
+
+template<class Scalar>
+const std::string
+PararealIntegrationDriver<Scalar>::tolerance_name_
+= "Convergence Tolerance";
+
+template<class Scalar>
+const double
+PararealIntegrationDriver<Scalar>::tolerance_default_
+= 1.0e-8;
+
+template<class Scalar>
+const std::string
+PararealIntegrationDriver<Scalar>::numThreads_name_
+= "Number of Threads";
+
+template<class Scalar>
+const int
+PararealIntegrationDriver<Scalar>::numThreads_default_
+= 0;
+
+
+// Constructors/Initializers/Accessors
+
+
+template<class Scalar>
+PararealIntegrationDriver<Scalar>::PararealIntegrationDriver()
+  :haveXDot_(false),
+   numSlices_(numSlices_default_),
+   numCoarseSteps_(numCoarseSteps_default_),
+   maxIterations_(maxIterations_default_),
+   tolerance_(tolerance_default_),
+   numThreadsRequested_(numThreads_default_),
+   numIterations_(0),
+   numThreads_(0),
+   wallTime_(0.0),
+   fineWallTime_(0.0),
+   coarseWallTime_(0.0),
+   nextSlice_(0)
+{}
+
+
+template<class Scalar>
+void PararealIntegrationDriver<Scalar>::initialize(
+  const RCP<const Thyra::ModelEvaluator<Scalar> > &model,
+  const Thyra::ModelEvaluatorBase::InArgs<Scalar> &initialCondition,
+  const RCP<Thyra::NonlinearSolverBase<Scalar> > &nlSolver,
+  const RCP<ParameterList> &integratorBuilderPL,
+  const RCP<StepperBase<Scalar> > &coarseStepper
+  )
+{
+  typedef Thyra::ModelEvaluatorBase MEB;
+
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(model));
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(integratorBuilderPL));
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(initialCondition.get_x()), std::logic_error,
+    "Error, PararealIntegrationDriver::initialize(...):  The initial"
+    " condition must have x!"
+    );
+
+  RCP<IntegratorBuilder<Scalar> > builder = integratorBuilder<Scalar>();
+  builder->setParameterList(integratorBuilderPL);
+  const RCP<IntegratorBase<Scalar> >
+    prototype = builder->create(model,initialCondition,nlSolver);
+
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(prototype->getStepper()), std::logic_error,
+    "Error, PararealIntegrationDriver::initialize(...):  The integrator"
+    " built from the parameter list has no stepper!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    !prototype->getStepper()->supportsCloning(), std::logic_error,
+    "Error, PararealIntegrationDriver::initialize(...):  The stepper "
+    << prototype->getStepper()->description()
+    << " does not support cloning!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    prototype->getFwdTimeRange().upper() <= initialCondition.get_t(),
+    std::logic_error,
+    "Error, PararealIntegrationDriver::initialize(...):  The final time "
+    << prototype->getFwdTimeRange().upper() << " must be after the initial"
+    " time " << initialCondition.get_t() << "!"
+    );
+
+  const bool haveXDot = model->createInArgs().supports(MEB::IN_ARG_x_dot);
+
+  RCP<StepperBase<Scalar> > coarse = coarseStepper;
+  if (is_null(coarse)) {
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      !haveXDot, std::logic_error,
+      "Error, PararealIntegrationDriver::initialize(...):  The default"
+      " backward Euler coarse stepper needs an implicit model, but the model "
+      << model->description() << " does not take x_dot!  Pass in a coarse"
+      " stepper for explicit models."
+      );
+    RCP<Thyra::NonlinearSolverBase<Scalar> > coarseSolver;
+    if (!is_null(nlSolver) && nlSolver->supportsCloning())
+      coarseSolver = nlSolver->cloneNonlinearSolver().assert_not_null();
+    else
+      coarseSolver = timeStepNonlinearSolver<Scalar>();
+    coarse = backwardEulerStepper<Scalar>(model,coarseSolver);
+  }
+  else if (is_null(coarse->getModel())) {
+    coarse->setModel(model);
+  }
+
+  model_ = model;
+  initialCondition_ = initialCondition;
+  prototype_ = prototype;
+  coarseStepper_ = coarse;
+  haveXDot_ = haveXDot;
+  coarseInitialCondition_ = model_->createInArgs();
+  coarseInitialCondition_.setArgs(initialCondition_);
+  workspaces_.clear();
+  U_.clear();
+}
+
+
+template<class Scalar>
+void PararealIntegrationDriver<Scalar>::setThreadModels(
+  const Array<RCP<const Thyra::ModelEvaluator<Scalar> > > &threadModels
+  )
+{
+  for (int i = 0; i < Teuchos::as<int>(threadModels.size()); ++i) {
+    TEUCHOS_TEST_FOR_EXCEPT(is_null(threadModels[i]));
+  }
+  threadModels_ = threadModels;
+  workspaces_.clear();
+}
+
+
+template<class Scalar>
+RCP<const IntegratorBase<Scalar> >
+PararealIntegrationDriver<Scalar>::getPrototypeIntegrator() const
+{
+  return prototype_;
+}
+
+
+template<class Scalar>
+RCP<const StepperBase<Scalar> >
+PararealIntegrationDriver<Scalar>::getCoarseStepper() const
+{
+  return coarseStepper_;
+}
+
+
+template<class Scalar>
+RCP<const Thyra::VectorBase<Scalar> >
+PararealIntegrationDriver<Scalar>::integrate()
+{
+
+  using Teuchos::as;
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  typedef Teuchos::ScalarTraits<ScalarMag> SMT;
+
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(prototype_), std::logic_error,
+    "Error, PararealIntegrationDriver::integrate(...):  initialize() must"
+    " be called first!"
+    );
+
+  const int N = numSlices_;
+  const int maxIterations =
+    ( maxIterations_ == 0 ? N : std::min(maxIterations_, N) );
+
+  // Never start more threads than there are slices.
+  int numThreads = 1;
+#ifdef HAVE_RYTHMOS_THREADS
+  numThreads = numThreadsRequested_;
+  if (numThreads == 0)
+    numThreads = std::max(as<int>(std::thread::hardware_concurrency()), 1);
+#endif
+  numThreads = std::max(std::min(numThreads, N), 1);
+  allocateWorkspace_(numThreads);
+
+  const Scalar t0 = initialCondition_.get_t();
+  const Scalar tf = prototype_->getFwdTimeRange().upper();
+  sliceTimes_.resize(N+1);
+  for (int n = 0; n < N; ++n) {
+    sliceTimes_[n] = t0 + (tf - t0)*(Scalar(n)/Scalar(N));
+  }
+  sliceTimes_[N] = tf;
+
+  if (as<int>(U_.size()) != N+1) {
+    const RCP<const Thyra::VectorSpaceBase<Scalar> >
+      space = model_->get_x_space();
+    U_.resize(N+1);
+    F_.resize(N);
+    G_.resize(N);
+    for (int n = 0; n <= N; ++n) {
+      U_[n] = createMember(space);
+      if (n < N) {
+        F_[n] = createMember(space);
+        G_[n] = createMember(space);
+      }
+    }
+    G_new_ = createMember(space);
+    U_new_ = createMember(space);
+    if (haveXDot_) {
+      U_dot_.resize(N+1);
+      F_dot_.resize(N);
+      G_dot_.resize(N);
+      for (int n = 0; n <= N; ++n) {
+        U_dot_[n] = createMember(space);
+        if (n < N) {
+          F_dot_[n] = createMember(space);
+          G_dot_[n] = createMember(space);
+        }
+      }
+      G_dot_new_ = createMember(space);
+      U_dot_new_ = createMember(space);
+    }
+  }
+
+  Thyra::V_V(U_[0].ptr(),*initialCondition_.get_x());
+  if (haveXDot_) {
+    if (!is_null(initialCondition_.get_x_dot()))
+      Thyra::V_V(U_dot_[0].ptr(),*initialCondition_.get_x_dot());
+    else
+      Thyra::V_S(U_dot_[0].ptr(),ST::zero());
+  }
+
+  numThreads_ = numThreads;
+  numIterations_ = 0;
+  correctionHistory_.clear();
+  fineWallTime_ = 0.0;
+  coarseWallTime_ = 0.0;
+
+  const double startTime = Teuchos::Time::wallTime();
+
+  // Coarse predictor: U(n+1) = G(U(n)).
+  double phaseStart = Teuchos::Time::wallTime();
+  for (int n = 0; n < N; ++n) {
+    propagateCoarse_(n);
+    Thyra::V_V(G_[n].ptr(),*G_new_);
+    Thyra::V_V(U_[n+1].ptr(),*G_new_);
+    if (haveXDot_) {
+      Thyra::V_V(G_dot_[n].ptr(),*G_dot_new_);
+      Thyra::V_V(U_dot_[n+1].ptr(),*G_dot_new_);
+    }
+  }
+  coarseWallTime_ += Teuchos::Time::wallTime() - phaseStart;
+
+  for (int k = 0; k < maxIterations; ++k) {
+
+    // Slices before k have converged, so only slices k,...,N-1 are run.
+    phaseStart = Teuchos::Time::wallTime();
+    propagateFine_(k,numThreads);
+    fineWallTime_ += Teuchos::Time::wallTime() - phaseStart;
+
+    phaseStart = Teuchos::Time::wallTime();
+    ScalarMag maxCorrection = SMT::zero();
+    for (int n = k; n < N; ++n) {
+      if (n == k) {
+        // U(k) is exact, so is F(U(k)).
+        Thyra::V_V(U_new_.ptr(),*F_[n]);
+        if (haveXDot_)
+          Thyra::V_V(U_dot_new_.ptr(),*F_dot_[n]);
+      }
+      else {
+        propagateCoarse_(n);
+        Thyra::V_VmV(U_new_.ptr(),*F_[n],*G_[n]);
+        Thyra::Vp_V(U_new_.ptr(),*G_new_);
+        Thyra::V_V(G_[n].ptr(),*G_new_);
+        if (haveXDot_) {
+          Thyra::V_VmV(U_dot_new_.ptr(),*F_dot_[n],*G_dot_[n]);
+          Thyra::Vp_V(U_dot_new_.ptr(),*G_dot_new_);
+          Thyra::V_V(G_dot_[n].ptr(),*G_dot_new_);
+        }
+      }
+      Thyra::Vp_StV(U_[n+1].ptr(),-ST::one(),*U_new_);
+      const ScalarMag correction = Thyra::norm_inf(*U_[n+1])
+        / (SMT::one() + Thyra::norm_inf(*U_new_));
+      maxCorrection = std::max(maxCorrection, correction);
+      Thyra::V_V(U_[n+1].ptr(),*U_new_);
+      if (haveXDot_)
+        Thyra::V_V(U_dot_[n+1].ptr(),*U_dot_new_);
+    }
+    coarseWallTime_ += Teuchos::Time::wallTime() - phaseStart;
+
+    ++numIterations_;
+    correctionHistory_.push_back(maxCorrection);
+    if (maxCorrection <= tolerance_)
+      break;
+
+  }
+
+  wallTime_ = Teuchos::Time::wallTime() - startTime;
+
+  return U_[N];
+
+}
+
+
+template<class Scalar>
+const Array<Scalar>&
+PararealIntegrationDriver<Scalar>::getSliceTimes() const
+{
+  return sliceTimes_;
+}
+
+
+template<class Scalar>
+RCP<const Thyra::VectorBase<Scalar> >
+PararealIntegrationDriver<Scalar>::getSliceSolution(const int n) const
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    n < 0 || n >= Teuchos::as<int>(U_.size()), std::out_of_range,
+    "Error, PararealIntegrationDriver::getSliceSolution(" << n << "):  There"
+    " are " << U_.size() << " slice boundary values!"
+    );
+  return U_[n];
+}
+
+
+template<class Scalar>
+int PararealIntegrationDriver<Scalar>::getNumIterations() const
+{
+  return numIterations_;
+}
+
+
+template<class Scalar>
+const Array<typename PararealIntegrationDriver<Scalar>::ScalarMag>&
+PararealIntegrationDriver<Scalar>::getCorrectionHistory() const
+{
+  return correctionHistory_;
+}
+
+
+template<class Scalar>
+int PararealIntegrationDriver<Scalar>::getNumThreads() const
+{
+  return numThreads_;
+}
+
+
+template<class Scalar>
+double PararealIntegrationDriver<Scalar>::getWallTime() const
+{
+  return wallTime_;
+}
+
+
+template<class Scalar>
+double PararealIntegrationDriver<Scalar>::getFineWallTime() const
+{
+  return fineWallTime_;
+}
+
+
+template<class Scalar>
+double PararealIntegrationDriver<Scalar>::getCoarseWallTime() const
+{
+  return coarseWallTime_;
+}
+
+
+// Overridden from ParameterListAcceptor
+
+
+template<class Scalar>
+void PararealIntegrationDriver<Scalar>::setParameterList(
+  RCP<ParameterList> const& paramList
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(paramList));
+  paramList->validateParametersAndSetDefaults(*getValidParameters());
+  const int numSlices = paramList->get<int>(numSlices_name_);
+  const int numCoarseSteps = paramList->get<int>(numCoarseSteps_name_);
+  const int maxIterations = paramList->get<int>(maxIterations_name_);
+  const double tolerance = paramList->get<double>(tolerance_name_);
+  const int numThreads = paramList->get<int>(numThreads_name_);
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    numSlices < 1, std::logic_error,
+    "Error, PararealIntegrationDriver::setParameterList(...):  \""
+    << numSlices_name_ << "\" = " << numSlices << " must be >= 1!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    numCoarseSteps < 1, std::logic_error,
+    "Error, PararealIntegrationDriver::setParameterList(...):  \""
+    << numCoarseSteps_name_ << "\" = " << numCoarseSteps << " must be >= 1!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    maxIterations < 0, std::logic_error,
+    "Error, PararealIntegrationDriver::setParameterList(...):  \""
+    << maxIterations_name_ << "\" = " << maxIterations << " must be >= 0!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    tolerance < 0.0, std::logic_error,
+    "Error, PararealIntegrationDriver::setParameterList(...):  \""
+    << tolerance_name_ << "\" = " << tolerance << " must be >= 0!"
+    );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    numThreads < 0, std::logic_error,
+    "Error, PararealIntegrationDriver::setParameterList(...):  \""
+    << numThreads_name_ << "\" = " << numThreads << " must be >= 0!"
+    );
+  if (numSlices != numSlices_)
+    U_.clear();
+  numSlices_ = numSlices;
+  numCoarseSteps_ = numCoarseSteps;
+  maxIterations_ = maxIterations;
+  tolerance_ = ScalarMag(tolerance);
+  numThreadsRequested_ = numThreads;
+  this->setMyParamList(paramList);
+}
+
+
+template<class Scalar>
+RCP<const ParameterList>
+PararealIntegrationDriver<Scalar>::getValidParameters() const
+{
+  static RCP<const ParameterList> validPL;
+  if (is_null(validPL)) {
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set(
+      numSlices_name_, numSlices_default_,
+      "Number of equal time slices the integration range is split into."
+      );
+    pl->set(
+      numCoarseSteps_name_, numCoarseSteps_default_,
+      "Number of equal fixed steps the coarse stepper takes per slice."
+      );
+    pl->set(
+      maxIterations_name_, maxIterations_default_,
+      "Maximum number of parareal iterations.  Zero allows one iteration\n"
+      "per slice, after which the result is the serial fine solution."
+      );
+    pl->set(
+      tolerance_name_, tolerance_default_,
+      "The iterations stop once no slice boundary value changes by more\n"
+      "than this times 1 + its max norm."
+      );
+    pl->set(
+      numThreads_name_, numThreads_default_,
+      "Number of threads that integrate the fine slices.  Zero uses one\n"
+      "thread per hardware thread.  This is ignored unless Rythmos was built\n"
+      "with thread support."
+      );
+    validPL = pl;
+  }
+  return validPL;
+}
+
+
+// Overridden from Teuchos::Describable
+
+
+template<class Scalar>
+std::string PararealIntegrationDriver<Scalar>::description() const
+{
+  return "Rythmos::PararealIntegrationDriver";
+}
+
+
+// private
+
+
+template<class Scalar>
+void PararealIntegrationDriver<Scalar>::allocateWorkspace_(
+  const int numThreads
+  )
+{
+  // The clones are made here on the calling thread since cloning reads the
+  // prototype, which is shared by all threads.
+  for (int i = Teuchos::as<int>(workspaces_.size()); i < numThreads; ++i) {
+    RCP<ThreadWorkspace> workspace = Teuchos::rcp(new ThreadWorkspace);
+    workspace->integrator = prototype_->cloneIntegrator();
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      is_null(workspace->integrator), std::logic_error,
+      "Error, PararealIntegrationDriver::integrate(...):  The integrator "
+      << prototype_->description() << " does not support cloning!"
+      );
+    workspace->stepper =
+      prototype_->getStepper()->cloneStepperAlgorithm().assert_not_null();
+    if (threadModels_.size() > 0) {
+      workspace->stepper->setModel(threadModels_[i % threadModels_.size()]);
+    }
+    workspace->initialCondition = model_->createInArgs();
+    workspace->initialCondition.setArgs(initialCondition_);
+    workspaces_.push_back(workspace);
+  }
+#ifdef HAVE_RYTHMOS_THREADS
+  if (is_null(threadPool_) || threadPool_->getNumThreads() != numThreads)
+    threadPool_ = Teuchos::rcp(new ThreadPool(numThreads));
+#endif
+}
+
+
+template<class Scalar>
+void PararealIntegrationDriver<Scalar>::propagateCoarse_(const int n)
+{
+  const Scalar t_begin = sliceTimes_[n];
+  const Scalar t_end = sliceTimes_[n+1];
+
+  coarseInitialCondition_.set_t(t_begin);
+  coarseInitialCondition_.set_x(U_[n]);
+  if (haveXDot_)
+    coarseInitialCondition_.set_x_dot(U_dot_[n]);
+  coarseStepper_->setInitialCondition(coarseInitialCondition_);
+
+  // The last step lands exactly on the end of the slice.
+  const Scalar dt = (t_end - t_begin)/Scalar(numCoarseSteps_);
+  for (int j = 0; j < numCoarseSteps_; ++j) {
+    const Scalar step = ( j == numCoarseSteps_-1
+      ? t_end - coarseStepper_->getTimeRange().upper() : dt );
+    const Scalar stepTaken = coarseStepper_->takeStep(step,STEP_TYPE_FIXED);
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      stepTaken != step, std::runtime_error,
+      "Error, PararealIntegrationDriver::integrate(...):  The coarse stepper "
+      << coarseStepper_->description() << " took a step of " << stepTaken
+      << " when asked to take a step of " << step << " in slice " << n << "!"
+      );
+  }
+
+  Array<Scalar> time_vec(1,t_end);
+  Array<RCP<const Thyra::VectorBase<Scalar> > > x_vec, x_dot_vec;
+  coarseStepper_->getPoints(time_vec,&x_vec,(haveXDot_ ? &x_dot_vec : NULL),
+    NULL);
+  Thyra::V_V(G_new_.ptr(),*x_vec[0]);
+  if (haveXDot_) {
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      is_null(x_dot_vec[0]), std::logic_error,
+      "Error, PararealIntegrationDriver::integrate(...):  The coarse stepper "
+      << coarseStepper_->description() << " does not give x_dot!"
+      );
+    Thyra::V_V(G_dot_new_.ptr(),*x_dot_vec[0]);
+  }
+}
+
+
+template<class Scalar>
+void PararealIntegrationDriver<Scalar>::propagateFine_(
+  const int firstSlice, const int numThreads
+  )
+{
+  nextSlice_ = firstSlice;
+#ifdef HAVE_RYTHMOS_THREADS
+  // Threads that find no slice left return right away.
+  TEUCHOS_ASSERT_EQUALITY( threadPool_->getNumThreads(), numThreads );
+  threadPool_->run( [this](int i) { runThread_(i); } );
+#else
+  (void)numThreads;
+  runThread_(0);
+#endif
+}
+
+
+template<class Scalar>
+void PararealIntegrationDriver<Scalar>::runThread_(const int threadIndex)
+{
+  ThreadWorkspace &workspace = *workspaces_[threadIndex];
+  int n = -1;
+  while (takeSlice_(&n)) {
+    integrateSlice_(workspace,n);
+  }
+}
+
+
+template<class Scalar>
+bool PararealIntegrationDriver<Scalar>::takeSlice_(int *n)
+{
+#ifdef HAVE_RYTHMOS_THREADS
+  std::lock_guard<std::mutex> lock(sliceMutex_);
+#endif
+  if (nextSlice_ >= numSlices_)
+    return false;
+  *n = nextSlice_++;
+  return true;
+}
+
+
+template<class Scalar>
+void PararealIntegrationDriver<Scalar>::integrateSlice_(
+  ThreadWorkspace &workspace, const int n
+  )
+{
+  const Scalar t_end = sliceTimes_[n+1];
+
+  workspace.initialCondition.set_t(sliceTimes_[n]);
+  workspace.initialCondition.set_x(U_[n]);
+  if (haveXDot_)
+    workspace.initialCondition.set_x_dot(U_dot_[n]);
+  workspace.stepper->setInitialCondition(workspace.initialCondition);
+  workspace.integrator->setStepper(workspace.stepper,t_end,true);
+
+  Array<Scalar> time_vec(1,t_end);
+  Array<RCP<const Thyra::VectorBase<Scalar> > > x_vec, x_dot_vec;
+  workspace.integrator->getFwdPoints(time_vec,&x_vec,
+    (haveXDot_ ? &x_dot_vec : NULL),NULL);
+  Thyra::V_V(F_[n].ptr(),*x_vec[0]);
+  if (haveXDot_) {
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      is_null(x_dot_vec[0]), std::logic_error,
+      "Error, PararealIntegrationDriver::integrate(...):  The fine stepper "
+      << workspace.stepper->description() << " does not give x_dot!"
+      );
+    Thyra::V_V(F_dot_[n].ptr(),*x_dot_vec[0]);
+  }
+}
+
+
+//
+// Explicit Instantiation macro
+//
+// Must be expanded from within the Rythmos namespace!
+//
+
+#define RYTHMOS_PARAREAL_INTEGRATION_DRIVER_INSTANT(SCALAR) \
+  \
+  template class PararealIntegrationDriver< SCALAR >; \
+  \
+  template RCP<PararealIntegrationDriver< SCALAR > > \
+  pararealIntegrationDriver( \
+    const RCP<const Thyra::ModelEvaluator< SCALAR > > &model, \
+    const Thyra::ModelEvaluatorBase::InArgs< SCALAR > &initialCondition, \
+    const RCP<Thyra::NonlinearSolverBase< SCALAR > > &nlSolver, \
+    const RCP<ParameterList> &integratorBuilderPL, \
+    const RCP<ParameterList> &paramList, \
+    const RCP<StepperBase< SCALAR > > &coarseStepper \
+    );
+
+
+} // namespace Rythmos
+
+
+#endif //Rythmos_PARAREAL_INTEGRATION_DRIVER_DEF_H
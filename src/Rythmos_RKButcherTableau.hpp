@@ -64,8 +64,12 @@ namespace Rythmos {
   inline const std::string Explicit3Stage3rdOrderHeun_name() { return  "Explicit 3 Stage 3rd order by Heun"; } // done
   inline const std::string Explicit3Stage3rdOrder_name() { return  "Explicit 3 Stage 3rd order"; } // done
   inline const std::string Explicit3Stage3rdOrderTVD_name() { return  "Explicit 3 Stage 3rd order TVD"; } // done
+  inline const std::string Explicit3Stage3rdOrderKnothWolke_name() { return  "Explicit 3 Stage 3rd order by Knoth and Wolke"; } // done
   inline const std::string Explicit4Stage3rdOrderRunge_name() { return  "Explicit 4 Stage 3rd order by Runge"; } // done
   inline const std::string Explicit5Stage3rdOrderKandG_name() { return  "Explicit 5 Stage 3rd order by Kinnmark and Gray"; } // done
+  inline const std::string Explicit10Stage4thOrderSSP_name() { return  "Explicit 10 Stage 4th order SSP"; } // done
+  inline const std::string ExplicitSStage2ndOrderSSP_name() { return  "Explicit s Stage 2nd order SSP"; } // done
+  inline const std::string ExplicitSStage3rdOrderSSP_name() { return  "Explicit s Stage 3rd order SSP"; } // done
 
   inline const std::string IRK1StageTheta_name() { return  "IRK 1 Stage Theta Method"; } // done
   inline const std::string IRK2StageTheta_name() { return  "IRK 2 Stage Theta Method"; } // done
@@ -105,6 +109,13 @@ namespace Rythmos {
   inline const std::string SDIRK5Stage4thOrder_name() { return  "Singly Diagonal IRK 5 Stage 4th order"; } // done
   inline const std::string SDIRK3Stage4thOrder_name() { return  "Singly Diagonal IRK 3 Stage 4th order"; } // done
 
+  inline const std::string Explicit3Stage2ndOrderARK_name() { return  "Explicit 3 Stage 2nd order ARK IMEX"; } // done
+  inline const std::string DIRK3Stage2ndOrderARK_name() { return  "Diagonal IRK 3 Stage 2nd order ARK IMEX"; } // done
+  inline const std::string Explicit4Stage3rdOrderARK_name() { return  "Explicit 4 Stage 3rd order ARK IMEX"; } // done
+  inline const std::string DIRK4Stage3rdOrderARK_name() { return  "Diagonal IRK 4 Stage 3rd order ARK IMEX"; } // done
+  inline const std::string Explicit6Stage4thOrderARK_name() { return  "Explicit 6 Stage 4th order ARK IMEX"; } // done
+  inline const std::string DIRK6Stage4thOrderARK_name() { return  "Diagonal IRK 6 Stage 4th order ARK IMEX"; } // done
+
 template<class Scalar>
 class RKButcherTableauDefaultBase :
   virtual public RKButcherTableauBase<Scalar>,
@@ -126,6 +137,8 @@ class RKButcherTableauDefaultBase :
     /** \brief . */
     virtual bool isEmbeddedMethod() const { return isEmbedded_; }  // returns whether the stepper is Embedded or not (Sidafa)
     /** \brief . */
+    virtual Scalar sspCoefficient() const { return sspCoef_; }
+    /** \brief . */
     virtual void setDescription(std::string longDescription) { longDescription_ = longDescription; }
 
     /** \brief . */
@@ -204,6 +217,8 @@ class RKButcherTableauDefaultBase :
         out << "b = " << printMat(this->b()) << std::endl;
         out << "c = " << printMat(this->c()) << std::endl;
         out << "order = " << this->order() << std::endl;
+        if (this->sspCoefficient() > ScalarTraits<Scalar>::zero())
+          out << "SSP coefficient = " << this->sspCoefficient() << std::endl;
       }
     }
 
@@ -216,7 +231,9 @@ class RKButcherTableauDefaultBase :
     void setMy_A(const Teuchos::SerialDenseMatrix<int,Scalar>& new_A) { A_ = new_A; }
     void setMy_b(const Teuchos::SerialDenseVector<int,Scalar>& new_b) { b_ = new_b; }
     void setMy_c(const Teuchos::SerialDenseVector<int,Scalar>& new_c) { c_ = new_c; }
+    void setMy_bhat(const Teuchos::SerialDenseVector<int,Scalar>& new_bhat) { bhat_ = new_bhat; isEmbedded_ = true; }
     void setMy_order(const int& new_order) { order_ = new_order; }
+    void setMy_sspCoef(const Scalar& new_sspCoef) { sspCoef_ = new_sspCoef; }
 
     void setMyValidParameterList( const RCP<ParameterList> validPL ) { validPL_ = validPL; }
     RCP<ParameterList> getMyNonconstValidParameterList() { return validPL_; }
@@ -232,6 +249,9 @@ class RKButcherTableauDefaultBase :
     /* Sidafa - Embedded method parameters */
     Teuchos::SerialDenseVector<int,Scalar> bhat_; 
     bool isEmbedded_ = false;
+
+    // Strong-stability-preserving coefficient (zero if not SSP)
+    Scalar sspCoef_ = ScalarTraits<Scalar>::zero();
 };
 
 
@@ -312,6 +332,7 @@ class ForwardEuler_RKBT :
       this->setMy_b(myb);
       this->setMy_c(myc);
       this->setMy_order(1);
+      this->setMy_sspCoef(ST::one());
     }
 };
 
@@ -736,6 +757,7 @@ class Explicit2Stage2ndOrderTVD_RKBT :
       this->setMy_b(myb);
       this->setMy_c(myc);
       this->setMy_order(2);
+      this->setMy_sspCoef(one);
     }
 };
 
@@ -804,6 +826,7 @@ class Explicit3Stage3rdOrderTVD_RKBT :
       this->setMy_b(myb);
       this->setMy_c(myc);
       this->setMy_order(3);
+      this->setMy_sspCoef(one);
     }
 };
 
@@ -871,6 +894,67 @@ class Explicit3Stage3rdOrderHeun_RKBT :
 };
 
 
+template<class Scalar>
+class Explicit3Stage3rdOrderKnothWolke_RKBT :
+  virtual public RKButcherTableauDefaultBase<Scalar>
+{
+  public:
+    Explicit3Stage3rdOrderKnothWolke_RKBT()
+    {
+      std::ostringstream myDescription;
+      myDescription << Explicit3Stage3rdOrderKnothWolke_name() << "\n"
+                  << "O. Knoth and R. Wolke\n"
+                  << "`Implicit-explicit Runge-Kutta methods for computing\n"
+                  << "atmospheric reactive flows'\n"
+                  << "Applied Numerical Mathematics, 28 (1998), pp. 327-341\n"
+                  << "Also third order as the slow method of a multirate\n"
+                  << "infinitesimal step (MIS) method.\n"
+                  << "c = [  0    1/3  3/4  ]'\n"
+                  << "A = [  0              ]\n"
+                  << "    [ 1/3    0        ]\n"
+                  << "    [-3/16 15/16  0   ]\n"
+                  << "b = [ 1/6  3/10 8/15  ]'" << std::endl;
+      typedef ScalarTraits<Scalar> ST;
+      Scalar one = ST::one();
+      Scalar zero = ST::zero();
+
+      int myNumStages = 3;
+      Teuchos::SerialDenseMatrix<int,Scalar> myA(myNumStages,myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myb(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myc(myNumStages);
+
+      // Fill myA:
+      myA(0,0) = zero;
+      myA(0,1) = zero;
+      myA(0,2) = zero;
+
+      myA(1,0) = one/(3*one);
+      myA(1,1) = zero;
+      myA(1,2) = zero;
+
+      myA(2,0) = -3*one/(16*one);
+      myA(2,1) = 15*one/(16*one);
+      myA(2,2) = zero;
+
+      // Fill myb:
+      myb(0) = one/(6*one);
+      myb(1) = 3*one/(10*one);
+      myb(2) = 8*one/(15*one);
+
+      // fill b_c_
+      myc(0) = zero;
+      myc(1) = one/(3*one);
+      myc(2) = 3*one/(4*one);
+
+      this->setMyDescription(myDescription.str());
+      this->setMy_A(myA);
+      this->setMy_b(myb);
+      this->setMy_c(myc);
+      this->setMy_order(3);
+    }
+};
+
+
 template<class Scalar>
 class Explicit2Stage2ndOrderRunge_RKBT :
   virtual public RKButcherTableauDefaultBase<Scalar>
@@ -1369,6 +1453,264 @@ class Implicit2Stage4thOrderHammerHollingsworth_RKBT :
 };
 
 
+template<class Scalar>
+class Explicit10Stage4thOrderSSP_RKBT :
+  virtual public RKButcherTableauDefaultBase<Scalar>
+{
+  public:
+    Explicit10Stage4thOrderSSP_RKBT()
+    {
+
+      std::ostringstream myDescription;
+      myDescription << Explicit10Stage4thOrderSSP_name() << "\n"
+                    << "David I. Ketcheson\n"
+                    << "`Highly Efficient Strong Stability-Preserving Runge-Kutta\n"
+                    << "Methods with Low-Storage Implementations'\n"
+                    << "SIAM J. Sci. Comput., Vol. 30, No. 4, 2008, pp. 2113-2136\n"
+                    << "SSP coefficient = 6 (effective SSP coefficient = 0.6)\n"
+                    << "This is written in the following set of updates.\n"
+                    << "q1 = u^n, q2 = u^n\n"
+                    << "for i=1:5, q1 = q1 + dt L(q1)/6\n"
+                    << "q2 = q2/25 + 9 q1/25\n"
+                    << "q1 = 15 q2 - 5 q1\n"
+                    << "for i=6:9, q1 = q1 + dt L(q1)/6\n"
+                    << "u^(n+1) = q2 + 3 q1/5 + dt L(q1)/10\n"
+                    << "b = [ 1/10 1/10 ... 1/10 ]'"
+                    << std::endl;
+      typedef ScalarTraits<Scalar> ST;
+      Scalar one = ST::one();
+      Scalar zero = ST::zero();
+      Scalar onesixth = one/(6*one);
+
+      int myNumStages = 10;
+      Teuchos::SerialDenseMatrix<int,Scalar> myA(myNumStages,myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myb(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myc(myNumStages);
+
+      // Build A by tracking the stage coefficients of the Shu-Osher updates
+      // above:  q1 and q2 are u^n + dt*sum_j q(j)*L(Y_j).
+      Teuchos::SerialDenseVector<int,Scalar> q1(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> q2(myNumStages);
+      int s = 0;
+      for ( ; s < 5 ; ++s) {
+        for (int j=0 ; j<myNumStages ; ++j) myA(s,j) = q1(j);
+        q1(s) += onesixth;
+      }
+      for (int j=0 ; j<myNumStages ; ++j) {
+        q2(j) = q2(j)/(25*one) + 9*one*q1(j)/(25*one);
+        q1(j) = 15*one*q2(j) - 5*one*q1(j);
+      }
+      for ( ; s < myNumStages ; ++s) {
+        for (int j=0 ; j<myNumStages ; ++j) myA(s,j) = q1(j);
+        if (s < myNumStages-1) q1(s) += onesixth;
+      }
+
+      // Fill myb and myc:
+      for (int i=0 ; i<myNumStages ; ++i) {
+        myb(i) = one/(10*one);
+        myc(i) = zero;
+        for (int j=0 ; j<i ; ++j) myc(i) += myA(i,j);
+      }
+
+      this->setMyDescription(myDescription.str());
+      this->setMy_A(myA);
+      this->setMy_b(myb);
+      this->setMy_c(myc);
+      this->setMy_order(4);
+      this->setMy_sspCoef(6*one);
+    }
+};
+
+
+template<class Scalar>
+class ExplicitSStage2ndOrderSSP_RKBT :
+  virtual public RKButcherTableauDefaultBase<Scalar>
+{
+  public:
+    ExplicitSStage2ndOrderSSP_RKBT()
+    {
+
+      std::ostringstream myDescription;
+      myDescription << ExplicitSStage2ndOrderSSP_name() << "\n"
+                    << "Sigal Gottlieb, David Ketcheson and Chi-Wang Shu\n"
+                    << "`Strong Stability Preserving Runge-Kutta and Multistep Time Discretizations'\n"
+                    << "World Scientific, 2011\n"
+                    << "pp. 84, SSPRK(s,2) with s >= 2 stages\n"
+                    << "SSP coefficient = s-1 (effective SSP coefficient = (s-1)/s)\n"
+                    << "This is written in the following set of updates.\n"
+                    << "u0 = u^n\n"
+                    << "ui = u(i-1) + dt L(u(i-1))/(s-1), i=1,...,s-1\n"
+                    << "u^(n+1) = u^n/s + (s-1)/s ( u(s-1) + dt L(u(s-1))/(s-1) )\n"
+                    << "A(i,j) = 1/(s-1) for j < i\n"
+                    << "b = [ 1/s 1/s ... 1/s ]'"
+                    << std::endl;
+
+      this->setMyDescription(myDescription.str());
+      numStages_default_ = 4;
+      numStages_ = numStages_default_;
+      this->setupData();
+
+      RCP<ParameterList> validPL = Teuchos::parameterList();
+      validPL->set("Description","",this->getMyDescription());
+      validPL->set<int>("Number of Stages",numStages_default_,
+        "Valid values are s >= 2.  The SSP coefficient is s-1, so the "
+        "allowable step size grows with the number of stages while the "
+        "cost per unit of allowable step size approaches one function "
+        "evaluation.  With s = 2, this is the 2 stage 2nd order TVD method.");
+      Teuchos::setupVerboseObjectSublist(&*validPL);
+      this->setMyValidParameterList(validPL);
+    }
+
+    void setupData()
+    {
+      typedef ScalarTraits<Scalar> ST;
+      TEUCHOS_TEST_FOR_EXCEPTION( numStages_ < 2, std::logic_error,
+        "Error, the number of stages (" << numStages_ << ") must be >= 2 for "
+        << ExplicitSStage2ndOrderSSP_name() << "!\n" );
+      const Scalar one = ST::one();
+      const Scalar r = (numStages_-1)*one;
+      int myNumStages = numStages_;
+      Teuchos::SerialDenseMatrix<int,Scalar> myA(myNumStages,myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myb(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myc(myNumStages);
+      for (int i=0 ; i<myNumStages ; ++i) {
+        for (int j=0 ; j<i ; ++j) myA(i,j) = one/r;
+        myb(i) = one/(myNumStages*one);
+        myc(i) = i*one/r;
+      }
+      this->setMy_A(myA);
+      this->setMy_b(myb);
+      this->setMy_c(myc);
+      this->setMy_order(2);
+      this->setMy_sspCoef(r);
+    }
+
+    void setParameterList(RCP<Teuchos::ParameterList> const& paramList)
+    {
+      TEUCHOS_TEST_FOR_EXCEPT( is_null(paramList) );
+      paramList->validateParameters(*this->getValidParameters());
+      Teuchos::readVerboseObjectSublist(&*paramList,this);
+      numStages_ = paramList->get<int>("Number of Stages",numStages_default_);
+      this->setupData();
+      this->setMyParamList(paramList);
+    }
+  private:
+    int numStages_default_;
+    int numStages_;
+};
+
+
+template<class Scalar>
+class ExplicitSStage3rdOrderSSP_RKBT :
+  virtual public RKButcherTableauDefaultBase<Scalar>
+{
+  public:
+    ExplicitSStage3rdOrderSSP_RKBT()
+    {
+
+      std::ostringstream myDescription;
+      myDescription << ExplicitSStage3rdOrderSSP_name() << "\n"
+                    << "David I. Ketcheson\n"
+                    << "`Highly Efficient Strong Stability-Preserving Runge-Kutta\n"
+                    << "Methods with Low-Storage Implementations'\n"
+                    << "SIAM J. Sci. Comput., Vol. 30, No. 4, 2008, pp. 2113-2136\n"
+                    << "SSPRK(s,3) with s = n^2 stages, n >= 2\n"
+                    << "SSP coefficient = s-n (effective SSP coefficient = 1-1/n)\n"
+                    << "This is written in the following set of updates (r = s-n).\n"
+                    << "q1 = u^n\n"
+                    << "for i=1:(n-1)(n-2)/2, q1 = q1 + dt L(q1)/r\n"
+                    << "q2 = q1\n"
+                    << "for i=(n-1)(n-2)/2+1:n(n+1)/2-1, q1 = q1 + dt L(q1)/r\n"
+                    << "q1 = n q2/(2n-1) + (n-1)/(2n-1) ( q1 + dt L(q1)/r )\n"
+                    << "for i=n(n+1)/2+1:s, q1 = q1 + dt L(q1)/r\n"
+                    << "u^(n+1) = q1"
+                    << std::endl;
+
+      this->setMyDescription(myDescription.str());
+      numStages_default_ = 4;
+      numStages_ = numStages_default_;
+      this->setupData();
+
+      RCP<ParameterList> validPL = Teuchos::parameterList();
+      validPL->set("Description","",this->getMyDescription());
+      validPL->set<int>("Number of Stages",numStages_default_,
+        "Valid values are perfect squares s = n^2 with n >= 2, i.e., "
+        "4, 9, 16, 25, ...  The SSP coefficient is s-n.  With s = 4, "
+        "this is the classical SSPRK(4,3) method with SSP coefficient 2.");
+      Teuchos::setupVerboseObjectSublist(&*validPL);
+      this->setMyValidParameterList(validPL);
+    }
+
+    void setupData()
+    {
+      typedef ScalarTraits<Scalar> ST;
+      int n = 1;
+      while ((n+1)*(n+1) <= numStages_) ++n;
+      TEUCHOS_TEST_FOR_EXCEPTION( (n < 2) || (n*n != numStages_),
+        std::logic_error,
+        "Error, the number of stages (" << numStages_ << ") must be a perfect "
+        "square n^2 with n >= 2 for " << ExplicitSStage3rdOrderSSP_name()
+        << "!\n" );
+      const Scalar one = ST::one();
+      const Scalar r = (numStages_-n)*one;
+      int myNumStages = numStages_;
+      Teuchos::SerialDenseMatrix<int,Scalar> myA(myNumStages,myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myb(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myc(myNumStages);
+
+      // Build A by tracking the stage coefficients of the Shu-Osher updates
+      // in the description:  q1 and q2 are u^n + dt*sum_j q(j)*L(Y_j).
+      Teuchos::SerialDenseVector<int,Scalar> q1(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> q2(myNumStages);
+      int s = 0;
+      for ( ; s < (n-1)*(n-2)/2 ; ++s) {
+        for (int j=0 ; j<myNumStages ; ++j) myA(s,j) = q1(j);
+        q1(s) += one/r;
+      }
+      q2 = q1;
+      for ( ; s < n*(n+1)/2-1 ; ++s) {
+        for (int j=0 ; j<myNumStages ; ++j) myA(s,j) = q1(j);
+        q1(s) += one/r;
+      }
+      for (int j=0 ; j<myNumStages ; ++j) myA(s,j) = q1(j);
+      q1(s) += one/r;
+      for (int j=0 ; j<myNumStages ; ++j) {
+        q1(j) = (n*one*q2(j) + (n-1)*one*q1(j))/((2*n-1)*one);
+      }
+      for (++s ; s < myNumStages ; ++s) {
+        for (int j=0 ; j<myNumStages ; ++j) myA(s,j) = q1(j);
+        q1(s) += one/r;
+      }
+
+      // Fill myb and myc:
+      for (int i=0 ; i<myNumStages ; ++i) {
+        myb(i) = q1(i);
+        myc(i) = ST::zero();
+        for (int j=0 ; j<i ; ++j) myc(i) += myA(i,j);
+      }
+
+      this->setMy_A(myA);
+      this->setMy_b(myb);
+      this->setMy_c(myc);
+      this->setMy_order(3);
+      this->setMy_sspCoef(r);
+    }
+
+    void setParameterList(RCP<Teuchos::ParameterList> const& paramList)
+    {
+      TEUCHOS_TEST_FOR_EXCEPT( is_null(paramList) );
+      paramList->validateParameters(*this->getValidParameters());
+      Teuchos::readVerboseObjectSublist(&*paramList,this);
+      numStages_ = paramList->get<int>("Number of Stages",numStages_default_);
+      this->setupData();
+      this->setMyParamList(paramList);
+    }
+  private:
+    int numStages_default_;
+    int numStages_;
+};
+
+
 template<class Scalar>
 class IRK1StageTheta_RKBT :
   virtual public RKButcherTableauDefaultBase<Scalar>
@@ -2698,6 +3040,389 @@ class SDIRK3Stage4thOrder_RKBT :
 };
 
 
+template<class Scalar>
+class Explicit3Stage2ndOrderARK_RKBT :
+  virtual public RKButcherTableauDefaultBase<Scalar>
+{
+  public:
+    Explicit3Stage2ndOrderARK_RKBT()
+    {
+      std::ostringstream myDescription;
+      myDescription << Explicit3Stage2ndOrderARK_name() << "\n"
+                  << "Explicit part of the ARK2 additive Runge-Kutta IMEX method\n"
+                  << "F. X. Giraldo, J. F. Kelly and E. M. Constantinescu,\n"
+                  << "SIAM J. Sci. Comput., 35(5), 2013, pp. B1162-B1194\n"
+                  << "with embedded 1st order method\n"
+                  << "gamma = 1-1/sqrt(2)\n"
+                  << "c = [ 0  2-sqrt(2)  1 ]'\n"
+                  << "A = [ 0                                      ]\n"
+                  << "    [ 2-sqrt(2)        0                     ]\n"
+                  << "    [ 1-(3+2sqrt(2))/6  (3+2sqrt(2))/6  0    ]\n"
+                  << "b = [ 1/(2sqrt(2))  1/(2sqrt(2))  1-1/sqrt(2) ]'\n"
+                  << "bhat = [ (4-sqrt(2))/8  (4-sqrt(2))/8  1/(2sqrt(2)) ]'" << std::endl;
+      typedef ScalarTraits<Scalar> ST;
+      int myNumStages = 3;
+      Teuchos::SerialDenseMatrix<int,Scalar> myA(myNumStages,myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myb(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myc(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> mybhat(myNumStages);
+      Scalar zero = ST::zero();
+      Scalar one = ST::one();
+      Scalar sqrt2 = ST::squareroot(2*one);
+      Scalar gamma = as<Scalar>( one - one/sqrt2 );
+
+      // Entries not set below are zero
+      myA(1,0) = as<Scalar>( 2*one - sqrt2 );
+      myA(2,0) = as<Scalar>( one - (3*one+2*sqrt2)/(6*one) );
+      myA(2,1) = as<Scalar>( (3*one+2*sqrt2)/(6*one) );
+
+      myb(0) = as<Scalar>( one/(2*sqrt2) );
+      myb(1) = as<Scalar>( one/(2*sqrt2) );
+      myb(2) = gamma;
+
+      mybhat(0) = as<Scalar>( (4*one-sqrt2)/(8*one) );
+      mybhat(1) = as<Scalar>( (4*one-sqrt2)/(8*one) );
+      mybhat(2) = as<Scalar>( one/(2*sqrt2) );
+
+      myc(0) = zero;
+      myc(1) = as<Scalar>( 2*one - sqrt2 );
+      myc(2) = one;
+
+      this->setMyDescription(myDescription.str());
+      this->setMy_A(myA);
+      this->setMy_b(myb);
+      this->setMy_bhat(mybhat);
+      this->setMy_c(myc);
+      this->setMy_order(2);
+    }
+};
+
+
+template<class Scalar>
+class DIRK3Stage2ndOrderARK_RKBT :
+  virtual public RKButcherTableauDefaultBase<Scalar>
+{
+  public:
+    DIRK3Stage2ndOrderARK_RKBT()
+    {
+      std::ostringstream myDescription;
+      myDescription << DIRK3Stage2ndOrderARK_name() << "\n"
+                  << "Implicit part of the ARK2 additive Runge-Kutta IMEX method\n"
+                  << "F. X. Giraldo, J. F. Kelly and E. M. Constantinescu,\n"
+                  << "SIAM J. Sci. Comput., 35(5), 2013, pp. B1162-B1194\n"
+                  << "with embedded 1st order method\n"
+                  << "gamma = 1-1/sqrt(2)\n"
+                  << "c = [ 0  2-sqrt(2)  1 ]'\n"
+                  << "A = [ 0                                      ]\n"
+                  << "    [ gamma          gamma                   ]\n"
+                  << "    [ 1/(2sqrt(2))   1/(2sqrt(2))   gamma    ]\n"
+                  << "b = [ 1/(2sqrt(2))  1/(2sqrt(2))  1-1/sqrt(2) ]'\n"
+                  << "bhat = [ (4-sqrt(2))/8  (4-sqrt(2))/8  1/(2sqrt(2)) ]'" << std::endl;
+      typedef ScalarTraits<Scalar> ST;
+      int myNumStages = 3;
+      Teuchos::SerialDenseMatrix<int,Scalar> myA(myNumStages,myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myb(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myc(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> mybhat(myNumStages);
+      Scalar zero = ST::zero();
+      Scalar one = ST::one();
+      Scalar sqrt2 = ST::squareroot(2*one);
+      Scalar gamma = as<Scalar>( one - one/sqrt2 );
+
+      // Entries not set below are zero
+      myA(1,0) = gamma;
+      myA(1,1) = gamma;
+      myA(2,0) = as<Scalar>( one/(2*sqrt2) );
+      myA(2,1) = as<Scalar>( one/(2*sqrt2) );
+      myA(2,2) = gamma;
+
+      myb(0) = as<Scalar>( one/(2*sqrt2) );
+      myb(1) = as<Scalar>( one/(2*sqrt2) );
+      myb(2) = gamma;
+
+      mybhat(0) = as<Scalar>( (4*one-sqrt2)/(8*one) );
+      mybhat(1) = as<Scalar>( (4*one-sqrt2)/(8*one) );
+      mybhat(2) = as<Scalar>( one/(2*sqrt2) );
+
+      myc(0) = zero;
+      myc(1) = as<Scalar>( 2*one - sqrt2 );
+      myc(2) = one;
+
+      this->setMyDescription(myDescription.str());
+      this->setMy_A(myA);
+      this->setMy_b(myb);
+      this->setMy_bhat(mybhat);
+      this->setMy_c(myc);
+      this->setMy_order(2);
+    }
+};
+
+
+template<class Scalar>
+class Explicit4Stage3rdOrderARK_RKBT :
+  virtual public RKButcherTableauDefaultBase<Scalar>
+{
+  public:
+    Explicit4Stage3rdOrderARK_RKBT()
+    {
+      std::ostringstream myDescription;
+      myDescription << Explicit4Stage3rdOrderARK_name() << "\n"
+                  << "Explicit part of the ARK3(2)4L[2]SA additive Runge-Kutta IMEX method\n"
+                  << "C. A. Kennedy and M. H. Carpenter,\n"
+                  << "Appl. Numer. Math., 44(1-2), 2003, pp. 139-181\n"
+                  << "with embedded 2nd order method\n"
+                  << "(see the reference for the coefficients)" << std::endl;
+      typedef ScalarTraits<Scalar> ST;
+      int myNumStages = 4;
+      Teuchos::SerialDenseMatrix<int,Scalar> myA(myNumStages,myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myb(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myc(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> mybhat(myNumStages);
+      Scalar zero = ST::zero();
+      Scalar one = ST::one();
+
+      // Entries not set below are zero
+      myA(1,0) = as<Scalar>( Scalar(1767732205903.0)/Scalar(2027836641118.0) );
+      myA(2,0) = as<Scalar>( Scalar(5535828885825.0)/Scalar(10492691773637.0) );
+      myA(2,1) = as<Scalar>( Scalar(788022342437.0)/Scalar(10882634858940.0) );
+      myA(3,0) = as<Scalar>( Scalar(6485989280629.0)/Scalar(16251701735622.0) );
+      myA(3,1) = as<Scalar>( Scalar(-4246266847089.0)/Scalar(9704473918619.0) );
+      myA(3,2) = as<Scalar>( Scalar(10755448449292.0)/Scalar(10357097424841.0) );
+
+      myb(0) = as<Scalar>( Scalar(1471266399579.0)/Scalar(7840856788654.0) );
+      myb(1) = as<Scalar>( Scalar(-4482444167858.0)/Scalar(7529755066697.0) );
+      myb(2) = as<Scalar>( Scalar(11266239266428.0)/Scalar(11593286722821.0) );
+      myb(3) = as<Scalar>( Scalar(1767732205903.0)/Scalar(4055673282236.0) );
+
+      mybhat(0) = as<Scalar>( Scalar(2756255671327.0)/Scalar(12835298489170.0) );
+      mybhat(1) = as<Scalar>( Scalar(-10771552573575.0)/Scalar(22201958757719.0) );
+      mybhat(2) = as<Scalar>( Scalar(9247589265047.0)/Scalar(10645013368117.0) );
+      mybhat(3) = as<Scalar>( Scalar(2193209047091.0)/Scalar(5459859503100.0) );
+
+      myc(0) = zero;
+      myc(1) = as<Scalar>( Scalar(1767732205903.0)/Scalar(2027836641118.0) );
+      myc(2) = as<Scalar>( 3*one/(5*one) );
+      myc(3) = one;
+
+      this->setMyDescription(myDescription.str());
+      this->setMy_A(myA);
+      this->setMy_b(myb);
+      this->setMy_bhat(mybhat);
+      this->setMy_c(myc);
+      this->setMy_order(3);
+    }
+};
+
+
+template<class Scalar>
+class DIRK4Stage3rdOrderARK_RKBT :
+  virtual public RKButcherTableauDefaultBase<Scalar>
+{
+  public:
+    DIRK4Stage3rdOrderARK_RKBT()
+    {
+      std::ostringstream myDescription;
+      myDescription << DIRK4Stage3rdOrderARK_name() << "\n"
+                  << "Implicit (ESDIRK) part of the ARK3(2)4L[2]SA additive Runge-Kutta\n"
+                  << "IMEX method, L-stable and stiffly accurate\n"
+                  << "C. A. Kennedy and M. H. Carpenter,\n"
+                  << "Appl. Numer. Math., 44(1-2), 2003, pp. 139-181\n"
+                  << "with embedded 2nd order method\n"
+                  << "gamma = 1767732205903/4055673282236\n"
+                  << "(see the reference for the remaining coefficients)" << std::endl;
+      typedef ScalarTraits<Scalar> ST;
+      int myNumStages = 4;
+      Teuchos::SerialDenseMatrix<int,Scalar> myA(myNumStages,myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myb(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myc(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> mybhat(myNumStages);
+      Scalar zero = ST::zero();
+      Scalar one = ST::one();
+
+      // Entries not set below are zero
+      myA(1,0) = as<Scalar>( Scalar(1767732205903.0)/Scalar(4055673282236.0) );
+      myA(1,1) = as<Scalar>( Scalar(1767732205903.0)/Scalar(4055673282236.0) );
+      myA(2,0) = as<Scalar>( Scalar(2746238789719.0)/Scalar(10658868560708.0) );
+      myA(2,1) = as<Scalar>( Scalar(-640167445237.0)/Scalar(6845629431997.0) );
+      myA(2,2) = as<Scalar>( Scalar(1767732205903.0)/Scalar(4055673282236.0) );
+      myA(3,0) = as<Scalar>( Scalar(1471266399579.0)/Scalar(7840856788654.0) );
+      myA(3,1) = as<Scalar>( Scalar(-4482444167858.0)/Scalar(7529755066697.0) );
+      myA(3,2) = as<Scalar>( Scalar(11266239266428.0)/Scalar(11593286722821.0) );
+      myA(3,3) = as<Scalar>( Scalar(1767732205903.0)/Scalar(4055673282236.0) );
+
+      myb(0) = as<Scalar>( Scalar(1471266399579.0)/Scalar(7840856788654.0) );
+      myb(1) = as<Scalar>( Scalar(-4482444167858.0)/Scalar(7529755066697.0) );
+      myb(2) = as<Scalar>( Scalar(11266239266428.0)/Scalar(11593286722821.0) );
+      myb(3) = as<Scalar>( Scalar(1767732205903.0)/Scalar(4055673282236.0) );
+
+      mybhat(0) = as<Scalar>( Scalar(2756255671327.0)/Scalar(12835298489170.0) );
+      mybhat(1) = as<Scalar>( Scalar(-10771552573575.0)/Scalar(22201958757719.0) );
+      mybhat(2) = as<Scalar>( Scalar(9247589265047.0)/Scalar(10645013368117.0) );
+      mybhat(3) = as<Scalar>( Scalar(2193209047091.0)/Scalar(5459859503100.0) );
+
+      myc(0) = zero;
+      myc(1) = as<Scalar>( Scalar(1767732205903.0)/Scalar(2027836641118.0) );
+      myc(2) = as<Scalar>( 3*one/(5*one) );
+      myc(3) = one;
+
+      this->setMyDescription(myDescription.str());
+      this->setMy_A(myA);
+      this->setMy_b(myb);
+      this->setMy_bhat(mybhat);
+      this->setMy_c(myc);
+      this->setMy_order(3);
+    }
+};
+
+
+template<class Scalar>
+class Explicit6Stage4thOrderARK_RKBT :
+  virtual public RKButcherTableauDefaultBase<Scalar>
+{
+  public:
+    Explicit6Stage4thOrderARK_RKBT()
+    {
+      std::ostringstream myDescription;
+      myDescription << Explicit6Stage4thOrderARK_name() << "\n"
+                  << "Explicit part of the ARK4(3)6L[2]SA additive Runge-Kutta IMEX method\n"
+                  << "C. A. Kennedy and M. H. Carpenter,\n"
+                  << "Appl. Numer. Math., 44(1-2), 2003, pp. 139-181\n"
+                  << "with embedded 3rd order method\n"
+                  << "(see the reference for the coefficients)" << std::endl;
+      typedef ScalarTraits<Scalar> ST;
+      int myNumStages = 6;
+      Teuchos::SerialDenseMatrix<int,Scalar> myA(myNumStages,myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myb(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myc(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> mybhat(myNumStages);
+      Scalar zero = ST::zero();
+      Scalar one = ST::one();
+
+      // Entries not set below are zero
+      myA(1,0) = as<Scalar>( one/(2*one) );
+      myA(2,0) = as<Scalar>( 13861*one/(62500*one) );
+      myA(2,1) = as<Scalar>( 6889*one/(62500*one) );
+      myA(3,0) = as<Scalar>( Scalar(-116923316275.0)/Scalar(2393684061468.0) );
+      myA(3,1) = as<Scalar>( Scalar(-2731218467317.0)/Scalar(15368042101831.0) );
+      myA(3,2) = as<Scalar>( Scalar(9408046702089.0)/Scalar(11113171139209.0) );
+      myA(4,0) = as<Scalar>( Scalar(-451086348788.0)/Scalar(2902428689909.0) );
+      myA(4,1) = as<Scalar>( Scalar(-2682348792572.0)/Scalar(7519795681897.0) );
+      myA(4,2) = as<Scalar>( Scalar(12662868775082.0)/Scalar(11960479115383.0) );
+      myA(4,3) = as<Scalar>( Scalar(3355817975965.0)/Scalar(11060851509271.0) );
+      myA(5,0) = as<Scalar>( Scalar(647845179188.0)/Scalar(3216320057751.0) );
+      myA(5,1) = as<Scalar>( Scalar(73281519250.0)/Scalar(8382639484533.0) );
+      myA(5,2) = as<Scalar>( Scalar(552539513391.0)/Scalar(3454668386233.0) );
+      myA(5,3) = as<Scalar>( Scalar(3354512671639.0)/Scalar(8306763924573.0) );
+      myA(5,4) = as<Scalar>( 4040*one/(17871*one) );
+
+      myb(0) = as<Scalar>( Scalar(82889.0)/Scalar(524892.0) );
+      myb(1) = zero;
+      myb(2) = as<Scalar>( 15625*one/(83664*one) );
+      myb(3) = as<Scalar>( Scalar(69875.0)/Scalar(102672.0) );
+      myb(4) = as<Scalar>( -2260*one/(8211*one) );
+      myb(5) = as<Scalar>( one/(4*one) );
+
+      mybhat(0) = as<Scalar>( Scalar(4586570599.0)/Scalar(29645900160.0) );
+      mybhat(1) = zero;
+      mybhat(2) = as<Scalar>( Scalar(178811875.0)/Scalar(945068544.0) );
+      mybhat(3) = as<Scalar>( Scalar(814220225.0)/Scalar(1159782912.0) );
+      mybhat(4) = as<Scalar>( Scalar(-3700637.0)/Scalar(11593932.0) );
+      mybhat(5) = as<Scalar>( Scalar(61727.0)/Scalar(225920.0) );
+
+      myc(0) = zero;
+      myc(1) = as<Scalar>( one/(2*one) );
+      myc(2) = as<Scalar>( 83*one/(250*one) );
+      myc(3) = as<Scalar>( 31*one/(50*one) );
+      myc(4) = as<Scalar>( 17*one/(20*one) );
+      myc(5) = one;
+
+      this->setMyDescription(myDescription.str());
+      this->setMy_A(myA);
+      this->setMy_b(myb);
+      this->setMy_bhat(mybhat);
+      this->setMy_c(myc);
+      this->setMy_order(4);
+    }
+};
+
+
+template<class Scalar>
+class DIRK6Stage4thOrderARK_RKBT :
+  virtual public RKButcherTableauDefaultBase<Scalar>
+{
+  public:
+    DIRK6Stage4thOrderARK_RKBT()
+    {
+      std::ostringstream myDescription;
+      myDescription << DIRK6Stage4thOrderARK_name() << "\n"
+                  << "Implicit (ESDIRK) part of the ARK4(3)6L[2]SA additive Runge-Kutta\n"
+                  << "IMEX method, L-stable and stiffly accurate\n"
+                  << "C. A. Kennedy and M. H. Carpenter,\n"
+                  << "Appl. Numer. Math., 44(1-2), 2003, pp. 139-181\n"
+                  << "with embedded 3rd order method\n"
+                  << "gamma = 1/4\n"
+                  << "(see the reference for the remaining coefficients)" << std::endl;
+      typedef ScalarTraits<Scalar> ST;
+      int myNumStages = 6;
+      Teuchos::SerialDenseMatrix<int,Scalar> myA(myNumStages,myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myb(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> myc(myNumStages);
+      Teuchos::SerialDenseVector<int,Scalar> mybhat(myNumStages);
+      Scalar zero = ST::zero();
+      Scalar one = ST::one();
+
+      // Entries not set below are zero
+      myA(1,0) = as<Scalar>( one/(4*one) );
+      myA(1,1) = as<Scalar>( one/(4*one) );
+      myA(2,0) = as<Scalar>( 8611*one/(62500*one) );
+      myA(2,1) = as<Scalar>( -1743*one/(31250*one) );
+      myA(2,2) = as<Scalar>( one/(4*one) );
+      myA(3,0) = as<Scalar>( Scalar(5012029.0)/Scalar(34652500.0) );
+      myA(3,1) = as<Scalar>( Scalar(-654441.0)/Scalar(2922500.0) );
+      myA(3,2) = as<Scalar>( Scalar(174375.0)/Scalar(388108.0) );
+      myA(3,3) = as<Scalar>( one/(4*one) );
+      myA(4,0) = as<Scalar>( Scalar(15267082809.0)/Scalar(155376265600.0) );
+      myA(4,1) = as<Scalar>( Scalar(-71443401.0)/Scalar(120774400.0) );
+      myA(4,2) = as<Scalar>( Scalar(730878875.0)/Scalar(902184768.0) );
+      myA(4,3) = as<Scalar>( Scalar(2285395.0)/Scalar(8070912.0) );
+      myA(4,4) = as<Scalar>( one/(4*one) );
+      myA(5,0) = as<Scalar>( Scalar(82889.0)/Scalar(524892.0) );
+      myA(5,2) = as<Scalar>( 15625*one/(83664*one) );
+      myA(5,3) = as<Scalar>( Scalar(69875.0)/Scalar(102672.0) );
+      myA(5,4) = as<Scalar>( -2260*one/(8211*one) );
+      myA(5,5) = as<Scalar>( one/(4*one) );
+
+      myb(0) = as<Scalar>( Scalar(82889.0)/Scalar(524892.0) );
+      myb(1) = zero;
+      myb(2) = as<Scalar>( 15625*one/(83664*one) );
+      myb(3) = as<Scalar>( Scalar(69875.0)/Scalar(102672.0) );
+      myb(4) = as<Scalar>( -2260*one/(8211*one) );
+      myb(5) = as<Scalar>( one/(4*one) );
+
+      mybhat(0) = as<Scalar>( Scalar(4586570599.0)/Scalar(29645900160.0) );
+      mybhat(1) = zero;
+      mybhat(2) = as<Scalar>( Scalar(178811875.0)/Scalar(945068544.0) );
+      mybhat(3) = as<Scalar>( Scalar(814220225.0)/Scalar(1159782912.0) );
+      mybhat(4) = as<Scalar>( Scalar(-3700637.0)/Scalar(11593932.0) );
+      mybhat(5) = as<Scalar>( Scalar(61727.0)/Scalar(225920.0) );
+
+      myc(0) = zero;
+      myc(1) = as<Scalar>( one/(2*one) );
+      myc(2) = as<Scalar>( 83*one/(250*one) );
+      myc(3) = as<Scalar>( 31*one/(50*one) );
+      myc(4) = as<Scalar>( 17*one/(20*one) );
+      myc(5) = one;
+
+      this->setMyDescription(myDescription.str());
+      this->setMy_A(myA);
+      this->setMy_b(myb);
+      this->setMy_bhat(mybhat);
+      this->setMy_c(myc);
+      this->setMy_order(4);
+    }
+};
+
+
 } // namespace Rythmos
 
 
@@ -61,6 +61,14 @@ public:
   virtual int order() const = 0;
     /** \brief . */
   virtual bool isEmbeddedMethod() const = 0;
+  /** \brief Return the strong-stability-preserving (SSP) coefficient.
+   *
+   * If the method is SSP, then it preserves any convex functional bound
+   * satisfied by Forward Euler with step size <tt>dt_FE</tt> for all step
+   * sizes <tt>dt <= sspCoefficient()*dt_FE</tt>.  A return value of zero
+   * means the method is not SSP (or the coefficient is not known).
+   */
+  virtual Scalar sspCoefficient() const = 0;
   /** \brief . */
   virtual bool operator== (const RKButcherTableauBase<Scalar>& rkbt) const;
   /** \brief . */
@@ -160,6 +160,11 @@ void RKButcherTableauBuilder<Scalar>::initializeDefaults_()
                           Explicit3Stage3rdOrderTVD_RKBT<Scalar> >(),
       Explicit3Stage3rdOrderTVD_name());
 
+  builder_.setObjectFactory(
+      abstractFactoryStd< RKButcherTableauBase<Scalar>,
+                          Explicit3Stage3rdOrderKnothWolke_RKBT<Scalar> >(),
+      Explicit3Stage3rdOrderKnothWolke_name());
+
   builder_.setObjectFactory(
       abstractFactoryStd< RKButcherTableauBase<Scalar>,
                           Explicit2Stage2ndOrderTVD_RKBT<Scalar> >(),
@@ -175,6 +180,21 @@ void RKButcherTableauBuilder<Scalar>::initializeDefaults_()
                          Explicit5Stage3rdOrderKandG_RKBT<Scalar> >(),
       Explicit5Stage3rdOrderKandG_name()); 
 
+  builder_.setObjectFactory(
+      abstractFactoryStd< RKButcherTableauBase<Scalar>,
+                          ExplicitSStage2ndOrderSSP_RKBT<Scalar> >(),
+      ExplicitSStage2ndOrderSSP_name());
+
+  builder_.setObjectFactory(
+      abstractFactoryStd< RKButcherTableauBase<Scalar>,
+                          ExplicitSStage3rdOrderSSP_RKBT<Scalar> >(),
+      ExplicitSStage3rdOrderSSP_name());
+
+  builder_.setObjectFactory(
+      abstractFactoryStd< RKButcherTableauBase<Scalar>,
+                          Explicit10Stage4thOrderSSP_RKBT<Scalar> >(),
+      Explicit10Stage4thOrderSSP_name());
+
   builder_.setObjectFactory(
       abstractFactoryStd< RKButcherTableauBase<Scalar>,
                           Explicit4Stage4thOrder_RKBT<Scalar> >(),
@@ -185,6 +205,21 @@ void RKButcherTableauBuilder<Scalar>::initializeDefaults_()
                           Explicit3_8Rule_RKBT<Scalar> >(),
       Explicit3_8Rule_name());
 
+  builder_.setObjectFactory(
+      abstractFactoryStd< RKButcherTableauBase<Scalar>,
+                          Explicit3Stage2ndOrderARK_RKBT<Scalar> >(),
+      Explicit3Stage2ndOrderARK_name());
+
+  builder_.setObjectFactory(
+      abstractFactoryStd< RKButcherTableauBase<Scalar>,
+                          Explicit4Stage3rdOrderARK_RKBT<Scalar> >(),
+      Explicit4Stage3rdOrderARK_name());
+
+  builder_.setObjectFactory(
+      abstractFactoryStd< RKButcherTableauBase<Scalar>,
+                          Explicit6Stage4thOrderARK_RKBT<Scalar> >(),
+      Explicit6Stage4thOrderARK_name());
+
   // Implicit
   builder_.setObjectFactory(
       abstractFactoryStd< RKButcherTableauBase<Scalar>,
@@ -233,6 +268,21 @@ void RKButcherTableauBuilder<Scalar>::initializeDefaults_()
                           DIRK2Stage3rdOrder_RKBT<Scalar> >(),
       DIRK2Stage3rdOrder_name());
 
+  builder_.setObjectFactory(
+      abstractFactoryStd< RKButcherTableauBase<Scalar>,
+                          DIRK3Stage2ndOrderARK_RKBT<Scalar> >(),
+      DIRK3Stage2ndOrderARK_name());
+
+  builder_.setObjectFactory(
+      abstractFactoryStd< RKButcherTableauBase<Scalar>,
+                          DIRK4Stage3rdOrderARK_RKBT<Scalar> >(),
+      DIRK4Stage3rdOrderARK_name());
+
+  builder_.setObjectFactory(
+      abstractFactoryStd< RKButcherTableauBase<Scalar>,
+                          DIRK6Stage4thOrderARK_RKBT<Scalar> >(),
+      DIRK6Stage4thOrderARK_name());
+
   // IRK
   builder_.setObjectFactory(
       abstractFactoryStd< RKButcherTableauBase<Scalar>,
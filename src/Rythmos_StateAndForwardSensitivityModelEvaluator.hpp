@@ -31,6 +31,7 @@
 
 
 #include "Rythmos_ForwardSensitivityModelEvaluatorBase.hpp"
+#include "Rythmos_BlockSolveLinearOpWithSolve.hpp"
 #include "Thyra_ModelEvaluator.hpp" // Interface
 #include "Thyra_StateFuncModelEvaluatorBase.hpp" // Implementation
 #include "Thyra_DefaultProductVectorSpace.hpp"
@@ -38,6 +39,9 @@
 #include "Thyra_DefaultMultiVectorProductVectorSpace.hpp"
 #include "Thyra_DefaultMultiVectorProductVector.hpp"
 #include "Thyra_DefaultMultiVectorLinearOpWithSolve.hpp"
+#include "Thyra_DefaultBlockedTriangularLinearOpWithSolve.hpp"
+#include "Thyra_ModelEvaluatorHelpers.hpp"
+#include "Thyra_ProductVectorBase.hpp"
 #include "Teuchos_implicit_cast.hpp"
 
 
@@ -169,14 +173,36 @@ namespace Rythmos {
  * ToDo: Replace the above documentation with the helper functions that will
  * do all of this!
  *
- * Currently, this class does not implement the full ModelEvaluator interface
- * and it really just provides the spaces for x_bar and f_bar and the InArgs
- * and OutArgs creation functions to allow for the full specification of the
- * <tt>ForwardSensitivityStepper</tt> class.  This is especially important in
- * order to correctly set the full initial condition for the state and the
- * forward sensitivities.  Later this class can be completely finished in
- * which case it would necessarly implement the evaluations and the linear
- * solves which would automatically support the simultaneous corrector method.
+ * This class provides the spaces for x_bar and f_bar and the InArgs and
+ * OutArgs creation functions needed to set the full initial condition for
+ * the state and the forward sensitivities in the
+ * <tt>ForwardSensitivityStepper</tt> class.  It also evaluates
+ * <tt>f_bar</tt> and <tt>W_bar</tt> so that a single stepper and nonlinear
+ * solver can integrate <tt>x_bar</tt> directly, which is the simultaneous
+ * corrector method.  The sensitivity residual is evaluated at the current
+ * state iterate with <tt>d(f)/d(x)</tt>, <tt>d(f)/d(x_dot)</tt> and
+ * <tt>d(f)/d(p)</tt> from the state model, whose storage is created once
+ * and reused.
+ *
+ * The iteration matrix <tt>W_bar</tt> created by <tt>create_W()</tt> is the
+ * block diagonal approximation
+
+ \verbatim
+
+   W_bar = [ W             ]
+           [    diag(W,np) ]
+
+ \endverbatim
+
+ * of the full Jacobian of <tt>f_bar</tt>, where <tt>W = alpha*d(f)/d(x_dot)
+ * + beta*d(f)/d(x)</tt> is the state iteration matrix.  The sensitivity
+ * block is a <tt>Thyra::DefaultMultiVectorLinearOpWithSolve</tt> that wraps
+ * the very same <tt>W</tt> object as the state block, so a Newton iteration
+ * on <tt>x_bar</tt> costs one factorization of <tt>W</tt> and solves the
+ * <tt>np</tt> sensitivity columns as one multi-vector solve.  The coupling
+ * <tt>d(f_sens)/d(x)</tt> is left out, which makes this a modified Newton
+ * method for <tt>x_bar</tt> just like the one used by the simultaneous
+ * corrector in CVODES.
  *
  * ToDo: Finish documentation!
  */
@@ -203,6 +229,17 @@ public:
     const Teuchos::RCP<const ForwardSensitivityModelEvaluatorBase<Scalar> > &sensModel
     );
 
+  /** \brief Set the number of sensitivity columns passed to each solve with
+   * the state block of <tt>W_bar</tt>.
+   *
+   * The default of zero solves for all <tt>np</tt> columns together.  See
+   * <tt>ForwardSensitivityImplicitModelEvaluator::setSolveBlockSize()</tt>.
+   */
+  void setSolveBlockSize(const int blockSize);
+
+  /** \brief . */
+  int getSolveBlockSize() const;
+
   // 2007/05/30: rabartl: ToDo: Add function to set the nominal values etc.
 
   /** \brief Create a wrapped product vector of the form <tt>x_bar = [ x; s_bar ]</tt>.
@@ -265,6 +302,22 @@ private:
   int Np_;
   Teuchos::RCP<const Thyra::DefaultProductVectorSpace<Scalar> > x_bar_space_;
   Teuchos::RCP<const Thyra::DefaultProductVectorSpace<Scalar> > f_bar_space_;
+  Teuchos::RCP<const Thyra::DefaultMultiVectorProductVectorSpace<Scalar> > s_bar_space_;
+  Teuchos::RCP<const Thyra::DefaultMultiVectorProductVectorSpace<Scalar> > f_sens_space_;
+
+  mutable Teuchos::RCP<Thyra::LinearOpBase<Scalar> > DfDx_;
+  mutable Teuchos::RCP<Thyra::LinearOpBase<Scalar> > DfDx_dot_;
+  mutable Teuchos::RCP<Thyra::MultiVectorBase<Scalar> > DfDp_;
+
+  int solveBlockSize_;
+  mutable Teuchos::RCP<BlockSolveLinearOpWithSolve<Scalar> > W_state_block_;
+
+  // /////////////////////////
+  // Private member functions
+
+  void computeDerivativeMatrices(
+    const Thyra::ModelEvaluatorBase::InArgs<Scalar> &stateInArgs
+    ) const;
   
 };
 
@@ -278,7 +331,7 @@ private:
 
 template<class Scalar>
 StateAndForwardSensitivityModelEvaluator<Scalar>::StateAndForwardSensitivityModelEvaluator()
-  :Np_(0)
+  :Np_(0), solveBlockSize_(0)
 {}
 
 
@@ -309,8 +362,39 @@ void StateAndForwardSensitivityModelEvaluator<Scalar>::initializeStructure(
       )
     );
 
+  s_bar_space_ = sensModel_->get_s_bar_space();
+
+  f_sens_space_ =
+    Teuchos::rcp_dynamic_cast<const Thyra::DefaultMultiVectorProductVectorSpace<Scalar> >(
+      sensModel_->get_f_space(), true
+      );
+
   Np_ = stateModel->Np();
 
+  DfDx_ = Teuchos::null;
+  DfDx_dot_ = Teuchos::null;
+  DfDp_ = Teuchos::null;
+
+}
+
+
+template<class Scalar>
+void StateAndForwardSensitivityModelEvaluator<Scalar>::setSolveBlockSize(
+  const int blockSize
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    blockSize < 0, std::logic_error,
+    "Error, blockSize = " << blockSize << " can not be negative!"
+    );
+  solveBlockSize_ = blockSize;
+}
+
+
+template<class Scalar>
+int StateAndForwardSensitivityModelEvaluator<Scalar>::getSolveBlockSize() const
+{
+  return solveBlockSize_;
 }
 
 
@@ -387,8 +471,15 @@ template<class Scalar>
 Teuchos::RCP<Thyra::LinearOpWithSolveBase<Scalar> >
 StateAndForwardSensitivityModelEvaluator<Scalar>::create_W() const
 {
-  TEUCHOS_TEST_FOR_EXCEPT("ToDo: Implement create_W() when needed!");
-  return Teuchos::null;
+  // The sensitivity block is initialized to wrap the state block in
+  // evalModel(...) once the state block has been computed.
+  const Teuchos::RCP<Thyra::DefaultBlockedTriangularLinearOpWithSolve<Scalar> >
+    W_bar = Thyra::defaultBlockedTriangularLinearOpWithSolve<Scalar>();
+  W_bar->beginBlockFill(f_bar_space_, x_bar_space_);
+  W_bar->setNonconstLOWSBlock(0, 0, sensModel_->getStateModel()->create_W());
+  W_bar->setNonconstLOWSBlock(1, 1, Thyra::multiVectorLinearOpWithSolve<Scalar>());
+  W_bar->endBlockFill();
+  return W_bar;
 }
 
 
@@ -438,11 +529,196 @@ StateAndForwardSensitivityModelEvaluator<Scalar>::createOutArgsImpl() const
 
 template<class Scalar>
 void StateAndForwardSensitivityModelEvaluator<Scalar>::evalModelImpl(
-  const Thyra::ModelEvaluatorBase::InArgs<Scalar> &/* inArgs */,
-  const Thyra::ModelEvaluatorBase::OutArgs<Scalar> &/* outArgs */
+  const Thyra::ModelEvaluatorBase::InArgs<Scalar> &inArgs,
+  const Thyra::ModelEvaluatorBase::OutArgs<Scalar> &outArgs
   ) const
 {
-  TEUCHOS_TEST_FOR_EXCEPT("ToDo: Implement evalModel(...) when needed!");
+
+  using Teuchos::RCP;
+  using Teuchos::rcp_dynamic_cast;
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  typedef Thyra::ModelEvaluatorBase MEB;
+  typedef Teuchos::VerboseObjectTempState<MEB> VOTSME;
+  typedef Thyra::DefaultMultiVectorProductVector<Scalar> DMVPV;
+
+  THYRA_MODEL_EVALUATOR_DECORATOR_EVAL_MODEL_GEN_BEGIN(
+    "StateAndForwardSensitivityModelEvaluator", inArgs, outArgs, Teuchos::null );
+
+  const RCP<const Thyra::ModelEvaluator<Scalar> >
+    stateModel = sensModel_->getStateModel();
+
+  //
+  // InArgs
+  //
+
+  const RCP<const Thyra::ProductVectorBase<Scalar> >
+    x_bar = Thyra::productVectorBase<Scalar>(inArgs.get_x().assert_not_null());
+  RCP<const Thyra::ProductVectorBase<Scalar> > x_bar_dot;
+  if (inArgs.supports(MEB::IN_ARG_x_dot))
+    x_bar_dot = Thyra::productVectorBase<Scalar>(inArgs.get_x_dot().assert_not_null());
+
+  MEB::InArgs<Scalar> stateInArgs = stateModel->createInArgs();
+  stateInArgs.setArgs(inArgs,true); // Set t, p, alpha and beta
+  stateInArgs.set_x(x_bar->getVectorBlock(0));
+  if (nonnull(x_bar_dot))
+    stateInArgs.set_x_dot(x_bar_dot->getVectorBlock(0));
+
+  //
+  // OutArgs
+  //
+
+  RCP<Thyra::ProductVectorBase<Scalar> > f_bar;
+  if (nonnull(outArgs.get_f()))
+    f_bar = Thyra::nonconstProductVectorBase<Scalar>(outArgs.get_f());
+  RCP<Thyra::DefaultBlockedTriangularLinearOpWithSolve<Scalar> > W_bar;
+  if (outArgs.supports(MEB::OUT_ARG_W) && nonnull(outArgs.get_W())) {
+    W_bar = rcp_dynamic_cast<Thyra::DefaultBlockedTriangularLinearOpWithSolve<Scalar> >(
+      outArgs.get_W(), true
+      );
+  }
+
+  //
+  // A) Evaluate the state residual and the state block of W_bar together
+  //
+
+  RCP<Thyra::LinearOpWithSolveBase<Scalar> > W_state;
+  {
+    MEB::OutArgs<Scalar> stateOutArgs = stateModel->createOutArgs();
+    if (nonnull(f_bar))
+      stateOutArgs.set_f(f_bar->getNonconstVectorBlock(0));
+    if (nonnull(W_bar)) {
+      W_state = W_bar->getNonconstLOWSBlock(0,0);
+      stateOutArgs.set_W(W_state);
+    }
+    VOTSME stateModel_outputTempState(stateModel,out,verbLevel);
+    stateModel->evalModel(stateInArgs,stateOutArgs);
+  }
+
+  //
+  // B) Evaluate the sensitivity residual
+  //
+  //   F_sens = d(f)/d(x_dot)*S_dot + d(f)/d(x)*S + d(f)/d(p)
+  //
+
+  if (nonnull(f_bar)) {
+
+    computeDerivativeMatrices(stateInArgs);
+
+    const RCP<const Thyra::MultiVectorBase<Scalar> >
+      S = rcp_dynamic_cast<const DMVPV>(x_bar->getVectorBlock(1),true)->getMultiVector();
+    const RCP<Thyra::MultiVectorBase<Scalar> >
+      F_sens = rcp_dynamic_cast<DMVPV>(
+        f_bar->getNonconstVectorBlock(1),true)->getNonconstMultiVector();
+
+    // F_sens = d(f)/d(x) * S
+    Thyra::apply( *DfDx_, Thyra::NOTRANS, *S, F_sens.ptr() );
+    // F_sens += d(f)/d(x_dot) * S_dot
+    if (nonnull(x_bar_dot)) {
+      const RCP<const Thyra::MultiVectorBase<Scalar> >
+        S_dot = rcp_dynamic_cast<const DMVPV>(
+          x_bar_dot->getVectorBlock(1),true)->getMultiVector();
+      Thyra::apply(
+        *DfDx_dot_, Thyra::NOTRANS,
+        *S_dot, F_sens.ptr(),
+        ST::one(), ST::one()
+        );
+    }
+    // F_sens += d(f)/d(p) for the active parameters
+    if (nonnull(DfDp_)) {
+      const Teuchos::Array<int> &activeParams = sensModel_->getActiveParameters();
+      if (Teuchos::as<int>(activeParams.size()) == DfDp_->domain()->dim())
+        Vp_V( F_sens.ptr(), *DfDp_ );
+      else
+        Vp_V( F_sens.ptr(), *DfDp_->subView(activeParams()) );
+    }
+
+  }
+
+  //
+  // C) Point the sensitivity block of W_bar at the state block
+  //
+
+  if (nonnull(W_bar)) {
+    RCP<const Thyra::LinearOpWithSolveBase<Scalar> > W_sens_block = W_state;
+    if (solveBlockSize_ > 0) {
+      if (is_null(W_state_block_))
+        W_state_block_ = blockSolveLinearOpWithSolve<Scalar>();
+      W_state_block_->initialize( W_state, solveBlockSize_ );
+      W_sens_block = W_state_block_;
+    }
+    rcp_dynamic_cast<Thyra::DefaultMultiVectorLinearOpWithSolve<Scalar> >(
+      W_bar->getNonconstLOWSBlock(1,1), true
+      )->initialize( W_sens_block, s_bar_space_, f_sens_space_ );
+  }
+
+  THYRA_MODEL_EVALUATOR_DECORATOR_EVAL_MODEL_END();
+
+}
+
+
+// private
+
+
+template<class Scalar>
+void StateAndForwardSensitivityModelEvaluator<Scalar>::computeDerivativeMatrices(
+  const Thyra::ModelEvaluatorBase::InArgs<Scalar> &stateInArgs
+  ) const
+{
+
+  typedef Teuchos::ScalarTraits<Scalar> ST;
+  typedef Thyra::ModelEvaluatorBase MEB;
+  typedef Teuchos::VerboseObjectTempState<MEB> VOTSME;
+
+  Teuchos::RCP<Teuchos::FancyOStream> out = this->getOStream();
+  Teuchos::EVerbosityLevel verbLevel = this->getVerbLevel();
+
+  const Teuchos::RCP<const Thyra::ModelEvaluator<Scalar> >
+    stateModel = sensModel_->getStateModel();
+  const int p_index = sensModel_->get_p_index();
+
+  // The storage for the matrices is created on the first evaluation and is
+  // refilled at every new point after that.
+
+  // d(f)/d(x) and d(f)/d(p)
+  {
+    MEB::InArgs<Scalar> inArgs = stateInArgs;
+    MEB::OutArgs<Scalar> outArgs = stateModel->createOutArgs();
+    if (is_null(DfDx_))
+      DfDx_ = stateModel->create_W_op();
+    if (inArgs.supports(MEB::IN_ARG_alpha))
+      inArgs.set_alpha(ST::zero());
+    if (inArgs.supports(MEB::IN_ARG_beta))
+      inArgs.set_beta(ST::one());
+    outArgs.set_W_op(DfDx_);
+    if (p_index >= 0) {
+      if (is_null(DfDp_)) {
+        DfDp_ = Thyra::create_DfDp_mv(
+          *stateModel, p_index,
+          MEB::DERIV_MV_BY_COL
+          ).getMultiVector();
+      }
+      outArgs.set_DfDp(
+        p_index,
+        MEB::Derivative<Scalar>(DfDp_,MEB::DERIV_MV_BY_COL)
+        );
+    }
+    VOTSME stateModel_outputTempState(stateModel,out,verbLevel);
+    stateModel->evalModel(inArgs,outArgs);
+  }
+
+  // d(f)/d(x_dot)
+  if (stateInArgs.supports(MEB::IN_ARG_x_dot)) {
+    MEB::InArgs<Scalar> inArgs = stateInArgs;
+    MEB::OutArgs<Scalar> outArgs = stateModel->createOutArgs();
+    if (is_null(DfDx_dot_))
+      DfDx_dot_ = stateModel->create_W_op();
+    inArgs.set_alpha(ST::one());
+    inArgs.set_beta(ST::zero());
+    outArgs.set_W_op(DfDx_dot_);
+    VOTSME stateModel_outputTempState(stateModel,out,verbLevel);
+    stateModel->evalModel(inArgs,outArgs);
+  }
+
 }
 
 
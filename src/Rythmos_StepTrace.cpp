@@ -0,0 +1,225 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+
+#include "Rythmos_StepTrace.hpp"
+#include "Teuchos_Assert.hpp"
+#include "Teuchos_as.hpp"
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+
+namespace {
+
+
+const char stepTraceMagic[8] = { 'R','Y','T','H','T','R','C','2' };
+
+
+struct StepTraceHeader {
+  char magic[8];
+  int recordSize;
+  int threadId;
+  int numRecords;
+  int reserved;
+  unsigned long long numDropped;
+};
+
+
+} // namespace
+
+
+namespace Rythmos {
+
+
+// StepTraceRing
+
+
+StepTraceRing::StepTraceRing(int capacity, int threadId)
+  :capacity_(1),
+   threadId_(threadId),
+   numRecorded_(0)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION( capacity < 1, std::logic_error,
+    "Error, the capacity = " << capacity << " of a StepTraceRing must be "
+    "positive!" );
+  while (capacity_ < capacity)
+    capacity_ *= 2;
+  mask_ = capacity_ - 1;
+  records_.resize(capacity_);
+}
+
+
+void StepTraceRing::getRecords(Array<StepTraceRecord> *records) const
+{
+  TEUCHOS_ASSERT(records);
+  records->clear();
+  const int numRecords = getNumRecords();
+  records->reserve(numRecords);
+  for (std::size_t i = numRecorded_ - numRecords ; i != numRecorded_ ; ++i)
+    records->push_back(records_[i & mask_]);
+}
+
+
+std::string StepTraceRing::description() const
+{
+  std::ostringstream oss;
+  oss << "Rythmos::StepTraceRing{capacity=" << capacity_
+      << ",threadId=" << threadId_
+      << ",numRecords=" << getNumRecords()
+      << ",numDropped=" << getNumDropped() << "}";
+  return oss.str();
+}
+
+
+// Nonmember functions
+
+
+void writeStepTrace(StepTraceRing &ring, std::ostream &out)
+{
+  Array<StepTraceRecord> records;
+  ring.getRecords(&records);
+  StepTraceHeader header;
+  std::memcpy(header.magic, stepTraceMagic, sizeof(stepTraceMagic));
+  header.recordSize = sizeof(StepTraceRecord);
+  header.threadId = ring.getThreadId();
+  header.numRecords = records.size();
+  header.reserved = 0;
+  header.numDropped = ring.getNumDropped();
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (records.size() > 0) {
+    out.write(reinterpret_cast<const char*>(&records[0]),
+      records.size()*sizeof(StepTraceRecord));
+  }
+  TEUCHOS_TEST_FOR_EXCEPTION( !out, std::runtime_error,
+    "Error, writing the step trace failed!" );
+  ring.clear();
+}
+
+
+bool readStepTrace(
+  std::istream &in, int *threadId, std::size_t *numDropped,
+  Array<StepTraceRecord> *records
+  )
+{
+  TEUCHOS_ASSERT(records);
+  StepTraceHeader header;
+  in.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (in.gcount() == 0)
+    return false;
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    (in.gcount() != sizeof(header)) ||
+    std::memcmp(header.magic, stepTraceMagic, sizeof(stepTraceMagic)) != 0,
+    std::runtime_error,
+    "Error, the stream does not contain a Rythmos step trace!" );
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    header.recordSize != sizeof(StepTraceRecord), std::runtime_error,
+    "Error, the step trace has records of " << header.recordSize
+    << " bytes but this build uses " << sizeof(StepTraceRecord) << "!" );
+  if (threadId)
+    *threadId = header.threadId;
+  if (numDropped)
+    *numDropped = header.numDropped;
+  const int offset = records->size();
+  records->resize(offset + header.numRecords);
+  if (header.numRecords > 0) {
+    in.read(reinterpret_cast<char*>(&(*records)[offset]),
+      header.numRecords*sizeof(StepTraceRecord));
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      in.gcount() != header.numRecords*Teuchos::as<int>(sizeof(StepTraceRecord)),
+      std::runtime_error,
+      "Error, the step trace ended after " << in.gcount() << " bytes of "
+      << header.numRecords << " records!" );
+  }
+  return true;
+}
+
+
+void writeStepTraceCSV(
+  const ArrayView<const StepTraceRecord> &records, int threadId,
+  std::ostream &out, bool writeHeader
+  )
+{
+  if (writeHeader) {
+    out << "thread,wallTime,event,stepIndex,time,stepSize,order,errorNorm,"
+        << "nonlinearIterations\n";
+  }
+  const std::streamsize oldPrecision = out.precision(17);
+  for (int i=0 ; i<records.size() ; ++i) {
+    const StepTraceRecord &r = records[i];
+    out << threadId << ","
+        << r.wallTime << ","
+        << toString(static_cast<EStepTraceEvent>(r.event)) << ","
+        << r.stepIndex << ","
+        << r.time << ","
+        << r.stepSize << ","
+        << r.order << ","
+        << r.errorNorm << ","
+        << r.nonlinearIterations << "\n";
+  }
+  out.precision(oldPrecision);
+}
+
+
+void writeStepTraceChromeJSON(
+  const ArrayView<const StepTraceRecord> &records, int threadId,
+  std::ostream &out
+  )
+{
+  // Chrome traces use microseconds relative to an arbitrary origin.
+  const std::streamsize oldPrecision = out.precision(17);
+  bool first = true;
+  for (int i=0 ; i<records.size() ; ++i) {
+    const StepTraceRecord &r = records[i];
+    if (!first)
+      out << ",\n";
+    first = false;
+    const char *phase = ( r.event == STEP_TRACE_TRIAL_STEP ? "B" : "E" );
+    const char *name = "step";
+    out << "{\"name\":\"" << name << "\",\"ph\":\"" << phase
+        << "\",\"pid\":0,\"tid\":" << threadId
+        << ",\"ts\":" << 1.0e6*r.wallTime
+        << ",\"args\":{\"stepIndex\":" << r.stepIndex
+        << ",\"time\":" << r.time
+        << ",\"stepSize\":" << r.stepSize;
+    if (r.event != STEP_TRACE_TRIAL_STEP) {
+      out << ",\"accepted\":"
+          << ( r.event == STEP_TRACE_ACCEPTED_STEP ? "true" : "false" )
+          << ",\"order\":" << r.order
+          << ",\"errorNorm\":" << r.errorNorm
+          << ",\"nonlinearIterations\":" << r.nonlinearIterations;
+    }
+    out << "}}";
+  }
+  out.precision(oldPrecision);
+}
+
+
+} // namespace Rythmos
@@ -0,0 +1,247 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+
+#ifndef RYTHMOS_STEP_TRACE_HPP
+#define RYTHMOS_STEP_TRACE_HPP
+
+#include "Rythmos_Types.hpp"
+#include "Teuchos_Time.hpp"
+#include "Teuchos_Describable.hpp"
+
+#include <cstddef>
+#include <iosfwd>
+
+
+namespace Rythmos {
+
+
+/** \brief Kinds of events recorded in a <tt>StepTraceRing</tt>. */
+enum EStepTraceEvent {
+  STEP_TRACE_TRIAL_STEP = 0,
+  STEP_TRACE_ACCEPTED_STEP = 1,
+  STEP_TRACE_FAILED_STEP = 2
+};
+
+
+/** \brief . */
+inline
+const char* toString(const EStepTraceEvent event)
+{
+  switch(event) {
+    case STEP_TRACE_TRIAL_STEP: return "STEP_TRACE_TRIAL_STEP";
+    case STEP_TRACE_ACCEPTED_STEP: return "STEP_TRACE_ACCEPTED_STEP";
+    case STEP_TRACE_FAILED_STEP: return "STEP_TRACE_FAILED_STEP";
+#ifdef HAVE_RYTHMOS_DEBUG
+    default: TEUCHOS_TEST_FOR_EXCEPT(true);
+#endif
+  }
+  return ""; // Never be called!
+}
+
+
+/** \brief One fixed size binary record of a step event.
+ *
+ * For a trial step, <tt>time</tt> is the time at the start of the step and
+ * <tt>stepSize</tt> the requested step size.  For accepted and failed steps
+ * they are the time reached and the step size taken as reported by the
+ * stepper.  Fields that the stepper does not provide are set to -1.
+ */
+struct StepTraceRecord {
+  /** \brief Wall clock time in seconds. */
+  double wallTime;
+  /** \brief . */
+  double time;
+  /** \brief . */
+  double stepSize;
+  /** \brief Local error test value of the step. */
+  double errorNorm;
+  /** \brief Time step index in the integrator. */
+  int stepIndex;
+  /** \brief One of <tt>EStepTraceEvent</tt>. */
+  int event;
+  /** \brief . */
+  int order;
+  /** \brief Nonlinear (Newton) iterations of the step. */
+  int nonlinearIterations;
+};
+
+
+/** \brief Fixed capacity ring buffer of <tt>StepTraceRecord</tt>s.
+ *
+ * The ring is meant to be owned by one integrator, and so by one thread, at
+ * a time.  Recording a step writes one record in place and increments a
+ * counter; there are no locks, no allocations and no formatting on this
+ * path.  Once the ring is full the oldest records are overwritten and
+ * counted as dropped.
+ *
+ * Recording from <tt>DefaultIntegrator</tt> is only compiled in when Rythmos
+ * is configured with <tt>Rythmos_ENABLE_STEP_TRACE=ON</tt>, see
+ * <tt>RYTHMOS_STEP_TRACE</tt>.  The records are written with
+ * <tt>writeStepTrace()</tt> and converted with the StepTraceReader tool.
+ */
+class StepTraceRing : virtual public Teuchos::Describable
+{
+public:
+
+  /** \brief The capacity is rounded up to a power of two. */
+  explicit StepTraceRing(int capacity = 4096, int threadId = 0);
+
+  /** \brief . */
+  int getCapacity() const { return capacity_; }
+
+  /** \brief Id written with the records, e.g. the thread owning the ring. */
+  int getThreadId() const { return threadId_; }
+
+  /** \brief Number of records currently held. */
+  int getNumRecords() const
+    {
+      return ( numRecorded_ < static_cast<std::size_t>(capacity_)
+        ? static_cast<int>(numRecorded_) : capacity_ );
+    }
+
+  /** \brief Number of records overwritten since the last <tt>clear()</tt>.
+   */
+  std::size_t getNumDropped() const
+    { return numRecorded_ - getNumRecords(); }
+
+  /** \brief Record an event. */
+  void record(
+    EStepTraceEvent event, int stepIndex, double time, double stepSize,
+    int order, double errorNorm, int nonlinearIterations
+    )
+    {
+      StepTraceRecord &r = records_[numRecorded_ & mask_];
+      r.wallTime = Teuchos::Time::wallTime();
+      r.time = time;
+      r.stepSize = stepSize;
+      r.errorNorm = errorNorm;
+      r.stepIndex = stepIndex;
+      r.event = event;
+      r.order = order;
+      r.nonlinearIterations = nonlinearIterations;
+      ++numRecorded_;
+    }
+
+  /** \brief Copy out the records held, oldest first. */
+  void getRecords(Array<StepTraceRecord> *records) const;
+
+  /** \brief . */
+  void clear() { numRecorded_ = 0; }
+
+  /** \brief . */
+  std::string description() const;
+
+private:
+
+  int capacity_;
+  int mask_;
+  int threadId_;
+  // Unsigned so that long runs wrap around instead of overflowing; the ring
+  // index only needs the low bits.
+  std::size_t numRecorded_;
+  Array<StepTraceRecord> records_;
+
+};
+
+
+/** \brief Write the records of <tt>ring</tt> in the compact binary trace
+ * format and clear the ring.
+ *
+ * The format is a header with the magic string "RYTHTRC2", the record size,
+ * the thread id, the number of records and the 64 bit number of dropped
+ * records, followed by
+ * the raw records in the byte order of the writing machine.
+ *
+ * \relates StepTraceRing
+ */
+void writeStepTrace(StepTraceRing &ring, std::ostream &out);
+
+
+/** \brief Read one block written with <tt>writeStepTrace()</tt>.
+ *
+ * Returns false at the end of the stream.  The records are appended to
+ * <tt>records</tt>.
+ *
+ * \relates StepTraceRing
+ */
+bool readStepTrace(
+  std::istream &in, int *threadId, std::size_t *numDropped,
+  Array<StepTraceRecord> *records
+  );
+
+
+/** \brief Write records as CSV with a header line.
+ *
+ * \relates StepTraceRing
+ */
+void writeStepTraceCSV(
+  const ArrayView<const StepTraceRecord> &records, int threadId,
+  std::ostream &out, bool writeHeader = true
+  );
+
+
+/** \brief Write records as Chrome trace (about:tracing) JSON events.
+ *
+ * Each trial step opens a duration event that is closed by the accepted or
+ * failed step that follows it, with the step data as arguments.  Only the
+ * events are written, separated by commas, so that blocks from several
+ * threads can be placed in one <tt>traceEvents</tt> array.
+ *
+ * \relates StepTraceRing
+ */
+void writeStepTraceChromeJSON(
+  const ArrayView<const StepTraceRecord> &records, int threadId,
+  std::ostream &out
+  );
+
+
+} // namespace Rythmos
+
+
+/** \brief Record a step event in the <tt>StepTraceRing</tt> pointed to by
+ * <tt>RING</tt>, if not null.
+ *
+ * Expands to nothing unless Rythmos was configured with
+ * <tt>Rythmos_ENABLE_STEP_TRACE=ON</tt>, so that none of the arguments are
+ * evaluated in a default build.
+ */
+#ifdef HAVE_RYTHMOS_STEP_TRACE
+#  define RYTHMOS_STEP_TRACE(RING, EVENT, STEPINDEX, TIME, STEPSIZE, ORDER, \
+     ERRORNORM, NLITERS) \
+  if (RING) { \
+    (RING)->record((EVENT), (STEPINDEX), (TIME), (STEPSIZE), (ORDER), \
+      (ERRORNORM), (NLITERS)); \
+  }
+#else
+#  define RYTHMOS_STEP_TRACE(RING, EVENT, STEPINDEX, TIME, STEPSIZE, ORDER, \
+     ERRORNORM, NLITERS)
+#endif
+
+
+#endif // RYTHMOS_STEP_TRACE_HPP
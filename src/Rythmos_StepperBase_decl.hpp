@@ -290,6 +290,16 @@ public:
    */
   virtual const StepStatus<Scalar> getStepStatus() const = 0;
 
+  /** \brief Get the cumulative work counters for this stepper.
+   *
+   * Like <tt>getStepStatus()</tt>, this function must be essentially free to
+   * call.  The counters accumulate over the lifetime of the stepper and are
+   * not reset by <tt>setInitialCondition()</tt>.
+   *
+   * The default implementation returns all zeros.
+   */
+  virtual StepperPerformanceCounters getPerformanceCounters() const;
+
   /** \brief Set step control data from another stepper.
    *
    * This is used to guarantee that you can re-use Jacobians from one stepper
@@ -84,6 +84,13 @@ void StepperBase<Scalar>::setStepControlData(const StepperBase & /* stepper */)
 }
 
 
+template<class Scalar>
+StepperPerformanceCounters StepperBase<Scalar>::getPerformanceCounters() const
+{
+  return StepperPerformanceCounters();
+}
+
+
 // 
 // Explicit Instantiation macro
 //
@@ -40,6 +40,7 @@
 #include "Rythmos_ForwardEulerStepper.hpp"
 #include "Rythmos_ExplicitRKStepper.hpp"
 #include "Rythmos_ImplicitRKStepper.hpp"
+#include "Rythmos_IMEXRKStepper.hpp"
 #ifdef HAVE_THYRA_ME_POLYNOMIAL
 #  include "Rythmos_ExplicitTaylorPolynomialStepper.hpp"
 #endif // HAVE_THYRA_ME_POLYNOMIAL
@@ -248,6 +249,11 @@ void StepperBuilder<Scalar>::initializeDefaults_()
       "Implicit RK"
       );
 
+  builder_.setObjectFactory(
+      abstractFactoryStd< StepperBase<Scalar>, IMEXRKStepper<Scalar> >(),
+      "IMEX RK"
+      );
+
 #ifdef HAVE_THYRA_ME_POLYNOMIAL
   builder_.setObjectFactory(
       abstractFactoryStd< StepperBase<Scalar>, ExplicitTaylorPolynomialStepper<Scalar> >(),
@@ -35,6 +35,8 @@
 #include "Thyra_ModelEvaluator.hpp"
 #include "Rythmos_InterpolatorBase.hpp"
 #include "Teuchos_ConstNonconstObjectContainer.hpp"
+#include "Thyra_SolveSupportTypes.hpp"
+#include "Thyra_NonlinearSolverBase.hpp"
 
 namespace Rythmos {
 
@@ -137,6 +139,22 @@ template<class Scalar>
       );
 
 
+/** \brief Add the work done by the last nonlinear solve to a set of stepper
+ * performance counters.
+ *
+ * For a <tt>TimeStepNonlinearSolver</tt> the counts are read through
+ * <tt>getNumIterations()</tt>.  For any other solver only the "Number of
+ * Iterations" entry of <tt>solveStatus.extraParameters</tt> is used, if the
+ * solver reports one.  Counts that are not available are left untouched.
+ */
+template<class Scalar>
+void accumulateNonlinearSolveCounters(
+    const Thyra::NonlinearSolverBase<Scalar>& solver,
+    const Thyra::SolveStatus<Scalar>& solveStatus,
+    const Ptr<StepperPerformanceCounters>& counters
+    );
+
+
 } // namespace Rythmos
 
 
@@ -32,6 +32,7 @@
 #include "Rythmos_StepperHelpers_decl.hpp"
 #include "Rythmos_InterpolationBufferHelpers.hpp"
 #include "Rythmos_InterpolatorBaseHelpers.hpp"
+#include "Rythmos_TimeStepNonlinearSolver.hpp"
 #include "Teuchos_Assert.hpp"
 #include "Thyra_AssertOp.hpp"
 #include "Thyra_VectorStdOps.hpp"
@@ -129,19 +130,24 @@ void restart( StepperBase<Scalar> *stepper )
   TEUCHOS_TEST_FOR_EXCEPT(0==stepper);
 #endif // HAVE_RYTHMOS_DEBUG
   typedef Thyra::ModelEvaluatorBase MEB;
-  const Rythmos::StepStatus<double>
+  const Rythmos::StepStatus<Scalar>
     stepStatus = stepper->getStepStatus();
   const RCP<const Thyra::ModelEvaluator<Scalar> >
     model = stepper->getModel();
   // First, copy all of the model's state, including parameter values etc.
-  MEB::InArgs<double> initialCondition = model->createInArgs();
+  MEB::InArgs<Scalar> initialCondition = model->createInArgs();
   initialCondition.setArgs(model->getNominalValues());
-  // Set the current values of the state and time
-  RCP<const Thyra::VectorBase<double> > x, x_dot;
-  Rythmos::get_x_and_x_dot(*stepper,stepStatus.time,&x,&x_dot);
+  // Set the current values of the state and time.  Explicit models do not
+  // take x_dot and explicit steppers do not give it.
+  const bool supportsXDot = initialCondition.supports(MEB::IN_ARG_x_dot);
+  RCP<const Thyra::VectorBase<Scalar> > x, x_dot;
+  Rythmos::get_x_and_x_dot(*stepper,stepStatus.time,&x,
+    supportsXDot ? &x_dot : 0);
   initialCondition.set_x(x);
-  initialCondition.set_x_dot(x_dot);
-  initialCondition.set_t(stepStatus.time);
+  if (supportsXDot && nonnull(x_dot))
+    initialCondition.set_x_dot(x_dot);
+  if (initialCondition.supports(MEB::IN_ARG_t))
+    initialCondition.set_t(stepStatus.time);
   // Set the new initial condition back on the stepper.  This will effectively
   // reset the stepper to think that it is starting over again (which it is).
   stepper->setInitialCondition(initialCondition);
@@ -353,6 +359,33 @@ template<class Scalar>
 }
 
 
+template<class Scalar>
+void accumulateNonlinearSolveCounters(
+    const Thyra::NonlinearSolverBase<Scalar>& solver,
+    const Thyra::SolveStatus<Scalar>& solveStatus,
+    const Ptr<StepperPerformanceCounters>& counters
+    )
+{
+  const TimeStepNonlinearSolver<Scalar>* timeStepSolver =
+    dynamic_cast<const TimeStepNonlinearSolver<Scalar>*>(&solver);
+  if (timeStepSolver != NULL) {
+    // Each Newton iteration performs exactly one evaluation of f and W
+    // followed by one linear solve.
+    const int numIters = timeStepSolver->getNumIterations();
+    counters->numNonlinearIterations += numIters;
+    counters->numResidualEvaluations += numIters;
+    counters->numJacobianEvaluations += numIters;
+    counters->numLinearSolves += numIters;
+    return;
+  }
+  const RCP<const Teuchos::ParameterList> params = solveStatus.extraParameters;
+  if (nonnull(params) && params->isType<int>("Number of Iterations")) {
+    counters->numNonlinearIterations +=
+      params->get<int>("Number of Iterations");
+  }
+}
+
+
 // 
 // Explicit Instantiation macro
 //
@@ -429,6 +462,12 @@ template<class Scalar>
   template void setStepperModel( \
         const Ptr<StepperBase< SCALAR > >& stepper, \
         Teuchos::ConstNonconstObjectContainer<Thyra::ModelEvaluator< SCALAR > >& model \
+        ); \
+  \
+  template void accumulateNonlinearSolveCounters( \
+        const Thyra::NonlinearSolverBase< SCALAR >& solver, \
+        const Thyra::SolveStatus< SCALAR >& solveStatus, \
+        const Ptr<StepperPerformanceCounters>& counters \
         );
 
 } // namespace Rythmos
@@ -0,0 +1,5 @@
+#include "Rythmos_StepperSnapshot_decl.hpp"
+#ifndef HAVE_RYTHMOS_EXPLICIT_INSTANTIATION
+#include "Rythmos_StepperSnapshot_def.hpp"
+#endif
+
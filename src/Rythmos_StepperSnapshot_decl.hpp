@@ -0,0 +1,208 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_STEPPER_SNAPSHOT_DECL_H
+#define Rythmos_STEPPER_SNAPSHOT_DECL_H
+
+#include "Rythmos_StepperBase.hpp"
+
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+
+#include "Thyra_VectorBase.hpp"
+#include "Thyra_ModelEvaluator.hpp"
+
+
+namespace Rythmos {
+
+/** \brief Read-only copy of the state of a stepper at the end of a step.
+ *
+ * <tt>capture()</tt> copies the time range, the step status, the performance
+ * counters and the solution and its time derivative at the end of the
+ * current step of another stepper into storage owned by <tt>*this</tt>.  The
+ * storage is allocated on the first capture and reused by later captures as
+ * long as the solution space does not change, so a set of snapshots can be
+ * kept as a preallocated pool.
+ *
+ * A snapshot can be handed to code that expects a <tt>StepperBase</tt> (for
+ * example an <tt>IntegrationObserverBase</tt>) after the original stepper
+ * has moved on.  Only the state at the end of the step is kept, so
+ * <tt>getPoints()</tt> only accepts <tt>getTimeRange().upper()</tt>, and all
+ * functions that would change the state of a stepper throw.
+ */
+template<class Scalar>
+class StepperSnapshot : virtual public StepperBase<Scalar>
+{
+public:
+
+  /** \brief . */
+  typedef typename Teuchos::ScalarTraits<Scalar>::magnitudeType ScalarMag;
+
+  /** \name Constructors, intializers, Misc. */
+  //@{
+
+  /** \brief . */
+  StepperSnapshot();
+
+  /** \brief Copy the current state of <tt>stepper</tt>.
+   *
+   * <b>Preconditions:</b><ul>
+   * <li><tt>stepper.getStepStatus().stepStatus != STEP_STATUS_UNINITIALIZED</tt>
+   * </ul>
+   */
+  void capture(const StepperBase<Scalar>& stepper);
+
+  /** \brief Returns true once <tt>capture()</tt> has been called. */
+  bool hasSnapshot() const;
+
+  //@}
+
+  /** \name Overridden from StepperBase */
+  //@{
+
+  /** \brief . */
+  void setModel(const RCP<const Thyra::ModelEvaluator<Scalar> >& model);
+
+  /** \brief . */
+  void setNonconstModel(const RCP<Thyra::ModelEvaluator<Scalar> >& model);
+
+  /** \brief Returns the model of the captured stepper. */
+  RCP<const Thyra::ModelEvaluator<Scalar> > getModel() const;
+
+  /** \brief Throws, a snapshot does not give access to a nonconst model. */
+  RCP<Thyra::ModelEvaluator<Scalar> > getNonconstModel();
+
+  /** \brief . */
+  void setInitialCondition(
+    const Thyra::ModelEvaluatorBase::InArgs<Scalar> &initialCondition
+    );
+
+  /** \brief . */
+  Thyra::ModelEvaluatorBase::InArgs<Scalar> getInitialCondition() const;
+
+  /** \brief Throws, a snapshot can not be stepped. */
+  Scalar takeStep(Scalar dt, StepSizeType flag);
+
+  /** \brief . */
+  const StepStatus<Scalar> getStepStatus() const;
+
+  /** \brief Returns the counters of the captured stepper. */
+  StepperPerformanceCounters getPerformanceCounters() const;
+
+  //@}
+
+  /** \name Overridden from InterpolationBufferBase */
+  //@{
+
+  /** \brief . */
+  RCP<const Thyra::VectorSpaceBase<Scalar> > get_x_space() const;
+
+  /** \brief . */
+  void addPoints(
+    const Array<Scalar>& time_vec,
+    const Array<RCP<const Thyra::VectorBase<Scalar> > >& x_vec,
+    const Array<RCP<const Thyra::VectorBase<Scalar> > >& xdot_vec
+    );
+
+  /** \brief . */
+  TimeRange<Scalar> getTimeRange() const;
+
+  /** \brief Only <tt>time_vec[i] == getTimeRange().upper()</tt> is
+   * supported. */
+  void getPoints(
+    const Array<Scalar>& time_vec,
+    Array<RCP<const Thyra::VectorBase<Scalar> > >* x_vec,
+    Array<RCP<const Thyra::VectorBase<Scalar> > >* xdot_vec,
+    Array<ScalarMag>* accuracy_vec
+    ) const;
+
+  /** \brief . */
+  void getNodes(Array<Scalar>* time_vec) const;
+
+  /** \brief . */
+  void removeNodes(Array<Scalar>& time_vec);
+
+  /** \brief . */
+  int getOrder() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::ParameterListAcceptor */
+  //@{
+
+  /** \brief . */
+  void setParameterList(RCP<ParameterList> const& paramList);
+
+  /** \brief . */
+  RCP<ParameterList> getNonconstParameterList();
+
+  /** \brief . */
+  RCP<ParameterList> unsetParameterList();
+
+  /** \brief . */
+  RCP<const ParameterList> getValidParameters() const;
+
+  //@}
+
+  /** \name Overridden from Teuchos::Describable */
+  //@{
+
+  /** \brief . */
+  std::string description() const;
+
+  //@}
+
+private:
+
+  // ///////////////////////
+  // Private date members
+
+  bool hasSnapshot_;
+  RCP<const Thyra::ModelEvaluator<Scalar> > model_;
+  RCP<Thyra::VectorBase<Scalar> > x_;
+  RCP<Thyra::VectorBase<Scalar> > x_dot_;
+  bool haveXDot_;
+  TimeRange<Scalar> timeRange_;
+  StepStatus<Scalar> stepStatus_;
+  StepperPerformanceCounters counters_;
+
+  RCP<ParameterList> parameterList_;
+
+};
+
+
+/** \brief Nonmember constructor.
+ *
+ * \relates StepperSnapshot
+ */
+template<class Scalar>
+RCP<StepperSnapshot<Scalar> > stepperSnapshot();
+
+
+} // namespace Rythmos
+
+#endif //Rythmos_STEPPER_SNAPSHOT_DECL_H
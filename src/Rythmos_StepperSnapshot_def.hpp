@@ -0,0 +1,376 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_STEPPER_SNAPSHOT_DEF_H
+#define Rythmos_STEPPER_SNAPSHOT_DEF_H
+
+#include "Rythmos_StepperSnapshot_decl.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+#include "Teuchos_as.hpp"
+
+namespace Rythmos {
+
+// ////////////////////////////
+// Defintions
+
+// Nonmember constructors
+template<class Scalar>
+RCP<StepperSnapshot<Scalar> > stepperSnapshot()
+{
+  RCP<StepperSnapshot<Scalar> >
+    snapshot = Teuchos::rcp(new StepperSnapshot<Scalar>());
+  return snapshot;
+}
+
+
+// Constructors, intializers, Misc.
+
+
+template<class Scalar>
+StepperSnapshot<Scalar>::StepperSnapshot()
+  :hasSnapshot_(false),
+   haveXDot_(false)
+{}
+
+
+template<class Scalar>
+void StepperSnapshot<Scalar>::capture(const StepperBase<Scalar>& stepper)
+{
+  const StepStatus<Scalar> stepStatus = stepper.getStepStatus();
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    stepStatus.stepStatus == STEP_STATUS_UNINITIALIZED, std::logic_error,
+    "Error, StepperSnapshot::capture(...):  The stepper \""
+    << stepper.description() << "\" has not been initialized!"
+    );
+
+  model_ = stepper.getModel();
+  timeRange_ = stepper.getTimeRange();
+
+  // Use the vectors exposed through the step status when the stepper gives
+  // them since this does not allocate anything.
+  RCP<const Thyra::VectorBase<Scalar> >
+    x = stepStatus.solution,
+    x_dot = stepStatus.solutionDot;
+  if (is_null(x) && timeRange_.isValid()) {
+    Array<Scalar> time_vec(1,timeRange_.upper());
+    Array<RCP<const Thyra::VectorBase<Scalar> > > x_vec, xdot_vec;
+    stepper.getPoints(time_vec,&x_vec,&xdot_vec,NULL);
+    x = x_vec[0];
+    x_dot = xdot_vec[0];
+  }
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    is_null(x), std::logic_error,
+    "Error, StepperSnapshot::capture(...):  The stepper \""
+    << stepper.description() << "\" did not give a solution!"
+    );
+
+  if (is_null(x_) || !x_->space()->isCompatible(*x->space())) {
+    x_ = Thyra::createMember(x->space());
+    x_dot_ = Thyra::createMember(x->space());
+  }
+  Thyra::V_V(x_.ptr(),*x);
+  haveXDot_ = nonnull(x_dot);
+  if (haveXDot_) {
+    Thyra::V_V(x_dot_.ptr(),*x_dot);
+  }
+
+  stepStatus_ = stepStatus;
+  stepStatus_.solution = x_;
+  stepStatus_.solutionDot = ( haveXDot_ ? x_dot_ : Teuchos::null );
+  stepStatus_.residual = Teuchos::null;
+  counters_ = stepper.getPerformanceCounters();
+  hasSnapshot_ = true;
+}
+
+
+template<class Scalar>
+bool StepperSnapshot<Scalar>::hasSnapshot() const
+{
+  return hasSnapshot_;
+}
+
+
+// Overridden from StepperBase
+
+
+template<class Scalar>
+void StepperSnapshot<Scalar>::setModel(
+  const RCP<const Thyra::ModelEvaluator<Scalar> >& /* model */
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION( true, std::logic_error,
+    "Error, the model of a StepperSnapshot can not be set!" );
+}
+
+
+template<class Scalar>
+void StepperSnapshot<Scalar>::setNonconstModel(
+  const RCP<Thyra::ModelEvaluator<Scalar> >& /* model */
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION( true, std::logic_error,
+    "Error, the model of a StepperSnapshot can not be set!" );
+}
+
+
+template<class Scalar>
+RCP<const Thyra::ModelEvaluator<Scalar> >
+StepperSnapshot<Scalar>::getModel() const
+{
+  return model_;
+}
+
+
+template<class Scalar>
+RCP<Thyra::ModelEvaluator<Scalar> >
+StepperSnapshot<Scalar>::getNonconstModel()
+{
+  TEUCHOS_TEST_FOR_EXCEPTION( true, std::logic_error,
+    "Error, a StepperSnapshot does not give access to a nonconst model!" );
+  return Teuchos::null;
+}
+
+
+template<class Scalar>
+void StepperSnapshot<Scalar>::setInitialCondition(
+  const Thyra::ModelEvaluatorBase::InArgs<Scalar> & /* initialCondition */
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION( true, std::logic_error,
+    "Error, the initial condition of a StepperSnapshot can not be set!" );
+}
+
+
+template<class Scalar>
+Thyra::ModelEvaluatorBase::InArgs<Scalar>
+StepperSnapshot<Scalar>::getInitialCondition() const
+{
+  TEUCHOS_TEST_FOR_EXCEPTION( true, std::logic_error,
+    "Error, a StepperSnapshot does not keep the initial condition!" );
+  return Thyra::ModelEvaluatorBase::InArgs<Scalar>();
+}
+
+
+template<class Scalar>
+Scalar StepperSnapshot<Scalar>::takeStep(
+  Scalar /* dt */, StepSizeType /* stepSizeType */
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION( true, std::logic_error,
+    "Error, a StepperSnapshot can not take a step!" );
+  return Scalar(-ScalarTraits<Scalar>::one());
+}
+
+
+template<class Scalar>
+const StepStatus<Scalar> StepperSnapshot<Scalar>::getStepStatus() const
+{
+  if (!hasSnapshot_) {
+    StepStatus<Scalar> stepStatus;
+    stepStatus.stepStatus = STEP_STATUS_UNINITIALIZED;
+    return stepStatus;
+  }
+  return stepStatus_;
+}
+
+
+template<class Scalar>
+StepperPerformanceCounters
+StepperSnapshot<Scalar>::getPerformanceCounters() const
+{
+  return counters_;
+}
+
+
+// Overridden from InterpolationBufferBase
+
+
+template<class Scalar>
+RCP<const Thyra::VectorSpaceBase<Scalar> >
+StepperSnapshot<Scalar>::get_x_space() const
+{
+  if (is_null(x_)) {
+    return Teuchos::null;
+  }
+  return x_->space();
+}
+
+
+template<class Scalar>
+void StepperSnapshot<Scalar>::addPoints(
+  const Array<Scalar>& /* time_vec */,
+  const Array<RCP<const Thyra::VectorBase<Scalar> > >& /* x_vec */,
+  const Array<RCP<const Thyra::VectorBase<Scalar> > >& /* xdot_vec */
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPTION( true, std::logic_error,
+    "Error, addPoints is not supported by StepperSnapshot!" );
+}
+
+
+template<class Scalar>
+TimeRange<Scalar> StepperSnapshot<Scalar>::getTimeRange() const
+{
+  return timeRange_;
+}
+
+
+template<class Scalar>
+void StepperSnapshot<Scalar>::getPoints(
+  const Array<Scalar>& time_vec,
+  Array<RCP<const Thyra::VectorBase<Scalar> > >* x_vec,
+  Array<RCP<const Thyra::VectorBase<Scalar> > >* xdot_vec,
+  Array<ScalarMag>* accuracy_vec
+  ) const
+{
+  TEUCHOS_TEST_FOR_EXCEPTION( !hasSnapshot_, std::logic_error,
+    "Error, getPoints called on an empty StepperSnapshot!" );
+  if (x_vec)
+    x_vec->clear();
+  if (xdot_vec)
+    xdot_vec->clear();
+  if (accuracy_vec)
+    accuracy_vec->clear();
+  for (int i=0 ; i<Teuchos::as<int>(time_vec.size()) ; ++i) {
+    TEUCHOS_TEST_FOR_EXCEPTION(
+      compareTimeValues(time_vec[i],timeRange_.upper()) != 0,
+      std::logic_error,
+      "Error, StepperSnapshot::getPoints(...):  time_vec["<<i<<"] = "
+      << time_vec[i] << " is not the end of the captured step t = "
+      << timeRange_.upper() << "!"
+      );
+    if (x_vec)
+      x_vec->push_back(x_->clone_v());
+    if (xdot_vec)
+      xdot_vec->push_back(
+        haveXDot_ ? x_dot_->clone_v() : Teuchos::null );
+    if (accuracy_vec)
+      accuracy_vec->push_back(ScalarTraits<ScalarMag>::zero());
+  }
+}
+
+
+template<class Scalar>
+void StepperSnapshot<Scalar>::getNodes(Array<Scalar>* time_vec) const
+{
+  TEUCHOS_ASSERT( time_vec != NULL );
+  time_vec->clear();
+  if (hasSnapshot_) {
+    time_vec->push_back(timeRange_.upper());
+  }
+}
+
+
+template<class Scalar>
+void StepperSnapshot<Scalar>::removeNodes(Array<Scalar>& /* time_vec */)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION( true, std::logic_error,
+    "Error, removeNodes is not supported by StepperSnapshot!" );
+}
+
+
+template<class Scalar>
+int StepperSnapshot<Scalar>::getOrder() const
+{
+  return stepStatus_.order;
+}
+
+
+// Overridden from Teuchos::ParameterListAcceptor
+
+
+template <class Scalar>
+void StepperSnapshot<Scalar>::setParameterList(
+  RCP<ParameterList> const& paramList
+  )
+{
+  TEUCHOS_TEST_FOR_EXCEPT(is_null(paramList));
+  paramList->validateParametersAndSetDefaults(*this->getValidParameters());
+  parameterList_ = paramList;
+  Teuchos::readVerboseObjectSublist(&*parameterList_,this);
+}
+
+
+template <class Scalar>
+RCP<ParameterList> StepperSnapshot<Scalar>::getNonconstParameterList()
+{
+  return parameterList_;
+}
+
+
+template <class Scalar>
+RCP<ParameterList> StepperSnapshot<Scalar>::unsetParameterList()
+{
+  RCP<ParameterList> temp_param_list = parameterList_;
+  parameterList_ = Teuchos::null;
+  return temp_param_list;
+}
+
+
+template<class Scalar>
+RCP<const ParameterList> StepperSnapshot<Scalar>::getValidParameters() const
+{
+  static RCP<const ParameterList> validPL;
+  if (is_null(validPL)) {
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    Teuchos::setupVerboseObjectSublist(&*pl);
+    validPL = pl;
+  }
+  return validPL;
+}
+
+
+// Overridden from Teuchos::Describable
+
+
+template<class Scalar>
+std::string StepperSnapshot<Scalar>::description() const
+{
+  return "Rythmos::StepperSnapshot";
+}
+
+
+//
+// Explicit Instantiation macro
+//
+// Must be expanded from within the Rythmos namespace!
+//
+
+#define RYTHMOS_STEPPER_SNAPSHOT_INSTANT(SCALAR) \
+  \
+  template class StepperSnapshot< SCALAR >; \
+  \
+  template RCP< StepperSnapshot< SCALAR > > \
+  stepperSnapshot(); \
+
+
+} // namespace Rythmos
+
+
+#endif //Rythmos_STEPPER_SNAPSHOT_DEF_H
@@ -210,6 +210,62 @@ std::ostream& operator<<( std::ostream& out_arg, const StepStatus<Scalar> &stepS
   return out_arg;
 }
 
+
+/** \brief Cumulative work counters reported by a stepper.
+ *
+ * All counts are accumulated over the lifetime of the stepper object and
+ * include work spent on attempted steps that were later rejected.  Counts
+ * that a stepper cannot observe (e.g. nonlinear iterations from a solver that
+ * does not report them) are left at zero.
+ */
+struct StepperPerformanceCounters {
+  /** \brief Number of accepted steps. */
+  int numSteps;
+  /** \brief Number of evaluations of the model residual f. */
+  int numResidualEvaluations;
+  /** \brief Number of evaluations of the model Jacobian W. */
+  int numJacobianEvaluations;
+  /** \brief Number of linear solves with W. */
+  int numLinearSolves;
+  /** \brief Number of nonlinear solver iterations. */
+  int numNonlinearIterations;
+  /** \brief Number of rejected step attempts. */
+  int numRejectedSteps;
+  /** \brief Number of changes in the method order. */
+  int numOrderChanges;
+  /** \brief . */
+  StepperPerformanceCounters()
+    :numSteps(0)
+     ,numResidualEvaluations(0)
+     ,numJacobianEvaluations(0)
+     ,numLinearSolves(0)
+     ,numNonlinearIterations(0)
+     ,numRejectedSteps(0)
+     ,numOrderChanges(0)
+    {}
+};
+
+
+/** \brief . */
+inline
+std::ostream& operator<<( std::ostream& out_arg,
+  const StepperPerformanceCounters &counters )
+{
+  using std::endl;
+  RCP<Teuchos::FancyOStream>
+    out = Teuchos::getFancyOStream(Teuchos::rcp(&out_arg,false));
+  Teuchos::OSTab tab(out);
+  *out
+    << "numSteps = " << counters.numSteps << endl
+    << "numResidualEvaluations = " << counters.numResidualEvaluations << endl
+    << "numJacobianEvaluations = " << counters.numJacobianEvaluations << endl
+    << "numLinearSolves = " << counters.numLinearSolves << endl
+    << "numNonlinearIterations = " << counters.numNonlinearIterations << endl
+    << "numRejectedSteps = " << counters.numRejectedSteps << endl
+    << "numOrderChanges = " << counters.numOrderChanges << endl;
+  return out_arg;
+}
+
 } // namespace Rythmos
 
 #endif // Rythmos_STEPPER_SUPPORT_TYPES_H
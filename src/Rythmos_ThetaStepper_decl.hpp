@@ -171,6 +171,9 @@ public:
   
   /** \brief . */
   const StepStatus<Scalar> getStepStatus() const;
+
+  /** \brief . */
+  StepperPerformanceCounters getPerformanceCounters() const;
   
   //@}
 
@@ -265,6 +268,7 @@ private:
   Scalar dt_;
   Scalar dt_old_;
   int numSteps_;
+  StepperPerformanceCounters perfCounters_;
 
   ThetaStepperType thetaStepperType_;
   Scalar theta_;
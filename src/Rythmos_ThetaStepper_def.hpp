@@ -519,6 +519,8 @@ Scalar ThetaStepper<Scalar>::takeStep(Scalar dt, StepSizeType stepSizeType)
 
   Thyra::SolveStatus<Scalar>
     neSolveStatus = solver_->solve(&*x_);
+  accumulateNonlinearSolveCounters(*solver_, neSolveStatus,
+    Teuchos::outArg(perfCounters_));
 
   // In the above solve, on input *x_ is the old value of x for the previous
   // time step which is used as the initial guess for the solver.  On output,
@@ -553,6 +555,7 @@ Scalar ThetaStepper<Scalar>::takeStep(Scalar dt, StepSizeType stepSizeType)
   t_ += dt;
 
   numSteps_++;
+  ++perfCounters_.numSteps;
 
   if ( as<int>(verbLevel) >= as<int>(Teuchos::VERB_HIGH) ) {
     *out << "\nt_old_ = " << t_old_ << std::endl;
@@ -644,6 +647,13 @@ const StepStatus<Scalar> ThetaStepper<Scalar>::getStepStatus() const
 
 }
 
+template<class Scalar>
+StepperPerformanceCounters
+ThetaStepper<Scalar>::getPerformanceCounters() const
+{
+  return perfCounters_;
+}
+
 
 // Overridden from InterpolationBufferBase
 
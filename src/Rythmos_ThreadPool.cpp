@@ -0,0 +1,137 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Rythmos_ThreadPool.hpp"
+
+#ifdef HAVE_RYTHMOS_THREADS
+
+#include "Teuchos_Assert.hpp"
+
+
+namespace Rythmos {
+
+
+ThreadPool::ThreadPool(const int numThreads)
+  :numThreads_(numThreads),
+   task_(0),
+   generation_(0),
+   numBusy_(0),
+   shutdown_(false)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(
+    numThreads < 1, std::logic_error,
+    "Error, ThreadPool needs at least one thread, not " << numThreads << "!"
+    );
+  exceptions_.resize(numThreads);
+  workers_.reserve(numThreads-1);
+  for (int i = 1; i < numThreads; ++i)
+    workers_.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+}
+
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  startCond_.notify_all();
+  for (int i = 0; i < static_cast<int>(workers_.size()); ++i)
+    workers_[i].join();
+}
+
+
+int ThreadPool::getNumThreads() const
+{
+  return numThreads_;
+}
+
+
+void ThreadPool::run(const std::function<void(int)> &task)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    numBusy_ = numThreads_ - 1;
+    ++generation_;
+  }
+  startCond_.notify_all();
+  runTask(0);
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCond_.wait(lock, [this]{ return numBusy_ == 0; });
+    task_ = 0;
+  }
+  for (int i = 0; i < numThreads_; ++i) {
+    if (exceptions_[i]) {
+      std::exception_ptr exception = exceptions_[i];
+      exceptions_.assign(numThreads_, std::exception_ptr());
+      std::rethrow_exception(exception);
+    }
+  }
+}
+
+
+void ThreadPool::workerLoop(const int threadIndex)
+{
+  timeMonitorSuppressedOnThisThread() = true;
+  int lastGeneration = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      startCond_.wait(lock,
+        [this, lastGeneration]{ return shutdown_ || generation_ != lastGeneration; });
+      if (shutdown_)
+        return;
+      lastGeneration = generation_;
+    }
+    runTask(threadIndex);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--numBusy_ == 0)
+        doneCond_.notify_one();
+    }
+  }
+}
+
+
+void ThreadPool::runTask(const int threadIndex)
+{
+  try {
+    (*task_)(threadIndex);
+  }
+  catch (...) {
+    exceptions_[threadIndex] = std::current_exception();
+  }
+}
+
+
+} // namespace Rythmos
+
+
+#endif // HAVE_RYTHMOS_THREADS
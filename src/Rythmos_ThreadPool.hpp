@@ -0,0 +1,113 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef RYTHMOS_THREAD_POOL_HPP
+#define RYTHMOS_THREAD_POOL_HPP
+
+#include "Rythmos_ConfigDefs.h"
+
+#ifdef HAVE_RYTHMOS_THREADS
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace Rythmos {
+
+
+/** \brief Fixed set of threads that run one task per thread.
+ *
+ * <tt>run(task)</tt> calls <tt>task(i)</tt> for each thread index <tt>i</tt>
+ * in <tt>[0,getNumThreads())</tt> and returns once all of them are done.
+ * Index 0 runs on the calling thread and the others on worker threads that
+ * are started by the constructor and wait between runs, so a pool that is
+ * kept around makes repeated runs cheap.  If tasks throw, the exception of
+ * the lowest thread index is rethrown by <tt>run()</tt> after all tasks have
+ * finished.
+ *
+ * The timers of <tt>RYTHMOS_FUNC_TIME_MONITOR</tt> are skipped on the worker
+ * threads (see <tt>timeMonitorSuppressedOnThisThread()</tt>), so with the
+ * Teuchos time monitor enabled only the share of the work done on the
+ * calling thread is timed.  Teuchos timers started outside of Rythmos, e.g.
+ * by a linear solver, are not covered by this.
+ *
+ * This is only there with thread support (<tt>HAVE_RYTHMOS_THREADS</tt>).
+ */
+class ThreadPool {
+public:
+
+  /** \brief Start <tt>numThreads-1</tt> worker threads. */
+  explicit ThreadPool(const int numThreads);
+
+  /** \brief Stops and joins the worker threads. */
+  ~ThreadPool();
+
+  /** \brief . */
+  int getNumThreads() const;
+
+  /** \brief Run <tt>task(i)</tt> on each thread <tt>i</tt> and wait for all
+   * of them.
+   *
+   * Must not be called from one of the tasks.
+   */
+  void run(const std::function<void(int)> &task);
+
+private:
+
+  int numThreads_;
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable startCond_;
+  std::condition_variable doneCond_;
+  const std::function<void(int)> *task_;
+  int generation_;
+  int numBusy_;
+  bool shutdown_;
+  std::vector<std::exception_ptr> exceptions_;
+
+  void workerLoop(const int threadIndex);
+  void runTask(const int threadIndex);
+
+  // Not defined and not to be called
+  ThreadPool(const ThreadPool&);
+  ThreadPool& operator=(const ThreadPool&);
+
+};
+
+
+} // namespace Rythmos
+
+
+#endif // HAVE_RYTHMOS_THREADS
+
+
+#endif // RYTHMOS_THREAD_POOL_HPP
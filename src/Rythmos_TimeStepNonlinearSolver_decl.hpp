@@ -115,6 +115,28 @@ public:
 
   //@}
 
+  /** @name Work counters */
+  //@{
+
+  /** \brief Return the number of Newton iterations taken by the last call
+   * to <tt>solve()</tt>.
+   *
+   * Each iteration performs exactly one residual evaluation, one Jacobian
+   * evaluation and one linear solve.
+   */
+  int getNumIterations() const;
+
+  //@}
+
+  /** \brief Give up the current W to the caller.
+   *
+   * Returns the W of the solver, or null if there is none, and forgets it,
+   * so that the next <tt>solve()</tt> creates and factors a new W instead
+   * of overwriting the returned one.  Use this to keep the factored W of
+   * several solves, e.g. after <tt>get_nonconst_W(true)</tt>.
+   */
+  RCP<Thyra::LinearOpWithSolveBase<Scalar> > release_W();
+
 private:
 
   // private object data members
@@ -124,6 +146,7 @@ private:
   RCP<Thyra::LinearOpWithSolveBase<Scalar> > J_;
   RCP<Thyra::VectorBase<Scalar> > current_x_;
   bool J_is_current_;
+  int numIterations_;
 
   double defaultTol_;
   int defaultMaxIters_;
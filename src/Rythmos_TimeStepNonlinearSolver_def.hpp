@@ -110,6 +110,7 @@ TimeStepNonlinearSolver<Scalar>::ThrownOnLinearSolveFailure_default_ = false;
 template <class Scalar>
 TimeStepNonlinearSolver<Scalar>::TimeStepNonlinearSolver()
   :J_is_current_(false),
+   numIterations_(0),
    defaultTol_(DefaultTol_default_),
    defaultMaxIters_(DefaultMaxIters_default_),
    nonlinearSafetyFactor_(NonlinearSafetyFactor_default_),
@@ -448,6 +449,10 @@ TimeStepNonlinearSolver<Scalar>::solve(
 
   solveStatus.message = oss.str();
 
+  // Record the work done so that steppers can accumulate performance
+  // counters through getNumIterations().
+  numIterations_ = std::min(iter,maxIters);
+
   // Update the solution state for external clients
   current_x_ = x->clone_v();
   J_is_current_ = false;
@@ -538,6 +543,27 @@ void TimeStepNonlinearSolver<Scalar>::set_W_is_current(bool W_is_current)
 }
 
 
+// Work counters
+
+
+template <class Scalar>
+int TimeStepNonlinearSolver<Scalar>::getNumIterations() const
+{
+  return numIterations_;
+}
+
+
+template <class Scalar>
+RCP<Thyra::LinearOpWithSolveBase<Scalar> >
+TimeStepNonlinearSolver<Scalar>::release_W()
+{
+  RCP<Thyra::LinearOpWithSolveBase<Scalar> > W = J_;
+  J_ = Teuchos::null;
+  J_is_current_ = false;
+  return W;
+}
+
+
 } // namespace Rythmos
 
 
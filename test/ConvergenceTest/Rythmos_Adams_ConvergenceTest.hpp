@@ -0,0 +1,82 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef Rythmos_ADAMS_CONVERGENCETEST_H
+#define Rythmos_ADAMS_CONVERGENCETEST_H
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_ConvergenceTestHelpers.hpp"
+#include "Rythmos_AdamsStepper.hpp"
+
+namespace Rythmos {
+
+template<class Scalar>
+class AdamsStepperFactory : public virtual StepperFactoryBase<Scalar>
+{
+  public:
+    AdamsStepperFactory(RCP<ModelFactoryBase<Scalar> > modelFactory) 
+    { 
+      modelFactory_ = modelFactory;
+      order_ = 1; 
+    }
+    virtual ~AdamsStepperFactory() {}
+    void setOrder(int order) { order_ = order; }
+    int maxOrder() { return 2; } // Same start-up limitation as ImplicitBDF
+    RCP<StepperBase<Scalar> > getStepper() const 
+    { 
+      RCP<ModelEvaluator<Scalar> > model = modelFactory_->getModel();
+      Thyra::ModelEvaluatorBase::InArgs<Scalar> model_ic = model->getNominalValues();
+      RCP<AdamsStepper<Scalar> > stepper = adamsStepper<Scalar>(model);
+      RCP<ParameterList> adamsPL = Teuchos::parameterList();
+      adamsPL->set("Minimum Order",order_);
+      adamsPL->set("Maximum Order",order_);
+      Teuchos::ParameterList& voPL = adamsPL->sublist("VerboseObject");
+      voPL.set("Verbosity Level","none");
+      stepper->setParameterList(adamsPL);
+      stepper->setInitialCondition(model_ic);
+      return stepper;
+    }
+  private:
+    RCP<ModelFactoryBase<Scalar> > modelFactory_;
+    int order_;
+};
+// non-member constructor
+template<class Scalar>
+RCP<AdamsStepperFactory<Scalar> > adamsStepperFactory(
+    RCP<ModelFactoryBase<Scalar> > modelFactory)
+{
+  RCP<AdamsStepperFactory<Scalar> > adamsFactory = Teuchos::rcp(
+      new AdamsStepperFactory<Scalar>(modelFactory)
+      );
+  return adamsFactory;
+}
+
+} // namespace Rythmos 
+
+#endif // Rythmos_ADAMS_CONVERGENCETEST_H
+
@@ -0,0 +1,418 @@
+//@HEADER
+
+// ***********************************************************************
+//
+//                     Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "DampedOscillatorModel.hpp"
+
+#include "Teuchos_StandardParameterEntryValidators.hpp"
+
+#include "Thyra_DefaultSpmdVectorSpace.hpp"
+#include "Thyra_DetachedVectorView.hpp"
+#include "Thyra_DetachedMultiVectorView.hpp"
+#include "Thyra_DefaultSerialDenseLinearOpWithSolveFactory.hpp"
+#include "Thyra_DefaultMultiVectorLinearOpWithSolve.hpp"
+#include "Thyra_DefaultLinearOpSource.hpp"
+#include "Thyra_VectorStdOps.hpp"
+
+namespace {
+  const std::string Implicit_name = "Implicit model formulation";
+  const bool Implicit_default = false;
+
+  const std::string IncludeDamping_name = "Include damping term";
+  const bool IncludeDamping_default = true;
+
+  const std::string IncludeRotation_name = "Include rotation term";
+  const bool IncludeRotation_default = true;
+
+  const std::string Coeff_lambda_name = "Coeff lambda";
+  const double Coeff_lambda_default = -10.0;
+
+  const std::string Coeff_omega_name = "Coeff omega";
+  const double Coeff_omega_default = 1.0;
+
+  const std::string IC_x0_name = "IC x_0";
+  const double IC_x0_default = 1.0;
+
+  const std::string IC_x1_name = "IC x_1";
+  const double IC_x1_default = 0.0;
+
+  const std::string IC_t0_name = "IC t_0";
+  const double IC_t0_default = 0.0;
+
+} // namespace
+
+namespace Rythmos {
+
+// non-member Constructor
+RCP<DampedOscillatorModel> dampedOscillatorModel()
+{
+  RCP<DampedOscillatorModel> model = rcp(new DampedOscillatorModel);
+  return(model);
+}
+
+// non-member Constructor
+RCP<DampedOscillatorModel> dampedOscillatorModel(bool implicit)
+{
+  RCP<DampedOscillatorModel> model = dampedOscillatorModel();
+  model->setImplicitFlag(implicit);
+  return(model);
+}
+
+// non-member Constructor
+RCP<DampedOscillatorModel> dampedOscillatorModel(
+  bool implicit, bool includeDamping, bool includeRotation)
+{
+  RCP<DampedOscillatorModel> model = dampedOscillatorModel();
+  model->setTerms(includeDamping,includeRotation);
+  model->setImplicitFlag(implicit);
+  return(model);
+}
+
+// Constructor
+DampedOscillatorModel::DampedOscillatorModel()
+{
+  isInitialized_ = false;
+  dim_ = 2;
+  isImplicit_ = Implicit_default;
+  includeDamping_ = IncludeDamping_default;
+  includeRotation_ = IncludeRotation_default;
+  lambda_ = Coeff_lambda_default;
+  omega_ = Coeff_omega_default;
+  x0_ic_ = IC_x0_default;
+  x1_ic_ = IC_x1_default;
+  t0_ic_ = IC_t0_default;
+
+  // Create x_space and f_space
+  x_space_ = Thyra::defaultSpmdVectorSpace<double>(dim_);
+  f_space_ = Thyra::defaultSpmdVectorSpace<double>(dim_);
+}
+
+void DampedOscillatorModel::setImplicitFlag(bool implicit)
+{
+  if (isImplicit_ != implicit) {
+    isInitialized_ = false;
+  }
+  isImplicit_ = implicit;
+  setupInOutArgs_();
+}
+
+void DampedOscillatorModel::setTerms(bool includeDamping, bool includeRotation)
+{
+  includeDamping_ = includeDamping;
+  includeRotation_ = includeRotation;
+  // The nominal x_dot depends on the selected terms
+  isInitialized_ = false;
+  setupInOutArgs_();
+}
+
+ModelEvaluatorBase::InArgs<double>
+DampedOscillatorModel::getExactSolution(double t) const
+{
+  TEUCHOS_TEST_FOR_EXCEPTION( !isInitialized_, std::logic_error,
+      "Error, setImplicitFlag must be called first!\n"
+      );
+  ModelEvaluatorBase::InArgs<double> inArgs = inArgs_;
+  inArgs.set_t(t);
+  const double tau = t-t0_ic_;
+  const double e = exp(lambda_*tau);
+  const double c = cos(omega_*tau);
+  const double s = sin(omega_*tau);
+  const double x0 = e*(c*x0_ic_ - s*x1_ic_);
+  const double x1 = e*(s*x0_ic_ + c*x1_ic_);
+  RCP<VectorBase<double> > exact_x = createMember(x_space_);
+  { // scope to delete DetachedVectorView
+    Thyra::DetachedVectorView<double> exact_x_view(*exact_x);
+    exact_x_view[0] = x0;
+    exact_x_view[1] = x1;
+  }
+  inArgs.set_x(exact_x);
+  if (isImplicit_) {
+    RCP<VectorBase<double> > exact_x_dot = createMember(x_space_);
+    { // scope to delete DetachedVectorView
+      Thyra::DetachedVectorView<double> exact_x_dot_view(*exact_x_dot);
+      exact_x_dot_view[0] = lambda_*x0 - omega_*x1;
+      exact_x_dot_view[1] = lambda_*x1 + omega_*x0;
+    }
+    inArgs.set_x_dot(exact_x_dot);
+  }
+  return(inArgs);
+}
+
+RCP<const Thyra::VectorSpaceBase<double> >
+DampedOscillatorModel::get_x_space() const
+{
+  return x_space_;
+}
+
+
+RCP<const Thyra::VectorSpaceBase<double> >
+DampedOscillatorModel::get_f_space() const
+{
+  return f_space_;
+}
+
+
+ModelEvaluatorBase::InArgs<double>
+DampedOscillatorModel::getNominalValues() const
+{
+  TEUCHOS_TEST_FOR_EXCEPTION( !isInitialized_, std::logic_error,
+      "Error, setImplicitFlag must be called first!\n"
+      );
+  return nominalValues_;
+}
+
+
+RCP<Thyra::LinearOpWithSolveBase<double> >
+DampedOscillatorModel::create_W() const
+{
+  RCP<const Thyra::LinearOpWithSolveFactoryBase<double> > W_factory = this->get_W_factory();
+  RCP<Thyra::LinearOpBase<double> > matrix = this->create_W_op();
+  {
+    // Provide a full rank matrix to linearOpWithSolve, which factors the
+    // matrix during initialization (see SinCosModel::create_W()).
+    RCP<Thyra::MultiVectorBase<double> > multivec = Teuchos::rcp_dynamic_cast<Thyra::MultiVectorBase<double> >(matrix,true);
+    Thyra::DetachedMultiVectorView<double> matrix_view( *multivec );
+    matrix_view(0,0) = 1.0;
+    matrix_view(0,1) = 0.0;
+    matrix_view(1,0) = 0.0;
+    matrix_view(1,1) = 1.0;
+  }
+  RCP<Thyra::LinearOpWithSolveBase<double> > W =
+    Thyra::linearOpWithSolve<double>(
+      *W_factory,
+      matrix
+      );
+  return W;
+}
+
+
+RCP<Thyra::LinearOpBase<double> >
+DampedOscillatorModel::create_W_op() const
+{
+  RCP<Thyra::MultiVectorBase<double> > matrix = Thyra::createMembers(x_space_, dim_);
+  return(matrix);
+}
+
+
+RCP<const Thyra::LinearOpWithSolveFactoryBase<double> >
+DampedOscillatorModel::get_W_factory() const
+{
+  RCP<Thyra::LinearOpWithSolveFactoryBase<double> > W_factory =
+    Thyra::defaultSerialDenseLinearOpWithSolveFactory<double>();
+  return W_factory;
+}
+
+
+ModelEvaluatorBase::InArgs<double>
+DampedOscillatorModel::createInArgs() const
+{
+  setupInOutArgs_();
+  return inArgs_;
+}
+
+
+// Private functions overridden from ModelEvaulatorDefaultBase
+
+
+ModelEvaluatorBase::OutArgs<double>
+DampedOscillatorModel::createOutArgsImpl() const
+{
+  setupInOutArgs_();
+  return outArgs_;
+}
+
+
+void DampedOscillatorModel::evalModelImpl(
+  const ModelEvaluatorBase::InArgs<double> &inArgs,
+  const ModelEvaluatorBase::OutArgs<double> &outArgs
+  ) const
+{
+  TEUCHOS_TEST_FOR_EXCEPTION( !isInitialized_, std::logic_error,
+      "Error, setImplicitFlag must be called first!\n"
+      );
+
+  const RCP<const VectorBase<double> > x_in = inArgs.get_x().assert_not_null();
+  Thyra::ConstDetachedVectorView<double> x_in_view( *x_in );
+
+  // Coefficients of the (possibly partial) right hand side J*x
+  const double lambda = ( includeDamping_ ? lambda_ : 0.0 );
+  const double omega = ( includeRotation_ ? omega_ : 0.0 );
+
+  RCP<const VectorBase<double> > x_dot_in;
+  double beta = inArgs.get_beta();
+  double alpha = 0.0;
+  if (isImplicit_) {
+    x_dot_in = inArgs.get_x_dot().assert_not_null();
+    alpha = inArgs.get_alpha();
+  }
+
+  const RCP<VectorBase<double> > f_out = outArgs.get_f();
+  const RCP<Thyra::LinearOpBase<double> > W_out = outArgs.get_W_op();
+
+  if (!isImplicit_) { // isImplicit_ == false
+    if (!is_null(f_out)) {
+      Thyra::DetachedVectorView<double> f_out_view( *f_out );
+      f_out_view[0] = lambda*x_in_view[0] - omega*x_in_view[1];
+      f_out_view[1] = omega*x_in_view[0] + lambda*x_in_view[1];
+    }
+    if (!is_null(W_out)) {
+      RCP<Thyra::MultiVectorBase<double> > matrix = Teuchos::rcp_dynamic_cast<Thyra::MultiVectorBase<double> >(W_out,true);
+      Thyra::DetachedMultiVectorView<double> matrix_view( *matrix );
+      matrix_view(0,0) = beta*lambda;
+      matrix_view(0,1) = -beta*omega;
+      matrix_view(1,0) = beta*omega;
+      matrix_view(1,1) = beta*lambda;
+    }
+  } else { // isImplicit_ == true
+    if (!is_null(f_out)) {
+      Thyra::DetachedVectorView<double> f_out_view( *f_out );
+      Thyra::ConstDetachedVectorView<double> x_dot_in_view( *x_dot_in );
+      f_out_view[0] = x_dot_in_view[0] - (lambda*x_in_view[0] - omega*x_in_view[1]);
+      f_out_view[1] = x_dot_in_view[1] - (omega*x_in_view[0] + lambda*x_in_view[1]);
+    }
+    if (!is_null(W_out)) {
+      RCP<Thyra::MultiVectorBase<double> > matrix = Teuchos::rcp_dynamic_cast<Thyra::MultiVectorBase<double> >(W_out,true);
+      Thyra::DetachedMultiVectorView<double> matrix_view( *matrix );
+      matrix_view(0,0) = alpha - beta*lambda;
+      matrix_view(0,1) = +beta*omega;
+      matrix_view(1,0) = -beta*omega;
+      matrix_view(1,1) = alpha - beta*lambda;
+    }
+  }
+}
+
+// private
+
+void DampedOscillatorModel::setupInOutArgs_() const
+{
+  if (isInitialized_) {
+    return;
+  }
+
+  {
+    // Set up prototypical InArgs
+    ModelEvaluatorBase::InArgsSetup<double> inArgs;
+    inArgs.setModelEvalDescription(this->description());
+    inArgs.setSupports( ModelEvaluatorBase::IN_ARG_t );
+    inArgs.setSupports( ModelEvaluatorBase::IN_ARG_x );
+    inArgs.setSupports( ModelEvaluatorBase::IN_ARG_beta );
+    if (isImplicit_) {
+      inArgs.setSupports( ModelEvaluatorBase::IN_ARG_x_dot );
+      inArgs.setSupports( ModelEvaluatorBase::IN_ARG_alpha );
+    }
+    inArgs_ = inArgs;
+  }
+
+  {
+    // Set up prototypical OutArgs
+    ModelEvaluatorBase::OutArgsSetup<double> outArgs;
+    outArgs.setModelEvalDescription(this->description());
+    outArgs.setSupports( ModelEvaluatorBase::OUT_ARG_f );
+    outArgs.setSupports( ModelEvaluatorBase::OUT_ARG_W_op );
+    outArgs_ = outArgs;
+  }
+
+  // Set up nominal values
+  nominalValues_ = inArgs_;
+  nominalValues_.set_t(t0_ic_);
+  const RCP<VectorBase<double> > x_ic = createMember(x_space_);
+  { // scope to delete DetachedVectorView
+    Thyra::DetachedVectorView<double> x_ic_view( *x_ic );
+    x_ic_view[0] = x0_ic_;
+    x_ic_view[1] = x1_ic_;
+  }
+  nominalValues_.set_x(x_ic);
+  if (isImplicit_) {
+    const double lambda = ( includeDamping_ ? lambda_ : 0.0 );
+    const double omega = ( includeRotation_ ? omega_ : 0.0 );
+    const RCP<VectorBase<double> > x_dot_ic = createMember(x_space_);
+    { // scope to delete DetachedVectorView
+      Thyra::DetachedVectorView<double> x_dot_ic_view( *x_dot_ic );
+      x_dot_ic_view[0] = lambda*x0_ic_ - omega*x1_ic_;
+      x_dot_ic_view[1] = omega*x0_ic_ + lambda*x1_ic_;
+    }
+    nominalValues_.set_x_dot(x_dot_ic);
+  }
+
+  isInitialized_ = true;
+
+}
+
+void DampedOscillatorModel::setParameterList(RCP<ParameterList> const& paramList)
+{
+  using Teuchos::get;
+  TEUCHOS_TEST_FOR_EXCEPT( is_null(paramList) );
+  paramList->validateParametersAndSetDefaults(*this->getValidParameters());
+  this->setMyParamList(paramList);
+  RCP<ParameterList> pl = this->getMyNonconstParamList();
+  isImplicit_ = get<bool>(*pl,Implicit_name);
+  includeDamping_ = get<bool>(*pl,IncludeDamping_name);
+  includeRotation_ = get<bool>(*pl,IncludeRotation_name);
+  lambda_ = get<double>(*pl,Coeff_lambda_name);
+  omega_ = get<double>(*pl,Coeff_omega_name);
+  x0_ic_ = get<double>(*pl,IC_x0_name);
+  x1_ic_ = get<double>(*pl,IC_x1_name);
+  t0_ic_ = get<double>(*pl,IC_t0_name);
+  isInitialized_ = false;
+  setupInOutArgs_();
+}
+
+RCP<const ParameterList> DampedOscillatorModel::getValidParameters() const
+{
+  static RCP<const ParameterList> validPL;
+  if (is_null(validPL)) {
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set(Implicit_name,Implicit_default);
+    pl->set(IncludeDamping_name,IncludeDamping_default);
+    pl->set(IncludeRotation_name,IncludeRotation_default);
+    Teuchos::setDoubleParameter(
+        Coeff_lambda_name, Coeff_lambda_default, "Damping rate lambda",
+        &*pl
+        );
+    Teuchos::setDoubleParameter(
+        Coeff_omega_name, Coeff_omega_default, "Rotation frequency omega",
+        &*pl
+        );
+    Teuchos::setDoubleParameter(
+        IC_x0_name, IC_x0_default, "Initial Condition for x0",
+        &*pl
+        );
+    Teuchos::setDoubleParameter(
+        IC_x1_name, IC_x1_default, "Initial Condition for x1",
+        &*pl
+        );
+    Teuchos::setDoubleParameter(
+        IC_t0_name, IC_t0_default, "Initial time t0",
+        &*pl
+        );
+    validPL = pl;
+  }
+  return validPL;
+}
+
+} // namespace Rythmos
@@ -0,0 +1,165 @@
+//@HEADER
+
+// ***********************************************************************
+//
+//                     Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef DAMPED_OSCILLATOR_MODEL_HPP
+#define DAMPED_OSCILLATOR_MODEL_HPP
+
+#include "Rythmos_ConfigDefs.h"
+#include "Rythmos_Types.hpp"
+
+#include "Thyra_ModelEvaluator.hpp" // Interface
+#include "Thyra_StateFuncModelEvaluatorBase.hpp" // Implementation
+
+#include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
+#include "Teuchos_ParameterList.hpp"
+
+using Thyra::ModelEvaluatorBase;
+
+namespace Rythmos {
+
+  /*
+   * This is a linear damped oscillator whose right hand side is the sum of a
+   * damping term and a rotation term:
+   *
+   * \dot{x} = F_d(x) + F_r(x)
+   *
+   * F_d(x) = lambda*[ x0 ]      F_r(x) = omega*[ -x1 ]
+   *                 [ x1 ]                     [  x0 ]
+   *
+   * The exact solution is
+   *
+   * x0(t) = exp(lambda*(t-t0))*( cos(omega*(t-t0))*x0_ic - sin(omega*(t-t0))*x1_ic )
+   * x1(t) = exp(lambda*(t-t0))*( sin(omega*(t-t0))*x0_ic + cos(omega*(t-t0))*x1_ic )
+   *
+   * Either term may be switched off, so that two instances of this model can
+   * be used as the two parts of a split (additive) model, e.g., for IMEX or
+   * multirate methods.  With lambda << 0 the damping term is stiff, and the
+   * ratio |lambda|/omega sets the ratio of the time scales of the two terms.
+   *
+   * p = (lambda, omega) [-10.0, 1.0]
+   *
+   */
+
+class DampedOscillatorModel
+  : public Thyra::StateFuncModelEvaluatorBase<double>,
+    public Teuchos::ParameterListAcceptorDefaultBase
+{
+  public:
+
+  // Constructor
+  DampedOscillatorModel();
+
+  // Exact solution of the full (unsplit) model
+  ModelEvaluatorBase::InArgs<double> getExactSolution(double t) const;
+
+  // Set explicit/implicit flag
+  void setImplicitFlag(bool implicit);
+
+  // Select which terms of the right hand side are evaluated
+  void setTerms(bool includeDamping, bool includeRotation);
+
+  /** \name Public functions overridden from ModelEvaulator. */
+  //@{
+
+  /** \brief . */
+  RCP<const Thyra::VectorSpaceBase<double> > get_x_space() const;
+  /** \brief . */
+  RCP<const Thyra::VectorSpaceBase<double> > get_f_space() const;
+  /** \brief . */
+  ModelEvaluatorBase::InArgs<double> getNominalValues() const;
+  /** \brief . */
+  RCP<Thyra::LinearOpWithSolveBase<double> > create_W() const;
+  /** \brief . */
+  RCP<Thyra::LinearOpBase<double> > create_W_op() const;
+  /** \brief . */
+  RCP<const Thyra::LinearOpWithSolveFactoryBase<double> > get_W_factory() const;
+  /** \brief . */
+  ModelEvaluatorBase::InArgs<double> createInArgs() const;
+
+  //@}
+
+  /** \name Public functions overridden from ParameterListAcceptor. */
+  //@{
+
+  /** \brief . */
+  void setParameterList(RCP<ParameterList> const& paramList);
+
+  /** \brief . */
+  RCP<const ParameterList> getValidParameters() const;
+
+  //@}
+
+private:
+
+  /** \brief. */
+  void setupInOutArgs_() const;
+
+  /** \name Private functions overridden from ModelEvaulatorDefaultBase. */
+  //@{
+
+  /** \brief . */
+  ModelEvaluatorBase::OutArgs<double> createOutArgsImpl() const;
+  /** \brief . */
+  void evalModelImpl(
+    const ModelEvaluatorBase::InArgs<double> &inArgs_bar,
+    const ModelEvaluatorBase::OutArgs<double> &outArgs_bar
+    ) const;
+
+  //@}
+
+private:
+  int dim_;         // Number of state unknowns (2)
+  bool isImplicit_; // false => \dot{x} = f(x,t)    W = beta*df/dx
+                    // true =>  F(\dot{x},x,t) = 0  W = alpha*dF/dxdot + beta*dF/dx
+  bool includeDamping_;  // Evaluate the damping term F_d
+  bool includeRotation_; // Evaluate the rotation term F_r
+  mutable bool isInitialized_;
+  mutable ModelEvaluatorBase::InArgs<double> inArgs_;
+  mutable ModelEvaluatorBase::OutArgs<double> outArgs_;
+  mutable ModelEvaluatorBase::InArgs<double> nominalValues_;
+  RCP<const Thyra::VectorSpaceBase<double> > x_space_;
+  RCP<const Thyra::VectorSpaceBase<double> > f_space_;
+
+  double lambda_; // damping rate
+  double omega_;  // rotation frequency
+  double t0_ic_;  // This is the time value where the initial condition is specified
+  double x0_ic_;  // initial condition for x0
+  double x1_ic_;  // initial condition for x1
+};
+
+// Non-member constructor
+RCP<DampedOscillatorModel> dampedOscillatorModel();
+RCP<DampedOscillatorModel> dampedOscillatorModel(bool implicit);
+RCP<DampedOscillatorModel> dampedOscillatorModel(
+  bool implicit, bool includeDamping, bool includeRotation);
+
+
+} // namespace Rythmos
+
+#endif // DAMPED_OSCILLATOR_MODEL_HPP
@@ -0,0 +1,296 @@
+//@HEADER
+
+// ***********************************************************************
+//
+//                     Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "KPRModel.hpp"
+
+#include "Teuchos_StandardParameterEntryValidators.hpp"
+
+#include "Thyra_DefaultSpmdVectorSpace.hpp"
+#include "Thyra_DetachedVectorView.hpp"
+
+namespace {
+  const std::string IncludeFast_name = "Include fast part";
+  const bool IncludeFast_default = true;
+
+  const std::string IncludeSlow_name = "Include slow part";
+  const bool IncludeSlow_default = true;
+
+  const std::string Coeff_omega_name = "Coeff omega";
+  const double Coeff_omega_default = 20.0;
+
+  const std::string Coeff_lambda_f_name = "Coeff lambda_f";
+  const double Coeff_lambda_f_default = -10.0;
+
+  const std::string Coeff_lambda_s_name = "Coeff lambda_s";
+  const double Coeff_lambda_s_default = -1.0;
+
+  const std::string Coeff_epsilon_name = "Coeff epsilon";
+  const double Coeff_epsilon_default = 0.1;
+
+  const std::string Coeff_alpha_name = "Coeff alpha";
+  const double Coeff_alpha_default = 1.0;
+
+  const std::string IC_t0_name = "IC t_0";
+  const double IC_t0_default = 0.0;
+
+} // namespace
+
+namespace Rythmos {
+
+// non-member Constructor
+RCP<KPRModel> kprModel()
+{
+  RCP<KPRModel> model = rcp(new KPRModel);
+  return(model);
+}
+
+// non-member Constructor
+RCP<KPRModel> kprModel(bool includeFast, bool includeSlow)
+{
+  RCP<KPRModel> model = kprModel();
+  model->setParts(includeFast,includeSlow);
+  return(model);
+}
+
+// Constructor
+KPRModel::KPRModel()
+{
+  isInitialized_ = false;
+  dim_ = 2;
+  includeFast_ = IncludeFast_default;
+  includeSlow_ = IncludeSlow_default;
+  omega_ = Coeff_omega_default;
+  lambda_f_ = Coeff_lambda_f_default;
+  lambda_s_ = Coeff_lambda_s_default;
+  epsilon_ = Coeff_epsilon_default;
+  alpha_ = Coeff_alpha_default;
+  t0_ic_ = IC_t0_default;
+
+  // Create x_space and f_space
+  x_space_ = Thyra::defaultSpmdVectorSpace<double>(dim_);
+  f_space_ = Thyra::defaultSpmdVectorSpace<double>(dim_);
+}
+
+void KPRModel::setParts(bool includeFast, bool includeSlow)
+{
+  includeFast_ = includeFast;
+  includeSlow_ = includeSlow;
+}
+
+ModelEvaluatorBase::InArgs<double>
+KPRModel::getExactSolution(double t) const
+{
+  setupInOutArgs_();
+  ModelEvaluatorBase::InArgs<double> inArgs = inArgs_;
+  inArgs.set_t(t);
+  RCP<VectorBase<double> > exact_x = createMember(x_space_);
+  { // scope to delete DetachedVectorView
+    Thyra::DetachedVectorView<double> exact_x_view(*exact_x);
+    exact_x_view[0] = sqrt(3.0 + cos(omega_*t));
+    exact_x_view[1] = sqrt(2.0 + cos(t));
+  }
+  inArgs.set_x(exact_x);
+  return(inArgs);
+}
+
+RCP<const Thyra::VectorSpaceBase<double> >
+KPRModel::get_x_space() const
+{
+  return x_space_;
+}
+
+
+RCP<const Thyra::VectorSpaceBase<double> >
+KPRModel::get_f_space() const
+{
+  return f_space_;
+}
+
+
+ModelEvaluatorBase::InArgs<double>
+KPRModel::getNominalValues() const
+{
+  setupInOutArgs_();
+  return nominalValues_;
+}
+
+
+ModelEvaluatorBase::InArgs<double>
+KPRModel::createInArgs() const
+{
+  setupInOutArgs_();
+  return inArgs_;
+}
+
+
+// Private functions overridden from ModelEvaulatorDefaultBase
+
+
+ModelEvaluatorBase::OutArgs<double>
+KPRModel::createOutArgsImpl() const
+{
+  setupInOutArgs_();
+  return outArgs_;
+}
+
+
+void KPRModel::evalModelImpl(
+  const ModelEvaluatorBase::InArgs<double> &inArgs,
+  const ModelEvaluatorBase::OutArgs<double> &outArgs
+  ) const
+{
+  const RCP<VectorBase<double> > f_out = outArgs.get_f();
+  if (is_null(f_out)) {
+    return;
+  }
+
+  const RCP<const VectorBase<double> > x_in = inArgs.get_x().assert_not_null();
+  Thyra::ConstDetachedVectorView<double> x_in_view( *x_in );
+  const double t = inArgs.get_t();
+  const double x0 = x_in_view[0];
+  const double x1 = x_in_view[1];
+
+  const double r_f = (-3.0 + x0*x0 - cos(omega_*t))/(2.0*x0);
+  const double r_s = (-2.0 + x1*x1 - cos(t))/(2.0*x1);
+  const double dlambda = lambda_f_ - lambda_s_;
+
+  Thyra::DetachedVectorView<double> f_out_view( *f_out );
+  f_out_view[0] = 0.0;
+  f_out_view[1] = 0.0;
+  if (includeFast_) {
+    f_out_view[0] = lambda_f_*r_f + (1.0-epsilon_)/alpha_*dlambda*r_s
+      - omega_*sin(omega_*t)/(2.0*x0);
+  }
+  if (includeSlow_) {
+    f_out_view[1] = -alpha_*epsilon_*dlambda*r_f + lambda_s_*r_s
+      - sin(t)/(2.0*x1);
+  }
+}
+
+// private
+
+void KPRModel::setupInOutArgs_() const
+{
+  if (isInitialized_) {
+    return;
+  }
+
+  {
+    // Set up prototypical InArgs
+    ModelEvaluatorBase::InArgsSetup<double> inArgs;
+    inArgs.setModelEvalDescription(this->description());
+    inArgs.setSupports( ModelEvaluatorBase::IN_ARG_t );
+    inArgs.setSupports( ModelEvaluatorBase::IN_ARG_x );
+    inArgs_ = inArgs;
+  }
+
+  {
+    // Set up prototypical OutArgs
+    ModelEvaluatorBase::OutArgsSetup<double> outArgs;
+    outArgs.setModelEvalDescription(this->description());
+    outArgs.setSupports( ModelEvaluatorBase::OUT_ARG_f );
+    outArgs_ = outArgs;
+  }
+
+  // Set up nominal values from the exact solution
+  nominalValues_ = inArgs_;
+  nominalValues_.set_t(t0_ic_);
+  const RCP<VectorBase<double> > x_ic = createMember(x_space_);
+  { // scope to delete DetachedVectorView
+    Thyra::DetachedVectorView<double> x_ic_view( *x_ic );
+    x_ic_view[0] = sqrt(3.0 + cos(omega_*t0_ic_));
+    x_ic_view[1] = sqrt(2.0 + cos(t0_ic_));
+  }
+  nominalValues_.set_x(x_ic);
+
+  isInitialized_ = true;
+
+}
+
+void KPRModel::setParameterList(RCP<ParameterList> const& paramList)
+{
+  using Teuchos::get;
+  TEUCHOS_TEST_FOR_EXCEPT( is_null(paramList) );
+  paramList->validateParametersAndSetDefaults(*this->getValidParameters());
+  this->setMyParamList(paramList);
+  RCP<ParameterList> pl = this->getMyNonconstParamList();
+  includeFast_ = get<bool>(*pl,IncludeFast_name);
+  includeSlow_ = get<bool>(*pl,IncludeSlow_name);
+  omega_ = get<double>(*pl,Coeff_omega_name);
+  lambda_f_ = get<double>(*pl,Coeff_lambda_f_name);
+  lambda_s_ = get<double>(*pl,Coeff_lambda_s_name);
+  epsilon_ = get<double>(*pl,Coeff_epsilon_name);
+  alpha_ = get<double>(*pl,Coeff_alpha_name);
+  t0_ic_ = get<double>(*pl,IC_t0_name);
+  isInitialized_ = false;
+  setupInOutArgs_();
+}
+
+RCP<const ParameterList> KPRModel::getValidParameters() const
+{
+  static RCP<const ParameterList> validPL;
+  if (is_null(validPL)) {
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set(IncludeFast_name,IncludeFast_default);
+    pl->set(IncludeSlow_name,IncludeSlow_default);
+    Teuchos::setDoubleParameter(
+        Coeff_omega_name, Coeff_omega_default,
+        "Frequency omega of the fast component, i.e., the time-scale ratio",
+        &*pl
+        );
+    Teuchos::setDoubleParameter(
+        Coeff_lambda_f_name, Coeff_lambda_f_default,
+        "Relaxation rate lambda_f of the fast component",
+        &*pl
+        );
+    Teuchos::setDoubleParameter(
+        Coeff_lambda_s_name, Coeff_lambda_s_default,
+        "Relaxation rate lambda_s of the slow component",
+        &*pl
+        );
+    Teuchos::setDoubleParameter(
+        Coeff_epsilon_name, Coeff_epsilon_default,
+        "Coupling strength epsilon",
+        &*pl
+        );
+    Teuchos::setDoubleParameter(
+        Coeff_alpha_name, Coeff_alpha_default,
+        "Coupling asymmetry alpha",
+        &*pl
+        );
+    Teuchos::setDoubleParameter(
+        IC_t0_name, IC_t0_default, "Initial time t0",
+        &*pl
+        );
+    validPL = pl;
+  }
+  return validPL;
+}
+
+} // namespace Rythmos
@@ -0,0 +1,159 @@
+//@HEADER
+
+// ***********************************************************************
+//
+//                     Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#ifndef KPR_MODEL_HPP
+#define KPR_MODEL_HPP
+
+#include "Rythmos_ConfigDefs.h"
+#include "Rythmos_Types.hpp"
+
+#include "Thyra_ModelEvaluator.hpp" // Interface
+#include "Thyra_StateFuncModelEvaluatorBase.hpp" // Implementation
+
+#include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
+#include "Teuchos_ParameterList.hpp"
+
+using Thyra::ModelEvaluatorBase;
+
+namespace Rythmos {
+
+  /*
+   * This is the nonlinear Kvaerno-Prothero-Robinson (KPR) test problem for
+   * multirate methods, with a fast component x0 and a slow component x1:
+   *
+   * \dot{x} = [ F_f(x,t) ]
+   *           [ F_s(x,t) ]
+   *
+   * F_f(x,t) = lambda_f*r_f + (1-epsilon)/alpha*(lambda_f-lambda_s)*r_s - omega*sin(omega*t)/(2*x0)
+   * F_s(x,t) = -alpha*epsilon*(lambda_f-lambda_s)*r_f + lambda_s*r_s - sin(t)/(2*x1)
+   *
+   * r_f = (-3 + x0^2 - cos(omega*t))/(2*x0)
+   * r_s = (-2 + x1^2 - cos(t))/(2*x1)
+   *
+   * The exact solution is
+   *
+   * x0(t) = sqrt(3 + cos(omega*t))
+   * x1(t) = sqrt(2 + cos(t))
+   *
+   * so omega is the ratio of the fast and slow time scales, and epsilon sets
+   * the strength of the coupling between the two components.  Either part
+   * may be switched off, so that two instances of this model form the fast
+   * and slow parts of an additive split for multirate methods.  Only the
+   * explicit form is provided.
+   *
+   * See A. Sandu, "A class of multirate infinitesimal GARK methods", SIAM J.
+   * Numer. Anal. 57 (2019).
+   *
+   */
+
+class KPRModel
+  : public Thyra::StateFuncModelEvaluatorBase<double>,
+    public Teuchos::ParameterListAcceptorDefaultBase
+{
+  public:
+
+  // Constructor
+  KPRModel();
+
+  // Exact solution of the full (unsplit) model
+  ModelEvaluatorBase::InArgs<double> getExactSolution(double t) const;
+
+  // Select which parts of the right hand side are evaluated
+  void setParts(bool includeFast, bool includeSlow);
+
+  /** \name Public functions overridden from ModelEvaulator. */
+  //@{
+
+  /** \brief . */
+  RCP<const Thyra::VectorSpaceBase<double> > get_x_space() const;
+  /** \brief . */
+  RCP<const Thyra::VectorSpaceBase<double> > get_f_space() const;
+  /** \brief . */
+  ModelEvaluatorBase::InArgs<double> getNominalValues() const;
+  /** \brief . */
+  ModelEvaluatorBase::InArgs<double> createInArgs() const;
+
+  //@}
+
+  /** \name Public functions overridden from ParameterListAcceptor. */
+  //@{
+
+  /** \brief . */
+  void setParameterList(RCP<ParameterList> const& paramList);
+
+  /** \brief . */
+  RCP<const ParameterList> getValidParameters() const;
+
+  //@}
+
+private:
+
+  /** \brief. */
+  void setupInOutArgs_() const;
+
+  /** \name Private functions overridden from ModelEvaulatorDefaultBase. */
+  //@{
+
+  /** \brief . */
+  ModelEvaluatorBase::OutArgs<double> createOutArgsImpl() const;
+  /** \brief . */
+  void evalModelImpl(
+    const ModelEvaluatorBase::InArgs<double> &inArgs_bar,
+    const ModelEvaluatorBase::OutArgs<double> &outArgs_bar
+    ) const;
+
+  //@}
+
+private:
+  int dim_;              // Number of state unknowns (2)
+  bool includeFast_;     // Evaluate the fast part F_f
+  bool includeSlow_;     // Evaluate the slow part F_s
+  mutable bool isInitialized_;
+  mutable ModelEvaluatorBase::InArgs<double> inArgs_;
+  mutable ModelEvaluatorBase::OutArgs<double> outArgs_;
+  mutable ModelEvaluatorBase::InArgs<double> nominalValues_;
+  RCP<const Thyra::VectorSpaceBase<double> > x_space_;
+  RCP<const Thyra::VectorSpaceBase<double> > f_space_;
+
+  double omega_;    // time-scale ratio
+  double lambda_f_; // fast relaxation rate
+  double lambda_s_; // slow relaxation rate
+  double epsilon_;  // coupling strength
+  double alpha_;    // coupling asymmetry
+  double t0_ic_;    // This is the time value where the initial condition is specified
+};
+
+// Non-member constructor
+RCP<KPRModel> kprModel();
+RCP<KPRModel> kprModel(bool includeFast, bool includeSlow);
+
+
+} // namespace Rythmos
+
+#endif // KPR_MODEL_HPP
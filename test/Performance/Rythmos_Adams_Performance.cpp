@@ -0,0 +1,198 @@
+//@HEADER
+
+// ***********************************************************************
+//
+//                     Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_AdamsStepper.hpp"
+#include "Rythmos_ExplicitRKStepper.hpp"
+#include "Rythmos_RKButcherTableau.hpp"
+#include "../VanderPol/VanderPolModel.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+
+#include "Teuchos_GlobalMPISession.hpp"
+#include "Teuchos_CommandLineProcessor.hpp"
+#include "Teuchos_StandardCatchMacros.hpp"
+#include "Teuchos_VerboseObject.hpp"
+#include "Teuchos_Time.hpp"
+#include "Teuchos_as.hpp"
+
+#include <iomanip>
+
+//
+// Adams benchmark on the explicit (non-stiff) formulation of the Van der Pol
+// model.  The AdamsStepper runs with variable order and step size to the
+// given tolerance, and classic RK4 with fixed steps is refined by doubling
+// the number of steps until its error is at most the Adams error.  The work
+// of both methods is compared in evaluations of the right hand side.
+//
+
+namespace {
+
+using Teuchos::RCP;
+using Teuchos::ParameterList;
+
+double relativeError(
+  const Thyra::VectorBase<double>& x,
+  const Thyra::VectorBase<double>& x_exact
+  )
+{
+  RCP<Thyra::VectorBase<double> > err = x.clone_v();
+  Thyra::Vp_StV(err.ptr(), -1.0, x_exact);
+  return Thyra::norm_2(*err)/Thyra::norm_2(x_exact);
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+
+  using Teuchos::as;
+  using Rythmos::STEP_TYPE_FIXED;
+  using Rythmos::STEP_TYPE_VARIABLE;
+
+  bool success = true;
+
+  Teuchos::GlobalMPISession mpiSession(&argc,&argv);
+
+  RCP<Teuchos::FancyOStream>
+    out = Teuchos::VerboseObjectBase::getDefaultOStream();
+
+  try { // catch exceptions
+
+    double epsilon = 0.5;     // Van der Pol coefficient
+    double finalTime = 10.0;
+    double tol = 1.0e-6;      // relative and absolute tolerance of Adams
+    int maxRKSteps = 100000;  // limit for the refinement of RK4
+
+    Teuchos::CommandLineProcessor clp(false); // Don't throw exceptions
+    clp.setOption( "epsilon", &epsilon, "Van der Pol coefficient epsilon." );
+    clp.setOption( "T", &finalTime, "Final time for simulation." );
+    clp.setOption( "tol", &tol,
+      "Relative and absolute error tolerance of the Adams run." );
+    clp.setOption( "max-rk-steps", &maxRKSteps,
+      "Maximum number of RK4 steps in the refinement." );
+
+    Teuchos::CommandLineProcessor::EParseCommandLineReturn
+      parse_return = clp.parse(argc,argv);
+    if( parse_return != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL )
+      return parse_return;
+
+    RCP<ParameterList> modelPL = Teuchos::parameterList();
+    modelPL->set("Implicit model formulation",false);
+    modelPL->set("Coeff epsilon",epsilon);
+    RCP<Rythmos::VanderPolModel> model = Rythmos::vanderPolModel(modelPL);
+    RCP<const Thyra::VectorBase<double> >
+      x_exact = model->getExactSolution(finalTime).get_x();
+
+    // Adams with variable order and step size.
+    Teuchos::Time adamsTimer("Adams");
+    RCP<Rythmos::AdamsStepper<double> >
+      adamsStepper = Rythmos::adamsStepper<double>(model);
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set("Relative Error Tolerance",tol);
+    pl->set("Absolute Error Tolerance",tol);
+    adamsStepper->setParameterList(pl);
+    adamsStepper->setInitialCondition(model->getNominalValues());
+    int adamsSteps = 0;
+    adamsTimer.start(true);
+    double time = adamsStepper->getStepStatus().time;
+    while (time < finalTime) {
+      adamsStepper->takeStep(finalTime-time,STEP_TYPE_VARIABLE);
+      time = adamsStepper->getStepStatus().time;
+      ++adamsSteps;
+    }
+    adamsTimer.stop();
+    const double adamsError =
+      relativeError(*adamsStepper->getStepStatus().solution,*x_exact);
+    const int adamsEvals = adamsStepper->getNumModelEvaluations();
+
+    // Classic RK4, doubling the number of steps until it is as accurate.
+    Teuchos::Time rkTimer("RK4");
+    int rkSteps = 8;
+    double rkError = 0.0;
+    while (true) {
+      RCP<Rythmos::ExplicitRKStepper<double> >
+        erkStepper = Rythmos::explicitRKStepper<double>(model,
+          Teuchos::rcp(new Rythmos::Explicit4Stage4thOrder_RKBT<double>()) );
+      erkStepper->setInitialCondition(model->getNominalValues());
+      const double dt = finalTime/rkSteps;
+      rkTimer.start(true);
+      for (int i=0 ; i<rkSteps ; ++i) {
+        erkStepper->takeStep(dt,STEP_TYPE_FIXED);
+      }
+      rkTimer.stop();
+      rkError = relativeError(*erkStepper->getStepStatus().solution,*x_exact);
+      if ( (rkError <= adamsError) || (2*rkSteps > maxRKSteps) )
+        break;
+      rkSteps *= 2;
+    }
+    const int rkEvals = 4*rkSteps;
+
+    *out << "\nAdams benchmark: Van der Pol epsilon = " << epsilon
+         << ", T = " << finalTime
+         << ", tol = " << tol << "\n\n";
+    *out << std::setw(12) << "method"
+         << std::setw(16) << "rel. error"
+         << std::setw(10) << "steps"
+         << std::setw(14) << "f evals"
+         << std::setw(14) << "time (s)" << "\n";
+    *out << std::setw(12) << "Adams"
+         << std::setw(16) << adamsError
+         << std::setw(10) << adamsSteps
+         << std::setw(14) << adamsEvals
+         << std::setw(14) << adamsTimer.totalElapsedTime() << "\n";
+    *out << std::setw(12) << "RK4"
+         << std::setw(16) << rkError
+         << std::setw(10) << rkSteps
+         << std::setw(14) << rkEvals
+         << std::setw(14) << rkTimer.totalElapsedTime() << "\n\n";
+
+    if (rkError > adamsError) {
+      *out << "Error, RK4 did not reach the Adams error with max-rk-steps = "
+           << maxRKSteps << "!\n";
+      success = false;
+    }
+    if (adamsEvals >= rkEvals) {
+      *out << "Error, the Adams run did not save evaluations of f!\n";
+      success = false;
+    }
+
+  } // end try
+  TEUCHOS_STANDARD_CATCH_STATEMENTS(true,*out,success)
+
+  if (success)
+    *out << "\nEnd Result: TEST PASSED" << std::endl;
+  else
+    *out << "\nEnd Result: TEST FAILED" << std::endl;
+
+  return success ? 0 : 1;
+
+} // end main() [Doxygen looks for this!]
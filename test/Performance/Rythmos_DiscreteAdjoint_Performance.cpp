@@ -0,0 +1,227 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_BackwardEulerStepper.hpp"
+#include "Rythmos_TimeStepNonlinearSolver.hpp"
+#include "Rythmos_DiscreteAdjointBackwardEulerIntegrator.hpp"
+#include "../UnitTest/Rythmos_UnitTestModels.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+
+#include "Teuchos_GlobalMPISession.hpp"
+#include "Teuchos_CommandLineProcessor.hpp"
+#include "Teuchos_StandardCatchMacros.hpp"
+#include "Teuchos_VerboseObject.hpp"
+#include "Teuchos_Time.hpp"
+#include "Teuchos_as.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+//
+// Gradient cost benchmark of the discrete adjoint of Backward Euler on the
+// EpetraExt DiagonalTransientModel.  The gradient of g = 0.5*x(T)^T*x(T)
+// with respect to the initial state and the np parameters is computed once
+// with the factored W of the forward steps kept for the transposed solves,
+// and once with W evaluated and factored again in each adjoint step.  Both
+// are reported relative to the wall time of a plain Backward Euler forward
+// integration over the same steps: the forward column includes the extra
+// evaluation and factorization of W per step that keeping W takes, and the
+// adjoint column is the cost of the gradient in plain forward integrations.
+// The two gradients must agree, and keeping W must avoid every evaluation
+// of W in the adjoint steps.
+//
+
+namespace {
+
+using Teuchos::RCP;
+using Teuchos::ParameterList;
+
+RCP<Thyra::ModelEvaluator<double> > createDiagonalModel(
+  int numElements, int numParams, const std::string &linearSolverType
+  )
+{
+  std::ostringstream coeff_s;
+  coeff_s << "{";
+  for (int j=0 ; j<numParams ; ++j)
+    coeff_s << (j==0 ? " " : ", ") << 1.0 + 0.5*(j%8);
+  coeff_s << " }";
+  RCP<ParameterList> paramList = Teuchos::parameterList();
+  ParameterList& stratPL = paramList->sublist(Rythmos::Stratimikos_name);
+  stratPL.set("Linear Solver Type",linearSolverType);
+  stratPL.set("Preconditioner Type","None");
+  ParameterList& modelPL =
+    paramList->sublist(Rythmos::DiagonalTransientModel_name);
+  modelPL.set("NumElements",numElements);
+  modelPL.set("Coeff_s",coeff_s.str());
+  return Rythmos::getDiagonalModel<double>(paramList);
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+
+  using Teuchos::as;
+
+  bool success = true;
+
+  Teuchos::GlobalMPISession mpiSession(&argc,&argv);
+
+  RCP<Teuchos::FancyOStream>
+    out = Teuchos::VerboseObjectBase::getDefaultOStream();
+
+  try { // catch exceptions
+
+    int numElements = 10000;  // number of state unknowns
+    int numParams = 8;        // number of gradient parameters
+    int numSteps = 20;        // fixed Backward Euler steps
+    double finalTime = 1.0e-3;
+    double tol = 1.0e-8;      // relative difference of the two gradients
+    std::string linearSolverType = "Amesos";
+
+    Teuchos::CommandLineProcessor clp(false); // Don't throw exceptions
+    clp.setOption( "num-elements", &numElements,
+      "Number of state unknowns of the diagonal model." );
+    clp.setOption( "np", &numParams, "Number of gradient parameters." );
+    clp.setOption( "num-steps", &numSteps, "Number of time steps." );
+    clp.setOption( "T", &finalTime, "Final time for simulation." );
+    clp.setOption( "tol", &tol,
+      "Largest relative difference of the gradients with kept and"
+      " recomputed W." );
+    clp.setOption( "linear-solver", &linearSolverType,
+      "Stratimikos linear solver type, must support transposed solves." );
+
+    Teuchos::CommandLineProcessor::EParseCommandLineReturn
+      parse_return = clp.parse(argc,argv);
+    if( parse_return != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL )
+      return parse_return;
+
+    *out << "\nDiscrete adjoint benchmark: unknowns = " << numElements
+         << ", np = " << numParams
+         << ", steps = " << numSteps
+         << ", T = " << finalTime << "\n\n";
+
+    const RCP<Thyra::ModelEvaluator<double> > model =
+      createDiagonalModel(numElements,numParams,linearSolverType);
+
+    // The plain forward integration all costs are measured against.
+    double plainForwardTime = 0.0;
+    {
+      RCP<Rythmos::BackwardEulerStepper<double> > stepper =
+        Rythmos::backwardEulerStepper<double>(
+          model, Rythmos::timeStepNonlinearSolver<double>());
+      stepper->setInitialCondition(model->getNominalValues());
+      const double dt = finalTime/numSteps;
+      const double startTime = Teuchos::Time::wallTime();
+      for (int n=0 ; n<numSteps ; ++n) {
+        const double dt_taken = stepper->takeStep(dt,Rythmos::STEP_TYPE_FIXED);
+        TEUCHOS_TEST_FOR_EXCEPTION( dt_taken != dt, std::runtime_error,
+          "Error, the plain forward stepper failed to take step " << n << "!" );
+      }
+      plainForwardTime = Teuchos::Time::wallTime() - startTime;
+    }
+    *out << "Plain forward integration: " << plainForwardTime << " s\n\n";
+
+    *out << std::setw(14) << "W"
+         << std::setw(16) << "forward (s)"
+         << std::setw(16) << "adjoint (s)"
+         << std::setw(18) << "forward/plain"
+         << std::setw(18) << "adjoint/plain"
+         << std::setw(14) << "W evals" << "\n";
+
+    RCP<Thyra::VectorBase<double> > d_g_d_x_init[2], d_g_d_p[2];
+    for (int k=0 ; k<2 ; ++k) {
+      const bool storeW = (k == 0);
+      RCP<Rythmos::BackwardEulerStepper<double> > fwdStepper =
+        Rythmos::backwardEulerStepper<double>(
+          model, Rythmos::timeStepNonlinearSolver<double>());
+      fwdStepper->setInitialCondition(model->getNominalValues());
+      RCP<ParameterList> pl = Teuchos::parameterList();
+      pl->set("Store Forward W",storeW);
+      RCP<Rythmos::DiscreteAdjointBackwardEulerIntegrator<double> > adjIntegrator =
+        Rythmos::discreteAdjointBackwardEulerIntegrator<double>(fwdStepper,0,pl);
+
+      const RCP<const Thyra::VectorBase<double> > x_final =
+        adjIntegrator->integrateForward(finalTime,numSteps);
+      d_g_d_x_init[k] = Thyra::createMember(model->get_x_space());
+      d_g_d_p[k] = Thyra::createMember(model->get_p_space(0));
+      adjIntegrator->integrateAdjoint(*x_final,d_g_d_x_init[k].ptr(),
+        d_g_d_p[k].ptr());
+
+      *out << std::setw(14) << (storeW ? "kept" : "recomputed")
+           << std::setw(16) << adjIntegrator->getForwardWallTime()
+           << std::setw(16) << adjIntegrator->getAdjointWallTime()
+           << std::setw(18)
+           << adjIntegrator->getForwardWallTime()/plainForwardTime
+           << std::setw(18)
+           << adjIntegrator->getAdjointWallTime()/plainForwardTime
+           << std::setw(14) << adjIntegrator->getNumWEvaluations() << "\n";
+
+      if (adjIntegrator->getNumTransposedSolves() != numSteps) {
+        *out << "\nError, " << adjIntegrator->getNumTransposedSolves()
+             << " transposed solves for " << numSteps << " steps!\n";
+        success = false;
+      }
+      if (storeW && adjIntegrator->getNumWEvaluations() != 0) {
+        *out << "\nError, the adjoint evaluated W "
+             << adjIntegrator->getNumWEvaluations() << " times with the"
+             << " forward W kept!\n";
+        success = false;
+      }
+    }
+
+    // The model is linear, so the kept W are those at the converged states.
+    const RCP<Thyra::VectorBase<double> > *gradients[2] = {d_g_d_x_init, d_g_d_p};
+    for (int k=0 ; k<2 ; ++k) {
+      const Thyra::VectorBase<double> &kept = *gradients[k][0];
+      const Thyra::VectorBase<double> &recomputed = *gradients[k][1];
+      RCP<Thyra::VectorBase<double> > diff = kept.clone_v();
+      Thyra::Vp_StV(diff.ptr(),-1.0,recomputed);
+      const double relDiff =
+        Thyra::norm_inf(*diff)/std::max(Thyra::norm_inf(recomputed),1.0e-300);
+      *out << "\nRelative difference of d(g)/d(" << (k == 0 ? "x_init" : "p")
+           << ") = " << relDiff << "\n";
+      if (!(relDiff <= tol))
+        success = false;
+    }
+
+  } // end try
+  TEUCHOS_STANDARD_CATCH_STATEMENTS(true,*out,success)
+
+  if (success)
+    *out << "\nEnd Result: TEST PASSED" << std::endl;
+  else
+    *out << "\nEnd Result: TEST FAILED" << std::endl;
+
+  return success ? 0 : 1;
+
+} // end main() [Doxygen looks for this!]
@@ -0,0 +1,228 @@
+//@HEADER
+
+// ***********************************************************************
+//
+//                     Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_EnsembleIntegrationDriver.hpp"
+#include "Rythmos_IntegratorBuilder.hpp"
+#include "Rythmos_TimeStepNonlinearSolver.hpp"
+#include "../SinCos/SinCosModel.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+#include "Thyra_MultiVectorStdOps.hpp"
+#include "Thyra_DetachedVectorView.hpp"
+
+#include "Teuchos_GlobalMPISession.hpp"
+#include "Teuchos_CommandLineProcessor.hpp"
+#include "Teuchos_StandardCatchMacros.hpp"
+#include "Teuchos_VerboseObject.hpp"
+#include "Teuchos_as.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+//
+// Thread-parallel ensemble benchmark on the implicit SinCos model.  The
+// members differ in the frequency f, spread logarithmically over a range of
+// 100, so the adaptive BDF step counts of the members differ by about as
+// much.  The ensemble is integrated by EnsembleIntegrationDriver once on one
+// thread and once on several, and the throughput in member steps per second
+// and the utilization of each thread are reported.
+//
+
+namespace {
+
+using Teuchos::RCP;
+using Teuchos::Array;
+using Teuchos::ParameterList;
+
+RCP<ParameterList> bdfBuilderPL(double finalTime)
+{
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->setParameters(
+    *(Rythmos::integratorBuilder<double>()->getValidParameters()));
+  pl->sublist("Integrator Settings").set("Final Time",finalTime);
+  ParameterList &stepperPL = pl->sublist("Stepper Settings");
+  stepperPL.sublist("Stepper Selection").set("Stepper Type","Implicit BDF");
+  stepperPL.sublist("Step Control Settings")
+    .sublist("Step Control Strategy Selection")
+    .set("Step Control Strategy Type",
+      "Implicit BDF Stepper Step Control Strategy");
+  stepperPL.sublist("Step Control Settings")
+    .sublist("Error Weight Vector Calculator Selection")
+    .set("Error Weight Vector Calculator Type",
+      "Implicit BDF Stepper Error Weight Vector Calculator");
+  return pl;
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+
+  using Teuchos::as;
+
+  bool success = true;
+
+  Teuchos::GlobalMPISession mpiSession(&argc,&argv);
+
+  RCP<Teuchos::FancyOStream>
+    out = Teuchos::VerboseObjectBase::getDefaultOStream();
+
+  try { // catch exceptions
+
+    int numMembers = 64;    // number of ensemble members
+    int numThreads = 4;     // threads of the parallel run
+    double finalTime = 1.0;
+    double freqRange = 100.0; // ratio of the largest to smallest frequency
+
+    Teuchos::CommandLineProcessor clp(false); // Don't throw exceptions
+    clp.setOption( "num-members", &numMembers,
+      "Number of members with different frequencies." );
+    clp.setOption( "num-threads", &numThreads,
+      "Number of threads of the parallel run." );
+    clp.setOption( "T", &finalTime, "Final time for simulation." );
+    clp.setOption( "freq-range", &freqRange,
+      "Ratio of the largest to the smallest member frequency." );
+
+    Teuchos::CommandLineProcessor::EParseCommandLineReturn
+      parse_return = clp.parse(argc,argv);
+    if( parse_return != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL )
+      return parse_return;
+
+    RCP<Rythmos::SinCosModel> model = Rythmos::sinCosModel();
+    {
+      RCP<ParameterList> pl = Teuchos::parameterList();
+      pl->set("Implicit model formulation",true);
+      pl->set("Accept model parameters",true);
+      model->setParameterList(pl);
+    }
+
+    // The largest frequencies come first so that contiguous blocks give a
+    // bad static balance for the driver to correct.
+    Array<RCP<const Thyra::VectorBase<double> > > params;
+    for (int k=0 ; k<numMembers ; ++k) {
+      RCP<Thyra::VectorBase<double> > p =
+        Thyra::createMember(model->get_p_space(0));
+      {
+        Thyra::DetachedVectorView<double> p_view( *p );
+        p_view[0] = 0.0;
+        p_view[1] = std::pow(freqRange, 1.0-as<double>(k)/std::max(numMembers-1,1));
+        p_view[2] = 1.0;
+      }
+      params.push_back(p);
+    }
+    Array<double> time_vec(1,finalTime);
+
+    Array<RCP<Thyra::MultiVectorBase<double> > > x_serial, x_parallel;
+    for (int k=0 ; k<numMembers ; ++k) {
+      x_serial.push_back(Thyra::createMembers(model->get_x_space(),1));
+      x_parallel.push_back(Thyra::createMembers(model->get_x_space(),1));
+    }
+
+    Array<RCP<Rythmos::EnsembleIntegrationDriver<double> > > drivers;
+    Array<int> threads;
+    threads.push_back(1);
+    threads.push_back(numThreads);
+    for (int r=0 ; r<2 ; ++r) {
+      RCP<ParameterList> driverPL = Teuchos::parameterList();
+      driverPL->set("Number of Threads",threads[r]);
+      drivers.push_back(Rythmos::ensembleIntegrationDriver<double>(
+          model, model->getNominalValues(),
+          Rythmos::timeStepNonlinearSolver<double>(),
+          bdfBuilderPL(finalTime), driverPL));
+      drivers[r]->integrate(params, time_vec, (r==0 ? x_serial : x_parallel));
+    }
+
+    const Array<int> &memberNumSteps = drivers[0]->getMemberNumSteps();
+    int totalSteps = 0;
+    for (int k=0 ; k<numMembers ; ++k) {
+      totalSteps += memberNumSteps[k];
+    }
+    const int maxSteps =
+      *std::max_element(memberNumSteps.begin(),memberNumSteps.end());
+    const int minSteps =
+      *std::min_element(memberNumSteps.begin(),memberNumSteps.end());
+
+    *out << "\nEnsemble driver benchmark: members = " << numMembers
+         << ", T = " << finalTime
+         << ", steps per member = " << minSteps << " to " << maxSteps
+         << "\n\n";
+    *out << std::setw(10) << "threads"
+         << std::setw(14) << "time (s)"
+         << std::setw(22) << "member steps/s" << "\n";
+    for (int r=0 ; r<2 ; ++r) {
+      const double time = drivers[r]->getWallTime();
+      *out << std::setw(10) << drivers[r]->getNumThreads()
+           << std::setw(14) << time
+           << std::setw(22) << totalSteps/std::max(time,1.0e-12) << "\n";
+    }
+    *out << "\nSpeedup = " << drivers[0]->getWallTime()
+      /std::max(drivers[1]->getWallTime(),1.0e-12) << "\n\n";
+
+    const Array<Rythmos::EnsembleThreadStatistics> &stats =
+      drivers[1]->getThreadStatistics();
+    *out << std::setw(10) << "thread"
+         << std::setw(10) << "members"
+         << std::setw(10) << "stolen"
+         << std::setw(10) << "steps"
+         << std::setw(14) << "utilization" << "\n";
+    for (int i=0 ; i<as<int>(stats.size()) ; ++i) {
+      *out << std::setw(10) << i
+           << std::setw(10) << stats[i].numMembers
+           << std::setw(10) << stats[i].numStolenMembers
+           << std::setw(10) << stats[i].numSteps
+           << std::setw(14) << stats[i].utilization << "\n";
+    }
+
+    // The threaded run must give the same answer as the serial one.
+    double maxDiff = 0.0;
+    for (int k=0 ; k<numMembers ; ++k) {
+      RCP<Thyra::MultiVectorBase<double> > diff = x_parallel[k]->clone_mv();
+      Thyra::update(-1.0, *x_serial[k], diff.ptr());
+      maxDiff = std::max(maxDiff, Thyra::norm_inf(*diff->col(0)));
+    }
+    *out << "\nMax difference to the serial run = " << maxDiff << "\n";
+    if (maxDiff != 0.0) {
+      *out << "Error, the threaded run differs from the serial run!\n";
+      success = false;
+    }
+
+  } // end try
+  TEUCHOS_STANDARD_CATCH_STATEMENTS(true,*out,success)
+
+  if (success)
+    *out << "\nEnd Result: TEST PASSED" << std::endl;
+  else
+    *out << "\nEnd Result: TEST FAILED" << std::endl;
+
+  return success ? 0 : 1;
+
+} // end main() [Doxygen looks for this!]
@@ -0,0 +1,222 @@
+//@HEADER
+
+// ***********************************************************************
+//
+//                     Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_EnsembleModelEvaluator.hpp"
+#include "Rythmos_ExplicitRKStepper.hpp"
+#include "Rythmos_RKButcherTableauBuilder.hpp"
+#include "Rythmos_DefaultIntegrator.hpp"
+#include "Rythmos_SimpleIntegrationControlStrategy.hpp"
+#include "../SinCos/SinCosModel.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+#include "Thyra_DetachedMultiVectorView.hpp"
+#include "Thyra_DetachedVectorView.hpp"
+
+#include "Teuchos_GlobalMPISession.hpp"
+#include "Teuchos_CommandLineProcessor.hpp"
+#include "Teuchos_StandardCatchMacros.hpp"
+#include "Teuchos_VerboseObject.hpp"
+#include "Teuchos_Time.hpp"
+#include "Teuchos_as.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+//
+// Ensemble throughput benchmark on the SinCos model.  An ensemble of members
+// with different initial conditions is integrated to the final time with
+// fixed step RK4, once with one DefaultIntegrator per member and once as one
+// EnsembleModelEvaluator whose state holds all members as columns of a
+// multi-vector.  Throughput is reported in member steps per second, and the
+// test fails if the ensemble does not beat the separate runs by at least the
+// given speedup.
+//
+
+namespace {
+
+using Teuchos::RCP;
+using Teuchos::Array;
+using Teuchos::ParameterList;
+typedef Thyra::ModelEvaluatorBase MEB;
+
+RCP<Rythmos::DefaultIntegrator<double> > fixedStepIntegrator(
+  const RCP<const Thyra::ModelEvaluator<double> > &model,
+  const MEB::InArgs<double> &ic, double dt, double finalTime
+  )
+{
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Take Variable Steps",false);
+  pl->set("Fixed dt",dt);
+  RCP<Rythmos::DefaultIntegrator<double> > integrator =
+    Rythmos::defaultIntegrator<double>(
+      Rythmos::simpleIntegrationControlStrategy<double>(pl));
+  RCP<Rythmos::ExplicitRKStepper<double> > stepper =
+    Rythmos::explicitRKStepper<double>(model,
+      Rythmos::createRKBT<double>("Explicit 4 Stage"));
+  stepper->setInitialCondition(ic);
+  integrator->setStepper(stepper,finalTime);
+  return integrator;
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+
+  using Teuchos::as;
+
+  bool success = true;
+
+  Teuchos::GlobalMPISession mpiSession(&argc,&argv);
+
+  RCP<Teuchos::FancyOStream>
+    out = Teuchos::VerboseObjectBase::getDefaultOStream();
+
+  try { // catch exceptions
+
+    int numMembers = 100;   // number of ensemble members
+    int numSteps = 1000;    // number of fixed RK4 steps
+    double finalTime = 10.0;
+    double tol = 1.0e-12;   // agreement of the ensemble and separate runs
+    double minSpeedup = 1.5; // required throughput gain of the ensemble
+
+    Teuchos::CommandLineProcessor clp(false); // Don't throw exceptions
+    clp.setOption( "num-members", &numMembers,
+      "Number of members with different initial conditions." );
+    clp.setOption( "num-steps", &numSteps,
+      "Number of fixed RK4 steps up to the final time." );
+    clp.setOption( "T", &finalTime, "Final time for simulation." );
+    clp.setOption( "tol", &tol,
+      "Maximum difference of the ensemble and separate solutions." );
+    clp.setOption( "min-speedup", &minSpeedup,
+      "Minimum ratio of the ensemble and separate throughputs." );
+
+    Teuchos::CommandLineProcessor::EParseCommandLineReturn
+      parse_return = clp.parse(argc,argv);
+    if( parse_return != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL )
+      return parse_return;
+
+    const double dt = finalTime/numSteps;
+
+    // Member k starts on the unit circle at angle 2*pi*k/numMembers.
+    RCP<Rythmos::SinCosModel> memberModel = Rythmos::sinCosModel(false);
+    Array<MEB::InArgs<double> > points;
+    for (int k=0 ; k<numMembers ; ++k) {
+      MEB::InArgs<double> point = memberModel->getNominalValues();
+      RCP<Thyra::VectorBase<double> > x = point.get_x()->clone_v();
+      {
+        const double theta = 2.0*M_PI*k/numMembers;
+        Thyra::DetachedVectorView<double> x_view( *x );
+        x_view[0] = std::sin(theta);
+        x_view[1] = std::cos(theta);
+      }
+      point.set_x(x);
+      points.push_back(point);
+    }
+
+    // Separate integrators
+    Teuchos::Time separateTimer("Separate members");
+    Array<RCP<const Thyra::VectorBase<double> > > x_separate;
+    separateTimer.start(true);
+    for (int k=0 ; k<numMembers ; ++k) {
+      RCP<Rythmos::DefaultIntegrator<double> > integrator =
+        fixedStepIntegrator(memberModel,points[k],dt,finalTime);
+      x_separate.push_back(
+        Rythmos::get_fwd_x<double>(*integrator,finalTime));
+    }
+    separateTimer.stop();
+
+    // One ensemble integrator
+    Teuchos::Time ensembleTimer("Ensemble");
+    ensembleTimer.start(true);
+    RCP<Rythmos::EnsembleModelEvaluator<double> > model =
+      Rythmos::ensembleModelEvaluator<double>(memberModel,points);
+    RCP<Rythmos::DefaultIntegrator<double> > integrator =
+      fixedStepIntegrator(model,model->getNominalValues(),dt,finalTime);
+    RCP<const Thyra::VectorBase<double> > x_bar =
+      Rythmos::get_fwd_x<double>(*integrator,finalTime);
+    ensembleTimer.stop();
+
+    RCP<const Thyra::MultiVectorBase<double> > X =
+      model->getMemberStates(x_bar);
+    double maxDiff = 0.0;
+    {
+      Thyra::ConstDetachedMultiVectorView<double> X_view( *X );
+      for (int k=0 ; k<numMembers ; ++k) {
+        Thyra::ConstDetachedVectorView<double> x_view( *x_separate[k] );
+        maxDiff = std::max(maxDiff, std::fabs(X_view(0,k)-x_view[0]));
+        maxDiff = std::max(maxDiff, std::fabs(X_view(1,k)-x_view[1]));
+      }
+    }
+
+    const double memberSteps = as<double>(numMembers)*numSteps;
+    const double separateTime = separateTimer.totalElapsedTime();
+    const double ensembleTime = ensembleTimer.totalElapsedTime();
+
+    *out << "\nEnsemble benchmark: members = " << numMembers
+         << ", steps = " << numSteps
+         << ", T = " << finalTime << "\n\n";
+    *out << std::setw(12) << "run"
+         << std::setw(14) << "time (s)"
+         << std::setw(22) << "member steps/s" << "\n";
+    *out << std::setw(12) << "separate"
+         << std::setw(14) << separateTime
+         << std::setw(22) << memberSteps/std::max(separateTime,1.0e-12) << "\n";
+    *out << std::setw(12) << "ensemble"
+         << std::setw(14) << ensembleTime
+         << std::setw(22) << memberSteps/std::max(ensembleTime,1.0e-12) << "\n\n";
+    const double speedup = separateTime/std::max(ensembleTime,1.0e-12);
+    *out << "Speedup = " << speedup << "\n";
+    *out << "Max difference = " << maxDiff << "\n";
+
+    if (maxDiff > tol) {
+      *out << "Error, the ensemble and separate solutions differ by "
+           << maxDiff << " > tol = " << tol << "!\n";
+      success = false;
+    }
+    if (speedup < minSpeedup) {
+      *out << "Error, the ensemble speedup " << speedup
+           << " < min-speedup = " << minSpeedup << "!\n";
+      success = false;
+    }
+
+  } // end try
+  TEUCHOS_STANDARD_CATCH_STATEMENTS(true,*out,success)
+
+  if (success)
+    *out << "\nEnd Result: TEST PASSED" << std::endl;
+  else
+    *out << "\nEnd Result: TEST FAILED" << std::endl;
+
+  return success ? 0 : 1;
+
+} // end main() [Doxygen looks for this!]
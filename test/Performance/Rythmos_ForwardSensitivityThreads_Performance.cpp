@@ -0,0 +1,310 @@
+//@HEADER
+
+// ***********************************************************************
+//
+//                     Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_ForwardSensitivityStepper.hpp"
+#include "Rythmos_ExplicitRKStepper.hpp"
+
+#include "Thyra_StateFuncModelEvaluatorBase.hpp"
+#include "Thyra_LinearOpDefaultBase.hpp"
+#include "Thyra_DefaultSpmdVectorSpace.hpp"
+#include "Thyra_DetachedVectorView.hpp"
+#include "Thyra_DetachedMultiVectorView.hpp"
+#include "Thyra_VectorStdOps.hpp"
+#include "Thyra_MultiVectorStdOps.hpp"
+
+#include "Teuchos_GlobalMPISession.hpp"
+#include "Teuchos_CommandLineProcessor.hpp"
+#include "Teuchos_StandardCatchMacros.hpp"
+#include "Teuchos_VerboseObject.hpp"
+#include "Teuchos_Time.hpp"
+#include "Teuchos_as.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+//
+// Thread-parallel sensitivity column benchmark for an explicit model with a
+// matrix-free Jacobian.  The model is
+//
+//   x_dot(i) = -(1/n) * sum_k exp(-|i-k|/w) * x(k) + p(i % np)
+//
+// and d(f)/d(x) is applied without storing it, recomputing the kernel for
+// each column, so each sensitivity column costs O(n^2) exponentials.  The
+// state and np sensitivities are integrated with fixed explicit RK steps
+// once for each number of sensitivity threads, each thread with its own copy
+// of the model, and the run time, speedup and parallel efficiency are
+// reported.  The sensitivities must not depend on the number of threads.
+//
+
+namespace {
+
+using Teuchos::RCP;
+using Teuchos::Array;
+using Teuchos::ParameterList;
+using Thyra::ModelEvaluatorBase;
+
+// Matrix-free y = alpha*scale*K*x + beta*y with K(i,k) = -(1/n)*exp(-|i-k|/w)
+class KernelLinearOp : public Thyra::LinearOpDefaultBase<double>
+{
+public:
+  KernelLinearOp(
+    const RCP<const Thyra::VectorSpaceBase<double> > &space, double width
+    )
+    : space_(space), width_(width), scale_(1.0)
+    {}
+  void setScale(double scale) { scale_ = scale; }
+  RCP<const Thyra::VectorSpaceBase<double> > range() const { return space_; }
+  RCP<const Thyra::VectorSpaceBase<double> > domain() const { return space_; }
+protected:
+  bool opSupportedImpl(Thyra::EOpTransp M_trans) const
+    { return (M_trans == Thyra::NOTRANS || M_trans == Thyra::TRANS); }
+  void applyImpl(
+    const Thyra::EOpTransp /* M_trans */, // K is symmetric
+    const Thyra::MultiVectorBase<double> &X,
+    const Teuchos::Ptr<Thyra::MultiVectorBase<double> > &Y,
+    const double alpha,
+    const double beta
+    ) const
+    {
+      const int n = space_->dim();
+      const double c = -alpha*scale_/n;
+      for (int j=0 ; j<X.domain()->dim() ; ++j) {
+        Thyra::ConstDetachedVectorView<double> x_view( *X.col(j) );
+        Thyra::DetachedVectorView<double> y_view( *Y->col(j) );
+        for (int i=0 ; i<n ; ++i) {
+          double sum = 0.0;
+          for (int k=0 ; k<n ; ++k)
+            sum += std::exp(-std::abs(i-k)/width_)*x_view[k];
+          y_view[i] = c*sum + (beta == 0.0 ? 0.0 : beta*y_view[i]);
+        }
+      }
+    }
+private:
+  RCP<const Thyra::VectorSpaceBase<double> > space_;
+  double width_;
+  double scale_;
+};
+
+class KernelModel : public Thyra::StateFuncModelEvaluatorBase<double>
+{
+public:
+  KernelModel(int n, int np, double width)
+    : x_space_(Thyra::defaultSpmdVectorSpace<double>(n)),
+      p_space_(Thyra::defaultSpmdVectorSpace<double>(np)),
+      width_(width)
+    {
+      ModelEvaluatorBase::InArgsSetup<double> inArgs;
+      inArgs.setModelEvalDescription("KernelModel");
+      inArgs.setSupports(ModelEvaluatorBase::IN_ARG_t);
+      inArgs.setSupports(ModelEvaluatorBase::IN_ARG_x);
+      inArgs.setSupports(ModelEvaluatorBase::IN_ARG_beta);
+      inArgs.set_Np(1);
+      inArgs_ = inArgs;
+      ModelEvaluatorBase::OutArgsSetup<double> outArgs;
+      outArgs.setModelEvalDescription("KernelModel");
+      outArgs.set_Np_Ng(1,0);
+      outArgs.setSupports(ModelEvaluatorBase::OUT_ARG_f);
+      outArgs.setSupports(ModelEvaluatorBase::OUT_ARG_W_op);
+      outArgs.setSupports(ModelEvaluatorBase::OUT_ARG_DfDp,0,
+        ModelEvaluatorBase::DERIV_MV_BY_COL);
+      outArgs_ = outArgs;
+      nominalValues_ = inArgs_;
+      nominalValues_.set_t(0.0);
+      RCP<Thyra::VectorBase<double> > x_ic = Thyra::createMember(x_space_);
+      Thyra::V_S(x_ic.ptr(),1.0);
+      nominalValues_.set_x(x_ic);
+      RCP<Thyra::VectorBase<double> > p_ic = Thyra::createMember(p_space_);
+      Thyra::V_S(p_ic.ptr(),1.0);
+      nominalValues_.set_p(0,p_ic);
+    }
+  RCP<const Thyra::VectorSpaceBase<double> > get_x_space() const
+    { return x_space_; }
+  RCP<const Thyra::VectorSpaceBase<double> > get_f_space() const
+    { return x_space_; }
+  RCP<const Thyra::VectorSpaceBase<double> > get_p_space(int /* l */) const
+    { return p_space_; }
+  ModelEvaluatorBase::InArgs<double> getNominalValues() const
+    { return nominalValues_; }
+  RCP<Thyra::LinearOpBase<double> > create_W_op() const
+    { return Teuchos::rcp(new KernelLinearOp(x_space_,width_)); }
+  ModelEvaluatorBase::InArgs<double> createInArgs() const
+    { return inArgs_; }
+private:
+  ModelEvaluatorBase::OutArgs<double> createOutArgsImpl() const
+    { return outArgs_; }
+  void evalModelImpl(
+    const ModelEvaluatorBase::InArgs<double> &inArgs,
+    const ModelEvaluatorBase::OutArgs<double> &outArgs
+    ) const
+    {
+      const int n = x_space_->dim();
+      const int np = p_space_->dim();
+      const RCP<Thyra::VectorBase<double> > f_out = outArgs.get_f();
+      if (nonnull(f_out)) {
+        KernelLinearOp(x_space_,width_).apply(
+          Thyra::NOTRANS, *inArgs.get_x(), f_out.ptr(), 1.0, 0.0);
+        Thyra::ConstDetachedVectorView<double> p_view( *inArgs.get_p(0) );
+        Thyra::DetachedVectorView<double> f_view( *f_out );
+        for (int i=0 ; i<n ; ++i)
+          f_view[i] += p_view[i % np];
+      }
+      const RCP<Thyra::LinearOpBase<double> > W_out = outArgs.get_W_op();
+      if (nonnull(W_out)) {
+        Teuchos::rcp_dynamic_cast<KernelLinearOp>(W_out,true)->setScale(
+          inArgs.get_beta());
+      }
+      const RCP<Thyra::MultiVectorBase<double> >
+        DfDp_out = outArgs.get_DfDp(0).getMultiVector();
+      if (nonnull(DfDp_out)) {
+        Thyra::DetachedMultiVectorView<double> DfDp_view( *DfDp_out );
+        for (int i=0 ; i<n ; ++i)
+          for (int j=0 ; j<np ; ++j)
+            DfDp_view(i,j) = ( i % np == j ? 1.0 : 0.0 );
+      }
+    }
+  RCP<const Thyra::VectorSpaceBase<double> > x_space_;
+  RCP<const Thyra::VectorSpaceBase<double> > p_space_;
+  double width_;
+  ModelEvaluatorBase::InArgs<double> inArgs_;
+  ModelEvaluatorBase::OutArgs<double> outArgs_;
+  ModelEvaluatorBase::InArgs<double> nominalValues_;
+};
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+
+  using Teuchos::as;
+
+  bool success = true;
+
+  Teuchos::GlobalMPISession mpiSession(&argc,&argv);
+
+  RCP<Teuchos::FancyOStream>
+    out = Teuchos::VerboseObjectBase::getDefaultOStream();
+
+  try { // catch exceptions
+
+    int numStates = 200;    // number of state unknowns
+    int numParams = 64;     // number of sensitivity columns
+    int maxThreads = 4;     // run for 1, 2, 4, ... threads
+    int numSteps = 10;      // fixed explicit RK steps
+    double finalTime = 0.1;
+    double width = 10.0;    // decay length of the kernel
+
+    Teuchos::CommandLineProcessor clp(false); // Don't throw exceptions
+    clp.setOption( "num-states", &numStates, "Number of state unknowns." );
+    clp.setOption( "np", &numParams, "Number of sensitivity parameters." );
+    clp.setOption( "max-threads", &maxThreads,
+      "Largest number of sensitivity threads, run for 1, 2, 4, ..." );
+    clp.setOption( "num-steps", &numSteps, "Number of time steps." );
+    clp.setOption( "T", &finalTime, "Final time for simulation." );
+
+    Teuchos::CommandLineProcessor::EParseCommandLineReturn
+      parse_return = clp.parse(argc,argv);
+    if( parse_return != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL )
+      return parse_return;
+
+    const RCP<KernelModel> model =
+      Teuchos::rcp(new KernelModel(numStates,numParams,width));
+    // The Jacobian scale is mutable state of each Jacobian object, so every
+    // thread gets its own model and Jacobian.
+    Array<RCP<const Thyra::ModelEvaluator<double> > > threadModels;
+    for (int i=1 ; i<maxThreads ; ++i)
+      threadModels.push_back(
+        Teuchos::rcp(new KernelModel(numStates,numParams,width)));
+
+    *out << "\nThreaded sensitivity columns: unknowns = " << numStates
+         << ", np = " << numParams << ", steps = " << numSteps << "\n\n";
+    *out << std::setw(10) << "threads"
+         << std::setw(14) << "time (s)"
+         << std::setw(12) << "speedup"
+         << std::setw(14) << "efficiency" << "\n";
+
+    const double dt = finalTime/numSteps;
+    double serialTime = 0.0;
+    RCP<const Thyra::VectorBase<double> > x_bar_serial;
+    for (int numThreads=1 ; numThreads<=maxThreads ; numThreads*=2) {
+      RCP<ParameterList> fwdSensPL = Teuchos::parameterList();
+      fwdSensPL->set("Number of Sensitivity Threads",numThreads);
+      RCP<Rythmos::ForwardSensitivityStepper<double> >
+        stateAndSensStepper = Rythmos::forwardSensitivityStepper<double>();
+      stateAndSensStepper->setParameterList(fwdSensPL);
+      stateAndSensStepper->setSensitivityThreadModels(threadModels);
+      stateAndSensStepper->initializeSyncedSteppers(
+        model, 0, model->getNominalValues(),
+        Rythmos::explicitRKStepper<double>(model), Teuchos::null );
+      stateAndSensStepper->setInitialCondition(
+        Rythmos::createStateAndSensInitialCondition<double>(
+          *stateAndSensStepper, model->getNominalValues()) );
+
+      const double startTime = Teuchos::Time::wallTime();
+      for (int i=0 ; i<numSteps ; ++i)
+        stateAndSensStepper->takeStep(dt,Rythmos::STEP_TYPE_FIXED);
+      const double wallTime = Teuchos::Time::wallTime() - startTime;
+
+      const RCP<const Thyra::VectorBase<double> >
+        x_bar = stateAndSensStepper->getStepStatus().solution;
+      if (numThreads == 1) {
+        serialTime = wallTime;
+        x_bar_serial = x_bar;
+      }
+      else {
+        // Each column is computed the same way by whichever thread has it.
+        RCP<Thyra::VectorBase<double> > x_bar_diff = x_bar->clone_v();
+        Thyra::Vp_StV(x_bar_diff.ptr(),-1.0,*x_bar_serial);
+        const double diff = Thyra::norm_inf(*x_bar_diff);
+        if (diff != 0.0) {
+          *out << "Error, the result with " << numThreads
+               << " threads differs from the serial result by " << diff
+               << "!\n";
+          success = false;
+        }
+      }
+      const double speedup = serialTime/std::max(wallTime,1.0e-12);
+      *out << std::setw(10) << numThreads
+           << std::setw(14) << wallTime
+           << std::setw(12) << speedup
+           << std::setw(14) << speedup/numThreads << "\n";
+    }
+
+  } // end try
+  TEUCHOS_STANDARD_CATCH_STATEMENTS(true,*out,success)
+
+  if (success)
+    *out << "\nEnd Result: TEST PASSED" << std::endl;
+  else
+    *out << "\nEnd Result: TEST FAILED" << std::endl;
+
+  return success ? 0 : 1;
+
+} // end main() [Doxygen looks for this!]
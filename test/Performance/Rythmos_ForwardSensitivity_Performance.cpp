@@ -0,0 +1,193 @@
+//@HEADER
+
+// ***********************************************************************
+//
+//                     Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_IntegratorBuilder.hpp"
+#include "Rythmos_TimeStepNonlinearSolver.hpp"
+#include "Rythmos_ForwardSensitivityStepper.hpp"
+#include "../UnitTest/Rythmos_UnitTestModels.hpp"
+
+#include "Teuchos_GlobalMPISession.hpp"
+#include "Teuchos_CommandLineProcessor.hpp"
+#include "Teuchos_StandardCatchMacros.hpp"
+#include "Teuchos_VerboseObject.hpp"
+#include "Teuchos_XMLParameterListHelpers.hpp"
+#include "Teuchos_Time.hpp"
+#include "Teuchos_as.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+//
+// Forward sensitivity benchmark on the EpetraExt DiagonalTransientModel.  The
+// state is integrated with fixed Backward Euler steps, once alone and once
+// together with the staggered forward sensitivities for np = 1, 2, 4, ...
+// parameters.  The difference of the two run times is the cost of the
+// sensitivities, which is reported per time step and per sensitivity column.
+// This cost should grow linearly with np, without any allocation of state
+// sized multi-vectors in the sensitivity residual evaluations.
+//
+
+namespace {
+
+using Teuchos::RCP;
+using Teuchos::Array;
+using Teuchos::ParameterList;
+
+RCP<Thyra::ModelEvaluator<double> > createDiagonalModel(
+  int numElements, int numParams, const std::string &linearSolverType
+  )
+{
+  std::ostringstream coeff_s;
+  coeff_s << "{";
+  for (int j=0 ; j<numParams ; ++j)
+    coeff_s << (j==0 ? " " : ", ") << 1.0 + 0.5*(j%8);
+  coeff_s << " }";
+  RCP<ParameterList> paramList = Teuchos::parameterList();
+  ParameterList& stratPL = paramList->sublist(Rythmos::Stratimikos_name);
+  stratPL.set("Linear Solver Type",linearSolverType);
+  stratPL.set("Preconditioner Type","None");
+  ParameterList& modelPL =
+    paramList->sublist(Rythmos::DiagonalTransientModel_name);
+  modelPL.set("NumElements",numElements);
+  modelPL.set("Coeff_s",coeff_s.str());
+  return Rythmos::getDiagonalModel<double>(paramList);
+}
+
+double integrate(
+  const RCP<Thyra::ModelEvaluator<double> > &model, bool withSens,
+  double finalTime, int numSteps
+  )
+{
+  RCP<ParameterList> ibPL = Teuchos::parameterList();
+  ibPL->sublist("Integrator Settings").set("Final Time",finalTime);
+  ibPL->sublist("Stepper Settings").sublist("Stepper Selection").set(
+    "Stepper Type","Backward Euler");
+  ParameterList& controlPL =
+    ibPL->sublist("Integration Control Strategy Selection");
+  controlPL.set("Integration Control Strategy Type",
+    "Simple Integration Control Strategy");
+  controlPL.sublist("Simple Integration Control Strategy").set(
+    "Take Variable Steps",false);
+  controlPL.sublist("Simple Integration Control Strategy").set(
+    "Fixed dt",finalTime/numSteps);
+
+  const Thyra::ModelEvaluatorBase::InArgs<double> ic =
+    model->getNominalValues();
+  RCP<Rythmos::TimeStepNonlinearSolver<double> > nlSolver =
+    Rythmos::timeStepNonlinearSolver<double>();
+  RCP<Rythmos::IntegratorBase<double> > integrator;
+  if (withSens) {
+    integrator = Rythmos::createForwardSensitivityIntegrator<double>(
+      model, 0, ic, nlSolver, ibPL);
+  }
+  else {
+    integrator = Rythmos::integratorBuilder<double>(ibPL)->create(
+      model, ic, nlSolver);
+  }
+
+  Teuchos::Time timer("Forward sensitivity");
+  timer.start(true);
+  Rythmos::get_fwd_x<double>(*integrator,finalTime);
+  timer.stop();
+  return timer.totalElapsedTime();
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+
+  using Teuchos::as;
+
+  bool success = true;
+
+  Teuchos::GlobalMPISession mpiSession(&argc,&argv);
+
+  RCP<Teuchos::FancyOStream>
+    out = Teuchos::VerboseObjectBase::getDefaultOStream();
+
+  try { // catch exceptions
+
+    int numElements = 10000;  // number of state unknowns
+    int maxNumParams = 64;    // largest number of sensitivity parameters
+    int numSteps = 20;        // fixed Backward Euler steps
+    double finalTime = 1.0e-3;
+    std::string linearSolverType = "Amesos";
+
+    Teuchos::CommandLineProcessor clp(false); // Don't throw exceptions
+    clp.setOption( "num-elements", &numElements,
+      "Number of state unknowns of the diagonal model." );
+    clp.setOption( "max-np", &maxNumParams,
+      "Largest number of sensitivity parameters, run for np = 1, 2, 4, ..." );
+    clp.setOption( "num-steps", &numSteps, "Number of time steps." );
+    clp.setOption( "T", &finalTime, "Final time for simulation." );
+    clp.setOption( "linear-solver", &linearSolverType,
+      "Stratimikos linear solver type." );
+
+    Teuchos::CommandLineProcessor::EParseCommandLineReturn
+      parse_return = clp.parse(argc,argv);
+    if( parse_return != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL )
+      return parse_return;
+
+    *out << "\nForward sensitivity benchmark: unknowns = " << numElements
+         << ", steps = " << numSteps
+         << ", T = " << finalTime << "\n\n";
+    *out << std::setw(6) << "np"
+         << std::setw(16) << "state (s)"
+         << std::setw(16) << "with sens (s)"
+         << std::setw(18) << "sens us/step"
+         << std::setw(22) << "sens us/step/column" << "\n";
+
+    for (int np=1 ; np<=maxNumParams ; np*=2) {
+      const RCP<Thyra::ModelEvaluator<double> > model =
+        createDiagonalModel(numElements,np,linearSolverType);
+      const double stateTime = integrate(model,false,finalTime,numSteps);
+      const double sensTime = integrate(model,true,finalTime,numSteps);
+      const double sensPerStep =
+        1.0e6*std::max(sensTime-stateTime,0.0)/numSteps;
+      *out << std::setw(6) << np
+           << std::setw(16) << stateTime
+           << std::setw(16) << sensTime
+           << std::setw(18) << sensPerStep
+           << std::setw(22) << sensPerStep/np << "\n";
+    }
+
+  } // end try
+  TEUCHOS_STANDARD_CATCH_STATEMENTS(true,*out,success)
+
+  if (success)
+    *out << "\nEnd Result: TEST PASSED" << std::endl;
+  else
+    *out << "\nEnd Result: TEST FAILED" << std::endl;
+
+  return success ? 0 : 1;
+
+} // end main() [Doxygen looks for this!]
@@ -0,0 +1,206 @@
+//@HEADER
+
+// ***********************************************************************
+//
+//                     Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_MultirateStepper.hpp"
+#include "Rythmos_ExplicitRKStepper.hpp"
+#include "Rythmos_RKButcherTableau.hpp"
+#include "../KPR/KPRModel.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+
+#include "Teuchos_GlobalMPISession.hpp"
+#include "Teuchos_CommandLineProcessor.hpp"
+#include "Teuchos_StandardCatchMacros.hpp"
+#include "Teuchos_VerboseObject.hpp"
+#include "Teuchos_Time.hpp"
+#include "Teuchos_as.hpp"
+
+#include <iomanip>
+
+//
+// Multirate benchmark on the Kvaerno-Prothero-Robinson problem, whose fast
+// component oscillates with frequency omega = ratio and whose slow component
+// oscillates with frequency one.  The single rate reference takes all of its
+// steps at the fast step size and evaluates both parts at every stage, while
+// the MultirateStepper only evaluates the slow part once per slow stage.
+//
+
+namespace {
+
+using Teuchos::RCP;
+using Teuchos::ParameterList;
+
+RCP<Rythmos::KPRModel> benchmarkModel(
+  bool includeFast, bool includeSlow, double ratio)
+{
+  RCP<Rythmos::KPRModel> model = Rythmos::kprModel();
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Include fast part",includeFast);
+  pl->set("Include slow part",includeSlow);
+  pl->set("Coeff omega",ratio);
+  model->setParameterList(pl);
+  return model;
+}
+
+double relativeError(
+  const Thyra::VectorBase<double>& x,
+  const Thyra::VectorBase<double>& x_exact
+  )
+{
+  RCP<Thyra::VectorBase<double> > err = x.clone_v();
+  Thyra::Vp_StV(err.ptr(), -1.0, x_exact);
+  return Thyra::norm_2(*err)/Thyra::norm_2(x_exact);
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+
+  using Teuchos::as;
+  using Rythmos::STEP_TYPE_FIXED;
+
+  bool success = true;
+
+  Teuchos::GlobalMPISession mpiSession(&argc,&argv);
+
+  RCP<Teuchos::FancyOStream>
+    out = Teuchos::VerboseObjectBase::getDefaultOStream();
+
+  try { // catch exceptions
+
+    double ratio = 100.0;     // time-scale ratio omega
+    double finalTime = 1.0;
+    int slowSteps = 20;       // number of slow steps to finalTime
+    int fastSteps = 50;       // fast steps per slow step
+    double maxError = 1.0e-5; // relative error target of the multirate run
+
+    Teuchos::CommandLineProcessor clp(false); // Don't throw exceptions
+    clp.setOption( "ratio", &ratio,
+      "Ratio of the fast and slow time scales, omega." );
+    clp.setOption( "T", &finalTime, "Final time for simulation." );
+    clp.setOption( "slow-steps", &slowSteps,
+      "Number of slow steps to the final time." );
+    clp.setOption( "fast-steps", &fastSteps,
+      "Number of fast steps per slow step." );
+    clp.setOption( "max-error", &maxError,
+      "Maximum relative error of the multirate solution." );
+
+    Teuchos::CommandLineProcessor::EParseCommandLineReturn
+      parse_return = clp.parse(argc,argv);
+    if( parse_return != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL )
+      return parse_return;
+
+    RCP<Rythmos::KPRModel> fullModel = benchmarkModel(true,true,ratio);
+    RCP<Rythmos::KPRModel> fastModel = benchmarkModel(true,false,ratio);
+    RCP<Rythmos::KPRModel> slowModel = benchmarkModel(false,true,ratio);
+    RCP<const Thyra::VectorBase<double> >
+      x_exact = fullModel->getExactSolution(finalTime).get_x();
+
+    const double slowDt = finalTime/slowSteps;
+    const int totalFastSteps = slowSteps*fastSteps;
+    const double fastDt = finalTime/totalFastSteps;
+
+    // Single rate reference: classic RK4 at the fast step size.
+    Teuchos::Time singleRateTimer("Single rate");
+    RCP<Rythmos::ExplicitRKStepper<double> >
+      erkStepper = Rythmos::explicitRKStepper<double>(fullModel,
+        Teuchos::rcp(new Rythmos::Explicit4Stage4thOrder_RKBT<double>()) );
+    erkStepper->setInitialCondition(fullModel->getNominalValues());
+    singleRateTimer.start(true);
+    for (int i=0 ; i<totalFastSteps ; ++i) {
+      erkStepper->takeStep(fastDt,STEP_TYPE_FIXED);
+    }
+    singleRateTimer.stop();
+    const double singleRateError =
+      relativeError(*erkStepper->getStepStatus().solution,*x_exact);
+    const int singleRateSlowEvals = 4*totalFastSteps;
+    const int singleRateFastEvals = 4*totalFastSteps;
+
+    // Multirate: RK4 fast steps inside the MIS method of Knoth and Wolke.
+    Teuchos::Time multirateTimer("Multirate");
+    RCP<Rythmos::MultirateStepper<double> >
+      mrStepper = Rythmos::multirateStepper<double>(slowModel,fastModel);
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set("Fast Steps per Slow Step",fastSteps);
+    mrStepper->setParameterList(pl);
+    mrStepper->setInitialCondition(fullModel->getNominalValues());
+    multirateTimer.start(true);
+    for (int i=0 ; i<slowSteps ; ++i) {
+      mrStepper->takeStep(slowDt,STEP_TYPE_FIXED);
+    }
+    multirateTimer.stop();
+    const double multirateError =
+      relativeError(*mrStepper->getStepStatus().solution,*x_exact);
+    const int multirateSlowEvals = mrStepper->getNumSlowEvaluations();
+    const int multirateFastEvals = 4*mrStepper->getNumFastSteps();
+
+    *out << "\nMultirate benchmark: omega = " << ratio
+         << ", T = " << finalTime
+         << ", slow dt = " << slowDt
+         << ", fast dt <= " << fastDt << "\n\n";
+    *out << std::setw(12) << "method"
+         << std::setw(16) << "rel. error"
+         << std::setw(14) << "slow evals"
+         << std::setw(14) << "fast evals"
+         << std::setw(14) << "time (s)" << "\n";
+    *out << std::setw(12) << "single rate"
+         << std::setw(16) << singleRateError
+         << std::setw(14) << singleRateSlowEvals
+         << std::setw(14) << singleRateFastEvals
+         << std::setw(14) << singleRateTimer.totalElapsedTime() << "\n";
+    *out << std::setw(12) << "multirate"
+         << std::setw(16) << multirateError
+         << std::setw(14) << multirateSlowEvals
+         << std::setw(14) << multirateFastEvals
+         << std::setw(14) << multirateTimer.totalElapsedTime() << "\n\n";
+
+    if (multirateError > maxError) {
+      *out << "Error, the multirate error " << multirateError
+           << " is larger than max-error = " << maxError << "!\n";
+      success = false;
+    }
+    if (multirateSlowEvals >= singleRateSlowEvals) {
+      *out << "Error, the multirate run did not save slow evaluations!\n";
+      success = false;
+    }
+
+  } // end try
+  TEUCHOS_STANDARD_CATCH_STATEMENTS(true,*out,success)
+
+  if (success)
+    *out << "\nEnd Result: TEST PASSED" << std::endl;
+  else
+    *out << "\nEnd Result: TEST FAILED" << std::endl;
+
+  return success ? 0 : 1;
+
+} // end main() [Doxygen looks for this!]
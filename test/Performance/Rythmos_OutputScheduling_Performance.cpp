@@ -0,0 +1,193 @@
+//@HEADER
+
+// ***********************************************************************
+//
+//                     Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_AdamsStepper.hpp"
+#include "Rythmos_DefaultIntegrator.hpp"
+#include "Rythmos_LoggingIntegrationObserver.hpp"
+#include "../SinCos/SinCosModel.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+
+#include "Teuchos_GlobalMPISession.hpp"
+#include "Teuchos_CommandLineProcessor.hpp"
+#include "Teuchos_StandardCatchMacros.hpp"
+#include "Teuchos_VerboseObject.hpp"
+#include "Teuchos_Time.hpp"
+#include "Teuchos_as.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+//
+// Output scheduling benchmark on the SinCos model.  DefaultIntegrator is
+// asked for a dense grid of output times with the variable order, variable
+// step AdamsStepper.  With natural steps the stepper chooses its own step
+// sizes and all output times inside a step are interpolated in one batch,
+// while "Land On Output Times" cuts a step at every output time.
+//
+
+namespace {
+
+using Teuchos::RCP;
+using Teuchos::Array;
+using Teuchos::ParameterList;
+
+struct OutputRun {
+  int numSteps;
+  double maxError;
+  double time;
+};
+
+OutputRun integrateToOutputTimes(
+  bool landOnOutputTimes, double tol, const Array<double>& time_vec
+  )
+{
+  RCP<Rythmos::SinCosModel> model = Rythmos::sinCosModel(false);
+  RCP<Rythmos::AdamsStepper<double> >
+    stepper = Rythmos::adamsStepper<double>(model);
+  RCP<ParameterList> stepperPL = Teuchos::parameterList();
+  stepperPL->set("Relative Error Tolerance",tol);
+  stepperPL->set("Absolute Error Tolerance",tol);
+  stepper->setParameterList(stepperPL);
+  stepper->setInitialCondition(model->getNominalValues());
+
+  RCP<Rythmos::LoggingIntegrationObserver<double> >
+    observer = Rythmos::createLoggingIntegrationObserver<double>();
+  RCP<Rythmos::DefaultIntegrator<double> >
+    integrator = Rythmos::observedDefaultIntegrator<double>(observer);
+  RCP<ParameterList> integratorPL = Teuchos::parameterList();
+  integratorPL->set("Land On Output Times",landOnOutputTimes);
+  integrator->setParameterList(integratorPL);
+  integrator->setStepper(stepper,time_vec.back());
+
+  Teuchos::Time timer("Output scheduling");
+  Array<RCP<const Thyra::VectorBase<double> > > x_vec;
+  timer.start(true);
+  integrator->getFwdPoints(time_vec,&x_vec,NULL,NULL);
+  timer.stop();
+
+  OutputRun run;
+  run.numSteps = observer->getCounters()->find(
+    observer->nameObserveCompletedTimeStep_)->second;
+  run.time = timer.totalElapsedTime();
+  run.maxError = 0.0;
+  for (int i=0 ; i<Teuchos::as<int>(time_vec.size()) ; ++i) {
+    RCP<Thyra::VectorBase<double> > err = x_vec[i]->clone_v();
+    Thyra::Vp_StV(err.ptr(), -1.0,
+      *model->getExactSolution(time_vec[i]).get_x());
+    run.maxError = std::max(run.maxError,Thyra::norm_inf(*err));
+  }
+  return run;
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+
+  using Teuchos::as;
+
+  bool success = true;
+
+  Teuchos::GlobalMPISession mpiSession(&argc,&argv);
+
+  RCP<Teuchos::FancyOStream>
+    out = Teuchos::VerboseObjectBase::getDefaultOStream();
+
+  try { // catch exceptions
+
+    int numOutputs = 1000;    // number of equally spaced output times
+    double finalTime = 10.0;
+    double tol = 1.0e-8;      // relative and absolute tolerance of Adams
+    double maxError = 1.0e-5; // error target at the output times
+
+    Teuchos::CommandLineProcessor clp(false); // Don't throw exceptions
+    clp.setOption( "num-outputs", &numOutputs,
+      "Number of equally spaced output times up to the final time." );
+    clp.setOption( "T", &finalTime, "Final time for simulation." );
+    clp.setOption( "tol", &tol,
+      "Relative and absolute error tolerance of the Adams stepper." );
+    clp.setOption( "max-error", &maxError,
+      "Maximum error at the output times with natural steps." );
+
+    Teuchos::CommandLineProcessor::EParseCommandLineReturn
+      parse_return = clp.parse(argc,argv);
+    if( parse_return != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL )
+      return parse_return;
+
+    Array<double> time_vec;
+    for (int i=1 ; i<=numOutputs ; ++i) {
+      time_vec.push_back(i*finalTime/numOutputs);
+    }
+
+    const OutputRun natural = integrateToOutputTimes(false,tol,time_vec);
+    const OutputRun landing = integrateToOutputTimes(true,tol,time_vec);
+
+    *out << "\nOutput scheduling benchmark: outputs = " << numOutputs
+         << ", T = " << finalTime
+         << ", tol = " << tol << "\n\n";
+    *out << std::setw(16) << "scheduling"
+         << std::setw(10) << "steps"
+         << std::setw(16) << "max error"
+         << std::setw(14) << "time (s)" << "\n";
+    *out << std::setw(16) << "natural steps"
+         << std::setw(10) << natural.numSteps
+         << std::setw(16) << natural.maxError
+         << std::setw(14) << natural.time << "\n";
+    *out << std::setw(16) << "land on outputs"
+         << std::setw(10) << landing.numSteps
+         << std::setw(16) << landing.maxError
+         << std::setw(14) << landing.time << "\n\n";
+    *out << "Step reduction = "
+         << as<double>(landing.numSteps)/natural.numSteps << "\n";
+
+    if (natural.maxError > maxError) {
+      *out << "Error, the error " << natural.maxError
+           << " with natural steps is larger than max-error = "
+           << maxError << "!\n";
+      success = false;
+    }
+    if (natural.numSteps >= landing.numSteps) {
+      *out << "Error, natural steps did not take fewer steps!\n";
+      success = false;
+    }
+
+  } // end try
+  TEUCHOS_STANDARD_CATCH_STATEMENTS(true,*out,success)
+
+  if (success)
+    *out << "\nEnd Result: TEST PASSED" << std::endl;
+  else
+    *out << "\nEnd Result: TEST FAILED" << std::endl;
+
+  return success ? 0 : 1;
+
+} // end main() [Doxygen looks for this!]
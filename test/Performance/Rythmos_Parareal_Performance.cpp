@@ -0,0 +1,216 @@
+//@HEADER
+
+// ***********************************************************************
+//
+//                     Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_PararealIntegrationDriver.hpp"
+#include "Rythmos_IntegratorBuilder.hpp"
+#include "Rythmos_TimeStepNonlinearSolver.hpp"
+#include "../SinCos/SinCosModel.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+
+#include "Teuchos_GlobalMPISession.hpp"
+#include "Teuchos_CommandLineProcessor.hpp"
+#include "Teuchos_StandardCatchMacros.hpp"
+#include "Teuchos_VerboseObject.hpp"
+#include "Teuchos_Time.hpp"
+#include "Teuchos_as.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+//
+// Strong-scaling benchmark of the parareal driver on the implicit SinCos
+// model.  The fine propagator is backward Euler with small fixed steps and
+// the coarse propagator is backward Euler with a few large fixed steps per
+// slice.  The same problem with a fixed number of time slices is solved with
+// 1, 2, 4, ... threads up to --max-threads, and the wall time, the split
+// between the parallel fine solves and the serial coarse sweeps, and the
+// speedup over a serial fine integration are reported.
+//
+
+namespace {
+
+using Teuchos::RCP;
+using Teuchos::Array;
+using Teuchos::ParameterList;
+
+RCP<ParameterList> fineBuilderPL(double dt, double finalTime)
+{
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->setParameters(
+    *(Rythmos::integratorBuilder<double>()->getValidParameters()));
+  pl->sublist("Integrator Settings").set("Final Time",finalTime);
+  ParameterList &controlPL =
+    pl->sublist("Integration Control Strategy Selection");
+  controlPL.set("Integration Control Strategy Type",
+    "Simple Integration Control Strategy");
+  controlPL.sublist("Simple Integration Control Strategy")
+    .set("Take Variable Steps",false);
+  controlPL.sublist("Simple Integration Control Strategy")
+    .set("Fixed dt",dt);
+  pl->sublist("Stepper Settings").sublist("Stepper Selection")
+    .set("Stepper Type","Backward Euler");
+  return pl;
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+
+  using Teuchos::as;
+
+  bool success = true;
+
+  Teuchos::GlobalMPISession mpiSession(&argc,&argv);
+
+  RCP<Teuchos::FancyOStream>
+    out = Teuchos::VerboseObjectBase::getDefaultOStream();
+
+  try { // catch exceptions
+
+    int numSlices = 16;     // number of time slices
+    int maxThreads = 4;     // largest thread count of the sweep
+    int coarseSteps = 1;    // coarse steps per slice
+    double finalTime = 4.0;
+    double fineDt = 1.0e-4;
+    double tol = 1.0e-8;    // parareal convergence tolerance
+
+    Teuchos::CommandLineProcessor clp(false); // Don't throw exceptions
+    clp.setOption( "num-slices", &numSlices, "Number of time slices." );
+    clp.setOption( "max-threads", &maxThreads,
+      "Largest number of threads of the strong-scaling sweep." );
+    clp.setOption( "coarse-steps", &coarseSteps,
+      "Number of coarse steps per slice." );
+    clp.setOption( "T", &finalTime, "Final time for simulation." );
+    clp.setOption( "fine-dt", &fineDt, "Step size of the fine propagator." );
+    clp.setOption( "tol", &tol, "Parareal convergence tolerance." );
+
+    Teuchos::CommandLineProcessor::EParseCommandLineReturn
+      parse_return = clp.parse(argc,argv);
+    if( parse_return != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL )
+      return parse_return;
+
+    RCP<Rythmos::SinCosModel> model = Rythmos::sinCosModel(true);
+    RCP<Thyra::NonlinearSolverBase<double> > nlSolver =
+      Rythmos::timeStepNonlinearSolver<double>();
+
+    // Serial fine reference
+    RCP<const Thyra::VectorBase<double> > x_fine;
+    double fineTime = 0.0;
+    {
+      RCP<Rythmos::IntegratorBuilder<double> >
+        ib = Rythmos::integratorBuilder<double>();
+      ib->setParameterList(fineBuilderPL(fineDt,finalTime));
+      RCP<Rythmos::IntegratorBase<double> > integrator =
+        ib->create(model,model->getNominalValues(),nlSolver);
+      const double startTime = Teuchos::Time::wallTime();
+      x_fine = Rythmos::get_fwd_x<double>(*integrator,finalTime);
+      fineTime = Teuchos::Time::wallTime() - startTime;
+    }
+
+    Array<RCP<Rythmos::PararealIntegrationDriver<double> > > drivers;
+    Array<RCP<const Thyra::VectorBase<double> > > x_parareal;
+    for (int numThreads=1 ; numThreads<=maxThreads ; numThreads*=2) {
+      RCP<ParameterList> driverPL = Teuchos::parameterList();
+      driverPL->set("Number of Time Slices",numSlices);
+      driverPL->set("Number of Threads",numThreads);
+      driverPL->set("Coarse Steps Per Slice",coarseSteps);
+      driverPL->set("Convergence Tolerance",tol);
+      RCP<Rythmos::PararealIntegrationDriver<double> > driver =
+        Rythmos::pararealIntegrationDriver<double>(
+          model, model->getNominalValues(), nlSolver,
+          fineBuilderPL(fineDt,finalTime), driverPL);
+      x_parareal.push_back(driver->integrate()->clone_v());
+      drivers.push_back(driver);
+    }
+
+    *out << "\nParareal strong scaling: slices = " << numSlices
+         << ", T = " << finalTime
+         << ", fine dt = " << fineDt
+         << ", coarse steps per slice = " << coarseSteps
+         << ", iterations = " << drivers[0]->getNumIterations()
+         << "\n\nSerial fine integration: " << fineTime << " s\n\n";
+    *out << std::setw(10) << "threads"
+         << std::setw(14) << "time (s)"
+         << std::setw(14) << "fine (s)"
+         << std::setw(14) << "coarse (s)"
+         << std::setw(12) << "speedup"
+         << std::setw(14) << "efficiency" << "\n";
+    for (int r=0 ; r<as<int>(drivers.size()) ; ++r) {
+      const double time = std::max(drivers[r]->getWallTime(),1.0e-12);
+      const double speedup = drivers[0]->getWallTime()/time;
+      *out << std::setw(10) << drivers[r]->getNumThreads()
+           << std::setw(14) << time
+           << std::setw(14) << drivers[r]->getFineWallTime()
+           << std::setw(14) << drivers[r]->getCoarseWallTime()
+           << std::setw(12) << speedup
+           << std::setw(14) << speedup/drivers[r]->getNumThreads() << "\n";
+    }
+    *out << "\nSpeedup over the serial fine integration with "
+         << drivers.back()->getNumThreads() << " threads = "
+         << fineTime/std::max(drivers.back()->getWallTime(),1.0e-12)
+         << "\n";
+
+    // All thread counts must give the same answer, which must agree with
+    // the serial fine integration to about the parareal tolerance.
+    double maxDiff = 0.0;
+    for (int r=1 ; r<as<int>(x_parareal.size()) ; ++r) {
+      RCP<Thyra::VectorBase<double> > diff = x_parareal[r]->clone_v();
+      Thyra::Vp_StV(diff.ptr(), -1.0, *x_parareal[0]);
+      maxDiff = std::max(maxDiff, Thyra::norm_inf(*diff));
+    }
+    RCP<Thyra::VectorBase<double> > err = x_parareal[0]->clone_v();
+    Thyra::Vp_StV(err.ptr(), -1.0, *x_fine);
+    const double fineErr = Thyra::norm_inf(*err);
+    *out << "Max difference between thread counts = " << maxDiff << "\n"
+         << "Difference to the serial fine integration = " << fineErr << "\n";
+    if (maxDiff != 0.0) {
+      *out << "Error, the threaded runs differ from the one-thread run!\n";
+      success = false;
+    }
+    if (fineErr > 100.0*tol) {
+      *out << "Error, the parareal solution is not within " << 100.0*tol
+           << " of the serial fine solution!\n";
+      success = false;
+    }
+
+  } // end try
+  TEUCHOS_STANDARD_CATCH_STATEMENTS(true,*out,success)
+
+  if (success)
+    *out << "\nEnd Result: TEST PASSED" << std::endl;
+  else
+    *out << "\nEnd Result: TEST FAILED" << std::endl;
+
+  return success ? 0 : 1;
+
+} // end main() [Doxygen looks for this!]
@@ -0,0 +1,124 @@
+//@HEADER
+
+// ***********************************************************************
+//
+//                     Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+
+#include "Rythmos_StepTrace.hpp"
+
+#include "Teuchos_GlobalMPISession.hpp"
+#include "Teuchos_CommandLineProcessor.hpp"
+#include "Teuchos_StandardCatchMacros.hpp"
+#include "Teuchos_VerboseObject.hpp"
+
+#include <fstream>
+
+//
+// Converts the binary step traces written by Rythmos::writeStepTrace() to CSV
+// or to Chrome trace JSON (load in chrome://tracing or Perfetto).  A trace
+// file may hold several blocks, e.g. one per flush or per thread.
+//
+
+int main(int argc, char *argv[])
+{
+
+  using Teuchos::RCP;
+  using Teuchos::Array;
+
+  bool success = true;
+
+  Teuchos::GlobalMPISession mpiSession(&argc,&argv);
+
+  RCP<Teuchos::FancyOStream>
+    out = Teuchos::VerboseObjectBase::getDefaultOStream();
+
+  try { // catch exceptions
+
+    std::string inputFile = "";
+    std::string outputFile = "";
+    std::string format = "csv";
+
+    Teuchos::CommandLineProcessor clp(false); // Don't throw exceptions
+    clp.setOption( "input", &inputFile, "Binary step trace file to read." );
+    clp.setOption( "output", &outputFile,
+      "File to write, standard output if empty." );
+    clp.setOption( "format", &format, "Output format, \"csv\" or \"chrome\"." );
+
+    Teuchos::CommandLineProcessor::EParseCommandLineReturn
+      parse_return = clp.parse(argc,argv);
+    if( parse_return != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL )
+      return parse_return;
+
+    TEUCHOS_TEST_FOR_EXCEPTION( (format != "csv") && (format != "chrome"),
+      std::logic_error, "Error, unknown format \"" << format << "\"!" );
+
+    std::ifstream in(inputFile.c_str(), std::ios::binary);
+    TEUCHOS_TEST_FOR_EXCEPTION( !in, std::runtime_error,
+      "Error, could not open \"" << inputFile << "\"!" );
+    std::ofstream outFile;
+    if (outputFile.length()) {
+      outFile.open(outputFile.c_str());
+      TEUCHOS_TEST_FOR_EXCEPTION( !outFile, std::runtime_error,
+        "Error, could not open \"" << outputFile << "\"!" );
+    }
+    std::ostream &os = ( outputFile.length() ? outFile : std::cout );
+
+    if (format == "chrome")
+      os << "{\"traceEvents\":[\n";
+    int numBlocks = 0, numRecords = 0;
+    std::size_t numDroppedTotal = 0, numDropped = 0;
+    int threadId = 0;
+    Array<Rythmos::StepTraceRecord> records;
+    while (Rythmos::readStepTrace(in, &threadId, &numDropped, &records)) {
+      if (format == "csv") {
+        Rythmos::writeStepTraceCSV(records, threadId, os, numBlocks == 0);
+      }
+      else if (records.size() > 0) {
+        if (numRecords > 0)
+          os << ",\n";
+        Rythmos::writeStepTraceChromeJSON(records, threadId, os);
+      }
+      ++numBlocks;
+      numRecords += records.size();
+      numDroppedTotal += numDropped;
+      records.clear();
+    }
+    if (format == "chrome")
+      os << "\n]}\n";
+
+    // Report on std::cerr so that the summary does not mix with output
+    // written to std::cout.
+    std::cerr << "Read " << numRecords << " records in " << numBlocks
+         << " blocks, " << numDroppedTotal
+         << " records were dropped when the rings were full.\n";
+
+  } // end try
+  TEUCHOS_STANDARD_CATCH_STATEMENTS(true,*out,success)
+
+  return success ? 0 : 1;
+
+} // end main() [Doxygen looks for this!]
@@ -0,0 +1,234 @@
+//@HEADER
+
+// ***********************************************************************
+//
+//                     Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_ImplicitBDFStepper.hpp"
+#include "Rythmos_TimeStepNonlinearSolver.hpp"
+#include "Rythmos_DefaultIntegrator.hpp"
+#include "Rythmos_IntegratorBase.hpp"
+#include "Rythmos_StepperHelpers.hpp"
+#include "Rythmos_LoggingIntegrationObserver.hpp"
+#include "../SinCos/SinCosModel.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+
+#include "Teuchos_GlobalMPISession.hpp"
+#include "Teuchos_CommandLineProcessor.hpp"
+#include "Teuchos_StandardCatchMacros.hpp"
+#include "Teuchos_VerboseObject.hpp"
+#include "Teuchos_Time.hpp"
+#include "Teuchos_as.hpp"
+
+#include <iomanip>
+
+//
+// Streaming benchmark on the implicit SinCos model.  A coupling loop advances
+// one variable order ImplicitBDFStepper through a large number of short
+// chunks, as an application does when it exchanges data with another code
+// after every chunk.  The chunks are run three ways:
+//
+//   getFwdPoints:  one getFwdPoints() call per chunk with "Land On Output
+//                  Times", which sets up and observes a whole time
+//                  integration every call.
+//   streaming:     DefaultIntegrator::advanceChunk() between one
+//                  beginStreaming() and endStreaming().
+//   restart:       the stepper is restarted at the start of every chunk, as
+//                  a coupling loop does that builds a new integration for
+//                  each chunk, and loses the BDF history and step size.
+//
+
+namespace {
+
+using Teuchos::RCP;
+using Teuchos::Array;
+using Teuchos::ParameterList;
+
+enum EChunkMode { CHUNK_GET_FWD_POINTS, CHUNK_STREAMING, CHUNK_RESTART };
+
+struct ChunkRun {
+  int numSteps;
+  int finalOrder;
+  double error;
+  double time;
+  RCP<Thyra::VectorBase<double> > x;
+};
+
+ChunkRun integrateChunks(
+  EChunkMode mode, int numChunks, double finalTime, double tol
+  )
+{
+  RCP<Rythmos::SinCosModel> model = Rythmos::sinCosModel(true);
+  RCP<ParameterList> stepperPL = Teuchos::parameterList();
+  {
+    ParameterList& pl = stepperPL->sublist("Step Control Settings");
+    pl.set("relErrTol",tol);
+    pl.set("absErrTol",tol);
+    pl.sublist("VerboseObject").set("Verbosity Level","none");
+  }
+  RCP<Rythmos::ImplicitBDFStepper<double> > stepper =
+    Rythmos::implicitBDFStepper<double>(
+      model,Rythmos::timeStepNonlinearSolver<double>(),stepperPL);
+  stepper->setInitialCondition(model->getNominalValues());
+
+  RCP<Rythmos::LoggingIntegrationObserver<double> >
+    observer = Rythmos::createLoggingIntegrationObserver<double>();
+  RCP<Rythmos::DefaultIntegrator<double> >
+    integrator = Rythmos::observedDefaultIntegrator<double>(observer);
+  RCP<ParameterList> integratorPL = Teuchos::parameterList();
+  integratorPL->set("Land On Output Times",true);
+  integrator->setParameterList(integratorPL);
+  integrator->setStepper(stepper,finalTime);
+
+  ChunkRun run;
+  run.x = model->getNominalValues().get_x()->clone_v();
+  Array<double> time_vec(1);
+  Array<RCP<const Thyra::VectorBase<double> > > x_vec;
+
+  Teuchos::Time timer("Streaming");
+  timer.start(true);
+  if (mode == CHUNK_STREAMING)
+    integrator->beginStreaming();
+  for (int i=1 ; i<=numChunks ; ++i) {
+    const double t = (i == numChunks ? finalTime : i*finalTime/numChunks);
+    if (mode == CHUNK_STREAMING) {
+      integrator->advanceChunk(t,run.x.ptr());
+    }
+    else {
+      if (mode == CHUNK_RESTART && i > 1) {
+        Rythmos::restart(&*stepper);
+        integrator->setStepper(stepper,finalTime);
+      }
+      time_vec[0] = t;
+      integrator->getFwdPoints(time_vec,&x_vec,NULL,NULL);
+    }
+  }
+  if (mode == CHUNK_STREAMING)
+    integrator->endStreaming();
+  else
+    Thyra::V_V(run.x.ptr(),*x_vec[0]);
+  timer.stop();
+
+  run.time = timer.totalElapsedTime();
+  run.numSteps = observer->getCounters()->find(
+    observer->nameObserveCompletedTimeStep_)->second;
+  run.finalOrder = stepper->getOrder();
+  RCP<Thyra::VectorBase<double> > err = run.x->clone_v();
+  Thyra::Vp_StV(err.ptr(), -1.0,
+    *model->getExactSolution(finalTime).get_x());
+  run.error = Thyra::norm_inf(*err);
+  return run;
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+
+  bool success = true;
+
+  Teuchos::GlobalMPISession mpiSession(&argc,&argv);
+
+  RCP<Teuchos::FancyOStream>
+    out = Teuchos::VerboseObjectBase::getDefaultOStream();
+
+  try { // catch exceptions
+
+    int numChunks = 100000;   // number of coupling chunks
+    double finalTime = 100.0;
+    double tol = 1.0e-6;      // relative and absolute tolerance of BDF
+    bool runRestart = true;
+
+    Teuchos::CommandLineProcessor clp(false); // Don't throw exceptions
+    clp.setOption( "num-chunks", &numChunks,
+      "Number of equally long chunks up to the final time." );
+    clp.setOption( "T", &finalTime, "Final time for simulation." );
+    clp.setOption( "tol", &tol,
+      "Relative and absolute error tolerance of the BDF stepper." );
+    clp.setOption( "restart", "no-restart", &runRestart,
+      "Also run the chunks with a stepper restart per chunk." );
+
+    Teuchos::CommandLineProcessor::EParseCommandLineReturn
+      parse_return = clp.parse(argc,argv);
+    if( parse_return != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL )
+      return parse_return;
+
+    Array<std::string> names;
+    Array<ChunkRun> runs;
+    names.push_back("getFwdPoints");
+    runs.push_back(
+      integrateChunks(CHUNK_GET_FWD_POINTS,numChunks,finalTime,tol));
+    names.push_back("streaming");
+    runs.push_back(integrateChunks(CHUNK_STREAMING,numChunks,finalTime,tol));
+    if (runRestart) {
+      names.push_back("restart");
+      runs.push_back(integrateChunks(CHUNK_RESTART,numChunks,finalTime,tol));
+    }
+
+    *out << "\nStreaming benchmark: chunks = " << numChunks
+         << ", T = " << finalTime
+         << ", tol = " << tol << "\n\n";
+    *out << std::setw(14) << "chunks by"
+         << std::setw(10) << "steps"
+         << std::setw(8) << "order"
+         << std::setw(16) << "error"
+         << std::setw(14) << "time (s)"
+         << std::setw(18) << "us per chunk" << "\n";
+    for (int k=0 ; k<Teuchos::as<int>(runs.size()) ; ++k) {
+      *out << std::setw(14) << names[k]
+           << std::setw(10) << runs[k].numSteps
+           << std::setw(8) << runs[k].finalOrder
+           << std::setw(16) << runs[k].error
+           << std::setw(14) << runs[k].time
+           << std::setw(18) << 1.0e6*runs[k].time/numChunks << "\n";
+    }
+    *out << "\nSpeedup of streaming over getFwdPoints = "
+         << runs[0].time/runs[1].time << "\n";
+
+    // Streaming takes exactly the steps of getFwdPoints() landing on the end
+    // of each chunk.
+    RCP<Thyra::VectorBase<double> > diff = runs[1].x->clone_v();
+    Thyra::Vp_StV(diff.ptr(), -1.0, *runs[0].x);
+    const double maxDiff = Thyra::norm_inf(*diff);
+    *out << "Difference of streaming from getFwdPoints = " << maxDiff << "\n";
+    if (runs[1].numSteps != runs[0].numSteps || maxDiff > 1.0e-12) {
+      *out << "Error, streaming did not reproduce getFwdPoints!\n";
+      success = false;
+    }
+
+  } // end try
+  TEUCHOS_STANDARD_CATCH_STATEMENTS(true,*out,success)
+
+  if (success)
+    *out << "\nEnd Result: TEST PASSED" << std::endl;
+  else
+    *out << "\nEnd Result: TEST FAILED" << std::endl;
+
+  return success ? 0 : 1;
+
+} // end main() [Doxygen looks for this!]
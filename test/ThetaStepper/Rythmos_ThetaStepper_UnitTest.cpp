@@ -122,6 +122,31 @@ TEUCHOS_UNIT_TEST( Rythmos_ThetaStepper, createTrapezoid) {
   TEST_EQUALITY_CONST( dt_taken, dt );
 }
 
+TEUCHOS_UNIT_TEST( Rythmos_ThetaStepper, performanceCounters ) {
+  RCP<SinCosModel> model = sinCosModel(true);
+  RCP<TimeStepNonlinearSolver<double> > solver = 
+    timeStepNonlinearSolver<double>();
+  RCP<ParameterList> stepperParamList = Teuchos::parameterList();
+  ParameterList& pl = stepperParamList->sublist("Step Control Settings");
+  pl.set("Theta Stepper Type", "Trapezoid");
+  RCP<ThetaStepper<double> > stepper = 
+    thetaStepper<double>(model, solver, stepperParamList);
+  stepper->setInitialCondition(model->getNominalValues());
+  TEST_EQUALITY_CONST( stepper->getPerformanceCounters().numSteps, 0 );
+  const int N = 3;
+  for (int i=0 ; i<N ; ++i) {
+    double dt_taken = stepper->takeStep(0.1,STEP_TYPE_FIXED);
+    TEST_EQUALITY_CONST( dt_taken, 0.1 );
+  }
+  StepperPerformanceCounters counters = stepper->getPerformanceCounters();
+  TEST_EQUALITY_CONST( counters.numSteps, N );
+  TEST_COMPARE( counters.numNonlinearIterations, >=, N );
+  TEST_EQUALITY( counters.numResidualEvaluations, counters.numNonlinearIterations );
+  TEST_EQUALITY( counters.numJacobianEvaluations, counters.numNonlinearIterations );
+  TEST_EQUALITY( counters.numLinearSolves, counters.numNonlinearIterations );
+  TEST_EQUALITY_CONST( counters.numRejectedSteps, 0 );
+}
+
 TEUCHOS_UNIT_TEST( Rythmos_ThetaStepper, createThetaStepper ) {
   // Verify the builder operates correctly for ThetaStepper
   RCP<StepperBuilder<double> > builder = stepperBuilder<double>();
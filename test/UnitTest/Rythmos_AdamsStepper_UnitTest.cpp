@@ -0,0 +1,133 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_UnitTestHelpers.hpp"
+#include "Rythmos_AdamsStepper.hpp"
+#include "../SinCos/SinCosModel.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+
+namespace Rythmos {
+
+using Thyra::VectorBase;
+
+namespace {
+
+double solutionError(
+  const VectorBase<double>& x, const SinCosModel& model, double t)
+{
+  RCP<VectorBase<double> > err = x.clone_v();
+  Thyra::Vp_StV(err.ptr(), -1.0, *model.getExactSolution(t).get_x());
+  return Thyra::norm_2(*err);
+}
+
+} // namespace
+
+
+TEUCHOS_UNIT_TEST( Rythmos_AdamsStepper, create ) {
+  RCP<AdamsStepper<double> > stepper = adamsStepper<double>();
+  TEST_ASSERT( !is_null(stepper) );
+  TEST_ASSERT( !stepper->isImplicit() );
+  TEST_ASSERT( stepper->supportsCloning() );
+  TEST_EQUALITY( stepper->getOrder(), -1 );
+  TEST_ASSERT( !stepper->getTimeRange().isValid() );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_AdamsStepper, invalidOrders ) {
+  RCP<AdamsStepper<double> > stepper = adamsStepper<double>();
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Maximum Order",13);
+  TEST_THROW( stepper->setParameterList(pl), std::logic_error );
+  pl = Teuchos::parameterList();
+  pl->set("Minimum Order",3);
+  pl->set("Maximum Order",2);
+  TEST_THROW( stepper->setParameterList(pl), std::logic_error );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_AdamsStepper, evaluationCounts ) {
+  // One evaluation at the initial condition, then one for the predictor and
+  // one for each corrector evaluation per step.
+  RCP<SinCosModel> model = sinCosModel(false);
+  for (int m=0 ; m<=2 ; ++m) {
+    RCP<AdamsStepper<double> > stepper = adamsStepper<double>(model);
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set("Corrector Evaluations",m);
+    stepper->setParameterList(pl);
+    stepper->setInitialCondition(model->getNominalValues());
+    for (int i=0 ; i<4 ; ++i) {
+      TEST_EQUALITY( stepper->takeStep(0.1,STEP_TYPE_FIXED), 0.1 );
+    }
+    TEST_EQUALITY( stepper->getNumModelEvaluations(), 1+4*(1+m) );
+  }
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_AdamsStepper, variableStepAccuracy ) {
+  RCP<SinCosModel> model = sinCosModel(false);
+  RCP<AdamsStepper<double> > stepper = adamsStepper<double>(model);
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Relative Error Tolerance",1.0e-8);
+  pl->set("Absolute Error Tolerance",1.0e-8);
+  stepper->setParameterList(pl);
+  stepper->setInitialCondition(model->getNominalValues());
+  const double finalTime = 1.0;
+  double time = 0.0;
+  int maxOrder = 0;
+  while (time < finalTime) {
+    TEST_COMPARE( stepper->takeStep(finalTime-time,STEP_TYPE_VARIABLE), >, 0.0 );
+    maxOrder = std::max(maxOrder,stepper->getOrder());
+    time = stepper->getStepStatus().time;
+  }
+  TEST_FLOATING_EQUALITY( time, finalTime, 1.0e-14 );
+  // The order is raised well beyond that of the start-up steps.
+  TEST_COMPARE( maxOrder, >=, 4 );
+  const double err =
+    solutionError(*stepper->getStepStatus().solution,*model,finalTime);
+  out << "err = " << err << ", f evals = "
+      << stepper->getNumModelEvaluations() << std::endl;
+  TEST_COMPARE( err, <, 1.0e-6 );
+
+  // Interpolate inside the last step.
+  const TimeRange<double> range = stepper->getTimeRange();
+  const double t = 0.5*(range.lower()+range.upper());
+  Array<double> time_vec;
+  time_vec.push_back(t);
+  Array<RCP<const VectorBase<double> > > x_vec;
+  stepper->getPoints(time_vec,&x_vec,0,0);
+  TEST_EQUALITY( Teuchos::as<int>(x_vec.size()), 1 );
+  TEST_COMPARE( solutionError(*x_vec[0],*model,t), <, 1.0e-6 );
+}
+
+
+} // namespace Rythmos
+
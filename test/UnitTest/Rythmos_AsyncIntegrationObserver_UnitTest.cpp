@@ -0,0 +1,342 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_UnitTestHelpers.hpp"
+
+#include "Rythmos_AsyncIntegrationObserver.hpp"
+#include "Rythmos_StepperSnapshot.hpp"
+#include "Rythmos_DefaultIntegrator.hpp"
+#include "Rythmos_ExplicitRKStepper.hpp"
+#include "Rythmos_BackwardEulerStepper.hpp"
+#include "Rythmos_TimeStepNonlinearSolver.hpp"
+#include "Rythmos_SimpleIntegrationControlStrategy.hpp"
+#include "Rythmos_RampingIntegrationControlStrategy.hpp"
+#include "Rythmos_MockStepperDecorator.hpp"
+#include "Rythmos_MockIntegrationObserver.hpp"
+
+#include "../SinCos/SinCosModel.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+
+#include "Teuchos_XMLParameterListHelpers.hpp"
+
+#ifdef HAVE_RYTHMOS_THREADS
+#  include <chrono>
+#  include <thread>
+#endif
+
+
+namespace Rythmos {
+
+
+using Teuchos::getParametersFromXmlString;
+
+
+namespace {
+
+
+// Records the time and the first solution component of each completed step.
+class RecordingIntegrationObserver
+  : public IntegrationObserverBase<double>
+{
+public:
+  RCP<IntegrationObserverBase<double> > cloneIntegrationObserver() const
+    { return Teuchos::rcp(new RecordingIntegrationObserver()); }
+  void resetIntegrationObserver(const TimeRange<double> &)
+    { times.clear(); x0.clear(); }
+  void observeCompletedTimeStep(
+    const StepperBase<double> &stepper,
+    const StepControlInfo<double> &,
+    const int
+    )
+    {
+      const StepStatus<double> stepStatus = stepper.getStepStatus();
+      times.push_back(stepStatus.time);
+      x0.push_back(Thyra::get_ele(*stepStatus.solution,0));
+    }
+  Array<double> times;
+  Array<double> x0;
+};
+
+
+// Checks that every start of step is followed by the completion of the same
+// step, and takes its time over each completed step so that the queue of an
+// asynchronous observer fills up.
+class SlowPairingIntegrationObserver
+  : public RecordingIntegrationObserver
+{
+public:
+  SlowPairingIntegrationObserver()
+    : numUnpaired(0), openStep_(-1)
+    {}
+  RCP<IntegrationObserverBase<double> > cloneIntegrationObserver() const
+    { return Teuchos::rcp(new SlowPairingIntegrationObserver()); }
+  void observeStartTimeStep(
+    const StepperBase<double> &,
+    const StepControlInfo<double> &,
+    const int timeStepIter
+    )
+    {
+      if (openStep_ >= 0)
+        ++numUnpaired;
+      openStep_ = timeStepIter;
+    }
+  void observeCompletedTimeStep(
+    const StepperBase<double> &stepper,
+    const StepControlInfo<double> &stepCtrlInfo,
+    const int timeStepIter
+    )
+    {
+      if (openStep_ != timeStepIter)
+        ++numUnpaired;
+      openStep_ = -1;
+#ifdef HAVE_RYTHMOS_THREADS
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+#endif
+      RecordingIntegrationObserver::observeCompletedTimeStep(
+        stepper, stepCtrlInfo, timeStepIter);
+    }
+  int numUnpaired;
+private:
+  int openStep_;
+};
+
+
+// Integrate SinCos to t = 1 with 20 fixed RK4 steps.
+void integrateSinCos(const RCP<IntegrationObserverBase<double> > &observer)
+{
+  const double finalTime = 1.0;
+  RCP<SinCosModel> model = sinCosModel(false);
+  RCP<StepperBase<double> > stepper = explicitRKStepper<double>(model);
+  stepper->setInitialCondition(model->getNominalValues());
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Take Variable Steps",false);
+  pl->set("Fixed dt",0.05);
+  RCP<DefaultIntegrator<double> > integrator = defaultIntegrator<double>();
+  integrator->setIntegrationControlStrategy(
+    simpleIntegrationControlStrategy<double>(pl) );
+  integrator->setIntegrationObserver(observer);
+  integrator->setStepper(stepper,finalTime);
+  get_fwd_x<double>(*integrator,finalTime);
+}
+
+
+RCP<ParameterList> asyncParameters(
+  bool asynchronous, int queueCapacity, const std::string &backpressure,
+  int batchSize
+  )
+{
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Asynchronous",asynchronous);
+  pl->set("Queue Capacity",queueCapacity);
+  pl->set("Backpressure Policy",backpressure);
+  pl->set("Batch Size",batchSize);
+  return pl;
+}
+
+
+} // namespace
+
+
+TEUCHOS_UNIT_TEST( Rythmos_AsyncIntegrationObserver, callOrder )
+{
+  for (int i = 0; i < 2; ++i) {
+    const bool asynchronous = (i == 1);
+    out << "Asynchronous = " << asynchronous << std::endl;
+
+    // Same scenario as the failRampingTimestep DefaultIntegrator test.
+    const RCP<SinCosModel> model = sinCosModel(true);
+    const RCP<BackwardEulerStepper<double> > beStepper =
+      backwardEulerStepper<double>(model, timeStepNonlinearSolver<double>());
+    const RCP<MockStepperDecorator<double> > stepper =
+      createMockStepperDecorator<double>(beStepper);
+    stepper->setFailOnStepId(3);
+    stepper->setInitialCondition(model->getNominalValues());
+    const RCP<DefaultIntegrator<double> > integrator =
+      defaultIntegrator<double>();
+    integrator->setIntegrationControlStrategy(
+      rampingIntegrationControlStrategy<double>(
+        getParametersFromXmlString(
+          "<ParameterList name=\"Ramping\">"
+          "  <Parameter name=\"Initial dt\" type=\"double\" value=\"0.2\"/>"
+          "</ParameterList>"
+          ) ) );
+
+    RCP<MockIntegrationObserver<double> > mockObserver =
+      createMockIntegrationObserver<double>();
+    std::list<std::string> call_stack;
+    call_stack.push_back(mockObserver->nameResetIntegrationObserver_);
+    call_stack.push_back(mockObserver->nameObserveStartTimeIntegration_);
+    for (int step = 0; step < 3; ++step) {
+      call_stack.push_back(mockObserver->nameObserveStartTimeStep_);
+      call_stack.push_back(mockObserver->nameObserveCompletedTimeStep_);
+    }
+    call_stack.push_back(mockObserver->nameObserveStartTimeStep_);
+    call_stack.push_back(mockObserver->nameObserveFailedTimeStep_);
+    for (int step = 0; step < 2; ++step) {
+      call_stack.push_back(mockObserver->nameObserveStartTimeStep_);
+      call_stack.push_back(mockObserver->nameObserveCompletedTimeStep_);
+    }
+    call_stack.push_back(mockObserver->nameObserveEndTimeIntegration_);
+    mockObserver->setCallStack(call_stack);
+
+    RCP<AsyncIntegrationObserver<double> > observer =
+      asyncIntegrationObserver<double>(mockObserver,
+        asyncParameters(asynchronous,4,"Block",3) );
+    integrator->setIntegrationObserver(observer);
+
+    integrator->setStepper(stepper, 1.0);
+    get_fwd_x<double>(*integrator, 1.0);
+
+    // Everything but the reset goes through the queue.
+    TEST_EQUALITY( observer->getNumDelivered(), 14 );
+    TEST_EQUALITY( observer->getNumDropped(), 0 );
+    TEST_EQUALITY( observer->getNumCoalesced(), 0 );
+  }
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_AsyncIntegrationObserver, recordedStates )
+{
+  RCP<RecordingIntegrationObserver> gold =
+    Teuchos::rcp(new RecordingIntegrationObserver());
+  integrateSinCos(gold);
+  TEST_EQUALITY( gold->times.size(), 20 );
+
+  for (int i = 0; i < 2; ++i) {
+    const bool asynchronous = (i == 1);
+    out << "Asynchronous = " << asynchronous << std::endl;
+    RCP<RecordingIntegrationObserver> recorder =
+      Teuchos::rcp(new RecordingIntegrationObserver());
+    integrateSinCos(
+      asyncIntegrationObserver<double>(recorder,
+        asyncParameters(asynchronous,2,"Block",2) ) );
+    TEST_COMPARE_ARRAYS( recorder->times, gold->times );
+    TEST_COMPARE_ARRAYS( recorder->x0, gold->x0 );
+  }
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_AsyncIntegrationObserver, backpressureAccounting )
+{
+  // 1 start and 1 end of integration, 20 starts and 20 completed steps.
+  const int numSteps = 20;
+  const int numEvents = 2 + 2*numSteps;
+  const Array<std::string> policies =
+    Teuchos::tuple<std::string>("Drop","Coalesce");
+  for (int i = 0; i < Teuchos::as<int>(policies.size()); ++i) {
+    out << "Backpressure Policy = " << policies[i] << std::endl;
+    RCP<SlowPairingIntegrationObserver> slowObserver =
+      Teuchos::rcp(new SlowPairingIntegrationObserver());
+    RCP<AsyncIntegrationObserver<double> > observer =
+      asyncIntegrationObserver<double>(slowObserver,
+        asyncParameters(true,4,policies[i],1) );
+    integrateSinCos(observer);
+    const int numSkipped =
+      observer->getNumDropped() + observer->getNumCoalesced();
+    // A skipped step takes its start of step event with it.
+    TEST_EQUALITY( observer->getNumDelivered() + 2*numSkipped, numEvents );
+    TEST_EQUALITY( Teuchos::as<int>(slowObserver->times.size()),
+      numSteps - numSkipped );
+    TEST_EQUALITY_CONST( slowObserver->numUnpaired, 0 );
+    if (observer->isAsynchronous()) {
+      // The wrapped observer takes 10ms per step while the integrator takes
+      // a few microseconds, so the queue must have overflowed.
+      if (policies[i] == "Drop") {
+        TEST_COMPARE( observer->getNumDropped(), >, 0 );
+        TEST_EQUALITY_CONST( observer->getNumCoalesced(), 0 );
+      }
+      else {
+        TEST_COMPARE( observer->getNumCoalesced(), >, 0 );
+        TEST_EQUALITY_CONST( observer->getNumDropped(), 0 );
+        // Coalescing keeps the newest state, so the last step is delivered.
+        TEST_FLOATING_EQUALITY( slowObserver->times.back(), 1.0, 1.0e-12 );
+      }
+    }
+    else {
+      TEST_EQUALITY( observer->getNumDelivered(), numEvents );
+    }
+  }
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_AsyncIntegrationObserver, invalidParameters )
+{
+  RCP<AsyncIntegrationObserver<double> > observer =
+    asyncIntegrationObserver<double>(
+      Teuchos::rcp(new RecordingIntegrationObserver()) );
+  TEST_THROW( observer->setParameterList(asyncParameters(true,2,"Block",3)),
+    std::logic_error );
+  TEST_THROW( observer->setParameterList(asyncParameters(true,0,"Block",1)),
+    std::logic_error );
+  TEST_THROW( observer->setParameterList(asyncParameters(true,2,"Wait",1)),
+    std::exception );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_StepperSnapshot, capture )
+{
+  RCP<SinCosModel> model = sinCosModel(false);
+  RCP<StepperBase<double> > stepper = explicitRKStepper<double>(model);
+  stepper->setInitialCondition(model->getNominalValues());
+  stepper->takeStep(0.1,STEP_TYPE_FIXED);
+  stepper->takeStep(0.1,STEP_TYPE_FIXED);
+
+  RCP<StepperSnapshot<double> > snapshot = stepperSnapshot<double>();
+  TEST_ASSERT( !snapshot->hasSnapshot() );
+  snapshot->capture(*stepper);
+  TEST_ASSERT( snapshot->hasSnapshot() );
+
+  const TimeRange<double> timeRange = snapshot->getTimeRange();
+  TEST_FLOATING_EQUALITY( timeRange.lower(), stepper->getTimeRange().lower(),
+    1.0e-14 );
+  TEST_FLOATING_EQUALITY( timeRange.upper(), 0.2, 1.0e-14 );
+  TEST_EQUALITY( snapshot->getOrder(), stepper->getOrder() );
+  TEST_EQUALITY( snapshot->getPerformanceCounters().numSteps, 2 );
+
+  const RCP<const Thyra::VectorBase<double> > x = get_x(*snapshot,timeRange.upper());
+  const RCP<const Thyra::VectorBase<double> > x_gold =
+    get_x(*stepper,timeRange.upper());
+  TEST_FLOATING_EQUALITY( Thyra::get_ele(*x,0), Thyra::get_ele(*x_gold,0),
+    1.0e-14 );
+  TEST_FLOATING_EQUALITY( Thyra::get_ele(*x,1), Thyra::get_ele(*x_gold,1),
+    1.0e-14 );
+
+  // The snapshot does not follow the stepper.
+  stepper->takeStep(0.1,STEP_TYPE_FIXED);
+  TEST_FLOATING_EQUALITY( snapshot->getTimeRange().upper(), 0.2, 1.0e-14 );
+
+  TEST_THROW( snapshot->takeStep(0.1,STEP_TYPE_FIXED), std::logic_error );
+  TEST_THROW( get_x(*snapshot,0.1), std::logic_error );
+}
+
+
+} // namespace Rythmos
@@ -49,6 +49,29 @@ TEUCHOS_UNIT_TEST( Rythmos_BackwardEulerStepper, clone ) {
   }
 }
 
+TEUCHOS_UNIT_TEST( Rythmos_BackwardEulerStepper, performanceCounters ) {
+  RCP<SinCosModel> model = sinCosModel(true);
+  RCP<Thyra::NonlinearSolverBase<double> > neSolver = timeStepNonlinearSolver<double>();
+  RCP<BackwardEulerStepper<double> > stepper = backwardEulerStepper<double>(model,neSolver);
+  stepper->setInitialCondition(model->getNominalValues());
+  TEST_EQUALITY_CONST( stepper->getPerformanceCounters().numSteps, 0 );
+  const int N = 5;
+  for (int i=0 ; i<N ; ++i) {
+    double dt_taken = stepper->takeStep(0.1,STEP_TYPE_FIXED);
+    TEST_ASSERT( dt_taken == 0.1 );
+  }
+  StepperPerformanceCounters counters = stepper->getPerformanceCounters();
+  TEST_EQUALITY_CONST( counters.numSteps, N );
+  TEST_COMPARE( counters.numNonlinearIterations, >=, N );
+  // TimeStepNonlinearSolver does one f/W evaluation and one linear solve per
+  // Newton iteration.
+  TEST_EQUALITY( counters.numResidualEvaluations, counters.numNonlinearIterations );
+  TEST_EQUALITY( counters.numJacobianEvaluations, counters.numNonlinearIterations );
+  TEST_EQUALITY( counters.numLinearSolves, counters.numNonlinearIterations );
+  TEST_EQUALITY_CONST( counters.numRejectedSteps, 0 );
+  TEST_EQUALITY_CONST( counters.numOrderChanges, 0 );
+}
+
 TEUCHOS_UNIT_TEST( Rythmos_BackwardEulerStepper, momento_create ) {
   RCP<const MomentoBase<double> > momento;
   {
@@ -150,6 +173,86 @@ TEUCHOS_UNIT_TEST( Rythmos_BackwardEulerStepper, restart ) {
   }
 }
 
+TEUCHOS_UNIT_TEST( Rythmos_BackwardEulerStepper, serializeMomento ) {
+  Array<RCP<StateSerializerStrategy<double> > > sss_array;
+  sss_array.push_back(rcp(new XMLStateSerializerStrategy<double>()));
+  sss_array.push_back(rcp(new BinaryStateSerializerStrategy<double>()));
+  int N = Teuchos::as<int>(sss_array.size());
+  for (int n=0 ; n<N; ++n) {
+    StateSerializerStrategy<double>& sss = *sss_array[n];
+    std::string data;
+    // place to store solution at time = 1.0
+    RCP<const VectorBase<double> > x_norestart;
+    RCP<const VectorBase<double> > xdot_norestart;
+    // Step to t = 0.5, serialize the momento, then step the rest of the way to t = 1.0.
+    {
+      RCP<SinCosModel> model = sinCosModel(true);
+      Thyra::ModelEvaluatorBase::InArgs<double> model_ic = model->getNominalValues();
+      RCP<Thyra::NonlinearSolverBase<double> > neSolver = timeStepNonlinearSolver<double>();
+      RCP<BackwardEulerStepper<double> > stepper = backwardEulerStepper<double>(model,neSolver);
+      stepper->setInitialCondition(model_ic);
+      double dt = 0.1;
+      // Step to t=0.5
+      for (int i=0 ; i<5 ; ++i) {
+        double dt_taken = stepper->takeStep(dt,STEP_TYPE_FIXED);
+        TEST_ASSERT( dt_taken == dt );
+      }
+      std::ostringstream oStream;
+      stepper->getMomento()->serialize(sss,oStream);
+      data = oStream.str();
+      // Step to t=1.0
+      for (int i=0 ; i<5 ; ++i) {
+        double dt_taken = stepper->takeStep(dt,STEP_TYPE_FIXED);
+        TEST_ASSERT( dt_taken == dt );
+      }
+      Array<double> time_vec;
+      time_vec.push_back(1.0);
+      Array<RCP<const VectorBase<double> > > x_vec;
+      Array<RCP<const VectorBase<double> > > xdot_vec;
+      stepper->getPoints(time_vec,&x_vec,&xdot_vec,0);
+      x_norestart = x_vec[0]->clone_v();
+      xdot_norestart = xdot_vec[0]->clone_v();
+    }
+    // Read the data into the momento of a stepper at t = 0 and restart from it.
+    {
+      RCP<SinCosModel> model = sinCosModel(true);
+      RCP<Thyra::NonlinearSolverBase<double> > neSolver = timeStepNonlinearSolver<double>();
+      RCP<MomentoBase<double> > stepper_momento;
+      {
+        RCP<BackwardEulerStepper<double> > stepper = backwardEulerStepper<double>(model,neSolver);
+        stepper->setInitialCondition(model->getNominalValues());
+        stepper_momento = stepper->getMomento()->clone();
+      }
+      std::istringstream iStream(data);
+      stepper_momento->deSerialize(sss,iStream);
+      RCP<BackwardEulerStepper<double> > stepper = backwardEulerStepper<double>();
+      stepper->setMomento(stepper_momento.ptr(),model,neSolver);
+      TEST_FLOATING_EQUALITY( stepper->getTimeRange().upper(), 0.5, 1.0e-14 );
+
+      double dt = 0.1;
+      // Step to t=1.0
+      for (int i=0 ; i<5 ; ++i) {
+        double dt_taken = stepper->takeStep(dt,STEP_TYPE_FIXED);
+        TEST_ASSERT( dt_taken == dt );
+      }
+      Array<double> time_vec;
+      time_vec.push_back(1.0);
+      Array<RCP<const VectorBase<double> > > x_vec;
+      Array<RCP<const VectorBase<double> > > xdot_vec;
+      stepper->getPoints(time_vec,&x_vec,&xdot_vec,0);
+
+      // Verify that the restarted solution matches
+      double tol = 1.0e-10;
+      RCP<VectorBase<double> > x_diff = createMember(x_vec[0]->space());
+      V_VmV( x_diff.ptr(), *x_norestart, *x_vec[0] );
+      TEST_COMPARE( norm(*x_diff), <, tol );
+      RCP<VectorBase<double> > xdot_diff = createMember(x_vec[0]->space());
+      V_VmV( xdot_diff.ptr(), *xdot_norestart, *xdot_vec[0] );
+      TEST_COMPARE( norm(*xdot_diff), <, tol );
+    }
+  }
+}
+
 TEUCHOS_UNIT_TEST( Rythmos_BackwardEulerStepper, checkConsistentState ) {
   {
     RCP<SinCosModel> model = sinCosModel(true);
@@ -0,0 +1,246 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_UnitTestHelpers.hpp"
+
+#include "Rythmos_CFLStepControlStrategy.hpp"
+#include "Rythmos_ExplicitRKStepper.hpp"
+#include "Rythmos_RKButcherTableauBuilder.hpp"
+
+#include "../SinCos/SinCosModel.hpp"
+
+#include "Thyra_DetachedVectorView.hpp"
+#include "Thyra_DefaultSpmdVectorSpace.hpp"
+#include "Thyra_ModelEvaluatorDelegatorBase.hpp"
+#include "Thyra_VectorStdOps.hpp"
+
+#include "Teuchos_ParameterList.hpp"
+
+namespace Rythmos {
+
+using Teuchos::ParameterList;
+using Teuchos::parameterList;
+
+namespace {
+
+// Adds the wave speed response g(0)[k] = c[k]*x(1) to a model, so the
+// analytic CFL limit is dt = CFL*C/(max|c[k]|*|x(1)|).
+class WaveSpeedModel
+  : virtual public Thyra::ModelEvaluatorDelegatorBase<double>
+{
+public:
+  WaveSpeedModel(
+    const RCP<const Thyra::ModelEvaluator<double> > &model,
+    const Array<double> &c
+    )
+    : c_(c),
+      g_space_(Thyra::defaultSpmdVectorSpace<double>(c.size()))
+    {
+      this->Thyra::ModelEvaluatorDelegatorBase<double>::initialize(model);
+    }
+  RCP<const Thyra::VectorSpaceBase<double> > get_g_space(int j) const
+    {
+      TEUCHOS_ASSERT_EQUALITY( j, 0 );
+      return g_space_;
+    }
+private:
+  Thyra::ModelEvaluatorBase::OutArgs<double> createOutArgsImpl() const
+    {
+      typedef Thyra::ModelEvaluatorBase MEB;
+      MEB::OutArgsSetup<double> outArgs;
+      outArgs.setModelEvalDescription(this->description());
+      outArgs.set_Np_Ng(0,1);
+      outArgs.setSupports(MEB::OUT_ARG_f);
+      return outArgs;
+    }
+  void evalModelImpl(
+    const Thyra::ModelEvaluatorBase::InArgs<double> &inArgs,
+    const Thyra::ModelEvaluatorBase::OutArgs<double> &outArgs
+    ) const
+    {
+      typedef Thyra::ModelEvaluatorBase MEB;
+      const RCP<const Thyra::ModelEvaluator<double> >
+        model = this->getUnderlyingModel();
+      MEB::InArgs<double> modelInArgs = model->createInArgs();
+      modelInArgs.setArgs(inArgs);
+      MEB::OutArgs<double> modelOutArgs = model->createOutArgs();
+      modelOutArgs.set_f(outArgs.get_f());
+      model->evalModel(modelInArgs,modelOutArgs);
+      const RCP<VectorBase<double> > g = outArgs.get_g(0);
+      if (nonnull(g)) {
+        const Thyra::ConstDetachedVectorView<double> x_view(*inArgs.get_x());
+        Thyra::DetachedVectorView<double> g_view(*g);
+        for (int k = 0; k < Teuchos::as<int>(c_.size()); ++k)
+          g_view[k] = c_[k]*x_view[1];
+      }
+    }
+  Array<double> c_;
+  RCP<const Thyra::VectorSpaceBase<double> > g_space_;
+};
+
+} // namespace
+
+TEUCHOS_UNIT_TEST( Rythmos_CFLStepControlStrategy, create ) {
+  RCP<CFLStepControlStrategy<double> > scs =
+    rcp(new CFLStepControlStrategy<double>());
+  TEST_EQUALITY_CONST( is_null(scs), false );
+  TEST_EQUALITY( scs->getCurrentState(), UNINITIALIZED );
+  TEST_EQUALITY_CONST( scs->supportsCloning(), true );
+  RCP<StepControlStrategyBase<double> > scs_clone =
+    scs->cloneStepControlStrategyAlgorithm();
+  TEST_EQUALITY_CONST( is_null(scs_clone), false );
+}
+
+TEUCHOS_UNIT_TEST( Rythmos_CFLStepControlStrategy, validParameters ) {
+  RCP<CFLStepControlStrategy<double> > scs =
+    rcp(new CFLStepControlStrategy<double>());
+  RCP<const ParameterList> validPL = scs->getValidParameters();
+  TEST_EQUALITY_CONST( validPL->get<int>("Max Wave Speed Response Index"), 0 );
+  TEST_EQUALITY_CONST( validPL->get<bool>("Use SSP Coefficient"), true );
+  {
+    RCP<ParameterList> pl = parameterList();
+    pl->set("CFL Number", 0.5);
+    TEST_NOTHROW( scs->setParameterList(pl) );
+  }
+  {
+    RCP<ParameterList> pl = parameterList();
+    pl->set("CFL Number", -0.5);
+    TEST_THROW( scs->setParameterList(pl), std::logic_error );
+  }
+  {
+    RCP<ParameterList> pl = parameterList();
+    pl->set("Min Step Size", 1.0);
+    pl->set("Max Step Size", 0.5);
+    TEST_THROW( scs->setParameterList(pl), std::logic_error );
+  }
+  {
+    RCP<ParameterList> pl = parameterList();
+    pl->set("Step Size Decrease Factor", 1.5);
+    TEST_THROW( scs->setParameterList(pl), std::logic_error );
+  }
+}
+
+TEUCHOS_UNIT_TEST( Rythmos_CFLStepControlStrategy, invalidResponseIndex ) {
+  RCP<SinCosModel> model = sinCosModel(false);
+  RCP<RKButcherTableauBase<double> > rkbt =
+    createRKBT<double>("Explicit 3 Stage 3rd order TVD");
+  RCP<ExplicitRKStepper<double> > stepper =
+    explicitRKStepper<double>(model,rkbt);
+  stepper->setInitialCondition(model->getNominalValues());
+  {
+    RCP<CFLStepControlStrategy<double> > scs =
+      rcp(new CFLStepControlStrategy<double>());
+    TEST_NOTHROW( scs->initialize(*stepper) );
+    TEST_EQUALITY( scs->getCurrentState(), BEFORE_FIRST_STEP );
+  }
+  {
+    RCP<CFLStepControlStrategy<double> > scs =
+      rcp(new CFLStepControlStrategy<double>());
+    RCP<ParameterList> pl = parameterList();
+    pl->set("Max Wave Speed Response Index", 1);
+    scs->setParameterList(pl);
+    TEST_THROW( scs->initialize(*stepper), std::logic_error );
+  }
+}
+
+TEUCHOS_UNIT_TEST( Rythmos_CFLStepControlStrategy, fixedStepSize ) {
+  RCP<SinCosModel> model = sinCosModel(false);
+  RCP<ExplicitRKStepper<double> > stepper = explicitRKStepper<double>(model);
+  stepper->setInitialCondition(model->getNominalValues());
+  RCP<CFLStepControlStrategy<double> > scs =
+    rcp(new CFLStepControlStrategy<double>());
+  double dt = 0.1;
+  StepSizeType stepType = STEP_TYPE_FIXED;
+  int order = 0;
+  scs->setRequestedStepSize(*stepper, dt, stepType);
+  scs->nextStepSize(*stepper, &dt, &stepType, &order);
+  TEST_EQUALITY_CONST( dt, 0.1 );
+  TEST_EQUALITY( scs->getCurrentState(), MID_STEP );
+  scs->setCorrection(*stepper, Teuchos::null, Teuchos::null, -1);
+  TEST_EQUALITY_CONST( scs->acceptStep(*stepper, NULL), false );
+  TEST_EQUALITY( scs->rejectStep(*stepper), REP_ERR_FAIL );
+}
+
+TEUCHOS_UNIT_TEST( Rythmos_CFLStepControlStrategy, cflLimit ) {
+  // Wave speeds over mesh size of 2, 5 and 3 at x(1) = 1.
+  Array<double> c;
+  c.push_back(2.0);
+  c.push_back(-5.0);
+  c.push_back(3.0);
+  const double maxWaveSpeed = 5.0;
+  const double cfl = 0.8;
+  RCP<SinCosModel> sinCos = sinCosModel(false);
+  RCP<WaveSpeedModel> model = rcp(new WaveSpeedModel(sinCos,c));
+  // SSP coefficients: 1 for the 3 stage TVD method, s-1 = 3 for the 4 stage
+  // 2nd order SSP method.
+  Array<std::string> rkbtNames;
+  rkbtNames.push_back("Explicit 3 Stage 3rd order TVD");
+  rkbtNames.push_back("Explicit s Stage 2nd order SSP");
+  Array<double> sspCoef;
+  sspCoef.push_back(1.0);
+  sspCoef.push_back(3.0);
+  for (int i = 0; i < Teuchos::as<int>(rkbtNames.size()); ++i) {
+    for (int useSSP = 0; useSSP < 2; ++useSSP) {
+      RCP<ExplicitRKStepper<double> > stepper =
+        explicitRKStepper<double>(model,createRKBT<double>(rkbtNames[i]));
+      stepper->setInitialCondition(model->getNominalValues());
+      RCP<CFLStepControlStrategy<double> > scs =
+        rcp(new CFLStepControlStrategy<double>());
+      RCP<ParameterList> pl = parameterList();
+      pl->set("CFL Number", cfl);
+      pl->set("Use SSP Coefficient", useSSP == 1);
+      scs->setParameterList(pl);
+      stepper->setStepControlStrategy(scs);
+      const double C = (useSSP == 1 ? sspCoef[i] : 1.0);
+
+      // First step at x(1) = 1
+      const double x1 = Thyra::get_ele(*stepper->getStepStatus().solution,1);
+      TEST_FLOATING_EQUALITY( x1, 1.0, 1.0e-14 );
+      double dt = stepper->takeStep(10.0, STEP_TYPE_VARIABLE);
+      TEST_FLOATING_EQUALITY( dt, cfl*C/maxWaveSpeed, 1.0e-14 );
+      TEST_FLOATING_EQUALITY( scs->getStableStepSize(), dt, 1.0e-14 );
+
+      // The next step uses the wave speed at the new state.
+      const double x1_new =
+        Thyra::get_ele(*stepper->getStepStatus().solution,1);
+      dt = stepper->takeStep(10.0, STEP_TYPE_VARIABLE);
+      TEST_FLOATING_EQUALITY( dt, cfl*C/(maxWaveSpeed*std::abs(x1_new)),
+        1.0e-12 );
+
+      // The requested step size bounds the stable one.
+      dt = stepper->takeStep(1.0e-3, STEP_TYPE_VARIABLE);
+      TEST_FLOATING_EQUALITY( dt, 1.0e-3, 1.0e-14 );
+    }
+  }
+}
+
+} // namespace Rythmos
+
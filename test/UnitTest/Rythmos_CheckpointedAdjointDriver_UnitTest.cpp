@@ -0,0 +1,274 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_UnitTestHelpers.hpp"
+#include "Rythmos_CheckpointedAdjointDriver.hpp"
+#include "Rythmos_AdjointModelEvaluator.hpp"
+#include "Rythmos_BackwardEulerStepper.hpp"
+#include "Rythmos_TimeStepNonlinearSolver.hpp"
+#include "../SinCos/SinCosModel.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+
+namespace Rythmos {
+
+
+namespace {
+
+
+RCP<BackwardEulerStepper<double> > createSinCosStepper()
+{
+  RCP<SinCosModel> model = sinCosModel(true);
+  RCP<BackwardEulerStepper<double> > stepper =
+    backwardEulerStepper<double>(model, timeStepNonlinearSolver<double>());
+  stepper->setInitialCondition(model->getNominalValues());
+  return stepper;
+}
+
+
+double maxDiff(const VectorBase<double> &x, const VectorBase<double> &y)
+{
+  RCP<VectorBase<double> > diff = x.clone_v();
+  Thyra::Vp_StV(diff.ptr(), -1.0, y);
+  return Thyra::norm_inf(*diff);
+}
+
+
+} // namespace
+
+
+TEUCHOS_UNIT_TEST( Rythmos_CheckpointedAdjointDriver, binomialSchedule ) {
+  // Forward steps taken to reverse l steps from a checkpoint with s free
+  // checkpoints, minimized over every place of the next checkpoint.
+  const int maxSteps = 30;
+  const int maxFree = 4;
+  Array<Array<long> > F(maxSteps+1, Array<long>(maxFree+1, 0));
+  for (int l = 1; l <= maxSteps; ++l) {
+    F[l][0] = (l*(l+1))/2;
+    for (int s = 1; s <= maxFree; ++s) {
+      F[l][s] = (l == 1 ? 1 : F[l][s-1]);
+      for (int m = 1; m < l; ++m)
+        F[l][s] = std::min(F[l][s], m + F[l-m][s-1] + F[m][s]);
+    }
+  }
+  for (int l = 1; l <= maxSteps; ++l) {
+    for (int s = 0; s <= maxFree; ++s) {
+      TEST_EQUALITY( binomialCheckpointRecomputations(l,s+1), F[l][s]-l );
+      if (l > 1 && s > 0) {
+        const int m = binomialCheckpointAdvance(l,s);
+        TEST_COMPARE( m, >=, 1 );
+        TEST_COMPARE( m, <, l );
+        TEST_EQUALITY( m + F[l-m][s-1] + F[m][s], F[l][s] );
+      }
+    }
+  }
+  // One checkpoint recomputes everything before each step, one checkpoint
+  // per step recomputes each step but the last once.
+  TEST_EQUALITY_CONST( binomialCheckpointRecomputations(10,1), 45 );
+  TEST_EQUALITY_CONST( binomialCheckpointRecomputations(10,10), 9 );
+  TEST_EQUALITY_CONST( binomialCheckpointRange(3,2), 10 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_CheckpointedAdjointDriver, invalidUse ) {
+  RCP<CheckpointedAdjointDriver<double> > driver =
+    checkpointedAdjointDriver<double>(createSinCosStepper());
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Number of Checkpoints", 0);
+  TEST_THROW( driver->setParameterList(pl), std::logic_error );
+  Array<double> time_vec(1, 0.5);
+  Array<RCP<const VectorBase<double> > > x_vec;
+  TEST_THROW( driver->getPoints(time_vec, &x_vec, 0, 0), std::logic_error );
+  TEST_THROW( driver->integrateForward(1.0, 0), std::logic_error );
+  driver->integrateForward(1.0, 4);
+  time_vec[0] = 1.5;
+  TEST_THROW( driver->getPoints(time_vec, &x_vec, 0, 0), std::out_of_range );
+  TEST_THROW( driver->removeNodes(time_vec), std::logic_error );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_CheckpointedAdjointDriver, reverseStates ) {
+  const int numSteps = 20;
+  const int numCheckpoints = 4;
+  const double finalTime = 1.0;
+  const double dt = finalTime/numSteps;
+
+  // Reference states in the middle of each step.
+  Array<double> t_mid;
+  Array<RCP<const VectorBase<double> > > x_ref, xdot_ref;
+  {
+    RCP<BackwardEulerStepper<double> > stepper = createSinCosStepper();
+    for (int i = 0; i < numSteps; ++i) {
+      stepper->takeStep(dt, STEP_TYPE_FIXED);
+      const TimeRange<double> range = stepper->getTimeRange();
+      Array<double> time_vec(1, range.lower() + 0.5*range.length());
+      Array<RCP<const VectorBase<double> > > x_vec, xdot_vec;
+      stepper->getPoints(time_vec, &x_vec, &xdot_vec, 0);
+      t_mid.push_back(time_vec[0]);
+      x_ref.push_back(x_vec[0]);
+      xdot_ref.push_back(xdot_vec[0]);
+    }
+  }
+
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Number of Checkpoints", numCheckpoints);
+  RCP<CheckpointedAdjointDriver<double> > driver =
+    checkpointedAdjointDriver<double>(createSinCosStepper(), pl);
+  driver->integrateForward(finalTime, numSteps);
+  TEST_EQUALITY( driver->getNumForwardSteps(), numSteps );
+  TEST_EQUALITY_CONST( driver->getNumRecomputedSteps(), 0 );
+  TEST_COMPARE( driver->getNumCheckpoints(), <=, numCheckpoints );
+  TEST_FLOATING_EQUALITY( driver->getTimeRange().upper(), finalTime, 1.0e-14 );
+
+  for (int i = numSteps-1; i >= 0; --i) {
+    Array<double> time_vec(1, t_mid[i]);
+    Array<RCP<const VectorBase<double> > > x_vec, xdot_vec;
+    driver->getPoints(time_vec, &x_vec, &xdot_vec, 0);
+    TEST_COMPARE( maxDiff(*x_vec[0], *x_ref[i]), <=, 1.0e-14 );
+    TEST_COMPARE( maxDiff(*xdot_vec[0], *xdot_ref[i]), <=, 1.0e-14 );
+  }
+  TEST_EQUALITY( driver->getNumRecomputedSteps(),
+    binomialCheckpointRecomputations(numSteps, numCheckpoints) );
+  TEST_EQUALITY_CONST( driver->getNumCheckpoints(), 1 );
+  TEST_COMPARE( driver->getRecomputationRatio(), >, 0.0 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_CheckpointedAdjointDriver, diskCheckpointInterval ) {
+  // Without disk checkpoints, or with a disk slower than recomputing, the
+  // steps are not split.
+  TEST_EQUALITY_CONST( binomialDiskCheckpointInterval(20,1,0,0.0), 20 );
+  TEST_EQUALITY_CONST( binomialDiskCheckpointInterval(20,1,3,1.0e6), 20 );
+  // A free disk is used as much as it can be.
+  const int K = binomialDiskCheckpointInterval(20,1,3,0.0);
+  TEST_COMPARE( K, <, 20 );
+  TEST_COMPARE( (20-1)/K, <=, 3 );
+  TEST_EQUALITY_CONST( K, 5 );
+  // A slower disk is used less.
+  TEST_COMPARE( binomialDiskCheckpointInterval(20,1,3,20.0), >=, K );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_CheckpointedAdjointDriver, reverseStatesFromDisk ) {
+  const int numSteps = 20;
+  const int numCheckpoints = 2;
+  const int numDiskCheckpoints = 3;
+  const double finalTime = 1.0;
+  const double dt = finalTime/numSteps;
+
+  // Reference states at the end of each step.
+  Array<RCP<const VectorBase<double> > > x_ref;
+  {
+    RCP<BackwardEulerStepper<double> > stepper = createSinCosStepper();
+    for (int i = 0; i < numSteps; ++i) {
+      stepper->takeStep(dt, STEP_TYPE_FIXED);
+      x_ref.push_back(stepper->getStepStatus().solution->clone_v());
+    }
+  }
+
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Number of Checkpoints", numCheckpoints);
+  pl->set("Number of Disk Checkpoints", numDiskCheckpoints);
+  pl->set("Disk Access Cost", 0.0);
+  RCP<CheckpointedAdjointDriver<double> > driver =
+    checkpointedAdjointDriver<double>(createSinCosStepper(), pl);
+  driver->integrateForward(finalTime, numSteps);
+  const int interval = driver->getDiskCheckpointInterval();
+  TEST_EQUALITY( interval,
+    binomialDiskCheckpointInterval(numSteps, numCheckpoints,
+      numDiskCheckpoints, 0.0) );
+  TEST_COMPARE( interval, <, numSteps );
+  TEST_EQUALITY( driver->getNumDiskCheckpoints(), (numSteps-1)/interval );
+  TEST_EQUALITY_CONST( driver->getNumDiskReads(), 0 );
+
+  Array<double> nodes;
+  driver->getNodes(&nodes);
+  TEST_EQUALITY( Teuchos::as<int>(nodes.size()), numSteps+1 );
+  for (int i = numSteps-1; i >= 0; --i) {
+    Array<double> time_vec(1, nodes[i+1]);
+    Array<RCP<const VectorBase<double> > > x_vec;
+    driver->getPoints(time_vec, &x_vec, 0, 0);
+    TEST_COMPARE( maxDiff(*x_vec[0], *x_ref[i]), <=, 1.0e-14 );
+  }
+  // Each disk checkpoint is read once.
+  TEST_EQUALITY( driver->getNumDiskReads(), driver->getNumDiskCheckpoints() );
+  TEST_COMPARE( driver->getDiskWallTime(), >=, 0.0 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_CheckpointedAdjointDriver, integrateAdjoint ) {
+  const int numSteps = 10;
+  const int numCheckpoints = 3;
+  const double finalTime = 1.0;
+
+  RCP<BackwardEulerStepper<double> > fwdStepper = createSinCosStepper();
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Number of Checkpoints", numCheckpoints);
+  RCP<CheckpointedAdjointDriver<double> > driver =
+    checkpointedAdjointDriver<double>(fwdStepper, pl);
+  driver->integrateForward(finalTime, numSteps);
+
+  // The model is linear, so the adjoint does not depend on the forward
+  // states and can be checked against an adjoint without them.
+  Array<RCP<const VectorBase<double> > > lambda;
+  for (int k = 0; k < 2; ++k) {
+    RCP<AdjointModelEvaluator<double> > adjModel =
+      adjointModelEvaluator<double>(fwdStepper->getModel(), driver->getTimeRange());
+    if (k == 0)
+      adjModel->setFwdStateSolutionBuffer(driver);
+    Thyra::ModelEvaluatorBase::InArgs<double> adj_ic = adjModel->getNominalValues();
+    RCP<VectorBase<double> > lambda_ic = createMember(adjModel->get_x_space());
+    RCP<VectorBase<double> > lambda_dot_ic = createMember(adjModel->get_x_space());
+    Thyra::V_S(lambda_ic.ptr(), 1.0);
+    Thyra::V_S(lambda_dot_ic.ptr(), 0.0);
+    adj_ic.set_x(lambda_ic);
+    adj_ic.set_x_dot(lambda_dot_ic);
+    RCP<BackwardEulerStepper<double> > adjStepper =
+      backwardEulerStepper<double>(adjModel, timeStepNonlinearSolver<double>());
+    adjStepper->setInitialCondition(adj_ic);
+    if (k == 0) {
+      driver->integrateAdjoint(adjStepper.ptr());
+    }
+    else {
+      for (int i = 0; i < numSteps; ++i)
+        adjStepper->takeStep(finalTime/numSteps, STEP_TYPE_FIXED);
+    }
+    lambda.push_back(adjStepper->getStepStatus().solution);
+  }
+  TEST_COMPARE( maxDiff(*lambda[0], *lambda[1]), <=, 1.0e-12 );
+  TEST_COMPARE( driver->getNumRecomputedSteps(), >, 0 );
+  TEST_COMPARE( driver->getNumRecomputedSteps(), <=,
+    binomialCheckpointRecomputations(numSteps, numCheckpoints) );
+}
+
+
+} // namespace Rythmos
+
@@ -0,0 +1,121 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_UnitTestHelpers.hpp"
+#include "Rythmos_DefaultBreakPointInformer.hpp"
+
+
+namespace Rythmos {
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DefaultBreakPointInformer, nextBreakPoint )
+{
+  RCP<DefaultBreakPointInformer<double> > informer =
+    defaultBreakPointInformer<double>();
+  informer->addBreakPoint(2.0,BREAK_POINT_TYPE_SOFT);
+  informer->addBreakPoint(1.0);
+  informer->addBreakPoint(3.0,BREAK_POINT_TYPE_SOFT);
+  informer->addBreakPoint(3.0,BREAK_POINT_TYPE_HARD);
+  TEST_EQUALITY( informer->getNumBreakPoints(), 3 );
+
+  double t = 0.0;
+  TEST_EQUALITY( informer->getNextBreakPoint(t), 1.0 );
+  TEST_EQUALITY( informer->getNextBreakPointType(t), BREAK_POINT_TYPE_HARD );
+  t = 1.0;
+  TEST_EQUALITY( informer->getNextBreakPoint(t), 2.0 );
+  TEST_EQUALITY( informer->getNextBreakPointType(t), BREAK_POINT_TYPE_SOFT );
+  // A time within round-off of a breakpoint has reached it.
+  t = 2.0 - 1.0e-15;
+  TEST_EQUALITY( informer->getNextBreakPoint(t), 3.0 );
+  TEST_EQUALITY( informer->getNextBreakPointType(t), BREAK_POINT_TYPE_HARD );
+  t = 3.0;
+  TEST_EQUALITY( informer->getNextBreakPoint(t),
+    Teuchos::ScalarTraits<double>::rmax() );
+  TEST_THROW( informer->getNextBreakPointType(t), std::logic_error );
+
+  informer->clearBreakPoints();
+  TEST_EQUALITY( informer->getNumBreakPoints(), 0 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DefaultBreakPointInformer, testForBreakPoint )
+{
+  RCP<DefaultBreakPointInformer<double> > informer =
+    defaultBreakPointInformer<double>();
+  informer->addBreakPoint(1.0);
+  double t = 0.5;
+  double dt = 0.4;
+  TEST_ASSERT( !informer->testForBreakPoint(t,dt) );
+  dt = 0.5;
+  TEST_ASSERT( informer->testForBreakPoint(t,dt) );
+  dt = 1.0;
+  TEST_ASSERT( informer->testForBreakPoint(t,dt) );
+  t = 1.0;
+  TEST_ASSERT( !informer->testForBreakPoint(t,dt) );
+
+  t = 0.0;
+  informer->removeNextBreakPoint(t);
+  TEST_EQUALITY( informer->getNumBreakPoints(), 0 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DefaultBreakPointInformer, setParameterList )
+{
+  Array<double> hardBreakPoints;
+  hardBreakPoints.push_back(0.5);
+  hardBreakPoints.push_back(1.5);
+  Array<double> softBreakPoints(1,1.0);
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Hard Break Points",hardBreakPoints);
+  pl->set("Soft Break Points",softBreakPoints);
+  RCP<DefaultBreakPointInformer<double> > informer =
+    defaultBreakPointInformer<double>();
+  informer->setParameterList(pl);
+  TEST_EQUALITY( informer->getNumBreakPoints(), 3 );
+  double t = 0.5;
+  TEST_EQUALITY( informer->getNextBreakPoint(t), 1.0 );
+  TEST_EQUALITY( informer->getNextBreakPointType(t), BREAK_POINT_TYPE_SOFT );
+  t = 1.0;
+  TEST_EQUALITY( informer->getNextBreakPointType(t), BREAK_POINT_TYPE_HARD );
+  // Setting a list again replaces the breakpoints instead of adding to them.
+  informer->addBreakPoint(2.0);
+  informer->setParameterList(pl);
+  TEST_EQUALITY( informer->getNumBreakPoints(), 3 );
+  RCP<ParameterList> softOnly = Teuchos::parameterList();
+  softOnly->set("Soft Break Points",hardBreakPoints);
+  informer->setParameterList(softOnly);
+  TEST_EQUALITY( informer->getNumBreakPoints(), 2 );
+  t = 0.0;
+  TEST_EQUALITY( informer->getNextBreakPointType(t), BREAK_POINT_TYPE_SOFT );
+}
+
+
+} // namespace Rythmos
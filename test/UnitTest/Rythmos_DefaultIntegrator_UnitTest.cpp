@@ -32,9 +32,11 @@
 #include "Rythmos_UnitTestHelpers.hpp"
 
 #include "Rythmos_ExplicitRKStepper.hpp"
+#include "Rythmos_ImplicitBDFStepper.hpp"
 #include "Rythmos_RKButcherTableauBuilder.hpp"
 
 #include "../SinCos/SinCosModel.hpp"
+#include "../DampedOscillator/DampedOscillatorModel.hpp"
 
 #include "Rythmos_DefaultIntegrator.hpp"
 #include "Rythmos_InterpolationBuffer.hpp"
@@ -46,8 +48,11 @@
 #include "Rythmos_MockIntegrationObserver.hpp"
 #include "Rythmos_LoggingIntegrationObserver.hpp"
 #include "Rythmos_CompositeIntegrationObserver.hpp"
+#include "Rythmos_DefaultBreakPointInformer.hpp"
 
 #include "Thyra_DetachedVectorView.hpp"
+#include "Thyra_DefaultSpmdVectorSpace.hpp"
+#include "Thyra_ModelEvaluatorDelegatorBase.hpp"
 
 #include "Teuchos_ParameterList.hpp"
 #include "Teuchos_XMLParameterListHelpers.hpp"
@@ -60,6 +65,143 @@ using Teuchos::getParametersFromXmlString;
 using Thyra::VectorBase;
 
 
+namespace {
+
+
+RCP<DampedOscillatorModel> oscillatorModel(bool implicit, double lambda)
+{
+  RCP<DampedOscillatorModel> model = dampedOscillatorModel();
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Implicit model formulation",implicit);
+  pl->set("Coeff lambda",lambda);
+  model->setParameterList(pl);
+  return model;
+}
+
+
+// Integrate the damped oscillator to t = 1 with fixed steps of 0.01,
+// starting with the explicit or the implicit stepper and switching between
+// RK4 and Backward Euler.
+RCP<DefaultIntegrator<double> > switchingIntegrator(
+  bool startImplicit, double lambda, double finalTime)
+{
+  RCP<DampedOscillatorModel> explicitModel = oscillatorModel(false,lambda);
+  RCP<DampedOscillatorModel> implicitModel = oscillatorModel(true,lambda);
+  RCP<StepperBase<double> > erkStepper = explicitRKStepper<double>(
+    explicitModel, createRKBT<double>("Explicit 4 Stage"));
+  RCP<StepperBase<double> > beStepper = backwardEulerStepper<double>(
+    implicitModel, timeStepNonlinearSolver<double>());
+  erkStepper->setInitialCondition(explicitModel->getNominalValues());
+  beStepper->setInitialCondition(implicitModel->getNominalValues());
+
+  RCP<DefaultIntegrator<double> > integrator = defaultIntegrator<double>();
+  if (startImplicit) {
+    integrator->setStepper(beStepper, finalTime);
+    integrator->setStiffnessSwitchingStepper(erkStepper);
+  }
+  else {
+    integrator->setStepper(erkStepper, finalTime);
+    integrator->setStiffnessSwitchingStepper(beStepper);
+  }
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Take Variable Steps",false);
+  pl->set("Fixed dt",0.01);
+  RCP<SimpleIntegrationControlStrategy<double> > intCont =
+    simpleIntegrationControlStrategy<double>(pl);
+  intCont->resetIntegrationControlStrategy(TimeRange<double>(0.0,finalTime));
+  integrator->setIntegrationControlStrategy(intCont);
+  return integrator;
+}
+
+
+// Adds the response g(0) = x(0) - levels to a model, one event function for
+// each level.
+class LevelCrossingModel
+  : virtual public Thyra::ModelEvaluatorDelegatorBase<double>
+{
+public:
+  LevelCrossingModel(
+    const RCP<const Thyra::ModelEvaluator<double> > &model,
+    const Array<double> &levels
+    )
+    : levels_(levels),
+      g_space_(Thyra::defaultSpmdVectorSpace<double>(levels.size()))
+    {
+      this->Thyra::ModelEvaluatorDelegatorBase<double>::initialize(model);
+    }
+  RCP<const Thyra::VectorSpaceBase<double> > get_g_space(int j) const
+    {
+      TEUCHOS_ASSERT_EQUALITY( j, 0 );
+      return g_space_;
+    }
+private:
+  Thyra::ModelEvaluatorBase::OutArgs<double> createOutArgsImpl() const
+    {
+      typedef Thyra::ModelEvaluatorBase MEB;
+      MEB::OutArgsSetup<double> outArgs;
+      outArgs.setModelEvalDescription(this->description());
+      outArgs.set_Np_Ng(0,1);
+      outArgs.setSupports(MEB::OUT_ARG_f);
+      return outArgs;
+    }
+  void evalModelImpl(
+    const Thyra::ModelEvaluatorBase::InArgs<double> &inArgs,
+    const Thyra::ModelEvaluatorBase::OutArgs<double> &outArgs
+    ) const
+    {
+      typedef Thyra::ModelEvaluatorBase MEB;
+      const RCP<const Thyra::ModelEvaluator<double> >
+        model = this->getUnderlyingModel();
+      MEB::InArgs<double> modelInArgs = model->createInArgs();
+      modelInArgs.setArgs(inArgs);
+      MEB::OutArgs<double> modelOutArgs = model->createOutArgs();
+      modelOutArgs.set_f(outArgs.get_f());
+      model->evalModel(modelInArgs,modelOutArgs);
+      const RCP<VectorBase<double> > g = outArgs.get_g(0);
+      if (nonnull(g)) {
+        const Thyra::ConstDetachedVectorView<double> x_view(*inArgs.get_x());
+        Thyra::DetachedVectorView<double> g_view(*g);
+        for (int k = 0; k < Teuchos::as<int>(levels_.size()); ++k)
+          g_view[k] = x_view[0] - levels_[k];
+      }
+    }
+  Array<double> levels_;
+  RCP<const Thyra::VectorSpaceBase<double> > g_space_;
+};
+
+
+// RK4 with fixed steps of 0.01 on x(0) = sin(t), with event functions that
+// cross zero at the levels 0.3, ..., 0.9.
+RCP<DefaultIntegrator<double> > levelCrossingIntegrator(
+  int numLevels, const RCP<ParameterList> &eventPL,
+  const RCP<IntegrationObserverBase<double> > &observer,
+  double finalTime)
+{
+  Array<double> levels;
+  for (int k = 0; k < numLevels; ++k)
+    levels.push_back(0.3 + (0.6*k)/(numLevels-1));
+  RCP<SinCosModel> sinCos = sinCosModel(false);
+  RCP<LevelCrossingModel> model =
+    Teuchos::rcp(new LevelCrossingModel(sinCos, levels));
+  RCP<StepperBase<double> > stepper = explicitRKStepper<double>(
+    model, createRKBT<double>("Explicit 4 Stage"));
+  stepper->setInitialCondition(sinCos->getNominalValues());
+  RCP<ParameterList> controlPL = Teuchos::parameterList();
+  controlPL->set("Take Variable Steps",false);
+  controlPL->set("Fixed dt",0.01);
+  RCP<DefaultIntegrator<double> > integrator = defaultIntegrator<double>(
+    simpleIntegrationControlStrategy<double>(controlPL), observer );
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->sublist("Event Detection").setParameters(*eventPL);
+  integrator->setParameterList(pl);
+  integrator->setStepper(stepper, finalTime);
+  return integrator;
+}
+
+
+} // namespace
+
+
 // Test the ERK stepper through the integrator
 TEUCHOS_UNIT_TEST( Rythmos_DefaultIntegrator, ExplicitRKStepper ) {
   // Integrator
@@ -292,5 +434,341 @@ TEUCHOS_UNIT_TEST( Rythmos_DefaultIntegrator, failRampingTimestep )
 }
 
 
-} // namespace Rythmos
+TEUCHOS_UNIT_TEST( Rythmos_DefaultIntegrator, stiffnessSwitchToImplicit )
+{
+  // With lambda = -1000 and dt = 0.01, h*rho is about 10 and RK4 is
+  // unstable, so the integrator switches to Backward Euler after the three
+  // detections on steps 2 to 4 and stays there.
+  const double finalTime = 1.0;
+  RCP<DefaultIntegrator<double> > integrator =
+    switchingIntegrator(false,-1000.0,finalTime);
+  const RCP<const VectorBase<double> > x_final =
+    get_fwd_x<double>(*integrator, finalTime);
+  TEST_EQUALITY( integrator->getNumStiffnessSwitches(), 1 );
+  TEST_ASSERT( integrator->getStepper()->isImplicit() );
+  TEST_ASSERT( !integrator->getStiffnessSwitchingStepper()->isImplicit() );
+  TEST_FLOATING_EQUALITY( integrator->getStiffnessEstimate(), 10.0, 1.0e-2 );
+  TEST_COMPARE( Thyra::norm_2(*x_final), <, 1.0e-10 );
+}
+
 
+TEUCHOS_UNIT_TEST( Rythmos_DefaultIntegrator, stiffnessSwitchToExplicit )
+{
+  // With lambda = -1 the problem is not stiff, h*rho is about 0.014 and the
+  // integrator moves from Backward Euler to RK4.
+  const double finalTime = 1.0;
+  RCP<DefaultIntegrator<double> > integrator =
+    switchingIntegrator(true,-1.0,finalTime);
+  const RCP<const VectorBase<double> > x_final =
+    get_fwd_x<double>(*integrator, finalTime);
+  TEST_EQUALITY( integrator->getNumStiffnessSwitches(), 1 );
+  TEST_ASSERT( !integrator->getStepper()->isImplicit() );
+  TEST_COMPARE( integrator->getStiffnessEstimate(), <, 0.5 );
+  RCP<VectorBase<double> > err = x_final->clone_v();
+  Thyra::Vp_StV(err.ptr(), -1.0,
+    *oscillatorModel(false,-1.0)->getExactSolution(finalTime).get_x());
+  // Only the four Backward Euler steps contribute a noticeable error.
+  TEST_COMPARE( Thyra::norm_2(*err), <, 1.0e-3 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DefaultIntegrator, stiffnessSwitchingSameType )
+{
+  RCP<SinCosModel> model = sinCosModel(false);
+  RCP<StepperBase<double> > stepper1 = explicitRKStepper<double>(model);
+  RCP<StepperBase<double> > stepper2 = explicitRKStepper<double>(model);
+  stepper1->setInitialCondition(model->getNominalValues());
+  RCP<DefaultIntegrator<double> > integrator = defaultIntegrator<double>();
+  integrator->setStepper(stepper1, 1.0);
+  TEST_THROW( integrator->setStiffnessSwitchingStepper(stepper2),
+    std::logic_error );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DefaultIntegrator, landOnOutputTimes )
+{
+  // Forty output times and fixed steps of 0.1 to t = 1: with natural steps
+  // the stepper takes 10 steps and interpolates, landing on the output times
+  // takes one step per output time.
+  Array<double> time_vec;
+  for (int i=1 ; i<=40 ; ++i)
+    time_vec.push_back(0.025*i);
+  for (int landOnOutputTimes=0 ; landOnOutputTimes<=1 ; ++landOnOutputTimes) {
+    RCP<SinCosModel> model = sinCosModel(false);
+    RCP<StepperBase<double> > stepper = explicitRKStepper<double>(model);
+    stepper->setInitialCondition(model->getNominalValues());
+    RCP<ParameterList> controlPL = Teuchos::parameterList();
+    controlPL->set("Take Variable Steps",false);
+    controlPL->set("Fixed dt",0.1);
+    RCP<LoggingIntegrationObserver<double> > observer =
+      createLoggingIntegrationObserver<double>();
+    RCP<DefaultIntegrator<double> > integrator = defaultIntegrator<double>(
+      simpleIntegrationControlStrategy<double>(controlPL), observer );
+    RCP<ParameterList> integratorPL = Teuchos::parameterList();
+    integratorPL->set("Land On Output Times",landOnOutputTimes==1);
+    integrator->setParameterList(integratorPL);
+    integrator->setStepper(stepper, 1.0);
+    Array<RCP<const VectorBase<double> > > x_vec;
+    integrator->getFwdPoints(time_vec,&x_vec,NULL,NULL);
+    TEST_EQUALITY( x_vec.size(), time_vec.size() );
+    const int numSteps = observer->getCounters()->find(
+      observer->nameObserveCompletedTimeStep_)->second;
+    TEST_EQUALITY( numSteps, (landOnOutputTimes==1 ? 40 : 10) );
+  }
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DefaultIntegrator, breakPoints )
+{
+  // Fixed steps of 0.1 to t = 1 with a hard breakpoint at 0.25 and a soft
+  // one at 0.6: the steps end at 0.1, 0.2, 0.25, 0.35, 0.45, 0.55, 0.6, 0.7,
+  // 0.8, 0.9 and 1.0.
+  RCP<SinCosModel> model = sinCosModel(false);
+  RCP<StepperBase<double> > stepper = explicitRKStepper<double>(model);
+  stepper->setInitialCondition(model->getNominalValues());
+  RCP<ParameterList> controlPL = Teuchos::parameterList();
+  controlPL->set("Take Variable Steps",false);
+  controlPL->set("Fixed dt",0.1);
+  RCP<LoggingIntegrationObserver<double> > observer =
+    createLoggingIntegrationObserver<double>();
+  RCP<DefaultIntegrator<double> > integrator = defaultIntegrator<double>(
+    simpleIntegrationControlStrategy<double>(controlPL), observer );
+  RCP<DefaultBreakPointInformer<double> > breakPoints =
+    defaultBreakPointInformer<double>();
+  breakPoints->addBreakPoint(0.25,BREAK_POINT_TYPE_HARD);
+  breakPoints->addBreakPoint(0.6,BREAK_POINT_TYPE_SOFT);
+  integrator->setBreakPointInformer(breakPoints);
+  integrator->setStepper(stepper, 1.0);
+  const RCP<const VectorBase<double> > x_final =
+    get_fwd_x<double>(*integrator, 1.0);
+  const int numSteps = observer->getCounters()->find(
+    observer->nameObserveCompletedTimeStep_)->second;
+  TEST_EQUALITY( numSteps, 11 );
+  TEST_EQUALITY( integrator->getNumBreakPointCutSteps(), 2 );
+  // The restart at the hard breakpoint does not change the solution.
+  RCP<VectorBase<double> > err = x_final->clone_v();
+  Thyra::Vp_StV(err.ptr(), -1.0, *model->getExactSolution(1.0).get_x());
+  TEST_COMPARE( Thyra::norm_2(*err), <, 1.0e-5 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DefaultIntegrator, eventDetectionStop )
+{
+  // The first of 200 event functions crosses zero at t = asin(0.3), inside
+  // the 31st step.  The output at t = 0.1 is computed, the one at t = 0.5 is
+  // after the event and is left null.
+  RCP<ParameterList> eventPL = Teuchos::parameterList();
+  eventPL->set("Response Index",0);
+  RCP<LoggingIntegrationObserver<double> > observer =
+    createLoggingIntegrationObserver<double>();
+  RCP<DefaultIntegrator<double> > integrator =
+    levelCrossingIntegrator(200, eventPL, observer, 1.0);
+  Array<double> time_vec;
+  time_vec.push_back(0.1);
+  time_vec.push_back(0.5);
+  Array<RCP<const VectorBase<double> > > x_vec;
+  integrator->getFwdPoints(time_vec, &x_vec, 0, 0);
+  TEST_EQUALITY_CONST( integrator->getNumEvents(), 1 );
+  TEST_FLOATING_EQUALITY( integrator->getLastEventTime(), std::asin(0.3),
+    1.0e-4 );
+  TEST_EQUALITY_CONST( integrator->getLastEventIndices().size(), 1 );
+  TEST_EQUALITY_CONST( integrator->getLastEventIndices()[0], 0 );
+  TEST_EQUALITY_CONST( observer->getCounters()->find(
+      observer->nameObserveEvent_)->second, 1 );
+  const int numSteps = observer->getCounters()->find(
+    observer->nameObserveCompletedTimeStep_)->second;
+  TEST_EQUALITY_CONST( numSteps, 31 );
+  TEST_EQUALITY_CONST( is_null(x_vec[0]), false );
+  TEST_EQUALITY_CONST( is_null(x_vec[1]), true );
+  // One evaluation per step plus a few to locate the event, independent of
+  // the number of event functions.
+  TEST_COMPARE( integrator->getNumEventResponseEvaluations(), <=,
+    numSteps + 1 + 20 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DefaultIntegrator, eventDetectionStopTwoEventsInStep )
+{
+  // The first two of 200 event functions cross zero at t = asin(0.3) and
+  // t = asin(0.3+0.6/199), both inside the 31st step.  Each call stops at
+  // one of them and the second one is found without taking another step.
+  RCP<ParameterList> eventPL = Teuchos::parameterList();
+  eventPL->set("Response Index",0);
+  RCP<LoggingIntegrationObserver<double> > observer =
+    createLoggingIntegrationObserver<double>();
+  RCP<DefaultIntegrator<double> > integrator =
+    levelCrossingIntegrator(200, eventPL, observer, 1.0);
+  Array<double> time_vec(1, 0.5);
+  Array<RCP<const VectorBase<double> > > x_vec;
+
+  integrator->getFwdPoints(time_vec, &x_vec, 0, 0);
+  TEST_EQUALITY_CONST( integrator->getNumEvents(), 1 );
+  TEST_FLOATING_EQUALITY( integrator->getLastEventTime(), std::asin(0.3),
+    1.0e-4 );
+  TEST_EQUALITY_CONST( integrator->getLastEventIndices()[0], 0 );
+  TEST_EQUALITY_CONST( observer->getCounters()->find(
+      observer->nameObserveCompletedTimeStep_)->second, 31 );
+
+  integrator->getFwdPoints(time_vec, &x_vec, 0, 0);
+  TEST_EQUALITY_CONST( integrator->getNumEvents(), 2 );
+  TEST_FLOATING_EQUALITY( integrator->getLastEventTime(),
+    std::asin(0.3+0.6/199), 1.0e-4 );
+  TEST_EQUALITY_CONST( integrator->getLastEventIndices().size(), 1 );
+  TEST_EQUALITY_CONST( integrator->getLastEventIndices()[0], 1 );
+  TEST_EQUALITY_CONST( observer->getCounters()->find(
+      observer->nameObserveEvent_)->second, 2 );
+  TEST_EQUALITY_CONST( observer->getCounters()->find(
+      observer->nameObserveCompletedTimeStep_)->second, 31 );
+  TEST_EQUALITY_CONST( is_null(x_vec[0]), true );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DefaultIntegrator, eventDetectionAllEvents )
+{
+  // Without stopping every level is crossed once on the way to t = 1.5 and
+  // several of them inside the same step.
+  const int numLevels = 200;
+  RCP<ParameterList> eventPL = Teuchos::parameterList();
+  eventPL->set("Response Index",0);
+  eventPL->set("Stop On Event",false);
+  RCP<LoggingIntegrationObserver<double> > observer =
+    createLoggingIntegrationObserver<double>();
+  RCP<DefaultIntegrator<double> > integrator =
+    levelCrossingIntegrator(numLevels, eventPL, observer, 1.5);
+  const RCP<const VectorBase<double> > x_final =
+    get_fwd_x<double>(*integrator, 1.5);
+  TEST_EQUALITY( integrator->getNumEvents(), numLevels );
+  TEST_EQUALITY( observer->getCounters()->find(
+      observer->nameObserveEvent_)->second, numLevels );
+  TEST_FLOATING_EQUALITY( integrator->getLastEventTime(), std::asin(0.9),
+    1.0e-4 );
+  TEST_EQUALITY_CONST( integrator->getLastEventIndices()[0], numLevels-1 );
+
+  // None of the crossings is decreasing.
+  eventPL->set("Crossing Direction","Decreasing");
+  integrator = levelCrossingIntegrator(numLevels, eventPL, observer, 1.5);
+  get_fwd_x<double>(*integrator, 1.5);
+  TEST_EQUALITY_CONST( integrator->getNumEvents(), 0 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DefaultIntegrator, eventDetectionInvalidIndex )
+{
+  RCP<ParameterList> eventPL = Teuchos::parameterList();
+  eventPL->set("Response Index",1);
+  RCP<DefaultIntegrator<double> > integrator = levelCrossingIntegrator(
+    2, eventPL, createLoggingIntegrationObserver<double>(), 1.0);
+  TEST_THROW( get_fwd_x<double>(*integrator, 1.0), std::logic_error );
+  eventPL->set("Max Iterations",0);
+  TEST_THROW( levelCrossingIntegrator(2, eventPL,
+      createLoggingIntegrationObserver<double>(), 1.0), std::logic_error );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DefaultIntegrator, streamingMatchesLandOnOutputTimes )
+{
+  // Forty chunks with fixed steps of 0.1 to t = 1 take the same steps as
+  // getFwdPoints() landing on the same output times, but the observer sees a
+  // single time integration.
+  Array<double> time_vec;
+  for (int i=1 ; i<=40 ; ++i)
+    time_vec.push_back(0.025*i);
+  Array<RCP<const VectorBase<double> > > x_vec;
+  {
+    RCP<SinCosModel> model = sinCosModel(false);
+    RCP<StepperBase<double> > stepper = explicitRKStepper<double>(model);
+    stepper->setInitialCondition(model->getNominalValues());
+    RCP<ParameterList> controlPL = Teuchos::parameterList();
+    controlPL->set("Take Variable Steps",false);
+    controlPL->set("Fixed dt",0.1);
+    RCP<DefaultIntegrator<double> > integrator = defaultIntegrator<double>(
+      simpleIntegrationControlStrategy<double>(controlPL) );
+    RCP<ParameterList> integratorPL = Teuchos::parameterList();
+    integratorPL->set("Land On Output Times",true);
+    integrator->setParameterList(integratorPL);
+    integrator->setStepper(stepper, 1.0);
+    integrator->getFwdPoints(time_vec,&x_vec,NULL,NULL);
+  }
+  RCP<SinCosModel> model = sinCosModel(false);
+  RCP<StepperBase<double> > stepper = explicitRKStepper<double>(model);
+  stepper->setInitialCondition(model->getNominalValues());
+  RCP<ParameterList> controlPL = Teuchos::parameterList();
+  controlPL->set("Take Variable Steps",false);
+  controlPL->set("Fixed dt",0.1);
+  RCP<LoggingIntegrationObserver<double> > observer =
+    createLoggingIntegrationObserver<double>();
+  RCP<DefaultIntegrator<double> > integrator = defaultIntegrator<double>(
+    simpleIntegrationControlStrategy<double>(controlPL), observer );
+  integrator->setStepper(stepper, 1.0);
+  TEST_EQUALITY_CONST( integrator->isStreaming(), false );
+  integrator->beginStreaming();
+  TEST_EQUALITY_CONST( integrator->isStreaming(), true );
+  RCP<VectorBase<double> > x = model->getNominalValues().get_x()->clone_v();
+  for (int i=0 ; i<Teuchos::as<int>(time_vec.size()) ; ++i) {
+    TEST_EQUALITY_CONST( integrator->advanceChunk(time_vec[i], x.ptr()), true );
+    RCP<VectorBase<double> > err = x->clone_v();
+    Thyra::Vp_StV(err.ptr(), -1.0, *x_vec[i]);
+    TEST_COMPARE( Thyra::norm_inf(*err), <=, 1.0e-14 );
+  }
+  integrator->endStreaming();
+  TEST_EQUALITY_CONST( integrator->isStreaming(), false );
+  TEST_EQUALITY( integrator->getNumStreamingChunks(), 40 );
+  const RCP<const std::map<std::string,int> > counters =
+    observer->getCounters();
+  TEST_EQUALITY_CONST( counters->find(
+      observer->nameObserveStartTimeIntegration_)->second, 1 );
+  TEST_EQUALITY_CONST( counters->find(
+      observer->nameObserveEndTimeIntegration_)->second, 1 );
+  TEST_EQUALITY_CONST( counters->find(
+      observer->nameObserveCompletedTimeStep_)->second, 40 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DefaultIntegrator, streamingKeepsBDFHistory )
+{
+  // Variable order BDF streamed in 100 chunks keeps raising its order, while
+  // restarting the stepper every chunk would drop it back to first order.
+  RCP<SinCosModel> model = sinCosModel(true);
+  RCP<ParameterList> stepperPL = Teuchos::parameterList();
+  stepperPL->sublist("Step Control Settings").sublist("VerboseObject").set(
+    "Verbosity Level","none");
+  RCP<ImplicitBDFStepper<double> > stepper = implicitBDFStepper<double>(
+    model,timeStepNonlinearSolver<double>(),stepperPL);
+  stepper->setInitialCondition(model->getNominalValues());
+  RCP<DefaultIntegrator<double> > integrator = defaultIntegrator<double>();
+  integrator->setStepper(stepper, 1.0);
+  integrator->beginStreaming();
+  RCP<VectorBase<double> > x = model->getNominalValues().get_x()->clone_v();
+  RCP<VectorBase<double> > x_dot = x->clone_v();
+  for (int i=1 ; i<=100 ; ++i)
+    integrator->advanceChunk(0.01*i, x.ptr(), x_dot.ptr());
+  integrator->endStreaming();
+  TEST_COMPARE( stepper->getOrder(), >, 1 );
+  TEST_FLOATING_EQUALITY( stepper->getStepStatus().time, 1.0, 1.0e-14 );
+  RCP<VectorBase<double> > err = x->clone_v();
+  Thyra::Vp_StV(err.ptr(), -1.0, *model->getExactSolution(1.0).get_x());
+  TEST_COMPARE( Thyra::norm_inf(*err), <, 1.0e-3 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DefaultIntegrator, streamingInvalidCalls )
+{
+  RCP<SinCosModel> model = sinCosModel(false);
+  RCP<StepperBase<double> > stepper = explicitRKStepper<double>(model);
+  stepper->setInitialCondition(model->getNominalValues());
+  RCP<DefaultIntegrator<double> > integrator = defaultIntegrator<double>();
+  TEST_THROW( integrator->beginStreaming(), std::logic_error );
+  integrator->setStepper(stepper, 1.0);
+  TEST_THROW( integrator->advanceChunk(0.5), std::logic_error );
+  TEST_THROW( integrator->endStreaming(), std::logic_error );
+  integrator->beginStreaming();
+  TEST_THROW( integrator->beginStreaming(), std::logic_error );
+  TEST_THROW( integrator->advanceChunk(1.5), std::out_of_range );
+  TEST_THROW( integrator->advanceChunk(-0.5), std::out_of_range );
+  // Resetting the stepper ends the stream.
+  integrator->setStepper(stepper, 1.0);
+  TEST_EQUALITY_CONST( integrator->isStreaming(), false );
+}
+
+
+} // namespace Rythmos
@@ -0,0 +1,234 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_UnitTestHelpers.hpp"
+#include "Rythmos_DiscreteAdjointBackwardEulerIntegrator.hpp"
+#include "Rythmos_BackwardEulerStepper.hpp"
+#include "Rythmos_TimeStepNonlinearSolver.hpp"
+#include "../SinCos/SinCosModel.hpp"
+#include "../VanderPol/VanderPolModel.hpp"
+
+#include "Thyra_VectorStdOps.hpp"
+#include "Thyra_DetachedVectorView.hpp"
+
+namespace Rythmos {
+
+
+typedef Thyra::ModelEvaluatorBase MEB;
+
+
+namespace {
+
+
+const double finalTime = 1.0;
+const int numSteps = 10;
+
+
+RCP<SinCosModel> sinCosParamModel()
+{
+  RCP<SinCosModel> model = sinCosModel();
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Implicit model formulation",true);
+  pl->set("Accept model parameters",true);
+  model->setParameterList(pl);
+  return model;
+}
+
+
+RCP<VanderPolModel> vanderPolParamModel()
+{
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Implicit model formulation",true);
+  pl->set("Accept model parameters",true);
+  return vanderPolModel(pl);
+}
+
+
+// The nonlinear solves are converged tightly so that the finite differences
+// see the Backward Euler solution itself.
+RCP<BackwardEulerStepper<double> > createStepper(
+  const RCP<const Thyra::ModelEvaluator<double> > &model,
+  const MEB::InArgs<double> &ic
+  )
+{
+  RCP<ParameterList> solverPL = Teuchos::parameterList();
+  solverPL->set("Default Tol",1.0e-12);
+  solverPL->set("Default Max Iters",20);
+  RCP<TimeStepNonlinearSolver<double> >
+    solver = timeStepNonlinearSolver<double>();
+  solver->setParameterList(solverPL);
+  RCP<BackwardEulerStepper<double> > stepper =
+    backwardEulerStepper<double>(model, solver);
+  stepper->setInitialCondition(ic);
+  return stepper;
+}
+
+
+// g = 0.5*x(T)^T*x(T) of the Backward Euler solution
+double response(
+  const RCP<const Thyra::ModelEvaluator<double> > &model,
+  const MEB::InArgs<double> &ic
+  )
+{
+  RCP<BackwardEulerStepper<double> > stepper = createStepper(model, ic);
+  for (int n = 0; n < numSteps; ++n)
+    stepper->takeStep(finalTime/numSteps, STEP_TYPE_FIXED);
+  const RCP<const VectorBase<double> > x = stepper->getStepStatus().solution;
+  return 0.5*Thyra::dot(*x,*x);
+}
+
+
+// Central difference of response() in component j of the initial state, or
+// of the parameters.
+double finiteDifference(
+  const RCP<const Thyra::ModelEvaluator<double> > &model,
+  const bool wrtParams, const int j, const double h
+  )
+{
+  double g[2];
+  for (int k = 0; k < 2; ++k) {
+    MEB::InArgs<double> ic = model->getNominalValues();
+    RCP<VectorBase<double> > v =
+      (wrtParams ? ic.get_p(0) : ic.get_x())->clone_v();
+    {
+      Thyra::DetachedVectorView<double> v_view( *v );
+      v_view[j] += (k == 0 ? h : -h);
+    }
+    if (wrtParams)
+      ic.set_p(0,v);
+    else
+      ic.set_x(v);
+    g[k] = response(model, ic);
+  }
+  return (g[0]-g[1])/(2.0*h);
+}
+
+
+// Checks the gradient of 0.5*x(T)^T*x(T) against finite differences for
+// both "Store Forward W" settings.
+void testGradient(
+  const RCP<const Thyra::ModelEvaluator<double> > &model,
+  const double x_tol, const double p_tol,
+  Teuchos::FancyOStream &out, bool &success
+  )
+{
+  const int np = model->get_p_space(0)->dim();
+  const int nx = model->get_x_space()->dim();
+  for (int k = 0; k < 2; ++k) {
+    const bool storeW = (k == 0);
+    out << "\nstoreW = " << storeW << "\n";
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set("Store Forward W", storeW);
+    RCP<DiscreteAdjointBackwardEulerIntegrator<double> > adjIntegrator =
+      discreteAdjointBackwardEulerIntegrator<double>(
+        createStepper(model, model->getNominalValues()), 0, pl);
+    RCP<const VectorBase<double> > x_final =
+      adjIntegrator->integrateForward(finalTime, numSteps);
+    TEST_EQUALITY( adjIntegrator->getNumForwardSteps(), numSteps );
+
+    RCP<VectorBase<double> > d_g_d_x_init = createMember(model->get_x_space());
+    RCP<VectorBase<double> > d_g_d_p = createMember(model->get_p_space(0));
+    adjIntegrator->integrateAdjoint(*x_final, d_g_d_x_init.ptr(), d_g_d_p.ptr());
+    TEST_EQUALITY( adjIntegrator->getNumTransposedSolves(), numSteps );
+    TEST_EQUALITY( adjIntegrator->getNumWEvaluations(), storeW ? 0 : numSteps );
+
+    Thyra::ConstDetachedVectorView<double> d_g_d_x_init_view( *d_g_d_x_init );
+    for (int j = 0; j < nx; ++j) {
+      TEST_FLOATING_EQUALITY( d_g_d_x_init_view[j],
+        finiteDifference(model, false, j, 1.0e-4), x_tol );
+    }
+    Thyra::ConstDetachedVectorView<double> d_g_d_p_view( *d_g_d_p );
+    for (int j = 0; j < np; ++j) {
+      TEST_FLOATING_EQUALITY( d_g_d_p_view[j],
+        finiteDifference(model, true, j, 1.0e-5), p_tol );
+    }
+  }
+}
+
+
+} // namespace
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DiscreteAdjointBackwardEulerIntegrator, invalidUse ) {
+  RCP<SinCosModel> model = sinCosParamModel();
+  RCP<DiscreteAdjointBackwardEulerIntegrator<double> > adjIntegrator =
+    discreteAdjointBackwardEulerIntegrator<double>(
+      createStepper(model, model->getNominalValues()));
+  RCP<VectorBase<double> > d_g_d_x = createMember(model->get_x_space());
+  RCP<VectorBase<double> > d_g_d_p = createMember(model->get_p_space(0));
+  Thyra::V_S(d_g_d_x.ptr(), 1.0);
+  TEST_THROW( adjIntegrator->integrateAdjoint(*d_g_d_x, Teuchos::null, Teuchos::null),
+    std::logic_error );
+  TEST_THROW( adjIntegrator->integrateForward(finalTime, 0), std::logic_error );
+  adjIntegrator->integrateForward(finalTime, numSteps);
+  TEST_THROW( adjIntegrator->integrateAdjoint(*d_g_d_x, Teuchos::null, d_g_d_p.ptr()),
+    std::logic_error );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DiscreteAdjointBackwardEulerIntegrator, gradient ) {
+  // The gradient of the Backward Euler solution matches its finite
+  // differences, whether the forward W are kept or evaluated again.
+  testGradient(sinCosParamModel(), 1.0e-8, 1.0e-6, out, success);
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DiscreteAdjointBackwardEulerIntegrator, gradientNonlinear ) {
+  // On a nonlinear model W depends on the state, so the kept W must be the
+  // one of the converged state for the gradient to match.
+  testGradient(vanderPolParamModel(), 1.0e-6, 1.0e-6, out, success);
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_DiscreteAdjointBackwardEulerIntegrator, repeatedAdjoint ) {
+  // One forward integration serves several responses.
+  RCP<SinCosModel> model = sinCosParamModel();
+  RCP<DiscreteAdjointBackwardEulerIntegrator<double> > adjIntegrator =
+    discreteAdjointBackwardEulerIntegrator<double>(
+      createStepper(model, model->getNominalValues()));
+  adjIntegrator->integrateForward(finalTime, numSteps);
+  Array<RCP<VectorBase<double> > > d_g_d_x_init;
+  for (int k = 0; k < 2; ++k) {
+    RCP<VectorBase<double> > d_g_d_x = createMember(model->get_x_space());
+    Thyra::V_S(d_g_d_x.ptr(), 1.0);
+    d_g_d_x_init.push_back(createMember(model->get_x_space()));
+    adjIntegrator->integrateAdjoint(*d_g_d_x, d_g_d_x_init[k].ptr(), Teuchos::null);
+  }
+  TEST_COMPARE( Thyra::norm_inf(*d_g_d_x_init[0]), >, 0.0 );
+  RCP<VectorBase<double> > diff = d_g_d_x_init[0]->clone_v();
+  Thyra::Vp_StV(diff.ptr(), -1.0, *d_g_d_x_init[1]);
+  TEST_COMPARE( Thyra::norm_inf(*diff), ==, 0.0 );
+  TEST_EQUALITY( adjIntegrator->getNumTransposedSolves(), 2*numSteps );
+  TEST_COMPARE( adjIntegrator->getGradientCostRatio(), >=, 0.0 );
+}
+
+
+} // namespace Rythmos
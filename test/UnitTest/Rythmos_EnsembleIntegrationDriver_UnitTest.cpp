@@ -0,0 +1,277 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_UnitTestHelpers.hpp"
+#include "Rythmos_EnsembleIntegrationDriver.hpp"
+
+#include "Rythmos_IntegratorBuilder.hpp"
+#include "Rythmos_TimeStepNonlinearSolver.hpp"
+#include "../SinCos/SinCosModel.hpp"
+
+#include "Thyra_DetachedVectorView.hpp"
+#include "Thyra_DetachedMultiVectorView.hpp"
+
+#include <cmath>
+
+namespace Rythmos {
+
+
+using Thyra::VectorBase;
+using Thyra::MultiVectorBase;
+typedef Thyra::ModelEvaluatorBase MEB;
+
+
+namespace {
+
+
+RCP<SinCosModel> sinCosParamModel(bool implicit)
+{
+  RCP<SinCosModel> model = sinCosModel();
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Implicit model formulation",implicit);
+  pl->set("Accept model parameters",true);
+  model->setParameterList(pl);
+  return model;
+}
+
+
+// Parameters (a,f,L) = (0,f[k],1) for member k.
+Array<RCP<const VectorBase<double> > > frequencyParams(
+  const RCP<const Thyra::ModelEvaluator<double> > &model,
+  const Array<double> &f
+  )
+{
+  Array<RCP<const VectorBase<double> > > params;
+  for (int k=0 ; k<Teuchos::as<int>(f.size()) ; ++k) {
+    RCP<VectorBase<double> > p = Thyra::createMember(model->get_p_space(0));
+    {
+      Thyra::DetachedVectorView<double> p_view( *p );
+      p_view[0] = 0.0;
+      p_view[1] = f[k];
+      p_view[2] = 1.0;
+    }
+    params.push_back(p);
+  }
+  return params;
+}
+
+
+Array<RCP<MultiVectorBase<double> > > createOutputs(
+  const RCP<const Thyra::ModelEvaluator<double> > &model,
+  int numMembers, int numTimes
+  )
+{
+  Array<RCP<MultiVectorBase<double> > > x_out;
+  for (int k=0 ; k<numMembers ; ++k) {
+    x_out.push_back(Thyra::createMembers(model->get_x_space(),numTimes));
+  }
+  return x_out;
+}
+
+
+RCP<ParameterList> fixedStepRK4BuilderPL(double dt, double finalTime)
+{
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->setParameters(*(integratorBuilder<double>()->getValidParameters()));
+  pl->sublist("Integrator Settings").set("Final Time",finalTime);
+  pl->sublist("Integration Control Strategy Selection").set("Integration Control Strategy Type","Simple Integration Control Strategy");
+  pl->sublist("Integration Control Strategy Selection").sublist("Simple Integration Control Strategy").set("Take Variable Steps",false);
+  pl->sublist("Integration Control Strategy Selection").sublist("Simple Integration Control Strategy").set("Fixed dt",dt);
+  pl->sublist("Stepper Settings").sublist("Stepper Selection").set("Stepper Type","Explicit RK");
+  pl->sublist("Stepper Settings").sublist("Runge Kutta Butcher Tableau Selection").set("Runge Kutta Butcher Tableau Type","Explicit 4 Stage");
+  return pl;
+}
+
+
+RCP<ParameterList> variableStepBDFBuilderPL(double finalTime)
+{
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->setParameters(*(integratorBuilder<double>()->getValidParameters()));
+  pl->sublist("Integrator Settings").set("Final Time",finalTime);
+  pl->sublist("Stepper Settings").sublist("Stepper Selection").set("Stepper Type","Implicit BDF");
+  pl->sublist("Stepper Settings").sublist("Step Control Settings").sublist("Step Control Strategy Selection").set("Step Control Strategy Type","Implicit BDF Stepper Step Control Strategy");
+  pl->sublist("Stepper Settings").sublist("Step Control Settings").sublist("Error Weight Vector Calculator Selection").set("Error Weight Vector Calculator Type","Implicit BDF Stepper Error Weight Vector Calculator");
+  return pl;
+}
+
+
+RCP<ParameterList> driverPL(int numThreads)
+{
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Number of Threads",numThreads);
+  return pl;
+}
+
+
+} // namespace
+
+
+TEUCHOS_UNIT_TEST( Rythmos_EnsembleIntegrationDriver, fixedStepMatchesSeparateRuns ) {
+  const double dt = 0.1;
+  const double finalTime = 1.0;
+  const int numSteps = 10;
+  RCP<SinCosModel> model = sinCosParamModel(false);
+  Array<double> f;
+  for (int k=0 ; k<7 ; ++k) {
+    f.push_back(1.0+0.5*k);
+  }
+  Array<RCP<const VectorBase<double> > > params = frequencyParams(model,f);
+  Array<double> time_vec;
+  time_vec.push_back(0.5);
+  time_vec.push_back(finalTime);
+
+  RCP<EnsembleIntegrationDriver<double> > driver =
+    ensembleIntegrationDriver<double>(model,model->getNominalValues(),
+      Teuchos::null,fixedStepRK4BuilderPL(dt,finalTime),driverPL(3));
+  Array<RCP<MultiVectorBase<double> > > x_out =
+    createOutputs(model,f.size(),time_vec.size());
+  driver->integrate(params,time_vec,x_out);
+
+#ifdef HAVE_RYTHMOS_THREADS
+  TEST_EQUALITY_CONST( driver->getNumThreads(), 3 );
+#else
+  TEST_EQUALITY_CONST( driver->getNumThreads(), 1 );
+#endif
+
+  // Every member matches a separate integration with its parameters
+  double tol = 1.0e-14;
+  for (int k=0 ; k<Teuchos::as<int>(f.size()) ; ++k) {
+    MEB::InArgs<double> ic = model->getNominalValues();
+    ic.set_p(0,params[k]);
+    RCP<IntegratorBuilder<double> > ib = integratorBuilder<double>();
+    ib->setParameterList(fixedStepRK4BuilderPL(dt,finalTime));
+    RCP<IntegratorBase<double> > integrator =
+      ib->create(model,ic,Teuchos::null);
+    Array<RCP<const VectorBase<double> > > x_vec;
+    integrator->getFwdPoints(time_vec,&x_vec,NULL,NULL);
+    Thyra::ConstDetachedMultiVectorView<double> X_view( *x_out[k] );
+    for (int i=0 ; i<Teuchos::as<int>(time_vec.size()) ; ++i) {
+      Thyra::ConstDetachedVectorView<double> x_view( *x_vec[i] );
+      TEST_FLOATING_EQUALITY( X_view(0,i), x_view[0], tol );
+      TEST_FLOATING_EQUALITY( X_view(1,i), x_view[1], tol );
+    }
+    TEST_EQUALITY( driver->getMemberNumSteps()[k], numSteps );
+  }
+
+  // Every member was integrated by exactly one thread
+  const Array<EnsembleThreadStatistics>& stats = driver->getThreadStatistics();
+  TEST_EQUALITY( Teuchos::as<int>(stats.size()), driver->getNumThreads() );
+  int numMembers = 0;
+  int totalSteps = 0;
+  for (int i=0 ; i<Teuchos::as<int>(stats.size()) ; ++i) {
+    numMembers += stats[i].numMembers;
+    totalSteps += stats[i].numSteps;
+    TEST_COMPARE( stats[i].utilization, >=, 0.0 );
+    TEST_COMPARE( stats[i].utilization, <=, 1.0 );
+  }
+  TEST_EQUALITY( numMembers, Teuchos::as<int>(f.size()) );
+  TEST_EQUALITY( totalSteps, numSteps*Teuchos::as<int>(f.size()) );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_EnsembleIntegrationDriver, variableStepThreadsMatchSerial ) {
+  const double finalTime = 1.0;
+  RCP<SinCosModel> model = sinCosParamModel(true);
+  RCP<TimeStepNonlinearSolver<double> > nlSolver =
+    timeStepNonlinearSolver<double>();
+  // Frequencies from 1 to 64 give very different adaptive step counts.
+  Array<double> f;
+  for (int k=0 ; k<7 ; ++k) {
+    f.push_back(std::pow(2.0,k));
+  }
+  Array<RCP<const VectorBase<double> > > params = frequencyParams(model,f);
+  Array<double> time_vec;
+  time_vec.push_back(finalTime);
+
+  RCP<EnsembleIntegrationDriver<double> > serialDriver =
+    ensembleIntegrationDriver<double>(model,model->getNominalValues(),
+      nlSolver,variableStepBDFBuilderPL(finalTime),driverPL(1));
+  Array<RCP<MultiVectorBase<double> > > x_serial =
+    createOutputs(model,f.size(),time_vec.size());
+  serialDriver->integrate(params,time_vec,x_serial);
+  TEST_EQUALITY_CONST( serialDriver->getNumThreads(), 1 );
+
+  RCP<EnsembleIntegrationDriver<double> > driver =
+    ensembleIntegrationDriver<double>(model,model->getNominalValues(),
+      nlSolver,variableStepBDFBuilderPL(finalTime),driverPL(4));
+  Array<RCP<MultiVectorBase<double> > > x_out =
+    createOutputs(model,f.size(),time_vec.size());
+  // Integrate twice to check that the thread workspaces are reused cleanly.
+  driver->integrate(params,time_vec,x_out);
+  driver->integrate(params,time_vec,x_out);
+
+  double tol = 1.0e-14;
+  for (int k=0 ; k<Teuchos::as<int>(f.size()) ; ++k) {
+    Thyra::ConstDetachedMultiVectorView<double> X_view( *x_out[k] );
+    Thyra::ConstDetachedMultiVectorView<double> X_serial_view( *x_serial[k] );
+    TEST_FLOATING_EQUALITY( X_view(0,0), X_serial_view(0,0), tol );
+    TEST_FLOATING_EQUALITY( X_view(1,0), X_serial_view(1,0), tol );
+    TEST_EQUALITY( driver->getMemberNumSteps()[k],
+      serialDriver->getMemberNumSteps()[k] );
+  }
+  TEST_COMPARE( driver->getMemberNumSteps()[f.size()-1], >,
+    4*driver->getMemberNumSteps()[0] );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_EnsembleIntegrationDriver, invalidArguments ) {
+  RCP<SinCosModel> model = sinCosParamModel(false);
+  Array<double> f(2,1.0);
+  Array<RCP<const VectorBase<double> > > params = frequencyParams(model,f);
+  Array<double> time_vec(1,1.0);
+
+  RCP<EnsembleIntegrationDriver<double> > driver =
+    Teuchos::rcp(new EnsembleIntegrationDriver<double>());
+  Array<RCP<MultiVectorBase<double> > > x_out = createOutputs(model,2,1);
+  // Not initialized
+  TEST_THROW( driver->integrate(params,time_vec,x_out), std::logic_error );
+
+  driver->initialize(model,model->getNominalValues(),Teuchos::null,
+    fixedStepRK4BuilderPL(0.1,1.0));
+  // Wrong number of outputs
+  Array<RCP<MultiVectorBase<double> > > x_short = createOutputs(model,1,1);
+  TEST_THROW( driver->integrate(params,time_vec,x_short), std::logic_error );
+  // Wrong number of output times
+  Array<RCP<MultiVectorBase<double> > > x_cols = createOutputs(model,2,2);
+  TEST_THROW( driver->integrate(params,time_vec,x_cols), std::logic_error );
+  // Parameter index out of range
+  RCP<ParameterList> pl = driverPL(1);
+  pl->set("Parameter Index",1);
+  driver->setParameterList(pl);
+  TEST_THROW( driver->integrate(params,time_vec,x_out), std::logic_error );
+  // Negative number of threads
+  TEST_THROW( driver->setParameterList(driverPL(-1)), std::logic_error );
+}
+
+
+} // namespace Rythmos
+
@@ -0,0 +1,302 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_UnitTestHelpers.hpp"
+#include "Rythmos_EnsembleModelEvaluator.hpp"
+
+#include "Rythmos_ExplicitRKStepper.hpp"
+#include "Rythmos_RKButcherTableauBuilder.hpp"
+#include "Rythmos_ImplicitBDFStepper.hpp"
+#include "Rythmos_TimeStepNonlinearSolver.hpp"
+#include "Rythmos_DefaultIntegrator.hpp"
+#include "Rythmos_SimpleIntegrationControlStrategy.hpp"
+#include "../SinCos/SinCosModel.hpp"
+
+#include "Thyra_DetachedVectorView.hpp"
+#include "Thyra_DetachedMultiVectorView.hpp"
+
+namespace Rythmos {
+
+
+using Thyra::VectorBase;
+typedef Thyra::ModelEvaluatorBase MEB;
+
+
+namespace {
+
+
+// Member k starts from the nominal initial condition scaled by (k+1).
+Array<MEB::InArgs<double> > scaledMemberPoints(
+  const RCP<const Thyra::ModelEvaluator<double> > &model,
+  int numMembers
+  )
+{
+  Array<MEB::InArgs<double> > points;
+  const MEB::InArgs<double> nominal = model->getNominalValues();
+  for (int k=0 ; k<numMembers ; ++k) {
+    MEB::InArgs<double> point = model->createInArgs();
+    point.setArgs(nominal);
+    RCP<VectorBase<double> > x = nominal.get_x()->clone_v();
+    Thyra::Vt_S(x.ptr(), k+1.0);
+    point.set_x(x);
+    if (point.supports(MEB::IN_ARG_x_dot)) {
+      RCP<VectorBase<double> > x_dot = nominal.get_x_dot()->clone_v();
+      Thyra::Vt_S(x_dot.ptr(), k+1.0);
+      point.set_x_dot(x_dot);
+    }
+    points.push_back(point);
+  }
+  return points;
+}
+
+
+RCP<DefaultIntegrator<double> > fixedStepRK4Integrator(
+  const RCP<const Thyra::ModelEvaluator<double> > &model,
+  const MEB::InArgs<double> &ic,
+  double dt, double finalTime
+  )
+{
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Take Variable Steps",false);
+  pl->set("Fixed dt",dt);
+  RCP<DefaultIntegrator<double> > integrator =
+    defaultIntegrator<double>(simpleIntegrationControlStrategy<double>(pl));
+  RCP<ExplicitRKStepper<double> > stepper =
+    explicitRKStepper<double>(model,createRKBT<double>("Explicit 4 Stage"));
+  stepper->setInitialCondition(ic);
+  integrator->setStepper(stepper,finalTime);
+  return integrator;
+}
+
+
+} // namespace
+
+
+TEUCHOS_UNIT_TEST( Rythmos_EnsembleModelEvaluator, spaces ) {
+  RCP<SinCosModel> memberModel = sinCosModel(true);
+  RCP<EnsembleModelEvaluator<double> > model =
+    ensembleModelEvaluator<double>(memberModel,
+      scaledMemberPoints(memberModel,3));
+  TEST_EQUALITY_CONST( model->getNumMembers(), 3 );
+  TEST_EQUALITY_CONST( model->get_x_space()->dim(), 6 );
+  TEST_EQUALITY_CONST( model->get_f_space()->dim(), 6 );
+  {
+    MEB::InArgs<double> inArgs = model->createInArgs();
+    TEST_EQUALITY_CONST( inArgs.supports(MEB::IN_ARG_t), true );
+    TEST_EQUALITY_CONST( inArgs.supports(MEB::IN_ARG_x), true );
+    TEST_EQUALITY_CONST( inArgs.supports(MEB::IN_ARG_x_dot), true );
+    TEST_EQUALITY_CONST( inArgs.supports(MEB::IN_ARG_alpha), true );
+    TEST_EQUALITY_CONST( inArgs.supports(MEB::IN_ARG_beta), true );
+  }
+  {
+    MEB::OutArgs<double> outArgs = model->createOutArgs();
+    TEST_EQUALITY_CONST( outArgs.supports(MEB::OUT_ARG_f), true );
+    TEST_EQUALITY_CONST( outArgs.supports(MEB::OUT_ARG_W_op), true );
+  }
+  // The nominal state has one column per member
+  RCP<const Thyra::MultiVectorBase<double> > X =
+    model->getMemberStates(model->getNominalValues().get_x());
+  TEST_EQUALITY_CONST( X->domain()->dim(), 3 );
+  TEST_EQUALITY_CONST( X->range()->dim(), 2 );
+  const MEB::InArgs<double> nominal = memberModel->getNominalValues();
+  Thyra::ConstDetachedVectorView<double> x_view( *nominal.get_x() );
+  Thyra::ConstDetachedMultiVectorView<double> X_view( *X );
+  double tol = 1.0e-14;
+  for (int k=0 ; k<3 ; ++k) {
+    TEST_FLOATING_EQUALITY( X_view(0,k), (k+1.0)*x_view[0], tol );
+    TEST_FLOATING_EQUALITY( X_view(1,k), (k+1.0)*x_view[1], tol );
+  }
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_EnsembleModelEvaluator, contiguousVectorOps ) {
+  RCP<SinCosModel> memberModel = sinCosModel(false);
+  RCP<EnsembleModelEvaluator<double> > model =
+    ensembleModelEvaluator<double>(memberModel,
+      scaledMemberPoints(memberModel,3));
+  RCP<const EnsembleVectorSpace<double> > space =
+    Teuchos::rcp_dynamic_cast<const EnsembleVectorSpace<double> >(
+      model->get_x_space(), true);
+  TEST_ASSERT( nonnull(space->getFlatSpace()) );
+  TEST_EQUALITY_CONST( space->getFlatSpace()->dim(), 6 );
+
+  // The ensemble vectors and their clones store the members contiguously
+  RCP<const VectorBase<double> > x_bar = model->getNominalValues().get_x();
+  RCP<VectorBase<double> > y_bar = x_bar->clone_v();
+  TEST_ASSERT( nonnull(
+      Teuchos::rcp_dynamic_cast<const EnsembleVector<double> >(x_bar)) );
+  TEST_ASSERT( nonnull(
+      Teuchos::rcp_dynamic_cast<const EnsembleVector<double> >(y_bar)) );
+
+  // Operators on the flat vectors give the answer over all the columns
+  const MEB::InArgs<double> nominal = memberModel->getNominalValues();
+  const double x_norm_1 = Thyra::norm_1(*nominal.get_x());
+  const double x_norm_inf = Thyra::norm_inf(*nominal.get_x());
+  double tol = 1.0e-14;
+  TEST_FLOATING_EQUALITY( Thyra::norm_1(*x_bar), (1.0+2.0+3.0)*x_norm_1, tol );
+  TEST_FLOATING_EQUALITY( Thyra::norm_inf(*x_bar), 3.0*x_norm_inf, tol );
+  Thyra::Vp_StV(y_bar.ptr(), 2.0, *x_bar);
+  RCP<const Thyra::MultiVectorBase<double> > Y = model->getMemberStates(y_bar);
+  Thyra::ConstDetachedVectorView<double> x_view( *nominal.get_x() );
+  Thyra::ConstDetachedMultiVectorView<double> Y_view( *Y );
+  for (int k=0 ; k<3 ; ++k) {
+    TEST_FLOATING_EQUALITY( Y_view(0,k), 3.0*(k+1.0)*x_view[0], tol );
+    TEST_FLOATING_EQUALITY( Y_view(1,k), 3.0*(k+1.0)*x_view[1], tol );
+  }
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_EnsembleModelEvaluator, invalidPoints ) {
+  RCP<SinCosModel> memberModel = sinCosModel(false);
+  RCP<EnsembleModelEvaluator<double> > model =
+    Teuchos::rcp(new EnsembleModelEvaluator<double>());
+  // No members
+  Array<MEB::InArgs<double> > points;
+  TEST_THROW( model->initialize(memberModel,points), std::logic_error );
+  // Member without x
+  points.push_back(memberModel->createInArgs());
+  TEST_THROW( model->initialize(memberModel,points), std::logic_error );
+  // Members starting at different times
+  points = scaledMemberPoints(memberModel,2);
+  points[1].set_t(points[0].get_t()+1.0);
+  TEST_THROW( model->initialize(memberModel,points), std::logic_error );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_EnsembleModelEvaluator, explicitRKMatchesSeparateRuns ) {
+  const int numMembers = 3;
+  const double dt = 0.1;
+  const double finalTime = 1.0;
+  RCP<SinCosModel> memberModel = sinCosModel(false);
+  Array<MEB::InArgs<double> > points =
+    scaledMemberPoints(memberModel,numMembers);
+  RCP<EnsembleModelEvaluator<double> > model =
+    ensembleModelEvaluator<double>(memberModel,points);
+
+  RCP<DefaultIntegrator<double> > ensembleIntegrator =
+    fixedStepRK4Integrator(model,model->getNominalValues(),dt,finalTime);
+  RCP<const VectorBase<double> > x_bar =
+    get_fwd_x<double>(*ensembleIntegrator,finalTime);
+  RCP<const Thyra::MultiVectorBase<double> > X =
+    model->getMemberStates(x_bar);
+  Thyra::ConstDetachedMultiVectorView<double> X_view( *X );
+
+  double tol = 1.0e-14;
+  for (int k=0 ; k<numMembers ; ++k) {
+    RCP<DefaultIntegrator<double> > memberIntegrator =
+      fixedStepRK4Integrator(memberModel,points[k],dt,finalTime);
+    RCP<const VectorBase<double> > x = get_fwd_x<double>(*memberIntegrator,finalTime);
+    Thyra::ConstDetachedVectorView<double> x_view( *x );
+    TEST_FLOATING_EQUALITY( X_view(0,k), x_view[0], tol );
+    TEST_FLOATING_EQUALITY( X_view(1,k), x_view[1], tol );
+  }
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_EnsembleModelEvaluator, implicitBDFExactNumericalAnswer_BE ) {
+  const int numMembers = 3;
+  double a = 1.5;
+  double f = 1.6;
+  double L = 1.7;
+  RCP<ParameterList> modelPL = Teuchos::parameterList();
+  {
+    modelPL->set("Implicit model formulation",true);
+    modelPL->set("Coeff a",a);
+    modelPL->set("Coeff f",f);
+    modelPL->set("Coeff L",L);
+  }
+  RCP<SinCosModel> memberModel = sinCosModel();
+  memberModel->setParameterList(modelPL);
+  // Member k starts from x = (k/2, 1), with a consistent x_dot.
+  Array<MEB::InArgs<double> > points;
+  for (int k=0 ; k<numMembers ; ++k) {
+    MEB::InArgs<double> point = memberModel->getNominalValues();
+    RCP<VectorBase<double> > x = point.get_x()->clone_v();
+    RCP<VectorBase<double> > x_dot = point.get_x_dot()->clone_v();
+    {
+      Thyra::DetachedVectorView<double> x_view( *x );
+      Thyra::DetachedVectorView<double> x_dot_view( *x_dot );
+      x_view[0] = 0.5*k;
+      x_view[1] = 1.0;
+      x_dot_view[0] = x_view[1];
+      x_dot_view[1] = f*f/(L*L)*(a-x_view[0]);
+    }
+    point.set_x(x);
+    point.set_x_dot(x_dot);
+    points.push_back(point);
+  }
+  RCP<EnsembleModelEvaluator<double> > model =
+    ensembleModelEvaluator<double>(memberModel,points);
+
+  RCP<ParameterList> stepperPL = Teuchos::parameterList();
+  {
+    ParameterList& pl = stepperPL->sublist("Step Control Settings");
+    pl.set("minOrder",1);
+    pl.set("maxOrder",1);
+    ParameterList& vopl = pl.sublist("VerboseObject");
+    vopl.set("Verbosity Level","none");
+  }
+  RCP<ImplicitBDFStepper<double> > stepper = implicitBDFStepper<double>(
+    model,timeStepNonlinearSolver<double>(),stepperPL);
+  stepper->setInitialCondition(model->getNominalValues());
+
+  // Take a few steps and compare every member to its exact Backward Euler
+  // answer.
+  int N = 3;
+  double dt = 0.1;
+  Array<double> x_exact_0(numMembers), x_exact_1(numMembers);
+  for (int k=0 ; k<numMembers ; ++k) {
+    x_exact_0[k] = 0.5*k;
+    x_exact_1[k] = 1.0;
+  }
+  double c = dt/(1+f*f*dt*dt/(L*L));
+  double tol = 1.0e-10;
+  for (int i=1 ; i<=N ; ++i) {
+    double dt_taken = stepper->takeStep(dt,STEP_TYPE_FIXED);
+    TEST_ASSERT( dt_taken == dt );
+    RCP<const Thyra::MultiVectorBase<double> > X =
+      model->getMemberStates(stepper->getStepStatus().solution);
+    Thyra::ConstDetachedMultiVectorView<double> X_view( *X );
+    for (int k=0 ; k<numMembers ; ++k) {
+      double x_e_0 = c*(x_exact_0[k]/dt + x_exact_1[k] + dt*f*f/(L*L)*a);
+      double x_e_1 = c*(-f*f/(L*L)*x_exact_0[k] + x_exact_1[k]/dt + f*f/(L*L)*a);
+      TEST_FLOATING_EQUALITY( X_view(0,k), x_e_0, tol );
+      TEST_FLOATING_EQUALITY( X_view(1,k), x_e_1, tol );
+      x_exact_0[k] = x_e_0;
+      x_exact_1[k] = x_e_1;
+    }
+  }
+}
+
+
+} // namespace Rythmos
+
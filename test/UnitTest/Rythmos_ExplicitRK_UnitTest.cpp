@@ -124,6 +124,25 @@ TEUCHOS_UNIT_TEST( Rythmos_ExplicitRKStepper, getTimeRange ) {
   }
 }
 
+TEUCHOS_UNIT_TEST( Rythmos_ExplicitRKStepper, performanceCounters ) {
+  RCP<SinCosModel> model = sinCosModel(false);
+  RCP<ExplicitRKStepper<double> > stepper = explicitRKStepper<double>(model);
+  stepper->setInitialCondition(model->getNominalValues());
+  const int numStages = stepper->getRKButcherTableau()->numStages();
+  const int N = 5;
+  for (int i=0 ; i<N ; ++i) {
+    double dt_taken = stepper->takeStep(0.1,STEP_TYPE_FIXED);
+    TEST_EQUALITY_CONST( dt_taken, 0.1 );
+  }
+  StepperPerformanceCounters counters = stepper->getPerformanceCounters();
+  TEST_EQUALITY_CONST( counters.numSteps, N );
+  TEST_EQUALITY( counters.numResidualEvaluations, N*numStages );
+  TEST_EQUALITY_CONST( counters.numJacobianEvaluations, 0 );
+  TEST_EQUALITY_CONST( counters.numLinearSolves, 0 );
+  TEST_EQUALITY_CONST( counters.numNonlinearIterations, 0 );
+  TEST_EQUALITY_CONST( counters.numRejectedSteps, 0 );
+}
+
 TEUCHOS_UNIT_TEST( Rythmos_ExplicitRKStepper, noRKBT ) {
   RCP<SinCosModel> model = sinCosModel(false);
   RCP<ExplicitRKStepper<double> > stepper = explicitRKStepper<double>();
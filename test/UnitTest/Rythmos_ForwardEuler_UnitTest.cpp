@@ -48,6 +48,21 @@ TEUCHOS_UNIT_TEST( Rythmos_ForwardEulerStepper, clone ) {
   }
 }
 
+TEUCHOS_UNIT_TEST( Rythmos_ForwardEulerStepper, performanceCounters ) {
+  RCP<SinCosModel> model = sinCosModel(false);
+  RCP<ForwardEulerStepper<double> > stepper = forwardEulerStepper<double>(model);
+  stepper->setInitialCondition(model->getNominalValues());
+  const int N = 4;
+  for (int i=0 ; i<N ; ++i) {
+    stepper->takeStep(0.1,STEP_TYPE_FIXED);
+  }
+  StepperPerformanceCounters counters = stepper->getPerformanceCounters();
+  TEST_EQUALITY_CONST( counters.numSteps, N );
+  TEST_EQUALITY_CONST( counters.numResidualEvaluations, N );
+  TEST_EQUALITY_CONST( counters.numJacobianEvaluations, 0 );
+  TEST_EQUALITY_CONST( counters.numNonlinearIterations, 0 );
+}
+
 TEUCHOS_UNIT_TEST( Rythmos_ForwardEulerStepper, momento_create ) {
   RCP<const MomentoBase<double> > momento;
   {
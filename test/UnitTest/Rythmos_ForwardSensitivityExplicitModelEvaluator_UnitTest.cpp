@@ -289,5 +289,84 @@ TEUCHOS_UNIT_TEST( Rythmos_ForwardSensitivityExplicitModelEvaluator, evalModel )
 
 }
 
+// Evaluate F_sens for the explicit SinCos model with S(i,j) = i+2*j+1 using
+// the given number of threads and thread models.
+RCP<const Thyra::MultiVectorBase<double> > evalSinCosFSens(
+  int numThreads, int numThreadModels
+  )
+{
+  typedef Thyra::ModelEvaluatorBase MEB;
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Accept model parameters",true);
+  pl->set("Implicit model formulation",false);
+  RCP<SinCosModel> innerModel = sinCosModel(false);
+  innerModel->setParameterList(pl);
+  RCP<ForwardSensitivityExplicitModelEvaluator<double> > model =
+    forwardSensitivityExplicitModelEvaluator<double>();
+  model->initializeStructure(innerModel, 0 );
+  model->setNumThreads(numThreads);
+  Array<RCP<const Thyra::ModelEvaluator<double> > > threadModels;
+  for (int i=0 ; i<numThreadModels ; ++i) {
+    RCP<SinCosModel> threadModel = sinCosModel(false);
+    threadModel->setParameterList(Teuchos::parameterList(*pl));
+    threadModels.push_back(threadModel);
+  }
+  model->setThreadModels(threadModels);
+  MEB::InArgs<double> pointInArgs = innerModel->getNominalValues();
+  pointInArgs.set_t(0.1);
+  RCP<VectorBase<double> > x = Thyra::createMember(innerModel->get_x_space());
+  {
+    Thyra::DetachedVectorView<double> x_view( *x );
+    x_view[0] = 2.0;
+    x_view[1] = 3.0;
+  }
+  pointInArgs.set_x(x);
+  RCP<StepperBase<double> > stepper = forwardEulerStepper<double>();
+  stepper->setInitialCondition(pointInArgs);
+  model->initializePointState(Teuchos::inOutArg(*stepper),false);
+  RCP<VectorBase<double> > x_bar = Thyra::createMember(model->get_x_space());
+  RCP<Thyra::MultiVectorBase<double> > S =
+    Teuchos::rcp_dynamic_cast<Thyra::DefaultMultiVectorProductVector<double> >(
+      x_bar, true )->getNonconstMultiVector();
+  for (int j=0 ; j<3 ; ++j) {
+    Thyra::DetachedVectorView<double> S_j_view( *S->col(j) );
+    S_j_view[0] = 2.0*j+1.0;
+    S_j_view[1] = 2.0*j+2.0;
+  }
+  RCP<VectorBase<double> > f_bar = Thyra::createMember(model->get_f_space());
+  MEB::InArgs<double> inArgs = model->createInArgs();
+  inArgs.set_x(x_bar);
+  inArgs.set_t(0.1);
+  MEB::OutArgs<double> outArgs = model->createOutArgs();
+  outArgs.set_f(f_bar);
+  model->evalModel(inArgs,outArgs);
+  return Teuchos::rcp_dynamic_cast<Thyra::DefaultMultiVectorProductVector<double> >(
+    f_bar, true )->getMultiVector();
+}
+
+// Computing the sensitivity columns in several threads must give the same
+// F_sens as computing them all on the calling thread.
+TEUCHOS_UNIT_TEST( Rythmos_ForwardSensitivityExplicitModelEvaluator, threadedEvalModel ) {
+  RCP<ForwardSensitivityExplicitModelEvaluator<double> > model =
+    forwardSensitivityExplicitModelEvaluator<double>();
+  TEST_EQUALITY_CONST( model->getNumThreads(), 1 );
+  TEST_THROW( model->setNumThreads(-1), std::logic_error );
+  const RCP<const Thyra::MultiVectorBase<double> >
+    F_serial = evalSinCosFSens(1,0);
+  const int numThreads[] = { 2, 3, 8, 0 };
+  for (int k=0 ; k<4 ; ++k) {
+    for (int numThreadModels=0 ; numThreadModels<=2 ; numThreadModels+=2) {
+      const RCP<const Thyra::MultiVectorBase<double> >
+        F_threaded = evalSinCosFSens(numThreads[k],numThreadModels);
+      for (int j=0 ; j<3 ; ++j) {
+        Thyra::ConstDetachedVectorView<double> F_serial_view( *F_serial->col(j) );
+        Thyra::ConstDetachedVectorView<double> F_threaded_view( *F_threaded->col(j) );
+        TEST_EQUALITY( F_threaded_view[0], F_serial_view[0] );
+        TEST_EQUALITY( F_threaded_view[1], F_serial_view[1] );
+      }
+    }
+  }
+}
+
 } // namespace Rythmos
 
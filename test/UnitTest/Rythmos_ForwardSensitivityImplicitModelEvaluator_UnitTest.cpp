@@ -120,6 +120,122 @@ TEUCHOS_UNIT_TEST( Rythmos_ForwardSensitivityImplicitModelEvaluator, spaces ) {
   }
 }
 
+
+TEUCHOS_UNIT_TEST( Rythmos_ForwardSensitivityImplicitModelEvaluator, evalModelAtNewBasePoints ) {
+  // F_sens = d(f)/d(x_dot)*S_dot + d(f)/d(x)*S + d(f)/d(p) must hold at every
+  // base point while the internal derivative storage is reused between them.
+  typedef Thyra::ModelEvaluatorBase MEB;
+  RCP<ForwardSensitivityImplicitModelEvaluator<double> > model =
+    forwardSensitivityImplicitModelEvaluator<double>();
+  RCP<SinCosModel> innerModel = sinCosModel();
+  {
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set("Accept model parameters",true);
+    pl->set("Implicit model formulation",true);
+    pl->set("Coeff a", 0.4 );
+    pl->set("Coeff f", 1.5 );
+    pl->set("Coeff L", 1.6 );
+    innerModel->setParameterList(pl);
+  }
+  model->initializeStructure(innerModel, 0 );
+  const double coeff_x_dot = 6.0;
+  const double coeff_x = 6.5;
+  const double tol = 1.0e-12;
+
+  RCP<VectorBase<double> > s_bar = Thyra::createMember(model->get_x_space());
+  RCP<VectorBase<double> > s_bar_dot = Thyra::createMember(model->get_x_space());
+  RCP<VectorBase<double> > f_bar = Thyra::createMember(model->get_f_space());
+  RCP<Thyra::MultiVectorBase<double> > S =
+    Teuchos::rcp_dynamic_cast<Thyra::DefaultMultiVectorProductVector<double> >(
+      s_bar, true)->getNonconstMultiVector();
+  RCP<Thyra::MultiVectorBase<double> > S_dot =
+    Teuchos::rcp_dynamic_cast<Thyra::DefaultMultiVectorProductVector<double> >(
+      s_bar_dot, true)->getNonconstMultiVector();
+  RCP<Thyra::MultiVectorBase<double> > F_sens =
+    Teuchos::rcp_dynamic_cast<Thyra::DefaultMultiVectorProductVector<double> >(
+      f_bar, true)->getNonconstMultiVector();
+  for (int j=0 ; j<3 ; ++j) {
+    Thyra::DetachedVectorView<double> S_view( *S->col(j) );
+    Thyra::DetachedVectorView<double> S_dot_view( *S_dot->col(j) );
+    for (int i=0 ; i<2 ; ++i) {
+      S_view[i] = 7.0 + 2*j + i;
+      S_dot_view[i] = 13.0 + 2*j + i;
+    }
+  }
+
+  for (int point=0 ; point<2 ; ++point) {
+    MEB::InArgs<double> pointInArgs = innerModel->getNominalValues();
+    pointInArgs.set_t(0.1*(point+1));
+    RCP<VectorBase<double> > x = Thyra::createMember(innerModel->get_x_space());
+    RCP<VectorBase<double> > x_dot = Thyra::createMember(innerModel->get_x_space());
+    {
+      Thyra::DetachedVectorView<double> x_view( *x );
+      Thyra::DetachedVectorView<double> x_dot_view( *x_dot );
+      x_view[0] = 2.0 + 18.0*point;
+      x_view[1] = 3.0 + 18.0*point;
+      x_dot_view[0] = 4.0 + 26.0*point;
+      x_dot_view[1] = 5.0 + 26.0*point;
+    }
+    pointInArgs.set_x(x);
+    pointInArgs.set_x_dot(x_dot);
+
+    // W_tilde, d(f)/d(x_dot), d(f)/d(x) and d(f)/d(p) straight from the model
+    RCP<Thyra::LinearOpWithSolveBase<double> > W_tilde = innerModel->create_W();
+    RCP<Thyra::LinearOpBase<double> > DfDx_dot = innerModel->create_W_op();
+    RCP<Thyra::LinearOpBase<double> > DfDx = innerModel->create_W_op();
+    RCP<Thyra::MultiVectorBase<double> > DfDp = Thyra::create_DfDp_mv(
+      *innerModel, 0, MEB::DERIV_MV_BY_COL).getMultiVector();
+    {
+      MEB::InArgs<double> inArgs = pointInArgs;
+      MEB::OutArgs<double> outArgs = innerModel->createOutArgs();
+      inArgs.set_alpha(coeff_x_dot);
+      inArgs.set_beta(coeff_x);
+      outArgs.set_W(W_tilde);
+      innerModel->evalModel(inArgs,outArgs);
+    }
+    {
+      MEB::InArgs<double> inArgs = pointInArgs;
+      MEB::OutArgs<double> outArgs = innerModel->createOutArgs();
+      inArgs.set_alpha(1.0);
+      inArgs.set_beta(0.0);
+      outArgs.set_W_op(DfDx_dot);
+      outArgs.set_DfDp(0, MEB::Derivative<double>(DfDp,MEB::DERIV_MV_BY_COL));
+      innerModel->evalModel(inArgs,outArgs);
+    }
+    {
+      MEB::InArgs<double> inArgs = pointInArgs;
+      MEB::OutArgs<double> outArgs = innerModel->createOutArgs();
+      inArgs.set_alpha(0.0);
+      inArgs.set_beta(1.0);
+      outArgs.set_W_op(DfDx);
+      innerModel->evalModel(inArgs,outArgs);
+    }
+    RCP<Thyra::MultiVectorBase<double> > F_expected = DfDp->clone_mv();
+    Thyra::apply(*DfDx_dot, Thyra::NOTRANS, *S_dot, F_expected.ptr(), 1.0, 1.0);
+    Thyra::apply(*DfDx, Thyra::NOTRANS, *S, F_expected.ptr(), 1.0, 1.0);
+
+    model->initializeState(pointInArgs, W_tilde, coeff_x_dot, coeff_x);
+    MEB::InArgs<double> inArgs = model->createInArgs();
+    inArgs.set_t(pointInArgs.get_t());
+    inArgs.set_x(s_bar);
+    inArgs.set_x_dot(s_bar_dot);
+    inArgs.set_alpha(coeff_x_dot);
+    inArgs.set_beta(coeff_x);
+    MEB::OutArgs<double> outArgs = model->createOutArgs();
+    outArgs.set_f(f_bar);
+    model->evalModel(inArgs,outArgs);
+
+    for (int j=0 ; j<3 ; ++j) {
+      Thyra::ConstDetachedVectorView<double> F_view( *F_sens->col(j) );
+      Thyra::ConstDetachedVectorView<double> F_expected_view(
+        *F_expected->col(j) );
+      for (int i=0 ; i<2 ; ++i) {
+        TEST_FLOATING_EQUALITY( F_view[i], F_expected_view[i], tol );
+      }
+    }
+  }
+}
+
 /*
 TEUCHOS_UNIT_TEST( Rythmos_ForwardSensitivityImplicitModelEvaluator, evalModel ) {
   typedef Thyra::ModelEvaluatorBase MEB;
@@ -45,9 +45,13 @@
 #include "Rythmos_StepperAsModelEvaluator.hpp"
 #include "Rythmos_IntegratorBuilder.hpp"
 #include "Rythmos_ForwardSensitivityStepperTester.hpp"
+#include "Rythmos_ForwardResponseSensitivityComputerObserver.hpp"
 
 #include "Thyra_DirectionalFiniteDiffCalculator.hpp"
 #include "Thyra_DetachedVectorView.hpp"
+#include "Thyra_DetachedMultiVectorView.hpp"
+#include "Thyra_DefaultScaledAdjointLinearOp.hpp"
+#include "Thyra_ModelEvaluatorDelegatorBase.hpp"
 
 #include "Teuchos_XMLParameterListHelpers.hpp"
 
@@ -800,6 +804,751 @@ TEUCHOS_UNIT_TEST( Rythmos_ForwardSensitivityStepper, getPoints ) {
   }
 }
 
+// Forward sensitivity stepper on SinCosModel for comparing the sensitivity
+// methods.
+RCP<ForwardSensitivityStepper<double> > createSinCosFwdSensStepper(
+  const std::string &stepperType,
+  const RCP<ParameterList> &fwdSensPL,
+  RCP<SinCosModel> stateModel = Teuchos::null
+  )
+{
+  if (is_null(stateModel))
+    stateModel = sinCosModel();
+  RCP<ParameterList> modelPL = Teuchos::parameterList();
+  modelPL->set("Accept model parameters",true);
+  modelPL->set("Implicit model formulation",true);
+  modelPL->set("Provide nominal values",true);
+  stateModel->setParameterList(modelPL);
+  const RCP<StepperBuilder<double> > builder = stepperBuilder<double>();
+  RCP<ParameterList> stepperPL = Teuchos::parameterList();
+  stepperPL->set("Stepper Type",stepperType);
+  builder->setParameterList(stepperPL);
+  RCP<StepperBase<double> > stateStepper = builder->create();
+  RCP<TimeStepNonlinearSolver<double> > nonlinearSolver = timeStepNonlinearSolver<double>();
+  Teuchos::rcp_dynamic_cast<SolverAcceptingStepperBase<double> >(
+    stateStepper,true)->setSolver(nonlinearSolver);
+  RCP<ForwardSensitivityStepper<double> > stateAndSensStepper =
+    forwardSensitivityStepper<double>();
+  if (nonnull(fwdSensPL))
+    stateAndSensStepper->setParameterList(fwdSensPL);
+  int p_index = 0;
+  stateAndSensStepper->initializeSyncedSteppers(
+    stateModel,
+    p_index,
+    stateModel->getNominalValues(),
+    stateStepper,
+    nonlinearSolver
+    );
+  stateAndSensStepper->setInitialCondition(
+    createStateAndSensInitialCondition(*stateAndSensStepper,
+      stateModel->getNominalValues())
+    );
+  return stateAndSensStepper;
+}
+
+// The simultaneous corrector must give the same state and sensitivities as
+// the staggered corrector on the linear SinCos problem where the block
+// diagonal Newton matrix is exact.
+TEUCHOS_UNIT_TEST( Rythmos_ForwardSensitivityStepper, simultaneousSinCosBE ) {
+  typedef Teuchos::ScalarTraits<double> ST;
+  RCP<ParameterList> simultaneousPL = Teuchos::parameterList();
+  simultaneousPL->set("Sensitivity Method","Simultaneous Corrector");
+  const RCP<ForwardSensitivityStepper<double> >
+    staggeredStepper = createSinCosFwdSensStepper("Backward Euler",Teuchos::null),
+    simultaneousStepper = createSinCosFwdSensStepper("Backward Euler",simultaneousPL);
+  TEST_EQUALITY(
+    simultaneousStepper->getNonconstStateStepper()->getModel(),
+    simultaneousStepper->getModel() );
+  const double dt = 0.1;
+  for (int i=0 ; i<10 ; ++i) {
+    TEST_FLOATING_EQUALITY(
+      staggeredStepper->takeStep(dt,STEP_TYPE_FIXED), dt, 1.0e-14 );
+    TEST_FLOATING_EQUALITY(
+      simultaneousStepper->takeStep(dt,STEP_TYPE_FIXED), dt, 1.0e-14 );
+  }
+  const StepStatus<double>
+    staggeredStatus = staggeredStepper->getStepStatus(),
+    simultaneousStatus = simultaneousStepper->getStepStatus();
+  TEST_FLOATING_EQUALITY( simultaneousStatus.time, staggeredStatus.time, 1.0e-14 );
+  TEST_ASSERT(
+    Thyra::testRelNormDiffErr(
+      "x_bar staggered", *staggeredStatus.solution,
+      "x_bar simultaneous", *simultaneousStatus.solution,
+      "tol", 1.0e-10,
+      "tol", 1.0e-10,
+      0
+      )
+    );
+  // The sensitivities are actually there
+  RCP<const Thyra::VectorBase<double> > s_bar =
+    Thyra::productVectorBase<double>(simultaneousStatus.solution)->getVectorBlock(1);
+  TEST_COMPARE( Thyra::norm_inf(*s_bar), >, ST::zero() );
+}
+
+// With "Sensitivity Error Control" off, the simultaneous corrector must take
+// the same variable steps as the staggered corrector, because the
+// sensitivities are left out of the local error test.
+TEUCHOS_UNIT_TEST( Rythmos_ForwardSensitivityStepper, simultaneousSinCosBDF ) {
+  RCP<ParameterList> simultaneousPL = Teuchos::parameterList();
+  simultaneousPL->set("Sensitivity Method","Simultaneous Corrector");
+  const RCP<ForwardSensitivityStepper<double> >
+    staggeredStepper = createSinCosFwdSensStepper("Implicit BDF",Teuchos::null),
+    simultaneousStepper = createSinCosFwdSensStepper("Implicit BDF",simultaneousPL);
+  const double finalTime = 1.0;
+  double staggeredTime = 0.0, simultaneousTime = 0.0;
+  int numSteps = 0;
+  while (staggeredTime < finalTime && numSteps < 1000) {
+    const double staggered_dt =
+      staggeredStepper->takeStep(finalTime-staggeredTime,STEP_TYPE_VARIABLE);
+    const double simultaneous_dt =
+      simultaneousStepper->takeStep(finalTime-simultaneousTime,STEP_TYPE_VARIABLE);
+    TEST_FLOATING_EQUALITY( simultaneous_dt, staggered_dt, 1.0e-10 );
+    staggeredTime += staggered_dt;
+    simultaneousTime += simultaneous_dt;
+    ++numSteps;
+  }
+  TEST_COMPARE( numSteps, >, 1 );
+  TEST_ASSERT(
+    Thyra::testRelNormDiffErr(
+      "x_bar staggered", *staggeredStepper->getStepStatus().solution,
+      "x_bar simultaneous", *simultaneousStepper->getStepStatus().solution,
+      "tol", 1.0e-8,
+      "tol", 1.0e-8,
+      0
+      )
+    );
+}
+
+// The combined state and sensitivity residual refills the state derivative
+// matrices at each new point, and must give the same residual there as a
+// fresh model evaluator.
+TEUCHOS_UNIT_TEST( Rythmos_StateAndForwardSensitivityModelEvaluator, residualAtNewPoint ) {
+  typedef Thyra::ModelEvaluatorBase MEB;
+  const RCP<SinCosModel> sinCos = sinCosModel();
+  {
+    RCP<ParameterList> modelPL = Teuchos::parameterList();
+    modelPL->set("Accept model parameters",true);
+    modelPL->set("Implicit model formulation",true);
+    modelPL->set("Provide nominal values",true);
+    sinCos->setParameterList(modelPL);
+  }
+  const RCP<ForwardSensitivityImplicitModelEvaluator<double> >
+    sensModel = forwardSensitivityImplicitModelEvaluator<double>();
+  sensModel->initializeStructure(sinCos,0);
+  const RCP<StateAndForwardSensitivityModelEvaluator<double> >
+    stateAndSensModel = Teuchos::rcp(new StateAndForwardSensitivityModelEvaluator<double>());
+  stateAndSensModel->initializeStructure(sensModel);
+
+  const MEB::InArgs<double> nominalValues = sinCos->getNominalValues();
+  const RCP<Thyra::VectorBase<double> >
+    x = Thyra::createMember(sinCos->get_x_space()),
+    x_dot = Thyra::createMember(sinCos->get_x_space()),
+    s_bar = Thyra::createMember(sensModel->get_x_space()),
+    s_bar_dot = Thyra::createMember(sensModel->get_x_space());
+  Thyra::V_S(x.ptr(),0.5);
+  Thyra::V_S(x_dot.ptr(),-0.25);
+  Thyra::V_S(s_bar.ptr(),1.0);
+  Thyra::V_S(s_bar_dot.ptr(),2.0);
+  MEB::InArgs<double> inArgs = stateAndSensModel->createInArgs();
+  inArgs.set_t(0.0);
+  inArgs.set_p(0,nominalValues.get_p(0));
+  inArgs.set_x(stateAndSensModel->create_x_bar_vec(x,s_bar));
+  inArgs.set_x_dot(stateAndSensModel->create_x_bar_vec(x_dot,s_bar_dot));
+
+  const RCP<Thyra::VectorBase<double> >
+    f_bar_1 = Thyra::createMember(stateAndSensModel->get_f_space()),
+    f_bar_2 = Thyra::createMember(stateAndSensModel->get_f_space());
+  MEB::OutArgs<double> outArgs = stateAndSensModel->createOutArgs();
+  outArgs.set_f(f_bar_1);
+  stateAndSensModel->evalModel(inArgs,outArgs);
+
+  // New state and sensitivities: the matrices are refilled and match a
+  // fresh evaluation
+  Thyra::V_S(x.ptr(),-1.5);
+  Thyra::V_S(s_bar.ptr(),3.0);
+  inArgs.set_t(0.5);
+  inArgs.set_x(stateAndSensModel->create_x_bar_vec(x,s_bar));
+  stateAndSensModel->evalModel(inArgs,outArgs);
+  {
+    const RCP<StateAndForwardSensitivityModelEvaluator<double> >
+      freshModel = Teuchos::rcp(new StateAndForwardSensitivityModelEvaluator<double>());
+    freshModel->initializeStructure(sensModel);
+    MEB::OutArgs<double> freshOutArgs = freshModel->createOutArgs();
+    freshOutArgs.set_f(f_bar_2);
+    freshModel->evalModel(inArgs,freshOutArgs);
+  }
+  TEST_ASSERT(
+    Thyra::testRelNormDiffErr(
+      "f_bar reused", *f_bar_1,
+      "f_bar fresh", *f_bar_2,
+      "tol", 1.0e-14,
+      "tol", 1.0e-14,
+      0
+      )
+    );
+}
+
+TEUCHOS_UNIT_TEST( Rythmos_ForwardSensitivityStepper, sensitivityErrorControl ) {
+  typedef ErrWtVecCalcAcceptingStepControlStrategyBase<double> EWVCASCSB;
+  {
+    // Staggered corrector can not control the sensitivity error
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set("Sensitivity Error Control",true);
+    RCP<ForwardSensitivityStepper<double> >
+      stateAndSensStepper = forwardSensitivityStepper<double>();
+    TEST_THROW( stateAndSensStepper->setParameterList(pl), std::logic_error );
+  }
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Sensitivity Method","Simultaneous Corrector");
+  const RCP<ForwardSensitivityStepper<double> >
+    stateAndSensStepper = createSinCosFwdSensStepper("Implicit BDF",pl);
+  const RCP<StepControlStrategyAcceptingStepperBase<double> >
+    bdfStepper = Teuchos::rcp_dynamic_cast<StepControlStrategyAcceptingStepperBase<double> >(
+      stateAndSensStepper->getNonconstStateStepper(), true );
+  const RCP<const EWVCASCSB>
+    stepControl = Teuchos::rcp_dynamic_cast<const EWVCASCSB>(
+      bdfStepper->getStepControlStrategy(), true );
+  TEST_ASSERT( nonnull(
+    Teuchos::rcp_dynamic_cast<const ForwardSensitivityErrWtVecCalc<double> >(
+      stepControl->getErrWtVecCalc())) );
+  // Turning on the sensitivity error control takes the sensitivities back
+  // into the error test
+  pl = Teuchos::parameterList();
+  pl->set("Sensitivity Method","Simultaneous Corrector");
+  pl->set("Sensitivity Error Control",true);
+  stateAndSensStepper->setParameterList(pl);
+  TEST_ASSERT( nonnull(stepControl->getErrWtVecCalc()) );
+  TEST_ASSERT( is_null(
+    Teuchos::rcp_dynamic_cast<const ForwardSensitivityErrWtVecCalc<double> >(
+      stepControl->getErrWtVecCalc())) );
+  const double dt = stateAndSensStepper->takeStep(1.0,STEP_TYPE_VARIABLE);
+  TEST_COMPARE( dt, >, 0.0 );
+}
+
+// Solving for the sensitivity columns one at a time must give the same
+// answer as solving for all of them together, with both sensitivity methods.
+TEUCHOS_UNIT_TEST( Rythmos_ForwardSensitivityStepper, sensitivitySolveBlockSize ) {
+  {
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set("Sensitivity Solve Block Size",-1);
+    RCP<ForwardSensitivityStepper<double> >
+      stateAndSensStepper = forwardSensitivityStepper<double>();
+    TEST_THROW( stateAndSensStepper->setParameterList(pl), std::logic_error );
+  }
+  const std::string methods[] = { "Staggered Corrector", "Simultaneous Corrector" };
+  for (int m=0 ; m<2 ; ++m) {
+    RCP<ParameterList> allColumnsPL = Teuchos::parameterList();
+    allColumnsPL->set("Sensitivity Method",methods[m]);
+    RCP<ParameterList> blockedPL = Teuchos::parameterList();
+    blockedPL->set("Sensitivity Method",methods[m]);
+    blockedPL->set("Sensitivity Solve Block Size",1);
+    const RCP<ForwardSensitivityStepper<double> >
+      allColumnsStepper = createSinCosFwdSensStepper("Backward Euler",allColumnsPL),
+      blockedStepper = createSinCosFwdSensStepper("Backward Euler",blockedPL);
+    const RCP<const ForwardSensitivityImplicitModelEvaluator<double> >
+      sensModel = Teuchos::rcp_dynamic_cast<const ForwardSensitivityImplicitModelEvaluator<double> >(
+        blockedStepper->getFwdSensModel(), true );
+    TEST_EQUALITY_CONST( sensModel->getSolveBlockSize(), 1 );
+    TEST_EQUALITY_CONST( blockedStepper->getStateAndFwdSensModel()->getSolveBlockSize(), 1 );
+    const double dt = 0.1;
+    for (int i=0 ; i<10 ; ++i) {
+      TEST_FLOATING_EQUALITY(
+        allColumnsStepper->takeStep(dt,STEP_TYPE_FIXED), dt, 1.0e-14 );
+      TEST_FLOATING_EQUALITY(
+        blockedStepper->takeStep(dt,STEP_TYPE_FIXED), dt, 1.0e-14 );
+    }
+    TEST_ASSERT(
+      Thyra::testRelNormDiffErr(
+        "x_bar all columns", *allColumnsStepper->getStepStatus().solution,
+        "x_bar blocked", *blockedStepper->getStepStatus().solution,
+        "tol", 1.0e-10,
+        "tol", 1.0e-10,
+        0
+        )
+      );
+  }
+}
+
+// clone() must copy the block size and clone the decorated object, or throw
+// when the decorated object can not be cloned.
+TEUCHOS_UNIT_TEST( Rythmos_BlockSolveLinearOpWithSolve, clone ) {
+  typedef BlockSolveLinearOpWithSolve<double> BSLOWS;
+  {
+    const RCP<const BSLOWS> blockLows = Teuchos::rcp_dynamic_cast<const BSLOWS>(
+      blockSolveLinearOpWithSolve<double>()->clone(), true );
+    TEST_ASSERT( is_null(blockLows->getLinearOpWithSolve()) );
+    TEST_EQUALITY_CONST( blockLows->getBlockSize(), 0 );
+  }
+  {
+    const RCP<const BSLOWS>
+      innerLows = blockSolveLinearOpWithSolve<double>(),
+      blockLows = blockSolveLinearOpWithSolve<double>(innerLows,2);
+    const RCP<const BSLOWS> clonedLows = Teuchos::rcp_dynamic_cast<const BSLOWS>(
+      blockLows->clone(), true );
+    TEST_EQUALITY_CONST( clonedLows->getBlockSize(), 2 );
+    const RCP<const BSLOWS> clonedInnerLows = Teuchos::rcp_dynamic_cast<const BSLOWS>(
+      clonedLows->getLinearOpWithSolve(), true );
+    TEST_INEQUALITY( clonedInnerLows.get(), innerLows.get() );
+  }
+  {
+    const RCP<SinCosModel> model = sinCosModel(true);
+    const RCP<const BSLOWS>
+      blockLows = blockSolveLinearOpWithSolve<double>(model->create_W(),1);
+    TEST_THROW( blockLows->clone(), std::logic_error );
+  }
+}
+
+// SinCosModel that computes its directional derivatives from its
+// derivative matrices and counts the calls.
+class DirectionalDerivativeSinCosModel
+  : public SinCosModel,
+    public DirectionalDerivativeModelEvaluatorBase<double>
+{
+public:
+  DirectionalDerivativeSinCosModel() : numCalls_(0) {}
+  int getNumCalls() const { return numCalls_; }
+  void evalDirectionalDerivatives(
+    const Thyra::ModelEvaluatorBase::InArgs<double> &basePoint,
+    const Ptr<const Thyra::MultiVectorBase<double> > &V_x_dot,
+    const Ptr<const Thyra::MultiVectorBase<double> > &V_x,
+    const int l,
+    const ArrayView<const int> &pCols,
+    const Ptr<Thyra::MultiVectorBase<double> > &F
+    ) const
+  {
+    typedef Thyra::ModelEvaluatorBase MEB;
+    ++numCalls_;
+    Thyra::assign(F, 0.0);
+    MEB::InArgs<double> inArgs = basePoint;
+    const RCP<Thyra::LinearOpBase<double> > DfDx_dot = this->create_W_op();
+    MEB::OutArgs<double> outArgs = this->createOutArgs();
+    inArgs.set_alpha(1.0);
+    inArgs.set_beta(0.0);
+    outArgs.set_W_op(DfDx_dot);
+    this->evalModel(inArgs,outArgs);
+    if (nonnull(V_x_dot))
+      Thyra::apply(*DfDx_dot, Thyra::NOTRANS, *V_x_dot, F, 1.0, 1.0);
+    const RCP<Thyra::LinearOpBase<double> > DfDx = this->create_W_op();
+    outArgs = this->createOutArgs();
+    inArgs.set_alpha(0.0);
+    inArgs.set_beta(1.0);
+    outArgs.set_W_op(DfDx);
+    this->evalModel(inArgs,outArgs);
+    if (nonnull(V_x))
+      Thyra::apply(*DfDx, Thyra::NOTRANS, *V_x, F, 1.0, 1.0);
+    if (l >= 0) {
+      const RCP<Thyra::MultiVectorBase<double> > DfDp =
+        Thyra::create_DfDp_mv(*this, l, MEB::DERIV_MV_BY_COL).getMultiVector();
+      outArgs = this->createOutArgs();
+      outArgs.set_DfDp(l, MEB::Derivative<double>(DfDp, MEB::DERIV_MV_BY_COL));
+      this->evalModel(basePoint,outArgs);
+      Thyra::Vp_V(F, *DfDp->subView(pCols));
+    }
+  }
+private:
+  mutable int numCalls_;
+};
+
+// Sensitivities from directional derivatives must match those from the
+// derivative matrices, to finite difference accuracy with the state model's
+// residual and exactly when the state model computes the derivatives.
+TEUCHOS_UNIT_TEST( Rythmos_ForwardSensitivityStepper, directionalDerivatives ) {
+  {
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set("Sensitivity Method","Simultaneous Corrector");
+    pl->set("Directional Derivative Sensitivities",true);
+    RCP<ForwardSensitivityStepper<double> >
+      stateAndSensStepper = forwardSensitivityStepper<double>();
+    TEST_THROW( stateAndSensStepper->setParameterList(pl), std::logic_error );
+  }
+  {
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set("Sensitivity Finite Difference Step",0.0);
+    RCP<ForwardSensitivityStepper<double> >
+      stateAndSensStepper = forwardSensitivityStepper<double>();
+    TEST_THROW( stateAndSensStepper->setParameterList(pl), std::logic_error );
+  }
+  RCP<ParameterList> ddPL = Teuchos::parameterList();
+  ddPL->set("Directional Derivative Sensitivities",true);
+  const RCP<DirectionalDerivativeSinCosModel>
+    ddModel = Teuchos::rcp(new DirectionalDerivativeSinCosModel);
+  const RCP<ForwardSensitivityStepper<double> >
+    matrixStepper = createSinCosFwdSensStepper("Backward Euler",Teuchos::null),
+    fdStepper = createSinCosFwdSensStepper("Backward Euler",ddPL),
+    ddStepper = createSinCosFwdSensStepper("Backward Euler",ddPL,ddModel);
+  const RCP<const ForwardSensitivityImplicitModelEvaluator<double> >
+    sensModel = Teuchos::rcp_dynamic_cast<const ForwardSensitivityImplicitModelEvaluator<double> >(
+      fdStepper->getFwdSensModel(), true );
+  TEST_ASSERT( sensModel->getDirectionalDerivatives() );
+  const double dt = 0.1;
+  const int numSteps = 10;
+  for (int i=0 ; i<numSteps ; ++i) {
+    TEST_FLOATING_EQUALITY(
+      matrixStepper->takeStep(dt,STEP_TYPE_FIXED), dt, 1.0e-14 );
+    TEST_FLOATING_EQUALITY(
+      fdStepper->takeStep(dt,STEP_TYPE_FIXED), dt, 1.0e-14 );
+    TEST_FLOATING_EQUALITY(
+      ddStepper->takeStep(dt,STEP_TYPE_FIXED), dt, 1.0e-14 );
+  }
+  // All of the columns of each sensitivity residual come from one call
+  TEST_COMPARE( ddModel->getNumCalls(), >=, numSteps );
+  TEST_ASSERT(
+    Thyra::testRelNormDiffErr(
+      "x_bar matrices", *matrixStepper->getStepStatus().solution,
+      "x_bar finite differences", *fdStepper->getStepStatus().solution,
+      "tol", 1.0e-6,
+      "tol", 1.0e-6,
+      0
+      )
+    );
+  TEST_ASSERT(
+    Thyra::testRelNormDiffErr(
+      "x_bar matrices", *matrixStepper->getStepStatus().solution,
+      "x_bar directional derivatives", *ddStepper->getStepStatus().solution,
+      "tol", 1.0e-10,
+      "tol", 1.0e-10,
+      0
+      )
+    );
+}
+
+// Return column k of the current sensitivities S of stateAndSensStepper.
+RCP<const Thyra::VectorBase<double> > getSensColumn(
+  const ForwardSensitivityStepper<double> &stateAndSensStepper,
+  const int k
+  )
+{
+  const RCP<const Thyra::ProductVectorBase<double> >
+    x_bar = Thyra::productVectorBase<double>(
+      stateAndSensStepper.getStepStatus().solution );
+  return Teuchos::rcp_dynamic_cast<const Thyra::DefaultMultiVectorProductVector<double> >(
+    x_bar->getVectorBlock(1), true )->getMultiVector()->col(k);
+}
+
+void testActiveParameters(
+  const RCP<ParameterList> &fwdSensPL,
+  Teuchos::FancyOStream &out,
+  bool &success
+  )
+{
+  const RCP<ForwardSensitivityStepper<double> >
+    allStepper = createSinCosFwdSensStepper("Backward Euler",fwdSensPL),
+    subsetStepper = createSinCosFwdSensStepper("Backward Euler",fwdSensPL),
+    changedStepper = createSinCosFwdSensStepper("Backward Euler",fwdSensPL);
+  TEST_EQUALITY( Teuchos::as<int>(allStepper->getActiveParameters().size()), 3 );
+  TEST_THROW( subsetStepper->setActiveParameters(Teuchos::tuple<int>(2,0)()),
+    std::logic_error );
+  TEST_THROW( subsetStepper->setActiveParameters(Teuchos::tuple<int>(0,3)()),
+    std::logic_error );
+  TEST_THROW( subsetStepper->setActiveParameters(Teuchos::tuple<int>(1,1)()),
+    std::logic_error );
+  subsetStepper->setActiveParameters(Teuchos::tuple<int>(0,2)());
+  TEST_EQUALITY( Teuchos::as<int>(subsetStepper->getActiveParameters().size()), 2 );
+  TEST_EQUALITY(
+    subsetStepper->getFwdSensModel()->get_s_bar_space()->numBlocks(), 2 );
+  const double dt = 0.1;
+  const double tol = 1.0e-10;
+  for (int i=0 ; i<10 ; ++i) {
+    TEST_FLOATING_EQUALITY(
+      allStepper->takeStep(dt,STEP_TYPE_FIXED), dt, 1.0e-14 );
+    TEST_FLOATING_EQUALITY(
+      subsetStepper->takeStep(dt,STEP_TYPE_FIXED), dt, 1.0e-14 );
+    TEST_FLOATING_EQUALITY(
+      changedStepper->takeStep(dt,STEP_TYPE_FIXED), dt, 1.0e-14 );
+    if (i == 4) {
+      // Drop p(1) half way through the integration
+      changedStepper->setActiveParameters(Teuchos::tuple<int>(0,2)());
+    }
+  }
+  TEST_FLOATING_EQUALITY(
+    changedStepper->getStepStatus().time, allStepper->getStepStatus().time,
+    1.0e-14 );
+  for (int k=0 ; k<2 ; ++k) {
+    const int j = 2*k;
+    TEST_ASSERT(
+      Thyra::testRelNormDiffErr(
+        "S(:,j) all", *getSensColumn(*allStepper,j),
+        "S(:,k) subset", *getSensColumn(*subsetStepper,k),
+        "tol", tol,
+        "tol", tol,
+        0
+        )
+      );
+    TEST_ASSERT(
+      Thyra::testRelNormDiffErr(
+        "S(:,j) all", *getSensColumn(*allStepper,j),
+        "S(:,k) changed", *getSensColumn(*changedStepper,k),
+        "tol", tol,
+        "tol", tol,
+        0
+        )
+      );
+  }
+  // Adding p(1) back starts its sensitivity at zero and keeps the others
+  changedStepper->setActiveParameters(Teuchos::tuple<int>(0,1,2)());
+  TEST_EQUALITY( Teuchos::as<int>(changedStepper->getActiveParameters().size()), 3 );
+  TEST_EQUALITY( Thyra::norm_inf(*getSensColumn(*changedStepper,1)), 0.0 );
+  TEST_ASSERT(
+    Thyra::testRelNormDiffErr(
+      "S(:,2) all", *getSensColumn(*allStepper,2),
+      "S(:,2) changed", *getSensColumn(*changedStepper,2),
+      "tol", tol,
+      "tol", tol,
+      0
+      )
+    );
+  TEST_FLOATING_EQUALITY(
+    changedStepper->takeStep(dt,STEP_TYPE_FIXED), dt, 1.0e-14 );
+  TEST_COMPARE( Thyra::norm_inf(*getSensColumn(*changedStepper,1)), >, 0.0 );
+}
+
+TEUCHOS_UNIT_TEST( Rythmos_ForwardSensitivityStepper, activeParameters ) {
+  {
+    RCP<ForwardSensitivityStepper<double> >
+      stateAndSensStepper = forwardSensitivityStepper<double>();
+    TEST_THROW(
+      stateAndSensStepper->setActiveParameters(Teuchos::tuple<int>(0)()),
+      std::logic_error );
+  }
+  testActiveParameters(Teuchos::null,out,success);
+}
+
+TEUCHOS_UNIT_TEST( Rythmos_ForwardSensitivityStepper, activeParametersSimultaneous ) {
+  RCP<ParameterList> simultaneousPL = Teuchos::parameterList();
+  simultaneousPL->set("Sensitivity Method","Simultaneous Corrector");
+  testActiveParameters(simultaneousPL,out,success);
+}
+
+// The response g = x(0) + 2*x(1) + p(0) + 2*p(1) + 3*p(2) of a SinCos
+// model, with DgDx as the adjoint of a multi-vector.
+class SinCosResponseModel
+  : virtual public Thyra::ModelEvaluatorDelegatorBase<double>
+{
+public:
+  SinCosResponseModel(const RCP<const Thyra::ModelEvaluator<double> > &model)
+    {
+      this->Thyra::ModelEvaluatorDelegatorBase<double>::initialize(model);
+      g_space_ = Thyra::createMembers(model->get_x_space(),1)->domain();
+    }
+  RCP<const Thyra::VectorSpaceBase<double> > get_g_space(int j) const
+    {
+      TEUCHOS_ASSERT_EQUALITY( j, 0 );
+      return g_space_;
+    }
+private:
+  RCP<Thyra::LinearOpBase<double> > create_DgDx_op_impl(int j) const
+    {
+      return Thyra::nonconstAdjoint<double>(
+        Thyra::createMembers(this->get_x_space(),1) );
+    }
+  Thyra::ModelEvaluatorBase::OutArgs<double> createOutArgsImpl() const
+    {
+      typedef Thyra::ModelEvaluatorBase MEB;
+      MEB::OutArgsSetup<double> outArgs;
+      outArgs.setModelEvalDescription(this->description());
+      outArgs.set_Np_Ng(1,1);
+      outArgs.setSupports(MEB::OUT_ARG_DgDx,0,MEB::DERIV_LINEAR_OP);
+      outArgs.setSupports(MEB::OUT_ARG_DgDp,0,0,MEB::DERIV_MV_BY_COL);
+      return outArgs;
+    }
+  void evalModelImpl(
+    const Thyra::ModelEvaluatorBase::InArgs<double> &inArgs,
+    const Thyra::ModelEvaluatorBase::OutArgs<double> &outArgs
+    ) const
+    {
+      const Thyra::ConstDetachedVectorView<double> x_view(*inArgs.get_x());
+      const Thyra::ConstDetachedVectorView<double> p_view(*inArgs.get_p(0));
+      const RCP<VectorBase<double> > g = outArgs.get_g(0);
+      if (nonnull(g)) {
+        Thyra::DetachedVectorView<double> g_view(*g);
+        g_view[0] = x_view[0] + 2.0*x_view[1]
+          + p_view[0] + 2.0*p_view[1] + 3.0*p_view[2];
+      }
+      const RCP<Thyra::LinearOpBase<double> >
+        DgDx = outArgs.get_DgDx(0).getLinearOp();
+      if (nonnull(DgDx)) {
+        const RCP<Thyra::MultiVectorBase<double> > DgDx_trans =
+          Teuchos::rcp_dynamic_cast<Thyra::MultiVectorBase<double> >(
+            Teuchos::rcp_dynamic_cast<Thyra::DefaultScaledAdjointLinearOp<double> >(
+              DgDx,true)->getNonconstOp(), true );
+        Thyra::DetachedMultiVectorView<double> DgDx_trans_view(*DgDx_trans);
+        DgDx_trans_view(0,0) = 1.0;
+        DgDx_trans_view(1,0) = 2.0;
+      }
+      const RCP<Thyra::MultiVectorBase<double> >
+        DgDp = outArgs.get_DgDp(0,0).getMultiVector();
+      if (nonnull(DgDp)) {
+        Thyra::DetachedMultiVectorView<double> DgDp_view(*DgDp);
+        for (int j = 0; j < DgDp_view.numSubCols(); ++j)
+          DgDp_view(0,j) = j + 1.0;
+      }
+    }
+  RCP<const Thyra::VectorSpaceBase<double> > g_space_;
+};
+
+// The batched response sensitivities at several times inside a step must
+// match those computed one time at a time and the exact
+// D_g_hat_D_p = S(0,:) + 2*S(1,:) + [ 1, 2, 3 ].
+TEUCHOS_UNIT_TEST( Rythmos_ForwardResponseSensitivityComputer, computeResponsesAndSensitivities ) {
+  const RCP<SinCosModel> stateModel = sinCosModel();
+  const RCP<ForwardSensitivityStepper<double> > stateAndSensStepper =
+    createSinCosFwdSensStepper("Backward Euler",Teuchos::null,stateModel);
+  const RCP<SinCosResponseModel>
+    responseModel = Teuchos::rcp(new SinCosResponseModel(stateModel));
+  ForwardResponseSensitivityComputer<double> computer;
+  computer.setResponseFunction(
+    responseModel, stateModel->getNominalValues(), 0, 0 );
+  const double dt = 0.1;
+  for (int i=0 ; i<2 ; ++i) {
+    TEST_FLOATING_EQUALITY(
+      stateAndSensStepper->takeStep(dt,STEP_TYPE_FIXED), dt, 1.0e-14 );
+  }
+  const Array<double> time_vec = Teuchos::tuple<double>(0.1, 0.125, 0.15, 0.2);
+  const int numTimes = time_vec.size();
+  Array<RCP<Thyra::VectorBase<double> > > g_hat_vec;
+  Array<RCP<Thyra::MultiVectorBase<double> > > D_g_hat_D_p_vec;
+  for (int i=0 ; i<numTimes ; ++i) {
+    g_hat_vec.push_back(computer.create_g_hat());
+    D_g_hat_D_p_vec.push_back(computer.create_D_g_hat_D_p());
+  }
+  computer.computeResponsesAndSensitivities(
+    *stateAndSensStepper, time_vec, g_hat_vec, D_g_hat_D_p_vec );
+  const RCP<Thyra::VectorBase<double> > g_hat = computer.create_g_hat();
+  const RCP<Thyra::MultiVectorBase<double> >
+    D_g_hat_D_p = computer.create_D_g_hat_D_p();
+  for (int i=0 ; i<numTimes ; ++i) {
+    Array<RCP<const Thyra::VectorBase<double> > > x_bar_vec, x_bar_dot_vec;
+    stateAndSensStepper->getPoints(
+      Teuchos::tuple<double>(time_vec[i]), &x_bar_vec, &x_bar_dot_vec, 0 );
+    RCP<const Thyra::VectorBase<double> > x, x_dot;
+    RCP<const Thyra::MultiVectorBase<double> > S, S_dot;
+    extractStateAndSens( x_bar_vec[0], x_bar_dot_vec[0], &x, &S, &x_dot, &S_dot );
+    computer.computeResponseAndSensitivity(
+      x_dot.get(), S_dot.get(), *x, *S, time_vec[i], &*g_hat, &*D_g_hat_D_p );
+    TEST_FLOATING_EQUALITY(
+      Thyra::get_ele(*g_hat_vec[i],0), Thyra::get_ele(*g_hat,0), 1.0e-14 );
+    const Thyra::ConstDetachedMultiVectorView<double>
+      S_view(*S),
+      batched_view(*D_g_hat_D_p_vec[i]),
+      single_view(*D_g_hat_D_p);
+    for (int j=0 ; j<3 ; ++j) {
+      const double exact = S_view(0,j) + 2.0*S_view(1,j) + ( j + 1.0 );
+      TEST_FLOATING_EQUALITY( batched_view(0,j), exact, 1.0e-14 );
+      TEST_FLOATING_EQUALITY( single_view(0,j), exact, 1.0e-14 );
+    }
+  }
+  Array<RCP<Thyra::MultiVectorBase<double> > > short_D_g_hat_D_p_vec;
+  short_D_g_hat_D_p_vec.push_back(D_g_hat_D_p);
+  TEST_THROW(
+    computer.computeResponsesAndSensitivities(
+      *stateAndSensStepper, time_vec, g_hat_vec, short_D_g_hat_D_p_vec ),
+    std::logic_error );
+}
+
+// The observer computes the responses at the given times as the integration
+// passes them.
+TEUCHOS_UNIT_TEST( Rythmos_ForwardResponseSensitivityComputerObserver, responseTimes ) {
+  const RCP<SinCosModel> stateModel = sinCosModel();
+  const RCP<ForwardSensitivityStepper<double> > stateAndSensStepper =
+    createSinCosFwdSensStepper("Backward Euler",Teuchos::null,stateModel);
+  const RCP<ForwardResponseSensitivityComputerObserver<double> > observer =
+    forwardResponseSensitivityComputerObserver<double>(
+      Teuchos::rcp(new SinCosResponseModel(stateModel)),
+      stateModel->getNominalValues(), 0, 0 );
+  TEST_THROW(
+    observer->setResponseTimes(Teuchos::tuple<double>(0.2, 0.1)),
+    std::logic_error );
+  observer->setResponseTimes(Teuchos::tuple<double>(0.05, 0.1, 0.15, 0.3));
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Take Variable Steps",false);
+  pl->set("Fixed dt",0.1);
+  const RCP<DefaultIntegrator<double> > integrator = defaultIntegrator<double>(
+    simpleIntegrationControlStrategy<double>(pl), observer );
+  const double finalTime = 0.2;
+  integrator->setStepper(stateAndSensStepper, finalTime);
+  get_fwd_x<double>(*integrator, finalTime);
+  const Array<ResponseAndFwdSensPoint<double> >
+    &points = observer->responseAndFwdSensPoints();
+  TEST_EQUALITY( Teuchos::as<int>(points.size()), 3 );
+  if (points.size() == 3) {
+    TEST_FLOATING_EQUALITY( points[0].t(), 0.05, 1.0e-14 );
+    TEST_FLOATING_EQUALITY( points[1].t(), 0.1, 1.0e-14 );
+    TEST_FLOATING_EQUALITY( points[2].t(), 0.15, 1.0e-14 );
+  }
+}
+
+// With a subset of the parameters active, the response sensitivities only
+// have the columns of the active parameters and these match the same
+// columns of a run with all of the parameters active.
+TEUCHOS_UNIT_TEST( Rythmos_ForwardResponseSensitivityComputerObserver, activeParameters ) {
+  const Array<int> activeParams = Teuchos::tuple<int>(0,2);
+  const int numActiveParams = activeParams.size();
+  const double finalTime = 0.3;
+  Array<RCP<ForwardResponseSensitivityComputerObserver<double> > > observers;
+  for (int run=0 ; run<2 ; ++run) {
+    const bool subset = ( run == 1 );
+    const RCP<SinCosModel> stateModel = sinCosModel();
+    const RCP<ForwardSensitivityStepper<double> > stateAndSensStepper =
+      createSinCosFwdSensStepper("Backward Euler",Teuchos::null,stateModel);
+    const RCP<ForwardResponseSensitivityComputerObserver<double> > observer =
+      forwardResponseSensitivityComputerObserver<double>(
+        Teuchos::rcp(new SinCosResponseModel(stateModel)),
+        stateModel->getNominalValues(), 0, 0 );
+    if (subset) {
+      stateAndSensStepper->setActiveParameters(activeParams());
+      observer->setActiveParameters(activeParams());
+    }
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set("Take Variable Steps",false);
+    pl->set("Fixed dt",0.1);
+    const RCP<DefaultIntegrator<double> > integrator = defaultIntegrator<double>(
+      simpleIntegrationControlStrategy<double>(pl), observer );
+    integrator->setStepper(stateAndSensStepper, finalTime);
+    get_fwd_x<double>(*integrator, finalTime);
+    observers.push_back(observer);
+  }
+  const Array<ResponseAndFwdSensPoint<double> >
+    &allPoints = observers[0]->responseAndFwdSensPoints(),
+    &subsetPoints = observers[1]->responseAndFwdSensPoints();
+  TEST_EQUALITY( subsetPoints.size(), allPoints.size() );
+  TEST_COMPARE( Teuchos::as<int>(allPoints.size()), >, 0 );
+  for (int i=0 ; i<Teuchos::as<int>(std::min(allPoints.size(),subsetPoints.size())) ; ++i) {
+    TEST_EQUALITY(
+      subsetPoints[i].DgDp()->domain()->dim(), numActiveParams );
+    const Thyra::ConstDetachedMultiVectorView<double>
+      all_view(*allPoints[i].DgDp()),
+      subset_view(*subsetPoints[i].DgDp());
+    for (int k=0 ; k<numActiveParams ; ++k) {
+      TEST_FLOATING_EQUALITY(
+        subset_view(0,k), all_view(0,activeParams[k]), 1.0e-10 );
+    }
+  }
+  // The computer checks the number of columns against the active parameters
+  {
+    const RCP<SinCosModel> stateModel = sinCosModel();
+    const RCP<ForwardSensitivityStepper<double> > stateAndSensStepper =
+      createSinCosFwdSensStepper("Backward Euler",Teuchos::null,stateModel);
+    ForwardResponseSensitivityComputer<double> computer;
+    TEST_THROW( computer.setActiveParameters(activeParams()), std::logic_error );
+    computer.setResponseFunction(
+      Teuchos::rcp(new SinCosResponseModel(stateModel)),
+      stateModel->getNominalValues(), 0, 0 );
+    computer.setActiveParameters(activeParams());
+    TEST_EQUALITY( computer.create_D_g_hat_D_p()->domain()->dim(), numActiveParams );
+    RCP<const Thyra::VectorBase<double> > x, x_dot;
+    RCP<const Thyra::MultiVectorBase<double> > S, S_dot;
+    extractStateAndSens(
+      stateAndSensStepper->getStepStatus().solution,
+      stateAndSensStepper->getStepStatus().solutionDot,
+      &x, &S, &x_dot, &S_dot );
+    TEST_THROW(
+      computer.computeResponseAndSensitivity(
+        x_dot.get(), S_dot.get(), *x, *S, 0.0,
+        0, &*computer.create_D_g_hat_D_p() ),
+      std::logic_error );
+  }
+}
+
 //TEUCHOS_UNIT_TEST( Rythmos_ForwardSensitivityStepper, distributedResponse ) {
   // Set up the SinCos problem with g(x,t;p) = 0.5*\| x - 1 \|^2
   // Set up the forward sensitivity problem so it will compute the distributed response
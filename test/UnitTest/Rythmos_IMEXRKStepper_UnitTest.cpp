@@ -0,0 +1,228 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_UnitTestHelpers.hpp"
+#include "Rythmos_IMEXRKStepper.hpp"
+#include "Rythmos_ImplicitRKStepper.hpp"
+#include "Rythmos_RKButcherTableau.hpp"
+#include "Rythmos_RKButcherTableauBuilder.hpp"
+#include "Rythmos_RKButcherTableauHelpers.hpp"
+#include "Rythmos_TimeStepNonlinearSolver.hpp"
+#include "../DampedOscillator/DampedOscillatorModel.hpp"
+
+#include "Thyra_DefaultSerialDenseLinearOpWithSolveFactory.hpp"
+#include "Thyra_DetachedVectorView.hpp"
+#include "Thyra_VectorStdOps.hpp"
+
+namespace Rythmos {
+
+using Thyra::VectorBase;
+
+namespace {
+
+// Damped oscillator with only the selected terms and lambda = -2, omega = 1.
+RCP<DampedOscillatorModel> splitModel(
+  bool implicit, bool includeDamping, bool includeRotation)
+{
+  RCP<DampedOscillatorModel> model = dampedOscillatorModel();
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Implicit model formulation",implicit);
+  pl->set("Include damping term",includeDamping);
+  pl->set("Include rotation term",includeRotation);
+  pl->set("Coeff lambda",-2.0);
+  pl->set("Coeff omega",1.0);
+  model->setParameterList(pl);
+  return model;
+}
+
+// Integrate the split damped oscillator to t = 1 with fixed steps and return
+// the norm of the error against the exact solution.
+double imexError(const std::string& method, int numSteps)
+{
+  RCP<DampedOscillatorModel> implicitModel = splitModel(true,true,false);
+  RCP<DampedOscillatorModel> explicitModel = splitModel(false,false,true);
+  RCP<DampedOscillatorModel> fullModel = splitModel(false,true,true);
+
+  RCP<IMEXRKStepper<double> > stepper = imexRKStepper<double>(
+    implicitModel, explicitModel, timeStepNonlinearSolver<double>());
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("IMEX RK Method",method);
+  stepper->setParameterList(pl);
+  stepper->setInitialCondition(implicitModel->getNominalValues());
+
+  const double dt = 1.0/numSteps;
+  for (int i=0 ; i<numSteps ; ++i) {
+    stepper->takeStep(dt,STEP_TYPE_FIXED);
+  }
+  const StepStatus<double> stepStatus = stepper->getStepStatus();
+  RCP<VectorBase<double> > err = stepStatus.solution->clone_v();
+  Thyra::Vp_StV(err.ptr(), -1.0,
+    *fullModel->getExactSolution(stepStatus.time).get_x());
+  return Thyra::norm_2(*err);
+}
+
+} // namespace
+
+
+TEUCHOS_UNIT_TEST( Rythmos_IMEXRKStepper, create ) {
+  RCP<IMEXRKStepper<double> > stepper = imexRKStepper<double>();
+  TEST_ASSERT( !is_null(stepper) );
+  TEST_ASSERT( stepper->isImplicit() );
+  TEST_ASSERT( is_null(stepper->getExplicitRKButcherTableau()) );
+  // The default method is ARK3(2)4L[2]SA
+  stepper->setParameterList(Teuchos::parameterList());
+  TEST_EQUALITY( stepper->getOrder(), 3 );
+  TEST_EQUALITY( stepper->getExplicitRKButcherTableau()->numStages(), 4 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_IMEXRKStepper, invalidTableaus ) {
+  RCP<IMEXRKStepper<double> > stepper = imexRKStepper<double>();
+  RCP<RKButcherTableauBase<double> > erk3 =
+    createRKBT<double>("Explicit 3 Stage 2nd order ARK IMEX");
+  RCP<RKButcherTableauBase<double> > dirk3 =
+    createRKBT<double>("Diagonal IRK 3 Stage 2nd order ARK IMEX");
+  RCP<RKButcherTableauBase<double> > dirk4 =
+    createRKBT<double>("Diagonal IRK 4 Stage 3rd order ARK IMEX");
+  // Implicit tableau in the explicit slot
+  TEST_THROW( stepper->setRKButcherTableaus(dirk3,dirk3), std::logic_error );
+  // Different number of stages
+  TEST_THROW( stepper->setRKButcherTableaus(erk3,dirk4), std::logic_error );
+  // Different c vectors
+  RCP<RKButcherTableauBase<double> > erk3b =
+    createRKBT<double>(Explicit3Stage3rdOrder_name());
+  TEST_THROW( stepper->setRKButcherTableaus(erk3b,dirk3), std::logic_error );
+  stepper->setRKButcherTableaus(erk3,dirk3);
+  TEST_EQUALITY( stepper->getOrder(), 2 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_IMEXRKStepper, tableauPairs ) {
+  // The explicit and implicit tableaus of each pair share b, bhat and c.
+  Array<std::string> erkNames, irkNames;
+  erkNames.push_back(Explicit3Stage2ndOrderARK_name());
+  irkNames.push_back(DIRK3Stage2ndOrderARK_name());
+  erkNames.push_back(Explicit4Stage3rdOrderARK_name());
+  irkNames.push_back(DIRK4Stage3rdOrderARK_name());
+  erkNames.push_back(Explicit6Stage4thOrderARK_name());
+  irkNames.push_back(DIRK6Stage4thOrderARK_name());
+  double tol = 1.0e-14;
+  for (int m=0 ; m<Teuchos::as<int>(erkNames.size()) ; ++m) {
+    RCP<RKButcherTableauBase<double> > erk = createRKBT<double>(erkNames[m]);
+    RCP<RKButcherTableauBase<double> > irk = createRKBT<double>(irkNames[m]);
+    TEST_EQUALITY( determineRKBTType<double>(*erk),
+      RYTHMOS_RK_BUTCHER_TABLEAU_TYPE_ERK );
+    TEST_ASSERT( isDIRKButcherTableau<double>(*irk) );
+    TEST_ASSERT( erk->isEmbeddedMethod() );
+    TEST_ASSERT( irk->isEmbeddedMethod() );
+    TEST_EQUALITY( erk->order(), irk->order() );
+    TEST_EQUALITY( erk->numStages(), irk->numStages() );
+    for (int i=0 ; i<erk->numStages() ; ++i) {
+      TEST_FLOATING_EQUALITY( erk->b()(i)+1.0, irk->b()(i)+1.0, tol );
+      TEST_FLOATING_EQUALITY( erk->bhat()(i)+1.0, irk->bhat()(i)+1.0, tol );
+      TEST_FLOATING_EQUALITY( erk->c()(i)+1.0, irk->c()(i)+1.0, tol );
+    }
+  }
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_IMEXRKStepper, noExplicitPartIsDIRK ) {
+  // With no explicit part the stepper is the DIRK method of the implicit
+  // tableau, so it must agree with the ImplicitRKStepper.
+  RCP<DampedOscillatorModel> model = splitModel(true,true,true);
+  RCP<RKButcherTableauBase<double> > irkbt =
+    createRKBT<double>(DIRK4Stage3rdOrderARK_name());
+  RCP<RKButcherTableauBase<double> > erkbt =
+    createRKBT<double>(Explicit4Stage3rdOrderARK_name());
+
+  RCP<ImplicitRKStepper<double> > irkStepper = implicitRKStepper<double>(
+    model, timeStepNonlinearSolver<double>(),
+    Thyra::defaultSerialDenseLinearOpWithSolveFactory<double>(), irkbt );
+  irkStepper->setInitialCondition(model->getNominalValues());
+
+  RCP<IMEXRKStepper<double> > imexStepper = imexRKStepper<double>(
+    model, Teuchos::null, timeStepNonlinearSolver<double>());
+  imexStepper->setRKButcherTableaus(erkbt,irkbt);
+  imexStepper->setInitialCondition(model->getNominalValues());
+
+  double dt = 0.1;
+  for (int i=0 ; i<5 ; ++i) {
+    TEST_EQUALITY( irkStepper->takeStep(dt,STEP_TYPE_FIXED), dt );
+    TEST_EQUALITY( imexStepper->takeStep(dt,STEP_TYPE_FIXED), dt );
+  }
+  double tol = 1.0e-10;
+  TEST_FLOATING_EQUALITY( imexStepper->getStepStatus().time, 0.5, tol );
+  {
+    Thyra::ConstDetachedVectorView<double>
+      irk_view( *irkStepper->getStepStatus().solution );
+    Thyra::ConstDetachedVectorView<double>
+      imex_view( *imexStepper->getStepStatus().solution );
+    TEST_FLOATING_EQUALITY( imex_view[0], irk_view[0], tol );
+    TEST_FLOATING_EQUALITY( imex_view[1], irk_view[1], tol );
+  }
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_IMEXRKStepper, splitConvergenceOrder ) {
+  // Damping is treated implicitly and rotation explicitly.  Halving the step
+  // size should reduce the error by 2^p.
+  Array<std::string> methods;
+  Array<int> orders;
+  methods.push_back("ARK2");           orders.push_back(2);
+  methods.push_back("ARK3(2)4L[2]SA"); orders.push_back(3);
+  methods.push_back("ARK4(3)6L[2]SA"); orders.push_back(4);
+  for (int m=0 ; m<Teuchos::as<int>(methods.size()) ; ++m) {
+    double err1 = imexError(methods[m],20);
+    double err2 = imexError(methods[m],40);
+    double observedOrder = std::log(err1/err2)/std::log(2.0);
+    out << methods[m] << ": err(dt=0.05) = " << err1
+        << ", err(dt=0.025) = " << err2
+        << ", observed order = " << observedOrder << std::endl;
+    TEST_COMPARE( std::fabs(observedOrder-orders[m]), <, 0.3 );
+  }
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_IMEXRKStepper, explicitResponse ) {
+  // The damped oscillator has no response functions, so asking for the
+  // nonstiff part through one must fail.
+  RCP<DampedOscillatorModel> model = splitModel(true,true,false);
+  RCP<IMEXRKStepper<double> > stepper = imexRKStepper<double>(
+    model, Teuchos::null, timeStepNonlinearSolver<double>());
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Explicit Response Index",0);
+  stepper->setParameterList(pl);
+  stepper->setInitialCondition(model->getNominalValues());
+  TEST_THROW( stepper->takeStep(0.1,STEP_TYPE_FIXED), std::logic_error );
+}
+
+
+} // namespace Rythmos
@@ -83,6 +83,39 @@ TEUCHOS_UNIT_TEST( Rythmos_ImplicitBDFStepper, minOrder ) {
   }
 }
 
+TEUCHOS_UNIT_TEST( Rythmos_ImplicitBDFStepper, performanceCounters ) {
+  RCP<ParameterList> modelPL = Teuchos::parameterList();
+  modelPL->set("Implicit model formulation",true);
+  RCP<SinCosModel> model = sinCosModel();
+  model->setParameterList(modelPL);
+  RCP<TimeStepNonlinearSolver<double> > nlSolver = timeStepNonlinearSolver<double>();
+  RCP<ParameterList> stepperPL = Teuchos::parameterList();
+  {
+    ParameterList& pl = stepperPL->sublist("Step Control Settings");
+    pl.set("minOrder",1);
+    pl.set("maxOrder",1);
+    ParameterList& vopl = pl.sublist("VerboseObject");
+    vopl.set("Verbosity Level","none");
+  }
+  RCP<ImplicitBDFStepper<double> > stepper = implicitBDFStepper<double>(model,nlSolver,stepperPL);
+  stepper->setInitialCondition(model->getNominalValues());
+  TEST_EQUALITY_CONST( stepper->getPerformanceCounters().numSteps, 0 );
+  const int N = 5;
+  for (int i=0 ; i<N ; ++i) {
+    double dt_taken = stepper->takeStep(0.1,STEP_TYPE_FIXED);
+    TEST_ASSERT( dt_taken == 0.1 );
+  }
+  StepperPerformanceCounters counters = stepper->getPerformanceCounters();
+  TEST_EQUALITY_CONST( counters.numSteps, N );
+  TEST_COMPARE( counters.numNonlinearIterations, >=, N );
+  TEST_EQUALITY( counters.numResidualEvaluations, counters.numNonlinearIterations );
+  TEST_EQUALITY( counters.numJacobianEvaluations, counters.numNonlinearIterations );
+  TEST_EQUALITY( counters.numLinearSolves, counters.numNonlinearIterations );
+  TEST_EQUALITY_CONST( counters.numRejectedSteps, 0 );
+  // The last solve is also visible through the solver itself.
+  TEST_COMPARE( nlSolver->getNumIterations(), >=, 1 );
+}
+
 TEUCHOS_UNIT_TEST( Rythmos_ImplicitBDFStepper, exactNumericalAnswer_BE ) {
   double a = 1.5;
   double f = 1.6;
@@ -803,6 +803,36 @@ TEUCHOS_UNIT_TEST( Rythmos_ImplicitRKStepper, takeStep ) {
   
 }
 
+TEUCHOS_UNIT_TEST( Rythmos_ImplicitRKStepper, performanceCounters ) {
+  // A fully implicit tableau takes one nonlinear solve per step, a DIRK
+  // tableau one per stage.
+  Array<std::string> names;
+  names.push_back(Implicit2Stage4thOrderGauss_name());
+  names.push_back(SDIRK2Stage3rdOrder_name());
+  for (int k=0 ; k<Teuchos::as<int>(names.size()) ; ++k) {
+    RCP<SinCosModel> model = sinCosModel(true);
+    RCP<RKButcherTableauBase<double> > irkbt = createRKBT<double>(names[k]);
+    RCP<ImplicitRKStepper<double> > stepper = implicitRKStepper<double>(
+      model, timeStepNonlinearSolver<double>(),
+      Thyra::defaultSerialDenseLinearOpWithSolveFactory<double>(), irkbt );
+    stepper->setInitialCondition(model->getNominalValues());
+    TEST_EQUALITY_CONST( stepper->getPerformanceCounters().numSteps, 0 );
+    const int N = 5;
+    for (int i=0 ; i<N ; ++i) {
+      double dt_taken = stepper->takeStep(0.1,STEP_TYPE_FIXED);
+      TEST_ASSERT( dt_taken == 0.1 );
+    }
+    const int numSolves = (k == 0 ? N : N*irkbt->numStages());
+    StepperPerformanceCounters counters = stepper->getPerformanceCounters();
+    TEST_EQUALITY_CONST( counters.numSteps, N );
+    TEST_COMPARE( counters.numNonlinearIterations, >=, numSolves );
+    TEST_EQUALITY( counters.numResidualEvaluations, counters.numNonlinearIterations );
+    TEST_EQUALITY( counters.numJacobianEvaluations, counters.numNonlinearIterations );
+    TEST_EQUALITY( counters.numLinearSolves, counters.numNonlinearIterations );
+    TEST_EQUALITY_CONST( counters.numRejectedSteps, 0 );
+  }
+}
+
 TEUCHOS_UNIT_TEST( Rythmos_ImplicitRKStepper, setDirk ) {
   RCP<Thyra::ModelEvaluator<double> > model = getDiagonalModel<double>();
   Thyra::ModelEvaluatorBase::InArgs<double> ic = model->getNominalValues();
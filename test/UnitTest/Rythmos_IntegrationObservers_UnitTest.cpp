@@ -167,6 +167,32 @@ TEUCHOS_UNIT_TEST( Rythmos_IntegrationObservers, LoggingIntegrationObserver) {
 
 }
 
+TEUCHOS_UNIT_TEST( Rythmos_IntegrationObservers, LoggingIntegrationObserverClone) {
+
+  RCP<LoggingIntegrationObserver<double> > 
+    observer = createLoggingIntegrationObserver<double>();
+
+  MockStepperDecorator<double> stepper; 
+  StepControlInfo<double> stepControlInfo;
+
+  observer->observeStartTimeStep(stepper, stepControlInfo, 0);
+  RCP<LoggingIntegrationObserver<double> > clone =
+    Teuchos::rcp_dynamic_cast<LoggingIntegrationObserver<double> >(
+      observer->cloneIntegrationObserver(), true);
+  clone->observeCompletedTimeStep(stepper, stepControlInfo, 0);
+
+  // The clone starts from a copy of the log and then keeps its own
+  const std::map<std::string,int>& counters = *(observer->getCounters());
+  const std::map<std::string,int>& cloneCounters = *(clone->getCounters());
+  TEST_EQUALITY(counters.find(observer->nameObserveStartTimeStep_)->second, 1);
+  TEST_EQUALITY(counters.find(observer->nameObserveCompletedTimeStep_)->second, 0);
+  TEST_EQUALITY(cloneCounters.find(clone->nameObserveStartTimeStep_)->second, 1);
+  TEST_EQUALITY(cloneCounters.find(clone->nameObserveCompletedTimeStep_)->second, 1);
+  TEST_EQUALITY(observer->getOrder()->size(), 2);
+  TEST_EQUALITY(clone->getOrder()->size(), 3);
+
+}
+
 TEUCHOS_UNIT_TEST( Rythmos_IntegrationObservers, CompositeIntegrationObserver) {
   
   RCP<MockIntegrationObserver<double> > 
@@ -0,0 +1,192 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_UnitTestHelpers.hpp"
+#include "Rythmos_MultirateStepper.hpp"
+#include "Rythmos_ExplicitRKStepper.hpp"
+#include "Rythmos_RKButcherTableau.hpp"
+#include "Rythmos_RKButcherTableauBuilder.hpp"
+#include "../DampedOscillator/DampedOscillatorModel.hpp"
+
+#include "Thyra_DetachedVectorView.hpp"
+#include "Thyra_VectorStdOps.hpp"
+
+namespace Rythmos {
+
+using Thyra::VectorBase;
+
+namespace {
+
+// Explicit damped oscillator with only the selected terms.
+RCP<DampedOscillatorModel> splitModel(
+  bool includeDamping, bool includeRotation, double lambda, double omega)
+{
+  RCP<DampedOscillatorModel> model = dampedOscillatorModel();
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Implicit model formulation",false);
+  pl->set("Include damping term",includeDamping);
+  pl->set("Include rotation term",includeRotation);
+  pl->set("Coeff lambda",lambda);
+  pl->set("Coeff omega",omega);
+  model->setParameterList(pl);
+  return model;
+}
+
+// Integrate the damped oscillator to t = 1 with damping as the fast part and
+// rotation as the slow part, and return the norm of the error.
+double multirateError(int numSteps)
+{
+  RCP<DampedOscillatorModel> fastModel = splitModel(true,false,-2.0,1.0);
+  RCP<DampedOscillatorModel> slowModel = splitModel(false,true,-2.0,1.0);
+  RCP<DampedOscillatorModel> fullModel = splitModel(true,true,-2.0,1.0);
+
+  RCP<MultirateStepper<double> > stepper =
+    multirateStepper<double>(slowModel,fastModel);
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Fast Steps per Slow Step",20);
+  stepper->setParameterList(pl);
+  stepper->setInitialCondition(slowModel->getNominalValues());
+
+  const double dt = 1.0/numSteps;
+  for (int i=0 ; i<numSteps ; ++i) {
+    stepper->takeStep(dt,STEP_TYPE_FIXED);
+  }
+  const StepStatus<double> stepStatus = stepper->getStepStatus();
+  RCP<VectorBase<double> > err = stepStatus.solution->clone_v();
+  Thyra::Vp_StV(err.ptr(), -1.0,
+    *fullModel->getExactSolution(stepStatus.time).get_x());
+  return Thyra::norm_2(*err);
+}
+
+} // namespace
+
+
+TEUCHOS_UNIT_TEST( Rythmos_MultirateStepper, create ) {
+  RCP<MultirateStepper<double> > stepper = multirateStepper<double>();
+  TEST_ASSERT( !is_null(stepper) );
+  TEST_ASSERT( !stepper->isImplicit() );
+  TEST_ASSERT( is_null(stepper->getRKButcherTableau()) );
+  TEST_ASSERT( is_null(stepper->getFastStepper()) );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_MultirateStepper, invalidTableaus ) {
+  RCP<MultirateStepper<double> > stepper = multirateStepper<double>();
+  // Implicit tableau
+  TEST_THROW( stepper->setRKButcherTableau(
+      createRKBT<double>(RKBT_BackwardEuler_name())), std::logic_error );
+  // c = [ 0 1 1/2 ] is not ordered
+  TEST_THROW( stepper->setRKButcherTableau(
+      createRKBT<double>(Explicit3Stage3rdOrderTVD_name())),
+    std::logic_error );
+  stepper->setRKButcherTableau(
+    createRKBT<double>(Explicit3Stage3rdOrderKnothWolke_name()));
+  TEST_EQUALITY( stepper->getOrder(), 3 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_MultirateStepper, noFastPartIsERK ) {
+  // With f_F = 0 the fast stepper integrates the constant forcing exactly and
+  // the stepper is the slow RK method.
+  RCP<DampedOscillatorModel> fastModel = splitModel(true,false,0.0,1.0);
+  RCP<DampedOscillatorModel> slowModel = splitModel(false,true,0.0,1.0);
+  RCP<RKButcherTableauBase<double> > rkbt =
+    createRKBT<double>(Explicit3Stage3rdOrderKnothWolke_name());
+
+  RCP<ExplicitRKStepper<double> > erkStepper =
+    explicitRKStepper<double>(slowModel,rkbt);
+  erkStepper->setInitialCondition(slowModel->getNominalValues());
+
+  RCP<MultirateStepper<double> > mrStepper =
+    multirateStepper<double>(slowModel,fastModel);
+  mrStepper->setRKButcherTableau(rkbt);
+  mrStepper->setInitialCondition(slowModel->getNominalValues());
+
+  double dt = 0.1;
+  for (int i=0 ; i<5 ; ++i) {
+    TEST_EQUALITY( erkStepper->takeStep(dt,STEP_TYPE_FIXED), dt );
+    TEST_EQUALITY( mrStepper->takeStep(dt,STEP_TYPE_FIXED), dt );
+  }
+  double tol = 1.0e-10;
+  TEST_FLOATING_EQUALITY( mrStepper->getStepStatus().time, 0.5, tol );
+  {
+    Thyra::ConstDetachedVectorView<double>
+      erk_view( *erkStepper->getStepStatus().solution );
+    Thyra::ConstDetachedVectorView<double>
+      mr_view( *mrStepper->getStepStatus().solution );
+    TEST_FLOATING_EQUALITY( mr_view[0], erk_view[0], tol );
+    TEST_FLOATING_EQUALITY( mr_view[1], erk_view[1], tol );
+  }
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_MultirateStepper, evaluationCounts ) {
+  // The default slow tableau has c = [ 0 1/3 3/4 ], so with 10 fast steps
+  // per slow step the three fast intervals take 4, 5 and 3 steps, while the
+  // slow model is only evaluated once per stage.
+  RCP<DampedOscillatorModel> fastModel = splitModel(true,false,-10.0,1.0);
+  RCP<DampedOscillatorModel> slowModel = splitModel(false,true,-10.0,1.0);
+  RCP<MultirateStepper<double> > stepper =
+    multirateStepper<double>(slowModel,fastModel);
+  stepper->setInitialCondition(slowModel->getNominalValues());
+  TEST_EQUALITY( stepper->takeStep(0.1,STEP_TYPE_FIXED), 0.1 );
+  TEST_EQUALITY( stepper->takeStep(0.1,STEP_TYPE_FIXED), 0.1 );
+  TEST_EQUALITY( stepper->getNumSlowEvaluations(), 6 );
+  TEST_EQUALITY( stepper->getNumFastSteps(), 24 );
+  TEST_ASSERT( !is_null(stepper->getFastStepper()) );
+  TEST_EQUALITY( stepper->getFastStepper()->getModel()->get_x_space()->dim(),
+    2 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_MultirateStepper, convergenceOrder ) {
+  // With accurate fast steps, halving the slow step size should reduce the
+  // error by 2^3 for the default tableau of Knoth and Wolke.
+  double err1 = multirateError(10);
+  double err2 = multirateError(20);
+  double observedOrder = std::log(err1/err2)/std::log(2.0);
+  out << "err(dt=0.1) = " << err1
+      << ", err(dt=0.05) = " << err2
+      << ", observed order = " << observedOrder << std::endl;
+  TEST_COMPARE( std::fabs(observedOrder-3.0), <, 0.3 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_MultirateStepper, missingFastModel ) {
+  RCP<DampedOscillatorModel> slowModel = splitModel(false,true,-2.0,1.0);
+  RCP<MultirateStepper<double> > stepper = multirateStepper<double>();
+  stepper->setModel(slowModel);
+  stepper->setInitialCondition(slowModel->getNominalValues());
+  TEST_THROW( stepper->takeStep(0.1,STEP_TYPE_FIXED), std::logic_error );
+}
+
+
+} // namespace Rythmos
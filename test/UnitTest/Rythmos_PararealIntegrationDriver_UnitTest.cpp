@@ -0,0 +1,291 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_UnitTestHelpers.hpp"
+#include "Rythmos_PararealIntegrationDriver.hpp"
+
+#include "Rythmos_IntegratorBuilder.hpp"
+#include "Rythmos_ExplicitRKStepper.hpp"
+#include "Rythmos_RKButcherTableauBuilder.hpp"
+#include "Rythmos_TimeStepNonlinearSolver.hpp"
+#include "../SinCos/SinCosModel.hpp"
+
+#include "Thyra_DetachedVectorView.hpp"
+
+namespace Rythmos {
+
+
+using Thyra::VectorBase;
+typedef Thyra::ModelEvaluatorBase MEB;
+
+
+namespace {
+
+
+RCP<ParameterList> fixedStepBuilderPL(const std::string &stepperType,
+  double dt, double finalTime)
+{
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->setParameters(*(integratorBuilder<double>()->getValidParameters()));
+  pl->sublist("Integrator Settings").set("Final Time",finalTime);
+  pl->sublist("Integration Control Strategy Selection").set("Integration Control Strategy Type","Simple Integration Control Strategy");
+  pl->sublist("Integration Control Strategy Selection").sublist("Simple Integration Control Strategy").set("Take Variable Steps",false);
+  pl->sublist("Integration Control Strategy Selection").sublist("Simple Integration Control Strategy").set("Fixed dt",dt);
+  pl->sublist("Stepper Settings").sublist("Stepper Selection").set("Stepper Type",stepperType);
+  if (stepperType == "Explicit RK") {
+    pl->sublist("Stepper Settings").sublist("Runge Kutta Butcher Tableau Selection").set("Runge Kutta Butcher Tableau Type","Explicit 4 Stage");
+  }
+  return pl;
+}
+
+
+RCP<ParameterList> variableStepBDFBuilderPL(double finalTime)
+{
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->setParameters(*(integratorBuilder<double>()->getValidParameters()));
+  pl->sublist("Integrator Settings").set("Final Time",finalTime);
+  pl->sublist("Stepper Settings").sublist("Stepper Selection").set("Stepper Type","Implicit BDF");
+  pl->sublist("Stepper Settings").sublist("Step Control Settings").sublist("Step Control Strategy Selection").set("Step Control Strategy Type","Implicit BDF Stepper Step Control Strategy");
+  pl->sublist("Stepper Settings").sublist("Step Control Settings").sublist("Error Weight Vector Calculator Selection").set("Error Weight Vector Calculator Type","Implicit BDF Stepper Error Weight Vector Calculator");
+  return pl;
+}
+
+
+RCP<ParameterList> driverPL(int numSlices, int numThreads, double tolerance)
+{
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Number of Time Slices",numSlices);
+  pl->set("Number of Threads",numThreads);
+  pl->set("Convergence Tolerance",tolerance);
+  return pl;
+}
+
+
+// Serial fine solution at the final time.
+RCP<const VectorBase<double> > serialSolution(
+  const RCP<const Thyra::ModelEvaluator<double> > &model,
+  const RCP<Thyra::NonlinearSolverBase<double> > &nlSolver,
+  const RCP<ParameterList> &builderPL,
+  double finalTime
+  )
+{
+  RCP<IntegratorBuilder<double> > ib = integratorBuilder<double>();
+  ib->setParameterList(builderPL);
+  RCP<IntegratorBase<double> > integrator =
+    ib->create(model,model->getNominalValues(),nlSolver);
+  return get_fwd_x<double>(*integrator,finalTime);
+}
+
+
+} // namespace
+
+
+TEUCHOS_UNIT_TEST( Rythmos_PararealIntegrationDriver, fullIterationsMatchSerialFineRun ) {
+  const double dt = 0.01;
+  const double finalTime = 1.0;
+  const int numSlices = 10;
+  RCP<SinCosModel> model = sinCosModel(true);
+  RCP<TimeStepNonlinearSolver<double> > nlSolver =
+    timeStepNonlinearSolver<double>();
+
+  // A zero tolerance runs one iteration per slice.
+  RCP<PararealIntegrationDriver<double> > driver =
+    pararealIntegrationDriver<double>(model,model->getNominalValues(),
+      nlSolver,fixedStepBuilderPL("Backward Euler",dt,finalTime),
+      driverPL(numSlices,3,0.0));
+  RCP<const VectorBase<double> > x = driver->integrate();
+
+  TEST_EQUALITY( driver->getNumIterations(), numSlices );
+  TEST_EQUALITY( Teuchos::as<int>(driver->getCorrectionHistory().size()),
+    numSlices );
+  TEST_EQUALITY( Teuchos::as<int>(driver->getSliceTimes().size()),
+    numSlices+1 );
+  TEST_EQUALITY_CONST( driver->getSliceTimes()[0], 0.0 );
+  TEST_EQUALITY( driver->getSliceTimes()[numSlices], finalTime );
+#ifdef HAVE_RYTHMOS_THREADS
+  TEST_EQUALITY_CONST( driver->getNumThreads(), 3 );
+#else
+  TEST_EQUALITY_CONST( driver->getNumThreads(), 1 );
+#endif
+
+  RCP<const VectorBase<double> > x_serial = serialSolution(model,nlSolver,
+    fixedStepBuilderPL("Backward Euler",dt,finalTime),finalTime);
+  double tol = 1.0e-10;
+  {
+    Thyra::ConstDetachedVectorView<double> x_view( *x );
+    Thyra::ConstDetachedVectorView<double> x_serial_view( *x_serial );
+    TEST_FLOATING_EQUALITY( x_view[0], x_serial_view[0], tol );
+    TEST_FLOATING_EQUALITY( x_view[1], x_serial_view[1], tol );
+  }
+  TEST_EQUALITY( x.get(), driver->getSliceSolution(numSlices).get() );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_PararealIntegrationDriver, convergesBeforeLastIteration ) {
+  const double dt = 0.01;
+  const double finalTime = 1.0;
+  const int numSlices = 10;
+  RCP<SinCosModel> model = sinCosModel(true);
+  RCP<TimeStepNonlinearSolver<double> > nlSolver =
+    timeStepNonlinearSolver<double>();
+
+  RCP<PararealIntegrationDriver<double> > driver =
+    pararealIntegrationDriver<double>(model,model->getNominalValues(),
+      nlSolver,fixedStepBuilderPL("Backward Euler",dt,finalTime),
+      driverPL(numSlices,2,1.0e-8));
+  RCP<const VectorBase<double> > x = driver->integrate();
+
+  const Array<double> &history = driver->getCorrectionHistory();
+  TEST_COMPARE( driver->getNumIterations(), <, numSlices );
+  TEST_EQUALITY( Teuchos::as<int>(history.size()), driver->getNumIterations() );
+  TEST_COMPARE( history[history.size()-1], <=, 1.0e-8 );
+  // The corrections shrink from iteration to iteration
+  for (int k=1 ; k<Teuchos::as<int>(history.size()) ; ++k) {
+    TEST_COMPARE( history[k], <, history[k-1] );
+  }
+
+  RCP<const VectorBase<double> > x_serial = serialSolution(model,nlSolver,
+    fixedStepBuilderPL("Backward Euler",dt,finalTime),finalTime);
+  double tol = 1.0e-6;
+  {
+    Thyra::ConstDetachedVectorView<double> x_view( *x );
+    Thyra::ConstDetachedVectorView<double> x_serial_view( *x_serial );
+    TEST_FLOATING_EQUALITY( x_view[0], x_serial_view[0], tol );
+    TEST_FLOATING_EQUALITY( x_view[1], x_serial_view[1], tol );
+  }
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_PararealIntegrationDriver, variableStepThreadsMatchSerial ) {
+  const double finalTime = 1.0;
+  const int numSlices = 8;
+  RCP<SinCosModel> model = sinCosModel(true);
+  RCP<TimeStepNonlinearSolver<double> > nlSolver =
+    timeStepNonlinearSolver<double>();
+
+  RCP<PararealIntegrationDriver<double> > serialDriver =
+    pararealIntegrationDriver<double>(model,model->getNominalValues(),
+      nlSolver,variableStepBDFBuilderPL(finalTime),
+      driverPL(numSlices,1,1.0e-6));
+  RCP<const VectorBase<double> > x_serial = serialDriver->integrate();
+  TEST_EQUALITY_CONST( serialDriver->getNumThreads(), 1 );
+
+  RCP<PararealIntegrationDriver<double> > driver =
+    pararealIntegrationDriver<double>(model,model->getNominalValues(),
+      nlSolver,variableStepBDFBuilderPL(finalTime),
+      driverPL(numSlices,4,1.0e-6));
+  // Integrate twice to check that the thread workspaces are reused cleanly.
+  driver->integrate();
+  RCP<const VectorBase<double> > x = driver->integrate();
+
+  TEST_EQUALITY( driver->getNumIterations(),
+    serialDriver->getNumIterations() );
+  double tol = 1.0e-14;
+  for (int n=0 ; n<=numSlices ; ++n) {
+    Thyra::ConstDetachedVectorView<double>
+      x_view( *driver->getSliceSolution(n) );
+    Thyra::ConstDetachedVectorView<double>
+      x_serial_view( *serialDriver->getSliceSolution(n) );
+    TEST_FLOATING_EQUALITY( x_view[0], x_serial_view[0], tol );
+    TEST_FLOATING_EQUALITY( x_view[1], x_serial_view[1], tol );
+  }
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_PararealIntegrationDriver, explicitModelCoarseStepper ) {
+  const double dt = 0.01;
+  const double finalTime = 1.0;
+  const int numSlices = 10;
+  RCP<SinCosModel> model = sinCosModel(false);
+
+  // The default backward Euler coarse stepper needs x_dot
+  TEST_THROW(
+    pararealIntegrationDriver<double>(model,model->getNominalValues(),
+      Teuchos::null,fixedStepBuilderPL("Explicit RK",dt,finalTime)),
+    std::logic_error );
+
+  RCP<StepperBase<double> > coarseStepper =
+    explicitRKStepper<double>(model,createRKBT<double>("Forward Euler"));
+  RCP<ParameterList> pl = driverPL(numSlices,2,0.0);
+  pl->set("Coarse Steps Per Slice",2);
+  RCP<PararealIntegrationDriver<double> > driver =
+    pararealIntegrationDriver<double>(model,model->getNominalValues(),
+      Teuchos::null,fixedStepBuilderPL("Explicit RK",dt,finalTime),
+      pl,coarseStepper);
+  TEST_EQUALITY( driver->getCoarseStepper().get(), coarseStepper.get() );
+  RCP<const VectorBase<double> > x = driver->integrate();
+  TEST_EQUALITY( driver->getNumIterations(), numSlices );
+
+  RCP<const VectorBase<double> > x_serial = serialSolution(model,Teuchos::null,
+    fixedStepBuilderPL("Explicit RK",dt,finalTime),finalTime);
+  double tol = 1.0e-12;
+  {
+    Thyra::ConstDetachedVectorView<double> x_view( *x );
+    Thyra::ConstDetachedVectorView<double> x_serial_view( *x_serial );
+    TEST_FLOATING_EQUALITY( x_view[0], x_serial_view[0], tol );
+    TEST_FLOATING_EQUALITY( x_view[1], x_serial_view[1], tol );
+  }
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_PararealIntegrationDriver, invalidArguments ) {
+  RCP<SinCosModel> model = sinCosModel(true);
+  RCP<PararealIntegrationDriver<double> > driver =
+    Teuchos::rcp(new PararealIntegrationDriver<double>());
+  // Not initialized
+  TEST_THROW( driver->integrate(), std::logic_error );
+
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Number of Time Slices",0);
+  TEST_THROW( driver->setParameterList(pl), std::logic_error );
+  pl = Teuchos::parameterList();
+  pl->set("Coarse Steps Per Slice",0);
+  TEST_THROW( driver->setParameterList(pl), std::logic_error );
+  pl = Teuchos::parameterList();
+  pl->set("Max Iterations",-1);
+  TEST_THROW( driver->setParameterList(pl), std::logic_error );
+  pl = Teuchos::parameterList();
+  pl->set("Convergence Tolerance",-1.0);
+  TEST_THROW( driver->setParameterList(pl), std::logic_error );
+  TEST_THROW( driver->setParameterList(driverPL(4,-1,0.0)), std::logic_error );
+
+  driver->initialize(model,model->getNominalValues(),
+    timeStepNonlinearSolver<double>(),
+    fixedStepBuilderPL("Backward Euler",0.1,1.0));
+  driver->integrate();
+  TEST_THROW( driver->getSliceSolution(-1), std::out_of_range );
+  TEST_THROW( driver->getSliceSolution(driver->getSliceTimes().size()),
+    std::out_of_range );
+}
+
+
+} // namespace Rythmos
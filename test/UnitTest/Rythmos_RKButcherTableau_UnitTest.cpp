@@ -511,6 +511,26 @@ TEUCHOS_UNIT_TEST( Rythmos_RKButcherTableau, createExplicit3Stage3rdOrderHeun_RK
   TEST_EQUALITY_CONST( rkbt->order(), 3 );
 }
 
+TEUCHOS_UNIT_TEST( Rythmos_RKButcherTableau, createExplicit3Stage3rdOrderKnothWolke_RKBT ) {
+  RCP<RKButcherTableauBase<double> > rkbt = rcp(new Explicit3Stage3rdOrderKnothWolke_RKBT<double>());
+  double tol = 1.0e-10;
+  validateERKButcherTableau(*rkbt);
+  const Teuchos::SerialDenseMatrix<int,double> A = rkbt->A();
+  const Teuchos::SerialDenseVector<int,double> b = rkbt->b();
+  const Teuchos::SerialDenseVector<int,double> c = rkbt->c();
+  TEST_EQUALITY_CONST( rkbt->numStages(), 3 );
+  TEST_FLOATING_EQUALITY( A(1,0),  1.0/3.0 , tol );
+  TEST_FLOATING_EQUALITY( A(2,0), -3.0/16.0, tol );
+  TEST_FLOATING_EQUALITY( A(2,1), 15.0/16.0, tol );
+  TEST_FLOATING_EQUALITY( b(0), 1.0/6.0 , tol );
+  TEST_FLOATING_EQUALITY( b(1), 3.0/10.0, tol );
+  TEST_FLOATING_EQUALITY( b(2), 8.0/15.0, tol );
+  TEST_FLOATING_EQUALITY( c(0), 0.0    , tol );
+  TEST_FLOATING_EQUALITY( c(1), 1.0/3.0, tol );
+  TEST_FLOATING_EQUALITY( c(2), 3.0/4.0, tol );
+  TEST_EQUALITY_CONST( rkbt->order(), 3 );
+}
+
 TEUCHOS_UNIT_TEST( Rythmos_RKButcherTableau, createExplicit3Stage3rdOrder_RKBT ) {
   RCP<RKButcherTableauBase<double> > rkbt = rcp(new Explicit3Stage3rdOrder_RKBT<double>());
   double tol = 1.0e-10;
@@ -532,6 +552,141 @@ TEUCHOS_UNIT_TEST( Rythmos_RKButcherTableau, createExplicit3Stage3rdOrder_RKBT )
   TEST_EQUALITY_CONST( rkbt->order(), 3 );
 }
 
+TEUCHOS_UNIT_TEST( Rythmos_RKButcherTableau, createExplicit10Stage4thOrderSSP_RKBT ) {
+  RCP<RKButcherTableauBase<double> > rkbt = rcp(new Explicit10Stage4thOrderSSP_RKBT<double>());
+  double tol = 1.0e-10;
+  validateERKButcherTableau(*rkbt);
+  const Teuchos::SerialDenseMatrix<int,double> A = rkbt->A();
+  const Teuchos::SerialDenseVector<int,double> b = rkbt->b();
+  const Teuchos::SerialDenseVector<int,double> c = rkbt->c();
+  TEST_EQUALITY_CONST( rkbt->numStages(), 10 );
+  TEST_FLOATING_EQUALITY( A(4,3),  1.0/6.0 , tol );
+  TEST_FLOATING_EQUALITY( A(5,0),  1.0/15.0, tol );
+  TEST_FLOATING_EQUALITY( A(5,4),  1.0/15.0, tol );
+  TEST_FLOATING_EQUALITY( A(9,0),  1.0/15.0, tol );
+  TEST_FLOATING_EQUALITY( A(9,8),  1.0/6.0 , tol );
+  for (int i=0 ; i<10 ; ++i) {
+    TEST_FLOATING_EQUALITY( b(i), 0.1, tol );
+  }
+  TEST_FLOATING_EQUALITY( c(4), 2.0/3.0, tol );
+  TEST_FLOATING_EQUALITY( c(5), 1.0/3.0, tol );
+  TEST_FLOATING_EQUALITY( c(9), 1.0    , tol );
+  TEST_EQUALITY_CONST( rkbt->order(), 4 );
+  TEST_FLOATING_EQUALITY( rkbt->sspCoefficient(), 6.0, tol );
+}
+
+TEUCHOS_UNIT_TEST( Rythmos_RKButcherTableau, createExplicitSStage2ndOrderSSP_RKBT ) {
+  RCP<RKButcherTableauBase<double> > rkbt = rcp(new ExplicitSStage2ndOrderSSP_RKBT<double>());
+  double tol = 1.0e-10;
+  validateERKButcherTableau(*rkbt);
+  TEST_EQUALITY_CONST( rkbt->numStages(), 4 );
+  TEST_FLOATING_EQUALITY( rkbt->sspCoefficient(), 3.0, tol );
+  TEST_EQUALITY_CONST( rkbt->order(), 2 );
+
+  // Two stages must reproduce the 2 stage 2nd order TVD method:
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set<int>("Number of Stages",2);
+  rkbt->setParameterList(pl);
+  RCP<RKButcherTableauBase<double> > rkbt_tvd = rcp(new Explicit2Stage2ndOrderTVD_RKBT<double>());
+  TEST_ASSERT( *rkbt == *rkbt_tvd );
+  TEST_FLOATING_EQUALITY( rkbt->sspCoefficient(), rkbt_tvd->sspCoefficient(), tol );
+
+  pl->set<int>("Number of Stages",5);
+  rkbt->setParameterList(pl);
+  const Teuchos::SerialDenseMatrix<int,double> A = rkbt->A();
+  const Teuchos::SerialDenseVector<int,double> b = rkbt->b();
+  const Teuchos::SerialDenseVector<int,double> c = rkbt->c();
+  TEST_EQUALITY_CONST( rkbt->numStages(), 5 );
+  TEST_FLOATING_EQUALITY( A(4,0), 0.25, tol );
+  TEST_FLOATING_EQUALITY( A(4,3), 0.25, tol );
+  TEST_FLOATING_EQUALITY( b(0), 0.2, tol );
+  TEST_FLOATING_EQUALITY( c(4), 1.0, tol );
+  TEST_FLOATING_EQUALITY( rkbt->sspCoefficient(), 4.0, tol );
+
+  pl->set<int>("Number of Stages",1);
+  TEST_THROW( rkbt->setParameterList(pl), std::logic_error );
+}
+
+TEUCHOS_UNIT_TEST( Rythmos_RKButcherTableau, createExplicitSStage3rdOrderSSP_RKBT ) {
+  RCP<RKButcherTableauBase<double> > rkbt = rcp(new ExplicitSStage3rdOrderSSP_RKBT<double>());
+  double tol = 1.0e-10;
+  validateERKButcherTableau(*rkbt);
+  {
+    // SSPRK(4,3)
+    const Teuchos::SerialDenseMatrix<int,double> A = rkbt->A();
+    const Teuchos::SerialDenseVector<int,double> b = rkbt->b();
+    const Teuchos::SerialDenseVector<int,double> c = rkbt->c();
+    TEST_EQUALITY_CONST( rkbt->numStages(), 4 );
+    TEST_FLOATING_EQUALITY( A(1,0), 0.5    , tol );
+    TEST_FLOATING_EQUALITY( A(2,0), 0.5    , tol );
+    TEST_FLOATING_EQUALITY( A(2,1), 0.5    , tol );
+    TEST_FLOATING_EQUALITY( A(3,0), 1.0/6.0, tol );
+    TEST_FLOATING_EQUALITY( A(3,1), 1.0/6.0, tol );
+    TEST_FLOATING_EQUALITY( A(3,2), 1.0/6.0, tol );
+    TEST_FLOATING_EQUALITY( b(0), 1.0/6.0, tol );
+    TEST_FLOATING_EQUALITY( b(1), 1.0/6.0, tol );
+    TEST_FLOATING_EQUALITY( b(2), 1.0/6.0, tol );
+    TEST_FLOATING_EQUALITY( b(3), 0.5    , tol );
+    TEST_FLOATING_EQUALITY( c(1), 0.5, tol );
+    TEST_FLOATING_EQUALITY( c(2), 1.0, tol );
+    TEST_FLOATING_EQUALITY( c(3), 0.5, tol );
+    TEST_EQUALITY_CONST( rkbt->order(), 3 );
+    TEST_FLOATING_EQUALITY( rkbt->sspCoefficient(), 2.0, tol );
+  }
+  {
+    // SSPRK(9,3)
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set<int>("Number of Stages",9);
+    rkbt->setParameterList(pl);
+    const Teuchos::SerialDenseMatrix<int,double> A = rkbt->A();
+    const Teuchos::SerialDenseVector<int,double> b = rkbt->b();
+    TEST_EQUALITY_CONST( rkbt->numStages(), 9 );
+    TEST_FLOATING_EQUALITY( A(6,0), 1.0/6.0 , tol );
+    TEST_FLOATING_EQUALITY( A(6,1), 1.0/15.0, tol );
+    TEST_FLOATING_EQUALITY( A(8,7), 1.0/6.0 , tol );
+    TEST_FLOATING_EQUALITY( b(0), 1.0/6.0 , tol );
+    TEST_FLOATING_EQUALITY( b(3), 1.0/15.0, tol );
+    TEST_FLOATING_EQUALITY( b(8), 1.0/6.0 , tol );
+    TEST_FLOATING_EQUALITY( rkbt->sspCoefficient(), 6.0, tol );
+    pl->set<int>("Number of Stages",8);
+    TEST_THROW( rkbt->setParameterList(pl), std::logic_error );
+  }
+}
+
+TEUCHOS_UNIT_TEST( Rythmos_RKButcherTableau, createARK2_RKBT ) {
+  RCP<RKButcherTableauBase<double> > erk = rcp(new Explicit3Stage2ndOrderARK_RKBT<double>());
+  RCP<RKButcherTableauBase<double> > irk = rcp(new DIRK3Stage2ndOrderARK_RKBT<double>());
+  double tol = 1.0e-10;
+  validateERKButcherTableau(*erk);
+  validateDIRKButcherTableau(*irk);
+  double sqrt2 = std::sqrt(2.0);
+  double gamma = 1.0-1.0/sqrt2;
+  const Teuchos::SerialDenseMatrix<int,double> AE = erk->A();
+  const Teuchos::SerialDenseMatrix<int,double> AI = irk->A();
+  TEST_EQUALITY_CONST( erk->numStages(), 3 );
+  TEST_EQUALITY_CONST( irk->numStages(), 3 );
+  TEST_FLOATING_EQUALITY( AE(1,0), 2.0*gamma, tol );
+  TEST_FLOATING_EQUALITY( AI(1,0), gamma, tol );
+  TEST_FLOATING_EQUALITY( AI(1,1), gamma, tol );
+  TEST_FLOATING_EQUALITY( AI(2,2), gamma, tol );
+  TEST_EQUALITY_CONST( AI(0,0), 0.0 );
+  TEST_FLOATING_EQUALITY( irk->b()(2), gamma, tol );
+  TEST_FLOATING_EQUALITY( erk->bhat()(2), 1.0/(2.0*sqrt2), tol );
+  TEST_ASSERT( erk->isEmbeddedMethod() );
+  TEST_ASSERT( irk->isEmbeddedMethod() );
+  TEST_EQUALITY_CONST( erk->order(), 2 );
+  TEST_EQUALITY_CONST( irk->order(), 2 );
+}
+
+TEUCHOS_UNIT_TEST( Rythmos_RKButcherTableau, sspCoefficient ) {
+  double tol = 1.0e-10;
+  TEST_FLOATING_EQUALITY( createRKBT<double>("Forward Euler")->sspCoefficient(), 1.0, tol );
+  TEST_FLOATING_EQUALITY( createRKBT<double>("Explicit 2 Stage 2nd order TVD")->sspCoefficient(), 1.0, tol );
+  TEST_FLOATING_EQUALITY( createRKBT<double>("Explicit 3 Stage 3rd order TVD")->sspCoefficient(), 1.0, tol );
+  TEST_EQUALITY_CONST( createRKBT<double>("Explicit 4 Stage")->sspCoefficient(), 0.0 );
+  TEST_EQUALITY_CONST( createRKBT<double>("Backward Euler")->sspCoefficient(), 0.0 );
+}
+
 TEUCHOS_UNIT_TEST( Rythmos_RKButcherTableau, createSDIRK2Stage3rdOrder_RKBT ) {
   RCP<RKButcherTableauBase<double> > rkbt = rcp(new SDIRK2Stage3rdOrder_RKBT<double>());
   validateSDIRKButcherTableau(*rkbt);
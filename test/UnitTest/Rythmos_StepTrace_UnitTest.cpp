@@ -0,0 +1,155 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_UnitTestHelpers.hpp"
+#include "Rythmos_StepTrace.hpp"
+#include "Rythmos_DefaultIntegrator.hpp"
+#include "Rythmos_ExplicitRKStepper.hpp"
+#include "Rythmos_SimpleIntegrationControlStrategy.hpp"
+#include "../SinCos/SinCosModel.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace Rythmos {
+
+
+TEUCHOS_UNIT_TEST( Rythmos_StepTrace, wrapAround ) {
+  StepTraceRing ring(5);
+  TEST_EQUALITY( ring.getCapacity(), 8 );
+  for (int i=0 ; i<11 ; ++i) {
+    ring.record(STEP_TRACE_TRIAL_STEP, i, 0.1*i, 0.1, 1, -1.0, -1);
+  }
+  TEST_EQUALITY( ring.getNumRecords(), 8 );
+  TEST_EQUALITY_CONST( ring.getNumDropped(), 3u );
+  Array<StepTraceRecord> records;
+  ring.getRecords(&records);
+  TEST_EQUALITY( Teuchos::as<int>(records.size()), 8 );
+  for (int i=0 ; i<8 ; ++i) {
+    TEST_EQUALITY( records[i].stepIndex, i+3 );
+  }
+  TEST_COMPARE( records[0].wallTime, <=, records[7].wallTime );
+  ring.clear();
+  TEST_EQUALITY( ring.getNumRecords(), 0 );
+  TEST_EQUALITY_CONST( ring.getNumDropped(), 0u );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_StepTrace, writeAndRead ) {
+  StepTraceRing ring(16,3);
+  ring.record(STEP_TRACE_TRIAL_STEP, 0, 0.0, 0.5, -1, -1.0, -1);
+  ring.record(STEP_TRACE_FAILED_STEP, 0, 0.0, -1.0, 2, 3.5, 10);
+  ring.record(STEP_TRACE_TRIAL_STEP, 0, 0.0, 0.25, -1, -1.0, -1);
+  ring.record(STEP_TRACE_ACCEPTED_STEP, 0, 0.25, 0.25, 2, 0.5, 3);
+  std::stringstream ss;
+  writeStepTrace(ring, ss);
+  TEST_EQUALITY( ring.getNumRecords(), 0 );
+  ring.record(STEP_TRACE_TRIAL_STEP, 1, 0.25, 0.25, -1, -1.0, -1);
+  writeStepTrace(ring, ss);
+
+  int threadId = -1;
+  std::size_t numDropped = 1;
+  Array<StepTraceRecord> records;
+  TEST_ASSERT( readStepTrace(ss, &threadId, &numDropped, &records) );
+  TEST_EQUALITY( threadId, 3 );
+  TEST_EQUALITY_CONST( numDropped, 0u );
+  TEST_EQUALITY( Teuchos::as<int>(records.size()), 4 );
+  TEST_EQUALITY( records[1].event, Teuchos::as<int>(STEP_TRACE_FAILED_STEP) );
+  TEST_EQUALITY( records[1].nonlinearIterations, 10 );
+  TEST_EQUALITY( records[3].time, 0.25 );
+  TEST_EQUALITY( records[3].errorNorm, 0.5 );
+  TEST_ASSERT( readStepTrace(ss, &threadId, &numDropped, &records) );
+  TEST_EQUALITY( Teuchos::as<int>(records.size()), 5 );
+  TEST_EQUALITY( records[4].stepIndex, 1 );
+  TEST_ASSERT( !readStepTrace(ss, &threadId, &numDropped, &records) );
+
+  std::ostringstream csv;
+  writeStepTraceCSV(records, threadId, csv);
+  const std::string csvString = csv.str();
+  TEST_EQUALITY( Teuchos::as<int>(
+      std::count(csvString.begin(), csvString.end(), '\n')), 6 );
+  TEST_INEQUALITY( csvString.find("STEP_TRACE_FAILED_STEP"),
+    std::string::npos );
+
+  std::ostringstream json;
+  writeStepTraceChromeJSON(records(0,4), threadId, json);
+  const std::string jsonString = json.str();
+  TEST_INEQUALITY( jsonString.find("\"ph\":\"B\""), std::string::npos );
+  TEST_INEQUALITY( jsonString.find("\"accepted\":false"), std::string::npos );
+  TEST_INEQUALITY( jsonString.find("\"tid\":3"), std::string::npos );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_StepTrace, badStream ) {
+  std::istringstream in("This is not a step trace, it is just text.");
+  Array<StepTraceRecord> records;
+  TEST_THROW( readStepTrace(in, 0, 0, &records), std::runtime_error );
+}
+
+
+#ifdef HAVE_RYTHMOS_STEP_TRACE
+
+TEUCHOS_UNIT_TEST( Rythmos_StepTrace, defaultIntegrator ) {
+  RCP<SinCosModel> model = sinCosModel(false);
+  RCP<ExplicitRKStepper<double> > stepper = explicitRKStepper<double>(model);
+  stepper->setInitialCondition(model->getNominalValues());
+  RCP<DefaultIntegrator<double> > integrator = defaultIntegrator<double>();
+  integrator->setStepper(stepper, 1.0);
+  RCP<ParameterList> pl = Teuchos::parameterList();
+  pl->set("Take Variable Steps",false);
+  pl->set("Fixed dt",0.1);
+  RCP<SimpleIntegrationControlStrategy<double> > intCont =
+    simpleIntegrationControlStrategy<double>(pl);
+  intCont->resetIntegrationControlStrategy(TimeRange<double>(0.0,1.0));
+  integrator->setIntegrationControlStrategy(intCont);
+  RCP<StepTraceRing> ring = Teuchos::rcp(new StepTraceRing(64));
+  integrator->setStepTrace(ring);
+  get_fwd_x<double>(*integrator, 1.0);
+
+  Array<StepTraceRecord> records;
+  ring->getRecords(&records);
+  TEST_EQUALITY( Teuchos::as<int>(records.size()), 20 );
+  for (int i=0 ; i<10 ; ++i) {
+    TEST_EQUALITY( records[2*i].event,
+      Teuchos::as<int>(STEP_TRACE_TRIAL_STEP) );
+    TEST_EQUALITY( records[2*i+1].event,
+      Teuchos::as<int>(STEP_TRACE_ACCEPTED_STEP) );
+    TEST_EQUALITY( records[2*i+1].stepIndex, i );
+    TEST_FLOATING_EQUALITY( records[2*i+1].time, 0.1*(i+1), 1.0e-12 );
+    TEST_EQUALITY( records[2*i+1].order, 4 );
+  }
+}
+
+#endif // HAVE_RYTHMOS_STEP_TRACE
+
+
+} // namespace Rythmos
+
@@ -221,6 +221,32 @@ TEUCHOS_UNIT_TEST( Rythmos_StepperBuilder, createIRKStepper ) {
   TEST_EQUALITY( verbLevel, Teuchos::VERB_NONE );
 }
 
+TEUCHOS_UNIT_TEST( Rythmos_StepperBuilder, createIMEXRKStepper ) {
+  // Verify the builder operates correctly for IMEX RK Stepper
+  RCP<StepperBuilder<double> > builder = stepperBuilder<double>();
+  {
+    // Specify which stepper we want
+    RCP<ParameterList> pl = Teuchos::parameterList();
+    pl->set(StepperType_name, "IMEX RK");
+    // Specify a IMEX RK setting
+    RCP<ParameterList> imexSettings = Teuchos::sublist(pl,"IMEX RK");
+    imexSettings->set("IMEX RK Method","ARK2");
+    RCP<ParameterList> vopl = Teuchos::sublist(imexSettings,"VerboseObject");
+    vopl->set("Verbosity Level","none");
+    builder->setParameterList(pl);
+  }
+  // Create the stepper
+  RCP<StepperBase<double> > stepper = builder->create();
+  TEST_EQUALITY( is_null(stepper), false );
+  // Verify we got the correct stepper
+  RCP<IMEXRKStepper<double> > imexStepper = Teuchos::rcp_dynamic_cast<IMEXRKStepper<double> >(stepper,false);
+  TEST_EQUALITY( is_null(imexStepper), false );
+  // Verify appropriate settings have propagated into the stepper correctly
+  Teuchos::EVerbosityLevel verbLevel = imexStepper->getVerbLevel();
+  TEST_EQUALITY( verbLevel, Teuchos::VERB_NONE );
+  TEST_EQUALITY( imexStepper->getOrder(), 2 );
+}
+
 
 #ifdef HAVE_THYRA_ME_POLYNOMIAL
 
@@ -0,0 +1,99 @@
+//@HEADER
+// ***********************************************************************
+//
+//                           Rythmos Package
+//                 Copyright (2006) Sandia Corporation
+//
+// Under terms of Contract DE-AC04-94AL85000, there is a non-exclusive
+// license for use of this work by or on behalf of the U.S. Government.
+//
+// This library is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as
+// published by the Free Software Foundation; either version 2.1 of the
+// License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301
+// USA
+// Questions? Contact Todd S. Coffey (tscoffe@sandia.gov)
+//
+// ***********************************************************************
+//@HEADER
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "Rythmos_Types.hpp"
+#include "Rythmos_ThreadPool.hpp"
+
+#ifdef HAVE_RYTHMOS_THREADS
+#  include <atomic>
+#endif
+
+namespace Rythmos {
+
+
+#ifdef HAVE_RYTHMOS_THREADS
+
+
+TEUCHOS_UNIT_TEST( Rythmos_ThreadPool, runsEveryThreadIndex ) {
+  ThreadPool pool(4);
+  TEST_EQUALITY_CONST( pool.getNumThreads(), 4 );
+  // The same workers run one task after the other.
+  Array<int> counts(4,0);
+  for (int run=0 ; run<10 ; ++run) {
+    pool.run( [&counts](int i) { ++counts[i]; } );
+  }
+  for (int i=0 ; i<4 ; ++i) {
+    TEST_EQUALITY_CONST( counts[i], 10 );
+  }
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_ThreadPool, timesOnlyTheCallingThread ) {
+  ThreadPool pool(3);
+  Array<int> suppressed(3,-1);
+  pool.run( [&suppressed](int i) {
+      suppressed[i] = timeMonitorSuppressedOnThisThread();
+    } );
+  TEST_EQUALITY_CONST( suppressed[0], 0 );
+  TEST_EQUALITY_CONST( suppressed[1], 1 );
+  TEST_EQUALITY_CONST( suppressed[2], 1 );
+  TEST_EQUALITY_CONST( timeMonitorSuppressedOnThisThread(), false );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_ThreadPool, rethrowsLowestThreadException ) {
+  ThreadPool pool(3);
+  std::atomic<int> numDone(0);
+  TEST_THROW(
+    pool.run( [&numDone](int i) {
+        ++numDone;
+        if (i == 1)
+          throw std::logic_error("thread 1");
+        if (i == 2)
+          throw std::runtime_error("thread 2");
+      } ),
+    std::logic_error );
+  TEST_EQUALITY_CONST( numDone.load(), 3 );
+  // The pool is still usable after an exception.
+  numDone = 0;
+  pool.run( [&numDone](int) { ++numDone; } );
+  TEST_EQUALITY_CONST( numDone.load(), 3 );
+}
+
+
+TEUCHOS_UNIT_TEST( Rythmos_ThreadPool, invalidNumThreads ) {
+  TEST_THROW( ThreadPool pool(0), std::logic_error );
+}
+
+
+#endif // HAVE_RYTHMOS_THREADS
+
+
+} // namespace Rythmos